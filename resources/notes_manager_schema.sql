@@ -3,16 +3,16 @@ PRAGMA foreign_keys = ON;
 CREATE TABLE IF NOT EXISTS resources (
     id          INTEGER PRIMARY KEY AUTOINCREMENT,
     title       TEXT NOT NULL,
-    type        TEXT NOT NULL,   -- Ví dụ: 'text', 'cpp', 'pdf', 'epub'
-	file_hash   TEXT UNIQUE NULL,     -- Kiểm tra trùng lặp file
-    created_at  TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
-    updated_at  TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    type        INTEGER NOT NULL,     -- mã ResourceType: 0 text, 1 cpp, 2 pdf, 3 epub
+	file_hash   BLOB UNIQUE NULL,     -- SHA-256 (32 byte), kiểm tra trùng lặp file
+    created_at  INTEGER NOT NULL DEFAULT (unixepoch()), -- unix epoch (giây)
+    updated_at  INTEGER NOT NULL DEFAULT (unixepoch()),
 	UNIQUE (title, type)
 );
 
 CREATE TABLE IF NOT EXISTS text_content (
     resource_id INTEGER PRIMARY KEY,
-    content     TEXT NOT NULL,
+    content     TEXT NOT NULL,           -- BLOB khi note được nén (xem text_dictionaries)
     FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
 );
 
@@ -21,6 +21,7 @@ CREATE TABLE IF NOT EXISTS files (
     stored_path   TEXT,
     original_path TEXT NOT NULL,
     is_managed    INTEGER NOT NULL DEFAULT 0, -- 0 = linked, 1 = copied
+    missing_since TEXT NULL,                  -- tombstone: file linked không còn ở original_path
     FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
 );
 
@@ -38,32 +39,54 @@ CREATE TABLE IF NOT EXISTS resource_tags (
 );
 
 -- -- --
-CREATE VIRTUAL TABLE text_content_fts USING fts5(
+-- Nội dung note chia chunk theo nội dung (content-defined) để FTS trả về vị trí chỗ khớp và sửa
+-- note chỉ ghi lại chunk đổi; TextContentRepository ghi text_chunks cùng lúc với text_content.
+-- text_chunks chỉ lưu vị trí chunk: FTS5 external-content đọc chunk qua view text_chunk_texts
+-- (note_slice, hàm đăng ký trên connection, cắt từ text_content kể cả khi đã nén) nên text của
+-- note chỉ có một bản. Dòng của chunk = tổng line_count phía trước.
+CREATE TABLE IF NOT EXISTS text_chunks (
+    id          INTEGER PRIMARY KEY,
+    resource_id INTEGER NOT NULL,
+    chunk_no    INTEGER NOT NULL,           -- khóa thứ tự, thưa để chèn giữa không đánh số lại
+    byte_offset INTEGER NOT NULL,           -- vị trí byte đầu chunk trong text_content
+    byte_len    INTEGER NOT NULL,
+    line_count  INTEGER NOT NULL,           -- số '\n' trong chunk
+    UNIQUE (resource_id, chunk_no),
+    FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+);
+
+CREATE VIEW IF NOT EXISTS text_chunk_texts AS
+SELECT c.id AS id, note_slice(t.content, c.byte_offset, c.byte_len) AS content
+FROM text_chunks c JOIN text_content t ON t.resource_id = c.resource_id;
+
+CREATE VIRTUAL TABLE IF NOT EXISTS text_chunks_fts USING fts5(
     content,
-    tokenize = 'unicode61 remove_diacritics 1'
+    content = 'text_chunk_texts',
+    content_rowid = 'id',
+    prefix = '2 3 4',
+    tokenize = 'code remove_diacritics 1'
 );
--- -- --
 
--- Trigger khi INSERT
-CREATE TRIGGER IF NOT EXISTS text_content_insert_fts
-AFTER INSERT ON text_content
-WHEN new.content IS NOT NULL
+-- Trigger đọc chunk qua view: chèn chunk sau khi ghi nội dung, xóa chunk trước khi đổi nội dung
+CREATE TRIGGER IF NOT EXISTS text_chunks_insert_fts
+AFTER INSERT ON text_chunks
 BEGIN
-    INSERT INTO text_content_fts (rowid, content) VALUES (new.resource_id, new.content);
+    INSERT INTO text_chunks_fts (rowid, content)
+    SELECT id, content FROM text_chunk_texts WHERE id = new.id;
 END;
 
--- Trigger khi UPDATE
-CREATE TRIGGER IF NOT EXISTS text_content_update_fts
-AFTER UPDATE ON text_content
+CREATE TRIGGER IF NOT EXISTS text_chunks_delete_fts
+BEFORE DELETE ON text_chunks
 BEGIN
-    UPDATE text_content_fts SET content = new.content WHERE rowid = old.resource_id;
+    INSERT INTO text_chunks_fts (text_chunks_fts, rowid, content)
+    SELECT 'delete', id, content FROM text_chunk_texts WHERE id = old.id;
 END;
 
--- Trigger khi DELETE
-CREATE TRIGGER IF NOT EXISTS text_content_delete_fts
-AFTER DELETE ON text_content
+-- Xóa note (kể cả cascade từ resources): bỏ chunk khỏi FTS khi nội dung còn đọc được
+CREATE TRIGGER IF NOT EXISTS text_content_delete_chunks
+BEFORE DELETE ON text_content
 BEGIN
-    DELETE FROM text_content_fts WHERE rowid = old.resource_id;
+    DELETE FROM text_chunks WHERE resource_id = old.resource_id;
 END;
 
 -- -- --
@@ -81,10 +104,12 @@ CREATE INDEX IF NOT EXISTS idx_resource_tags_tag_id ON resource_tags(tag_id);
 
 -- -- --
 
--- Tạo bảng ảo FTS5 cho resources(title)
+-- Tạo bảng ảo FTS5 cho resources(title); prefix index cho "ab*".."abcd*"
+-- Tokenizer 'code' (đăng ký trên connection, xem code_tokenizer.hpp) tách camelCase/snake_case/::
 CREATE VIRTUAL TABLE IF NOT EXISTS resources_fts USING fts5(
     title,
-    tokenize = 'unicode61 remove_diacritics 1'
+    prefix = '2 3 4',
+    tokenize = 'code remove_diacritics 1'
 );
 
 -- Trigger khi INSERT vào resources
@@ -110,6 +135,36 @@ BEGIN
     DELETE FROM resources_fts WHERE rowid = old.id;
 END;
 
+-- Trigram của title: tìm chuỗi con ("Buffer" trong "RingBufferImpl").
+-- Trigram của nội dung (text_chunks_trigram, file_chunks_trigram) do app tạo khi bật trong settings
+CREATE VIRTUAL TABLE IF NOT EXISTS resources_trigram USING fts5(
+    title,
+    content = 'resources',
+    content_rowid = 'id',
+    tokenize = 'trigram'
+);
+
+CREATE TRIGGER IF NOT EXISTS resources_insert_trigram
+AFTER INSERT ON resources
+BEGIN
+    INSERT INTO resources_trigram (rowid, title) VALUES (new.id, new.title);
+END;
+
+CREATE TRIGGER IF NOT EXISTS resources_delete_trigram
+AFTER DELETE ON resources
+BEGIN
+    INSERT INTO resources_trigram (resources_trigram, rowid, title)
+    VALUES ('delete', old.id, old.title);
+END;
+
+CREATE TRIGGER IF NOT EXISTS resources_update_trigram
+AFTER UPDATE OF title ON resources
+BEGIN
+    INSERT INTO resources_trigram (resources_trigram, rowid, title)
+    VALUES ('delete', old.id, old.title);
+    INSERT INTO resources_trigram (rowid, title) VALUES (new.id, new.title);
+END;
+
 -- -- --
 
 CREATE TRIGGER IF NOT EXISTS update_resource_timestamp
@@ -117,6 +172,104 @@ AFTER UPDATE ON resources
 FOR EACH ROW
 WHEN NEW.updated_at = OLD.updated_at
 BEGIN
-    UPDATE resources SET updated_at = CURRENT_TIMESTAMP WHERE id = OLD.id;
+    UPDATE resources SET updated_at = unixepoch() WHERE id = OLD.id;
 END;
 
+-- -- --
+-- Nội dung file (cpp/txt,...) chia chunk, FTS5 external-content trỏ vào file_chunks
+CREATE TABLE IF NOT EXISTS file_chunks (
+    id          INTEGER PRIMARY KEY,
+    resource_id INTEGER NOT NULL,
+    chunk_no    INTEGER NOT NULL,
+    content     TEXT NOT NULL,
+    page        INTEGER NULL,               -- trang PDF (1-based), NULL với file không phân trang
+    byte_offset INTEGER NOT NULL DEFAULT 0, -- vị trí byte đầu chunk (PDF: trong trang)
+    line_no     INTEGER NOT NULL DEFAULT 1, -- dòng (1-based) chứa byte đầu chunk
+    UNIQUE (resource_id, chunk_no),
+    FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+);
+
+CREATE TABLE IF NOT EXISTS file_index_state (
+    resource_id  INTEGER PRIMARY KEY,
+    indexed_hash BLOB NOT NULL,            -- file_hash lúc index, khác => index lại
+    chunk_count  INTEGER NOT NULL DEFAULT 0,
+    error        TEXT NULL,
+    indexed_at   TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+    FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+);
+
+CREATE VIRTUAL TABLE IF NOT EXISTS file_chunks_fts USING fts5(
+    content,
+    content = 'file_chunks',
+    content_rowid = 'id',
+    prefix = '2 3 4',
+    tokenize = 'code remove_diacritics 1'
+);
+
+CREATE TRIGGER IF NOT EXISTS file_chunks_insert_fts
+AFTER INSERT ON file_chunks
+BEGIN
+    INSERT INTO file_chunks_fts (rowid, content) VALUES (new.id, new.content);
+END;
+
+CREATE TRIGGER IF NOT EXISTS file_chunks_delete_fts
+AFTER DELETE ON file_chunks
+BEGIN
+    INSERT INTO file_chunks_fts (file_chunks_fts, rowid, content)
+    VALUES ('delete', old.id, old.content);
+END;
+
+CREATE TRIGGER IF NOT EXISTS file_chunks_update_fts
+AFTER UPDATE ON file_chunks
+BEGIN
+    INSERT INTO file_chunks_fts (file_chunks_fts, rowid, content)
+    VALUES ('delete', old.id, old.content);
+    INSERT INTO file_chunks_fts (rowid, content) VALUES (new.id, new.content);
+END;
+
+-- -- --
+-- Ký hiệu trích từ file cpp khi index nội dung (CppSymbolScanner): kind là mã SymbolKind
+-- (0 type, 1 function, 2 macro, 3 include, 4 call). Khóa bắt đầu bằng name nên tra
+-- "X được định nghĩa ở đâu" chỉ là một lần tìm trên B-tree.
+CREATE TABLE IF NOT EXISTS symbols (
+    resource_id INTEGER NOT NULL,
+    kind        INTEGER NOT NULL,
+    name        TEXT NOT NULL,
+    line        INTEGER NOT NULL,           -- dòng (1-based) của tên trong file
+    PRIMARY KEY (name, kind, resource_id, line),
+    FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+) WITHOUT ROWID;
+
+CREATE INDEX IF NOT EXISTS idx_symbols_resource ON symbols(resource_id);
+
+-- -- --
+-- Từ điển nén nội dung note (deflate preset dictionary), học từ chính các note.
+-- Blob nén ghi id từ điển trong header nên từ điển cũ phải giữ lại đến khi nén lại hết note.
+CREATE TABLE IF NOT EXISTS text_dictionaries (
+    id           INTEGER PRIMARY KEY,
+    dictionary   BLOB NOT NULL,
+    sample_count INTEGER NOT NULL,          -- số note dùng để học
+    created_at   TEXT DEFAULT CURRENT_TIMESTAMP
+);
+
+-- -- --
+-- Lịch sử text note: depth = 0 là snapshot (nén bằng TextCodec), depth > 0 là delta (TextDelta)
+-- so với revision ngay trước; tối đa RevisionPolicy::maxChainDepth delta sau mỗi snapshot.
+-- Phiên bản mới nhất trùng text_content.content (khi app ghi lịch sử);
+-- checksum (CRC-32) kiểm tra kết quả dựng lại từ chuỗi delta.
+CREATE TABLE IF NOT EXISTS text_revisions (
+    id          INTEGER PRIMARY KEY,
+    resource_id INTEGER NOT NULL,
+    revision    INTEGER NOT NULL,           -- tăng dần trong từng note
+    depth       INTEGER NOT NULL,           -- số delta tính từ snapshot gần nhất phía trước
+    size        INTEGER NOT NULL,           -- kích thước text của phiên bản
+    checksum    INTEGER NOT NULL,
+    data        BLOB NOT NULL,
+    created_at  TEXT DEFAULT CURRENT_TIMESTAMP,
+    UNIQUE (resource_id, revision),
+    FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+);
+
+-- -- --
+-- Phiên bản schema (SchemaMigrator nâng cấp DB cũ theo giá trị này)
+PRAGMA user_version = 13;
@@ -12,14 +12,20 @@
 #include <QTranslator>
 #include "AppController.hpp"
 #include "MainWindow.hpp"
+#include "code_tokenizer.hpp"
 #include "database_checker.hpp"
+#include "schema_migrator.hpp"
 #include "sqldb_raii.hpp"
 #include "resource_repository.hpp"
 #include "file_repository.hpp"
 #include "text_content_repository.hpp"
+#include "revision_repository.hpp"
 #include "tag_repository.hpp"
 #include "file_service.hpp"
+#include "content_store.hpp"
 #include "resource_service.hpp"
+#include "content_index_repository.hpp"
+#include "search_indexes.hpp"
 #include "NotesAppCore.hpp"
 
 AppController::AppController(QObject* parent) : QObject(parent) {}
@@ -56,21 +62,62 @@ void AppController::initializeCore() {
     }
 
     try {
+        m_revisionCompactor.reset();
+        m_pdfPool.reset();
+        m_indexScheduler.reset();
+        m_fileMonitor.reset();
+
         m_db = std::make_unique<SQLiteDB>(dbPath.string());
 
         verifyDatabase();
+        SchemaMigrator(*m_db).migrate();
         loadSettings();
 
         m_resRepo = std::make_unique<ResourceRepository>(*m_db);
         m_fileRepo = std::make_unique<FileRepository>(*m_db);
-        m_textRepo = std::make_unique<TextContentRepository>(*m_db);
+        m_revisionRepo = std::make_unique<RevisionRepository>(*m_db);
+        m_textRepo = std::make_unique<TextContentRepository>(*m_db, m_revisionRepo.get());
+        m_textRepo->setCompressionEnabled(m_settings && m_settings->compressNotes());
+        applyCompressionSettings();
+        applySearchIndexSettings();
         m_tagRepo = std::make_unique<TagRepository>(*m_db);
         m_fileService = std::make_unique<FileService>(*m_db, *m_fileRepo, *m_resRepo);
-        m_resService = std::make_unique<ResourceService>(*m_db, *m_resRepo, *m_fileRepo,
-                                                         *m_textRepo, *m_tagRepo, *m_fileService);
+        applyStorageSettings();
+        m_contentIndexRepo = std::make_unique<ContentIndexRepository>(*m_db);
+        m_resService =
+            std::make_unique<ResourceService>(*m_db, *m_resRepo, *m_fileRepo, *m_textRepo,
+                                              *m_tagRepo, *m_fileService, m_contentIndexRepo.get());
         m_core = std::make_unique<NotesAppCore>(*m_db, *m_resRepo, *m_fileRepo, *m_textRepo,
                                                 *m_tagRepo, *m_fileService, *m_resService);
 
+        m_fileMonitor = std::make_unique<LinkedFileMonitor>(*m_fileRepo, *m_fileService);
+        connect(m_fileMonitor.get(), &LinkedFileMonitor::watchError, this,
+                &AppController::errorOccurred);
+
+        // File linked đổi nội dung -> hash mới -> index lại
+        m_indexScheduler = std::make_unique<ContentIndexScheduler>(*m_db, *m_contentIndexRepo);
+        connect(m_indexScheduler.get(), &ContentIndexScheduler::indexError, this,
+                &AppController::errorOccurred);
+        connect(m_fileMonitor.get(), &LinkedFileMonitor::filesChanged, m_indexScheduler.get(),
+                &ContentIndexScheduler::schedule);
+
+        // Không có notes-pdf-worker (build thiếu target): PDF chỉ không được index nội dung
+        m_pdfPool = std::make_unique<PdfExtractionPool>(*m_db, *m_contentIndexRepo,
+                                                        PdfExtractionPool::findWorker());
+        connect(m_pdfPool.get(), &PdfExtractionPool::indexError, this,
+                &AppController::errorOccurred);
+        connect(m_fileMonitor.get(), &LinkedFileMonitor::filesChanged, m_pdfPool.get(),
+                &PdfExtractionPool::schedule);
+
+        m_revisionCompactor = std::make_unique<RevisionCompactor>(*m_revisionRepo);
+        connect(m_revisionCompactor.get(), &RevisionCompactor::compactError, this,
+                &AppController::errorOccurred);
+
+        m_fileMonitor->start();
+        m_indexScheduler->schedule();
+        m_pdfPool->schedule();
+        m_revisionCompactor->schedule();
+
         emit coreReady(m_core.get());
 
     } catch (const std::exception &ex) { emit errorOccurred(QString::fromStdString(ex.what())); }
@@ -126,6 +173,16 @@ void AppController::createDatabase() {
         return;
     }
 
+    // Schema tạo bảng FTS dùng tokenizer "code"
+    try {
+        registerCodeTokenizer(dbPtr);
+    } catch (const std::exception &ex) {
+        sqlite3_close_v2(dbPtr);
+        emit errorOccurred(QString::fromStdString(ex.what()));
+
+        return;
+    }
+
     // Thực thi schema
     char* errMsg = nullptr;
     rc = sqlite3_exec(dbPtr, schemaData.constData(), nullptr, nullptr, &errMsg);
@@ -187,9 +244,61 @@ void AppController::saveSettings() {
         if (!m_settings->save(configPath)) {
             QMessageBox::critical(nullptr, "Error", "Can not save config file");
         }
+
+        applyStorageSettings();
+        applyCompressionSettings();
+        applySearchIndexSettings();
     }
 }
 
+void AppController::applyStorageSettings() {
+    if (!m_fileService || !m_settings) { return; }
+
+    m_fileService->setContentStore(ContentStore(m_settings->resourceDir()));
+
+    // Storage phẳng cũ -> layout sharded (chỉ tốn một lần liệt kê thư mục nếu đã migrate)
+    try {
+        const auto moved = m_fileService->migrateFlatStorage();
+        if (moved > 0) {
+            emit infoMessage(tr("Migrated %1 stored files to the sharded layout.").arg(static_cast<qulonglong>(moved)));
+        }
+    } catch (const std::exception &ex) { emit errorOccurred(QString::fromStdString(ex.what())); }
+}
+
+void AppController::applyCompressionSettings() {
+    if (!m_textRepo || !m_settings) { return; }
+
+    const bool enabled = m_settings->compressNotes();
+    const bool toggled = m_textRepo->compressionEnabled() != enabled;
+    m_textRepo->setCompressionEnabled(enabled);
+
+    // Note đã đúng dạng thì recompress chỉ quét typeof(content), không đọc lại nội dung.
+    // Từ điển học lại khi vừa bật nén hoặc khi trước đó chưa đủ note để học
+    try {
+        const bool retrain = enabled && (toggled || !m_textRepo->hasDictionary());
+        const bool trained = retrain && m_textRepo->trainDictionary().has_value();
+        const auto rewritten = m_textRepo->recompress(trained);
+
+        if (toggled && rewritten > 0) {
+            const auto count = static_cast<qulonglong>(rewritten);
+            emit infoMessage(enabled ? tr("Compressed %1 notes.").arg(count)
+                                     : tr("Decompressed %1 notes.").arg(count));
+        }
+    } catch (const std::exception &ex) { emit errorOccurred(QString::fromStdString(ex.what())); }
+}
+
+void AppController::applySearchIndexSettings() {
+    if (!m_db || !m_settings) { return; }
+
+    // Bảng trigram nạp lại từ text_chunks/file_chunks nên chỉ tốn thời gian khi vừa bật
+    try {
+        if (SearchIndexes(*m_db).setContentTrigram(m_settings->substringIndex())) {
+            emit infoMessage(m_settings->substringIndex() ? tr("Substring index built.")
+                                                          : tr("Substring index removed."));
+        }
+    } catch (const std::exception &ex) { emit errorOccurred(QString::fromStdString(ex.what())); }
+}
+
 void AppController::updateSettings(const AppSettings &newSettings) {
     if (!m_settings) {
         m_settings = std::make_unique<AppSettings>();
@@ -204,6 +313,22 @@ const AppSettings* AppController::settings() const noexcept {
     return m_settings.get();
 }
 
+LinkedFileMonitor* AppController::fileMonitor() const noexcept {
+    return m_fileMonitor.get();
+}
+
+ContentIndexScheduler* AppController::indexScheduler() const noexcept {
+    return m_indexScheduler.get();
+}
+
+PdfExtractionPool* AppController::pdfPool() const noexcept {
+    return m_pdfPool.get();
+}
+
+RevisionCompactor* AppController::revisionCompactor() const noexcept {
+    return m_revisionCompactor.get();
+}
+
 void AppController::applyLanguage(Language lang) {
     if (m_translator) { qApp->removeTranslator(m_translator.get()); }
 
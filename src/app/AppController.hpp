@@ -3,6 +3,10 @@
 #include <memory>
 #include "NotesAppCore.hpp"
 #include "AppSettings.hpp"
+#include "LinkedFileMonitor.hpp"
+#include "ContentIndexScheduler.hpp"
+#include "PdfExtractionPool.hpp"
+#include "RevisionCompactor.hpp"
 
 class QObject;
 class QString;
@@ -10,9 +14,11 @@ class SQLiteDB;
 class ResourceRepository;
 class FileRepository;
 class TextContentRepository;
+class RevisionRepository;
 class TagRepository;
 class FileService;
 class ResourceService;
+class ContentIndexRepository;
 class MainWindow;
 class QTranslator;
 
@@ -33,8 +39,29 @@ class AppController : public QObject {
 
         void updateSettings(const AppSettings &newSettings);
 
+        // Áp dụng resourceDir cho FileService và migrate storage phẳng cũ
+        void applyStorageSettings();
+
+        // Bật/tắt nén nội dung note theo settings, nén/giải nén các note đã lưu cho khớp
+        void applyCompressionSettings();
+
+        // Tạo/xóa index trigram cho nội dung theo settings (tìm chuỗi con "*abc")
+        void applySearchIndexSettings();
+
         [[nodiscard]] const AppSettings* settings() const noexcept;
 
+        // Theo dõi file linked; nullptr khi core chưa khởi tạo
+        [[nodiscard]] LinkedFileMonitor* fileMonitor() const noexcept;
+
+        // Index nội dung file (cpp/txt) chạy nền; nullptr khi core chưa khởi tạo
+        [[nodiscard]] ContentIndexScheduler* indexScheduler() const noexcept;
+
+        // Trích text PDF bằng tiến trình riêng; nullptr khi core chưa khởi tạo
+        [[nodiscard]] PdfExtractionPool* pdfPool() const noexcept;
+
+        // Dọn lịch sử note chạy nền; nullptr khi core chưa khởi tạo
+        [[nodiscard]] RevisionCompactor* revisionCompactor() const noexcept;
+
         void applyLanguage(Language lang);
         void applyTheme(Theme theme);
 
@@ -60,10 +87,16 @@ class AppController : public QObject {
         std::unique_ptr<SQLiteDB> m_db;
         std::unique_ptr<ResourceRepository> m_resRepo;
         std::unique_ptr<FileRepository> m_fileRepo;
+        std::unique_ptr<RevisionRepository> m_revisionRepo; // m_textRepo giữ con trỏ tới nó
         std::unique_ptr<TextContentRepository> m_textRepo;
         std::unique_ptr<TagRepository> m_tagRepo;
         std::unique_ptr<FileService> m_fileService;
+        std::unique_ptr<ContentIndexRepository> m_contentIndexRepo;
         std::unique_ptr<ResourceService> m_resService;
+        std::unique_ptr<LinkedFileMonitor> m_fileMonitor; // hủy trước service/repo nó tham chiếu
+        std::unique_ptr<ContentIndexScheduler> m_indexScheduler;
+        std::unique_ptr<PdfExtractionPool> m_pdfPool;
+        std::unique_ptr<RevisionCompactor> m_revisionCompactor;
 
         std::unique_ptr<AppSettings> m_settings;
 
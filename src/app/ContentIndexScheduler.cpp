@@ -0,0 +1,60 @@
+#include <exception>
+#include <QString>
+#include <QTimer>
+#include "ContentIndexScheduler.hpp"
+
+namespace {
+    constexpr std::size_t FILES_PER_BATCH{4};
+} // namespace
+
+ContentIndexScheduler::ContentIndexScheduler(SQLiteDB &db, ContentIndexRepository &indexRepo,
+                                             QObject* parent)
+    : QObject(parent), m_indexer(db, indexRepo) {
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(0);
+
+    connect(m_timer, &QTimer::timeout, this, &ContentIndexScheduler::processBatch);
+}
+
+void ContentIndexScheduler::suspend() {
+    m_suspended = true;
+    m_timer->stop();
+}
+
+void ContentIndexScheduler::resume() {
+    if (!m_suspended) { return; }
+
+    m_suspended = false;
+    schedule();
+}
+
+void ContentIndexScheduler::schedule() {
+    if (m_suspended || m_timer->isActive()) { return; }
+
+    m_timer->start();
+}
+
+void ContentIndexScheduler::processBatch() {
+    if (m_suspended) { return; }
+
+    std::size_t processed{0};
+    try {
+        processed = m_indexer.indexPending(FILES_PER_BATCH);
+    } catch (const std::exception &ex) {
+        m_indexedInRun = 0;
+        emit indexError(QString::fromStdString(ex.what()));
+        return;
+    }
+
+    m_indexedInRun += static_cast<int>(processed);
+
+    // Còn file chờ -> nhường event loop rồi làm tiếp
+    if (processed == FILES_PER_BATCH) {
+        m_timer->start();
+        return;
+    }
+
+    if (m_indexedInRun > 0) { emit indexed(m_indexedInRun); }
+    m_indexedInRun = 0;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QObject>
+#include "content_indexer.hpp"
+
+class QTimer;
+class QString;
+class SQLiteDB;
+class ContentIndexRepository;
+
+// Chạy ContentIndexer theo từng lát nhỏ trên GUI thread (QTimer 0 ms) để UI không bị đứng;
+// mỗi lát chỉ index vài file, bộ nhớ tối đa một chunk mỗi file
+class ContentIndexScheduler : public QObject {
+        Q_OBJECT
+
+    public:
+        ContentIndexScheduler(SQLiteDB &db, ContentIndexRepository &indexRepo,
+                              QObject* parent = nullptr);
+        ~ContentIndexScheduler() override = default;
+
+        // Import pipeline đang giữ connection
+        void suspend();
+        void resume();
+
+    signals:
+        void indexed(int count);
+        void indexError(const QString &message);
+
+    public slots:
+        // Có file mới/đổi hash -> index phần còn thiếu
+        void schedule();
+
+    private slots:
+        void processBatch();
+
+    private: // NOLINT(readability-redundant-access-specifiers)
+        ContentIndexer m_indexer;
+        QTimer* m_timer{};
+        bool m_suspended{};
+        int m_indexedInRun{};
+};
@@ -0,0 +1,55 @@
+#include <memory>
+#include <QMetaObject>
+#include <QString>
+#include "ImportWorker.hpp"
+#include "NotesAppCore.hpp"
+
+ImportWorker::ImportWorker(NotesAppCore &core, QObject* parent) : QObject(parent), m_core(core) {}
+
+ImportWorker::~ImportWorker() {
+    // Hủy và join pipeline trước khi QObject bị hủy => không còn queued call nào trỏ tới this
+    m_pipeline.reset();
+}
+
+bool ImportWorker::start(const QString &directory, bool isManaged) {
+    if (isRunning()) { return false; }
+
+    m_pipeline.reset();
+
+    ImportPipeline::Options options{.root = directory.toStdString(), .isManaged = isManaged};
+
+    m_pipeline = m_core.createImportPipeline(std::move(options), [this](const ImportProgress &p) {
+        // Gọi từ thread ghi DB -> chuyển về GUI thread
+        QMetaObject::invokeMethod(
+            this,
+            [this, p]() {
+                emit progressChanged(p);
+                if (p.finished) { emit finished(p); }
+            },
+            Qt::QueuedConnection);
+    });
+
+    m_pipeline->start();
+
+    return true;
+}
+
+bool ImportWorker::isRunning() const noexcept {
+    return m_pipeline && m_pipeline->isRunning();
+}
+
+bool ImportWorker::isPaused() const noexcept {
+    return m_pipeline && m_pipeline->isPaused();
+}
+
+void ImportWorker::pause() {
+    if (m_pipeline) { m_pipeline->pause(); }
+}
+
+void ImportWorker::resume() {
+    if (m_pipeline) { m_pipeline->resume(); }
+}
+
+void ImportWorker::cancel() {
+    if (m_pipeline) { m_pipeline->cancel(); }
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <memory>
+#include <QObject>
+#include "import_pipeline.hpp"
+
+class QString;
+class NotesAppCore;
+
+// Cầu nối ImportPipeline (thread thuần C++) với Qt: tiến độ được chuyển về GUI thread
+// bằng queued call rồi mới emit signal
+class ImportWorker : public QObject {
+        Q_OBJECT
+
+    public:
+        explicit ImportWorker(NotesAppCore &core, QObject* parent = nullptr);
+        ~ImportWorker() override;
+
+        bool start(const QString &directory, bool isManaged);
+
+        [[nodiscard]] bool isRunning() const noexcept;
+        [[nodiscard]] bool isPaused() const noexcept;
+
+    signals:
+        void progressChanged(const ImportProgress &progress);
+        void finished(const ImportProgress &progress);
+
+    public slots:
+        void pause();
+        void resume();
+        void cancel();
+
+    private:
+        NotesAppCore &m_core;
+        std::unique_ptr<ImportPipeline> m_pipeline;
+};
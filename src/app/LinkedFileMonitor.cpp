@@ -0,0 +1,107 @@
+#include <chrono>
+#include <exception>
+#include <QSocketNotifier>
+#include <QString>
+#include <QTimer>
+#include "LinkedFileMonitor.hpp"
+
+namespace {
+    // needsRescan() được kiểm tra mỗi phút; khoảng rescan thật nằm trong LinkedWatchOptions
+    constexpr int RESCAN_CHECK_MS{60 * 1000};
+} // namespace
+
+LinkedFileMonitor::LinkedFileMonitor(FileRepository &fileRepo, FileService &fileService,
+                                     QObject* parent)
+    : QObject(parent), m_watcher(fileRepo, fileService) {
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(static_cast<int>(LinkedWatchOptions{}.debounce.count()));
+
+    m_rescanTimer = new QTimer(this);
+    m_rescanTimer->setInterval(RESCAN_CHECK_MS);
+
+    connect(m_debounceTimer, &QTimer::timeout, this, &LinkedFileMonitor::onDebounceTimeout);
+    connect(m_rescanTimer, &QTimer::timeout, this, &LinkedFileMonitor::onRescanTimeout);
+}
+
+LinkedFileMonitor::~LinkedFileMonitor() {
+    // Gỡ notifier trước khi fd bị đóng trong ~LinkedFileWatcher
+    delete m_notifier;
+    m_notifier = nullptr;
+}
+
+void LinkedFileMonitor::start() {
+    if (m_watcher.isStarted()) { return; }
+
+    try {
+        report(m_watcher.start());
+    } catch (const std::exception &ex) {
+        emit watchError(QString::fromStdString(ex.what()));
+        return;
+    }
+
+    // Không có inotify (Windows, hết watch,...) -> chỉ còn rescan định kỳ
+    if (m_watcher.nativeHandle() >= 0) {
+        m_notifier = new QSocketNotifier(m_watcher.nativeHandle(), QSocketNotifier::Read, this);
+        connect(m_notifier, &QSocketNotifier::activated, this, &LinkedFileMonitor::onActivated);
+    }
+
+    m_rescanTimer->start();
+}
+
+void LinkedFileMonitor::suspend() {
+    m_suspended = true;
+    m_debounceTimer->stop();
+}
+
+void LinkedFileMonitor::resume() {
+    if (!m_suspended) { return; }
+
+    m_suspended = false;
+
+    // Sự kiện gom trong lúc suspend + file vừa import -> rescan một lần
+    refresh();
+}
+
+void LinkedFileMonitor::refresh() {
+    if (m_suspended || !m_watcher.isStarted()) { return; }
+
+    try {
+        report(m_watcher.rescan());
+    } catch (const std::exception &ex) { emit watchError(QString::fromStdString(ex.what())); }
+}
+
+void LinkedFileMonitor::onActivated() {
+    m_watcher.readEvents();
+
+    if (m_suspended) { return; }
+
+    if (m_watcher.needsRescan()) {
+        refresh();
+        return;
+    }
+
+    // Mỗi sự kiện mới đẩy lùi mốc ghi DB => cả burst chỉ ghi một lần
+    if (m_watcher.hasPending()) { m_debounceTimer->start(); }
+}
+
+void LinkedFileMonitor::onDebounceTimeout() {
+    if (m_suspended) { return; }
+
+    if (!m_watcher.isSettled()) {
+        if (m_watcher.hasPending()) { m_debounceTimer->start(); }
+        return;
+    }
+
+    try {
+        report(m_watcher.flush());
+    } catch (const std::exception &ex) { emit watchError(QString::fromStdString(ex.what())); }
+}
+
+void LinkedFileMonitor::onRescanTimeout() {
+    if (!m_suspended && m_watcher.needsRescan()) { refresh(); }
+}
+
+void LinkedFileMonitor::report(std::size_t changed) {
+    if (changed > 0) { emit filesChanged(static_cast<int>(changed)); }
+}
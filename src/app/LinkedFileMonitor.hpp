@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include "linked_file_watcher.hpp"
+
+class QSocketNotifier;
+class QTimer;
+class QString;
+class FileRepository;
+class FileService;
+
+// Gắn LinkedFileWatcher vào event loop của Qt: inotify fd -> QSocketNotifier,
+// debounce + rescan định kỳ bằng QTimer. Mọi thao tác DB chạy trên GUI thread.
+class LinkedFileMonitor : public QObject {
+        Q_OBJECT
+
+    public:
+        LinkedFileMonitor(FileRepository &fileRepo, FileService &fileService,
+                          QObject* parent = nullptr);
+        ~LinkedFileMonitor() override;
+
+        void start();
+
+        // Import pipeline đang giữ connection: chỉ gom sự kiện, không ghi DB
+        void suspend();
+        void resume();
+
+        [[nodiscard]] bool isSuspended() const noexcept { return m_suspended; }
+
+    signals:
+        void filesChanged(int count);
+        void watchError(const QString &message);
+
+    public slots:
+        // Đọc lại danh sách file linked (vd: vừa thêm file mới) và rescan
+        void refresh();
+
+    private slots:
+        void onActivated();
+        void onDebounceTimeout();
+        void onRescanTimeout();
+
+    private: // NOLINT(readability-redundant-access-specifiers)
+        void report(std::size_t changed);
+
+        LinkedFileWatcher m_watcher;
+        QSocketNotifier* m_notifier{};
+        QTimer* m_debounceTimer{};
+        QTimer* m_rescanTimer{};
+        bool m_suspended{};
+};
@@ -1,6 +1,7 @@
 #include "NotesAppCore.hpp"
 #include "resource_service.hpp"
 #include "file_service.hpp"
+#include "import_pipeline.hpp"
 
 // ========= CRUD =========
 sqlite3_int64 NotesAppCore::addTextNote(const std::string &title, const std::string &content,
@@ -43,6 +44,136 @@ std::vector<FullResource> NotesAppCore::getFullResourcesByTag(const std::string
     return m_resService.getFullResourcesByTag(tag);
 }
 
+SearchResult NotesAppCore::searchByTitleResult(const std::string &keyword) {
+    return m_resService.searchByTitleResult(keyword);
+}
+
+SearchResult NotesAppCore::searchByContentResult(const std::string &keyword) {
+    return m_resService.searchByContentResult(keyword);
+}
+
+SearchResult NotesAppCore::getResultByTag(const std::string &tag) {
+    return m_resService.getResultByTag(tag);
+}
+
+SearchPage NotesAppCore::searchByTitlePage(const std::string &keyword, std::size_t offset,
+                                           std::size_t limit) {
+    return m_searchCache.page(
+        SearchCache::pageKey(SearchCache::Mode::title, keyword, offset, limit),
+        [&] { return m_resService.searchByTitlePage(keyword, offset, limit); });
+}
+
+SearchPage NotesAppCore::getTagPage(const std::string &tag, std::size_t offset,
+                                    std::size_t limit) {
+    return m_searchCache.page(SearchCache::pageKey(SearchCache::Mode::tag, tag, offset, limit),
+                              [&] { return m_resService.getTagPage(tag, offset, limit); });
+}
+
+std::vector<ContentHit> NotesAppCore::searchContentHits(const std::string &keyword) {
+    return contentMatches(keyword)->hits;
+}
+
+SearchPage NotesAppCore::searchContentPage(const std::string &keyword, std::size_t offset,
+                                           std::size_t limit) {
+    return m_searchCache.page(
+        SearchCache::pageKey(SearchCache::Mode::content, keyword, offset, limit), [&] {
+            const auto matches = contentMatches(keyword);
+            return m_resService.contentHitPage(matches->hits, offset, limit);
+        });
+}
+
+std::shared_ptr<const QueryMatches> NotesAppCore::contentMatches(const std::string &keyword) {
+    return m_searchCache.matches(
+        SearchCache::matchesKey(SearchCache::Mode::content, keyword), [&] {
+            QueryMatches matches{.ids = {},
+                                 .hits = m_resService.searchContentHits(keyword),
+                                 .plan = m_resService.routeContentQuery(keyword).describe()};
+            matches.ids.reserve(matches.hits.size());
+            for (const auto &hit : matches.hits) { matches.ids.push_back(hit.resource_id); }
+            return matches;
+        });
+}
+
+SearchFacets NotesAppCore::searchFacets(SearchCache::Mode mode, const std::string &text) {
+    switch (mode) {
+        case SearchCache::Mode::title:
+            return m_resService.searchFacets(m_resService.searchTitleIds(text), kFacetTags);
+        case SearchCache::Mode::content:
+            return m_resService.searchFacets(contentMatches(text)->ids, kFacetTags);
+        case SearchCache::Mode::tag:
+            return m_resService.searchFacets(m_tagRepo.getResourceIdsViaOneTag(text), kFacetTags);
+        case SearchCache::Mode::query:
+            break;
+    }
+
+    const auto matches = searchQueryMatches(text);
+    return matches->facets.value_or(SearchFacets{});
+}
+
+std::vector<ContentHit> NotesAppCore::searchContentHits(const RoutedQuery &query) {
+    return m_resService.searchContentHits(query);
+}
+
+std::vector<ContentHit> NotesAppCore::searchContentHitsFuzzy(const std::string &keyword) {
+    return m_resService.searchContentHits(routeFuzzyContentQuery(keyword));
+}
+
+QueryMatches NotesAppCore::searchQuery(const SearchQuery &query) {
+    return m_resService.searchQuery(query);
+}
+
+std::shared_ptr<const QueryMatches> NotesAppCore::searchQueryMatches(const std::string &text) {
+    return m_searchCache.matches(SearchCache::matchesKey(SearchCache::Mode::query, text), [&] {
+        return m_resService.searchQuery(parseSearchQuery(text), kFacetTags);
+    });
+}
+
+SearchPage NotesAppCore::searchQueryPage(const std::string &text, std::size_t offset,
+                                         std::size_t limit) {
+    return m_searchCache.page(
+        SearchCache::pageKey(SearchCache::Mode::query, text, offset, limit), [&] {
+            const auto matches = searchQueryMatches(text);
+            return matches->hits.empty()
+                       ? m_resService.idPage(matches->ids, offset, limit)
+                       : m_resService.contentHitPage(matches->hits, offset, limit);
+        });
+}
+
+std::vector<ContentHit> NotesAppCore::findDefinitions(const std::string &name) {
+    return m_resService.findDefinitions(name);
+}
+
+SearchPage NotesAppCore::contentHitPage(std::span<const ContentHit> hits, std::size_t offset,
+                                        std::size_t limit) {
+    return m_resService.contentHitPage(hits, offset, limit);
+}
+
+RoutedQuery NotesAppCore::routeTitleQuery(std::string_view keyword) const {
+    return m_resService.routeTitleQuery(keyword);
+}
+
+RoutedQuery NotesAppCore::routeContentQuery(std::string_view keyword) const {
+    return m_resService.routeContentQuery(keyword);
+}
+
+RoutedQuery NotesAppCore::routeFuzzyContentQuery(std::string_view keyword) {
+    m_contentTerms.refreshContent(m_db);
+    return routeFuzzyQuery(keyword, m_contentTerms);
+}
+
+SearchPage NotesAppCore::idPage(std::span<const sqlite3_int64> ids, std::size_t offset,
+                                std::size_t limit) {
+    return m_resService.idPage(ids, offset, limit);
+}
+
+LiveSearch::Result NotesAppCore::liveSearchTitle(std::string_view keyword) {
+    return m_liveSearch.search(keyword);
+}
+
+void NotesAppCore::resetLiveSearch() noexcept {
+    m_liveSearch.reset();
+}
+
 std::vector<Resource> NotesAppCore::getResourcesByTags(const std::vector<std::string> &tags) {
     return m_resService.getResourcesByTags(tags);
 }
@@ -64,6 +195,19 @@ std::vector<std::pair<sqlite3_int64, std::string>> NotesAppCore::getAllTags() {
     return m_resService.getAllTags();
 }
 
+// ========= Import =========
+std::unique_ptr<ImportPipeline>
+    NotesAppCore::createImportPipeline(ImportPipeline::Options options,
+                                       ImportPipeline::ProgressCallback onProgress) {
+    return std::make_unique<ImportPipeline>(m_db, m_fileService, m_resRepo, std::move(options),
+                                            std::move(onProgress));
+}
+
+std::unique_ptr<RegexSearch> NotesAppCore::createRegexSearch(std::string_view pattern,
+                                                             RegexSearch::Options options) {
+    return std::make_unique<RegexSearch>(m_db, pattern, options);
+}
+
 bool NotesAppCore::isExistTitle(std::string_view title, ResourceType type) const {
     return m_resService.isExistTitle(title, type);
 }
@@ -1,16 +1,29 @@
 #pragma once
 
+#include <cstddef>
+#include <span>
 #include <string>
+#include <string_view>
+#include <memory>
 #include <optional>
 #include <vector>
 #include <utility>
 #include "model.hpp"
 #include "file_repository.hpp"
 #include "file_service.hpp"
+#include "import_pipeline.hpp"
+#include "live_search.hpp"
+#include "query_router.hpp"
+#include "regex_search.hpp"
 #include "resource_repository.hpp"
 #include "resource_service.hpp"
+#include "search_cache.hpp"
+#include "search_facets.hpp"
+#include "search_query.hpp"
+#include "search_result.hpp"
 #include "sqldb_raii.hpp"
 #include "tag_repository.hpp"
+#include "term_dictionary.hpp"
 #include "text_content_repository.hpp"
 
 class NotesAppCore {
@@ -38,6 +51,40 @@ class NotesAppCore {
         std::vector<FullResource> searchByContentFull(const std::string &keyword);
         std::vector<FullResource> searchByTitleFull(const std::string &keyword);
         std::vector<FullResource> getFullResourcesByTag(const std::string &tag);
+        SearchResult searchByTitleResult(const std::string &keyword);
+        SearchResult searchByContentResult(const std::string &keyword);
+        SearchResult getResultByTag(const std::string &tag);
+        // Phân trang cho view nạp dần (xem ResourceService)
+        SearchPage searchByTitlePage(const std::string &keyword, std::size_t offset,
+                                     std::size_t limit);
+        SearchPage getTagPage(const std::string &tag, std::size_t offset, std::size_t limit);
+        std::vector<ContentHit> searchContentHits(const std::string &keyword);
+        std::vector<ContentHit> searchContentHits(const RoutedQuery &query);
+        std::vector<ContentHit> findDefinitions(const std::string &name);
+        // Tìm theo nội dung chấp nhận gõ sai: mỗi từ mở rộng tới các term gần nó trong index
+        std::vector<ContentHit> searchContentHitsFuzzy(const std::string &keyword);
+        // "tag:cpp type:text content:mutex" (parseSearchQuery): mọi điều kiện trong một lần tìm
+        QueryMatches searchQuery(const SearchQuery &query);
+        // Như trên qua cache; trang của kết quả theo thứ tự ids/hits
+        std::shared_ptr<const QueryMatches> searchQueryMatches(const std::string &text);
+        SearchPage searchQueryPage(const std::string &text, std::size_t offset, std::size_t limit);
+        // Trang của searchContentHits(keyword); hit được tìm một lần rồi cache
+        SearchPage searchContentPage(const std::string &keyword, std::size_t offset,
+                                     std::size_t limit);
+        // Số resource theo tag/type của cả tập kết quả mà mode tìm được cho text, để lọc tiếp;
+        // content/query đếm trên danh sách đã cache, query cache luôn cả facet
+        SearchFacets searchFacets(SearchCache::Mode mode, const std::string &text);
+        // Index sẽ dùng cho từ khóa (để báo plan cho người dùng)
+        [[nodiscard]] RoutedQuery routeTitleQuery(std::string_view keyword) const;
+        [[nodiscard]] RoutedQuery routeContentQuery(std::string_view keyword) const;
+        [[nodiscard]] RoutedQuery routeFuzzyContentQuery(std::string_view keyword);
+        SearchPage contentHitPage(std::span<const ContentHit> hits, std::size_t offset,
+                                  std::size_t limit);
+        SearchPage idPage(std::span<const sqlite3_int64> ids, std::size_t offset,
+                          std::size_t limit);
+        // Tìm title khi đang gõ, lọc tiếp từ lần gõ trước nếu được (xem LiveSearch)
+        LiveSearch::Result liveSearchTitle(std::string_view keyword);
+        void resetLiveSearch() noexcept;
         std::vector<Resource> getResourcesByTags(const std::vector<std::string> &tags);
 
         // ========= Tags =========
@@ -46,11 +93,33 @@ class NotesAppCore {
         void removeTag(sqlite3_int64 resourceId, const std::string &tag);
         std::vector<std::pair<sqlite3_int64, std::string>> getAllTags();
 
+        // Các hàm *Page, searchContentHits(keyword) và searchQueryMatches đi qua cache kết quả
+        // (xem SearchCache); ghi vào bảng liên quan thì mục cũ tự mất hiệu lực
+        void setSearchCacheBudget(std::size_t bytes) { m_searchCache.setBudget(bytes); }
+        [[nodiscard]] const SearchCache::Stats &searchCacheStats() const noexcept {
+            return m_searchCache.stats();
+        }
+
+        // ========= Import =========
+        // Import cả thư mục ở background; pipeline dùng chung connection với core
+        [[nodiscard]] std::unique_ptr<ImportPipeline>
+            createImportPipeline(ImportPipeline::Options options,
+                                 ImportPipeline::ProgressCallback onProgress);
+        // Tìm regex trên note và file liên kết; worker chạy ngay, caller gọi poll() định kỳ.
+        // Ném std::runtime_error nếu pattern không hợp lệ
+        [[nodiscard]] std::unique_ptr<RegexSearch>
+            createRegexSearch(std::string_view pattern, RegexSearch::Options options = {});
+
         // ========= Utility =========
         [[nodiscard]] bool isExistTitle(std::string_view title, ResourceType type) const;
         [[nodiscard]] bool isFileIndexed(const std::string &filepath) const;
 
     private:
+        static constexpr std::size_t kSearchCacheBytes{32 * 1024 * 1024};
+        static constexpr std::size_t kFacetTags{10};
+
+        std::shared_ptr<const QueryMatches> contentMatches(const std::string &keyword);
+
         SQLiteDB &m_db;
         ResourceRepository &m_resRepo;
         FileRepository &m_fileRepo;
@@ -58,4 +127,7 @@ class NotesAppCore {
         TagRepository &m_tagRepo;
         FileService &m_fileService;
         ResourceService &m_resService;
+        LiveSearch m_liveSearch{m_db, m_resRepo};
+        TermDictionary m_contentTerms; // chỉ nạp lại khi DB đã đổi từ lần tìm fuzzy trước
+        SearchCache m_searchCache{m_db.generations(), kSearchCacheBytes};
 };
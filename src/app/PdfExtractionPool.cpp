@@ -0,0 +1,216 @@
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QTimer>
+#include "PdfExtractionPool.hpp"
+#include "content_index_repository.hpp"
+#include "content_indexer.hpp"
+#include "model.hpp"
+#include "pdf_worker_protocol.hpp"
+
+namespace {
+    constexpr std::size_t MAX_PROCESSES{2};
+    constexpr int MAX_PAGES{2000};          // ngân sách trang mỗi file
+    constexpr int CPU_SECONDS{60};          // worker tự đặt RLIMIT_CPU
+    constexpr int WALL_TIMEOUT_MS{120'000}; // tính cả thời gian chờ mà RLIMIT_CPU không đếm
+    constexpr int KILL_WAIT_MS{1000};
+} // namespace
+
+struct PdfExtractionPool::Job {
+        Job(SQLiteDB &db, ContentIndexRepository &indexRepo, IndexCandidate candidate)
+            : writer(db, indexRepo, std::move(candidate)),
+              decoder(
+                  [this](int page, std::string_view text) {
+                      writing = true;
+                      writer.addPage(page, text);
+                      writing = false;
+                  },
+                  [this](int) { done = true; },
+                  [this](std::string_view message) { error = std::string(message); }) {}
+
+        PageChunkWriter writer;
+        PdfWorkerDecoder decoder;
+        QProcess* process{};
+        QTimer* budget{};
+
+        std::optional<std::string> error;   // worker báo lỗi hoặc output sai giao thức
+        std::optional<std::string> dbError; // ghi DB lỗi: không ghi trạng thái, lượt sau thử lại
+        bool done{};
+        bool timedOut{};
+        bool writing{};
+};
+
+PdfExtractionPool::PdfExtractionPool(SQLiteDB &db, ContentIndexRepository &indexRepo,
+                                     QString workerPath, QObject* parent)
+    : QObject(parent), m_db(db), m_indexRepo(indexRepo), m_workerPath(std::move(workerPath)) {}
+
+PdfExtractionPool::~PdfExtractionPool() {
+    stopAll();
+}
+
+QString PdfExtractionPool::findWorker() {
+    return QStandardPaths::findExecutable("notes-pdf-worker",
+                                          {QCoreApplication::applicationDirPath()});
+}
+
+void PdfExtractionPool::suspend() {
+    m_suspended = true;
+
+    // File đang trích chưa có trạng thái index => vẫn ở hàng chờ, resume sẽ chạy lại từ đầu
+    stopAll();
+}
+
+void PdfExtractionPool::resume() {
+    if (!m_suspended) { return; }
+
+    m_suspended = false;
+    schedule();
+}
+
+void PdfExtractionPool::schedule() {
+    if (m_suspended || m_workerPath.isEmpty()) { return; }
+
+    try {
+        while (!m_workerPath.isEmpty() && m_jobs.size() < MAX_PROCESSES) {
+            // File đang chạy vẫn nằm trong hàng chờ: lấy dư để bỏ qua chúng
+            const auto candidates =
+                m_indexRepo.getPendingFiles({ResourceType::pdf}, m_jobs.size() + 1);
+
+            const auto next = std::ranges::find_if(candidates, [&](const IndexCandidate &c) {
+                return std::ranges::none_of(m_jobs, [&](const auto &job) {
+                    return job->writer.candidate().resource_id == c.resource_id;
+                });
+            });
+            if (next == candidates.end()) { break; }
+
+            m_jobs.push_back(std::make_unique<Job>(m_db, m_indexRepo, *next));
+            startJob(*m_jobs.back());
+        }
+    } catch (const std::exception &ex) {
+        emit indexError(QString::fromStdString(ex.what()));
+    }
+
+    if (m_jobs.empty() && m_indexedInRun > 0) {
+        emit indexed(m_indexedInRun);
+        m_indexedInRun = 0;
+    }
+}
+
+void PdfExtractionPool::startJob(Job &job) {
+    job.process = new QProcess(this);
+    job.process->setStandardInputFile(QProcess::nullDevice());
+    job.process->setStandardErrorFile(QProcess::nullDevice());
+
+    job.budget = new QTimer(job.process);
+    job.budget->setSingleShot(true);
+
+    connect(job.process, &QProcess::readyReadStandardOutput, this, [this, &job] {
+        onReadyRead(job);
+    });
+    connect(job.process, &QProcess::finished, this,
+            [this, &job](int exitCode, QProcess::ExitStatus status) {
+                onFinished(job, exitCode, status);
+            });
+    connect(job.process, &QProcess::errorOccurred, this, [this, &job](QProcess::ProcessError e) {
+        // Không chạy được worker: không phải lỗi của file, tắt pool thay vì đánh dấu mọi PDF
+        if (e == QProcess::FailedToStart) {
+            emit indexError(tr("Cannot start PDF worker: %1").arg(job.process->errorString()));
+            m_workerPath.clear();
+            removeJob(job);
+        }
+    });
+    connect(job.budget, &QTimer::timeout, this, [this, &job] { onTimeout(job); });
+
+    const QStringList args{"--max-pages", QString::number(MAX_PAGES),
+                           "--cpu-seconds", QString::number(CPU_SECONDS),
+                           QString::fromStdString(job.writer.candidate().path)};
+
+    job.budget->start(WALL_TIMEOUT_MS);
+    job.process->start(m_workerPath, args);
+}
+
+void PdfExtractionPool::onReadyRead(Job &job) {
+    const QByteArray data = job.process->readAllStandardOutput();
+    const std::string_view chunk(data.constData(), static_cast<std::size_t>(data.size()));
+
+    // Đã quyết định dừng worker: bỏ phần output còn lại
+    if (job.error.has_value() || job.dbError.has_value()) { return; }
+
+    try {
+        job.decoder.feed(chunk);
+    } catch (const std::exception &ex) {
+        if (job.writing) {
+            job.dbError = ex.what();
+        } else {
+            job.error = ex.what();
+        }
+        job.process->kill(); // finished tới sau và kết thúc job
+    }
+}
+
+void PdfExtractionPool::onTimeout(Job &job) {
+    job.timedOut = true;
+    job.process->kill();
+}
+
+void PdfExtractionPool::onFinished(Job &job, int exitCode, QProcess::ExitStatus status) {
+    onReadyRead(job);
+    job.budget->stop();
+
+    if (job.dbError.has_value()) {
+        emit indexError(QString::fromStdString(*job.dbError));
+        removeJob(job);
+        return; // không schedule lại ngay: DB đang lỗi
+    }
+
+    std::optional<std::string> failure = job.error;
+    if (!failure.has_value()) {
+        if (job.timedOut) {
+            failure = "PDF extraction timed out";
+        } else if (status == QProcess::CrashExit || !job.done) {
+            // Crash hoặc bị hệ điều hành dừng khi vượt giới hạn CPU/bộ nhớ
+            failure = "PDF worker stopped unexpectedly (exit code " + std::to_string(exitCode) +
+                      ")";
+        }
+    }
+
+    try {
+        if (failure.has_value()) {
+            job.writer.fail(*failure);
+        } else {
+            job.writer.finish();
+        }
+        ++m_indexedInRun;
+    } catch (const std::exception &ex) { emit indexError(QString::fromStdString(ex.what())); }
+
+    removeJob(job);
+    schedule();
+}
+
+void PdfExtractionPool::removeJob(Job &job) {
+    job.process->disconnect(this);
+    job.budget->disconnect(this);
+    job.budget->stop();
+    job.process->deleteLater(); // có thể đang ở trong signal của chính process này
+
+    std::erase_if(m_jobs, [&](const auto &item) { return item.get() == &job; });
+}
+
+void PdfExtractionPool::stopAll() {
+    for (const auto &job : m_jobs) {
+        job->process->disconnect(this);
+        job->budget->disconnect(this);
+        job->process->kill();
+        job->process->waitForFinished(KILL_WAIT_MS);
+        job->process->deleteLater();
+    }
+    m_jobs.clear();
+    m_indexedInRun = 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <QObject>
+#include <QProcess>
+#include <QString>
+
+class SQLiteDB;
+class ContentIndexRepository;
+
+// Index text PDF bằng các tiến trình notes-pdf-worker (mỗi file một tiến trình, tối đa vài
+// tiến trình cùng lúc). Worker crash, treo hoặc vượt ngân sách thời gian/trang chỉ làm hỏng
+// file đó: app ghi nhận lỗi và không thử lại đến khi file đổi. Mọi thao tác DB chạy trên
+// GUI thread khi stdout của worker có dữ liệu (QProcess bất đồng bộ, không block UI).
+class PdfExtractionPool : public QObject {
+        Q_OBJECT
+
+    public:
+        PdfExtractionPool(SQLiteDB &db, ContentIndexRepository &indexRepo, QString workerPath,
+                          QObject* parent = nullptr);
+        ~PdfExtractionPool() override;
+
+        // Tìm notes-pdf-worker cạnh file thực thi của app; rỗng nếu không có
+        [[nodiscard]] static QString findWorker();
+
+        // Import pipeline đang giữ connection: dừng các worker đang chạy, chạy lại sau resume
+        void suspend();
+        void resume();
+
+    signals:
+        void indexed(int count);
+        void indexError(const QString &message);
+
+    public slots:
+        // Có file mới/đổi hash -> trích các PDF còn thiếu
+        void schedule();
+
+    private:
+        struct Job;
+
+        void startJob(Job &job);
+        void onReadyRead(Job &job);
+        void onFinished(Job &job, int exitCode, QProcess::ExitStatus status);
+        void onTimeout(Job &job);
+        void abort(Job &job, const QString &reason);
+        void removeJob(Job &job);
+        void stopAll();
+
+        SQLiteDB &m_db;
+        ContentIndexRepository &m_indexRepo;
+        QString m_workerPath;
+        std::vector<std::unique_ptr<Job>> m_jobs;
+        bool m_suspended{};
+        int m_indexedInRun{};
+};
@@ -0,0 +1,66 @@
+#include <exception>
+#include <QString>
+#include <QTimer>
+#include "RevisionCompactor.hpp"
+#include "revision_repository.hpp"
+
+namespace {
+    constexpr std::size_t NOTES_PER_BATCH{8};
+    constexpr int COMPACT_INTERVAL_MS{10 * 60 * 1000};
+} // namespace
+
+RevisionCompactor::RevisionCompactor(RevisionRepository &revisions, QObject* parent)
+    : QObject(parent), m_revisions(revisions) {
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    m_timer->setInterval(0);
+
+    m_periodic = new QTimer(this);
+    m_periodic->setInterval(COMPACT_INTERVAL_MS);
+
+    connect(m_timer, &QTimer::timeout, this, &RevisionCompactor::processBatch);
+    connect(m_periodic, &QTimer::timeout, this, &RevisionCompactor::schedule);
+    m_periodic->start();
+}
+
+void RevisionCompactor::suspend() {
+    m_suspended = true;
+    m_timer->stop();
+}
+
+void RevisionCompactor::resume() {
+    if (!m_suspended) { return; }
+
+    m_suspended = false;
+    schedule();
+}
+
+void RevisionCompactor::schedule() {
+    if (m_suspended || m_timer->isActive()) { return; }
+
+    m_timer->start();
+}
+
+void RevisionCompactor::processBatch() {
+    if (m_suspended) { return; }
+
+    std::size_t notes{0};
+    try {
+        const auto ids = m_revisions.getNotesToCompact(NOTES_PER_BATCH);
+        for (const auto id : ids) { m_removedInRun += static_cast<int>(m_revisions.compact(id)); }
+        notes = ids.size();
+    } catch (const std::exception &ex) {
+        m_removedInRun = 0;
+        emit compactError(QString::fromStdString(ex.what()));
+        return;
+    }
+
+    // Còn note chờ -> nhường event loop rồi làm tiếp
+    if (notes == NOTES_PER_BATCH) {
+        m_timer->start();
+        return;
+    }
+
+    if (m_removedInRun > 0) { emit compacted(m_removedInRun); }
+    m_removedInRun = 0;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QObject>
+
+class QTimer;
+class QString;
+class RevisionRepository;
+
+// Dọn lịch sử note trên GUI thread theo từng lát nhỏ (QTimer 0 ms): mỗi lát compact vài note
+// có quá nhiều phiên bản. Chạy lúc khởi động rồi định kỳ, không chặn lần ghi note
+class RevisionCompactor : public QObject {
+        Q_OBJECT
+
+    public:
+        explicit RevisionCompactor(RevisionRepository &revisions, QObject* parent = nullptr);
+        ~RevisionCompactor() override = default;
+
+        // Import pipeline đang giữ connection
+        void suspend();
+        void resume();
+
+    signals:
+        void compacted(int removed);
+        void compactError(const QString &message);
+
+    public slots:
+        void schedule();
+
+    private slots:
+        void processBatch();
+
+    private: // NOLINT(readability-redundant-access-specifiers)
+        RevisionRepository &m_revisions;
+        QTimer* m_timer{};
+        QTimer* m_periodic{};
+        bool m_suspended{};
+        int m_removedInRun{};
+};
@@ -0,0 +1,109 @@
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sqlite3.h>
+#include "code_tokenizer.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    using TokenCallback = int (*)(void*, int, const char*, int, int, int);
+
+    // Mỗi bảng FTS một instance; unicode61 bên trong xử lý đoạn không phải ASCII
+    struct CodeTokenizer {
+            fts5_tokenizer unicode{};
+            Fts5Tokenizer* unicodeInstance{};
+    };
+
+    // Chuyển token của unicode61 ra ngoài, dời offset về text gốc
+    struct ForeignContext {
+            void* ctx{};
+            TokenCallback xToken{};
+            int offset{};
+    };
+
+    int forwardToken(void* ctx, int flags, const char* token, int size, int begin, int end) {
+        auto* forward = static_cast<ForeignContext*>(ctx);
+        return forward->xToken(forward->ctx, flags, token, size, begin + forward->offset,
+                               end + forward->offset);
+    }
+
+    int createTokenizer(void* userData, const char** args, int argc, Fts5Tokenizer** out) {
+        auto* api = static_cast<fts5_api*>(userData);
+
+        auto* tokenizer = new (std::nothrow) CodeTokenizer;
+        if (tokenizer == nullptr) { return SQLITE_NOMEM; }
+
+        void* unicodeData = nullptr;
+        int rc = api->xFindTokenizer(api, "unicode61", &unicodeData, &tokenizer->unicode);
+        if (rc == SQLITE_OK) {
+            rc = tokenizer->unicode.xCreate(unicodeData, args, argc, &tokenizer->unicodeInstance);
+        }
+        if (rc != SQLITE_OK) {
+            delete tokenizer;
+            return rc;
+        }
+
+        *out = reinterpret_cast<Fts5Tokenizer*>(tokenizer);
+        return SQLITE_OK;
+    }
+
+    void deleteTokenizer(Fts5Tokenizer* handle) {
+        auto* tokenizer = reinterpret_cast<CodeTokenizer*>(handle);
+        tokenizer->unicode.xDelete(tokenizer->unicodeInstance);
+        delete tokenizer;
+    }
+
+    int tokenize(Fts5Tokenizer* handle, void* ctx, int flags, const char* text, int size,
+                 TokenCallback xToken) {
+        auto* tokenizer = reinterpret_cast<CodeTokenizer*>(handle);
+        const std::string_view view(text, static_cast<std::size_t>(size));
+        int rc = SQLITE_OK;
+
+        try {
+            forEachCodeToken(
+                view, (flags & FTS5_TOKENIZE_QUERY) != 0,
+                [&](std::string_view token, std::size_t begin, std::size_t end, bool colocated) {
+                    rc = xToken(ctx, colocated ? FTS5_TOKEN_COLOCATED : 0, token.data(),
+                                static_cast<int>(token.size()), static_cast<int>(begin),
+                                static_cast<int>(end));
+                    return rc == SQLITE_OK;
+                },
+                [&](std::size_t begin, std::size_t end) {
+                    ForeignContext forward{.ctx = ctx,
+                                           .xToken = xToken,
+                                           .offset = static_cast<int>(begin)};
+                    rc = tokenizer->unicode.xTokenize(tokenizer->unicodeInstance, &forward, flags,
+                                                      text + begin, static_cast<int>(end - begin),
+                                                      forwardToken);
+                    return rc == SQLITE_OK;
+                });
+        } catch (const std::bad_alloc &) { return SQLITE_NOMEM; }
+
+        // SQLITE_DONE: nơi gọi đã lấy đủ token, không phải lỗi (như các tokenizer có sẵn)
+        return rc == SQLITE_DONE ? SQLITE_OK : rc;
+    }
+
+    fts5_api* fts5Api(sqlite3* db) {
+        fts5_api* api = nullptr;
+
+        SQLiteStmt stmt(db, "SELECT fts5(?1);");
+        sqlite3_bind_pointer(stmt.get(), 1, static_cast<void*>(&api), "fts5_api_ptr", nullptr);
+        sqlite3_step(stmt.get());
+
+        return api;
+    }
+} // namespace
+
+void registerCodeTokenizer(sqlite3* db) {
+    fts5_api* api = fts5Api(db);
+    if (api == nullptr) { throw std::runtime_error("SQLite was built without FTS5"); }
+
+    fts5_tokenizer tokenizer{.xCreate = createTokenizer,
+                             .xDelete = deleteTokenizer,
+                             .xTokenize = tokenize};
+    if (api->xCreateTokenizer(api, kCodeTokenizerName, api, &tokenizer, nullptr) != SQLITE_OK) {
+        throw std::runtime_error(std::string("Failed to register FTS5 tokenizer: ") +
+                                 sqlite3_errmsg(db));
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+
+// Tokenizer FTS5 "code" cho note chủ yếu là code C++. Identifier ASCII (chữ, số, '_', nối bằng
+// "::") được tách thành từ con theo camelCase, snake_case và từng đoạn "::":
+//   getTagIdByName  -> get tag id by name + "gettagidbyname" (cùng vị trí với "get")
+//   std::unordered_map -> std unordered map + "stdunorderedmap"
+// Từ con có vị trí liên tiếp nên "tag id" khớp như một phrase; identifier đầy đủ (bỏ dấu nối,
+// chữ thường) là token colocated với từ con đầu. Truy vấn (FTS5_TOKENIZE_QUERY) chỉ sinh từ con.
+// Đoạn có byte >= 0x80 (tiếng Việt...) chuyển nguyên cho unicode61 với các tham số còn lại của
+// tokenize (vd 'code remove_diacritics 1'), nên text không phải code được index như trước.
+inline constexpr const char* kCodeTokenizerName = "code";
+
+// Đăng ký tokenizer trên connection; ném std::runtime_error nếu SQLite không có FTS5
+void registerCodeTokenizer(sqlite3* db);
+
+namespace code_tokenizer {
+    [[nodiscard]] constexpr bool isUpper(char c) noexcept { return c >= 'A' && c <= 'Z'; }
+
+    [[nodiscard]] constexpr bool isLower(char c) noexcept { return c >= 'a' && c <= 'z'; }
+
+    [[nodiscard]] constexpr bool isDigit(char c) noexcept { return c >= '0' && c <= '9'; }
+
+    [[nodiscard]] constexpr bool isAlnum(char c) noexcept {
+        return isUpper(c) || isLower(c) || isDigit(c);
+    }
+
+    [[nodiscard]] constexpr bool isForeign(char c) noexcept {
+        return static_cast<unsigned char>(c) >= 0x80U;
+    }
+
+    [[nodiscard]] constexpr bool isWordByte(char c) noexcept {
+        return isAlnum(c) || c == '_' || isForeign(c);
+    }
+
+    [[nodiscard]] constexpr char toLower(char c) noexcept {
+        return isUpper(c) ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    // Ranh giới camelCase trước text[i] (text[i - 1], text[i] đều là chữ/số):
+    // aB, 9B (utf8Decode) và AAb (HTMLParser -> HTML | Parser)
+    [[nodiscard]] constexpr bool camelBoundary(std::string_view text, std::size_t i) noexcept {
+        const char prev = text[i - 1];
+        const char cur = text[i];
+        if (!isUpper(cur)) { return false; }
+        if (!isUpper(prev)) { return true; }
+        return i + 1 < text.size() && isLower(text[i + 1]);
+    }
+
+    using Span = std::pair<std::size_t, std::size_t>; // [begin, end) trong text
+
+    // Từ con của một identifier ASCII text[begin, end)
+    inline void splitWords(std::string_view text, std::size_t begin, std::size_t end,
+                           std::vector<Span> &words) {
+        words.clear();
+        std::size_t start = begin;
+        for (std::size_t i = begin; i <= end; ++i) {
+            const bool atEnd = i == end || !isAlnum(text[i]);
+            if (!atEnd && (i == start || !camelBoundary(text, i))) { continue; }
+
+            if (i > start) { words.emplace_back(start, i); }
+            start = atEnd ? i + 1 : i;
+        }
+    }
+} // namespace code_tokenizer
+
+// Quét text một lượt theo byte:
+//   onToken(token, begin, end, colocated) -> bool: token đã hạ chữ thường, false để dừng
+//   onForeign(begin, end) -> bool: đoạn chứa byte >= 0x80 (gộp các đoạn liền kề), để unicode61
+//   tách
+// Identifier đầy đủ chỉ sinh khi có từ hai từ con trở lên và query = false.
+template <typename OnToken, typename OnForeign>
+bool forEachCodeToken(std::string_view text, bool query, OnToken &&onToken,
+                      OnForeign &&onForeign) {
+    using namespace code_tokenizer;
+
+    std::vector<Span> words;
+    std::string token;
+    std::string whole;
+
+    const auto emit = [&](std::size_t begin, std::size_t end, bool colocated) {
+        token.assign(text.substr(begin, end - begin));
+        for (auto &c : token) { c = toLower(c); }
+        return onToken(std::string_view(token), begin, end, colocated);
+    };
+
+    std::size_t foreignBegin{};
+    std::size_t foreignEnd{};
+    bool foreign{};
+
+    std::size_t pos{0};
+    while (pos < text.size()) {
+        if (!isWordByte(text[pos])) {
+            ++pos;
+            continue;
+        }
+
+        // Một identifier: byte chữ, '_' hoặc "::" nằm giữa hai byte chữ
+        const std::size_t begin = pos;
+        bool ascii = true;
+        while (pos < text.size()) {
+            if (isWordByte(text[pos])) {
+                ascii = ascii && !isForeign(text[pos]);
+                ++pos;
+            } else if (text[pos] == ':' && pos + 2 < text.size() && text[pos + 1] == ':' &&
+                       isWordByte(text[pos + 2])) {
+                pos += 2;
+            } else {
+                break;
+            }
+        }
+
+        if (!ascii) {
+            if (!foreign) { foreignBegin = begin; }
+            foreign = true;
+            foreignEnd = pos;
+            continue;
+        }
+        if (foreign) {
+            foreign = false;
+            if (!onForeign(foreignBegin, foreignEnd)) { return false; }
+        }
+
+        splitWords(text, begin, pos, words);
+        for (std::size_t i = 0; i < words.size(); ++i) {
+            if (!emit(words[i].first, words[i].second, false)) { return false; }
+            if (i != 0 || query || words.size() < 2) { continue; }
+
+            whole.clear();
+            for (const auto &[wordBegin, wordEnd] : words) {
+                for (std::size_t k = wordBegin; k < wordEnd; ++k) { whole += toLower(text[k]); }
+            }
+            if (!onToken(std::string_view(whole), words.front().first, words.back().second,
+                         true)) {
+                return false;
+            }
+        }
+    }
+
+    return !foreign || onForeign(foreignBegin, foreignEnd);
+}
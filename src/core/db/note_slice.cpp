@@ -0,0 +1,99 @@
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <sqlite3.h>
+#include "note_slice.hpp"
+#include "sqldb_raii.hpp"
+#include "text_codec.hpp"
+
+namespace {
+    // Trạng thái theo connection (hàm chạy khi connection đang bị khóa nên không cần mutex)
+    struct SliceState {
+            std::unordered_map<std::uint32_t, TextCodec> codecs; // cache theo id từ điển
+            std::string blob;                                    // blob nén của note trong text
+            std::string text;
+    };
+
+    const TextCodec &codecFor(sqlite3* db, SliceState &state, std::uint32_t dictionaryId) {
+        if (const auto found = state.codecs.find(dictionaryId); found != state.codecs.end()) {
+            return found->second;
+        }
+
+        std::string dictionary;
+        if (dictionaryId != 0) {
+            SQLiteStmt stmt(db, "SELECT dictionary FROM text_dictionaries WHERE id = ?;");
+            sqlite3_bind_int64(stmt.get(), 1, dictionaryId);
+
+            if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+                throw std::runtime_error("Missing text dictionary: " +
+                                         std::to_string(dictionaryId));
+            }
+
+            const auto* ptr = static_cast<const char*>(sqlite3_column_blob(stmt.get(), 0));
+            dictionary.assign(ptr, static_cast<std::size_t>(sqlite3_column_bytes(stmt.get(), 0)));
+        }
+
+        return state.codecs.try_emplace(dictionaryId, dictionaryId, std::move(dictionary))
+            .first->second;
+    }
+
+    std::string_view noteText(sqlite3_context* ctx, sqlite3_value* content) {
+        if (sqlite3_value_type(content) != SQLITE_BLOB) {
+            const auto* ptr = reinterpret_cast<const char*>(sqlite3_value_text(content));
+            return {ptr, static_cast<std::size_t>(sqlite3_value_bytes(content))};
+        }
+
+        auto &state = *static_cast<SliceState*>(sqlite3_user_data(ctx));
+        const auto* ptr = static_cast<const char*>(sqlite3_value_blob(content));
+        const std::string_view blob(ptr, static_cast<std::size_t>(sqlite3_value_bytes(content)));
+
+        if (blob != state.blob) {
+            const auto &codec =
+                codecFor(sqlite3_context_db_handle(ctx), state, TextCodec::dictionaryId(blob));
+            state.text = codec.decompress(blob);
+            state.blob.assign(blob);
+        }
+
+        return state.text;
+    }
+
+    void noteSlice(sqlite3_context* ctx, int /*argc*/, sqlite3_value** argv) {
+        if (sqlite3_value_type(argv[0]) == SQLITE_NULL) { return; } // NULL
+
+        const auto offset = sqlite3_value_int64(argv[1]);
+        const auto length = sqlite3_value_int64(argv[2]);
+
+        try {
+            const auto text = noteText(ctx, argv[0]);
+            if (offset < 0 || length < 0 ||
+                static_cast<std::uint64_t>(offset) + static_cast<std::uint64_t>(length) >
+                    text.size()) {
+                sqlite3_result_error(ctx, "note_slice: chunk lies outside the note text", -1);
+                return;
+            }
+
+            sqlite3_result_text64(ctx, text.data() + offset, static_cast<sqlite3_uint64>(length),
+                                  SQLITE_TRANSIENT, SQLITE_UTF8);
+        } catch (const std::exception &e) {
+            sqlite3_result_error(ctx, e.what(), -1);
+        }
+    }
+
+    void destroyState(void* state) { delete static_cast<SliceState*>(state); }
+} // namespace
+
+void registerNoteSliceFunction(sqlite3* db) {
+    // SQLite gọi destroyState cả khi đăng ký thất bại
+    const int rc = sqlite3_create_function_v2(
+        db, kNoteSliceFunctionName, 3, SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+        std::make_unique<SliceState>().release(), noteSlice, nullptr, nullptr, destroyState);
+    if (rc != SQLITE_OK) {
+        throw std::runtime_error(std::string("Failed to register SQL function: ") +
+                                 sqlite3_errmsg(db));
+    }
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <sqlite3.h>
+
+// Hàm SQL note_slice(content, byte_offset, byte_len): đoạn [byte_offset, byte_offset + byte_len)
+// của nội dung note dạng TEXT. content là text_content.content, TEXT hoặc BLOB nén (TextCodec,
+// từ điển đọc từ text_dictionaries trên cùng connection). View text_chunk_texts dùng hàm này để
+// FTS5 đọc chunk từ nội dung note thay vì giữ thêm một bản text thường trong text_chunks.
+// Note giải nén gần nhất được giữ lại (chunk của một note thường được đọc liền nhau); đoạn nằm
+// ngoài nội dung hoặc blob hỏng là lỗi SQL chứ không trả về text sai.
+inline constexpr const char* kNoteSliceFunctionName = "note_slice";
+
+// Đăng ký trên connection; ném std::runtime_error nếu SQLite từ chối
+void registerNoteSliceFunction(sqlite3* db);
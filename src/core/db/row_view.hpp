@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <sqlite3.h>
+#include "model.hpp"
+#include "sqldb_raii.hpp"
+
+// Đọc kết quả truy vấn không copy: string_view/span trỏ thẳng vào bộ nhớ của sqlite3_stmt nên
+// chỉ hợp lệ đến lần step/reset/finalize kế tiếp của statement. Cần giữ lâu hơn thì tự copy.
+class RowView {
+    public:
+        explicit RowView(sqlite3_stmt* stmt) noexcept : m_stmt(stmt) {}
+
+        [[nodiscard]] sqlite3_stmt* stmt() const noexcept { return m_stmt; }
+
+        [[nodiscard]] int columnCount() const noexcept { return sqlite3_column_count(m_stmt); }
+
+        [[nodiscard]] int type(int column) const noexcept {
+            return sqlite3_column_type(m_stmt, column);
+        }
+
+        [[nodiscard]] bool isNull(int column) const noexcept { return type(column) == SQLITE_NULL; }
+
+        [[nodiscard]] sqlite3_int64 int64(int column) const noexcept {
+            return sqlite3_column_int64(m_stmt, column);
+        }
+
+        [[nodiscard]] double real(int column) const noexcept {
+            return sqlite3_column_double(m_stmt, column);
+        }
+
+        // NULL => view rỗng
+        [[nodiscard]] std::string_view text(int column) const noexcept {
+            // Gọi column_text trước column_bytes (thứ tự SQLite yêu cầu khi phải đổi kiểu)
+            const auto* ptr = reinterpret_cast<const char*>(sqlite3_column_text(m_stmt, column));
+            if (ptr == nullptr) { return {}; }
+            return {ptr, static_cast<std::size_t>(sqlite3_column_bytes(m_stmt, column))};
+        }
+
+        [[nodiscard]] std::span<const std::byte> blob(int column) const noexcept {
+            const auto* ptr = static_cast<const std::byte*>(sqlite3_column_blob(m_stmt, column));
+            if (ptr == nullptr) { return {}; }
+            return {ptr, static_cast<std::size_t>(sqlite3_column_bytes(m_stmt, column))};
+        }
+
+        // Giải mã theo ColumnDecoder<T> (khai báo bên dưới)
+        template <typename T> [[nodiscard]] T get(int column) const;
+
+        // Cột 0..N-1 theo thứ tự kiểu
+        template <typename... Columns> [[nodiscard]] std::tuple<Columns...> as() const {
+            return asImpl<Columns...>(std::index_sequence_for<Columns...>{});
+        }
+
+    private:
+        sqlite3_stmt* m_stmt;
+
+        template <typename... Columns, std::size_t... I>
+        [[nodiscard]] std::tuple<Columns...> asImpl(std::index_sequence<I...> /*unused*/) const {
+            return {get<Columns>(static_cast<int>(I))...};
+        }
+};
+
+// Cách đọc một cột thành kiểu T. Kiểu view (string_view, span) không cấp phát;
+// std::string là lựa chọn tường minh khi cần copy.
+template <typename T> struct ColumnDecoder;
+
+template <typename T>
+    requires std::is_integral_v<T>
+struct ColumnDecoder<T> {
+        static T read(const RowView &row, int column) noexcept {
+            if constexpr (std::is_same_v<T, bool>) {
+                return row.int64(column) != 0;
+            } else {
+                return static_cast<T>(row.int64(column));
+            }
+        }
+};
+
+template <> struct ColumnDecoder<double> {
+        static double read(const RowView &row, int column) noexcept { return row.real(column); }
+};
+
+template <> struct ColumnDecoder<std::string_view> {
+        static std::string_view read(const RowView &row, int column) noexcept {
+            return row.text(column);
+        }
+};
+
+template <> struct ColumnDecoder<std::string> {
+        static std::string read(const RowView &row, int column) {
+            return std::string(row.text(column));
+        }
+};
+
+template <> struct ColumnDecoder<std::span<const std::byte>> {
+        static std::span<const std::byte> read(const RowView &row, int column) noexcept {
+            return row.blob(column);
+        }
+};
+
+template <> struct ColumnDecoder<ResourceType> {
+        static ResourceType read(const RowView &row, int column) {
+            return resourceTypeFromCode(row.int64(column));
+        }
+};
+
+template <> struct ColumnDecoder<SymbolKind> {
+        static SymbolKind read(const RowView &row, int column) {
+            return symbolKindFromCode(row.int64(column));
+        }
+};
+
+template <> struct ColumnDecoder<Timestamp> {
+        static Timestamp read(const RowView &row, int column) noexcept {
+            return timestampFromEpoch(row.int64(column));
+        }
+};
+
+// NULL => nullopt
+template <typename T> struct ColumnDecoder<std::optional<T>> {
+        static std::optional<T> read(const RowView &row, int column) {
+            if (row.isNull(column)) { return std::nullopt; }
+            return ColumnDecoder<T>::read(row, column);
+        }
+};
+
+// NULL hoặc sai độ dài => nullopt
+template <> struct ColumnDecoder<std::optional<FileHash>> {
+        static std::optional<FileHash> read(const RowView &row, int column) noexcept {
+            const auto bytes = row.blob(column);
+            return fileHashFromBlob(bytes.data(), static_cast<int>(bytes.size()));
+        }
+};
+
+template <typename T> T RowView::get(int column) const {
+    return ColumnDecoder<T>::read(*this, column);
+}
+
+// Duyệt các dòng của một statement đã bind tham số:
+//   for (auto [id, title] : ResultSet<sqlite3_int64, std::string_view>(stmt)) { ... }
+// Danh sách kiểu là schema cột lúc biên dịch; không có kiểu nào thì mỗi dòng là một RowView.
+// Lỗi khi step (khác SQLITE_ROW/SQLITE_DONE) ném std::runtime_error.
+template <typename... Columns> class ResultSet {
+    public:
+        static constexpr int kColumnCount{static_cast<int>(sizeof...(Columns))};
+
+        using value_type =
+            std::conditional_t<sizeof...(Columns) == 0, RowView, std::tuple<Columns...>>;
+
+        explicit ResultSet(const SQLiteStmt &stmt) noexcept : m_stmt(stmt.get()) {}
+        explicit ResultSet(sqlite3_stmt* stmt) noexcept : m_stmt(stmt) {}
+
+        class iterator {
+            public:
+                using iterator_category = std::input_iterator_tag;
+                using difference_type = std::ptrdiff_t;
+                using value_type = ResultSet::value_type;
+
+                iterator() noexcept = default;
+                explicit iterator(ResultSet* set) noexcept : m_set(set) {}
+
+                [[nodiscard]] value_type operator*() const {
+                    const RowView row(m_set->m_stmt);
+                    if constexpr (sizeof...(Columns) == 0) {
+                        return row;
+                    } else {
+                        return row.template as<Columns...>();
+                    }
+                }
+
+                iterator &operator++() {
+                    if (!m_set->step()) { m_set = nullptr; }
+                    return *this;
+                }
+
+                void operator++(int) { ++*this; }
+
+                friend bool operator==(const iterator &it, std::default_sentinel_t) noexcept {
+                    return it.m_set == nullptr;
+                }
+
+            private:
+                ResultSet* m_set{nullptr};
+        };
+
+        // Bước tới dòng đầu tiên; chỉ duyệt được một lần
+        [[nodiscard]] iterator begin() {
+            if constexpr (sizeof...(Columns) != 0) {
+                if (sqlite3_column_count(m_stmt) < kColumnCount) {
+                    throw std::runtime_error("Result has fewer columns than its schema");
+                }
+            }
+            return step() ? iterator(this) : iterator();
+        }
+
+        [[nodiscard]] std::default_sentinel_t end() const noexcept { return {}; }
+
+        // Dòng kế tiếp, nullopt khi hết
+        [[nodiscard]] std::optional<value_type> next() {
+            auto it = m_started ? (step() ? iterator(this) : iterator()) : begin();
+            if (it == std::default_sentinel) { return std::nullopt; }
+            return *it;
+        }
+
+    private:
+        sqlite3_stmt* m_stmt;
+        bool m_started{false};
+
+        bool step() {
+            m_started = true;
+
+            const int rc = sqlite3_step(m_stmt);
+            if (rc == SQLITE_ROW) { return true; }
+            if (rc == SQLITE_DONE) { return false; }
+
+            throw std::runtime_error(std::string("Query step failed: ") +
+                                     sqlite3_errmsg(sqlite3_db_handle(m_stmt)));
+        }
+};
@@ -0,0 +1,690 @@
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "schema_migrator.hpp"
+#include "model.hpp"
+#include "search_indexes.hpp"
+#include "sqldb_raii.hpp"
+#include "text_content_repository.hpp"
+
+int SchemaMigrator::migrate() {
+    int steps{0};
+    int version = userVersion();
+    if (version >= kCurrentVersion) { return steps; }
+
+    // Dựng lại bảng cha (resources) khi foreign_keys bật thì DROP TABLE sẽ cascade xóa bảng con.
+    // PRAGMA foreign_keys không có tác dụng trong transaction nên tắt trước vòng lặp.
+    bool foreignKeys{false};
+    {
+        SQLiteStmt stmt(m_db.get(), "PRAGMA foreign_keys;");
+        foreignKeys = sqlite3_step(stmt.get()) == SQLITE_ROW && sqlite3_column_int(stmt.get(), 0);
+    }
+    exec("PRAGMA foreign_keys = OFF;");
+
+    try {
+        steps = migrateSteps(version);
+    } catch (...) {
+        if (foreignKeys) { exec("PRAGMA foreign_keys = ON;"); }
+        throw;
+    }
+
+    if (foreignKeys) { exec("PRAGMA foreign_keys = ON;"); }
+
+    return steps;
+}
+
+int SchemaMigrator::migrateSteps(int version) {
+    int steps{0};
+
+    while (version < kCurrentVersion) {
+        exec("BEGIN TRANSACTION;");
+
+        try {
+            switch (version) {
+                case 0: migrateToV1(); break;
+                case 1: migrateToV2(); break;
+                case 2: migrateToV3(); break;
+                case 3: migrateToV4(); break;
+                case 4: migrateToV5(); break;
+                case 5: migrateToV6(); break;
+                case 6: migrateToV7(); break;
+                case 7: migrateToV8(); break;
+                case 8: migrateToV9(); break;
+                case 9: migrateToV10(); break;
+                case 10: migrateToV11(); break;
+                case 11: migrateToV12(); break;
+                case 12: migrateToV13(); break;
+                default:
+                    throw std::runtime_error("No migration from schema version " +
+                                             std::to_string(version));
+            }
+
+            ++version;
+            setUserVersion(version);
+
+            exec("COMMIT;");
+
+        } catch (...) {
+            // Lỗi gốc được ném lại; ROLLBACK lỗi (SQLite có thể đã tự rollback) thì bỏ qua
+            try {
+                exec("ROLLBACK;");
+            } catch (const std::exception &) {} // NOLINT(bugprone-empty-catch)
+            throw;
+        }
+
+        ++steps;
+    }
+
+    return steps;
+}
+
+int SchemaMigrator::userVersion() const {
+    SQLiteStmt stmt(m_db.get(), "PRAGMA user_version;");
+
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) { return sqlite3_column_int(stmt.get(), 0); }
+
+    return 0;
+}
+
+bool SchemaMigrator::hasColumn(std::string_view table, std::string_view column) const {
+    SQLiteStmt stmt(m_db.get(), "SELECT 1 FROM pragma_table_info(?) WHERE name = ?;");
+
+    sqlite3_bind_text(stmt.get(), 1, table.data(), static_cast<int>(table.size()),
+                      SQLITE_TRANSIENT);
+    sqlite3_bind_text(stmt.get(), 2, column.data(), static_cast<int>(column.size()),
+                      SQLITE_TRANSIENT);
+
+    return sqlite3_step(stmt.get()) == SQLITE_ROW;
+}
+
+void SchemaMigrator::exec(const char* sql) {
+    SQLiteStmt stmt(m_db.get(), sql);
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Migration failed: ") + sqlite3_errmsg(m_db.get()));
+    }
+}
+
+void SchemaMigrator::execScript(const char* sql) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(m_db.get(), sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::string msg = errMsg != nullptr ? errMsg : "unknown";
+        sqlite3_free(errMsg);
+        throw std::runtime_error("Migration failed: " + msg);
+    }
+}
+
+// foreign_keys tắt trong lúc migrate nên dựng lại bảng cha không bị SQLite kiểm tra: kiểm tra
+// lại cả DB, còn dòng con mồ côi thì migration thất bại (rollback) thay vì commit DB hỏng
+void SchemaMigrator::checkForeignKeys() {
+    SQLiteStmt stmt(m_db.get(), "PRAGMA foreign_key_check;");
+
+    const int rc = sqlite3_step(stmt.get());
+    if (rc == SQLITE_ROW) {
+        const auto* table = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+        const auto* parent = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
+        throw std::runtime_error(std::string("Migration failed: foreign key violation in ") +
+                                 table + " (rowid " +
+                                 std::to_string(sqlite3_column_int64(stmt.get(), 1)) +
+                                 ") referencing " + parent);
+    }
+    if (rc != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Migration failed: ") + sqlite3_errmsg(m_db.get()));
+    }
+}
+
+void SchemaMigrator::setUserVersion(int version) {
+    // PRAGMA không nhận tham số bind
+    exec(("PRAGMA user_version = " + std::to_string(version) + ";").c_str());
+}
+
+void SchemaMigrator::migrateToV1() {
+    if (!hasColumn("files", "missing_since")) {
+        exec("ALTER TABLE files ADD COLUMN missing_since TEXT NULL;");
+    }
+}
+
+void SchemaMigrator::migrateToV2() {
+    const char* sql = R"SQL(
+        CREATE TABLE IF NOT EXISTS file_chunks (
+            id          INTEGER PRIMARY KEY,
+            resource_id INTEGER NOT NULL,
+            chunk_no    INTEGER NOT NULL,
+            content     TEXT NOT NULL,
+            UNIQUE (resource_id, chunk_no),
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+
+        CREATE TABLE IF NOT EXISTS file_index_state (
+            resource_id  INTEGER PRIMARY KEY,
+            indexed_hash TEXT NOT NULL,            -- file_hash lúc index, khác => index lại
+            chunk_count  INTEGER NOT NULL DEFAULT 0,
+            error        TEXT NULL,
+            indexed_at   TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+
+        CREATE VIRTUAL TABLE IF NOT EXISTS file_chunks_fts USING fts5(
+            content,
+            content = 'file_chunks',
+            content_rowid = 'id',
+            tokenize = 'unicode61 remove_diacritics 1'
+        );
+
+        CREATE TRIGGER IF NOT EXISTS file_chunks_insert_fts
+        AFTER INSERT ON file_chunks
+        BEGIN
+            INSERT INTO file_chunks_fts (rowid, content) VALUES (new.id, new.content);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS file_chunks_delete_fts
+        AFTER DELETE ON file_chunks
+        BEGIN
+            INSERT INTO file_chunks_fts (file_chunks_fts, rowid, content)
+            VALUES ('delete', old.id, old.content);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS file_chunks_update_fts
+        AFTER UPDATE ON file_chunks
+        BEGIN
+            INSERT INTO file_chunks_fts (file_chunks_fts, rowid, content)
+            VALUES ('delete', old.id, old.content);
+            INSERT INTO file_chunks_fts (rowid, content) VALUES (new.id, new.content);
+        END;
+    )SQL";
+
+    execScript(sql);
+}
+
+void SchemaMigrator::migrateToV3() {
+    if (!hasColumn("file_chunks", "page")) {
+        exec("ALTER TABLE file_chunks ADD COLUMN page INTEGER NULL;");
+    }
+}
+
+void SchemaMigrator::migrateToV4() {
+    if (!hasColumn("file_chunks", "byte_offset")) {
+        exec("ALTER TABLE file_chunks ADD COLUMN byte_offset INTEGER NOT NULL DEFAULT 0;");
+    }
+    if (!hasColumn("file_chunks", "line_no")) {
+        exec("ALTER TABLE file_chunks ADD COLUMN line_no INTEGER NOT NULL DEFAULT 1;");
+    }
+
+    // Chunk cũ chưa có vị trí: xóa trạng thái để ContentIndexer/PDF worker index lại
+    // (DB chưa có bảng resources thì không có gì để index, DML lên bảng có FK sẽ lỗi)
+    if (hasColumn("resources", "id")) { exec("DELETE FROM file_index_state;"); }
+
+    const char* sql = R"SQL(
+        CREATE TABLE IF NOT EXISTS text_chunks (
+            id          INTEGER PRIMARY KEY,
+            resource_id INTEGER NOT NULL,
+            chunk_no    INTEGER NOT NULL,
+            byte_offset INTEGER NOT NULL,
+            line_no     INTEGER NOT NULL,
+            content     TEXT NOT NULL,
+            UNIQUE (resource_id, chunk_no),
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+
+        CREATE VIRTUAL TABLE IF NOT EXISTS text_chunks_fts USING fts5(
+            content,
+            content = 'text_chunks',
+            content_rowid = 'id',
+            tokenize = 'unicode61 remove_diacritics 1'
+        );
+
+        CREATE TRIGGER IF NOT EXISTS text_chunks_insert_fts
+        AFTER INSERT ON text_chunks
+        BEGIN
+            INSERT INTO text_chunks_fts (rowid, content) VALUES (new.id, new.content);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS text_chunks_delete_fts
+        AFTER DELETE ON text_chunks
+        BEGIN
+            INSERT INTO text_chunks_fts (text_chunks_fts, rowid, content)
+            VALUES ('delete', old.id, old.content);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS text_chunks_update_fts
+        AFTER UPDATE ON text_chunks
+        BEGIN
+            INSERT INTO text_chunks_fts (text_chunks_fts, rowid, content)
+            VALUES ('delete', old.id, old.content);
+            INSERT INTO text_chunks_fts (rowid, content) VALUES (new.id, new.content);
+        END;
+
+        DROP TRIGGER IF EXISTS text_content_insert_fts;
+        DROP TRIGGER IF EXISTS text_content_update_fts;
+        DROP TRIGGER IF EXISTS text_content_delete_fts;
+        DROP TABLE IF EXISTS text_content_fts;
+    )SQL";
+
+    execScript(sql);
+    // Chunk của note được ghi ở v5 (TextContentRepository luôn ghi theo schema mới nhất)
+}
+
+void SchemaMigrator::migrateToV5() {
+    // text_chunks không còn lưu vị trí tuyệt đối: tạo lại bảng, chia chunk lại toàn bộ note
+    const char* sql = R"SQL(
+        DROP TRIGGER IF EXISTS text_chunks_insert_fts;
+        DROP TRIGGER IF EXISTS text_chunks_delete_fts;
+        DROP TRIGGER IF EXISTS text_chunks_update_fts;
+        DROP TABLE IF EXISTS text_chunks_fts;
+        DROP TABLE IF EXISTS text_chunks;
+
+        CREATE TABLE text_chunks (
+            id          INTEGER PRIMARY KEY,
+            resource_id INTEGER NOT NULL,
+            chunk_no    INTEGER NOT NULL,
+            byte_len    INTEGER NOT NULL,
+            line_count  INTEGER NOT NULL,
+            content     TEXT NOT NULL,
+            UNIQUE (resource_id, chunk_no),
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+
+        CREATE VIRTUAL TABLE text_chunks_fts USING fts5(
+            content,
+            content = 'text_chunks',
+            content_rowid = 'id',
+            tokenize = 'unicode61 remove_diacritics 1'
+        );
+
+        CREATE TRIGGER text_chunks_insert_fts
+        AFTER INSERT ON text_chunks
+        BEGIN
+            INSERT INTO text_chunks_fts (rowid, content) VALUES (new.id, new.content);
+        END;
+
+        CREATE TRIGGER text_chunks_delete_fts
+        AFTER DELETE ON text_chunks
+        BEGIN
+            INSERT INTO text_chunks_fts (text_chunks_fts, rowid, content)
+            VALUES ('delete', old.id, old.content);
+        END;
+
+        CREATE TRIGGER text_chunks_update_fts
+        AFTER UPDATE OF content ON text_chunks
+        BEGIN
+            INSERT INTO text_chunks_fts (text_chunks_fts, rowid, content)
+            VALUES ('delete', old.id, old.content);
+            INSERT INTO text_chunks_fts (rowid, content) VALUES (new.id, new.content);
+        END;
+    )SQL";
+
+    execScript(sql);
+    // Chunk của note được ghi lại ở v13 (TextContentRepository luôn ghi theo schema mới nhất)
+}
+
+void SchemaMigrator::migrateToV6() {
+    // Không đụng text_content: note cũ vẫn là TEXT, chỉ được nén khi bật trong settings
+    const char* sql = R"SQL(
+        CREATE TABLE IF NOT EXISTS text_dictionaries (
+            id           INTEGER PRIMARY KEY,
+            dictionary   BLOB NOT NULL,
+            sample_count INTEGER NOT NULL,
+            created_at   TEXT DEFAULT CURRENT_TIMESTAMP
+        );
+    )SQL";
+
+    execScript(sql);
+}
+
+void SchemaMigrator::migrateToV7() {
+    // Note cũ chưa có lịch sử: lần sửa đầu tiên ghi nội dung cũ làm snapshot
+    const char* sql = R"SQL(
+        CREATE TABLE IF NOT EXISTS text_revisions (
+            id          INTEGER PRIMARY KEY,
+            resource_id INTEGER NOT NULL,
+            revision    INTEGER NOT NULL,
+            depth       INTEGER NOT NULL,
+            size        INTEGER NOT NULL,
+            checksum    INTEGER NOT NULL,
+            data        BLOB NOT NULL,
+            created_at  TEXT DEFAULT CURRENT_TIMESTAMP,
+            UNIQUE (resource_id, revision),
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+    )SQL";
+
+    execScript(sql);
+}
+
+void SchemaMigrator::migrateToV8() {
+    // DB chưa có bảng resources: bảng được tạo theo schema mới
+    if (!hasColumn("resources", "id")) { return; }
+
+    // SQLite không đổi được kiểu cột: tạo bảng mới, chép dữ liệu (giữ id), thay bảng cũ.
+    // Mã loại không nhận ra => NULL => vi phạm NOT NULL, migration rollback
+    const char* sql = R"SQL(
+        CREATE TABLE resources_v8 (
+            id          INTEGER PRIMARY KEY AUTOINCREMENT,
+            title       TEXT NOT NULL,
+            type        INTEGER NOT NULL,
+            file_hash   TEXT UNIQUE NULL,
+            created_at  INTEGER NOT NULL DEFAULT (unixepoch()),
+            updated_at  INTEGER NOT NULL DEFAULT (unixepoch()),
+            UNIQUE (title, type)
+        );
+
+        INSERT INTO resources_v8 (id, title, type, file_hash, created_at, updated_at)
+        SELECT id, title,
+               CASE type WHEN 'text' THEN 0 WHEN 'cpp' THEN 1 WHEN 'pdf' THEN 2
+                         WHEN 'epub' THEN 3 END,
+               file_hash,
+               COALESCE(unixepoch(created_at), unixepoch()),
+               COALESCE(unixepoch(updated_at), unixepoch(created_at), unixepoch())
+        FROM resources;
+
+        -- Giữ bộ đếm AUTOINCREMENT: id của resource đã xóa không được cấp lại
+        UPDATE sqlite_sequence
+        SET seq = MAX(seq, COALESCE((SELECT seq FROM sqlite_sequence
+                                     WHERE name = 'resources'), 0))
+        WHERE name = 'resources_v8';
+
+        DROP TABLE resources;
+        ALTER TABLE resources_v8 RENAME TO resources;
+
+        CREATE INDEX IF NOT EXISTS idx_resources_title ON resources(title);
+        CREATE INDEX IF NOT EXISTS idx_resources_type ON resources(type);
+        CREATE UNIQUE INDEX IF NOT EXISTS idx_resources_title_type ON resources(title, type);
+
+        CREATE TRIGGER update_resource_timestamp
+        AFTER UPDATE ON resources
+        FOR EACH ROW
+        WHEN NEW.updated_at = OLD.updated_at
+        BEGIN
+            UPDATE resources SET updated_at = unixepoch() WHERE id = OLD.id;
+        END;
+    )SQL";
+
+    execScript(sql);
+    checkForeignKeys();
+
+    // Trigger FTS bị xóa cùng bảng cũ; resources_fts giữ nguyên vì rowid = id không đổi
+    if (!hasColumn("resources_fts", "title")) { return; }
+
+    const char* ftsSql = R"SQL(
+        CREATE TRIGGER resources_insert_fts
+        AFTER INSERT ON resources
+        WHEN new.title IS NOT NULL
+        BEGIN
+            INSERT INTO resources_fts (rowid, title) VALUES (new.id, new.title);
+        END;
+
+        CREATE TRIGGER resources_update_fts
+        AFTER UPDATE OF title ON resources
+        WHEN new.title IS NOT NULL
+        BEGIN
+            UPDATE resources_fts SET title = new.title WHERE rowid = old.id;
+        END;
+
+        CREATE TRIGGER resources_delete_fts
+        AFTER DELETE ON resources
+        BEGIN
+            DELETE FROM resources_fts WHERE rowid = old.id;
+        END;
+    )SQL";
+
+    execScript(ftsSql);
+}
+
+void SchemaMigrator::migrateToV9() {
+    // Không cần dựng lại bảng: cột khai báo TEXT vẫn giữ nguyên giá trị BLOB (affinity không đổi
+    // BLOB), DB tạo mới từ notes_manager_schema.sql khai báo BLOB
+    if (hasColumn("resources", "file_hash")) {
+        // Hash hỏng: bỏ đi, coi như dữ liệu cũ chưa có hash (watcher ghi lại khi file đổi)
+        for (auto id : hexColumnToBlob("resources", "id", "file_hash")) {
+            SQLiteStmt stmt(m_db.get(), "UPDATE resources SET file_hash = NULL WHERE id = ?;");
+            sqlite3_bind_int64(stmt.get(), 1, id);
+            if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+                throw std::runtime_error(std::string("Migration failed: ") +
+                                         sqlite3_errmsg(m_db.get()));
+            }
+        }
+    }
+
+    if (hasColumn("file_index_state", "indexed_hash")) {
+        // Trạng thái không đọc được: index lại file đó
+        for (auto id : hexColumnToBlob("file_index_state", "resource_id", "indexed_hash")) {
+            SQLiteStmt stmt(m_db.get(), "DELETE FROM file_index_state WHERE resource_id = ?;");
+            sqlite3_bind_int64(stmt.get(), 1, id);
+            if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+                throw std::runtime_error(std::string("Migration failed: ") +
+                                         sqlite3_errmsg(m_db.get()));
+            }
+        }
+    }
+}
+
+void SchemaMigrator::migrateToV10() {
+    // FTS5 không đổi được option của bảng: tạo lại rồi nạp từ bảng gốc. Trigger chỉ tham chiếu
+    // bảng FTS theo tên nên không phải tạo lại
+    if (hasColumn("resources_fts", "title") && hasColumn("resources", "title")) {
+        execScript(R"SQL(
+            DROP TABLE resources_fts;
+
+            CREATE VIRTUAL TABLE resources_fts USING fts5(
+                title,
+                prefix = '2 3 4',
+                tokenize = 'unicode61 remove_diacritics 1'
+            );
+
+            INSERT INTO resources_fts (rowid, title) SELECT id, title FROM resources;
+        )SQL");
+    }
+
+    for (const std::string chunks : {"text_chunks", "file_chunks"}) {
+        const std::string fts = chunks + "_fts";
+        if (!hasColumn(fts, "content")) { continue; }
+
+        execScript(("DROP TABLE " + fts + ";"
+                    "CREATE VIRTUAL TABLE " + fts + " USING fts5(content, content = '" + chunks +
+                    "', content_rowid = 'id', prefix = '2 3 4', "
+                    "tokenize = 'unicode61 remove_diacritics 1');"
+                    "INSERT INTO " + fts + " (" + fts + ") VALUES ('rebuild');")
+                       .c_str());
+    }
+
+    if (!hasColumn("resources", "title")) { return; }
+
+    // Trigram của title luôn có (title ngắn); trigram của nội dung do SearchIndexes bật/tắt
+    execScript(R"SQL(
+        CREATE VIRTUAL TABLE IF NOT EXISTS resources_trigram USING fts5(
+            title,
+            content = 'resources',
+            content_rowid = 'id',
+            tokenize = 'trigram'
+        );
+
+        CREATE TRIGGER IF NOT EXISTS resources_insert_trigram
+        AFTER INSERT ON resources
+        BEGIN
+            INSERT INTO resources_trigram (rowid, title) VALUES (new.id, new.title);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS resources_delete_trigram
+        AFTER DELETE ON resources
+        BEGIN
+            INSERT INTO resources_trigram (resources_trigram, rowid, title)
+            VALUES ('delete', old.id, old.title);
+        END;
+
+        CREATE TRIGGER IF NOT EXISTS resources_update_trigram
+        AFTER UPDATE OF title ON resources
+        BEGIN
+            INSERT INTO resources_trigram (resources_trigram, rowid, title)
+            VALUES ('delete', old.id, old.title);
+            INSERT INTO resources_trigram (rowid, title) VALUES (new.id, new.title);
+        END;
+
+        INSERT INTO resources_trigram (resources_trigram) VALUES ('rebuild');
+    )SQL");
+}
+
+void SchemaMigrator::migrateToV11() {
+    // Đổi tokenizer cũng phải tạo lại bảng FTS; trigger giữ nguyên như v10
+    if (hasColumn("resources_fts", "title") && hasColumn("resources", "title")) {
+        execScript(R"SQL(
+            DROP TABLE resources_fts;
+
+            CREATE VIRTUAL TABLE resources_fts USING fts5(
+                title,
+                prefix = '2 3 4',
+                tokenize = 'code remove_diacritics 1'
+            );
+
+            INSERT INTO resources_fts (rowid, title) SELECT id, title FROM resources;
+        )SQL");
+    }
+
+    for (const std::string chunks : {"text_chunks", "file_chunks"}) {
+        const std::string fts = chunks + "_fts";
+        if (!hasColumn(fts, "content")) { continue; }
+
+        execScript(("DROP TABLE " + fts + ";"
+                    "CREATE VIRTUAL TABLE " + fts + " USING fts5(content, content = '" + chunks +
+                    "', content_rowid = 'id', prefix = '2 3 4', "
+                    "tokenize = 'code remove_diacritics 1');"
+                    "INSERT INTO " + fts + " (" + fts + ") VALUES ('rebuild');")
+                       .c_str());
+    }
+}
+
+void SchemaMigrator::migrateToV12() {
+    const char* sql = R"SQL(
+        CREATE TABLE IF NOT EXISTS symbols (
+            resource_id INTEGER NOT NULL,
+            kind        INTEGER NOT NULL,
+            name        TEXT NOT NULL,
+            line        INTEGER NOT NULL,
+            PRIMARY KEY (name, kind, resource_id, line),
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        ) WITHOUT ROWID;
+
+        CREATE INDEX IF NOT EXISTS idx_symbols_resource ON symbols(resource_id);
+    )SQL";
+
+    execScript(sql);
+
+    // File cpp đã index trước v12 chưa có ký hiệu: xóa trạng thái để ContentIndexer index lại
+    if (hasColumn("file_index_state", "resource_id") && hasColumn("resources", "type")) {
+        exec("DELETE FROM file_index_state WHERE resource_id IN "
+             "(SELECT id FROM resources WHERE type = 1);");
+    }
+}
+
+void SchemaMigrator::migrateToV13() {
+    // Chunk được cắt từ text_content: không có bảng nội dung thì giữ nguyên
+    if (!hasColumn("text_content", "content")) { return; }
+
+    // Trigram của note cũng đọc text_chunks.content: bỏ đi, tạo lại trên view sau khi chia chunk
+    const bool trigram = hasColumn("text_chunks_trigram", "content");
+
+    const char* sql = R"SQL(
+        DROP TRIGGER IF EXISTS text_chunks_insert_fts;
+        DROP TRIGGER IF EXISTS text_chunks_delete_fts;
+        DROP TRIGGER IF EXISTS text_chunks_update_fts;
+        DROP TRIGGER IF EXISTS text_chunks_trigram_insert;
+        DROP TRIGGER IF EXISTS text_chunks_trigram_delete;
+        DROP TRIGGER IF EXISTS text_chunks_trigram_update;
+        DROP TABLE IF EXISTS text_chunks_trigram;
+        DROP TABLE IF EXISTS text_chunks_fts;
+        DROP TABLE IF EXISTS text_chunks;
+
+        CREATE TABLE text_chunks (
+            id          INTEGER PRIMARY KEY,
+            resource_id INTEGER NOT NULL,
+            chunk_no    INTEGER NOT NULL,
+            byte_offset INTEGER NOT NULL,
+            byte_len    INTEGER NOT NULL,
+            line_count  INTEGER NOT NULL,
+            UNIQUE (resource_id, chunk_no),
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+
+        CREATE VIEW text_chunk_texts AS
+        SELECT c.id AS id, note_slice(t.content, c.byte_offset, c.byte_len) AS content
+        FROM text_chunks c JOIN text_content t ON t.resource_id = c.resource_id;
+
+        CREATE VIRTUAL TABLE text_chunks_fts USING fts5(
+            content,
+            content = 'text_chunk_texts',
+            content_rowid = 'id',
+            prefix = '2 3 4',
+            tokenize = 'code remove_diacritics 1'
+        );
+
+        CREATE TRIGGER text_chunks_insert_fts
+        AFTER INSERT ON text_chunks
+        BEGIN
+            INSERT INTO text_chunks_fts (rowid, content)
+            SELECT id, content FROM text_chunk_texts WHERE id = new.id;
+        END;
+
+        CREATE TRIGGER text_chunks_delete_fts
+        BEFORE DELETE ON text_chunks
+        BEGIN
+            INSERT INTO text_chunks_fts (text_chunks_fts, rowid, content)
+            SELECT 'delete', id, content FROM text_chunk_texts WHERE id = old.id;
+        END;
+
+        CREATE TRIGGER text_content_delete_chunks
+        BEFORE DELETE ON text_content
+        BEGIN
+            DELETE FROM text_chunks WHERE resource_id = old.resource_id;
+        END;
+    )SQL";
+
+    execScript(sql);
+
+    TextContentRepository(m_db).reindexAll();
+    if (trigram) { SearchIndexes(m_db).setContentTrigram(true); }
+}
+
+std::vector<sqlite3_int64> SchemaMigrator::hexColumnToBlob(std::string_view table,
+                                                           std::string_view key,
+                                                           std::string_view column) {
+    const std::string tableName(table);
+    const std::string keyName(key);
+    const std::string columnName(column);
+
+    std::vector<std::pair<sqlite3_int64, FileHash>> converted;
+    std::vector<sqlite3_int64> invalid;
+    {
+        SQLiteStmt stmt(m_db.get(), "SELECT " + keyName + ", " + columnName + " FROM " +
+                                        tableName + " WHERE typeof(" + columnName + ") = 'text';");
+
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            const auto id = sqlite3_column_int64(stmt.get(), 0);
+            const auto* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+            const std::string_view hex(
+                text, static_cast<std::size_t>(sqlite3_column_bytes(stmt.get(), 1)));
+
+            if (auto hash = fileHashFromHex(hex)) {
+                converted.emplace_back(id, *hash);
+            } else {
+                invalid.push_back(id);
+            }
+        }
+    }
+
+    SQLiteStmt update(m_db.get(), "UPDATE " + tableName + " SET " + columnName + " = ? WHERE " +
+                                      keyName + " = ?;");
+    for (const auto &[id, hash] : converted) {
+        sqlite3_bind_blob(update.get(), 1, hash.data(), static_cast<int>(hash.size()),
+                          SQLITE_TRANSIENT);
+        sqlite3_bind_int64(update.get(), 2, id);
+        if (sqlite3_step(update.get()) != SQLITE_DONE) {
+            throw std::runtime_error(std::string("Migration failed: ") +
+                                     sqlite3_errmsg(m_db.get()));
+        }
+        sqlite3_reset(update.get());
+    }
+
+    return invalid;
+}
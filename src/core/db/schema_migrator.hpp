@@ -0,0 +1,79 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+
+class SQLiteDB;
+
+// Nâng cấp schema của DB cũ theo PRAGMA user_version
+// DB tạo mới từ notes_manager_schema.sql đã ở phiên bản mới nhất
+class SchemaMigrator {
+    public:
+        static constexpr int kCurrentVersion{13};
+
+        explicit SchemaMigrator(SQLiteDB &db) noexcept : m_db(db) {}
+
+        // Chạy các bước còn thiếu (mỗi bước một transaction), trả về số bước đã chạy
+        int migrate();
+
+        [[nodiscard]] int userVersion() const;
+
+    private:
+        SQLiteDB &m_db;
+
+        [[nodiscard]] bool hasColumn(std::string_view table, std::string_view column) const;
+        void exec(const char* sql);
+        void execScript(const char* sql); // nhiều câu lệnh
+        void setUserVersion(int version);
+        void checkForeignKeys(); // ném nếu PRAGMA foreign_key_check báo vi phạm
+        int migrateSteps(int version);
+
+        // v1: files.missing_since (tombstone cho file linked bị xóa/di chuyển)
+        void migrateToV1();
+
+        // v2: file_chunks + file_chunks_fts + file_index_state (index nội dung file)
+        void migrateToV2();
+
+        // v3: file_chunks.page (số trang của chunk trích từ PDF)
+        void migrateToV3();
+
+        // v4: vị trí chunk (byte_offset, line_no) trong file_chunks; text note chuyển sang
+        // text_chunks + text_chunks_fts thay cho text_content_fts (một dòng FTS mỗi note)
+        void migrateToV4();
+
+        // v5: text_chunks chia theo nội dung, lưu độ dài/số dòng từng chunk thay cho vị trí
+        // tuyệt đối để sửa note chỉ ghi lại các chunk đổi
+        void migrateToV5();
+
+        // v6: text_dictionaries (từ điển nén nội dung note, text_content.content có thể là BLOB)
+        void migrateToV6();
+
+        // v7: text_revisions (lịch sử text note: snapshot + delta)
+        void migrateToV7();
+
+        // v8: resources.type là mã số (ResourceType), created_at/updated_at là unix epoch INTEGER
+        void migrateToV8();
+
+        // v9: resources.file_hash, file_index_state.indexed_hash từ hex TEXT sang BLOB 32 byte
+        void migrateToV9();
+
+        // v10: prefix index ('2 3 4') cho resources_fts, text_chunks_fts, file_chunks_fts và
+        // resources_trigram (tìm chuỗi con trong title)
+        void migrateToV10();
+
+        // v11: resources_fts, text_chunks_fts, file_chunks_fts dùng tokenizer "code" (tách
+        // camelCase, snake_case, "::" của identifier C++)
+        void migrateToV11();
+
+        // v12: symbols (định nghĩa, #include, lời gọi trích từ file cpp); file cpp được index lại
+        void migrateToV12();
+
+        // v13: text_chunks chỉ lưu vị trí chunk, FTS (và trigram) của note đọc chunk qua view
+        // text_chunk_texts cắt từ text_content: text note không còn bản thường thứ hai
+        void migrateToV13();
+
+        // Đổi giá trị hex của column sang BLOB, trả về key các dòng không phải hash hợp lệ
+        std::vector<sqlite3_int64> hexColumnToBlob(std::string_view table, std::string_view key,
+                                                   std::string_view column);
+};
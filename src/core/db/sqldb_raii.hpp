@@ -4,6 +4,9 @@
 #include <stdexcept>
 #include <memory>
 #include <sqlite3.h>
+#include "code_tokenizer.hpp"
+#include "note_slice.hpp"
+#include "write_generations.hpp"
 
 // RAII wrapper cho sqlite3*
 class SQLiteDB {
@@ -40,13 +43,31 @@ class SQLiteDB {
                 throw std::runtime_error("Failed to enable PRAGMA foreign_keys: " + errorMSG);
             }
 
+            // Tokenizer "code" phải có trước khi chạm vào bảng FTS dùng nó; FTS của note đọc
+            // chunk qua note_slice
+            try {
+                registerCodeTokenizer(dbPtr);
+                registerNoteSliceFunction(dbPtr);
+            } catch (...) {
+                sqlite3_close_v2(dbPtr);
+                throw;
+            }
+
             m_db = unique_sqlite_db_ptr(dbPtr);
+            m_generations = std::make_unique<WriteGenerations>(dbPtr);
         }
 
         [[nodiscard]] sqlite3* get() const noexcept { return m_db.get(); }
 
+        // Generation ghi theo bảng (để cache kết quả biết khi nào đã cũ)
+        [[nodiscard]] WriteGenerations &generations() noexcept { return *m_generations; }
+        [[nodiscard]] const WriteGenerations &generations() const noexcept {
+            return *m_generations;
+        }
+
     private:
         unique_sqlite_db_ptr m_db;
+        std::unique_ptr<WriteGenerations> m_generations; // hủy (gỡ hook) trước khi đóng m_db
 };
 
 // RAII wrapper cho sqlite3_stmt*
@@ -0,0 +1,46 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <sqlite3.h>
+#include "write_generations.hpp"
+
+WriteGenerations::WriteGenerations(sqlite3* db) noexcept : m_db(db) {
+    sqlite3_update_hook(m_db, &WriteGenerations::onUpdate, this);
+}
+
+WriteGenerations::~WriteGenerations() {
+    sqlite3_update_hook(m_db, nullptr, nullptr);
+}
+
+void WriteGenerations::bump(std::string_view table) noexcept {
+    m_generations[slot(table)].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t WriteGenerations::version(std::span<const std::string_view> tables) const noexcept {
+    std::uint64_t sum{0};
+    for (const auto table : tables) {
+        sum += m_generations[slot(table)].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+bool WriteGenerations::inTransaction() const noexcept {
+    return sqlite3_get_autocommit(m_db) == 0;
+}
+
+void WriteGenerations::onUpdate(void* self, int /*op*/, const char* /*database*/,
+                                const char* table, sqlite3_int64 /*rowid*/) {
+    static_cast<WriteGenerations*>(self)->bump(table);
+}
+
+std::size_t WriteGenerations::slot(std::string_view table) noexcept {
+    // FNV-1a
+    std::uint64_t hash{14695981039346656037ULL};
+    for (const char c : table) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<std::size_t>(hash % kSlots);
+}
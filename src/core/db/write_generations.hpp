@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <sqlite3.h>
+
+// Bộ đếm ghi theo bảng của một connection, để cache biết chính xác khi nào kết quả đã cũ.
+// sqlite3_update_hook tăng generation của bảng với mọi dòng INSERT/UPDATE/DELETE, kể cả dòng
+// ghi bởi trigger, FTS và ON DELETE CASCADE, nên repository không phải tự báo. Hook không thấy
+// thay đổi schema, bảng WITHOUT ROWID (symbols) và DELETE không WHERE trên bảng không có trigger
+// (truncate optimization): nơi cần thì gọi bump() (kSchema với schema).
+// Tên bảng được băm vào kSlots ô đếm: hai bảng chung ô chỉ làm cache bỏ mục sớm hơn, không bao
+// giờ giữ mục cũ. Ô đếm là atomic vì import ghi từ thread khác trên cùng connection.
+class WriteGenerations {
+    public:
+        static constexpr std::size_t kSlots{64};
+        static constexpr std::string_view kSchema{"sqlite_schema"};
+
+        explicit WriteGenerations(sqlite3* db) noexcept;
+        ~WriteGenerations();
+
+        WriteGenerations(const WriteGenerations &) = delete;
+        WriteGenerations &operator=(const WriteGenerations &) = delete;
+
+        void bump(std::string_view table) noexcept;
+
+        // Tổng generation của các bảng: tăng mỗi khi một trong số chúng bị ghi
+        [[nodiscard]] std::uint64_t
+            version(std::span<const std::string_view> tables) const noexcept;
+
+        // Đang trong transaction: dữ liệu đọc được có thể chưa commit (và bị rollback sau đó)
+        [[nodiscard]] bool inTransaction() const noexcept;
+
+    private:
+        static void onUpdate(void* self, int op, const char* database, const char* table,
+                             sqlite3_int64 rowid);
+        [[nodiscard]] static std::size_t slot(std::string_view table) noexcept;
+
+        sqlite3* m_db;
+        std::array<std::atomic<std::uint64_t>, kSlots> m_generations{};
+};
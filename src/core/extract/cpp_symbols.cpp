@@ -0,0 +1,481 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "cpp_symbols.hpp"
+
+namespace {
+    constexpr bool isIdentStart(char c) noexcept {
+        return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+               static_cast<unsigned char>(c) >= 0x80U;
+    }
+
+    constexpr bool isIdentChar(char c) noexcept {
+        return isIdentStart(c) || (c >= '0' && c <= '9');
+    }
+
+    constexpr bool isSpace(char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    template <std::size_t N>
+    constexpr bool contains(const std::array<std::string_view, N> &words, std::string_view word) {
+        return std::ranges::find(words, word) != words.end();
+    }
+
+    // Prefix của string literal: u8"..", L"..", R"(..)", u8R"(..)"
+    constexpr std::array<std::string_view, 9> kStringPrefixes{"R",  "L",  "u",  "U",  "u8",
+                                                              "LR", "uR", "UR", "u8R"};
+
+    // Từ khóa không bao giờ là tên hàm được gọi / được định nghĩa
+    constexpr std::array<std::string_view, 46> kNotCallee{
+        "if",       "for",         "while",       "switch",       "catch",
+        "return",   "sizeof",      "alignof",     "alignas",      "decltype",
+        "typeid",   "noexcept",    "requires",    "defined",      "static_assert",
+        "new",      "static_cast", "const_cast",  "dynamic_cast", "reinterpret_cast",
+        "delete",   "throw",       "co_await",    "co_return",    "co_yield",
+        "operator", "template",    "typename",    "int",          "char",
+        "bool",     "float",       "double",      "void",         "long",
+        "short",    "unsigned",    "signed",      "auto",         "const",
+        "volatile", "case",        "do",          "else",         "using",
+        "explicit"};
+
+    // Từ khóa có thể đứng trước lời gọi hàm (return f(x)); định danh khác đứng trước
+    // "name(" nghĩa là khai báo biến/hàm (std::string name(buf))
+    constexpr std::array<std::string_view, 13> kBeforeCall{
+        "return", "new",  "throw", "case", "co_await", "co_return", "co_yield",
+        "else",   "and",  "or",    "not",  "delete",   "do"};
+
+    // Được phép giữa ')' của tham số và '{' của thân hàm
+    constexpr std::array<std::string_view, 9> kAfterParams{
+        "const", "volatile", "noexcept", "override", "final", "mutable", "throw", "try",
+        "requires"};
+} // namespace
+
+void CppSymbolScanner::push(std::string_view text) {
+    m_pending.append(text);
+
+    std::size_t start{0};
+    std::size_t newline{};
+    while ((newline = m_pending.find('\n', start)) != std::string::npos) {
+        processLine(std::string_view(m_pending).substr(start, newline - start));
+        start = newline + 1;
+    }
+    m_pending.erase(0, start);
+}
+
+std::vector<Symbol> CppSymbolScanner::finish() {
+    if (!m_pending.empty()) {
+        processLine(m_pending);
+        m_pending.clear();
+    }
+    return std::move(m_symbols);
+}
+
+std::vector<Symbol> CppSymbolScanner::scan(std::string_view text) {
+    CppSymbolScanner scanner;
+    scanner.push(text);
+    return scanner.finish();
+}
+
+void CppSymbolScanner::processLine(std::string_view line) {
+    ++m_line;
+    m_lineStart = m_symbols.size();
+
+    if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+
+    // Directive (kể cả các dòng nối tiếp bằng '\') không đi vào parser
+    const auto endsWithBackslash = [](std::string_view s) {
+        while (!s.empty() && isSpace(s.back())) { s.remove_suffix(1); }
+        return !s.empty() && s.back() == '\\';
+    };
+    if (m_continuation) {
+        m_continuation = endsWithBackslash(line);
+        return;
+    }
+    if (!m_inBlockComment && !m_rawEnd) {
+        const auto first = line.find_first_not_of(" \t\f\v");
+        if (first != std::string_view::npos && line[first] == '#') {
+            directive(line.substr(first + 1));
+            m_continuation = endsWithBackslash(line);
+            return;
+        }
+    }
+
+    std::size_t i{0};
+    const std::size_t n = line.size();
+    while (i < n) {
+        if (m_inBlockComment) {
+            const auto end = line.find("*/", i);
+            if (end == std::string_view::npos) { return; }
+            m_inBlockComment = false;
+            i = end + 2;
+            continue;
+        }
+        if (m_rawEnd) {
+            const auto end = line.find(*m_rawEnd, i);
+            if (end == std::string_view::npos) { return; }
+            i = end + m_rawEnd->size();
+            m_rawEnd.reset();
+            feed(TokenType::string, {});
+            continue;
+        }
+
+        const char c = line[i];
+        if (isSpace(c)) {
+            ++i;
+        } else if (c == '/' && i + 1 < n && line[i + 1] == '/') {
+            return;
+        } else if (c == '/' && i + 1 < n && line[i + 1] == '*') {
+            m_inBlockComment = true;
+            i += 2;
+        } else if (isIdentStart(c)) {
+            std::size_t end = i;
+            while (end < n && isIdentChar(line[end])) { ++end; }
+            const auto word = line.substr(i, end - i);
+
+            if (end < n && line[end] == '"' && contains(kStringPrefixes, word)) {
+                if (!word.ends_with('R')) {
+                    i = end; // phần literal do nhánh '"' đọc
+                    continue;
+                }
+                // Raw string: R"delim( ... )delim"
+                const auto open = line.find('(', end + 1);
+                if (open == std::string_view::npos) { return; }
+                m_rawEnd = ")" + std::string(line.substr(end + 1, open - end - 1)) + "\"";
+                i = open + 1;
+                continue;
+            }
+            feed(TokenType::identifier, word);
+            i = end;
+        } else if ((c >= '0' && c <= '9') ||
+                   (c == '.' && i + 1 < n && line[i + 1] >= '0' && line[i + 1] <= '9')) {
+            // Số, kể cả 1'000'000, 0x1Fp-3, 1e+5
+            std::size_t end = i + 1;
+            while (end < n) {
+                const char d = line[end];
+                if (isIdentChar(d) || d == '.' || (d == '\'' && end + 1 < n &&
+                                                   isIdentChar(line[end + 1]))) {
+                    ++end;
+                } else if ((d == '+' || d == '-') &&
+                           (line[end - 1] == 'e' || line[end - 1] == 'E' ||
+                            line[end - 1] == 'p' || line[end - 1] == 'P')) {
+                    ++end;
+                } else {
+                    break;
+                }
+            }
+            feed(TokenType::other, line.substr(i, end - i));
+            i = end;
+        } else if (c == '"' || c == '\'') {
+            std::size_t end = i + 1;
+            while (end < n && line[end] != c) { end += line[end] == '\\' ? 2 : 1; }
+            feed(c == '"' ? TokenType::string : TokenType::other, {});
+            i = end + 1;
+        } else if ((c == ':' && i + 1 < n && line[i + 1] == ':') ||
+                   (c == '-' && i + 1 < n && line[i + 1] == '>')) {
+            feed(TokenType::punct, line.substr(i, 2));
+            i += 2;
+        } else {
+            feed(TokenType::punct, line.substr(i, 1));
+            ++i;
+        }
+    }
+}
+
+void CppSymbolScanner::directive(std::string_view line) {
+    const auto skipSpaces = [&] {
+        while (!line.empty() && isSpace(line.front())) { line.remove_prefix(1); }
+    };
+    const auto readIdent = [&] {
+        std::size_t end{0};
+        while (end < line.size() && isIdentChar(line[end])) { ++end; }
+        const auto word = line.substr(0, end);
+        line.remove_prefix(end);
+        return word;
+    };
+
+    skipSpaces();
+    const auto name = readIdent();
+    skipSpaces();
+
+    if (name == "include" || name == "include_next" || name == "import") {
+        if (line.empty() || (line.front() != '<' && line.front() != '"')) { return; }
+        const char close = line.front() == '<' ? '>' : '"';
+        const auto end = line.find(close, 1);
+        if (end == std::string_view::npos || end == 1) { return; }
+        add(SymbolKind::include, std::string(line.substr(1, end - 1)), m_line);
+    } else if (name == "define") {
+        if (line.empty() || !isIdentStart(line.front())) { return; }
+        add(SymbolKind::macro, std::string(readIdent()), m_line);
+    }
+}
+
+void CppSymbolScanner::feed(TokenType type, std::string_view text) {
+    Token token{.type = type, .text = std::string(text), .line = m_line};
+
+    switch (m_mode) {
+        case Mode::normal     : feedNormal(token); break;
+        case Mode::typeHead   : feedTypeHead(token); break;
+        case Mode::afterParams: feedAfterParams(token); break;
+        case Mode::initList   : feedInitList(token); break;
+        case Mode::typeArgs:
+            if (token.is("<")) {
+                ++m_depth;
+            } else if (token.is(">") && --m_depth == 0) {
+                m_mode = Mode::typeHead;
+                m_typeScoped = false;
+            } else if (token.is(";") || token.is("{") || token.is("}")) {
+                m_mode = Mode::normal;
+                feedNormal(token);
+            }
+            break;
+        case Mode::baseClause:
+            if (token.is("{")) {
+                add(SymbolKind::type, m_name, m_nameLine);
+                m_mode = Mode::normal;
+                openScope(m_isEnum ? Scope::enumBody : Scope::declaration);
+            } else if (token.is(";") || token.is("}")) {
+                // enum class E : int; là khai báo trước
+                m_mode = Mode::normal;
+                feedNormal(token);
+            }
+            break;
+        case Mode::params:
+            if (token.type == TokenType::string) {
+                m_sawString = true;
+            } else if (token.is("(")) {
+                ++m_depth;
+            } else if (token.is(")") && --m_depth == 0) {
+                m_mode = Mode::afterParams;
+            }
+            break;
+        case Mode::skipGroup:
+            if (token.is("(")) {
+                ++m_depth;
+            } else if (token.is(")") && --m_depth == 0) {
+                m_mode = m_returnMode;
+            }
+            break;
+    }
+
+    m_prevPrev = std::move(m_prev);
+    m_prev = std::move(token);
+}
+
+void CppSymbolScanner::feedNormal(const Token &token) {
+    if (!inDeclarationScope()) {
+        feedCode(token);
+        return;
+    }
+
+    if (m_operatorName) {
+        // operator==, operator(), operator bool, operator new[] ...
+        auto &name = *m_operatorName;
+        if (token.is("(") && name == "operator") {
+            name += "(";
+        } else if (token.is(")") && name.ends_with('(')) {
+            name += ")";
+        } else if (token.is("(")) {
+            startFunction(std::move(name), token.line);
+            m_operatorName.reset();
+        } else if (token.is(";") || token.is("{") || token.is("}")) {
+            m_operatorName.reset();
+            feedNormal(token);
+        } else if (token.type == TokenType::identifier) {
+            name += " " + token.text;
+        } else {
+            name += token.text;
+        }
+        return;
+    }
+
+    if (token.type == TokenType::identifier) {
+        const auto &word = token.text;
+        if (word == "class" || word == "struct" || word == "union" || word == "enum") {
+            // "enum class" đã ở typeHead
+            m_mode = Mode::typeHead;
+            m_isEnum = word == "enum";
+            m_name.clear();
+            m_typeScoped = false;
+            m_attrDepth = 0;
+        } else if (word == "namespace" || word == "extern") {
+            m_nextScope = Scope::declaration;
+        } else if (word == "operator") {
+            m_operatorName = "operator";
+        }
+        return;
+    }
+
+    if (token.is("(")) {
+        if (m_prev.type == TokenType::identifier && !contains(kNotCallee, m_prev.text)) {
+            const bool destructor = m_prevPrev.is("~");
+            startFunction((destructor ? "~" : "") + m_prev.text, m_prev.line);
+        } else {
+            m_mode = Mode::skipGroup;
+            m_returnMode = Mode::normal;
+            m_depth = 1;
+        }
+    } else if (token.is("{")) {
+        openScope(m_nextScope.value_or(Scope::code));
+    } else if (token.is("}")) {
+        closeScope();
+    } else if (token.is(";")) {
+        m_nextScope.reset();
+    }
+}
+
+void CppSymbolScanner::feedCode(const Token &token) {
+    if (token.is("{")) {
+        openScope(Scope::code);
+    } else if (token.is("}")) {
+        closeScope();
+    } else if (token.is("(") && m_scopes.back() == Scope::code &&
+               m_prev.type == TokenType::identifier && !contains(kNotCallee, m_prev.text) &&
+               (m_prevPrev.type != TokenType::identifier ||
+                contains(kBeforeCall, m_prevPrev.text))) {
+        add(SymbolKind::call, m_prev.text, m_prev.line);
+    }
+}
+
+void CppSymbolScanner::feedTypeHead(const Token &token) {
+    if (m_attrDepth > 0 || token.is("[")) {
+        // [[nodiscard]], alignas(...) không phải tên
+        if (token.is("[")) { ++m_attrDepth; }
+        if (token.is("]")) { --m_attrDepth; }
+        return;
+    }
+
+    if (token.type == TokenType::identifier) {
+        if (token.text == "class" || token.text == "struct" || token.text == "final") { return; }
+        if (token.text == "alignas") {
+            // skipGroup từ độ sâu 0: '(' kế tiếp mở nhóm
+            m_mode = Mode::skipGroup;
+            m_returnMode = Mode::typeHead;
+            m_depth = 0;
+            return;
+        }
+        if (m_name.empty() || m_typeScoped) {
+            m_name = token.text;
+            m_nameLine = token.line;
+            m_typeScoped = false;
+            return;
+        }
+        // "struct stat info;", "class Foo bar()" ...
+        m_mode = Mode::normal;
+        feedNormal(token);
+        return;
+    }
+
+    if (token.is("::")) {
+        m_typeScoped = true;
+    } else if (token.is("<") && !m_name.empty()) {
+        m_mode = Mode::typeArgs;
+        m_depth = 1;
+    } else if (token.is("{") && !m_name.empty()) {
+        add(SymbolKind::type, m_name, m_nameLine);
+        m_mode = Mode::normal;
+        openScope(m_isEnum ? Scope::enumBody : Scope::declaration);
+    } else if (token.is(":") && !m_name.empty()) {
+        m_mode = Mode::baseClause;
+    } else {
+        // Khai báo trước, biến kiểu struct, tham số template <class T> ...
+        m_mode = Mode::normal;
+        feedNormal(token);
+    }
+}
+
+void CppSymbolScanner::feedAfterParams(const Token &token) {
+    if (token.is("{")) {
+        if (!m_sawString) { add(SymbolKind::function, m_name, m_nameLine); }
+        m_mode = Mode::normal;
+        openScope(Scope::code);
+    } else if (token.is(":") && !m_trailing) {
+        m_mode = Mode::initList;
+        m_depth = 0;
+        m_nameLike = false;
+    } else if (token.is("(")) {
+        // noexcept(...), throw(...), requires(...), decltype(...)
+        m_mode = Mode::skipGroup;
+        m_returnMode = Mode::afterParams;
+        m_depth = 1;
+    } else if (token.is("->")) {
+        m_trailing = true;
+    } else if (token.type == TokenType::identifier) {
+        if (m_trailing || contains(kAfterParams, token.text)) {
+            m_trailing = m_trailing || token.text == "requires";
+            return;
+        }
+        // Macro không tham số theo sau lời gọi, vd TEST_CASE(...) SECTION ...
+        m_mode = Mode::normal;
+        feedNormal(token);
+    } else if (token.is(";") || token.is("=") || token.is("}") || token.is(",") ||
+               token.type != TokenType::punct) {
+        // Khai báo, = default/delete, biến khởi tạo bằng ()
+        m_mode = Mode::normal;
+        feedNormal(token);
+    }
+}
+
+void CppSymbolScanner::feedInitList(const Token &token) {
+    if (m_depth > 0) {
+        if (token.is("(") || token.is("{") || token.is("[")) {
+            ++m_depth;
+        } else if ((token.is(")") || token.is("}") || token.is("]")) && --m_depth == 0) {
+            m_nameLike = false;
+        }
+        return;
+    }
+
+    if ((token.is("(") || token.is("{")) && m_nameLike) {
+        m_depth = 1;
+    } else if (token.is("{")) {
+        if (!m_sawString) { add(SymbolKind::function, m_name, m_nameLine); }
+        m_mode = Mode::normal;
+        openScope(Scope::code);
+    } else if (token.is(";") || token.is("}")) {
+        // Bit-field, nhãn public: ... không phải init list
+        m_mode = Mode::normal;
+        feedNormal(token);
+    } else {
+        m_nameLike = token.type == TokenType::identifier || token.is("::") || token.is(">");
+    }
+}
+
+void CppSymbolScanner::startFunction(std::string name, int line) {
+    m_name = std::move(name);
+    m_nameLine = line;
+    m_mode = Mode::params;
+    m_depth = 1;
+    m_sawString = false;
+    m_trailing = false;
+}
+
+void CppSymbolScanner::openScope(Scope scope) {
+    m_scopes.push_back(scope);
+    m_nextScope.reset();
+}
+
+void CppSymbolScanner::closeScope() {
+    if (!m_scopes.empty()) { m_scopes.pop_back(); }
+    m_nextScope.reset();
+}
+
+bool CppSymbolScanner::inDeclarationScope() const noexcept {
+    return m_scopes.empty() || m_scopes.back() == Scope::declaration;
+}
+
+void CppSymbolScanner::add(SymbolKind kind, std::string name, int line) {
+    // Cùng tên, cùng loại trên một dòng chỉ ghi một lần (f(f(x)))
+    const bool seen =
+        std::any_of(m_symbols.begin() + static_cast<std::ptrdiff_t>(m_lineStart), m_symbols.end(),
+                    [&](const Symbol &symbol) {
+                        return symbol.kind == kind && symbol.line == line && symbol.name == name;
+                    });
+    if (seen) { return; }
+
+    m_symbols.push_back(Symbol{.kind = kind, .name = std::move(name), .line = line});
+}
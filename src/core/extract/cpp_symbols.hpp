@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "model.hpp"
+
+// Lexer C++ nhẹ (không preprocess, không parse đầy đủ) trích ký hiệu cho bảng symbols:
+//   #include <x> / "x"            -> include
+//   #define NAME                   -> macro
+//   class/struct/union/enum Name { -> type (khai báo trước "class Foo;" bị bỏ qua)
+//   ret name(params) ... {         -> function, ở scope namespace/class (kể cả Foo::bar, ~Foo,
+//                                     operator==, constructor có init list)
+//   name(                          -> call, trong thân hàm
+// Bỏ qua comment, string/char/raw string; không theo #if nên cả hai nhánh đều được quét.
+// Text được đẩy vào theo từng đoạn bất kỳ, chỉ giữ lại dòng chưa trọn nên bộ nhớ không phụ
+// thuộc kích thước file.
+class CppSymbolScanner {
+    public:
+        void push(std::string_view text);
+
+        // Xử lý phần còn lại; ký hiệu theo thứ tự dòng, resource_id = 0
+        std::vector<Symbol> finish();
+
+        [[nodiscard]] static std::vector<Symbol> scan(std::string_view text);
+
+    private:
+        enum class TokenType : std::uint8_t { identifier, punct, string, other };
+
+        struct Token {
+                TokenType type{TokenType::other};
+                std::string text;
+                int line{};
+
+                [[nodiscard]] bool is(std::string_view value) const noexcept {
+                    return type == TokenType::punct && text == value;
+                }
+        };
+
+        // declaration: global/namespace/class (có định nghĩa), code: thân hàm, initializer
+        enum class Scope : std::uint8_t { declaration, code, enumBody };
+
+        enum class Mode : std::uint8_t {
+            normal,
+            typeHead,    // sau class/struct/union/enum, chờ tên rồi '{' hoặc ':'
+            typeArgs,    // <...> sau tên type (specialization)
+            baseClause,  // sau ':' của type, chờ '{'
+            params,      // (...) của hàm ứng viên
+            afterParams, // const/noexcept/-> ... chờ '{', ':' (init list) hoặc ';'
+            initList,    // init list của constructor
+            skipGroup    // (...) không phải tham số (decltype(...), noexcept(...), macro)
+        };
+
+        void processLine(std::string_view line);
+        void directive(std::string_view line);
+        void feed(TokenType type, std::string_view text);
+
+        void feedNormal(const Token &token);
+        void feedCode(const Token &token);
+        void feedTypeHead(const Token &token);
+        void feedAfterParams(const Token &token);
+        void feedInitList(const Token &token);
+
+        void startFunction(std::string name, int line);
+        void openScope(Scope scope);
+        void closeScope();
+        [[nodiscard]] bool inDeclarationScope() const noexcept;
+        void add(SymbolKind kind, std::string name, int line);
+
+        std::string m_pending;
+        int m_line{};
+        bool m_inBlockComment{};
+        std::optional<std::string> m_rawEnd; // )delim" khi đang trong raw string nhiều dòng
+        bool m_continuation{};               // dòng trước là directive kết thúc bằng '\'
+
+        std::vector<Scope> m_scopes;
+        std::optional<Scope> m_nextScope; // scope cho '{' kế tiếp (namespace, extern "C")
+        Mode m_mode{Mode::normal};
+        Mode m_returnMode{Mode::normal}; // mode quay lại sau skipGroup
+        int m_depth{};
+        Token m_prev;
+        Token m_prevPrev;
+
+        std::string m_name; // hàm hoặc type ứng viên
+        int m_nameLine{};
+        bool m_sawString{}; // tham số có string literal => gọi macro (TEST_CASE("...")), không
+                            // phải định nghĩa hàm
+        bool m_trailing{};  // sau "->" / requires: bỏ qua mọi token tới '{'
+        bool m_nameLike{};  // init list: token trước là tên member/base
+        bool m_typeScoped{};
+        bool m_isEnum{};
+        int m_attrDepth{};
+        std::optional<std::string> m_operatorName;
+
+        std::vector<Symbol> m_symbols;
+        std::size_t m_lineStart{}; // ký hiệu đầu tiên của dòng hiện tại (lọc trùng)
+};
@@ -0,0 +1,218 @@
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "epub_extractor.hpp"
+#include "markup_text.hpp"
+#include "zip_archive.hpp"
+
+namespace {
+    constexpr std::string_view kContainerPath{"META-INF/container.xml"};
+
+    bool isSpace(char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    // suffix phải viết thường
+    bool endsWithNoCase(std::string_view s, std::string_view suffix) {
+        if (s.size() < suffix.size()) { return false; }
+        return std::equal(suffix.rbegin(), suffix.rend(), s.rbegin(), [](char a, char b) {
+            return a == ((b >= 'A' && b <= 'Z') ? static_cast<char>(b - 'A' + 'a') : b);
+        });
+    }
+
+    // Gọi fn(nội dung giữa '<' và '>') cho mọi thẻ mở có local name khớp (bỏ prefix namespace).
+    // Đủ cho container.xml/OPF: không cần cây DOM, chỉ cần attribute của vài loại thẻ.
+    template <typename Fn>
+    void forEachElement(std::string_view xml, std::string_view localName, Fn fn) {
+        std::size_t pos{0};
+        while ((pos = xml.find('<', pos)) != std::string_view::npos) {
+            const auto end = xml.find('>', pos);
+            if (end == std::string_view::npos) { return; }
+
+            const auto tag = xml.substr(pos + 1, end - pos - 1);
+            pos = end + 1;
+
+            std::size_t nameEnd{0};
+            while (nameEnd < tag.size() && !isSpace(tag[nameEnd]) && tag[nameEnd] != '/') {
+                ++nameEnd;
+            }
+
+            auto name = tag.substr(0, nameEnd);
+            if (const auto colon = name.find(':'); colon != std::string_view::npos) {
+                name.remove_prefix(colon + 1);
+            }
+
+            if (name == localName) { fn(tag); }
+        }
+    }
+
+    // Giá trị attribute trong một thẻ (đã giải mã &amp;); rỗng nếu không có
+    std::string attribute(std::string_view tag, std::string_view name) {
+        std::size_t pos{0};
+        while ((pos = tag.find(name, pos)) != std::string_view::npos) {
+            const bool startsWord = pos > 0 && isSpace(tag[pos - 1]);
+            std::size_t i = pos + name.size();
+            pos = i;
+            if (!startsWord) { continue; }
+
+            while (i < tag.size() && isSpace(tag[i])) { ++i; }
+            if (i >= tag.size() || tag[i] != '=') { continue; }
+            ++i;
+            while (i < tag.size() && isSpace(tag[i])) { ++i; }
+            if (i >= tag.size() || (tag[i] != '"' && tag[i] != '\'')) { continue; }
+
+            const char quote = tag[i];
+            const auto close = tag.find(quote, i + 1);
+            if (close == std::string_view::npos) { return {}; }
+
+            std::string value(tag.substr(i + 1, close - i - 1));
+            for (std::size_t amp = 0; (amp = value.find("&amp;", amp)) != std::string::npos;) {
+                value.erase(amp + 1, 4);
+                ++amp;
+            }
+            return value;
+        }
+        return {};
+    }
+
+    int hexValue(char c) noexcept {
+        if (c >= '0' && c <= '9') { return c - '0'; }
+        if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+        if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+        return -1;
+    }
+
+    // href trong OPF là URL tương đối so với thư mục chứa OPF: bỏ fragment,
+    // giải mã %XX và chuẩn hóa "."/".." thành đường dẫn entry trong ZIP
+    std::string resolveHref(std::string_view baseDir, std::string_view href) {
+        if (const auto hash = href.find('#'); hash != std::string_view::npos) {
+            href = href.substr(0, hash);
+        }
+
+        std::string decoded;
+        decoded.reserve(href.size());
+        for (std::size_t i = 0; i < href.size(); ++i) {
+            if (href[i] == '%' && i + 2 < href.size() && hexValue(href[i + 1]) >= 0 &&
+                hexValue(href[i + 2]) >= 0) {
+                decoded += static_cast<char>(hexValue(href[i + 1]) * 16 + hexValue(href[i + 2]));
+                i += 2;
+            } else {
+                decoded += href[i];
+            }
+        }
+
+        std::string joined = decoded.starts_with('/') ? decoded.substr(1)
+                                                      : std::string(baseDir) + decoded;
+
+        std::vector<std::string> segments;
+        std::size_t start{0};
+        while (start <= joined.size()) {
+            auto slash = joined.find('/', start);
+            if (slash == std::string::npos) { slash = joined.size(); }
+
+            const auto segment = joined.substr(start, slash - start);
+            if (segment == "..") {
+                if (!segments.empty()) { segments.pop_back(); }
+            } else if (!segment.empty() && segment != ".") {
+                segments.push_back(segment);
+            }
+            start = slash + 1;
+        }
+
+        std::string result;
+        for (const auto &segment : segments) {
+            if (!result.empty()) { result += '/'; }
+            result += segment;
+        }
+        return result;
+    }
+
+    bool isXhtmlMediaType(std::string_view mediaType) {
+        return mediaType == "application/xhtml+xml" || mediaType == "text/html";
+    }
+} // namespace
+
+EpubExtractor::EpubExtractor(const std::filesystem::path &path) : m_zip(path) {
+    loadSpine();
+    if (m_spine.empty()) { loadFallbackSpine(); }
+}
+
+void EpubExtractor::loadSpine() {
+    const auto* container = m_zip.find(kContainerPath);
+    if (container == nullptr) { return; }
+
+    const auto containerXml = m_zip.readEntryToString(*container, kMaxMetadataBytes);
+
+    std::string opfPath;
+    forEachElement(containerXml, "rootfile", [&](std::string_view tag) {
+        if (!opfPath.empty()) { return; }
+        const auto mediaType = attribute(tag, "media-type");
+        if (mediaType.empty() || mediaType == "application/oebps-package+xml") {
+            opfPath = attribute(tag, "full-path");
+        }
+    });
+
+    const auto* opf = opfPath.empty() ? nullptr : m_zip.find(opfPath);
+    if (opf == nullptr) { return; }
+
+    const auto opfXml = m_zip.readEntryToString(*opf, kMaxMetadataBytes);
+
+    const auto slash = opfPath.rfind('/');
+    const std::string baseDir = slash == std::string::npos ? "" : opfPath.substr(0, slash + 1);
+
+    struct ManifestItem {
+            std::string path;
+            std::string mediaType;
+    };
+    std::unordered_map<std::string, ManifestItem> manifest;
+
+    forEachElement(opfXml, "item", [&](std::string_view tag) {
+        auto id = attribute(tag, "id");
+        auto href = attribute(tag, "href");
+        if (id.empty() || href.empty()) { return; }
+
+        manifest.emplace(std::move(id),
+                         ManifestItem{resolveHref(baseDir, href), attribute(tag, "media-type")});
+    });
+
+    forEachElement(opfXml, "itemref", [&](std::string_view tag) {
+        const auto it = manifest.find(attribute(tag, "idref"));
+        if (it == manifest.end() || !isXhtmlMediaType(it->second.mediaType)) { return; }
+
+        // Cùng một tài liệu có thể xuất hiện nhiều lần trong spine lỗi
+        if (std::ranges::find(m_spine, it->second.path) == m_spine.end()) {
+            m_spine.push_back(it->second.path);
+        }
+    });
+}
+
+void EpubExtractor::loadFallbackSpine() {
+    // Không có container/OPF hợp lệ: lấy mọi tài liệu HTML theo thứ tự tên
+    for (const auto &entry : m_zip.entries()) {
+        const std::string_view name = entry.name;
+        if (endsWithNoCase(name, ".xhtml") || endsWithNoCase(name, ".html") ||
+            endsWithNoCase(name, ".htm")) {
+            m_spine.push_back(entry.name);
+        }
+    }
+    std::ranges::sort(m_spine);
+}
+
+void EpubExtractor::extractText(const TextSink &sink) {
+    bool first = true;
+
+    for (const auto &path : m_spine) {
+        const auto* entry = m_zip.find(path);
+        if (entry == nullptr) { continue; } // manifest trỏ tới file không có trong archive
+
+        if (!first) { sink("\n\n"); }
+        first = false;
+
+        MarkupTextScanner scanner(sink);
+        m_zip.readEntry(
+            *entry, [&](std::string_view block) { scanner.feed(block); }, kMaxDocumentBytes);
+        scanner.finish();
+    }
+}
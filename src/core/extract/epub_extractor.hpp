@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "zip_archive.hpp"
+
+// Trích text của một cuốn EPUB theo thứ tự đọc:
+//   META-INF/container.xml -> file OPF -> manifest + spine -> từng tài liệu XHTML
+// Mỗi tài liệu được giải nén từng block và bỏ thẻ bằng MarkupTextScanner,
+// nên bộ nhớ chỉ phụ thuộc kích thước block chứ không phụ thuộc kích thước sách.
+// Một EpubExtractor chỉ dùng trên một thread; các cuốn khác nhau có thể trích song song.
+class EpubExtractor {
+    public:
+        using TextSink = std::function<void(std::string_view)>;
+
+        static constexpr std::uint64_t kMaxMetadataBytes{4ULL * 1024 * 1024};   // container/OPF
+        static constexpr std::uint64_t kMaxDocumentBytes{64ULL * 1024 * 1024};  // mỗi chương
+
+        // Mở archive và đọc spine; ném std::runtime_error nếu file không phải EPUB/ZIP hợp lệ
+        explicit EpubExtractor(const std::filesystem::path &path);
+
+        // Đường dẫn (trong archive) các tài liệu XHTML theo thứ tự spine
+        [[nodiscard]] const std::vector<std::string> &spine() const noexcept { return m_spine; }
+
+        // Đẩy text của cả cuốn ra sink, các chương cách nhau bởi dòng trống
+        void extractText(const TextSink &sink);
+
+    private:
+        void loadSpine();
+        void loadFallbackSpine();
+
+        ZipArchive m_zip;
+        std::vector<std::string> m_spine;
+};
@@ -0,0 +1,278 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "markup_text.hpp"
+
+namespace {
+    constexpr std::size_t kFlushSize{16 * 1024};
+    constexpr std::size_t kMaxTagName{32};
+    constexpr std::size_t kMaxEntity{12};
+
+    // Nội dung là raw text (có thể chứa '<'), không phải markup
+    constexpr std::array<std::string_view, 2> kRawTextElements{"script", "style"};
+
+    constexpr std::array<std::string_view, 33> kBlockElements{
+        "address", "article", "aside", "blockquote", "body", "br", "dd", "div", "dl",
+        "dt", "figcaption", "figure", "footer", "h1", "h2", "h3", "h4", "h5", "h6", "header",
+        "hr", "html", "li", "nav", "ol", "p", "pre", "section", "table", "td", "th", "tr", "ul"};
+
+    bool isSpace(char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+    }
+
+    char toLower(char c) noexcept {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    bool contains(const auto &list, std::string_view name) {
+        return std::ranges::find(list, name) != list.end();
+    }
+
+    // Mã hóa code point thành UTF-8; trả về chuỗi rỗng nếu code point không hợp lệ
+    std::string encodeUtf8(std::uint32_t cp) {
+        std::string out;
+        if (cp == 0 || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) { return out; }
+
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6U));
+            out += static_cast<char>(0x80 | (cp & 0x3FU));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12U));
+            out += static_cast<char>(0x80 | ((cp >> 6U) & 0x3FU));
+            out += static_cast<char>(0x80 | (cp & 0x3FU));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18U));
+            out += static_cast<char>(0x80 | ((cp >> 12U) & 0x3FU));
+            out += static_cast<char>(0x80 | ((cp >> 6U) & 0x3FU));
+            out += static_cast<char>(0x80 | (cp & 0x3FU));
+        }
+        return out;
+    }
+
+    // Giải mã entity (không gồm '&' và ';'); trả về false nếu không nhận ra
+    bool decodeEntity(std::string_view name, std::string &out) {
+        if (name == "amp") { out = "&"; return true; }
+        if (name == "lt") { out = "<"; return true; }
+        if (name == "gt") { out = ">"; return true; }
+        if (name == "quot") { out = "\""; return true; }
+        if (name == "apos") { out = "'"; return true; }
+        if (name == "nbsp") { out = " "; return true; }
+
+        if (name.size() < 2 || name[0] != '#') { return false; }
+
+        int base = 10;
+        name.remove_prefix(1);
+        if (name[0] == 'x' || name[0] == 'X') {
+            base = 16;
+            name.remove_prefix(1);
+        }
+
+        std::uint32_t cp{};
+        const auto [ptr, ec] = std::from_chars(name.data(), name.data() + name.size(), cp, base);
+        if (ec != std::errc{} || ptr != name.data() + name.size()) { return false; }
+
+        out = encodeUtf8(cp);
+        return true;
+    }
+} // namespace
+
+MarkupTextScanner::MarkupTextScanner(TextSink sink) : m_sink(std::move(sink)) {
+    m_out.reserve(kFlushSize);
+}
+
+void MarkupTextScanner::feed(std::string_view data) {
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        const char c = data[i];
+
+        switch (m_state) {
+        case State::text:
+            if (c == '<') {
+                m_state = State::tagName;
+                m_tagName.clear();
+                m_closingTag = false;
+                m_selfClosing = false;
+            } else if (c == '&' && m_skipUntil.empty()) {
+                m_state = State::entity;
+                m_entity.clear();
+            } else {
+                handleText(c);
+            }
+            break;
+
+        case State::tagName:
+            if (m_tagName.empty() && !m_closingTag && (c == '!' || c == '?')) {
+                m_state = State::declaration;
+                m_tagName.assign(1, c);
+            } else if (m_tagName.empty() && c == '/') {
+                m_closingTag = true;
+            } else if (c == '>') {
+                endTag();
+            } else if (isSpace(c)) {
+                m_state = State::tagBody;
+            } else if (c == '/') {
+                m_selfClosing = true;
+                m_state = State::tagBody;
+            } else if (c == ':') {
+                m_tagName.clear(); // bỏ prefix namespace (xhtml:p -> p)
+            } else if (m_tagName.size() < kMaxTagName) {
+                m_tagName += toLower(c);
+            }
+            break;
+
+        case State::tagBody:
+            if (m_quote != 0) {
+                if (c == m_quote) { m_quote = 0; }
+            } else if (c == '"' || c == '\'') {
+                m_quote = c;
+            } else if (c == '>') {
+                endTag();
+            } else if (c == '/') {
+                m_selfClosing = true;
+            } else if (!isSpace(c)) {
+                m_selfClosing = false;
+            }
+            break;
+
+        case State::declaration:
+            // "<!--" chuyển sang comment; các khai báo khác (<!DOCTYPE>, <?xml?>) bỏ đến '>'
+            if (m_tagName.size() < 3 && m_tagName[0] == '!' && c == '-') {
+                m_tagName += c;
+                if (m_tagName == "!--") {
+                    m_state = State::comment;
+                    m_commentDashes = 0;
+                }
+            } else if (c == '>') {
+                m_state = State::text;
+            } else {
+                m_tagName += ' '; // không còn là "<!--"
+            }
+            break;
+
+        case State::comment:
+            if (c == '-') {
+                ++m_commentDashes;
+            } else if (c == '>' && m_commentDashes >= 2) {
+                m_state = State::text;
+            } else {
+                m_commentDashes = 0;
+            }
+            break;
+
+        case State::rawText:
+            if (toLower(c) == m_rawClose[m_rawMatch]) {
+                if (++m_rawMatch == m_rawClose.size()) {
+                    m_state = State::tagBody;
+                    m_tagName = m_rawClose.substr(2);
+                    m_closingTag = true;
+                    m_selfClosing = false;
+                }
+            } else {
+                m_rawMatch = c == '<' ? 1 : 0;
+            }
+            break;
+
+        case State::entity:
+            if (c == ';') {
+                endEntity();
+            } else if (m_entity.size() >= kMaxEntity || isSpace(c) || c == '<' || c == '&') {
+                // Không phải entity: giữ nguyên '&...' rồi xử lý lại ký tự hiện tại như text
+                m_state = State::text;
+                emitChar('&');
+                for (const char e : m_entity) { emitChar(e); }
+                --i;
+            } else {
+                m_entity += c;
+            }
+            break;
+        }
+    }
+}
+
+void MarkupTextScanner::finish() {
+    if (m_state == State::entity) {
+        emitChar('&');
+        for (const char e : m_entity) { emitChar(e); }
+    }
+    m_state = State::text;
+    flush();
+}
+
+void MarkupTextScanner::handleText(char c) {
+    if (!m_skipUntil.empty()) { return; }
+
+    if (isSpace(c)) {
+        m_pendingSpace = true;
+    } else {
+        emitChar(c);
+    }
+}
+
+void MarkupTextScanner::endTag() {
+    m_state = State::text;
+    m_quote = 0;
+
+    const bool opening = !m_closingTag && !m_selfClosing;
+
+    if (opening && contains(kRawTextElements, m_tagName)) {
+        m_state = State::rawText;
+        m_rawClose = "</" + m_tagName;
+        m_rawMatch = 0;
+        return;
+    }
+
+    if (!m_skipUntil.empty()) {
+        if (m_closingTag && m_tagName == m_skipUntil) { m_skipUntil.clear(); }
+        return;
+    }
+
+    if (opening && m_tagName == "head") {
+        m_skipUntil = m_tagName;
+        return;
+    }
+
+    // Thẻ inline (span, a, em, ...) không tạo khoảng trắng: "<b>x</b>y" -> "xy"
+    if (contains(kBlockElements, m_tagName)) { emitBreak(); }
+}
+
+void MarkupTextScanner::endEntity() {
+    m_state = State::text;
+
+    std::string decoded;
+    if (!decodeEntity(m_entity, decoded)) {
+        emitChar('&');
+        for (const char e : m_entity) { emitChar(e); }
+        emitChar(';');
+        return;
+    }
+
+    for (const char d : decoded) { handleText(d); }
+}
+
+void MarkupTextScanner::emitChar(char c) {
+    if (m_pendingSpace && !m_atLineStart) { m_out += ' '; }
+    m_pendingSpace = false;
+    m_atLineStart = false;
+
+    m_out += c;
+    if (m_out.size() >= kFlushSize) { flush(); }
+}
+
+void MarkupTextScanner::emitBreak() {
+    if (!m_atLineStart) {
+        m_out += '\n';
+        m_atLineStart = true;
+    }
+    m_pendingSpace = false;
+}
+
+void MarkupTextScanner::flush() {
+    if (m_out.empty()) { return; }
+    m_sink(m_out);
+    m_out.clear();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Bỏ thẻ (X)HTML theo kiểu SAX: nhận input từng đoạn bất kỳ (có thể cắt giữa thẻ/entity),
+// trạng thái giữ giữa các lần feed nên không cần nạp cả tài liệu.
+// - bỏ nội dung <head>, <script>, <style>, comment, <!DOCTYPE>, <?xml ...?>
+// - giải mã entity cơ bản (&amp; &lt; ... &#NN; &#xNN;)
+// - thẻ khối (p, div, h1..h6, li, br, ...) thành xuống dòng; khoảng trắng liên tiếp gộp lại
+class MarkupTextScanner {
+    public:
+        using TextSink = std::function<void(std::string_view)>;
+
+        explicit MarkupTextScanner(TextSink sink);
+
+        void feed(std::string_view data);
+
+        // Xả phần text còn giữ trong buffer; gọi một lần khi hết tài liệu
+        void finish();
+
+    private:
+        enum class State { text, tagName, tagBody, comment, declaration, entity, rawText };
+
+        void handleText(char c);
+        void endTag();
+        void endEntity();
+        void emitChar(char c);
+        void emitBreak();
+        void flush();
+
+        TextSink m_sink;
+        State m_state{State::text};
+
+        std::string m_out;       // text chờ đẩy ra sink (giới hạn kích thước)
+        std::string m_tagName;   // tên thẻ hiện tại (lowercase, bỏ prefix namespace)
+        std::string m_entity;    // entity đang đọc dở
+        std::string m_skipUntil; // đang trong <head>: bỏ text đến thẻ đóng này
+        std::string m_rawClose;  // "</script" / "</style": nội dung raw text, chỉ tìm thẻ đóng
+        std::size_t m_rawMatch{};
+
+        bool m_closingTag{};
+        bool m_selfClosing{};
+        char m_quote{};          // đang trong giá trị attribute
+        int m_commentDashes{};   // số '-' liên tiếp vừa gặp trong comment
+        bool m_pendingSpace{};
+        bool m_atLineStart{true};
+};
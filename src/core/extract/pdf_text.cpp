@@ -0,0 +1,1307 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+#include <zlib.h>
+#include "pdf_text.hpp"
+
+namespace {
+    constexpr std::size_t kMaxDecodedStream{64 * 1024 * 1024};
+    constexpr std::size_t kMaxPageText{4 * 1024 * 1024};
+    constexpr std::size_t kMaxOperands{1024};
+    constexpr std::uint32_t kMaxBfRange{0x10000};
+    constexpr int kMaxNesting{64};     // mảng/dict lồng nhau, độ sâu cây trang
+    constexpr int kMaxResolveDepth{32};
+    constexpr int kMaxFormDepth{8};
+
+    // TJ: khoảng cách âm lớn hơn ngưỡng này (phần nghìn em) coi như dấu cách
+    constexpr double kTjSpaceThreshold{-200.0};
+
+    // ------------------------------------------------------------
+    // Object model
+    // ------------------------------------------------------------
+    struct Object;
+    struct Dict;
+    using Array = std::vector<Object>;
+
+    struct Name {
+            std::string value;
+    };
+
+    struct Ref {
+            int num{};
+            int gen{};
+    };
+
+    struct Stream {
+            std::shared_ptr<const Dict> dict;
+            std::size_t offset{}; // vị trí dữ liệu thô trong file
+            std::size_t length{};
+    };
+
+    struct Object {
+            std::variant<std::monostate, bool, double, std::string, Name,
+                         std::shared_ptr<const Array>, std::shared_ptr<const Dict>, Ref, Stream>
+                value;
+
+            template <typename T>
+            [[nodiscard]] const T* as() const noexcept {
+                return std::get_if<T>(&value);
+            }
+    };
+
+    struct Dict {
+            std::vector<std::pair<std::string, Object>> entries;
+
+            [[nodiscard]] const Object* find(std::string_view key) const {
+                for (const auto &[k, v] : entries) {
+                    if (k == key) { return &v; }
+                }
+                return nullptr;
+            }
+    };
+
+    const Object kNull{};
+
+    std::string_view nameOf(const Object* obj) {
+        if (obj == nullptr) { return {}; }
+        const auto* name = obj->as<Name>();
+        return name != nullptr ? std::string_view(name->value) : std::string_view{};
+    }
+
+    std::optional<double> numberOf(const Object* obj) {
+        if (obj == nullptr) { return std::nullopt; }
+        const auto* number = obj->as<double>();
+        return number != nullptr ? std::optional<double>(*number) : std::nullopt;
+    }
+
+    // ------------------------------------------------------------
+    // Lexer
+    // ------------------------------------------------------------
+    bool isSpace(char c) noexcept {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\0';
+    }
+
+    bool isDelimiter(char c) noexcept {
+        return c == '(' || c == ')' || c == '<' || c == '>' || c == '[' || c == ']' || c == '{' ||
+               c == '}' || c == '/' || c == '%';
+    }
+
+    bool isRegular(char c) noexcept {
+        return !isSpace(c) && !isDelimiter(c);
+    }
+
+    bool isDigit(char c) noexcept {
+        return c >= '0' && c <= '9';
+    }
+
+    int hexValue(char c) noexcept {
+        if (c >= '0' && c <= '9') { return c - '0'; }
+        if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+        if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+        return -1;
+    }
+
+    class Lexer {
+        public:
+            Lexer(std::string_view data, std::size_t pos, bool allowRefs)
+                : m_data(data), m_pos(pos), m_allowRefs(allowRefs) {}
+
+            [[nodiscard]] std::size_t pos() const noexcept { return m_pos; }
+            [[nodiscard]] bool atEnd() const noexcept { return m_pos >= m_data.size(); }
+
+            void skipSpace() {
+                while (m_pos < m_data.size()) {
+                    if (isSpace(m_data[m_pos])) {
+                        ++m_pos;
+                    } else if (m_data[m_pos] == '%') {
+                        while (m_pos < m_data.size() && m_data[m_pos] != '\n' &&
+                               m_data[m_pos] != '\r') {
+                            ++m_pos;
+                        }
+                    } else {
+                        break;
+                    }
+                }
+            }
+
+            // Token tiếp theo: object (keyword rỗng) hoặc keyword/toán tử. false khi hết dữ liệu.
+            bool next(Object &obj, std::string &keyword) {
+                keyword.clear();
+                skipSpace();
+                if (atEnd()) { return false; }
+
+                const char c = m_data[m_pos];
+                if (isRegular(c) && !isDigit(c) && c != '+' && c != '-' && c != '.') {
+                    keyword = readRegular();
+                    if (keyword == "true" || keyword == "false") {
+                        obj.value = keyword == "true";
+                        keyword.clear();
+                    } else if (keyword == "null") {
+                        obj = kNull;
+                        keyword.clear();
+                    }
+                    return true;
+                }
+
+                obj = parseObject(0);
+                return true;
+            }
+
+            Object parseObject(int depth) {
+                skipSpace();
+                if (atEnd() || depth > kMaxNesting) { return kNull; }
+
+                const char c = m_data[m_pos];
+                switch (c) {
+                case '/': ++m_pos; return Object{Name{readName()}};
+                case '(': ++m_pos; return Object{readLiteralString()};
+                case '[': ++m_pos; return readArray(depth);
+                case '<':
+                    if (m_pos + 1 < m_data.size() && m_data[m_pos + 1] == '<') {
+                        m_pos += 2;
+                        return readDict(depth);
+                    }
+                    ++m_pos;
+                    return Object{readHexString()};
+                default: break;
+                }
+
+                if (isDigit(c) || c == '+' || c == '-' || c == '.') { return readNumberOrRef(); }
+
+                // Keyword trong ngữ cảnh object (true/false/null hoặc rác): đọc bỏ
+                const auto word = readRegular();
+                if (word == "true") { return Object{true}; }
+                if (word == "false") { return Object{false}; }
+                if (word.empty()) { ++m_pos; } // delimiter lẻ (')', '>', '{', ...)
+                return kNull;
+            }
+
+            // Sau dict của indirect object: có từ khóa "stream" không (không tiêu thụ nếu không có)
+            bool consumeKeyword(std::string_view keyword) {
+                skipSpace();
+                if (m_data.substr(m_pos, keyword.size()) != keyword) { return false; }
+
+                const auto end = m_pos + keyword.size();
+                if (end < m_data.size() && isRegular(m_data[end])) { return false; }
+
+                m_pos = end;
+                return true;
+            }
+
+        private:
+            std::string readRegular() {
+                const auto start = m_pos;
+                while (m_pos < m_data.size() && isRegular(m_data[m_pos])) { ++m_pos; }
+                return std::string(m_data.substr(start, m_pos - start));
+            }
+
+            std::string readName() {
+                std::string name;
+                while (m_pos < m_data.size() && isRegular(m_data[m_pos])) {
+                    const char c = m_data[m_pos++];
+                    if (c == '#' && m_pos + 1 < m_data.size() && hexValue(m_data[m_pos]) >= 0 &&
+                        hexValue(m_data[m_pos + 1]) >= 0) {
+                        name += static_cast<char>(hexValue(m_data[m_pos]) * 16 +
+                                                  hexValue(m_data[m_pos + 1]));
+                        m_pos += 2;
+                    } else {
+                        name += c;
+                    }
+                }
+                return name;
+            }
+
+            std::string readLiteralString() {
+                std::string out;
+                int nesting{1};
+
+                while (m_pos < m_data.size()) {
+                    const char c = m_data[m_pos++];
+                    if (c == '(') {
+                        ++nesting;
+                    } else if (c == ')') {
+                        if (--nesting == 0) { break; }
+                    } else if (c == '\\' && m_pos < m_data.size()) {
+                        const char e = m_data[m_pos++];
+                        switch (e) {
+                        case 'n': out += '\n'; continue;
+                        case 'r': out += '\r'; continue;
+                        case 't': out += '\t'; continue;
+                        case 'b': out += '\b'; continue;
+                        case 'f': out += '\f'; continue;
+                        case '\r':
+                            if (m_pos < m_data.size() && m_data[m_pos] == '\n') { ++m_pos; }
+                            continue;
+                        case '\n': continue;
+                        default: break;
+                        }
+
+                        if (e >= '0' && e <= '7') {
+                            int value = e - '0';
+                            for (int i = 0; i < 2 && m_pos < m_data.size() &&
+                                            m_data[m_pos] >= '0' && m_data[m_pos] <= '7';
+                                 ++i) {
+                                value = value * 8 + (m_data[m_pos++] - '0');
+                            }
+                            out += static_cast<char>(value & 0xFF);
+                        } else {
+                            out += e; // \( \) \\ và escape không hợp lệ
+                        }
+                        continue;
+                    }
+                    out += c;
+                }
+                return out;
+            }
+
+            std::string readHexString() {
+                std::string out;
+                int high{-1};
+
+                while (m_pos < m_data.size()) {
+                    const char c = m_data[m_pos++];
+                    if (c == '>') { break; }
+
+                    const int v = hexValue(c);
+                    if (v < 0) { continue; }
+
+                    if (high < 0) {
+                        high = v;
+                    } else {
+                        out += static_cast<char>(high * 16 + v);
+                        high = -1;
+                    }
+                }
+                if (high >= 0) { out += static_cast<char>(high * 16); }
+                return out;
+            }
+
+            Object readArray(int depth) {
+                auto array = std::make_shared<Array>();
+                for (;;) {
+                    skipSpace();
+                    if (atEnd()) { break; }
+                    if (m_data[m_pos] == ']') {
+                        ++m_pos;
+                        break;
+                    }
+                    array->push_back(parseObject(depth + 1));
+                }
+                return Object{std::shared_ptr<const Array>(std::move(array))};
+            }
+
+            Object readDict(int depth) {
+                auto dict = std::make_shared<Dict>();
+                for (;;) {
+                    skipSpace();
+                    if (atEnd()) { break; }
+                    if (m_data[m_pos] == '>') {
+                        m_pos += (m_pos + 1 < m_data.size() && m_data[m_pos + 1] == '>') ? 2 : 1;
+                        break;
+                    }
+                    if (m_data[m_pos] != '/') {
+                        parseObject(depth + 1); // khóa không hợp lệ: bỏ qua
+                        continue;
+                    }
+
+                    ++m_pos;
+                    auto key = readName();
+                    auto value = parseObject(depth + 1);
+                    dict->entries.emplace_back(std::move(key), std::move(value));
+                }
+                return Object{std::shared_ptr<const Dict>(std::move(dict))};
+            }
+
+            static std::optional<double> toNumber(std::string_view token) {
+                if (!token.empty() && token[0] == '+') { token.remove_prefix(1); }
+
+                double value{};
+                const auto [ptr, ec] =
+                    std::from_chars(token.data(), token.data() + token.size(), value);
+                if (ec != std::errc{} || ptr == token.data()) { return std::nullopt; }
+                return value;
+            }
+
+            Object readNumberOrRef() {
+                const auto first = readRegular();
+                const auto value = toNumber(first);
+                if (!value.has_value()) { return kNull; }
+
+                // "num gen R" -> tham chiếu gián tiếp
+                const bool isInteger = first.find('.') == std::string::npos && first[0] != '-';
+                if (m_allowRefs && isInteger) {
+                    const auto saved = m_pos;
+                    skipSpace();
+
+                    const auto genStart = m_pos;
+                    while (m_pos < m_data.size() && isDigit(m_data[m_pos])) { ++m_pos; }
+
+                    if (m_pos > genStart) {
+                        const auto gen = toNumber(m_data.substr(genStart, m_pos - genStart));
+                        skipSpace();
+                        if (m_pos < m_data.size() && m_data[m_pos] == 'R' &&
+                            (m_pos + 1 >= m_data.size() || !isRegular(m_data[m_pos + 1]))) {
+                            ++m_pos;
+                            return Object{Ref{static_cast<int>(*value), static_cast<int>(*gen)}};
+                        }
+                    }
+                    m_pos = saved;
+                }
+
+                return Object{*value};
+            }
+
+            std::string_view m_data;
+            std::size_t m_pos;
+            bool m_allowRefs;
+    };
+
+    // ------------------------------------------------------------
+    // Filters
+    // ------------------------------------------------------------
+    struct UnsupportedFilter : std::runtime_error {
+            using std::runtime_error::runtime_error;
+    };
+
+    // Stream hỏng rất phổ biến: trả về phần đã giải nén được thay vì ném lỗi
+    std::string inflateData(std::string_view input, bool raw) {
+        z_stream zs{};
+        if (inflateInit2(&zs, raw ? -MAX_WBITS : MAX_WBITS) != Z_OK) {
+            throw std::runtime_error("inflateInit2 failed");
+        }
+
+        std::string out;
+        std::array<char, 16 * 1024> buffer{};
+
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        zs.avail_in = static_cast<uInt>(input.size());
+
+        int rc = Z_OK;
+        while (rc == Z_OK) {
+            zs.next_out = reinterpret_cast<Bytef*>(buffer.data());
+            zs.avail_out = static_cast<uInt>(buffer.size());
+
+            rc = inflate(&zs, Z_NO_FLUSH);
+            out.append(buffer.data(), buffer.size() - zs.avail_out);
+
+            if (out.size() > kMaxDecodedStream) {
+                inflateEnd(&zs);
+                throw std::runtime_error("PDF stream too large");
+            }
+            if (rc == Z_BUF_ERROR && zs.avail_in == 0) { break; } // thiếu dữ liệu cuối
+        }
+
+        const bool headerError = rc == Z_DATA_ERROR && out.empty() && !raw;
+        inflateEnd(&zs);
+
+        // Một số file ghi deflate thô không có header zlib
+        if (headerError) { return inflateData(input, true); }
+        return out;
+    }
+
+    std::string applyPngPredictor(const std::string &data, int colors, int bitsPerComponent,
+                                  int columns) {
+        const int bpp = std::max(1, colors * bitsPerComponent / 8);
+        const auto rowLength =
+            static_cast<std::size_t>((colors * bitsPerComponent * columns + 7) / 8);
+        if (rowLength == 0) { return data; }
+
+        std::string out;
+        std::vector<unsigned char> previous(rowLength, 0);
+        std::vector<unsigned char> row(rowLength);
+
+        for (std::size_t pos = 0; pos + 1 + rowLength <= data.size(); pos += rowLength + 1) {
+            const auto type = static_cast<unsigned char>(data[pos]);
+            for (std::size_t i = 0; i < rowLength; ++i) {
+                const auto raw = static_cast<unsigned char>(data[pos + 1 + i]);
+                const int left = i >= static_cast<std::size_t>(bpp) ? row[i - bpp] : 0;
+                const int up = previous[i];
+                const int upLeft = i >= static_cast<std::size_t>(bpp) ? previous[i - bpp] : 0;
+
+                int predicted{0};
+                switch (type) {
+                case 1: predicted = left; break;
+                case 2: predicted = up; break;
+                case 3: predicted = (left + up) / 2; break;
+                case 4: {
+                    const int p = left + up - upLeft;
+                    const int pa = std::abs(p - left);
+                    const int pb = std::abs(p - up);
+                    const int pc = std::abs(p - upLeft);
+                    predicted = (pa <= pb && pa <= pc) ? left : (pb <= pc ? up : upLeft);
+                    break;
+                }
+                default: break;
+                }
+                row[i] = static_cast<unsigned char>(raw + predicted);
+            }
+            out.append(reinterpret_cast<const char*>(row.data()), row.size());
+            previous = row;
+        }
+        return out;
+    }
+
+    std::string decodeAsciiHex(std::string_view input) {
+        std::string out;
+        int high{-1};
+        for (const char c : input) {
+            if (c == '>') { break; }
+            const int v = hexValue(c);
+            if (v < 0) { continue; }
+            if (high < 0) {
+                high = v;
+            } else {
+                out += static_cast<char>(high * 16 + v);
+                high = -1;
+            }
+        }
+        if (high >= 0) { out += static_cast<char>(high * 16); }
+        return out;
+    }
+
+    std::string decodeAscii85(std::string_view input) {
+        std::string out;
+        std::uint32_t tuple{0};
+        int count{0};
+
+        auto flush = [&](int bytes) {
+            for (int i = 0; i < bytes; ++i) {
+                out += static_cast<char>((tuple >> (24 - 8 * i)) & 0xFFU);
+            }
+        };
+
+        for (std::size_t i = 0; i < input.size(); ++i) {
+            const char c = input[i];
+            if (c == '~') { break; }
+            if (isSpace(c)) { continue; }
+            if (c == 'z' && count == 0) {
+                out.append(4, '\0');
+                continue;
+            }
+            if (c < '!' || c > 'u') { continue; }
+
+            tuple = tuple * 85 + static_cast<std::uint32_t>(c - '!');
+            if (++count == 5) {
+                flush(4);
+                tuple = 0;
+                count = 0;
+            }
+        }
+
+        if (count > 1) {
+            for (int i = count; i < 5; ++i) { tuple = tuple * 85 + 84; }
+            flush(count - 1);
+        }
+        return out;
+    }
+
+    // ------------------------------------------------------------
+    // Mã hóa ký tự
+    // ------------------------------------------------------------
+    void appendUtf8(std::string &out, std::uint32_t cp) {
+        if (cp == 0 || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) { return; }
+
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6U));
+            out += static_cast<char>(0x80 | (cp & 0x3FU));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12U));
+            out += static_cast<char>(0x80 | ((cp >> 6U) & 0x3FU));
+            out += static_cast<char>(0x80 | (cp & 0x3FU));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18U));
+            out += static_cast<char>(0x80 | ((cp >> 12U) & 0x3FU));
+            out += static_cast<char>(0x80 | ((cp >> 6U) & 0x3FU));
+            out += static_cast<char>(0x80 | (cp & 0x3FU));
+        }
+    }
+
+    std::string utf16BeToUtf8(std::string_view bytes) {
+        std::string out;
+        for (std::size_t i = 0; i + 1 < bytes.size(); i += 2) {
+            std::uint32_t unit = (static_cast<unsigned char>(bytes[i]) << 8U) |
+                                 static_cast<unsigned char>(bytes[i + 1]);
+
+            if (unit >= 0xD800 && unit <= 0xDBFF && i + 3 < bytes.size()) {
+                const std::uint32_t low = (static_cast<unsigned char>(bytes[i + 2]) << 8U) |
+                                          static_cast<unsigned char>(bytes[i + 3]);
+                if (low >= 0xDC00 && low <= 0xDFFF) {
+                    unit = 0x10000 + ((unit - 0xD800) << 10U) + (low - 0xDC00);
+                    i += 2;
+                }
+            }
+            appendUtf8(out, unit);
+        }
+        return out;
+    }
+
+    std::uint32_t bytesToCode(std::string_view bytes) {
+        std::uint32_t code{0};
+        for (const char b : bytes.substr(0, 4)) {
+            code = (code << 8U) | static_cast<unsigned char>(b);
+        }
+        return code;
+    }
+
+    // Byte 0x80..0x9F của WinAnsiEncoding (0 = không dùng)
+    constexpr std::array<std::uint16_t, 32> kWinAnsiHigh{
+        0x20AC, 0,      0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160,
+        0x2039, 0x0152, 0,      0x017D, 0,      0,      0x2018, 0x2019, 0x201C, 0x201D, 0x2022,
+        0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0,      0x017E, 0x0178};
+
+    // Tên glyph hay gặp trong /Differences (không cần cả Adobe Glyph List)
+    std::optional<std::uint32_t> glyphNameToCodePoint(std::string_view name) {
+        static const std::unordered_map<std::string_view, std::uint32_t> kNames{
+            {"space", ' '},          {"exclam", '!'},       {"quotedbl", '"'},
+            {"numbersign", '#'},     {"dollar", '$'},       {"percent", '%'},
+            {"ampersand", '&'},      {"quotesingle", '\''}, {"parenleft", '('},
+            {"parenright", ')'},     {"asterisk", '*'},     {"plus", '+'},
+            {"comma", ','},          {"hyphen", '-'},       {"period", '.'},
+            {"slash", '/'},          {"zero", '0'},         {"one", '1'},
+            {"two", '2'},            {"three", '3'},        {"four", '4'},
+            {"five", '5'},           {"six", '6'},          {"seven", '7'},
+            {"eight", '8'},          {"nine", '9'},         {"colon", ':'},
+            {"semicolon", ';'},      {"less", '<'},         {"equal", '='},
+            {"greater", '>'},        {"question", '?'},     {"at", '@'},
+            {"bracketleft", '['},    {"backslash", '\\'},   {"bracketright", ']'},
+            {"underscore", '_'},     {"braceleft", '{'},    {"bar", '|'},
+            {"braceright", '}'},     {"quoteleft", 0x2018}, {"quoteright", 0x2019},
+            {"quotedblleft", 0x201C}, {"quotedblright", 0x201D}, {"endash", 0x2013},
+            {"emdash", 0x2014},      {"bullet", 0x2022},    {"ellipsis", 0x2026},
+            {"fi", 0xFB01},          {"fl", 0xFB02},        {"ff", 0xFB00},
+            {"ffi", 0xFB03},         {"ffl", 0xFB04},       {"minus", 0x2212}};
+
+        if (name.size() == 1 && isRegular(name[0])) {
+            return static_cast<unsigned char>(name[0]);
+        }
+
+        if (const auto it = kNames.find(name); it != kNames.end()) { return it->second; }
+
+        // uniXXXX / uXXXX[XX]
+        std::string_view hex;
+        if (name.starts_with("uni") && name.size() == 7) {
+            hex = name.substr(3);
+        } else if (name.starts_with('u') && name.size() >= 5 && name.size() <= 7) {
+            hex = name.substr(1);
+        }
+        if (!hex.empty()) {
+            std::uint32_t cp{};
+            const auto [ptr, ec] = std::from_chars(hex.data(), hex.data() + hex.size(), cp, 16);
+            if (ec == std::errc{} && ptr == hex.data() + hex.size()) { return cp; }
+        }
+
+        return std::nullopt;
+    }
+
+    struct Font {
+            struct CodeRange {
+                    std::size_t bytes{};
+                    std::uint32_t low{};
+                    std::uint32_t high{};
+            };
+
+            bool composite{};       // Type0: mã nhiều byte theo CMap
+            bool codesAreUnicode{}; // CMap dạng Uni*-UCS2/UTF16: mã chính là UTF-16
+            std::vector<CodeRange> codespace;
+            std::unordered_map<std::uint32_t, std::string> toUnicode;
+            std::array<std::string, 256> simple; // font đơn byte không có ToUnicode
+
+            [[nodiscard]] std::size_t codeLength(std::string_view bytes) const {
+                for (const auto &range : codespace) {
+                    if (range.bytes > bytes.size()) { continue; }
+                    const auto code = bytesToCode(bytes.substr(0, range.bytes));
+                    if (code >= range.low && code <= range.high) { return range.bytes; }
+                }
+                if (!codespace.empty()) { return std::min(codespace.front().bytes, bytes.size()); }
+                return composite ? std::min<std::size_t>(2, bytes.size()) : 1;
+            }
+
+            void decode(std::string_view bytes, std::string &out) const {
+                while (!bytes.empty()) {
+                    const auto length = std::max<std::size_t>(1, codeLength(bytes));
+                    const auto codeBytes = bytes.substr(0, length);
+                    bytes.remove_prefix(length);
+
+                    const auto code = bytesToCode(codeBytes);
+                    if (const auto it = toUnicode.find(code); it != toUnicode.end()) {
+                        out += it->second;
+                    } else if (codesAreUnicode) {
+                        out += utf16BeToUtf8(codeBytes);
+                    } else if (!composite) {
+                        out += simple[code & 0xFFU];
+                    }
+                }
+            }
+    };
+
+    Font makeDefaultSimpleFont() {
+        Font font;
+        for (std::uint32_t b = 0x20; b < 0x7F; ++b) { appendUtf8(font.simple[b], b); }
+        for (std::uint32_t b = 0x80; b < 0xA0; ++b) {
+            appendUtf8(font.simple[b], kWinAnsiHigh[b - 0x80]);
+        }
+        for (std::uint32_t b = 0xA0; b <= 0xFF; ++b) { appendUtf8(font.simple[b], b); }
+        font.simple['\t'] = " ";
+        return font;
+    }
+} // namespace
+
+// ------------------------------------------------------------
+// Document
+// ------------------------------------------------------------
+struct PdfTextExtractor::Document {
+        struct Page {
+                std::shared_ptr<const Dict> dict;
+                Object resources; // đã tính kế thừa từ node Pages cha
+        };
+
+        std::string data;
+        std::unordered_map<int, Object> objects;
+        std::vector<Page> pages;
+        std::unordered_map<const Dict*, std::shared_ptr<const Font>> fonts;
+
+        explicit Document(const std::filesystem::path &path) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in.is_open()) { throw std::runtime_error("Cannot open PDF: " + path.string()); }
+
+            data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            if (data.find("%PDF-") > 1024) {
+                throw std::runtime_error("Not a PDF file: " + path.string());
+            }
+
+            indexObjects();
+            expandObjectStreams();
+
+            // String và stream của PDF mã hóa đều đã bị mã hóa: trích ra chỉ được rác
+            if (isEncrypted()) {
+                throw std::runtime_error("Encrypted PDF: text extraction is not supported");
+            }
+
+            std::unordered_set<const Dict*> visited;
+            collectPages(findRoot(), kNull, 0, visited);
+        }
+
+        const Object &resolve(const Object &obj) const {
+            const Object* current = &obj;
+            for (int depth = 0; depth < kMaxResolveDepth; ++depth) {
+                const auto* ref = current->as<Ref>();
+                if (ref == nullptr) { return *current; }
+
+                const auto it = objects.find(ref->num);
+                if (it == objects.end()) { return kNull; }
+                current = &it->second;
+            }
+            return kNull;
+        }
+
+        const Object &resolve(const Object* obj) const {
+            return obj == nullptr ? kNull : resolve(*obj);
+        }
+
+        std::shared_ptr<const Dict> dictOf(const Object* obj) const {
+            const auto &value = resolve(obj);
+            if (const auto* dict = value.as<std::shared_ptr<const Dict>>()) { return *dict; }
+            if (const auto* stream = value.as<Stream>()) { return stream->dict; }
+            return nullptr;
+        }
+
+        std::shared_ptr<const Array> arrayOf(const Object* obj) const {
+            const auto* array = resolve(obj).as<std::shared_ptr<const Array>>();
+            return array != nullptr ? *array : nullptr;
+        }
+
+        // Quét toàn bộ file tìm "num gen obj": không phụ thuộc bảng xref (hay hỏng),
+        // object xuất hiện sau (incremental update) ghi đè object trước
+        void indexObjects() {
+            std::size_t pos{0};
+            while ((pos = data.find("obj", pos)) != std::string::npos) {
+                const auto keyword = pos;
+                pos += 3;
+                if (pos < data.size() && isRegular(data[pos])) { continue; }
+
+                std::size_t p = keyword;
+                while (p > 0 && isSpace(data[p - 1])) { --p; }
+                const auto genEnd = p;
+                while (p > 0 && isDigit(data[p - 1])) { --p; }
+                if (p == genEnd) { continue; }
+
+                const auto spaceEnd = p;
+                while (p > 0 && isSpace(data[p - 1])) { --p; }
+                if (p == spaceEnd) { continue; }
+
+                const auto numEnd = p;
+                while (p > 0 && isDigit(data[p - 1])) { --p; }
+                if (p == numEnd || (p > 0 && isRegular(data[p - 1]))) { continue; }
+
+                int num{};
+                std::from_chars(data.data() + p, data.data() + numEnd, num);
+
+                Lexer lexer(data, pos, true);
+                Object obj = lexer.parseObject(0);
+                pos = lexer.pos();
+
+                if (lexer.consumeKeyword("stream")) {
+                    if (const auto* dict = obj.as<std::shared_ptr<const Dict>>()) {
+                        obj = Object{readStream(*dict, lexer.pos(), pos)};
+                    }
+                }
+
+                objects[num] = std::move(obj);
+            }
+        }
+
+        // Dữ liệu stream bắt đầu sau EOL của "stream"; /Length có thể sai hoặc là ref chưa đọc
+        Stream readStream(const std::shared_ptr<const Dict> &dict, std::size_t afterKeyword,
+                          std::size_t &nextPos) {
+            std::size_t offset = afterKeyword;
+            if (offset < data.size() && data[offset] == '\r') { ++offset; }
+            if (offset < data.size() && data[offset] == '\n') { ++offset; }
+
+            std::optional<std::size_t> length;
+            if (const auto n = numberOf(&resolve(dict->find("Length"))); n.has_value() && *n >= 0) {
+                length = static_cast<std::size_t>(*n);
+            }
+
+            if (length.has_value() && *length <= data.size() - offset) {
+                Lexer check(data, offset + *length, false);
+                if (check.consumeKeyword("endstream")) {
+                    nextPos = check.pos();
+                    return Stream{dict, offset, *length};
+                }
+            }
+
+            auto end = data.find("endstream", offset);
+            if (end == std::string::npos) { end = data.size(); }
+            nextPos = std::min(data.size(), end + 9);
+
+            std::size_t trimmed = end;
+            if (trimmed > offset && data[trimmed - 1] == '\n') { --trimmed; }
+            if (trimmed > offset && data[trimmed - 1] == '\r') { --trimmed; }
+            return Stream{dict, offset, trimmed - offset};
+        }
+
+        void expandObjectStreams() {
+            std::vector<Stream> objectStreams;
+            for (const auto &[num, obj] : objects) {
+                const auto* stream = obj.as<Stream>();
+                if (stream != nullptr && nameOf(stream->dict->find("Type")) == "ObjStm") {
+                    objectStreams.push_back(*stream);
+                }
+            }
+
+            for (const auto &stream : objectStreams) {
+                std::string decoded;
+                try {
+                    decoded = decodeStream(stream);
+                } catch (const std::exception &) {
+                    continue; // object stream hỏng: các object trong đó coi như không có
+                }
+
+                const auto count = numberOf(&resolve(stream.dict->find("N"))).value_or(0);
+                const auto first = numberOf(&resolve(stream.dict->find("First"))).value_or(0);
+                if (count <= 0 || first < 0) { continue; }
+
+                Lexer header(decoded, 0, false);
+                for (int i = 0; i < static_cast<int>(count); ++i) {
+                    const auto numObj = header.parseObject(0);
+                    const auto offsetObj = header.parseObject(0);
+                    const auto num = numberOf(&numObj);
+                    const auto offset = numberOf(&offsetObj);
+                    if (!num.has_value() || !offset.has_value()) { break; }
+
+                    const auto at = static_cast<std::size_t>(first + *offset);
+                    if (at >= decoded.size()) { continue; }
+
+                    // Object trực tiếp trong file (thường là bản cập nhật sau) được ưu tiên
+                    Lexer lexer(decoded, at, true);
+                    objects.try_emplace(static_cast<int>(*num), lexer.parseObject(0));
+                }
+            }
+        }
+
+        Object findRoot() const {
+            // trailer cuối cùng (file kiểu cũ)
+            if (const auto trailer = data.rfind("trailer"); trailer != std::string::npos) {
+                Lexer lexer(data, trailer + 7, true);
+                const auto dict = lexer.parseObject(0);
+                if (const auto* d = dict.as<std::shared_ptr<const Dict>>()) {
+                    if (const auto* root = (*d)->find("Root"); root != nullptr && hasPages(*root)) {
+                        return *root;
+                    }
+                }
+            }
+
+            // xref stream (PDF 1.5+): lấy cái nằm sau cùng trong file
+            const Object* best{nullptr};
+            std::size_t bestOffset{0};
+            for (const auto &[num, obj] : objects) {
+                const auto* stream = obj.as<Stream>();
+                if (stream == nullptr || nameOf(stream->dict->find("Type")) != "XRef") { continue; }
+
+                const auto* root = stream->dict->find("Root");
+                if (root != nullptr && hasPages(*root) && stream->offset >= bestOffset) {
+                    best = root;
+                    bestOffset = stream->offset;
+                }
+            }
+            if (best != nullptr) { return *best; }
+
+            // Cuối cùng: bất kỳ Catalog nào
+            for (const auto &[num, obj] : objects) {
+                const auto* dict = obj.as<std::shared_ptr<const Dict>>();
+                if (dict != nullptr && nameOf((*dict)->find("Type")) == "Catalog") { return obj; }
+            }
+
+            throw std::runtime_error("PDF catalog not found");
+        }
+
+        // /Encrypt nằm trong trailer cuối (file kiểu cũ) hoặc dict của xref stream (PDF 1.5+)
+        bool isEncrypted() const {
+            if (const auto trailer = data.rfind("trailer"); trailer != std::string::npos) {
+                Lexer lexer(data, trailer + 7, true);
+                const auto dict = lexer.parseObject(0);
+                if (const auto* d = dict.as<std::shared_ptr<const Dict>>();
+                    d != nullptr && (*d)->find("Encrypt") != nullptr) {
+                    return true;
+                }
+            }
+
+            return std::ranges::any_of(objects, [](const auto &entry) {
+                const auto* stream = entry.second.template as<Stream>();
+                return stream != nullptr && nameOf(stream->dict->find("Type")) == "XRef" &&
+                       stream->dict->find("Encrypt") != nullptr;
+            });
+        }
+
+        bool hasPages(const Object &root) const {
+            const auto dict = dictOf(&root);
+            return dict != nullptr && dict->find("Pages") != nullptr;
+        }
+
+        void collectPages(const Object &node, const Object &inheritedResources, int depth,
+                          std::unordered_set<const Dict*> &visited) {
+            const auto catalog = dictOf(&node);
+            if (catalog == nullptr) { return; }
+
+            // Gọi lần đầu với Catalog
+            if (depth == 0 && catalog->find("Pages") != nullptr) {
+                collectPages(*catalog->find("Pages"), inheritedResources, 1, visited);
+                return;
+            }
+
+            if (depth > kMaxNesting || !visited.insert(catalog.get()).second) { return; }
+
+            const auto* ownResources = catalog->find("Resources");
+            const Object &resources =
+                ownResources != nullptr ? resolve(*ownResources) : inheritedResources;
+
+            const auto type = nameOf(&resolve(catalog->find("Type")));
+            const auto kids = arrayOf(catalog->find("Kids"));
+
+            if (type != "Page" && kids != nullptr) {
+                for (const auto &kid : *kids) { collectPages(kid, resources, depth + 1, visited); }
+            } else if (type == "Page" || catalog->find("Contents") != nullptr) {
+                pages.push_back(Page{catalog, resources});
+            }
+        }
+
+        std::string decodeStream(const Stream &stream) const {
+            std::string result = data.substr(stream.offset, stream.length);
+
+            std::vector<const Object*> filters;
+            const auto &filter = resolve(stream.dict->find("Filter"));
+            if (filter.as<Name>() != nullptr) {
+                filters.push_back(&filter);
+            } else if (const auto array = arrayOf(&filter)) {
+                for (const auto &f : *array) { filters.push_back(&f); }
+            }
+
+            const auto &parms = resolve(stream.dict->find("DecodeParms"));
+            const auto parmsArray = arrayOf(&parms);
+
+            for (std::size_t i = 0; i < filters.size(); ++i) {
+                const auto name = nameOf(&resolve(*filters[i]));
+
+                std::shared_ptr<const Dict> params;
+                if (parmsArray != nullptr) {
+                    if (i < parmsArray->size()) { params = dictOf(&(*parmsArray)[i]); }
+                } else {
+                    params = dictOf(&parms);
+                }
+
+                if (name == "FlateDecode" || name == "Fl") {
+                    result = inflateData(result, false);
+
+                    const auto predictor =
+                        params ? numberOf(&resolve(params->find("Predictor"))).value_or(1) : 1;
+                    if (predictor >= 10) {
+                        const auto colors = numberOf(&resolve(params->find("Colors"))).value_or(1);
+                        const auto bits =
+                            numberOf(&resolve(params->find("BitsPerComponent"))).value_or(8);
+                        const auto columns =
+                            numberOf(&resolve(params->find("Columns"))).value_or(1);
+                        result = applyPngPredictor(result, static_cast<int>(colors),
+                                                   static_cast<int>(bits),
+                                                   static_cast<int>(columns));
+                    }
+                } else if (name == "ASCIIHexDecode" || name == "AHx") {
+                    result = decodeAsciiHex(result);
+                } else if (name == "ASCII85Decode" || name == "A85") {
+                    result = decodeAscii85(result);
+                } else {
+                    // LZW, DCT (ảnh), JBIG2, ... không chứa text hoặc hiếm gặp
+                    throw UnsupportedFilter("Unsupported PDF filter: " + std::string(name));
+                }
+            }
+
+            return result;
+        }
+
+        std::shared_ptr<const Font> loadFont(const Object &resources, std::string_view name) {
+            const auto resourceDict = dictOf(&resources);
+            if (resourceDict == nullptr) { return nullptr; }
+
+            const auto fontDict = dictOf(resourceDict->find("Font"));
+            if (fontDict == nullptr) { return nullptr; }
+
+            const auto font = dictOf(fontDict->find(name));
+            if (font == nullptr) { return nullptr; }
+
+            if (const auto it = fonts.find(font.get()); it != fonts.end()) { return it->second; }
+
+            auto parsed = std::make_shared<Font>(makeDefaultSimpleFont());
+            parseFont(*font, *parsed);
+
+            fonts.emplace(font.get(), parsed);
+            return parsed;
+        }
+
+        void parseFont(const Dict &font, Font &out) const {
+            out.composite = nameOf(&resolve(font.find("Subtype"))) == "Type0";
+
+            const auto &encoding = resolve(font.find("Encoding"));
+            if (out.composite) {
+                const auto cmapName = nameOf(&encoding);
+                out.codesAreUnicode = cmapName.starts_with("Uni") &&
+                                      (cmapName.find("UCS2") != std::string_view::npos ||
+                                       cmapName.find("UTF16") != std::string_view::npos);
+            } else if (const auto encodingDict = dictOf(&encoding)) {
+                applyDifferences(*encodingDict, out);
+            }
+
+            if (const auto* toUnicode = resolve(font.find("ToUnicode")).as<Stream>()) {
+                try {
+                    parseCMap(decodeStream(*toUnicode), out);
+                } catch (const std::exception &) {
+                    // CMap hỏng: dùng bảng mặc định
+                }
+            }
+        }
+
+        void applyDifferences(const Dict &encoding, Font &out) const {
+            const auto differences = arrayOf(encoding.find("Differences"));
+            if (differences == nullptr) { return; }
+
+            int code{-1};
+            for (const auto &item : *differences) {
+                if (const auto n = numberOf(&item)) {
+                    code = static_cast<int>(*n);
+                    continue;
+                }
+
+                const auto glyph = nameOf(&item);
+                if (glyph.empty() || code < 0 || code > 0xFF) { continue; }
+
+                if (const auto cp = glyphNameToCodePoint(glyph)) {
+                    out.simple[code].clear();
+                    appendUtf8(out.simple[code], *cp);
+                }
+                ++code;
+            }
+        }
+
+        static void parseCMap(const std::string &cmap, Font &out) {
+            Lexer lexer(cmap, 0, false);
+            std::vector<Object> operands;
+            Object obj;
+            std::string keyword;
+
+            auto stringAt = [&](std::size_t i) -> std::string_view {
+                const auto* s = operands[i].as<std::string>();
+                return s != nullptr ? std::string_view(*s) : std::string_view{};
+            };
+
+            while (lexer.next(obj, keyword)) {
+                if (keyword.empty()) {
+                    if (operands.size() < kMaxOperands) { operands.push_back(std::move(obj)); }
+                    continue;
+                }
+
+                if (keyword == "endcodespacerange") {
+                    for (std::size_t i = 0; i + 1 < operands.size(); i += 2) {
+                        const auto low = stringAt(i);
+                        const auto high = stringAt(i + 1);
+                        if (low.empty() || low.size() > 4) { continue; }
+                        out.codespace.push_back(
+                            {low.size(), bytesToCode(low), bytesToCode(high)});
+                    }
+                } else if (keyword == "endbfchar") {
+                    for (std::size_t i = 0; i + 1 < operands.size(); i += 2) {
+                        const auto src = stringAt(i);
+                        if (src.empty()) { continue; }
+                        out.toUnicode[bytesToCode(src)] = utf16BeToUtf8(stringAt(i + 1));
+                    }
+                } else if (keyword == "endbfrange") {
+                    for (std::size_t i = 0; i + 2 < operands.size(); i += 3) {
+                        const auto low = bytesToCode(stringAt(i));
+                        const auto high = bytesToCode(stringAt(i + 1));
+                        if (stringAt(i).empty() || high < low || high - low >= kMaxBfRange) {
+                            continue;
+                        }
+
+                        if (const auto* dst = operands[i + 2].as<std::string>()) {
+                            // Tăng code unit cuối của đích theo khoảng cách tới low
+                            for (std::uint32_t step = 0; step <= high - low; ++step) {
+                                std::string target = *dst;
+                                if (target.size() >= 2) {
+                                    auto &lead = target[target.size() - 2];
+                                    auto last = (static_cast<unsigned char>(lead) << 8U) |
+                                                static_cast<unsigned char>(target.back());
+                                    last += step;
+                                    lead = static_cast<char>((last >> 8U) & 0xFFU);
+                                    target.back() = static_cast<char>(last & 0xFFU);
+                                }
+                                out.toUnicode[low + step] = utf16BeToUtf8(target);
+                            }
+                        } else if (const auto* list =
+                                       operands[i + 2].as<std::shared_ptr<const Array>>()) {
+                            const auto count =
+                                std::min<std::size_t>((*list)->size(), high - low + 1);
+                            for (std::size_t step = 0; step < count; ++step) {
+                                if (const auto* s = (**list)[step].as<std::string>()) {
+                                    out.toUnicode[low + static_cast<std::uint32_t>(step)] =
+                                        utf16BeToUtf8(*s);
+                                }
+                            }
+                        }
+                    }
+                }
+
+                operands.clear();
+            }
+        }
+
+        std::string pageContent(const Page &page) const {
+            std::string content;
+
+            auto append = [&](const Object &obj) {
+                const auto* stream = resolve(obj).as<Stream>();
+                if (stream == nullptr) { return; }
+                try {
+                    content += decodeStream(*stream);
+                    content += '\n';
+                } catch (const UnsupportedFilter &) {
+                    // bỏ qua stream không đọc được, các stream khác của trang vẫn dùng được
+                }
+            };
+
+            const auto* contents = page.dict->find("Contents");
+            if (const auto array = arrayOf(contents)) {
+                for (const auto &part : *array) { append(part); }
+            } else if (contents != nullptr) {
+                append(*contents);
+            }
+            return content;
+        }
+
+        class TextCollector;
+};
+
+// Chạy content stream, chỉ quan tâm các toán tử text + XObject form
+class PdfTextExtractor::Document::TextCollector {
+    public:
+        TextCollector(Document &doc, std::string &out) : m_doc(doc), m_out(out) {}
+
+        void run(const std::string &content, const Object &resources, int depth);
+
+    private:
+        void show(std::string_view bytes);
+        void space();
+        void newLine();
+        void moveTo(double y);
+        static void skipInlineImage(std::string_view content, Lexer &lexer);
+
+        Document &m_doc;
+        std::string &m_out;
+        std::shared_ptr<const Font> m_font;
+        std::optional<double> m_lineY;
+};
+
+void PdfTextExtractor::Document::TextCollector::run(const std::string &content,
+                                                  const Object &resources, int depth) {
+    Lexer lexer(content, 0, false);
+    std::vector<Object> operands;
+    Object obj;
+    std::string op;
+
+    auto number = [&](std::size_t i) -> double {
+        return i < operands.size() ? numberOf(&operands[i]).value_or(0.0) : 0.0;
+    };
+
+    while (m_out.size() < kMaxPageText && lexer.next(obj, op)) {
+        if (op.empty()) {
+            if (operands.size() < kMaxOperands) { operands.push_back(std::move(obj)); }
+            continue;
+        }
+
+        if (op == "Tf") {
+            if (!operands.empty()) {
+                m_font = m_doc.loadFont(resources, nameOf(&operands[0]));
+            }
+        } else if (op == "Tj" || op == "'" || op == "\"") {
+            if (op != "Tj") { newLine(); }
+            if (!operands.empty()) {
+                if (const auto* s = operands.back().as<std::string>()) { show(*s); }
+            }
+        } else if (op == "TJ") {
+            if (!operands.empty()) {
+                if (const auto* items = operands.back().as<std::shared_ptr<const Array>>()) {
+                    for (const auto &item : **items) {
+                        if (const auto* s = item.as<std::string>()) {
+                            show(*s);
+                        } else if (numberOf(&item).value_or(0.0) < kTjSpaceThreshold) {
+                            space();
+                        }
+                    }
+                }
+            }
+        } else if (op == "Td" || op == "TD") {
+            const double ty = number(1);
+            if (std::abs(ty) > 0.01) {
+                moveTo(m_lineY.value_or(0.0) + ty);
+            } else if (number(0) > 0.0) {
+                space();
+            }
+        } else if (op == "Tm") {
+            moveTo(number(5));
+        } else if (op == "T*") {
+            newLine();
+        } else if (op == "BT") {
+            m_lineY.reset();
+            space();
+        } else if (op == "Do" && depth < kMaxFormDepth && !operands.empty()) {
+            const auto resourceDict = m_doc.dictOf(&resources);
+            const auto xobjects =
+                resourceDict ? m_doc.dictOf(resourceDict->find("XObject")) : nullptr;
+            const auto* entry = xobjects ? xobjects->find(nameOf(&operands[0])) : nullptr;
+            const auto* form = m_doc.resolve(entry).as<Stream>();
+
+            if (form != nullptr && nameOf(form->dict->find("Subtype")) == "Form") {
+                try {
+                    const auto* formResources = form->dict->find("Resources");
+                    run(m_doc.decodeStream(*form),
+                        formResources ? m_doc.resolve(*formResources) : resources, depth + 1);
+                } catch (const std::runtime_error &) {
+                    // form không giải mã được: bỏ qua
+                }
+            }
+        } else if (op == "BI") {
+            skipInlineImage(content, lexer);
+        }
+
+        operands.clear();
+    }
+}
+
+void PdfTextExtractor::Document::TextCollector::show(std::string_view bytes) {
+    if (m_font) {
+        m_font->decode(bytes, m_out);
+    } else {
+        static const Font kFallback = makeDefaultSimpleFont();
+        kFallback.decode(bytes, m_out);
+    }
+}
+
+void PdfTextExtractor::Document::TextCollector::space() {
+    if (!m_out.empty() && m_out.back() != ' ' && m_out.back() != '\n') { m_out += ' '; }
+}
+
+void PdfTextExtractor::Document::TextCollector::newLine() {
+    while (!m_out.empty() && m_out.back() == ' ') { m_out.pop_back(); }
+    if (!m_out.empty() && m_out.back() != '\n') { m_out += '\n'; }
+}
+
+void PdfTextExtractor::Document::TextCollector::moveTo(double y) {
+    if (m_lineY.has_value() && std::abs(*m_lineY - y) > 0.5) {
+        newLine();
+    } else {
+        space();
+    }
+    m_lineY = y;
+}
+
+void PdfTextExtractor::Document::TextCollector::skipInlineImage(std::string_view content,
+                                                              Lexer &lexer) {
+    // BI <dict> ID <dữ liệu nhị phân> EI
+    Object obj;
+    std::string op;
+    while (lexer.next(obj, op)) {
+        if (op == "ID") { break; }
+    }
+
+    std::size_t pos = lexer.pos() + 1;
+    while ((pos = content.find("EI", pos)) != std::string_view::npos) {
+        const bool before = pos > 0 && isSpace(content[pos - 1]);
+        const bool after = pos + 2 >= content.size() || isSpace(content[pos + 2]);
+        if (before && after) { break; }
+        pos += 2;
+    }
+
+    Lexer rest(content, pos == std::string_view::npos ? content.size() : pos + 2, false);
+    lexer = rest;
+}
+
+// ------------------------------------------------------------
+// PdfTextExtractor
+// ------------------------------------------------------------
+PdfTextExtractor::PdfTextExtractor(const std::filesystem::path &path)
+    : m_doc(std::make_unique<Document>(path)) {}
+
+PdfTextExtractor::~PdfTextExtractor() = default;
+
+int PdfTextExtractor::pageCount() const noexcept {
+    return static_cast<int>(m_doc->pages.size());
+}
+
+int PdfTextExtractor::extractPages(const PageSink &sink, int maxPages) {
+    const int total = std::min(pageCount(), std::max(0, maxPages));
+
+    for (int i = 0; i < total; ++i) {
+        const auto &page = m_doc->pages[static_cast<std::size_t>(i)];
+
+        std::string text;
+        Document::TextCollector collector(*m_doc, text);
+        collector.run(m_doc->pageContent(page), page.resources, 0);
+
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\n')) { text.pop_back(); }
+        const auto start = text.find_first_not_of(" \n");
+        if (start != std::string::npos) { sink(i + 1, std::string_view(text).substr(start)); }
+    }
+
+    return total;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string_view>
+
+// Trích text layer của PDF (không render): object (kể cả object stream), cây trang,
+// content stream (FlateDecode/ASCIIHex/ASCII85) và font (ToUnicode, WinAnsi/Differences) ra UTF-8.
+// Chỉ dùng trong tiến trình notes-pdf-worker: PDF lạ có thể rất nặng hoặc làm parser hỏng,
+// nên tiến trình chính của app không bao giờ parse PDF.
+class PdfTextExtractor {
+    public:
+        using PageSink = std::function<void(int page, std::string_view text)>;
+
+        static constexpr int kAllPages{std::numeric_limits<int>::max()};
+
+        // Đọc file và dựng bảng object + danh sách trang; ném std::runtime_error nếu không phải PDF
+        explicit PdfTextExtractor(const std::filesystem::path &path);
+        ~PdfTextExtractor();
+
+        PdfTextExtractor(const PdfTextExtractor &) = delete;
+        PdfTextExtractor &operator=(const PdfTextExtractor &) = delete;
+
+        [[nodiscard]] int pageCount() const noexcept;
+
+        // Trích lần lượt từng trang (đánh số từ 1), dừng sau maxPages trang.
+        // Trang không có text vẫn được tính nhưng không gọi sink. Trả về số trang đã xử lý.
+        int extractPages(const PageSink &sink, int maxPages = kAllPages);
+
+    private:
+        struct Document;
+        std::unique_ptr<Document> m_doc;
+};
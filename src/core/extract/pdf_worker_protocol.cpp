@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "pdf_worker_protocol.hpp"
+
+namespace {
+    template <typename T>
+    bool parseNumber(std::string_view text, T &value) {
+        const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+        return ec == std::errc{} && ptr == text.data() + text.size();
+    }
+} // namespace
+
+std::string encodePdfPage(int page, std::string_view text) {
+    std::string frame = "page " + std::to_string(page) + " " + std::to_string(text.size()) + "\n";
+    frame += text;
+    return frame;
+}
+
+std::string encodePdfDone(int pages) {
+    return "done " + std::to_string(pages) + "\n";
+}
+
+std::string encodePdfError(std::string_view message) {
+    std::string frame = "error " + std::to_string(message.size()) + "\n";
+    frame += message;
+    return frame;
+}
+
+PdfWorkerDecoder::PdfWorkerDecoder(PageHandler onPage, DoneHandler onDone, ErrorHandler onError,
+                                   std::size_t maxFrameBytes)
+    : m_onPage(std::move(onPage)), m_onDone(std::move(onDone)), m_onError(std::move(onError)),
+      m_maxFrameBytes(maxFrameBytes) {}
+
+void PdfWorkerDecoder::feed(std::string_view data) {
+    while (!data.empty()) {
+        if (m_finished) { throw std::runtime_error("PDF worker wrote data after finishing"); }
+
+        if (m_inPayload) {
+            const auto take = std::min(data.size(), m_payloadBytes - m_buffer.size());
+            m_buffer.append(data.substr(0, take));
+            data.remove_prefix(take);
+
+            if (m_buffer.size() < m_payloadBytes) { return; }
+
+            m_inPayload = false;
+            if (m_frame == Frame::page) {
+                m_onPage(m_page, m_buffer);
+            } else {
+                m_finished = true;
+                m_onError(m_buffer);
+            }
+            m_buffer.clear();
+            continue;
+        }
+
+        const auto newline = data.find('\n');
+        const auto take = newline == std::string_view::npos ? data.size() : newline;
+        if (m_buffer.size() + take > kMaxHeaderBytes) {
+            throw std::runtime_error("Malformed PDF worker output");
+        }
+
+        m_buffer.append(data.substr(0, take));
+        data.remove_prefix(take);
+        if (newline == std::string_view::npos) { return; }
+
+        data.remove_prefix(1);
+        const auto header = std::move(m_buffer);
+        m_buffer.clear();
+        parseHeader(header);
+    }
+}
+
+void PdfWorkerDecoder::parseHeader(std::string_view header) {
+    const auto space = header.find(' ');
+    if (space == std::string_view::npos) {
+        throw std::runtime_error("Malformed PDF worker output");
+    }
+
+    const auto kind = header.substr(0, space);
+    const auto args = header.substr(space + 1);
+
+    if (kind == "done") {
+        int pages{};
+        if (!parseNumber(args, pages)) { throw std::runtime_error("Malformed PDF worker output"); }
+        m_finished = true;
+        m_onDone(pages);
+        return;
+    }
+
+    std::size_t bytes{};
+    if (kind == "page") {
+        const auto sep = args.find(' ');
+        if (sep == std::string_view::npos || !parseNumber(args.substr(0, sep), m_page) ||
+            !parseNumber(args.substr(sep + 1), bytes)) {
+            throw std::runtime_error("Malformed PDF worker output");
+        }
+        m_frame = Frame::page;
+    } else if (kind == "error") {
+        if (!parseNumber(args, bytes)) { throw std::runtime_error("Malformed PDF worker output"); }
+        m_frame = Frame::error;
+    } else {
+        throw std::runtime_error("Malformed PDF worker output");
+    }
+
+    if (bytes > m_maxFrameBytes) { throw std::runtime_error("PDF worker frame too large"); }
+
+    // Payload rỗng vẫn phải phát sự kiện ngay
+    m_payloadBytes = bytes;
+    m_inPayload = true;
+    if (bytes == 0) {
+        m_inPayload = false;
+        if (m_frame == Frame::page) {
+            m_onPage(m_page, {});
+        } else {
+            m_finished = true;
+            m_onError({});
+        }
+    }
+}
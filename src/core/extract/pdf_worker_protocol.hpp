@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+
+// Giao thức stdout của notes-pdf-worker, dạng khung có độ dài nên text chứa '\n' vẫn an toàn:
+//   page <số trang> <số byte>\n<text UTF-8>
+//   done <số trang đã xử lý>\n
+//   error <số byte>\n<thông báo>
+// Tiến trình chết giữa chừng thì không có done/error; bên đọc tự coi là lỗi.
+std::string encodePdfPage(int page, std::string_view text);
+std::string encodePdfDone(int pages);
+std::string encodePdfError(std::string_view message);
+
+// Giải mã tăng dần: dữ liệu từ pipe đến theo từng đoạn bất kỳ
+class PdfWorkerDecoder {
+    public:
+        using PageHandler = std::function<void(int page, std::string_view text)>;
+        using DoneHandler = std::function<void(int pages)>;
+        using ErrorHandler = std::function<void(std::string_view message)>;
+
+        static constexpr std::size_t kMaxHeaderBytes{64};
+        static constexpr std::size_t kDefaultMaxFrameBytes{8 * 1024 * 1024};
+
+        PdfWorkerDecoder(PageHandler onPage, DoneHandler onDone, ErrorHandler onError,
+                         std::size_t maxFrameBytes = kDefaultMaxFrameBytes);
+
+        // Ném std::runtime_error khi dữ liệu sai giao thức (worker hỏng hoặc ghi rác ra stdout)
+        void feed(std::string_view data);
+
+        // Đã nhận done hoặc error
+        [[nodiscard]] bool finished() const noexcept { return m_finished; }
+
+    private:
+        enum class Frame { page, error };
+
+        void parseHeader(std::string_view header);
+
+        PageHandler m_onPage;
+        DoneHandler m_onDone;
+        ErrorHandler m_onError;
+        std::size_t m_maxFrameBytes;
+
+        std::string m_buffer;   // header hoặc payload đang đọc dở
+        Frame m_frame{Frame::page};
+        int m_page{};
+        std::size_t m_payloadBytes{};
+        bool m_inPayload{};
+        bool m_finished{};
+};
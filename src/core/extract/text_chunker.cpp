@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "text_chunker.hpp"
+#include "model.hpp"
+
+namespace {
+    // Bảng gear cố định (splitmix64): đổi bảng làm đổi mọi điểm cắt
+    constexpr std::array<std::uint64_t, 256> kGear = [] {
+        std::array<std::uint64_t, 256> table{};
+        std::uint64_t state{0};
+        for (auto &value : table) {
+            state += 0x9E3779B97F4A7C15ULL;
+            std::uint64_t z = state;
+            z = (z ^ (z >> 30U)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27U)) * 0x94D049BB133111EBULL;
+            value = z ^ (z >> 31U);
+        }
+        return table;
+    }();
+
+    bool isUtf8Continuation(char c) noexcept {
+        return (static_cast<unsigned char>(c) & 0xC0U) == 0x80U;
+    }
+
+    // Vị trí cắt trong [limit/2, limit]: sau '\n' cuối cùng, nếu không có thì lùi về đầu ký tự UTF-8
+    // (buffer.size() > limit)
+    std::size_t findCut(std::string_view buffer, std::size_t limit) {
+        const auto window = buffer.substr(0, limit);
+        const auto newline = window.rfind('\n');
+        if (newline != std::string_view::npos && newline + 1 >= limit / 2) { return newline + 1; }
+
+        std::size_t cut = limit;
+        while (cut > 0 && isUtf8Continuation(buffer[cut])) { --cut; }
+
+        return cut == 0 ? limit : cut;
+    }
+} // namespace
+
+// ------------------------------------------------------------
+// TextChunker
+// ------------------------------------------------------------
+TextChunker::TextChunker(std::size_t chunkSize, ChunkSink sink)
+    : m_chunkSize(std::max(chunkSize, kMinChunkSize)), m_sink(std::move(sink)) {
+    m_pending.reserve(m_chunkSize * 2);
+}
+
+void TextChunker::push(std::string_view text) {
+    while (!text.empty()) {
+        // Nạp từng phần để buffer không vượt quá ~2 * chunkSize dù text đưa vào rất dài
+        const auto take = std::min(text.size(), m_chunkSize);
+        m_pending.append(text.substr(0, take));
+        text.remove_prefix(take);
+
+        // Cần thấy byte ngay sau giới hạn mới biết có đang cắt giữa ký tự UTF-8 hay không
+        while (m_pending.size() > m_chunkSize) {
+            const auto cut = findCut(m_pending, m_chunkSize);
+            m_sink(std::string_view(m_pending).substr(0, cut));
+            m_pending.erase(0, cut);
+            ++m_count;
+        }
+    }
+}
+
+std::size_t TextChunker::finish() {
+    if (!m_pending.empty()) {
+        m_sink(m_pending);
+        m_pending.clear();
+        ++m_count;
+    }
+    return m_count;
+}
+
+// ------------------------------------------------------------
+// ChunkCursor
+// ------------------------------------------------------------
+ChunkPosition ChunkCursor::advance(std::string_view chunk) noexcept {
+    const ChunkPosition current = m_next;
+
+    ++m_next.chunk_no;
+    m_next.byte_offset += static_cast<std::int64_t>(chunk.size());
+    m_next.line_no += static_cast<int>(std::ranges::count(chunk, '\n'));
+
+    return current;
+}
+
+// ------------------------------------------------------------
+// splitContentDefined
+// ------------------------------------------------------------
+std::vector<std::string_view> splitContentDefined(std::string_view text,
+                                                  const ContentChunkOptions &options) {
+    const std::size_t minSize = std::max<std::size_t>(options.minSize, 1);
+    const std::size_t maxSize = std::max(options.maxSize, minSize);
+
+    // Xét các bit cao của hash: bit thấp của gear hash chỉ phụ thuộc vài byte cuối
+    const auto target = std::bit_floor(std::max<std::size_t>(options.targetSize, 2));
+    const int shift = 64 - std::countr_zero(target);
+
+    std::vector<std::string_view> chunks;
+    std::uint64_t hash{0};
+    std::size_t start{0};
+    bool pending{false}; // hash đã khớp, chờ hết dòng
+
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        hash = (hash << 1U) + kGear[static_cast<unsigned char>(text[i])];
+
+        const std::size_t size = i + 1 - start;
+        if (!pending && size >= minSize && (hash >> shift) == 0) { pending = true; }
+
+        const bool boundary = i + 1 == text.size() || !isUtf8Continuation(text[i + 1]);
+        if ((pending && text[i] == '\n') || (size >= maxSize && boundary)) {
+            chunks.push_back(text.substr(start, size));
+            start = i + 1;
+            pending = false;
+        }
+    }
+
+    if (start < text.size()) { chunks.push_back(text.substr(start)); }
+
+    return chunks;
+}
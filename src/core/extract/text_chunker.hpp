@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "model.hpp"
+
+// Gom text đẩy vào từng đoạn bất kỳ thành chunk ~chunkSize byte:
+// ưu tiên cắt sau '\n', không cắt giữa một ký tự UTF-8. Buffer tối đa ~2 * chunkSize.
+class TextChunker {
+    public:
+        using ChunkSink = std::function<void(std::string_view)>;
+
+        static constexpr std::size_t kMinChunkSize{256};
+
+        TextChunker(std::size_t chunkSize, ChunkSink sink);
+
+        void push(std::string_view text);
+
+        // Xả phần còn lại, trả về tổng số chunk đã đẩy ra sink
+        std::size_t finish();
+
+    private:
+        std::size_t m_chunkSize;
+        ChunkSink m_sink;
+        std::string m_pending;
+        std::size_t m_count{};
+};
+
+// Theo dõi vị trí của các chunk liên tiếp trong text gốc (số thứ tự, byte offset, dòng)
+class ChunkCursor {
+    public:
+        ChunkCursor() = default;
+        explicit ChunkCursor(int firstChunkNo) noexcept { m_next.chunk_no = firstChunkNo; }
+
+        // Vị trí của chunk vừa nhận; chunk kế tiếp bắt đầu ngay sau nó
+        ChunkPosition advance(std::string_view chunk) noexcept;
+
+    private:
+        ChunkPosition m_next;
+};
+
+struct ContentChunkOptions {
+        std::size_t minSize{2 * 1024};
+        std::size_t targetSize{4 * 1024}; // khoảng trung bình tới điểm cắt sau minSize (lũy thừa 2)
+        std::size_t maxSize{32 * 1024};
+};
+
+// Content-defined chunking: điểm cắt do gear hash của ~64 byte gần nhất quyết định (cắt ở '\n'
+// đầu tiên sau khi hash khớp), không phụ thuộc vị trí tuyệt đối. Sửa một chỗ chỉ đổi các chunk
+// quanh chỗ sửa, phần còn lại cắt y như cũ nên so sánh được từng chunk với bản trước.
+// Không cắt giữa ký tự UTF-8; ghép các chunk trả về được đúng text ban đầu.
+std::vector<std::string_view> splitContentDefined(std::string_view text,
+                                                  const ContentChunkOptions &options = {});
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <zlib.h>
+#include "zip_archive.hpp"
+
+namespace {
+    constexpr std::uint32_t kEndOfCentralDirSig{0x06054b50};
+    constexpr std::uint32_t kCentralHeaderSig{0x02014b50};
+    constexpr std::uint32_t kLocalHeaderSig{0x04034b50};
+
+    constexpr std::size_t kEndOfCentralDirSize{22};
+    constexpr std::size_t kCentralHeaderSize{46};
+    constexpr std::size_t kLocalHeaderSize{30};
+    constexpr std::size_t kMaxCommentSize{0xFFFF};
+
+    constexpr std::uint32_t kZip64Marker{0xFFFFFFFF};
+    constexpr std::uint16_t kEncryptedFlag{0x0001};
+
+    // ZIP luôn little-endian
+    std::uint16_t readU16(const char* p) noexcept {
+        const auto* b = reinterpret_cast<const unsigned char*>(p);
+        return static_cast<std::uint16_t>(b[0] | (b[1] << 8U));
+    }
+
+    std::uint32_t readU32(const char* p) noexcept {
+        const auto* b = reinterpret_cast<const unsigned char*>(p);
+        return static_cast<std::uint32_t>(b[0]) | (static_cast<std::uint32_t>(b[1]) << 8U) |
+               (static_cast<std::uint32_t>(b[2]) << 16U) |
+               (static_cast<std::uint32_t>(b[3]) << 24U);
+    }
+
+    // RAII cho z_stream (raw deflate, không header zlib/gzip)
+    class Inflater {
+        public:
+            Inflater() {
+                if (inflateInit2(&m_stream, -MAX_WBITS) != Z_OK) {
+                    throw std::runtime_error("inflateInit2 failed");
+                }
+            }
+
+            ~Inflater() { inflateEnd(&m_stream); }
+
+            Inflater(const Inflater &) = delete;
+            Inflater &operator=(const Inflater &) = delete;
+
+            z_stream* get() noexcept { return &m_stream; }
+
+        private:
+            z_stream m_stream{};
+    };
+} // namespace
+
+ZipArchive::ZipArchive(const std::filesystem::path &path)
+    : m_path(path), m_in(path, std::ios::binary) {
+    if (!m_in.is_open()) { throw std::runtime_error("Cannot open archive: " + path.string()); }
+
+    m_in.seekg(0, std::ios::end);
+    m_fileSize = static_cast<std::uint64_t>(m_in.tellg());
+
+    readCentralDirectory();
+}
+
+const ZipArchive::Entry* ZipArchive::find(std::string_view name) const {
+    const auto it = std::ranges::find(m_entries, name, &Entry::name);
+    return it == m_entries.end() ? nullptr : &*it;
+}
+
+void ZipArchive::readRaw(std::uint64_t offset, char* out, std::size_t size) {
+    if (offset > m_fileSize || size > m_fileSize - offset) {
+        throw std::runtime_error("Truncated archive: " + m_path.string());
+    }
+
+    m_in.clear();
+    m_in.seekg(static_cast<std::streamoff>(offset));
+    if (!m_in.read(out, static_cast<std::streamsize>(size))) {
+        throw std::runtime_error("Cannot read archive: " + m_path.string());
+    }
+}
+
+void ZipArchive::readCentralDirectory() {
+    if (m_fileSize < kEndOfCentralDirSize) {
+        throw std::runtime_error("Not a ZIP archive: " + m_path.string());
+    }
+
+    // EOCD nằm ở cuối file, sau nó có thể là comment (tối đa 64 KiB)
+    const auto tailSize = static_cast<std::size_t>(
+        std::min<std::uint64_t>(m_fileSize, kEndOfCentralDirSize + kMaxCommentSize));
+    std::vector<char> tail(tailSize);
+    readRaw(m_fileSize - tailSize, tail.data(), tailSize);
+
+    std::size_t eocd = tailSize - kEndOfCentralDirSize + 1;
+    do {
+        --eocd;
+        if (readU32(tail.data() + eocd) == kEndOfCentralDirSig) { break; }
+    } while (eocd > 0);
+
+    if (readU32(tail.data() + eocd) != kEndOfCentralDirSig) {
+        throw std::runtime_error("Not a ZIP archive: " + m_path.string());
+    }
+
+    const char* e = tail.data() + eocd;
+    const std::uint16_t entryCount = readU16(e + 10);
+    const std::uint32_t dirSize = readU32(e + 12);
+    const std::uint32_t dirOffset = readU32(e + 16);
+
+    if (dirSize == kZip64Marker || dirOffset == kZip64Marker) {
+        throw std::runtime_error("ZIP64 archives are not supported: " + m_path.string());
+    }
+
+    std::vector<char> dir(dirSize);
+    readRaw(dirOffset, dir.data(), dir.size());
+
+    m_entries.reserve(entryCount);
+
+    std::size_t pos{0};
+    for (std::uint16_t i = 0; i < entryCount; ++i) {
+        if (pos + kCentralHeaderSize > dir.size() ||
+            readU32(dir.data() + pos) != kCentralHeaderSig) {
+            throw std::runtime_error("Corrupt central directory: " + m_path.string());
+        }
+
+        const char* h = dir.data() + pos;
+        const std::uint16_t nameLen = readU16(h + 28);
+        const std::uint16_t extraLen = readU16(h + 30);
+        const std::uint16_t commentLen = readU16(h + 32);
+
+        if (pos + kCentralHeaderSize + nameLen > dir.size()) {
+            throw std::runtime_error("Corrupt central directory: " + m_path.string());
+        }
+
+        Entry entry;
+        entry.flags = readU16(h + 8);
+        entry.method = readU16(h + 10);
+        entry.compressedSize = readU32(h + 20);
+        entry.uncompressedSize = readU32(h + 24);
+        entry.localHeaderOffset = readU32(h + 42);
+        entry.name.assign(h + kCentralHeaderSize, nameLen);
+
+        m_entries.push_back(std::move(entry));
+        pos += kCentralHeaderSize + nameLen + extraLen + commentLen;
+    }
+}
+
+std::uint64_t ZipArchive::dataOffset(const Entry &entry) {
+    std::array<char, kLocalHeaderSize> header{};
+    readRaw(entry.localHeaderOffset, header.data(), header.size());
+
+    if (readU32(header.data()) != kLocalHeaderSig) {
+        throw std::runtime_error("Corrupt local header for " + entry.name);
+    }
+
+    // Độ dài name/extra ở local header có thể khác central directory
+    return entry.localHeaderOffset + kLocalHeaderSize + readU16(header.data() + 26) +
+           readU16(header.data() + 28);
+}
+
+void ZipArchive::readEntry(const Entry &entry, const BlockSink &sink, std::uint64_t maxBytes) {
+    if ((entry.flags & kEncryptedFlag) != 0) {
+        throw std::runtime_error("Encrypted ZIP entry: " + entry.name);
+    }
+    if (entry.method != kStored && entry.method != kDeflated) {
+        throw std::runtime_error("Unsupported compression method for " + entry.name);
+    }
+
+    std::uint64_t offset = dataOffset(entry);
+    std::uint64_t remaining = entry.compressedSize;
+
+    std::vector<char> input(kBlockSize);
+
+    if (entry.method == kStored) {
+        if (remaining > maxBytes) {
+            throw std::runtime_error("ZIP entry too large: " + entry.name);
+        }
+
+        while (remaining > 0) {
+            const auto n = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, kBlockSize));
+            readRaw(offset, input.data(), n);
+            sink(std::string_view(input.data(), n));
+            offset += n;
+            remaining -= n;
+        }
+        return;
+    }
+
+    Inflater inflater;
+    z_stream* zs = inflater.get();
+    std::vector<char> output(kBlockSize);
+    std::uint64_t produced{0};
+
+    int rc = Z_OK;
+    while (rc != Z_STREAM_END) {
+        // Hết input nhưng zlib có thể còn giữ output chưa xả: vẫn gọi inflate,
+        // Z_BUF_ERROR lúc đó nghĩa là entry bị cắt cụt
+        if (zs->avail_in == 0 && remaining > 0) {
+            const auto n = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, kBlockSize));
+            readRaw(offset, input.data(), n);
+            offset += n;
+            remaining -= n;
+
+            zs->next_in = reinterpret_cast<Bytef*>(input.data());
+            zs->avail_in = static_cast<uInt>(n);
+        }
+
+        zs->next_out = reinterpret_cast<Bytef*>(output.data());
+        zs->avail_out = static_cast<uInt>(output.size());
+
+        rc = inflate(zs, Z_NO_FLUSH);
+        if (rc == Z_BUF_ERROR) { throw std::runtime_error("Truncated ZIP entry: " + entry.name); }
+        if (rc != Z_OK && rc != Z_STREAM_END) {
+            throw std::runtime_error("Corrupt deflate data in " + entry.name);
+        }
+
+        const std::size_t n = output.size() - zs->avail_out;
+        produced += n;
+        if (produced > maxBytes) { throw std::runtime_error("ZIP entry too large: " + entry.name); }
+        if (n > 0) { sink(std::string_view(output.data(), n)); }
+    }
+}
+
+std::string ZipArchive::readEntryToString(const Entry &entry, std::uint64_t maxBytes) {
+    std::string result;
+    readEntry(entry, [&](std::string_view block) { result.append(block); }, maxBytes);
+    return result;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Đọc file ZIP (EPUB, ...) theo central directory, không nạp cả archive vào bộ nhớ.
+// Entry được giải nén từng block (stored hoặc deflate) và đẩy ra sink.
+// Không hỗ trợ ZIP64, mã hóa và các phương thức nén khác ngoài stored/deflate.
+class ZipArchive {
+    public:
+        struct Entry {
+                std::string name;
+                std::uint16_t method{};
+                std::uint16_t flags{};
+                std::uint64_t compressedSize{};
+                std::uint64_t uncompressedSize{};
+                std::uint64_t localHeaderOffset{};
+        };
+
+        using BlockSink = std::function<void(std::string_view)>;
+
+        static constexpr std::uint16_t kStored{0};
+        static constexpr std::uint16_t kDeflated{8};
+        static constexpr std::size_t kBlockSize{64 * 1024};
+        static constexpr std::uint64_t kUnlimited{std::numeric_limits<std::uint64_t>::max()};
+
+        // Đọc central directory; ném std::runtime_error nếu không phải ZIP hợp lệ
+        explicit ZipArchive(const std::filesystem::path &path);
+
+        [[nodiscard]] const std::vector<Entry> &entries() const noexcept { return m_entries; }
+
+        // Tìm entry theo tên chính xác (phân biệt hoa thường như trong ZIP)
+        [[nodiscard]] const Entry* find(std::string_view name) const;
+
+        // Giải nén entry, mỗi lần gọi sink tối đa kBlockSize byte.
+        // maxBytes chặn entry giải nén ra quá lớn (zip bomb): vượt quá thì ném lỗi.
+        void readEntry(const Entry &entry, const BlockSink &sink,
+                       std::uint64_t maxBytes = kUnlimited);
+
+        // Dành cho entry nhỏ (container.xml, OPF)
+        [[nodiscard]] std::string readEntryToString(const Entry &entry, std::uint64_t maxBytes);
+
+    private:
+        void readCentralDirectory();
+        std::uint64_t dataOffset(const Entry &entry);
+        void readRaw(std::uint64_t offset, char* out, std::size_t size);
+
+        std::filesystem::path m_path;
+        std::ifstream m_in;
+        std::uint64_t m_fileSize{};
+        std::vector<Entry> m_entries;
+};
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "helper.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <stdexcept>
 #include <string>
 #include <string_view>
@@ -13,7 +17,76 @@
 #include <filesystem>
 #include <sqlite3.h>
 
-enum class ResourceType : std::uint8_t { text, cpp, pdf, epub };
+// Giá trị enum là mã lưu trong resources.type: chỉ thêm mã mới, không đổi mã cũ
+enum class ResourceType : std::uint8_t { text = 0, cpp = 1, pdf = 2, epub = 3 };
+
+// Thời điểm lưu trong DB dạng INTEGER (unix epoch, giây)
+using Timestamp = std::chrono::sys_seconds;
+
+[[nodiscard]] constexpr Timestamp timestampFromEpoch(std::int64_t seconds) noexcept {
+    return Timestamp{std::chrono::seconds{seconds}};
+}
+
+[[nodiscard]] constexpr std::int64_t epochFromTimestamp(Timestamp time) noexcept {
+    return time.time_since_epoch().count();
+}
+
+// SHA-256 nội dung file, lưu nguyên 32 byte (BLOB) trong resources.file_hash
+using FileHash = std::array<std::byte, 32>;
+
+// Hex chỉ dùng ở biên: tên file trong ContentStore, hiển thị/xuất dữ liệu
+[[nodiscard]] inline std::string fileHashToHex(const FileHash &hash) {
+    constexpr std::string_view kDigits{"0123456789abcdef"};
+
+    std::string hex(hash.size() * 2, '\0');
+    for (std::size_t i = 0; i < hash.size(); ++i) {
+        const auto byte = std::to_integer<unsigned>(hash[i]);
+        hex[2 * i] = kDigits[byte >> 4U];
+        hex[2 * i + 1] = kDigits[byte & 0x0FU];
+    }
+    return hex;
+}
+
+// nullopt nếu không phải đúng 64 ký tự hex
+[[nodiscard]] inline std::optional<FileHash> fileHashFromHex(std::string_view hex) noexcept {
+    FileHash hash{};
+    if (hex.size() != hash.size() * 2) { return std::nullopt; }
+
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') { return c - '0'; }
+        if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+        if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+        return -1;
+    };
+
+    for (std::size_t i = 0; i < hash.size(); ++i) {
+        const int high = nibble(hex[2 * i]);
+        const int low = nibble(hex[2 * i + 1]);
+        if (high < 0 || low < 0) { return std::nullopt; }
+        hash[i] = static_cast<std::byte>((high << 4) | low);
+    }
+    return hash;
+}
+
+// Giá trị cột BLOB (sqlite3_column_blob/bytes); nullopt nếu NULL hoặc sai độ dài
+[[nodiscard]] inline std::optional<FileHash> fileHashFromBlob(const void* data, int size) noexcept {
+    FileHash hash{};
+    if (data == nullptr || size != static_cast<int>(hash.size())) { return std::nullopt; }
+
+    std::memcpy(hash.data(), data, hash.size());
+    return hash;
+}
+
+[[nodiscard]] constexpr int resourceTypeCode(ResourceType type) noexcept {
+    return static_cast<int>(type);
+}
+
+[[nodiscard]] inline ResourceType resourceTypeFromCode(std::int64_t code) {
+    if (code < 0 || code > resourceTypeCode(ResourceType::epub)) {
+        throw std::runtime_error(std::format("Unknown ResourceType code: {}", code));
+    }
+    return static_cast<ResourceType>(code);
+}
 
 [[nodiscard]] inline const char* resourceTypeToString(ResourceType type) noexcept {
     switch (type) {
@@ -62,12 +135,22 @@ enum class ResourceType : std::uint8_t { text, cpp, pdf, epub };
 }
 
 struct Resource {
-        sqlite3_int64 id{};     // id của resource
-        std::string title;      // tiêu đề
-        ResourceType type;      // loại: text, cpp, pdf, epub
-        std::string file_hash;  // hash file (có thể rỗng nếu là text)
-        std::string created_at; // timestamp tạo
-        std::string updated_at; // timestamp cập nhật
+        sqlite3_int64 id{};                // id của resource
+        std::string title;                 // tiêu đề
+        ResourceType type;                 // loại: text, cpp, pdf, epub
+        std::optional<FileHash> file_hash; // SHA-256 file, không có với text note
+        Timestamp created_at{};            // thời điểm tạo
+        Timestamp updated_at{};            // thời điểm cập nhật
+};
+
+// Chỗ khớp tốt nhất của một resource khi tìm theo nội dung
+struct ContentHit {
+        sqlite3_int64 resource_id{};
+        std::string snippet;
+        std::int64_t byte_offset{}; // vị trí khớp đầu tiên trong text (PDF: trong trang)
+        int line{1};                // dòng chứa byte_offset, đếm từ 1
+        std::optional<int> page;    // chỉ có với PDF
+        double rank{};              // bm25 của chunk (nhỏ hơn = khớp hơn), để trộn note và file
 };
 
 struct FullResource {
@@ -75,6 +158,7 @@ struct FullResource {
         std::optional<std::string> content;
         std::optional<std::string> filepath;
         std::vector<std::string> tags;
+        std::optional<ContentHit> hit; // chỉ có khi tìm theo nội dung
 };
 
 struct FileEntry {
@@ -83,3 +167,84 @@ struct FileEntry {
         std::string original_path;
         bool is_managed{};
 };
+
+// File linked (is_managed = 0) cùng hash hiện tại, dùng cho LinkedFileWatcher
+struct LinkedFileState {
+        sqlite3_int64 resource_id{};
+        std::string path;                  // original_path (= stored_path với file linked)
+        std::optional<FileHash> file_hash; // NULL với dữ liệu cũ
+        bool is_missing{};                 // missing_since IS NOT NULL
+};
+
+// Thay đổi phát hiện trên file linked, ghi DB theo batch
+struct LinkedFileChange {
+        enum class Kind : std::uint8_t { modified, moved, missing, restored };
+
+        sqlite3_int64 resource_id{};
+        Kind kind{};
+        std::string path;             // đường dẫn mới (moved), còn lại là đường dẫn hiện tại
+        std::optional<FileHash> hash; // hash mới; nullopt nếu nội dung không đổi
+};
+
+// File cần (re)index nội dung
+struct IndexCandidate {
+        sqlite3_int64 resource_id{};
+        ResourceType type{};
+        std::string path;                  // stored_path, fallback original_path
+        std::optional<FileHash> file_hash; // nullopt với dữ liệu cũ chưa có hash
+};
+
+// Vị trí một chunk trong text gốc (bảng file_chunks / text_chunks)
+struct ChunkPosition {
+        int chunk_no{};
+        std::int64_t byte_offset{};
+        int line_no{1}; // dòng chứa byte đầu tiên của chunk
+};
+
+// Một phiên bản cũ của text note (bảng text_revisions)
+struct RevisionInfo {
+        std::int64_t revision{};  // tăng dần trong từng note, bắt đầu từ 1
+        std::string created_at;
+        bool is_snapshot{};       // lưu nguyên văn (nén), không phải delta
+        std::int64_t size{};      // kích thước text của phiên bản
+        std::int64_t stored_size{};
+};
+
+// Ký hiệu trích từ resource cpp (bảng symbols)
+enum class SymbolKind : std::uint8_t { type = 0, function = 1, macro = 2, include = 3, call = 4 };
+
+[[nodiscard]] constexpr int symbolKindCode(SymbolKind kind) noexcept {
+    return static_cast<int>(kind);
+}
+
+[[nodiscard]] inline SymbolKind symbolKindFromCode(std::int64_t code) {
+    if (code < 0 || code > symbolKindCode(SymbolKind::call)) {
+        throw std::runtime_error(std::format("Unknown SymbolKind code: {}", code));
+    }
+    return static_cast<SymbolKind>(code);
+}
+
+// Định nghĩa (class/struct/union/enum, hàm có thân, macro), không tính include và lời gọi
+[[nodiscard]] constexpr bool isDefinitionKind(SymbolKind kind) noexcept {
+    return kind == SymbolKind::type || kind == SymbolKind::function || kind == SymbolKind::macro;
+}
+
+[[nodiscard]] inline const char* symbolKindToString(SymbolKind kind) noexcept {
+    switch (kind) {
+        case SymbolKind::type    : return "type";
+        case SymbolKind::function: return "function";
+        case SymbolKind::macro   : return "macro";
+        case SymbolKind::include : return "include";
+        case SymbolKind::call    : return "call";
+    }
+    std::unreachable();
+}
+
+struct Symbol {
+        sqlite3_int64 resource_id{};
+        SymbolKind kind{};
+        std::string name; // tên không kèm scope (Foo::bar -> bar); include: đường dẫn trong <> / ""
+        int line{1};      // dòng của tên, đếm từ 1
+
+        bool operator==(const Symbol &) const = default;
+};
@@ -0,0 +1,180 @@
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include "search_result.hpp"
+#include "model.hpp"
+
+// Upstream (new_delete_resource) đếm số byte xin hệ thống để arenaBytes() đo được
+struct SearchResult::Storage {
+        class CountingResource final : public std::pmr::memory_resource {
+            public:
+                std::size_t allocated{};
+
+            private:
+                void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+                    void* ptr = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+                    allocated += bytes;
+                    return ptr;
+                }
+
+                void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {
+                    std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+                    allocated -= bytes;
+                }
+
+                [[nodiscard]] bool
+                    do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+                    return this == &other;
+                }
+        };
+
+        CountingResource upstream;
+        std::pmr::monotonic_buffer_resource arena{kInitialArenaBytes, &upstream};
+        std::pmr::vector<Record> records{&arena};
+        std::pmr::vector<std::string_view> tags{&arena};
+};
+
+SearchResult::SearchResult() = default;
+SearchResult::~SearchResult() = default;
+SearchResult::SearchResult(SearchResult &&other) noexcept = default;
+SearchResult &SearchResult::operator=(SearchResult &&other) noexcept = default;
+
+std::size_t SearchResult::size() const noexcept {
+    return m_storage != nullptr ? m_storage->records.size() : 0;
+}
+
+SearchResult::Entry SearchResult::operator[](std::size_t index) const {
+    if (index >= size()) { throw std::out_of_range("SearchResult index out of range"); }
+
+    const auto &rec = m_storage->records[index];
+    Entry entry{.id = rec.id,
+                .type = rec.type,
+                .title = view(rec.title),
+                .path = std::nullopt,
+                .created_at = rec.created_at,
+                .updated_at = rec.updated_at,
+                .tags = std::span(m_storage->tags).subspan(rec.tag_begin, rec.tag_count),
+                .hit = std::nullopt};
+
+    if (rec.path != nullptr) { entry.path = view(rec.path); }
+    if (rec.has_hit) {
+        entry.hit = Hit{.snippet = view(rec.snippet),
+                        .byte_offset = rec.byte_offset,
+                        .line = rec.line,
+                        .page = rec.page >= 0 ? std::optional<int>(rec.page) : std::nullopt};
+    }
+
+    return entry;
+}
+
+std::size_t SearchResult::arenaBytes() const noexcept {
+    return m_storage != nullptr ? m_storage->upstream.allocated : 0;
+}
+
+void SearchResult::clear() noexcept {
+    m_storage.reset();
+}
+
+SearchResult SearchResult::copy() const {
+    SearchResult out;
+    if (empty()) { return out; }
+
+    out.reserve(size());
+    for (std::size_t i = 0; i < size(); ++i) {
+        const auto entry = (*this)[i];
+        out.add(entry.id, entry.type, entry.title, entry.path, entry.created_at,
+                entry.updated_at);
+        for (const auto tag : entry.tags) { out.addTag(tag); }
+
+        if (entry.hit.has_value()) {
+            auto &rec = out.m_storage->records.back();
+            rec.snippet = out.intern(entry.hit->snippet);
+            rec.byte_offset = entry.hit->byte_offset;
+            rec.line = entry.hit->line;
+            rec.page = entry.hit->page.value_or(-1);
+            rec.has_hit = true;
+        }
+    }
+
+    return out;
+}
+
+void SearchResult::reserve(std::size_t entries) {
+    storage().records.reserve(entries);
+}
+
+std::size_t SearchResult::add(sqlite3_int64 id, ResourceType type, std::string_view title,
+                              std::optional<std::string_view> path, Timestamp createdAt,
+                              Timestamp updatedAt) {
+    auto &store = storage();
+
+    store.records.push_back({.id = id,
+                             .created_at = createdAt,
+                             .updated_at = updatedAt,
+                             .title = intern(title),
+                             .path = path.has_value() ? intern(*path) : nullptr,
+                             .snippet = nullptr,
+                             .byte_offset = 0,
+                             .tag_begin = static_cast<std::uint32_t>(store.tags.size()),
+                             .tag_count = 0,
+                             .line = 0,
+                             .page = -1,
+                             .type = type,
+                             .has_hit = false});
+
+    return store.records.size() - 1;
+}
+
+void SearchResult::addTag(std::string_view tag) {
+    auto &store = storage();
+    if (store.records.empty()) { throw std::logic_error("SearchResult::addTag before add"); }
+
+    auto &rec = store.records.back();
+    if (rec.tag_begin + rec.tag_count != store.tags.size()) {
+        throw std::logic_error("SearchResult::addTag must follow add of the same entry");
+    }
+
+    store.tags.push_back(view(intern(tag)));
+    ++rec.tag_count;
+}
+
+void SearchResult::setHit(std::size_t index, const ContentHit &hit) {
+    if (index >= size()) { throw std::out_of_range("SearchResult index out of range"); }
+
+    auto &rec = m_storage->records[index];
+    rec.snippet = intern(hit.snippet);
+    rec.byte_offset = hit.byte_offset;
+    rec.line = hit.line;
+    rec.page = hit.page.value_or(-1);
+    rec.has_hit = true;
+}
+
+SearchResult::Storage &SearchResult::storage() {
+    // Tạo lười: SearchResult rỗng (hoặc đã move/clear) không giữ arena
+    if (m_storage == nullptr) { m_storage = std::make_unique<Storage>(); }
+    return *m_storage;
+}
+
+const char* SearchResult::intern(std::string_view text) {
+    const auto size = static_cast<std::uint32_t>(text.size());
+
+    auto* ptr = static_cast<char*>(
+        storage().arena.allocate(sizeof(size) + text.size(), alignof(std::uint32_t)));
+    std::memcpy(ptr, &size, sizeof(size));
+    std::memcpy(ptr + sizeof(size), text.data(), text.size());
+    return ptr;
+}
+
+std::string_view SearchResult::view(const char* interned) noexcept {
+    if (interned == nullptr) { return {}; }
+
+    std::uint32_t size{};
+    std::memcpy(&size, interned, sizeof(size));
+    return {interned + sizeof(size), size};
+}
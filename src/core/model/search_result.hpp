@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <sqlite3.h>
+#include "model.hpp"
+
+// Kết quả tìm kiếm cho Browse tab, thay cho std::vector<FullResource>: mọi chuỗi (title, path,
+// snippet, tag) được copy vào một arena (monotonic_buffer_resource), mỗi resource là một bản ghi
+// cố định kích thước trỏ vào arena. 10k kết quả chỉ tốn vài lần cấp phát block, giải phóng một
+// lần khi hủy/clear, và move (kể cả sang thread khác) chỉ là chuyển một con trỏ.
+// Chuỗi trong Entry sống cùng SearchResult (kể cả sau khi move); riêng tags có thể đổi chỗ khi
+// add thêm, nên đọc Entry sau khi đã ghi xong.
+class SearchResult {
+    public:
+        // Chỗ khớp khi tìm theo nội dung (xem ContentHit)
+        struct Hit {
+                std::string_view snippet;
+                std::int64_t byte_offset{};
+                int line{1};
+                std::optional<int> page;
+        };
+
+        struct Entry {
+                sqlite3_int64 id{};
+                ResourceType type{};
+                std::string_view title;
+                std::optional<std::string_view> path; // không có với text note
+                Timestamp created_at{};
+                Timestamp updated_at{};
+                std::span<const std::string_view> tags;
+                std::optional<Hit> hit;
+        };
+
+        static constexpr std::size_t kInitialArenaBytes{16 * 1024};
+
+        SearchResult();
+        ~SearchResult();
+
+        SearchResult(SearchResult &&other) noexcept;
+        SearchResult &operator=(SearchResult &&other) noexcept;
+
+        SearchResult(const SearchResult &) = delete;
+        SearchResult &operator=(const SearchResult &) = delete;
+
+        [[nodiscard]] std::size_t size() const noexcept;
+        [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+
+        [[nodiscard]] Entry operator[](std::size_t index) const;
+
+        // Số byte arena đã cấp phát từ hệ thống (để đo, không phải số byte đang dùng)
+        [[nodiscard]] std::size_t arenaBytes() const noexcept;
+
+        // Giải phóng cả arena một lần
+        void clear() noexcept;
+
+        // Bản sao sâu vào một arena mới (vd trả kết quả từ cache); không có copy ngầm
+        [[nodiscard]] SearchResult copy() const;
+
+        // ===== Ghi (từ repository) =====
+        void reserve(std::size_t entries);
+
+        // Thêm một resource, trả về chỉ số của nó; các chuỗi được copy vào arena
+        std::size_t add(sqlite3_int64 id, ResourceType type, std::string_view title,
+                        std::optional<std::string_view> path, Timestamp createdAt,
+                        Timestamp updatedAt);
+
+        // Tag của resource vừa add (phải gọi ngay sau add, trước add kế tiếp)
+        void addTag(std::string_view tag);
+
+        void setHit(std::size_t index, const ContentHit &hit);
+
+    private:
+        // Chuỗi trong arena dạng [uint32 độ dài][byte], bản ghi chỉ giữ con trỏ (nullptr = không
+        // có) nên mỗi kết quả tốn 80 byte cộng phần chuỗi; tag là đoạn [tag_begin, +tag_count)
+        struct Record {
+                sqlite3_int64 id{};
+                Timestamp created_at{};
+                Timestamp updated_at{};
+                const char* title{};
+                const char* path{};
+                const char* snippet{};
+                std::int64_t byte_offset{};
+                std::uint32_t tag_begin{};
+                std::uint32_t tag_count{};
+                std::int32_t line{};
+                std::int32_t page{-1}; // -1 = không có trang
+                ResourceType type{};
+                bool has_hit{};
+        };
+
+        static_assert(sizeof(Record) <= 80);
+
+        struct Storage;
+        std::unique_ptr<Storage> m_storage;
+
+        Storage &storage();
+        const char* intern(std::string_view text);
+        [[nodiscard]] static std::string_view view(const char* interned) noexcept;
+};
+
+// Một trang của truy vấn phân trang (view ảo nạp dần)
+struct SearchPage {
+        SearchResult result;
+        bool last{}; // không còn dòng nào sau trang này
+};
@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "chunk_search.hpp"
+#include "model.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    // Ký tự đánh dấu chỗ khớp trong highlight(); không xuất hiện trong text thông thường
+    constexpr char kMatchOpen{'\x01'};
+
+    std::string columnText(sqlite3_stmt* stmt, int col) {
+        const char* ptr = reinterpret_cast<const char*>(sqlite3_column_text(stmt, col));
+        if (ptr == nullptr) { return {}; }
+
+        return {ptr, static_cast<std::string::size_type>(sqlite3_column_bytes(stmt, col))};
+    }
+
+    // Snippet và dời offset/dòng của hit (đang là đầu chunk) tới chỗ khớp đầu tiên trong chunk
+    // (stmt đã bind keyword ở tham số 1)
+    void locateMatch(const SQLiteStmt &stmt, sqlite3_int64 chunkId, ContentHit &hit) {
+        sqlite3_reset(stmt.get());
+        sqlite3_bind_int64(stmt.get(), 2, chunkId);
+
+        if (sqlite3_step(stmt.get()) != SQLITE_ROW) { return; }
+
+        hit.snippet = columnText(stmt.get(), 0);
+
+        const std::string marked = columnText(stmt.get(), 1);
+        const auto pos = marked.find(kMatchOpen);
+        if (pos == std::string::npos) { return; }
+
+        // Trước marker đầu tiên chưa có marker nào => pos là offset trong chunk gốc
+        const std::string_view before = std::string_view(marked).substr(0, pos);
+        hit.byte_offset += static_cast<std::int64_t>(pos);
+        hit.line += static_cast<int>(std::ranges::count(before, '\n'));
+    }
+} // namespace
+
+std::vector<ContentHit> searchChunkHits(SQLiteDB &db, const ChunkTables &tables,
+                                        std::string_view keyword) {
+    const std::string fts(tables.fts);
+    const std::string chunks(tables.chunks);
+    const char* line = tables.prefixLines ? "1" : "c.line_no";
+
+    // Không gọi snippet() ở đây: FTS sẽ đọc text của mọi chunk khớp, kể cả chunk bị bỏ
+    SQLiteStmt stmt(db.get(), "SELECT c.id, c.resource_id, c.byte_offset, " + std::string(line) +
+                                  ", " + (tables.hasPage ? "c.page" : "NULL") +
+                                  ", c.chunk_no, rank FROM " + fts + " JOIN " + chunks +
+                                  " c ON c.id = " + fts + ".rowid WHERE " + fts +
+                                  " MATCH ? ORDER BY rank;");
+
+    sqlite3_bind_text(stmt.get(), 1, keyword.data(), static_cast<int>(keyword.size()),
+                      SQLITE_TRANSIENT);
+
+    struct BestChunk {
+            sqlite3_int64 id{};
+            sqlite3_int64 chunkNo{};
+            ContentHit hit;
+    };
+
+    std::vector<BestChunk> best;
+    std::unordered_set<sqlite3_int64> seen;
+
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        ContentHit hit;
+        hit.resource_id = sqlite3_column_int64(stmt.get(), 1);
+        if (!seen.insert(hit.resource_id).second) { continue; } // đã có chunk xếp hạng cao hơn
+
+        hit.byte_offset = sqlite3_column_int64(stmt.get(), 2);
+        hit.line = sqlite3_column_int(stmt.get(), 3);
+        if (sqlite3_column_type(stmt.get(), 4) != SQLITE_NULL) {
+            hit.page = sqlite3_column_int(stmt.get(), 4);
+        }
+        hit.rank = sqlite3_column_double(stmt.get(), 6);
+
+        best.push_back({.id = sqlite3_column_int64(stmt.get(), 0),
+                        .chunkNo = sqlite3_column_int64(stmt.get(), 5),
+                        .hit = std::move(hit)});
+    }
+
+    // Chỉ snippet/highlight/cộng dòng cho chunk được chọn (một chunk mỗi resource); snippet và
+    // highlight chung một dòng nên text của chunk chỉ được đọc một lần
+    std::vector<ContentHit> result;
+    result.reserve(best.size());
+    if (best.empty()) { return result; }
+
+    SQLiteStmt locate(db.get(), "SELECT snippet(" + fts + ", 0, '', '', '...', 32), highlight(" +
+                                    fts + ", 0, char(1), char(2)) FROM " + fts + " WHERE " + fts +
+                                    " MATCH ? AND rowid = ?;");
+    sqlite3_bind_text(locate.get(), 1, keyword.data(), static_cast<int>(keyword.size()),
+                      SQLITE_TRANSIENT);
+
+    std::optional<SQLiteStmt> prefix;
+    if (tables.prefixLines) {
+        prefix.emplace(db.get(), "SELECT COALESCE(SUM(line_count), 0) FROM " + chunks +
+                                     " WHERE resource_id = ? AND chunk_no < ?;");
+    }
+
+    for (auto &[chunkId, chunkNo, hit] : best) {
+        if (prefix.has_value()) {
+            sqlite3_reset(prefix->get());
+            sqlite3_bind_int64(prefix->get(), 1, hit.resource_id);
+            sqlite3_bind_int64(prefix->get(), 2, chunkNo);
+
+            if (sqlite3_step(prefix->get()) == SQLITE_ROW) {
+                hit.line = 1 + sqlite3_column_int(prefix->get(), 0);
+            }
+        }
+
+        locateMatch(locate, chunkId, hit);
+        result.push_back(std::move(hit));
+    }
+
+    return result;
+}
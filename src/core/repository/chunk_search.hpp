@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string_view>
+#include <vector>
+#include "model.hpp"
+
+class SQLiteDB;
+
+// Bảng chunk (id, resource_id, chunk_no, byte_offset, ...) kèm bảng FTS5 external-content đọc
+// text của chunk (file_chunks.content, hoặc view text_chunk_texts cắt từ nội dung note).
+// Dòng của chunk lưu sẵn (line_no: file_chunks) hoặc tính từ tổng line_count của các chunk
+// đứng trước (text_chunks: chèn một dòng không phải cập nhật chunk phía sau).
+struct ChunkTables {
+        std::string_view chunks;
+        std::string_view fts;
+        bool hasPage{};
+        bool prefixLines{};
+};
+
+// Mỗi resource một hit lấy từ chunk xếp hạng cao nhất, theo thứ tự rank (bm25, giữ trong hit.rank).
+// byte_offset/line trỏ tới chỗ khớp đầu tiên trong chunk đó, tính trên text gốc. Text của chunk
+// (snippet, highlight) chỉ được đọc cho chunk đã chọn, không cho mọi dòng khớp.
+std::vector<ContentHit> searchChunkHits(SQLiteDB &db, const ChunkTables &tables,
+                                        std::string_view keyword);
@@ -0,0 +1,198 @@
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "content_index_repository.hpp"
+#include "chunk_search.hpp"
+#include "model.hpp"
+#include "query_router.hpp"
+#include "row_view.hpp"
+#include "sqldb_raii.hpp"
+
+std::vector<IndexCandidate>
+    ContentIndexRepository::getPendingFiles(const std::vector<ResourceType> &types,
+                                            std::size_t limit) {
+    std::vector<IndexCandidate> result;
+    if (types.empty() || limit == 0) { return result; }
+
+    std::string placeholders;
+    for (std::size_t i = 0; i < types.size(); ++i) { placeholders += i == 0 ? "?" : ", ?"; }
+
+    // file_hash NULL (dữ liệu cũ): chỉ index lần đầu, sau đó watcher cập nhật hash khi file đổi
+    SQLiteStmt stmt(m_db.get(),
+                    "SELECT r.id, r.type, COALESCE(f.stored_path, f.original_path), r.file_hash "
+                    "FROM resources r JOIN files f ON f.resource_id = r.id "
+                    "LEFT JOIN file_index_state s ON s.resource_id = r.id "
+                    "WHERE r.type IN (" +
+                        placeholders +
+                        ") AND f.missing_since IS NULL AND (s.resource_id IS NULL OR "
+                        "(r.file_hash IS NOT NULL AND s.indexed_hash <> r.file_hash)) "
+                        "ORDER BY r.id LIMIT ?;");
+
+    int idx{1};
+    for (auto type : types) {
+        sqlite3_bind_int(stmt.get(), idx++, resourceTypeCode(type));
+    }
+    sqlite3_bind_int64(stmt.get(), idx, static_cast<sqlite3_int64>(limit));
+
+    for (const auto &[id, type, path, hash] :
+         ResultSet<sqlite3_int64, ResourceType, std::string_view, std::optional<FileHash>>(stmt)) {
+        result.push_back(
+            {.resource_id = id, .type = type, .path = std::string(path), .file_hash = hash});
+    }
+
+    return result;
+}
+
+std::vector<IndexCandidate>
+    ContentIndexRepository::getFiles(const std::vector<ResourceType> &types) {
+    std::vector<IndexCandidate> result;
+    if (types.empty()) { return result; }
+
+    std::string placeholders;
+    for (std::size_t i = 0; i < types.size(); ++i) { placeholders += i == 0 ? "?" : ", ?"; }
+
+    SQLiteStmt stmt(m_db.get(),
+                    "SELECT r.id, r.type, COALESCE(f.stored_path, f.original_path), r.file_hash "
+                    "FROM resources r JOIN files f ON f.resource_id = r.id "
+                    "WHERE r.type IN (" +
+                        placeholders + ") AND f.missing_since IS NULL ORDER BY r.id;");
+
+    int idx{1};
+    for (auto type : types) {
+        sqlite3_bind_int(stmt.get(), idx++, resourceTypeCode(type));
+    }
+
+    for (const auto &[id, type, path, hash] :
+         ResultSet<sqlite3_int64, ResourceType, std::string_view, std::optional<FileHash>>(stmt)) {
+        result.push_back(
+            {.resource_id = id, .type = type, .path = std::string(path), .file_hash = hash});
+    }
+
+    return result;
+}
+
+void ContentIndexRepository::clearChunks(sqlite3_int64 resourceId) {
+    // Trigger file_chunks_delete_fts tự xóa khỏi FTS
+    SQLiteStmt stmt(m_db.get(), "DELETE FROM file_chunks WHERE resource_id = ?;");
+
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        std::string errMsg = sqlite3_errmsg(m_db.get());
+        throw std::runtime_error("Clear chunks failed: " + errMsg);
+    }
+}
+
+void ContentIndexRepository::insertChunk(sqlite3_int64 resourceId, const ChunkPosition &position,
+                                         std::string_view text, std::optional<int> page) {
+    SQLiteStmt stmt(m_db.get(), "INSERT INTO file_chunks(resource_id, chunk_no, byte_offset, "
+                                "line_no, content, page) VALUES (?, ?, ?, ?, ?, ?);");
+
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+    sqlite3_bind_int(stmt.get(), 2, position.chunk_no);
+    sqlite3_bind_int64(stmt.get(), 3, position.byte_offset);
+    sqlite3_bind_int(stmt.get(), 4, position.line_no);
+    sqlite3_bind_text(stmt.get(), 5, text.data(), static_cast<int>(text.size()), SQLITE_TRANSIENT);
+
+    if (page.has_value()) {
+        sqlite3_bind_int(stmt.get(), 6, *page);
+    } else {
+        sqlite3_bind_null(stmt.get(), 6);
+    }
+
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        std::string errMsg = sqlite3_errmsg(m_db.get());
+        throw std::runtime_error("Insert chunk failed for resource ID: " +
+                                 std::to_string(resourceId) + " Error: " + errMsg);
+    }
+}
+
+void ContentIndexRepository::setIndexState(sqlite3_int64 resourceId,
+                                           const std::optional<FileHash> &hash, int chunkCount,
+                                           std::optional<std::string_view> error) {
+    SQLiteStmt stmt(m_db.get(),
+                    "INSERT INTO file_index_state(resource_id, indexed_hash, chunk_count, error) "
+                    "VALUES (?, ?, ?, ?) ON CONFLICT(resource_id) DO UPDATE SET "
+                    "indexed_hash = excluded.indexed_hash, chunk_count = excluded.chunk_count, "
+                    "error = excluded.error, indexed_at = CURRENT_TIMESTAMP;");
+
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+    // Resource chưa có hash (dữ liệu cũ): BLOB rỗng, không bằng hash nào
+    if (hash.has_value()) {
+        sqlite3_bind_blob(stmt.get(), 2, hash->data(), static_cast<int>(hash->size()),
+                          SQLITE_TRANSIENT);
+    } else {
+        sqlite3_bind_zeroblob(stmt.get(), 2, 0);
+    }
+    sqlite3_bind_int(stmt.get(), 3, chunkCount);
+
+    if (error.has_value()) {
+        sqlite3_bind_text(stmt.get(), 4, error->data(), static_cast<int>(error->size()),
+                          SQLITE_TRANSIENT);
+    } else {
+        sqlite3_bind_null(stmt.get(), 4);
+    }
+
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        std::string errMsg = sqlite3_errmsg(m_db.get());
+        throw std::runtime_error("Update index state failed: " + errMsg);
+    }
+}
+
+std::optional<FileHash> ContentIndexRepository::getIndexedHash(sqlite3_int64 resourceId) {
+    SQLiteStmt stmt(m_db.get(),
+                    "SELECT indexed_hash FROM file_index_state WHERE resource_id = ?;");
+
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        const void* hash = sqlite3_column_blob(stmt.get(), 0);
+        return fileHashFromBlob(hash, sqlite3_column_bytes(stmt.get(), 0));
+    }
+
+    return std::nullopt;
+}
+
+int ContentIndexRepository::chunkCount(sqlite3_int64 resourceId) const {
+    SQLiteStmt stmt(m_db.get(), "SELECT COUNT(*) FROM file_chunks WHERE resource_id = ?;");
+
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) { return sqlite3_column_int(stmt.get(), 0); }
+
+    return 0;
+}
+
+std::vector<std::pair<sqlite3_int64, std::string>>
+    ContentIndexRepository::searchFileContentFTS(std::string_view keyword) {
+    std::vector<std::pair<sqlite3_int64, std::string>> result;
+
+    for (auto &hit : searchFileContentHits(keyword)) {
+        if (hit.page.has_value()) {
+            hit.snippet = "p. " + std::to_string(*hit.page) + ": " + hit.snippet;
+        }
+        result.emplace_back(hit.resource_id, std::move(hit.snippet));
+    }
+
+    return result;
+}
+
+std::vector<ContentHit> ContentIndexRepository::searchFileContentHits(std::string_view keyword) {
+    return searchChunkHits(m_db, {.chunks = "file_chunks", .fts = "file_chunks_fts",
+                                  .hasPage = true}, keyword);
+}
+
+std::vector<ContentHit> ContentIndexRepository::searchFileContentHits(const RoutedQuery &query) {
+    if (query.plan == QueryPlan::none || query.plan == QueryPlan::likeScan) { return {}; }
+
+    const bool trigram = query.plan == QueryPlan::trigram;
+    return searchChunkHits(m_db,
+                           {.chunks = "file_chunks",
+                            .fts = trigram ? "file_chunks_trigram" : "file_chunks_fts",
+                            .hasPage = true},
+                           query.expression);
+}
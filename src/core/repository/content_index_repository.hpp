@@ -0,0 +1,49 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "model.hpp"
+
+class SQLiteDB;
+struct RoutedQuery;
+
+// Nội dung trích từ file (cpp/txt,...) được chia chunk trong file_chunks,
+// file_chunks_fts là bảng FTS5 external-content trỏ vào file_chunks
+class ContentIndexRepository {
+    public:
+        explicit ContentIndexRepository(SQLiteDB &db) noexcept : m_db(db) {}
+
+        // File chưa index, hoặc hash hiện tại khác hash lúc index
+        std::vector<IndexCandidate> getPendingFiles(const std::vector<ResourceType> &types,
+                                                    std::size_t limit);
+
+        // File còn tồn tại (không bị đánh dấu missing) thuộc các loại đã cho, kể cả chưa index
+        std::vector<IndexCandidate> getFiles(const std::vector<ResourceType> &types);
+
+        void clearChunks(sqlite3_int64 resourceId);
+        void insertChunk(sqlite3_int64 resourceId, const ChunkPosition &position,
+                         std::string_view text, std::optional<int> page = std::nullopt);
+
+        // Ghi lại hash đã index (kể cả khi lỗi để không thử lại liên tục đến khi file đổi)
+        void setIndexState(sqlite3_int64 resourceId, const std::optional<FileHash> &hash,
+                           int chunkCount, std::optional<std::string_view> error = std::nullopt);
+
+        // nullopt nếu chưa index hoặc lúc index resource chưa có hash
+        std::optional<FileHash> getIndexedHash(sqlite3_int64 resourceId);
+        [[nodiscard]] int chunkCount(sqlite3_int64 resourceId) const;
+
+        // Mỗi resource một kết quả (chunk khớp tốt nhất), kèm snippet ("p. N: ..." với PDF)
+        std::vector<std::pair<sqlite3_int64, std::string>>
+            searchFileContentFTS(std::string_view keyword);
+
+        // Như trên, kèm vị trí chỗ khớp (PDF: offset/dòng tính trong trang)
+        std::vector<ContentHit> searchFileContentHits(std::string_view keyword);
+        std::vector<ContentHit> searchFileContentHits(const RoutedQuery &query);
+
+    private:
+        SQLiteDB &m_db;
+};
@@ -1,3 +1,4 @@
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <sqlite3.h>
@@ -5,6 +6,7 @@
 #include <vector>
 #include <utility>
 #include "model.hpp"
+#include "row_view.hpp"
 #include "sqldb_raii.hpp"
 #include "file_repository.hpp"
 
@@ -81,6 +83,91 @@ void FileRepository::updateFile(sqlite3_int64 resourceId, std::string_view store
     }
 }
 
+void FileRepository::updateStoredPaths(
+    const std::vector<std::pair<std::string, std::string>> &renames) {
+    rewriteStoredPaths("UPDATE files SET stored_path = ?2 WHERE stored_path = ?1;", renames);
+}
+
+void FileRepository::relinkStoredFiles(
+    const std::vector<std::pair<std::string, std::string>> &renames) {
+    // So đúng phần đuôi "/<tên>" (hoặc "\<tên>"), không dùng LIKE vì LIKE bỏ qua hoa thường
+    // và coi '_' trong phần mở rộng là wildcard
+    rewriteStoredPaths("UPDATE files SET stored_path = ?2 WHERE is_managed = 1 AND "
+                       "(stored_path = ?1 OR substr(stored_path, -length(?1) - 1) "
+                       "IN ('/' || ?1, '\\' || ?1));",
+                       renames);
+}
+
+void FileRepository::rewriteStoredPaths(
+    const char* sql, const std::vector<std::pair<std::string, std::string>> &renames) {
+    if (renames.empty()) { return; }
+
+    const auto exec = [&](const char* statement) {
+        SQLiteStmt stmt(m_db.get(), statement);
+        if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+            throw std::runtime_error(std::string(statement) + " failed: " +
+                                     sqlite3_errmsg(m_db.get()));
+        }
+    };
+
+    exec("BEGIN TRANSACTION;");
+
+    try {
+        SQLiteStmt stmt(m_db.get(), sql);
+
+        for (const auto &[oldPath, newPath] : renames) {
+            sqlite3_reset(stmt.get());
+            sqlite3_bind_text(stmt.get(), 1, oldPath.data(), static_cast<int>(oldPath.size()),
+                              SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt.get(), 2, newPath.data(), static_cast<int>(newPath.size()),
+                              SQLITE_TRANSIENT);
+
+            if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+                throw std::runtime_error("Update stored path failed: " +
+                                         std::string(sqlite3_errmsg(m_db.get())));
+            }
+        }
+
+        exec("COMMIT;");
+    } catch (...) {
+        SQLiteStmt rollbackStmt(m_db.get(), "ROLLBACK;");
+        sqlite3_step(rollbackStmt.get());
+        throw;
+    }
+}
+
+std::vector<LinkedFileState> FileRepository::getLinkedFiles() {
+    SQLiteStmt stmt(m_db.get(), "SELECT f.resource_id, f.original_path, r.file_hash, "
+                                "f.missing_since IS NOT NULL FROM files f "
+                                "JOIN resources r ON r.id = f.resource_id WHERE f.is_managed = 0;");
+
+    std::vector<LinkedFileState> result;
+
+    for (const auto &[id, path, hash, missing] :
+         ResultSet<sqlite3_int64, std::string_view, std::optional<FileHash>, bool>(stmt)) {
+        result.push_back({.resource_id = id,
+                          .path = std::string(path),
+                          .file_hash = hash,
+                          .is_missing = missing});
+    }
+
+    return result;
+}
+
+void FileRepository::setMissing(sqlite3_int64 resourceId, bool missing) {
+    SQLiteStmt stmt(m_db.get(), missing ? "UPDATE files SET missing_since = COALESCE(missing_since, "
+                                          "CURRENT_TIMESTAMP) WHERE resource_id = ?;"
+                                        : "UPDATE files SET missing_since = NULL WHERE "
+                                          "resource_id = ?;");
+
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        std::string errMsg = sqlite3_errmsg(m_db.get());
+        throw std::runtime_error("Update missing state failed: " + errMsg);
+    }
+}
+
 std::optional<FileEntry> FileRepository::getFileById(sqlite_int64 resourceId) {
     SQLiteStmt stmt(m_db.get(), "SELECT resource_id, stored_path, original_path, is_managed FROM "
                                 "files WHERE resource_id = ?;");
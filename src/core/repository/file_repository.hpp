@@ -4,6 +4,8 @@
 #include <sqlite3.h>
 #include <optional>
 #include <vector>
+#include <string>
+#include <utility>
 #include "model.hpp"
 
 class SQLiteDB;
@@ -18,6 +20,18 @@ class FileRepository {
         void updateFile(sqlite3_int64 resourceId, std::string_view storedPath,
                         std::string_view originalPath, bool isManaged);
 
+        // Đổi stored_path hàng loạt (old -> new) trong một transaction
+        void updateStoredPaths(const std::vector<std::pair<std::string, std::string>> &renames);
+        // Như trên nhưng khớp file managed theo tên file (<hash><ext>) thay vì cả chuỗi đường
+        // dẫn: dòng cũ có thể ghi root theo cách khác ("resources/...", tuyệt đối, "./resources")
+        void relinkStoredFiles(const std::vector<std::pair<std::string, std::string>> &renames);
+
+        // File linked (is_managed = 0) kèm hash và trạng thái tombstone
+        std::vector<LinkedFileState> getLinkedFiles();
+
+        // Đánh dấu / bỏ đánh dấu file linked không còn tồn tại (giữ mốc thời gian đầu tiên)
+        void setMissing(sqlite3_int64 resourceId, bool missing);
+
         std::optional<FileEntry> getFileById(sqlite_int64 resourceId);
         std::vector<FileEntry> getAllFile();
 
@@ -27,5 +41,9 @@ class FileRepository {
         [[nodiscard]] bool exists(sqlite3_int64 resourceId) const;
 
     private:
+        // Mỗi cặp bind vào ?1 (old) và ?2 (new) của sql, tất cả trong một transaction
+        void rewriteStoredPaths(const char* sql,
+                                const std::vector<std::pair<std::string, std::string>> &renames);
+
         SQLiteDB &m_db;
 };
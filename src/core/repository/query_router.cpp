@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "code_tokenizer.hpp"
+#include "query_router.hpp"
+#include "term_dictionary.hpp"
+
+namespace {
+    // Độ dài tiền tố có prefix index (prefix = '2 3 4'), tính theo ký tự như FTS5
+    constexpr std::size_t kMinIndexedPrefix{2};
+    constexpr std::size_t kMaxIndexedPrefix{4};
+    // Tokenizer trigram cần ít nhất 3 ký tự để tra index
+    constexpr std::size_t kMinTrigramChars{3};
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    std::string_view trim(std::string_view text) {
+        while (!text.empty() && isSpace(text.front())) { text.remove_prefix(1); }
+        while (!text.empty() && isSpace(text.back())) { text.remove_suffix(1); }
+        return text;
+    }
+
+    std::string_view trimChars(std::string_view text, std::string_view chars) {
+        while (!text.empty() && chars.find(text.front()) != std::string_view::npos) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && chars.find(text.back()) != std::string_view::npos) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    // Số ký tự UTF-8 (không đếm byte nối tiếp)
+    std::size_t charCount(std::string_view text) {
+        return static_cast<std::size_t>(std::ranges::count_if(
+            text, [](char c) { return (static_cast<unsigned char>(c) & 0xC0U) != 0x80U; }));
+    }
+
+    std::string quoted(std::string_view text) {
+        std::string out{'"'};
+        for (const char c : text) {
+            if (c == '"') { out += '"'; }
+            out += c;
+        }
+        out += '"';
+        return out;
+    }
+
+    std::string likePattern(std::string_view needle) {
+        std::string out{'%'};
+        for (const char c : needle) {
+            if (c == '%' || c == '_' || c == '\\') { out += '\\'; }
+            out += c;
+        }
+        out += '%';
+        return out;
+    }
+
+    // FTS5 chỉ áp '*' cho token cuối của phrase, mà tokenizer "code" tách "getTa*" thành
+    // get, ta*: độ dài cần xét là của từ con cuối. Đoạn không phải ASCII tính nguyên đoạn
+    std::string_view lastWord(std::string_view stem) {
+        std::string_view last = stem;
+        forEachCodeToken(
+            stem, true,
+            [&](std::string_view, std::size_t begin, std::size_t end, bool) {
+                last = stem.substr(begin, end - begin);
+                return true;
+            },
+            [&](std::size_t begin, std::size_t end) {
+                last = stem.substr(begin, end - begin);
+                return true;
+            });
+        return last;
+    }
+
+    QueryPlan prefixPlan(std::size_t stemChars, const SearchCapabilities &caps) {
+        const bool indexed = stemChars >= kMinIndexedPrefix && stemChars <= kMaxIndexedPrefix;
+        return caps.prefixIndex && indexed ? QueryPlan::ftsPrefix : QueryPlan::ftsPrefixScan;
+    }
+
+    RoutedQuery routeSubstring(std::string_view needle, const SearchCapabilities &caps) {
+        const auto chars = charCount(needle);
+
+        if (caps.trigram && chars >= kMinTrigramChars) {
+            return {.plan = QueryPlan::trigram, .expression = quoted(needle)};
+        }
+        if (caps.likeScan) {
+            return {.plan = QueryPlan::likeScan, .expression = likePattern(needle)};
+        }
+
+        // Không có cách tìm chuỗi con: ít nhất tìm được token bắt đầu bằng needle
+        return {.plan = prefixPlan(chars, caps), .expression = quoted(needle) + '*'};
+    }
+
+    RoutedQuery routeFts(std::string_view keyword, const SearchCapabilities &caps) {
+        RoutedQuery routed{.plan = QueryPlan::ftsTerms, .expression = std::string(keyword)};
+
+        std::size_t pos{0};
+        while (pos < keyword.size()) {
+            while (pos < keyword.size() && isSpace(keyword[pos])) { ++pos; }
+            const auto start = pos;
+            while (pos < keyword.size() && !isSpace(keyword[pos])) { ++pos; }
+
+            const auto token = keyword.substr(start, pos - start);
+            if (!token.ends_with('*')) { continue; }
+
+            // Tiền tố không có index thì cả truy vấn phải quét dải term
+            const auto plan = prefixPlan(charCount(lastWord(trimChars(token, "*\"()^"))), caps);
+            if (routed.plan != QueryPlan::ftsPrefixScan) { routed.plan = plan; }
+        }
+
+        return routed;
+    }
+} // namespace
+
+std::string_view planName(QueryPlan plan) noexcept {
+    switch (plan) {
+        case QueryPlan::none: return "none";
+        case QueryPlan::ftsTerms: return "fts";
+        case QueryPlan::ftsPrefix: return "fts-prefix";
+        case QueryPlan::ftsPrefixScan: return "fts-prefix-scan";
+        case QueryPlan::trigram: return "trigram";
+        case QueryPlan::likeScan: return "like-scan";
+        case QueryPlan::ftsFuzzy: return "fts-fuzzy";
+    }
+    return "unknown";
+}
+
+std::string RoutedQuery::describe() const {
+    std::string text(planName(plan));
+    if (!expression.empty()) { text += ": " + expression; }
+    return text;
+}
+
+RoutedQuery routeQuery(std::string_view keyword, const SearchCapabilities &caps) {
+    keyword = trim(keyword);
+
+    if (keyword.starts_with('*')) {
+        const auto needle = trim(trimChars(keyword, "*"));
+        if (needle.empty()) { return {}; }
+        return routeSubstring(needle, caps);
+    }
+
+    if (keyword.empty()) { return {}; }
+    return routeFts(keyword, caps);
+}
+
+RoutedQuery routeFuzzyQuery(std::string_view keyword, const TermDictionary &dict,
+                            const FuzzyOptions &options) {
+    RoutedQuery routed{.plan = QueryPlan::ftsFuzzy, .expression = {}};
+    const auto append = [&](const std::string &group) {
+        // FTS5 chỉ nối ngầm bằng AND giữa các phrase, không giữa nhóm trong ngoặc
+        if (!routed.expression.empty()) { routed.expression += " AND "; }
+        routed.expression += group;
+    };
+
+    const auto text = trim(keyword);
+    forEachCodeToken(
+        text, true,
+        [&](std::string_view token, std::size_t, std::size_t, bool) {
+            // Chính từ khóa luôn có trong nhóm, kể cả khi không phải term của index
+            std::vector<std::string> terms{std::string(token)};
+            for (auto &match : dict.expand(token, options)) {
+                if (std::ranges::find(terms, match.term) == terms.end()) {
+                    terms.push_back(std::move(match.term));
+                }
+            }
+
+            std::string group = terms.size() > 1 ? "(" : "";
+            for (std::size_t i = 0; i < terms.size(); ++i) {
+                if (i > 0) { group += " OR "; }
+                group += quoted(terms[i]);
+            }
+            if (terms.size() > 1) { group += ')'; }
+            append(group);
+            return true;
+        },
+        [&](std::size_t begin, std::size_t end) {
+            append(quoted(text.substr(begin, end - begin)));
+            return true;
+        });
+
+    if (routed.expression.empty()) { routed.plan = QueryPlan::none; }
+    return routed;
+}
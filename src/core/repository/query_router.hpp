@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Cách chạy một truy vấn tìm kiếm, từ rẻ đến đắt
+enum class QueryPlan : std::uint8_t {
+    none,          // từ khóa rỗng
+    ftsTerms,      // FTS5 theo token
+    ftsPrefix,     // FTS5 "abc*" với độ dài tiền tố có prefix index (2..4 ký tự)
+    ftsPrefixScan, // FTS5 "abc*" không có prefix index tương ứng: quét dải term
+    trigram,       // chuỗi con qua bảng FTS5 tokenizer trigram
+    likeScan,      // chuỗi con bằng LIKE '%...%': quét toàn bảng
+    ftsFuzzy       // FTS5, mỗi từ mở rộng thành nhóm OR các term gần nó (gõ sai)
+};
+
+// Index mà bảng được tìm đang có (xem SearchIndexes)
+struct SearchCapabilities {
+        bool prefixIndex{}; // prefix = '2 3 4'
+        bool trigram{};     // bảng trigram song song
+        bool likeScan{};    // quét được bảng gốc bằng LIKE (chỉ title; nội dung có thể bị nén)
+};
+
+struct RoutedQuery {
+        QueryPlan plan{QueryPlan::none};
+        std::string expression; // biểu thức MATCH, hoặc mẫu LIKE (ESCAPE '\') với likeScan
+
+        // Dạng "trigram: \"Buffer\"" để báo cho người dùng
+        [[nodiscard]] std::string describe() const;
+};
+
+[[nodiscard]] std::string_view planName(QueryPlan plan) noexcept;
+
+// Chọn index rẻ nhất cho từ khóa người dùng gõ:
+//   *Buffer hoặc *Buffer*  -> tìm chuỗi con (trigram nếu có và >= 3 ký tự, không thì LIKE;
+//                             không quét được thì lùi về FTS prefix "Buffer"*)
+//   algo*                  -> FTS prefix, dùng prefix index khi tiền tố (từ con cuối) dài 2..4
+//   còn lại                -> FTS theo token, từ khóa giữ nguyên làm biểu thức MATCH
+[[nodiscard]] RoutedQuery routeQuery(std::string_view keyword, const SearchCapabilities &caps);
+
+class TermDictionary;
+
+// Giới hạn mở rộng một từ khóa thành các term gần nó (xem TermDictionary::expand)
+struct FuzzyOptions {
+        int maxDistance{-1};          // khoảng cách Levenshtein tối đa, < 0: theo độ dài từ
+        std::size_t maxExpansions{8}; // số term tối đa mỗi từ, ưu tiên gần hơn rồi phổ biến hơn
+        std::int64_t minDocs{1};      // bỏ term hiếm hơn (số chunk chứa term)
+};
+
+// Tìm khi có thể gõ sai: mỗi từ (tách như tokenizer "code") thành nhóm OR của các term trong
+// dict cách nó không quá maxDistance, vd "templete clas" ->
+//   ("templete" OR "template") AND ("clas" OR "class" OR "clash")
+// Đoạn không phải ASCII giữ nguyên (unicode61 tự tách khi MATCH)
+[[nodiscard]] RoutedQuery routeFuzzyQuery(std::string_view keyword, const TermDictionary &dict,
+                                          const FuzzyOptions &options = {});
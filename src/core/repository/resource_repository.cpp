@@ -1,22 +1,79 @@
 #include <stdexcept>
+#include <cstddef>
 #include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include <sqlite3.h>
 #include "resource_repository.hpp"
 #include "model.hpp"
+#include "query_router.hpp"
+#include "row_view.hpp"
+#include "search_result.hpp"
 #include "sqldb_raii.hpp"
 
+namespace {
+    // Cột: id, title, type, created_at, updated_at
+    using ResourceRows =
+        ResultSet<sqlite3_int64, std::string_view, ResourceType, Timestamp, Timestamp>;
+
+    // Cột: id, title, type, file_hash, created_at, updated_at
+    using HashedResourceRows = ResultSet<sqlite3_int64, std::string_view, ResourceType,
+                                         std::optional<FileHash>, Timestamp, Timestamp>;
+
+    // Câu truy vấn id có đúng 3 tham số: biểu thức tìm, LIMIT, OFFSET (limit nullopt = đến hết)
+    std::vector<sqlite3_int64> pagedIds(SQLiteDB &db, const char* sql, std::string_view arg,
+                                        std::size_t offset, std::optional<std::size_t> limit) {
+        SQLiteStmt stmt(db.get(), sql);
+
+        sqlite3_bind_text(stmt.get(), 1, arg.data(), static_cast<int>(arg.size()),
+                          SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt.get(), 2,
+                           limit.has_value() ? static_cast<sqlite3_int64>(*limit) : -1);
+        sqlite3_bind_int64(stmt.get(), 3, static_cast<sqlite3_int64>(offset));
+
+        std::vector<sqlite3_int64> ids;
+        for (const auto &[id] : ResultSet<sqlite3_int64>(stmt)) { ids.push_back(id); }
+
+        return ids;
+    }
+
+    Resource makeResource(const ResourceRows::value_type &row) {
+        const auto &[id, title, type, created, updated] = row;
+        return {.id = id,
+                .title = std::string(title),
+                .type = type,
+                .file_hash = std::nullopt,
+                .created_at = created,
+                .updated_at = updated};
+    }
+
+    Resource makeResource(const HashedResourceRows::value_type &row) {
+        const auto &[id, title, type, hash, created, updated] = row;
+        return {.id = id,
+                .title = std::string(title),
+                .type = type,
+                .file_hash = hash,
+                .created_at = created,
+                .updated_at = updated};
+    }
+} // namespace
+
 sqlite3_int64 ResourceRepository::insert(const Resource &res) {
     SQLiteStmt stmt(m_db.get(), "INSERT INTO resources (title, type, file_hash) VALUES (?, ?, ?);");
 
     sqlite3_bind_text(stmt.get(), 1, res.title.c_str(), -1, SQLITE_TRANSIENT);
 
-    const char* typeStr = resourceTypeToString(res.type);
-    sqlite3_bind_text(stmt.get(), 2, typeStr, -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt.get(), 2, resourceTypeCode(res.type));
 
-    if (res.type == ResourceType::text || res.file_hash.empty()) {
-        sqlite3_bind_null(stmt.get(), 3);
+    // Text note không có hash; file .txt thì có (để dedupe và index nội dung theo hash)
+    if (res.file_hash.has_value()) {
+        sqlite3_bind_blob(stmt.get(), 3, res.file_hash->data(),
+                          static_cast<int>(res.file_hash->size()), SQLITE_TRANSIENT);
     } else {
-        sqlite3_bind_text(stmt.get(), 3, res.file_hash.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_null(stmt.get(), 3);
     }
 
     if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
@@ -33,20 +90,7 @@ std::optional<Resource> ResourceRepository::getById(sqlite3_int64 resourceId) {
 
     sqlite3_bind_int64(stmt.get(), 1, resourceId);
 
-    if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        Resource res;
-
-        res.id = sqlite3_column_int64(stmt.get(), 0);
-        res.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
-
-        const char* typeText = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
-        res.type = resourceTypeFromString(typeText);
-
-        res.created_at = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 3));
-        res.updated_at = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 4));
-
-        return res;
-    }
+    if (auto row = ResourceRows(stmt).next()) { return makeResource(*row); }
 
     return std::nullopt;
 }
@@ -55,18 +99,7 @@ std::vector<Resource> ResourceRepository::getAll() {
     SQLiteStmt stmt(m_db.get(), "SELECT id, title, type, created_at, updated_at FROM resources;");
 
     std::vector<Resource> results;
-    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        Resource res;
-        res.id = sqlite3_column_int64(stmt.get(), 0);
-        res.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
-
-        const char* typeText = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
-        res.type = resourceTypeFromString(typeText);
-
-        res.created_at = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 3));
-        res.updated_at = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 4));
-        results.push_back(std::move(res));
-    }
+    for (const auto &row : ResourceRows(stmt)) { results.push_back(makeResource(row)); }
     return results;
 }
 
@@ -80,75 +113,112 @@ std::vector<Resource> ResourceRepository::searchByTitleFTS(std::string_view keyw
                       SQLITE_TRANSIENT);
 
     std::vector<Resource> result;
-    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        Resource res;
-        res.id = sqlite3_column_int64(stmt.get(), 0);
-        res.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+    for (const auto &row : HashedResourceRows(stmt)) { result.push_back(makeResource(row)); }
+
+    return result;
+}
 
-        const char* typeText = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
-        res.type = resourceTypeFromString(typeText);
+std::vector<sqlite3_int64> ResourceRepository::searchIdsByTitleFTS(std::string_view keyword,
+                                                               std::size_t offset,
+                                                               std::optional<std::size_t> limit) {
+    return pagedIds(m_db, "SELECT rowid FROM resources_fts WHERE resources_fts MATCH ? "
+                          "ORDER BY rowid LIMIT ? OFFSET ?;",
+                    keyword, offset, limit);
+}
+
+std::vector<sqlite3_int64> ResourceRepository::searchIdsByTitle(const RoutedQuery &query,
+                                                            std::size_t offset,
+                                                            std::optional<std::size_t> limit) {
+    switch (query.plan) {
+        case QueryPlan::none:
+            return {};
+        case QueryPlan::trigram:
+            return pagedIds(m_db, "SELECT rowid FROM resources_trigram WHERE resources_trigram "
+                                  "MATCH ? ORDER BY rowid LIMIT ? OFFSET ?;",
+                            query.expression, offset, limit);
+        case QueryPlan::likeScan:
+            return pagedIds(m_db, "SELECT id FROM resources WHERE title LIKE ? ESCAPE '\\' "
+                                  "ORDER BY id LIMIT ? OFFSET ?;",
+                            query.expression, offset, limit);
+        default:
+            return searchIdsByTitleFTS(query.expression, offset, limit);
+    }
+}
 
-        if (sqlite3_column_type(stmt.get(), 3) != SQLITE_NULL) {
-            res.file_hash = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 3));
-        }
+std::vector<std::pair<sqlite3_int64, std::string>>
+    ResourceRepository::searchTitlesFTS(std::string_view match, sqlite3_int64 minId,
+                                        sqlite3_int64 maxId, std::optional<std::size_t> limit) {
+    SQLiteStmt stmt(m_db.get(), "SELECT rowid, title FROM resources_fts WHERE resources_fts "
+                                "MATCH ? AND rowid BETWEEN ? AND ? ORDER BY rowid LIMIT ?;");
 
-        res.created_at = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 4));
-        res.updated_at = reinterpret_cast<const char*>(
-            sqlite3_column_text(stmt.get(), 5)); // NOLINT(readability-magic-numbers)
+    sqlite3_bind_text(stmt.get(), 1, match.data(), static_cast<int>(match.size()),
+                      SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt.get(), 2, minId);
+    sqlite3_bind_int64(stmt.get(), 3, maxId);
+    sqlite3_bind_int64(stmt.get(), 4, limit.has_value() ? static_cast<sqlite3_int64>(*limit) : -1);
 
-        result.push_back(std::move(res));
+    std::vector<std::pair<sqlite3_int64, std::string>> rows;
+    for (const auto &[id, title] : ResultSet<sqlite3_int64, std::string_view>(stmt)) {
+        rows.emplace_back(id, title);
     }
 
-    return result;
+    return rows;
 }
 
-std::optional<Resource> ResourceRepository::getByFileHash(std::string_view hash) {
-    SQLiteStmt stmt(m_db.get(), "SELECT id, title, type, file_hash, created_at, updated_at FROM "
-                                "resources WHERE file_hash = ?;");
+std::vector<sqlite3_int64> ResourceRepository::getIdsByType(ResourceType type) {
+    SQLiteStmt stmt(m_db.get(), "SELECT id FROM resources WHERE type = ? ORDER BY id;");
 
-    sqlite3_bind_text(stmt.get(), 1, hash.data(), static_cast<int>(hash.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt.get(), 1, resourceTypeCode(type));
 
-    if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        Resource res;
-        res.id = sqlite3_column_int64(stmt.get(), 0);
-        res.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+    std::vector<sqlite3_int64> ids;
+    for (const auto &[id] : ResultSet<sqlite3_int64>(stmt)) { ids.push_back(id); }
+
+    return ids;
+}
+
+sqlite3_int64 ResourceRepository::countByType(ResourceType type) {
+    SQLiteStmt stmt(m_db.get(), "SELECT COUNT(*) FROM resources WHERE type = ?;");
 
-        const char* typeText = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
-        res.type = resourceTypeFromString(typeText);
+    sqlite3_bind_int(stmt.get(), 1, resourceTypeCode(type));
 
-        if (sqlite3_column_type(stmt.get(), 3) != SQLITE_NULL) {
-            res.file_hash = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 3));
-        }
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) { return sqlite3_column_int64(stmt.get(), 0); }
+
+    throw std::runtime_error(std::string("Count resources by type failed: ") +
+                             sqlite3_errmsg(m_db.get()));
+}
 
-        res.created_at = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 4));
-        res.updated_at = reinterpret_cast<const char*>(
-            sqlite3_column_text(stmt.get(), 5)); // NOLINT(readability-magic-numbers)
+std::optional<ResourceType> ResourceRepository::getTypeById(sqlite3_int64 resourceId) {
+    SQLiteStmt stmt(m_db.get(), "SELECT type FROM resources WHERE id = ?;");
 
-        return res;
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        return resourceTypeFromCode(sqlite3_column_int64(stmt.get(), 0));
     }
 
     return std::nullopt;
 }
 
-std::optional<std::pair<std::string, std::string>>
+std::optional<Resource> ResourceRepository::getByFileHash(const FileHash &hash) {
+    SQLiteStmt stmt(m_db.get(), "SELECT id, title, type, file_hash, created_at, updated_at FROM "
+                                "resources WHERE file_hash = ?;");
+
+    sqlite3_bind_blob(stmt.get(), 1, hash.data(), static_cast<int>(hash.size()), SQLITE_TRANSIENT);
+
+    if (auto row = HashedResourceRows(stmt).next()) { return makeResource(*row); }
+
+    return std::nullopt;
+}
+
+std::optional<std::pair<Timestamp, Timestamp>>
     ResourceRepository::getTimestamps(sqlite3_int64 resourceID) {
     SQLiteStmt stmt(m_db.get(), "SELECT created_at, updated_at FROM resources WHERE id = ?;");
 
     sqlite3_bind_int64(stmt.get(), 1, resourceID);
 
     if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        std::string createdAt;
-        std::string updatedAt;
-
-        if (sqlite3_column_type(stmt.get(), 0) != SQLITE_NULL) {
-            createdAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
-        }
-
-        if (sqlite3_column_type(stmt.get(), 1) != SQLITE_NULL) {
-            updatedAt = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
-        }
-
-        return std::make_pair(std::move(createdAt), std::move(updatedAt));
+        return std::make_pair(timestampFromEpoch(sqlite3_column_int64(stmt.get(), 0)),
+                              timestampFromEpoch(sqlite3_column_int64(stmt.get(), 1)));
     }
 
     return std::nullopt;
@@ -156,10 +226,10 @@ std::optional<std::pair<std::string, std::string>>
 
 void ResourceRepository::update(const Resource &res) {
     SQLiteStmt stmt(m_db.get(), "UPDATE resources SET title = ?, type = ?, updated_at = "
-                                "CURRENT_TIMESTAMP WHERE id = ?;");
+                                "unixepoch() WHERE id = ?;");
 
     sqlite3_bind_text(stmt.get(), 1, res.title.c_str(), -1, SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt.get(), 2, resourceTypeToString(res.type), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt.get(), 2, resourceTypeCode(res.type));
     sqlite3_bind_int64(stmt.get(), 3, res.id);
 
     if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
@@ -179,10 +249,10 @@ void ResourceRepository::remove(sqlite3_int64 resourceId) {
     }
 }
 
-void ResourceRepository::updateFileHash(sqlite3_int64 resourceID, std::string_view hash) {
+void ResourceRepository::updateFileHash(sqlite3_int64 resourceID, const FileHash &hash) {
     SQLiteStmt stmt(m_db.get(), "UPDATE resources SET file_hash = ? WHERE id = ?;");
 
-    sqlite3_bind_text(stmt.get(), 1, hash.data(), static_cast<int>(hash.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_blob(stmt.get(), 1, hash.data(), static_cast<int>(hash.size()), SQLITE_TRANSIENT);
     sqlite3_bind_int64(stmt.get(), 2, resourceID);
 
     if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
@@ -198,9 +268,43 @@ bool ResourceRepository::existsTitle(std::string_view title, ResourceType type)
 
     sqlite3_bind_text(stmt.get(), 1, title.data(), static_cast<int>(title.size()),
                       SQLITE_TRANSIENT);
-    sqlite3_bind_text(stmt.get(), 2, resourceTypeToString(type), -1, SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt.get(), 2, resourceTypeCode(type));
 
     if (sqlite3_step(stmt.get()) == SQLITE_ROW) { return sqlite3_column_int(stmt.get(), 0) != 0; }
 
     return false;
 }
+
+void ResourceRepository::appendSearchEntries(std::span<const sqlite3_int64> ids,
+                                             SearchResult &out) {
+    // Text note không có path; file thiếu dòng files bị bỏ qua
+    SQLiteStmt resource(m_db.get(), R"SQL(
+        SELECT r.id, r.type, r.title,
+               CASE WHEN r.type = 0 THEN NULL ELSE COALESCE(f.stored_path, f.original_path) END,
+               r.created_at, r.updated_at
+        FROM resources r LEFT JOIN files f ON f.resource_id = r.id
+        WHERE r.id = ? AND (r.type = 0 OR f.resource_id IS NOT NULL);
+    )SQL");
+    SQLiteStmt tags(m_db.get(), "SELECT t.name FROM tags t JOIN resource_tags rt "
+                                "ON t.id = rt.tag_id WHERE rt.resource_id = ?;");
+
+    out.reserve(out.size() + ids.size());
+
+    for (const auto resourceId : ids) {
+        sqlite3_reset(resource.get());
+        sqlite3_bind_int64(resource.get(), 1, resourceId);
+
+        const auto row = ResultSet<sqlite3_int64, ResourceType, std::string_view,
+                                   std::optional<std::string_view>, Timestamp, Timestamp>(
+                             resource)
+                             .next();
+        if (!row.has_value()) { continue; }
+
+        const auto &[id, type, title, path, created, updated] = *row;
+        out.add(id, type, title, path, created, updated);
+
+        sqlite3_reset(tags.get());
+        sqlite3_bind_int64(tags.get(), 1, resourceId);
+        for (const auto &[tag] : ResultSet<std::string_view>(tags)) { out.addTag(tag); }
+    }
+}
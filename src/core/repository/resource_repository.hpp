@@ -1,12 +1,18 @@
 #pragma once
 
+#include <cstddef>
 #include <optional>
+#include <span>
+#include <string>
+#include <utility>
 #include <vector>
 #include <sqlite3.h>
 #include "sqldb_raii.hpp"
 #include "model.hpp"
 
 class SQLiteDB;
+class SearchResult;
+struct RoutedQuery;
 
 class ResourceRepository {
     public:
@@ -22,12 +28,33 @@ class ResourceRepository {
 
         std::vector<Resource> getAll();
         std::vector<Resource> searchByTitleFTS(std::string_view keyword);
-        std::optional<Resource> getByFileHash(std::string_view hash);
-        std::optional<std::pair<std::string, std::string>> getTimestamps(sqlite3_int64 resourceID);
+        // Phân trang theo rowid; limit nullopt = đến hết
+        std::vector<sqlite3_int64> searchIdsByTitleFTS(std::string_view keyword,
+                                                       std::size_t offset = 0,
+                                                       std::optional<std::size_t> limit = {});
+        // Theo kế hoạch của QueryRouter (FTS, trigram hoặc LIKE), cùng cách phân trang
+        std::vector<sqlite3_int64> searchIdsByTitle(const RoutedQuery &query,
+                                                    std::size_t offset = 0,
+                                                    std::optional<std::size_t> limit = {});
+        // (id, title) khớp FTS trong khoảng rowid [minId, maxId], theo rowid tăng dần
+        std::vector<std::pair<sqlite3_int64, std::string>>
+            searchTitlesFTS(std::string_view match, sqlite3_int64 minId, sqlite3_int64 maxId,
+                            std::optional<std::size_t> limit = {});
+        // Theo idx_resources_type: id tăng dần, đếm không đọc bảng
+        std::vector<sqlite3_int64> getIdsByType(ResourceType type);
+        [[nodiscard]] sqlite3_int64 countByType(ResourceType type);
+        [[nodiscard]] std::optional<ResourceType> getTypeById(sqlite3_int64 resourceId);
+        std::optional<Resource> getByFileHash(const FileHash &hash);
+        std::optional<std::pair<Timestamp, Timestamp>> getTimestamps(sqlite3_int64 resourceID);
 
-        void updateFileHash(sqlite3_int64 resourceID, std::string_view hash);
+        void updateFileHash(sqlite3_int64 resourceID, const FileHash &hash);
         [[nodiscard]] bool existsTitle(std::string_view title, ResourceType type) const;
 
+        // Thêm vào out các resource theo thứ tự ids, kèm path và tag; bỏ qua id không còn tồn
+        // tại và file mất dòng trong files (như ResourceService::getFullResource).
+        // Đọc thẳng từ dòng SQLite vào arena của out, không cấp phát theo từng dòng
+        void appendSearchEntries(std::span<const sqlite3_int64> ids, SearchResult &out);
+
     private:
         SQLiteDB &m_db;
 };
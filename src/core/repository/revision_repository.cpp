@@ -0,0 +1,282 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+#include <zlib.h>
+#include "revision_repository.hpp"
+#include "model.hpp"
+#include "sqldb_raii.hpp"
+#include "text_codec.hpp"
+#include "text_delta.hpp"
+
+namespace {
+    // Delta lớn hơn tỉ lệ này của text thì ghi snapshot luôn (note ngắn, viết lại gần hết)
+    constexpr std::size_t kMaxDeltaRatio{2};
+
+    std::int64_t checksum(std::string_view text) {
+        uLong crc = crc32(0L, Z_NULL, 0);
+        std::size_t pos{0};
+        while (pos < text.size()) {
+            const auto len = static_cast<uInt>(
+                std::min<std::size_t>(text.size() - pos, std::numeric_limits<uInt>::max()));
+            crc = crc32(crc, reinterpret_cast<const Bytef*>(text.data() + pos), len);
+            pos += len;
+        }
+        return static_cast<std::int64_t>(crc);
+    }
+
+    std::string_view columnBlob(sqlite3_stmt* stmt, int column) {
+        const auto* ptr = static_cast<const char*>(sqlite3_column_blob(stmt, column));
+        return {ptr, static_cast<std::size_t>(sqlite3_column_bytes(stmt, column))};
+    }
+
+    struct LatestRevision {
+            std::int64_t revision{};
+            std::int64_t depth{};
+            std::int64_t size{};
+            std::int64_t checksum{};
+    };
+} // namespace
+
+std::optional<std::int64_t> RevisionRepository::record(sqlite3_int64 resourceId,
+                                                       std::string_view previous,
+                                                       std::string_view text) {
+    if (text == previous) { return std::nullopt; }
+
+    std::optional<LatestRevision> latest;
+    {
+        SQLiteStmt stmt(m_db.get(), "SELECT revision, depth, size, checksum FROM text_revisions "
+                                    "WHERE resource_id = ? ORDER BY revision DESC LIMIT 1;");
+        sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+        if (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            latest = LatestRevision{.revision = sqlite3_column_int64(stmt.get(), 0),
+                                    .depth = sqlite3_column_int64(stmt.get(), 1),
+                                    .size = sqlite3_column_int64(stmt.get(), 2),
+                                    .checksum = sqlite3_column_int64(stmt.get(), 3)};
+        }
+    }
+
+    exec("SAVEPOINT text_revision_write;");
+
+    try {
+        // Lịch sử không kết thúc ở previous: ghi previous làm gốc cho delta
+        const bool chained = latest.has_value() &&
+                             latest->size == static_cast<std::int64_t>(previous.size()) &&
+                             latest->checksum == checksum(previous);
+        if (!chained) {
+            const std::int64_t revision = latest.has_value() ? latest->revision + 1 : 1;
+            insertRevision(resourceId, revision, 0, previous, TextCodec().compress(previous));
+            latest = LatestRevision{.revision = revision, .depth = 0};
+        }
+
+        const std::int64_t revision = latest->revision + 1;
+        bool written{false};
+
+        if (static_cast<std::size_t>(latest->depth) < m_policy.maxChainDepth) {
+            const auto delta = TextDelta::make(previous, text);
+            if (delta.size() * kMaxDeltaRatio < text.size()) {
+                insertRevision(resourceId, revision, latest->depth + 1, text, delta);
+                written = true;
+            }
+        }
+
+        if (!written) { insertRevision(resourceId, revision, 0, text, TextCodec().compress(text)); }
+
+        exec("RELEASE text_revision_write;");
+        return revision;
+
+    } catch (...) {
+        exec("ROLLBACK TO text_revision_write;");
+        exec("RELEASE text_revision_write;");
+        throw;
+    }
+}
+
+std::vector<RevisionInfo> RevisionRepository::getRevisions(sqlite3_int64 resourceId) {
+    SQLiteStmt stmt(m_db.get(), "SELECT revision, created_at, depth, size, length(data) "
+                                "FROM text_revisions WHERE resource_id = ? ORDER BY revision;");
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+    std::vector<RevisionInfo> revisions;
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        const auto* created = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+
+        revisions.push_back({.revision = sqlite3_column_int64(stmt.get(), 0),
+                             .created_at = created != nullptr ? created : "",
+                             .is_snapshot = sqlite3_column_int64(stmt.get(), 2) == 0,
+                             .size = sqlite3_column_int64(stmt.get(), 3),
+                             .stored_size = sqlite3_column_int64(stmt.get(), 4)});
+    }
+
+    return revisions;
+}
+
+std::optional<std::string> RevisionRepository::getRevisionText(sqlite3_int64 resourceId,
+                                                               std::int64_t revision) {
+    // Snapshot gần nhất tính từ revision trở về trước, cùng các delta nối sau nó
+    SQLiteStmt stmt(m_db.get(), R"SQL(
+        SELECT revision, depth, checksum, data FROM text_revisions
+        WHERE resource_id = ?1 AND revision <= ?2
+          AND revision >= (SELECT MAX(revision) FROM text_revisions
+                           WHERE resource_id = ?1 AND revision <= ?2 AND depth = 0)
+        ORDER BY revision;
+    )SQL");
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+    sqlite3_bind_int64(stmt.get(), 2, revision);
+
+    std::optional<std::string> text;
+    std::int64_t last{};
+    std::int64_t expected{};
+
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        const auto data = columnBlob(stmt.get(), 3);
+
+        if (!text.has_value()) {
+            if (sqlite3_column_int64(stmt.get(), 1) != 0) {
+                throw std::runtime_error("Revision chain has no snapshot");
+            }
+            text = TextCodec().decompress(data);
+        } else {
+            text = TextDelta::apply(*text, data);
+        }
+
+        last = sqlite3_column_int64(stmt.get(), 0);
+        expected = sqlite3_column_int64(stmt.get(), 2);
+    }
+
+    if (!text.has_value() || last != revision) { return std::nullopt; }
+
+    if (checksum(*text) != expected) {
+        throw std::runtime_error("Revision " + std::to_string(revision) + " of resource " +
+                                 std::to_string(resourceId) + " failed its checksum");
+    }
+
+    return text;
+}
+
+std::vector<sqlite3_int64> RevisionRepository::getNotesToCompact(std::size_t limit) {
+    SQLiteStmt stmt(m_db.get(), "SELECT resource_id FROM text_revisions GROUP BY resource_id "
+                                "HAVING COUNT(*) > ? LIMIT ?;");
+    sqlite3_bind_int64(stmt.get(), 1, static_cast<sqlite3_int64>(m_policy.keepRevisions));
+    sqlite3_bind_int64(stmt.get(), 2, static_cast<sqlite3_int64>(limit));
+
+    std::vector<sqlite3_int64> ids;
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        ids.push_back(sqlite3_column_int64(stmt.get(), 0));
+    }
+
+    return ids;
+}
+
+std::size_t RevisionRepository::compact(sqlite3_int64 resourceId) {
+    if (m_policy.keepRevisions == 0) {
+        throw std::invalid_argument("RevisionPolicy must keep at least one revision");
+    }
+
+    // Phiên bản cũ nhất được giữ lại
+    std::int64_t oldest{};
+    std::int64_t depth{};
+    {
+        SQLiteStmt stmt(m_db.get(), "SELECT revision, depth FROM text_revisions "
+                                    "WHERE resource_id = ? ORDER BY revision DESC "
+                                    "LIMIT 1 OFFSET ?;");
+        sqlite3_bind_int64(stmt.get(), 1, resourceId);
+        sqlite3_bind_int64(stmt.get(), 2, static_cast<sqlite3_int64>(m_policy.keepRevisions - 1));
+
+        if (sqlite3_step(stmt.get()) != SQLITE_ROW) { return 0; }
+
+        oldest = sqlite3_column_int64(stmt.get(), 0);
+        depth = sqlite3_column_int64(stmt.get(), 1);
+    }
+
+    exec("SAVEPOINT text_revision_compact;");
+
+    try {
+        if (depth > 0) {
+            const auto text = getRevisionText(resourceId, oldest);
+            if (!text.has_value()) { throw std::runtime_error("Revision chain is broken"); }
+
+            const auto data = TextCodec().compress(*text);
+            SQLiteStmt snapshot(m_db.get(), "UPDATE text_revisions SET depth = 0, data = ? "
+                                            "WHERE resource_id = ? AND revision = ?;");
+            sqlite3_bind_blob(snapshot.get(), 1, data.data(), static_cast<int>(data.size()),
+                              SQLITE_TRANSIENT);
+            sqlite3_bind_int64(snapshot.get(), 2, resourceId);
+            sqlite3_bind_int64(snapshot.get(), 3, oldest);
+            if (sqlite3_step(snapshot.get()) != SQLITE_DONE) {
+                throw std::runtime_error(std::string("Compact revisions failed: ") +
+                                         sqlite3_errmsg(m_db.get()));
+            }
+
+            // Các delta nối sau nó (đến snapshot kế tiếp) giờ bắt đầu từ snapshot mới
+            SQLiteStmt rebase(m_db.get(), R"SQL(
+                UPDATE text_revisions SET depth = depth - ?3
+                WHERE resource_id = ?1 AND revision > ?2 AND depth > 0
+                  AND revision < COALESCE((SELECT MIN(revision) FROM text_revisions
+                                           WHERE resource_id = ?1 AND revision > ?2
+                                             AND depth = 0),
+                                          9223372036854775807);
+            )SQL");
+            sqlite3_bind_int64(rebase.get(), 1, resourceId);
+            sqlite3_bind_int64(rebase.get(), 2, oldest);
+            sqlite3_bind_int64(rebase.get(), 3, depth);
+            if (sqlite3_step(rebase.get()) != SQLITE_DONE) {
+                throw std::runtime_error(std::string("Compact revisions failed: ") +
+                                         sqlite3_errmsg(m_db.get()));
+            }
+        }
+
+        SQLiteStmt prune(m_db.get(), "DELETE FROM text_revisions "
+                                     "WHERE resource_id = ? AND revision < ?;");
+        sqlite3_bind_int64(prune.get(), 1, resourceId);
+        sqlite3_bind_int64(prune.get(), 2, oldest);
+        if (sqlite3_step(prune.get()) != SQLITE_DONE) {
+            throw std::runtime_error(std::string("Compact revisions failed: ") +
+                                     sqlite3_errmsg(m_db.get()));
+        }
+        const auto removed = static_cast<std::size_t>(sqlite3_changes(m_db.get()));
+
+        exec("RELEASE text_revision_compact;");
+        return removed;
+
+    } catch (...) {
+        exec("ROLLBACK TO text_revision_compact;");
+        exec("RELEASE text_revision_compact;");
+        throw;
+    }
+}
+
+void RevisionRepository::exec(const char* sql) {
+    SQLiteStmt stmt(m_db.get(), sql);
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Revision write failed: ") +
+                                 sqlite3_errmsg(m_db.get()));
+    }
+}
+
+void RevisionRepository::insertRevision(sqlite3_int64 resourceId, std::int64_t revision,
+                                        std::int64_t depth, std::string_view text,
+                                        std::string_view data) {
+    SQLiteStmt stmt(m_db.get(), "INSERT INTO text_revisions(resource_id, revision, depth, size, "
+                                "checksum, data) VALUES (?, ?, ?, ?, ?, ?);");
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+    sqlite3_bind_int64(stmt.get(), 2, revision);
+    sqlite3_bind_int64(stmt.get(), 3, depth);
+    sqlite3_bind_int64(stmt.get(), 4, static_cast<sqlite3_int64>(text.size()));
+    sqlite3_bind_int64(stmt.get(), 5, checksum(text));
+    sqlite3_bind_blob(stmt.get(), 6, data.data(), static_cast<int>(data.size()),
+                      SQLITE_TRANSIENT);
+
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        std::string erroMSG = sqlite3_errmsg(m_db.get());
+        throw std::runtime_error("Insert revision failed for resource ID: " +
+                                 std::to_string(resourceId) + " Error: " + erroMSG);
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+#include "model.hpp"
+
+class SQLiteDB;
+
+struct RevisionPolicy {
+        std::size_t maxChainDepth{16};  // số delta tối đa nối sau một snapshot
+        std::size_t keepRevisions{100}; // số phiên bản mỗi note còn lại sau compact
+};
+
+// Lịch sử text note trong text_revisions: mỗi lần sửa ghi một delta (TextDelta) so với phiên bản
+// ngay trước, sau tối đa maxChainDepth delta thì ghi một snapshot nén. Dựng lại một phiên bản chỉ
+// cần snapshot gần nhất phía trước nó và không quá maxChainDepth delta.
+// Bảng lịch sử tách khỏi text_content/text_chunks: ghi thêm một dòng nhỏ mỗi lần sửa, chỉ đọc khi
+// xem lịch sử hoặc compact.
+class RevisionRepository {
+    public:
+        using Policy = RevisionPolicy;
+
+        explicit RevisionRepository(SQLiteDB &db, Policy policy = RevisionPolicy{}) noexcept
+            : m_db(db), m_policy(policy) {}
+
+        [[nodiscard]] const Policy &policy() const noexcept { return m_policy; }
+
+        // Ghi phiên bản text; previous là nội dung trước khi sửa, được ghi làm snapshot nếu
+        // lịch sử chưa có nó (note cũ, hoặc lần sửa trước không được ghi).
+        // Trả về số phiên bản của text, nullopt nếu text không đổi
+        std::optional<std::int64_t> record(sqlite3_int64 resourceId, std::string_view previous,
+                                           std::string_view text);
+
+        // Cũ nhất trước
+        std::vector<RevisionInfo> getRevisions(sqlite3_int64 resourceId);
+
+        std::optional<std::string> getRevisionText(sqlite3_int64 resourceId,
+                                                   std::int64_t revision);
+
+        // Note có nhiều hơn keepRevisions phiên bản
+        std::vector<sqlite3_int64> getNotesToCompact(std::size_t limit);
+
+        // Xóa các phiên bản cũ vượt keepRevisions; phiên bản cũ nhất còn lại được ghi thành
+        // snapshot để chuỗi delta phía sau không trỏ vào dòng đã xóa.
+        // Trả về số phiên bản đã xóa
+        std::size_t compact(sqlite3_int64 resourceId);
+
+    private:
+        SQLiteDB &m_db;
+        Policy m_policy;
+
+        void exec(const char* sql);
+        void insertRevision(sqlite3_int64 resourceId, std::int64_t revision, std::int64_t depth,
+                            std::string_view text, std::string_view data);
+};
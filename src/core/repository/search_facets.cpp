@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "model.hpp"
+#include "row_view.hpp"
+#include "search_facets.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    // Tra một id đi qua vài trang B-tree, quét thì mỗi dòng một lần: tra từng id khi số id nhân
+    // hệ số này vẫn nhỏ hơn khoảng id phải quét
+    constexpr sqlite3_int64 kProbeCost{8};
+
+    constexpr std::size_t kTypeCount{
+        static_cast<std::size_t>(resourceTypeCode(ResourceType::epub)) + 1};
+
+    // Mỗi resource một hoặc nhiều dòng liền nhau (một dòng mỗi tag, tag NULL nếu không có)
+    constexpr const char* kFacetColumns{
+        "SELECT r.id, r.type, rt.tag_id FROM resources r "
+        "LEFT JOIN resource_tags rt ON rt.resource_id = r.id "};
+
+    using TagCounts = std::unordered_map<sqlite3_int64, std::size_t>;
+
+    struct Tally {
+            std::size_t total{};
+            std::array<std::size_t, kTypeCount> types{};
+            TagCounts tags;
+            std::optional<sqlite3_int64> last;
+
+            void add(sqlite3_int64 id, ResourceType type, std::optional<sqlite3_int64> tag) {
+                if (last != id) {
+                    last = id;
+                    ++total;
+                    ++types[static_cast<std::size_t>(resourceTypeCode(type))];
+                }
+                if (tag.has_value()) { ++tags[*tag]; }
+            }
+    };
+
+    using FacetRows = ResultSet<sqlite3_int64, ResourceType, std::optional<sqlite3_int64>>;
+
+    void probe(SQLiteDB &db, std::span<const sqlite3_int64> ids, Tally &tally) {
+        SQLiteStmt stmt(db.get(), std::string(kFacetColumns) + "WHERE r.id = ?;");
+
+        for (const auto id : ids) {
+            sqlite3_reset(stmt.get());
+            sqlite3_bind_int64(stmt.get(), 1, id);
+            for (const auto &[rowId, type, tag] : FacetRows(stmt)) { tally.add(rowId, type, tag); }
+        }
+    }
+
+    void scan(SQLiteDB &db, std::span<const sqlite3_int64> ids, Tally &tally) {
+        SQLiteStmt stmt(db.get(), std::string(kFacetColumns) +
+                                      "WHERE r.id BETWEEN ? AND ? ORDER BY r.id;");
+        sqlite3_bind_int64(stmt.get(), 1, ids.front());
+        sqlite3_bind_int64(stmt.get(), 2, ids.back());
+
+        auto next = ids.begin();
+        for (const auto &[rowId, type, tag] : FacetRows(stmt)) {
+            while (next != ids.end() && *next < rowId) { ++next; }
+            if (next == ids.end()) { break; }
+            if (*next == rowId) { tally.add(rowId, type, tag); }
+        }
+    }
+
+    std::vector<FacetCount> topTagCounts(SQLiteDB &db, const TagCounts &counts,
+                                         std::size_t topTags) {
+        std::vector<std::pair<sqlite3_int64, std::size_t>> ranked(counts.begin(), counts.end());
+        const auto top = std::min(topTags, ranked.size());
+        std::partial_sort(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(top),
+                          ranked.end(), [](const auto &a, const auto &b) {
+                              return a.second != b.second ? a.second > b.second : a.first < b.first;
+                          });
+        ranked.resize(top);
+
+        // Chỉ đọc tên của các tag được giữ lại
+        SQLiteStmt stmt(db.get(), "SELECT name FROM tags WHERE id = ?;");
+        std::vector<FacetCount> tags;
+        tags.reserve(ranked.size());
+        for (const auto &[tagId, count] : ranked) {
+            sqlite3_reset(stmt.get());
+            sqlite3_bind_int64(stmt.get(), 1, tagId);
+            for (const auto &[name] : ResultSet<std::string>(stmt)) {
+                tags.push_back({.name = name, .count = count});
+            }
+        }
+
+        std::ranges::sort(tags, [](const FacetCount &a, const FacetCount &b) {
+            return a.count != b.count ? a.count > b.count : a.name < b.name;
+        });
+        return tags;
+    }
+} // namespace
+
+SearchFacets countSearchFacets(SQLiteDB &db, std::span<const sqlite3_int64> ids,
+                               std::size_t topTags) {
+    std::vector<sqlite3_int64> sorted(ids.begin(), ids.end());
+    std::ranges::sort(sorted);
+    const auto [first, last] = std::ranges::unique(sorted);
+    sorted.erase(first, last);
+
+    SearchFacets facets;
+    if (sorted.empty()) { return facets; }
+
+    Tally tally;
+    const auto span = sorted.back() - sorted.front() + 1;
+    if (static_cast<sqlite3_int64>(sorted.size()) * kProbeCost < span) {
+        probe(db, sorted, tally);
+    } else {
+        scan(db, sorted, tally);
+    }
+
+    facets.total = tally.total;
+    for (std::size_t code = 0; code < kTypeCount; ++code) {
+        if (tally.types[code] == 0) { continue; }
+        facets.types.push_back(
+            {.name = resourceTypeToString(resourceTypeFromCode(static_cast<std::int64_t>(code))),
+             .count = tally.types[code]});
+    }
+    if (topTags > 0) { facets.tags = topTagCounts(db, tally.tags, topTags); }
+
+    return facets;
+}
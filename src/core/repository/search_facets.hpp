@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+
+class SQLiteDB;
+
+struct FacetCount {
+        std::string name;
+        std::size_t count{};
+};
+
+// Số resource theo tag và theo type của một tập kết quả, để lọc tiếp (vd thêm tag:cpp)
+struct SearchFacets {
+        std::size_t total{};           // số resource còn tồn tại trong tập, id trùng tính một lần
+        std::vector<FacetCount> tags;  // tối đa topTags tag, count giảm dần rồi theo tên
+        std::vector<FacetCount> types; // type có ít nhất một resource, theo thứ tự ResourceType
+};
+
+// Đếm cả hai facet trong một lượt đọc resources LEFT JOIN resource_tags (index theo
+// resource_id) trên đúng các id của tập, không query lại theo từng facet. Tập thưa so với
+// khoảng [min, max] của nó thì tra từng id, dày thì quét khoảng đó một lần theo id và merge với
+// ids đã sắp. Tag bằng count ở ranh giới topTags được chọn theo id tag; topTags = 0 bỏ qua tag.
+[[nodiscard]] SearchFacets countSearchFacets(SQLiteDB &db, std::span<const sqlite3_int64> ids,
+                                             std::size_t topTags);
@@ -0,0 +1,121 @@
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <sqlite3.h>
+#include "search_indexes.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    // Bảng chunk có thể có trigram song song (bảng <chunks>_trigram)
+    constexpr std::array<std::string_view, 2> kChunkTables{"text_chunks", "file_chunks"};
+
+    // text_chunks không lưu text: trigram đọc chunk qua view như text_chunks_fts
+    std::string contentSource(const std::string &chunks) {
+        return chunks == "text_chunks" ? "text_chunk_texts" : chunks;
+    }
+
+    std::string createTrigramSql(const std::string &chunks) {
+        const std::string trigram = chunks + "_trigram";
+        const std::string source = contentSource(chunks);
+        std::string sql =
+            "CREATE VIRTUAL TABLE " + trigram + " USING fts5(content, content = '" + source +
+            "', content_rowid = 'id', tokenize = 'trigram');"
+
+            "CREATE TRIGGER " + trigram + "_insert AFTER INSERT ON " + chunks + " BEGIN "
+            "INSERT INTO " + trigram + " (rowid, content) "
+            "SELECT id, content FROM " + source + " WHERE id = new.id; END;"
+
+            // BEFORE: chunk (và với view, nội dung note) vẫn còn để đọc lại text đã index
+            "CREATE TRIGGER " + trigram + "_delete BEFORE DELETE ON " + chunks + " BEGIN "
+            "INSERT INTO " + trigram + " (" + trigram + ", rowid, content) "
+            "SELECT 'delete', id, content FROM " + source + " WHERE id = old.id; END;";
+
+        if (source == chunks) {
+            sql += "CREATE TRIGGER " + trigram + "_update AFTER UPDATE OF content ON " + chunks +
+                   " BEGIN INSERT INTO " + trigram + " (" + trigram + ", rowid, content) "
+                   "VALUES ('delete', old.id, old.content); "
+                   "INSERT INTO " + trigram + " (rowid, content) VALUES (new.id, new.content); "
+                   "END;";
+        }
+
+        return sql + "INSERT INTO " + trigram + " (" + trigram + ") VALUES ('rebuild');";
+    }
+
+    std::string dropTrigramSql(const std::string &chunks) {
+        const std::string trigram = chunks + "_trigram";
+        return "DROP TRIGGER IF EXISTS " + trigram + "_insert;"
+               "DROP TRIGGER IF EXISTS " + trigram + "_delete;"
+               "DROP TRIGGER IF EXISTS " + trigram + "_update;"
+               "DROP TABLE IF EXISTS " + trigram + ";";
+    }
+} // namespace
+
+SearchCapabilities SearchIndexes::titleCapabilities() const {
+    return {.prefixIndex = hasPrefixIndex("resources_fts"),
+            .trigram = hasTable("resources_trigram"),
+            .likeScan = true};
+}
+
+SearchCapabilities SearchIndexes::contentCapabilities() const {
+    // Nội dung note có thể bị nén (BLOB) nên không LIKE thẳng trên bảng gốc được
+    return {.prefixIndex = hasPrefixIndex("text_chunks_fts"),
+            .trigram = contentTrigramEnabled(),
+            .likeScan = false};
+}
+
+bool SearchIndexes::contentTrigramEnabled() const {
+    for (const auto chunks : kChunkTables) {
+        if (hasTable(chunks) && !hasTable(std::string(chunks) + "_trigram")) { return false; }
+    }
+    return hasTable("text_chunks_trigram");
+}
+
+bool SearchIndexes::setContentTrigram(bool enabled) {
+    std::string sql;
+    for (const auto chunks : kChunkTables) {
+        const std::string table(chunks);
+        const bool exists = hasTable(table + "_trigram");
+
+        if (enabled && !exists && hasTable(table)) { sql += createTrigramSql(table); }
+        if (!enabled && exists) { sql += dropTrigramSql(table); }
+    }
+    if (sql.empty()) { return false; }
+
+    execScript("SAVEPOINT search_indexes;");
+    try {
+        execScript(sql);
+        execScript("RELEASE search_indexes;");
+        // Cách tìm nội dung (routeContentQuery) đổi theo: kết quả đã cache không còn đúng
+        m_db.generations().bump(WriteGenerations::kSchema);
+    } catch (...) {
+        execScript("ROLLBACK TO search_indexes; RELEASE search_indexes;");
+        throw;
+    }
+
+    return true;
+}
+
+bool SearchIndexes::hasTable(std::string_view name) const {
+    SQLiteStmt stmt(m_db.get(), "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?;");
+    sqlite3_bind_text(stmt.get(), 1, name.data(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+
+    return sqlite3_step(stmt.get()) == SQLITE_ROW;
+}
+
+bool SearchIndexes::hasPrefixIndex(std::string_view fts) const {
+    SQLiteStmt stmt(m_db.get(), "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ? "
+                                "AND sql LIKE '%prefix%';");
+    sqlite3_bind_text(stmt.get(), 1, fts.data(), static_cast<int>(fts.size()), SQLITE_TRANSIENT);
+
+    return sqlite3_step(stmt.get()) == SQLITE_ROW;
+}
+
+void SearchIndexes::execScript(const std::string &sql) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(m_db.get(), sql.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        std::string msg = errMsg != nullptr ? errMsg : "unknown";
+        sqlite3_free(errMsg);
+        throw std::runtime_error("Update search indexes failed: " + msg);
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include "query_router.hpp"
+
+class SQLiteDB;
+
+// Index phụ cho tìm kiếm. Prefix index (prefix = '2 3 4') của resources_fts, text_chunks_fts,
+// file_chunks_fts và bảng trigram của title được tạo ở schema v10. Trigram cho nội dung
+// (text_chunks_trigram, file_chunks_trigram) tốn thêm vài lần dung lượng text nên chỉ tạo khi
+// bật trong settings; trigger giữ chúng khớp với bảng chunk như các bảng FTS khác
+// (text_chunks_trigram đọc chunk qua view text_chunk_texts).
+class SearchIndexes {
+    public:
+        explicit SearchIndexes(SQLiteDB &db) noexcept : m_db(db) {}
+
+        [[nodiscard]] SearchCapabilities titleCapabilities() const;
+        [[nodiscard]] SearchCapabilities contentCapabilities() const;
+
+        [[nodiscard]] bool contentTrigramEnabled() const;
+
+        // Tạo (nạp lại từ bảng chunk) hoặc xóa trigram của nội dung trong một savepoint.
+        // Trả về true nếu schema có thay đổi
+        bool setContentTrigram(bool enabled);
+
+    private:
+        [[nodiscard]] bool hasTable(std::string_view name) const;
+        [[nodiscard]] bool hasPrefixIndex(std::string_view fts) const;
+        void execScript(const std::string &sql);
+
+        SQLiteDB &m_db;
+};
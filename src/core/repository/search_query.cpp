@@ -0,0 +1,106 @@
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "model.hpp"
+#include "search_query.hpp"
+
+namespace {
+    constexpr std::array<std::pair<std::string_view, SearchField>, 4> kFields{{
+        {"title", SearchField::title},
+        {"content", SearchField::content},
+        {"tag", SearchField::tag},
+        {"type", SearchField::type},
+    }};
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    std::optional<SearchField> fieldOf(std::string_view name) {
+        for (const auto &[fieldName, field] : kFields) {
+            if (fieldName == name) { return field; }
+        }
+        return std::nullopt;
+    }
+
+    // Token tới dấu cách đầu tiên nằm ngoài cặp "..." ("" bên trong là một dấu ", như FTS5)
+    std::string_view nextToken(std::string_view text, std::size_t &pos) {
+        while (pos < text.size() && isSpace(text[pos])) { ++pos; }
+
+        const auto start = pos;
+        bool inQuote{false};
+        while (pos < text.size() && (inQuote || !isSpace(text[pos]))) {
+            if (text[pos] == '"') { inQuote = !inQuote; }
+            ++pos;
+        }
+        if (inQuote) { throw std::runtime_error("Unterminated quote in search query"); }
+
+        return text.substr(start, pos - start);
+    }
+
+    std::string unquoted(std::string_view value) {
+        if (value.size() < 2 || value.front() != '"' || value.back() != '"') {
+            return std::string(value);
+        }
+
+        value = value.substr(1, value.size() - 2);
+        std::string out;
+        for (std::size_t i = 0; i < value.size(); ++i) {
+            out += value[i];
+            if (value[i] == '"') { ++i; }
+        }
+        return out;
+    }
+} // namespace
+
+std::string_view searchFieldName(SearchField field) noexcept {
+    for (const auto &[name, value] : kFields) {
+        if (value == field) { return name; }
+    }
+    return "unknown";
+}
+
+SearchQuery parseSearchQuery(std::string_view text) {
+    SearchQuery query;
+    std::string bare;
+    std::size_t barePos{0};
+
+    std::size_t pos{0};
+    for (auto token = nextToken(text, pos); !token.empty(); token = nextToken(text, pos)) {
+        const auto colon = token.find(':');
+        const auto field =
+            colon == std::string_view::npos ? std::nullopt : fieldOf(token.substr(0, colon));
+
+        if (!field.has_value()) {
+            if (bare.empty()) {
+                barePos = query.terms.size();
+            } else {
+                bare += ' ';
+            }
+            bare += token;
+            continue;
+        }
+
+        const auto raw = token.substr(colon + 1);
+        const bool keyword = *field == SearchField::title || *field == SearchField::content;
+        SearchTerm term{.field = *field, .value = keyword ? std::string(raw) : unquoted(raw)};
+        if (term.value.empty() || term.value == "\"\"") {
+            throw std::runtime_error("Missing value for " + std::string(token));
+        }
+        if (term.field == SearchField::type) { (void)resourceTypeFromString(term.value); }
+
+        query.terms.push_back(std::move(term));
+        query.fielded = true;
+    }
+
+    if (!bare.empty()) {
+        query.terms.insert(query.terms.begin() + static_cast<std::ptrdiff_t>(barePos),
+                           {.field = SearchField::title, .value = std::move(bare)});
+    }
+
+    return query;
+}
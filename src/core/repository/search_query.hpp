@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+#include "model.hpp"
+#include "search_facets.hpp"
+
+// Trường của một điều kiện trong truy vấn nhiều điều kiện
+enum class SearchField : std::uint8_t { title, content, tag, type };
+
+struct SearchTerm {
+        SearchField field{SearchField::title};
+        std::string value; // title/content: cú pháp của QueryRouter; tag: tên tag; type: "cpp"...
+};
+
+// Truy vấn dạng "tag:cpp type:text content:mutex", các điều kiện nối bằng AND:
+//   field:value hoặc field:"có dấu cách" với field là title, content, tag, type
+//   từ không có field (hoặc field lạ, vd std::vector) gộp lại thành một điều kiện title
+// Với title/content dấu " được giữ nguyên (phrase của FTS5), với tag/type thì bỏ đi
+struct SearchQuery {
+        std::vector<SearchTerm> terms;
+        bool fielded{}; // có ít nhất một field tường minh
+};
+
+// Kết quả của ResourceService::searchQuery
+struct QueryMatches {
+        std::vector<sqlite3_int64> ids; // theo rank của điều kiện content đầu tiên, không thì id
+        std::vector<ContentHit> hits;   // cùng thứ tự ids nếu có điều kiện content, không thì rỗng
+        std::string plan; // các bước theo thứ tự đã chạy, vd "tag:cpp(3) > content:mutex(1)"
+        std::optional<SearchFacets> facets; // của cả tập ids, chỉ khi được yêu cầu
+};
+
+[[nodiscard]] std::string_view searchFieldName(SearchField field) noexcept;
+
+// Ném std::runtime_error nếu field không có giá trị, thiếu dấu " đóng hoặc type không hợp lệ
+[[nodiscard]] SearchQuery parseSearchQuery(std::string_view text);
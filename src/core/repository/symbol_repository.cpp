@@ -0,0 +1,90 @@
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+#include "symbol_repository.hpp"
+#include "model.hpp"
+#include "row_view.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    std::vector<Symbol> readSymbols(SQLiteStmt &stmt) {
+        std::vector<Symbol> result;
+        for (const auto &[resourceId, kind, name, line] :
+             ResultSet<sqlite3_int64, SymbolKind, std::string_view, int>(stmt)) {
+            result.push_back(
+                {.resource_id = resourceId, .kind = kind, .name = std::string(name), .line = line});
+        }
+        return result;
+    }
+} // namespace
+
+void SymbolRepository::replaceSymbols(sqlite3_int64 resourceId, std::span<const Symbol> symbols) {
+    clearSymbols(resourceId);
+
+    // Trùng (cùng tên, loại, dòng) bị bỏ qua thay vì lỗi khóa chính
+    SQLiteStmt stmt(m_db.get(), "INSERT OR IGNORE INTO symbols (resource_id, kind, name, line) "
+                                "VALUES (?, ?, ?, ?);");
+
+    for (const auto &symbol : symbols) {
+        sqlite3_reset(stmt.get());
+        sqlite3_bind_int64(stmt.get(), 1, resourceId);
+        sqlite3_bind_int(stmt.get(), 2, symbolKindCode(symbol.kind));
+        sqlite3_bind_text(stmt.get(), 3, symbol.name.data(),
+                          static_cast<int>(symbol.name.size()), SQLITE_STATIC);
+        sqlite3_bind_int(stmt.get(), 4, symbol.line);
+
+        if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+            std::string errMsg = sqlite3_errmsg(m_db.get());
+            throw std::runtime_error("Insert symbol failed for resource ID: " +
+                                     std::to_string(resourceId) + " Error: " + errMsg);
+        }
+    }
+}
+
+void SymbolRepository::clearSymbols(sqlite3_int64 resourceId) {
+    SQLiteStmt stmt(m_db.get(), "DELETE FROM symbols WHERE resource_id = ?;");
+
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        std::string errMsg = sqlite3_errmsg(m_db.get());
+        throw std::runtime_error("Clear symbols failed: " + errMsg);
+    }
+}
+
+std::vector<Symbol> SymbolRepository::findDefinitions(std::string_view name, std::size_t limit) {
+    SQLiteStmt stmt(m_db.get(), "SELECT resource_id, kind, name, line FROM symbols "
+                                "WHERE name = ? AND kind IN (?, ?, ?) "
+                                "ORDER BY kind, resource_id, line LIMIT ?;");
+
+    sqlite3_bind_text(stmt.get(), 1, name.data(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt.get(), 2, symbolKindCode(SymbolKind::type));
+    sqlite3_bind_int(stmt.get(), 3, symbolKindCode(SymbolKind::function));
+    sqlite3_bind_int(stmt.get(), 4, symbolKindCode(SymbolKind::macro));
+    sqlite3_bind_int64(stmt.get(), 5, static_cast<sqlite3_int64>(limit));
+
+    return readSymbols(stmt);
+}
+
+std::vector<Symbol> SymbolRepository::findSymbols(std::string_view name, SymbolKind kind,
+                                                  std::size_t limit) {
+    SQLiteStmt stmt(m_db.get(), "SELECT resource_id, kind, name, line FROM symbols "
+                                "WHERE name = ? AND kind = ? ORDER BY resource_id, line LIMIT ?;");
+
+    sqlite3_bind_text(stmt.get(), 1, name.data(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_int(stmt.get(), 2, symbolKindCode(kind));
+    sqlite3_bind_int64(stmt.get(), 3, static_cast<sqlite3_int64>(limit));
+
+    return readSymbols(stmt);
+}
+
+std::vector<Symbol> SymbolRepository::symbolsOf(sqlite3_int64 resourceId) {
+    SQLiteStmt stmt(m_db.get(), "SELECT resource_id, kind, name, line FROM symbols "
+                                "WHERE resource_id = ? ORDER BY line, kind, name;");
+
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+    return readSymbols(stmt);
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+#include "model.hpp"
+
+class SQLiteDB;
+
+// Bảng symbols: ký hiệu của từng file cpp, ghi lại toàn bộ mỗi lần ContentIndexer index file.
+// Tra theo tên dùng khóa chính (name, kind, ...) nên không phụ thuộc số file đã index.
+class SymbolRepository {
+    public:
+        explicit SymbolRepository(SQLiteDB &db) noexcept : m_db(db) {}
+
+        // Thay ký hiệu của resource (resource_id trong symbols bị bỏ qua); nơi gọi giữ transaction
+        void replaceSymbols(sqlite3_int64 resourceId, std::span<const Symbol> symbols);
+        void clearSymbols(sqlite3_int64 resourceId);
+
+        // "name được định nghĩa ở đâu": type, function, macro; theo loại, resource, dòng
+        std::vector<Symbol> findDefinitions(std::string_view name, std::size_t limit = 200);
+        std::vector<Symbol> findSymbols(std::string_view name, SymbolKind kind,
+                                        std::size_t limit = 200);
+
+        // Ký hiệu của một resource theo dòng
+        std::vector<Symbol> symbolsOf(sqlite3_int64 resourceId);
+
+    private:
+        SQLiteDB &m_db;
+};
@@ -1,3 +1,4 @@
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <optional>
@@ -7,6 +8,7 @@
 #include "sqldb_raii.hpp"
 #include "tag_repository.hpp"
 #include "model.hpp"
+#include "row_view.hpp"
 
 std::optional<sqlite3_int64> TagRepository::addTag(std::string_view name) {
     SQLiteStmt stmt(m_db.get(), "INSERT INTO tags (name) VALUES (?) ON CONFLICT(name) DO NOTHING;");
@@ -205,15 +207,14 @@ std::vector<Resource> TagRepository::getResourcesViaTags(const std::vector<std::
     }
 
     std::vector<Resource> results;
-    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        Resource res{};
-        res.id = sqlite3_column_int64(stmt.get(), 0);
-        res.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
-        res.type = resourceTypeFromString(
-            reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2)));
-        res.created_at = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 3));
-        res.updated_at = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 4));
-        results.emplace_back(std::move(res));
+    for (const auto &[id, title, type, created, updated] :
+         ResultSet<sqlite3_int64, std::string_view, ResourceType, Timestamp, Timestamp>(stmt)) {
+        results.push_back({.id = id,
+                           .title = std::string(title),
+                           .type = type,
+                           .file_hash = std::nullopt,
+                           .created_at = created,
+                           .updated_at = updated});
     }
 
     return results;
@@ -226,34 +227,59 @@ std::vector<Resource> TagRepository::getResourcesViaOneTag(std::string_view name
 
     sqlite3_bind_text(stmt.get(), 1, name.data(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
 
+    // Title NULL => chuỗi rỗng (text() trả view rỗng)
     std::vector<Resource> results;
-    int rc{};
-    while ((rc = sqlite3_step(stmt.get())) == SQLITE_ROW) {
+    for (const auto &[id, title, type] :
+         ResultSet<sqlite3_int64, std::string_view, ResourceType>(stmt)) {
         Resource res{};
+        res.id = id;
+        res.title = title;
+        res.type = type;
+        results.push_back(std::move(res));
+    }
 
-        res.id = sqlite3_column_int64(stmt.get(), 0);
+    return results;
+}
 
-        if (sqlite3_column_type(stmt.get(), 1) != SQLITE_NULL) {
-            res.title = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
-        }
+std::vector<sqlite3_int64> TagRepository::getResourceIdsViaOneTag(std::string_view name,
+                                                                std::size_t offset,
+                                                                std::optional<std::size_t> limit) {
+    SQLiteStmt stmt(m_db.get(), "SELECT rt.resource_id FROM resource_tags rt JOIN tags t "
+                                "ON t.id = rt.tag_id WHERE t.name = ? "
+                                "ORDER BY rt.resource_id LIMIT ? OFFSET ?;");
 
-        if (sqlite3_column_type(stmt.get(), 2) != SQLITE_NULL) {
-            const char* typeText =
-                reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 2));
-            res.type = resourceTypeFromString(typeText);
-        } else {
-            res.type = resourceTypeFromString("");
-        }
+    sqlite3_bind_text(stmt.get(), 1, name.data(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt.get(), 2, limit.has_value() ? static_cast<sqlite3_int64>(*limit) : -1);
+    sqlite3_bind_int64(stmt.get(), 3, static_cast<sqlite3_int64>(offset));
 
-        results.emplace_back(std::move(res));
-    }
+    std::vector<sqlite3_int64> ids;
+    for (const auto &[id] : ResultSet<sqlite3_int64>(stmt)) { ids.push_back(id); }
 
-    if (rc != SQLITE_DONE) {
-        throw std::runtime_error("Has problem at getResourcesViaOneTag, reason: " +
-                                 std::string(sqlite3_errmsg(m_db.get())));
-    }
+    return ids;
+}
 
-    return results;
+sqlite3_int64 TagRepository::countResourcesViaOneTag(std::string_view name) {
+    SQLiteStmt stmt(m_db.get(), "SELECT COUNT(*) FROM resource_tags WHERE tag_id = "
+                                "(SELECT id FROM tags WHERE name = ?);");
+
+    sqlite3_bind_text(stmt.get(), 1, name.data(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) { return sqlite3_column_int64(stmt.get(), 0); }
+
+    throw std::runtime_error("countResourcesViaOneTag failed, reason: " +
+                             std::string(sqlite3_errmsg(m_db.get())));
+}
+
+bool TagRepository::hasTag(sqlite3_int64 resourceId, std::string_view name) {
+    SQLiteStmt stmt(m_db.get(), "SELECT EXISTS (SELECT 1 FROM resource_tags rt JOIN tags t "
+                                "ON t.id = rt.tag_id WHERE rt.resource_id = ? AND t.name = ?);");
+
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+    sqlite3_bind_text(stmt.get(), 2, name.data(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+
+    if (sqlite3_step(stmt.get()) == SQLITE_ROW) { return sqlite3_column_int(stmt.get(), 0) != 0; }
+
+    return false;
 }
 
 void TagRepository::deleteTagFromResource(const ParamIDs &params) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <string_view>
 #include <optional>
@@ -32,6 +33,13 @@ class TagRepository {
         std::vector<std::pair<sqlite3_int64, std::string>> getAllTags();
         std::vector<Resource> getResourcesViaTags(const std::vector<std::string> &tags);
         std::vector<Resource> getResourcesViaOneTag(std::string_view name);
+        // Phân trang theo resource_id; limit nullopt = đến hết
+        std::vector<sqlite3_int64> getResourceIdsViaOneTag(std::string_view name,
+                                                           std::size_t offset = 0,
+                                                           std::optional<std::size_t> limit = {});
+        // Số resource có tag name (qua idx_resource_tags_tag_id, không đọc resources)
+        [[nodiscard]] sqlite3_int64 countResourcesViaOneTag(std::string_view name);
+        [[nodiscard]] bool hasTag(sqlite3_int64 resourceId, std::string_view name);
 
         void deleteTagFromResource(const ParamIDs &params);
         void deleteAllTagsFromResource(sqlite3_int64 resourceId);
@@ -0,0 +1,178 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "term_dictionary.hpp"
+#include "row_view.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    constexpr std::array<std::string_view, 2> kContentFtsTables{"text_chunks_fts",
+                                                                "file_chunks_fts"};
+
+    bool hasTable(SQLiteDB &db, std::string_view name) {
+        SQLiteStmt stmt(db.get(),
+                        "SELECT 1 FROM sqlite_master WHERE type = 'table' AND name = ?;");
+        sqlite3_bind_text(stmt.get(), 1, name.data(), static_cast<int>(name.size()),
+                          SQLITE_TRANSIENT);
+        return sqlite3_step(stmt.get()) == SQLITE_ROW;
+    }
+
+    void execSql(SQLiteDB &db, const std::string &sql) {
+        SQLiteStmt stmt(db.get(), sql.c_str());
+        sqlite3_step(stmt.get());
+    }
+
+    std::size_t charCount(std::string_view text) {
+        return static_cast<std::size_t>(std::ranges::count_if(
+            text, [](char c) { return (static_cast<unsigned char>(c) & 0xC0U) != 0x80U; }));
+    }
+} // namespace
+
+TermDictionary::TermDictionary(std::vector<Entry> terms) {
+    assign(std::move(terms));
+}
+
+void TermDictionary::assign(std::vector<Entry> terms) {
+    std::ranges::sort(terms, {}, &Entry::first);
+
+    m_text.clear();
+    m_offsets.assign(1, 0);
+    m_docs.clear();
+    m_offsets.reserve(terms.size() + 1);
+    m_docs.reserve(terms.size());
+
+    for (auto &[text, docs] : terms) {
+        if (!m_docs.empty() && term(m_docs.size() - 1) == text) {
+            m_docs.back() += docs;
+            continue;
+        }
+        m_text += text;
+        m_offsets.push_back(static_cast<std::uint32_t>(m_text.size()));
+        m_docs.push_back(docs);
+    }
+}
+
+bool TermDictionary::refreshContent(SQLiteDB &db) {
+    const auto changes = sqlite3_total_changes64(db.get());
+    if (changes == m_changes) { return false; }
+
+    std::vector<Entry> terms;
+    for (const auto fts : kContentFtsTables) {
+        if (!hasTable(db, fts)) { continue; }
+
+        // Bảng fts5vocab tạm: không đổi schema của file DB, mất khi đóng connection
+        const std::string vocab = std::string(fts) + "_vocab";
+        execSql(db, "CREATE VIRTUAL TABLE IF NOT EXISTS temp." + vocab +
+                        " USING fts5vocab(main, " + std::string(fts) + ", row);");
+
+        SQLiteStmt stmt(db.get(), ("SELECT term, doc FROM temp." + vocab + ";").c_str());
+        for (const auto &[text, docs] : ResultSet<std::string_view, sqlite3_int64>(stmt)) {
+            terms.emplace_back(std::string(text), docs);
+        }
+    }
+
+    assign(std::move(terms));
+    m_changes = changes;
+    return true;
+}
+
+int TermDictionary::defaultDistance(std::string_view term) noexcept {
+    const auto chars = charCount(term);
+    if (chars <= 3) { return 0; }
+    return chars <= 7 ? 1 : 2;
+}
+
+std::vector<TermMatch> TermDictionary::expand(std::string_view term,
+                                              const FuzzyOptions &options) const {
+    std::vector<TermMatch> found;
+    const auto k = options.maxDistance < 0 ? defaultDistance(term) : options.maxDistance;
+    if (term.empty() || term.size() > kMaxTermBytes || options.maxExpansions == 0) {
+        return found;
+    }
+
+    // rows[d * width + j]: khoảng cách giữa d byte đầu của term đang xét và j byte đầu từ khóa
+    const std::size_t width = term.size() + 1;
+    const auto band = static_cast<std::size_t>(k);
+    std::vector<int> rows((kMaxTermBytes + 1) * width);
+    for (std::size_t j = 0; j < width; ++j) { rows[j] = static_cast<int>(j); }
+
+    std::string_view prev;
+    std::size_t depth{0}; // số hàng (sau hàng 0) còn đúng cho tiền tố của prev
+
+    const auto count = size();
+    std::size_t i{0};
+    while (i < count) {
+        const auto candidate = this->term(i);
+
+        std::size_t d{0};
+        const auto shared = std::min({depth, candidate.size(), prev.size()});
+        while (d < shared && candidate[d] == prev[d]) { ++d; }
+
+        bool skipped{false};
+        for (; d < candidate.size(); ++d) {
+            if (d == kMaxTermBytes) {
+                skipped = true;
+                break;
+            }
+
+            // Chỉ tính dải |d + 1 - j| <= k; ô sát dải gán k + 1 để hàng sau đọc như vô cực
+            const int* above = &rows[d * width];
+            int* row = &rows[(d + 1) * width];
+            row[0] = static_cast<int>(d + 1);
+            int rowMin = row[0];
+            const std::size_t lo = d + 1 > band ? d + 1 - band : 1;
+            const std::size_t hi = std::min(width - 1, d + 1 + band);
+            if (lo > 1 && lo - 1 < width) { row[lo - 1] = k + 1; }
+            for (std::size_t j = lo; j <= hi; ++j) {
+                const int cost = candidate[d] == term[j - 1] ? 0 : 1;
+                row[j] = std::min({above[j] + 1, row[j - 1] + 1, above[j - 1] + cost});
+                rowMin = std::min(rowMin, row[j]);
+            }
+            if (hi + 1 < width) { row[hi + 1] = k + 1; }
+
+            if (rowMin > k) {
+                // Mọi term bắt đầu bằng tiền tố này đều xa hơn k: nhảy qua cả dải
+                const auto prefix = candidate.substr(0, d + 1);
+                const auto rest = std::views::iota(i + 1, count);
+                const auto next = std::ranges::partition_point(rest, [&](std::size_t index) {
+                    return this->term(index).starts_with(prefix);
+                });
+                i = next == rest.end() ? count : *next;
+                skipped = true;
+                break;
+            }
+        }
+
+        prev = candidate;
+        depth = d;
+        if (skipped) {
+            if (d == kMaxTermBytes) { ++i; }
+            continue;
+        }
+
+        const auto lengthGap = candidate.size() > term.size() ? candidate.size() - term.size()
+                                                              : term.size() - candidate.size();
+        const int distance = rows[candidate.size() * width + term.size()];
+        if (lengthGap <= band && distance <= k && m_docs[i] >= options.minDocs) {
+            found.push_back({.term = std::string(candidate), .distance = distance,
+                             .docs = m_docs[i]});
+        }
+        ++i;
+    }
+
+    std::ranges::sort(found, [](const TermMatch &a, const TermMatch &b) {
+        if (a.distance != b.distance) { return a.distance < b.distance; }
+        if (a.docs != b.docs) { return a.docs > b.docs; }
+        return a.term < b.term;
+    });
+    if (found.size() > options.maxExpansions) { found.resize(options.maxExpansions); }
+
+    return found;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "query_router.hpp"
+
+class SQLiteDB;
+
+// Một term của index gần từ khóa
+struct TermMatch {
+        std::string term;
+        int distance{};      // khoảng cách Levenshtein (theo byte) tới từ khóa
+        std::int64_t docs{}; // số chunk chứa term
+};
+
+// Từ điển term của index nội dung (text_chunks_fts, file_chunks_fts), đọc qua bảng fts5vocab
+// tạm. Term sắp xếp theo byte trong một arena (4 byte offset + 8 byte tần suất mỗi term).
+// expand() duyệt mảng đã sắp xếp như một trie ngầm (automaton Levenshtein theo hàng DP):
+// term chung tiền tố với term trước dùng lại các hàng DP của tiền tố, tiền tố nào đã có mọi ô
+// > k thì nhảy (binary search) qua cả dải term bắt đầu bằng nó; mỗi hàng chỉ tính dải 2k + 1
+// ô quanh đường chéo. Chi phí tỉ lệ với số nút trie trong khoảng k quanh từ khóa chứ không
+// với số term.
+class TermDictionary {
+    public:
+        using Entry = std::pair<std::string, std::int64_t>; // term, số chunk chứa term
+
+        static constexpr std::size_t kMaxTermBytes{64}; // term dài hơn không được mở rộng tới
+
+        TermDictionary() = default;
+        // Term trùng nhau được gộp (cộng tần suất)
+        explicit TermDictionary(std::vector<Entry> terms);
+
+        // Nạp lại từ index nội dung nếu connection đã ghi gì đó kể từ lần nạp trước
+        // (sqlite3_total_changes64). Trả về true nếu đã nạp lại
+        bool refreshContent(SQLiteDB &db);
+
+        // Các term cách term không quá k (FuzzyOptions::maxDistance, mặc định theo số ký tự:
+        // 0 với <= 3, 1 với 4..7, 2 từ 8), xếp theo khoảng cách rồi tần suất giảm dần
+        [[nodiscard]] std::vector<TermMatch> expand(std::string_view term,
+                                                    const FuzzyOptions &options = {}) const;
+
+        [[nodiscard]] std::size_t size() const noexcept { return m_docs.size(); }
+        [[nodiscard]] std::string_view term(std::size_t index) const noexcept {
+            return std::string_view(m_text).substr(m_offsets[index],
+                                                   m_offsets[index + 1] - m_offsets[index]);
+        }
+
+        [[nodiscard]] static int defaultDistance(std::string_view term) noexcept;
+
+    private:
+        void assign(std::vector<Entry> terms);
+
+        std::string m_text;                  // các term nối liền
+        std::vector<std::uint32_t> m_offsets{0};
+        std::vector<std::int64_t> m_docs;
+        sqlite3_int64 m_changes{-1};         // total_changes lúc nạp, -1 = chưa nạp
+};
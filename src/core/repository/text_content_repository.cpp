@@ -1,24 +1,121 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <sqlite3.h>
 #include "text_content_repository.hpp"
+#include "chunk_search.hpp"
+#include "model.hpp"
+#include "query_router.hpp"
+#include "revision_repository.hpp"
+#include "row_view.hpp"
 #include "sqldb_raii.hpp"
+#include "text_chunker.hpp"
+
+namespace {
+    constexpr std::size_t kTrainingBytes{16 * 1024 * 1024}; // đọc tối đa khi học từ điển
+    constexpr std::size_t kMinTrainingNotes{8};
+
+    // Khoảng cách chunk_no khi ghi mới, chừa chỗ để chèn chunk vào giữa khi sửa note
+    constexpr sqlite3_int64 kChunkGap{1 << 16};
+
+    struct StoredChunk {
+            sqlite3_int64 id{};
+            sqlite3_int64 chunkNo{};
+            std::size_t offset{};
+            std::optional<std::string_view> content; // nullopt: vị trí nằm ngoài nội dung cũ
+    };
+
+    // Ghi vị trí chunk kèm số dòng (để tính dòng khi tìm kiếm mà không đọc nội dung); trigger
+    // đưa chunk vào FTS qua text_chunk_texts
+    class ChunkInserter {
+        public:
+            ChunkInserter(SQLiteDB &db, sqlite3_int64 resourceId)
+                : m_db(db), m_resourceId(resourceId),
+                  m_stmt(db.get(), "INSERT INTO text_chunks(resource_id, chunk_no, byte_offset, "
+                                   "byte_len, line_count) VALUES (?, ?, ?, ?, ?);") {}
+
+            void operator()(sqlite3_int64 chunkNo, std::size_t offset, std::string_view chunk) {
+                sqlite3_reset(m_stmt.get());
+                sqlite3_bind_int64(m_stmt.get(), 1, m_resourceId);
+                sqlite3_bind_int64(m_stmt.get(), 2, chunkNo);
+                sqlite3_bind_int64(m_stmt.get(), 3, static_cast<sqlite3_int64>(offset));
+                sqlite3_bind_int64(m_stmt.get(), 4, static_cast<sqlite3_int64>(chunk.size()));
+                sqlite3_bind_int64(m_stmt.get(), 5, std::ranges::count(chunk, '\n'));
+
+                if (sqlite3_step(m_stmt.get()) != SQLITE_DONE) {
+                    std::string erroMSG = sqlite3_errmsg(m_db.get());
+                    throw std::runtime_error("Insert text chunk failed for resource ID: " +
+                                             std::to_string(m_resourceId) + " Error: " + erroMSG);
+                }
+            }
+
+        private:
+            SQLiteDB &m_db;
+            sqlite3_int64 m_resourceId;
+            SQLiteStmt m_stmt;
+    };
+
+    void deleteChunkIds(SQLiteDB &db, const std::vector<sqlite3_int64> &ids) {
+        SQLiteStmt stmt(db.get(), "DELETE FROM text_chunks WHERE id = ?;");
+        for (const auto id : ids) {
+            sqlite3_reset(stmt.get());
+            sqlite3_bind_int64(stmt.get(), 1, id);
+            if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+                std::string erroMSG = sqlite3_errmsg(db.get());
+                throw std::runtime_error("Delete text chunk failed: " + erroMSG);
+            }
+        }
+    }
+
+    // Chỉ đổi cột số, nội dung chunk (và FTS) giữ nguyên
+    void moveChunks(SQLiteDB &db, const std::vector<std::pair<sqlite3_int64, std::size_t>> &moved) {
+        SQLiteStmt stmt(db.get(), "UPDATE text_chunks SET byte_offset = ? WHERE id = ?;");
+        for (const auto &[id, offset] : moved) {
+            sqlite3_reset(stmt.get());
+            sqlite3_bind_int64(stmt.get(), 1, static_cast<sqlite3_int64>(offset));
+            sqlite3_bind_int64(stmt.get(), 2, id);
+            if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+                std::string erroMSG = sqlite3_errmsg(db.get());
+                throw std::runtime_error("Move text chunk failed: " + erroMSG);
+            }
+        }
+    }
+} // namespace
 
 void TextContentRepository::insertText(sqlite3_int64 resourceId, std::string_view text) {
-    SQLiteStmt stmt(m_db.get(), "INSERT INTO text_content(resource_id, content) VALUES (?, ?)");
+    // Nội dung và chunk FTS phải khớp nhau: ghi chung một savepoint (lồng được trong transaction)
+    exec("SAVEPOINT text_content_write;");
 
-    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+    try {
+        SQLiteStmt stmt(m_db.get(),
+                        "INSERT INTO text_content(resource_id, content) VALUES (?, ?)");
 
-    sqlite3_bind_text(stmt.get(), 2, text.data(), static_cast<int>(text.size()), SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt.get(), 1, resourceId);
 
-    const int resCheck = sqlite3_step(stmt.get());
-    if (resCheck != SQLITE_DONE) {
-        std::string erroMSG = sqlite3_errmsg(m_db.get());
-        throw std::runtime_error("Insert content failed for resource ID: " +
-                                 std::to_string(resourceId) + " Error: " + erroMSG);
+        bindContent(stmt.get(), 2, text);
+
+        const int resCheck = sqlite3_step(stmt.get());
+        if (resCheck != SQLITE_DONE) {
+            std::string erroMSG = sqlite3_errmsg(m_db.get());
+            throw std::runtime_error("Insert content failed for resource ID: " +
+                                     std::to_string(resourceId) + " Error: " + erroMSG);
+        }
+
+        writeChunks(resourceId, text);
+
+        exec("RELEASE text_content_write;");
+
+    } catch (...) {
+        exec("ROLLBACK TO text_content_write;");
+        exec("RELEASE text_content_write;");
+        throw;
     }
 }
 
@@ -27,37 +124,89 @@ std::optional<std::string> TextContentRepository::getTextById(sqlite3_int64 reso
 
     sqlite3_bind_int64(stmt.get(), 1, resourceId);
 
-    const int resCheck = sqlite3_step(stmt.get());
-    if (resCheck == SQLITE_ROW) {
-        if (sqlite3_column_type(stmt.get(), 0) != SQLITE_NULL) {
-            const char* textPtr = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
-            int len = sqlite3_column_bytes(stmt.get(), 0);
-            return std::string(textPtr, static_cast<std::string::size_type>(len));
-        }
-        // Giá trị trả về trong lệnh truy vấn có chỉ số bắt đầu là 0 và vì chỉ
-        // truy vấn 1 cột content nên giá trị iCol trong sqlite3_column_text() là 0
+    // Chỉ giải nén note được đọc, không phải lúc tìm kiếm/liệt kê
+    if (const auto row = ResultSet<>(stmt).next(); row.has_value() && !row->isNull(0)) {
+        // BLOB được giải nén thẳng vào text, TEXT thì copy từ dòng
+        const bool compressed = row->type(0) == SQLITE_BLOB;
+        std::string text;
+        const auto content = readContent(*row, 0, text);
+        return compressed ? text : std::string(content);
     }
 
     return std::nullopt;
 }
 
 void TextContentRepository::updateText(sqlite3_int64 resourceId, std::string_view newText) {
-    SQLiteStmt stmt(m_db.get(), "UPDATE text_content SET content = ? WHERE resource_id = ?;");
+    exec("SAVEPOINT text_content_write;");
 
-    sqlite3_bind_text(stmt.get(), 1, newText.data(), static_cast<int>(newText.size()),
-                      SQLITE_TRANSIENT); // NOLINT
+    try {
+        // Nội dung cũ để so chunk (chunk chỉ lưu vị trí) và ghi lịch sử, đọc qua RowView: TEXT
+        // không bị copy, BLOB giải nén một lần vào scratch. View trỏ vào dòng sắp bị UPDATE nên
+        // chỉ dùng trong khối này, edit không giữ gì của text cũ
+        std::optional<ChunkEdit> edit;
+        {
+            SQLiteStmt oldStmt(m_db.get(),
+                               "SELECT content FROM text_content WHERE resource_id = ?;");
+            sqlite3_bind_int64(oldStmt.get(), 1, resourceId);
 
-    sqlite3_bind_int64(stmt.get(), 2, resourceId);
+            ResultSet<> rows(oldStmt);
+            const auto row = rows.next();
+            const bool hasOld = row.has_value() && !row->isNull(0);
 
-    const int resCheck = sqlite3_step(stmt.get());
-    if (resCheck != SQLITE_DONE) {
-        std::string erroMSG = sqlite3_errmsg(m_db.get());
-        throw std::runtime_error("Update failed: " + erroMSG);
-    }
+            std::string scratch;
+            const auto oldText = hasOld ? readContent(*row, 0, scratch) : std::string_view{};
+
+            // Lịch sử ghi chung savepoint: phiên bản mới nhất luôn khớp nội dung đang lưu
+            if (m_revisions != nullptr && hasOld) {
+                m_revisions->record(resourceId, oldText, newText);
+            }
+
+            edit = planChunkEdit(resourceId, oldText, newText);
+        }
+
+        // Chỉ ghi/index lại chunk đổi; hiếm khi phải chia lại cả note.
+        // Xóa khi nội dung cũ còn trong text_content (trigger FTS đọc chunk từ đó)
+        if (edit.has_value()) {
+            deleteChunkIds(m_db, edit->removed);
+        } else {
+            deleteChunks(resourceId);
+        }
+
+        SQLiteStmt stmt(m_db.get(),
+                        "UPDATE text_content SET content = ? WHERE resource_id = ?;");
+
+        bindContent(stmt.get(), 1, newText);
+
+        sqlite3_bind_int64(stmt.get(), 2, resourceId);
+
+        const int resCheck = sqlite3_step(stmt.get());
+        if (resCheck != SQLITE_DONE) {
+            std::string erroMSG = sqlite3_errmsg(m_db.get());
+            throw std::runtime_error("Update failed: " + erroMSG);
+        }
+
+        if (sqlite3_changes(m_db.get()) == 0) {
+            throw std::runtime_error("Update failed: no rows updated for resource ID: " +
+                                     std::to_string(resourceId));
+        }
+
+        if (edit.has_value()) {
+            moveChunks(m_db, edit->moved);
+
+            ChunkInserter insert(m_db, resourceId);
+            for (const auto &[chunkNo, chunk] : edit->added) {
+                insert(chunkNo, static_cast<std::size_t>(chunk.data() - newText.data()), chunk);
+            }
+        } else {
+            writeChunks(resourceId, newText);
+        }
+
+        exec("RELEASE text_content_write;");
 
-    if (sqlite3_changes(m_db.get()) == 0) {
-        throw std::runtime_error("Update failed: no rows updated for resource ID: " +
-                                 std::to_string(resourceId));
+    } catch (...) {
+        exec("ROLLBACK TO text_content_write;");
+        exec("RELEASE text_content_write;");
+        throw;
     }
 }
 
@@ -72,34 +221,409 @@ bool TextContentRepository::exists(sqlite3_int64 resourceId) {
 }
 
 std::vector<std::pair<sqlite3_int64, std::string>> TextContentRepository::getAllTexts() {
-    SQLiteStmt stmt(m_db.get(), "SELECT resource_id, content FROM text_content;");
-
     std::vector<std::pair<sqlite3_int64, std::string>> results;
 
-    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        sqlite3_int64 rID = sqlite3_column_int64(stmt.get(), 0);
-        std::string content = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
+    forEachText([&results](sqlite3_int64 resourceId, std::string_view text) {
+        results.emplace_back(resourceId, std::string(text));
+    });
+
+    return results;
+}
+
+std::vector<sqlite3_int64> TextContentRepository::getNoteIds() {
+    SQLiteStmt stmt(m_db.get(), "SELECT resource_id FROM text_content "
+                                "WHERE content IS NOT NULL ORDER BY resource_id;");
+
+    std::vector<sqlite3_int64> ids;
+    for (const auto &[id] : ResultSet<sqlite3_int64>(stmt)) { ids.push_back(id); }
+    return ids;
+}
+
+std::vector<sqlite3_int64> TextContentRepository::searchNoteIds(const RoutedQuery &query) {
+    if (query.plan == QueryPlan::none || query.plan == QueryPlan::likeScan) { return {}; }
+
+    const std::string fts =
+        query.plan == QueryPlan::trigram ? "text_chunks_trigram" : "text_chunks_fts";
+    SQLiteStmt stmt(m_db.get(), "SELECT DISTINCT c.resource_id FROM " + fts +
+                                    " JOIN text_chunks c ON c.id = " + fts + ".rowid WHERE " +
+                                    fts + " MATCH ? ORDER BY c.resource_id;");
+    sqlite3_bind_text(stmt.get(), 1, query.expression.c_str(), -1, SQLITE_TRANSIENT);
+
+    std::vector<sqlite3_int64> ids;
+    for (const auto &[id] : ResultSet<sqlite3_int64>(stmt)) { ids.push_back(id); }
+    return ids;
+}
 
-        results.emplace_back(rID, std::move(content));
+std::size_t TextContentRepository::forEachText(const TextVisitor &visit) {
+    SQLiteStmt stmt(m_db.get(), "SELECT resource_id, content FROM text_content "
+                                "WHERE content IS NOT NULL ORDER BY resource_id;");
+
+    // Một buffer giải nén cho cả lượt duyệt: note lưu TEXT không cấp phát gì
+    std::string scratch;
+    std::size_t count{};
+    for (const auto row : ResultSet<>(stmt)) {
+        visit(row.int64(0), readContent(row, 1, scratch));
+        ++count;
     }
 
-    return results;
+    return count;
 }
 
 std::vector<std::pair<sqlite3_int64, std::string>>
     TextContentRepository::searchByContentFTS(std::string_view keyword) {
-    SQLiteStmt stmt(m_db.get(),
-                    "SELECT rowid, content FROM text_content_fts WHERE text_content_fts MATCH ?;");
+    std::vector<std::pair<sqlite3_int64, std::string>> result;
+
+    for (auto &hit : searchContentHits(keyword)) {
+        result.emplace_back(hit.resource_id, std::move(hit.snippet));
+    }
+
+    return result;
+}
+
+std::vector<ContentHit> TextContentRepository::searchContentHits(std::string_view keyword) {
+    return searchChunkHits(m_db,
+                           {.chunks = "text_chunks", .fts = "text_chunks_fts",
+                            .prefixLines = true},
+                           keyword);
+}
+
+std::vector<ContentHit> TextContentRepository::searchContentHits(const RoutedQuery &query) {
+    if (query.plan == QueryPlan::none || query.plan == QueryPlan::likeScan) { return {}; }
+
+    const bool trigram = query.plan == QueryPlan::trigram;
+    return searchChunkHits(m_db,
+                           {.chunks = "text_chunks",
+                            .fts = trigram ? "text_chunks_trigram" : "text_chunks_fts",
+                            .prefixLines = true},
+                           query.expression);
+}
+
+std::size_t TextContentRepository::reindexAll() {
+    exec("SAVEPOINT text_chunks_reindex;");
+
+    try {
+        exec("DELETE FROM text_chunks;");
+
+        const auto count = forEachText([this](sqlite3_int64 resourceId, std::string_view text) {
+            writeChunks(resourceId, text);
+        });
+
+        exec("RELEASE text_chunks_reindex;");
+        return count;
+
+    } catch (...) {
+        exec("ROLLBACK TO text_chunks_reindex;");
+        exec("RELEASE text_chunks_reindex;");
+        throw;
+    }
+}
+
+void TextContentRepository::exec(const char* sql) {
+    SQLiteStmt stmt(m_db.get(), sql);
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Text content write failed: ") +
+                                 sqlite3_errmsg(m_db.get()));
+    }
+}
+
+std::optional<sqlite3_int64> TextContentRepository::trainDictionary() {
+    std::vector<std::string> texts;
+    {
+        SQLiteStmt stmt(m_db.get(), "SELECT content FROM text_content "
+                                    "WHERE content IS NOT NULL ORDER BY resource_id DESC;");
+
+        ResultSet<> rows(stmt);
+        std::string scratch;
+        std::size_t total{0};
+        while (total < kTrainingBytes) {
+            const auto row = rows.next();
+            if (!row.has_value()) { break; }
+
+            texts.emplace_back(readContent(*row, 0, scratch));
+            total += texts.back().size();
+        }
+    }
+
+    if (texts.size() < kMinTrainingNotes) { return std::nullopt; }
 
-    sqlite3_bind_text(stmt.get(), 1, keyword.data(), static_cast<int>(keyword.size()),
+    const std::vector<std::string_view> samples(texts.begin(), texts.end());
+    const auto dictionary = TextCodec::trainDictionary(samples);
+    if (dictionary.empty()) { return std::nullopt; }
+
+    SQLiteStmt stmt(m_db.get(),
+                    "INSERT INTO text_dictionaries(dictionary, sample_count) VALUES (?, ?);");
+    sqlite3_bind_blob(stmt.get(), 1, dictionary.data(), static_cast<int>(dictionary.size()),
                       SQLITE_TRANSIENT);
+    sqlite3_bind_int64(stmt.get(), 2, static_cast<sqlite3_int64>(texts.size()));
 
-    std::vector<std::pair<sqlite3_int64, std::string>> result;
-    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
-        sqlite_int64 rID = sqlite3_column_int64(stmt.get(), 0);
-        std::string content = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1));
-        result.emplace_back(rID, std::move(content));
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        std::string erroMSG = sqlite3_errmsg(m_db.get());
+        throw std::runtime_error("Save text dictionary failed: " + erroMSG);
     }
 
-    return result;
+    const auto id = sqlite3_last_insert_rowid(m_db.get());
+    m_activeDictionary = static_cast<std::uint32_t>(id);
+    return id;
+}
+
+std::size_t TextContentRepository::recompress(bool allNotes) {
+    const char* sql = !m_compress ? "SELECT resource_id FROM text_content "
+                                    "WHERE typeof(content) = 'blob';"
+                      : allNotes  ? "SELECT resource_id FROM text_content;"
+                                  : "SELECT resource_id FROM text_content "
+                                    "WHERE typeof(content) = 'text';";
+
+    std::vector<sqlite3_int64> ids;
+    {
+        SQLiteStmt stmt(m_db.get(), sql);
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            ids.push_back(sqlite3_column_int64(stmt.get(), 0));
+        }
+    }
+
+    exec("SAVEPOINT text_content_recompress;");
+
+    try {
+        SQLiteStmt select(m_db.get(), "SELECT content FROM text_content WHERE resource_id = ?;");
+        SQLiteStmt update(m_db.get(),
+                          "UPDATE text_content SET content = ? WHERE resource_id = ?;");
+
+        std::string scratch;
+        std::size_t count{};
+        for (const auto id : ids) {
+            sqlite3_reset(select.get());
+            sqlite3_bind_int64(select.get(), 1, id);
+
+            const auto row = ResultSet<>(select).next();
+            if (!row.has_value()) { continue; }
+
+            const bool wasBlob = row->type(0) == SQLITE_BLOB;
+            const auto text = readContent(*row, 0, scratch);
+            const auto encoded = encodeContent(text);
+
+            // Đã đúng dạng (cùng từ điển): không ghi lại
+            if (!encoded.has_value() && !wasBlob) { continue; }
+            if (encoded.has_value() && wasBlob) {
+                const auto stored = row->blob(0);
+                if (std::string_view(reinterpret_cast<const char*>(stored.data()),
+                                     stored.size()) == *encoded) {
+                    continue;
+                }
+            }
+
+            sqlite3_reset(update.get());
+            if (encoded.has_value()) {
+                sqlite3_bind_blob(update.get(), 1, encoded->data(),
+                                  static_cast<int>(encoded->size()), SQLITE_TRANSIENT);
+            } else {
+                sqlite3_bind_text(update.get(), 1, text.data(), static_cast<int>(text.size()),
+                                  SQLITE_TRANSIENT);
+            }
+            sqlite3_bind_int64(update.get(), 2, id);
+
+            if (sqlite3_step(update.get()) != SQLITE_DONE) {
+                std::string erroMSG = sqlite3_errmsg(m_db.get());
+                throw std::runtime_error("Recompress failed for resource ID: " +
+                                         std::to_string(id) + " Error: " + erroMSG);
+            }
+            ++count;
+        }
+
+        exec("RELEASE text_content_recompress;");
+        return count;
+
+    } catch (...) {
+        exec("ROLLBACK TO text_content_recompress;");
+        exec("RELEASE text_content_recompress;");
+        throw;
+    }
+}
+
+const TextCodec &TextContentRepository::codec(std::uint32_t dictionaryId) {
+    if (const auto found = m_codecs.find(dictionaryId); found != m_codecs.end()) {
+        return found->second;
+    }
+
+    std::string dictionary;
+    if (dictionaryId != 0) {
+        SQLiteStmt stmt(m_db.get(), "SELECT dictionary FROM text_dictionaries WHERE id = ?;");
+        sqlite3_bind_int64(stmt.get(), 1, dictionaryId);
+
+        if (sqlite3_step(stmt.get()) != SQLITE_ROW) {
+            throw std::runtime_error("Missing text dictionary: " + std::to_string(dictionaryId));
+        }
+
+        const auto* ptr = static_cast<const char*>(sqlite3_column_blob(stmt.get(), 0));
+        dictionary.assign(ptr, static_cast<std::size_t>(sqlite3_column_bytes(stmt.get(), 0)));
+    }
+
+    return m_codecs.try_emplace(dictionaryId, dictionaryId, std::move(dictionary)).first->second;
+}
+
+const TextCodec &TextContentRepository::activeCodec() {
+    if (!m_activeDictionary.has_value()) {
+        // Chưa học từ điển nào: vẫn nén được, chỉ kém hiệu quả với note ngắn
+        SQLiteStmt stmt(m_db.get(), "SELECT COALESCE(MAX(id), 0) FROM text_dictionaries;");
+        m_activeDictionary = sqlite3_step(stmt.get()) == SQLITE_ROW
+                                 ? static_cast<std::uint32_t>(sqlite3_column_int64(stmt.get(), 0))
+                                 : 0;
+    }
+
+    return codec(*m_activeDictionary);
+}
+
+std::optional<std::string> TextContentRepository::encodeContent(std::string_view text) {
+    if (!m_compress || text.size() < kMinCompressSize) { return std::nullopt; }
+
+    auto blob = activeCodec().compress(text);
+    if (blob.size() >= text.size()) { return std::nullopt; }
+
+    return blob;
+}
+
+void TextContentRepository::bindContent(sqlite3_stmt* stmt, int index, std::string_view text) {
+    if (const auto blob = encodeContent(text)) {
+        sqlite3_bind_blob(stmt, index, blob->data(), static_cast<int>(blob->size()),
+                          SQLITE_TRANSIENT);
+        return;
+    }
+
+    sqlite3_bind_text(stmt, index, text.data(), static_cast<int>(text.size()), SQLITE_TRANSIENT);
+}
+
+std::string_view TextContentRepository::readContent(const RowView &row, int column,
+                                                    std::string &scratch) {
+    // BLOB = nội dung nén (TEXT không bao giờ bị SQLite đổi sang BLOB)
+    if (row.type(column) == SQLITE_BLOB) {
+        const auto bytes = row.blob(column);
+        const std::string_view blob(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        scratch = codec(TextCodec::dictionaryId(blob)).decompress(blob);
+        return scratch;
+    }
+
+    return row.text(column);
+}
+
+void TextContentRepository::deleteChunks(sqlite3_int64 resourceId) {
+    // Trigger text_chunks_delete_fts tự xóa khỏi FTS
+    SQLiteStmt stmt(m_db.get(), "DELETE FROM text_chunks WHERE resource_id = ?;");
+    sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        std::string erroMSG = sqlite3_errmsg(m_db.get());
+        throw std::runtime_error("Clear text chunks failed: " + erroMSG);
+    }
+}
+
+void TextContentRepository::writeChunks(sqlite3_int64 resourceId, std::string_view text) {
+    deleteChunks(resourceId);
+
+    ChunkInserter insert(m_db, resourceId);
+    sqlite3_int64 chunkNo{0};
+    std::size_t offset{0};
+    for (const auto chunk : splitContentDefined(text, kChunkOptions)) {
+        insert(chunkNo, offset, chunk);
+        chunkNo += kChunkGap;
+        offset += chunk.size();
+    }
+}
+
+std::optional<TextContentRepository::ChunkEdit>
+    TextContentRepository::planChunkEdit(sqlite3_int64 resourceId, std::string_view oldText,
+                                         std::string_view newText) {
+    std::vector<StoredChunk> stored;
+    {
+        SQLiteStmt stmt(m_db.get(), "SELECT id, chunk_no, byte_offset, byte_len FROM text_chunks "
+                                    "WHERE resource_id = ? ORDER BY chunk_no;");
+        sqlite3_bind_int64(stmt.get(), 1, resourceId);
+
+        for (const auto &[id, chunkNo, offset, length] :
+             ResultSet<sqlite3_int64, sqlite3_int64, sqlite3_int64, sqlite3_int64>(stmt)) {
+            StoredChunk chunk{.id = id, .chunkNo = chunkNo,
+                              .offset = static_cast<std::size_t>(offset)};
+            if (offset >= 0 && length >= 0 &&
+                static_cast<std::size_t>(offset + length) <= oldText.size()) {
+                chunk.content = oldText.substr(chunk.offset, static_cast<std::size_t>(length));
+            }
+            stored.push_back(chunk);
+        }
+    }
+
+    const auto chunks = splitContentDefined(newText, kChunkOptions);
+
+    // Ghép chunk mới với chunk cũ cùng nội dung, giữ nguyên thứ tự (greedy từ đầu note)
+    std::unordered_map<std::string_view, std::vector<std::size_t>> byContent;
+    for (std::size_t i = 0; i < stored.size(); ++i) {
+        if (stored[i].content.has_value()) { byContent[*stored[i].content].push_back(i); }
+    }
+
+    std::vector<std::optional<std::size_t>> matched(chunks.size());
+    std::vector<bool> kept(stored.size());
+    std::size_t nextStored{0};
+
+    for (std::size_t j = 0; j < chunks.size(); ++j) {
+        const auto found = byContent.find(chunks[j]);
+        if (found == byContent.end()) { continue; }
+
+        const auto &candidates = found->second;
+        const auto pos = std::ranges::lower_bound(candidates, nextStored);
+        if (pos == candidates.end()) { continue; }
+
+        matched[j] = *pos;
+        kept[*pos] = true;
+        nextStored = *pos + 1;
+    }
+
+    // chunk_no cho các đoạn chunk mới nằm giữa hai chunk giữ lại
+    std::vector<sqlite3_int64> chunkNos(chunks.size());
+    for (std::size_t j = 0; j < chunks.size();) {
+        if (matched[j].has_value()) {
+            chunkNos[j] = stored[*matched[j]].chunkNo;
+            ++j;
+            continue;
+        }
+
+        std::size_t end = j;
+        while (end < chunks.size() && !matched[end].has_value()) { ++end; }
+
+        const auto count = static_cast<sqlite3_int64>(end - j);
+        const bool hasLow = j > 0;
+        const bool hasHigh = end < chunks.size();
+        const sqlite3_int64 low = hasLow ? chunkNos[j - 1] : 0;
+        const sqlite3_int64 high = hasHigh ? stored[*matched[end]].chunkNo : 0;
+
+        // Hết khoảng trống giữa hai chunk giữ lại: để caller ghi lại toàn bộ
+        if (hasLow && hasHigh && high - low <= count) { return std::nullopt; }
+
+        for (sqlite3_int64 t = 0; t < count; ++t) {
+            sqlite3_int64 chunkNo{};
+            if (hasLow && hasHigh) {
+                chunkNo = low + (high - low) / (count + 1) * (t + 1);
+            } else if (hasLow) {
+                chunkNo = low + (t + 1) * kChunkGap;
+            } else if (hasHigh) {
+                chunkNo = high - (count - t) * kChunkGap;
+            } else {
+                chunkNo = t * kChunkGap;
+            }
+            chunkNos[j + static_cast<std::size_t>(t)] = chunkNo;
+        }
+        j = end;
+    }
+
+    // Caller xóa trước khi chèn: chunk_no mới có thể trùng chunk_no của chunk cũ bị thay
+    ChunkEdit edit;
+    for (std::size_t i = 0; i < stored.size(); ++i) {
+        if (!kept[i]) { edit.removed.push_back(stored[i].id); }
+    }
+    for (std::size_t j = 0; j < chunks.size(); ++j) {
+        const auto offset = static_cast<std::size_t>(chunks[j].data() - newText.data());
+        if (!matched[j].has_value()) {
+            edit.added.emplace_back(chunkNos[j], chunks[j]);
+        } else if (stored[*matched[j]].offset != offset) {
+            edit.moved.emplace_back(stored[*matched[j]].id, offset);
+        }
+    }
+
+    return edit;
 }
@@ -1,26 +1,121 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
 #include <string_view>
 #include <optional>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 #include <sqlite3.h>
+#include "model.hpp"
+#include "text_chunker.hpp"
+#include "text_codec.hpp"
 
 class SQLiteDB;
+class RevisionRepository;
+class RowView;
+struct RoutedQuery;
 
+// Nội dung note nằm nguyên vẹn trong text_content; FTS chạy trên text_chunks để note rất dài
+// không thành một dòng FTS khổng lồ và kết quả trỏ được tới chỗ khớp. Chunk chia theo nội dung
+// (splitContentDefined) nên updateText chỉ xóa/chèn các chunk quanh chỗ sửa.
+// Khi bật nén, text_content.content lưu BLOB (TextCodec, từ điển trong text_dictionaries) và chỉ
+// được giải nén khi đọc. text_chunks chỉ lưu vị trí (byte_offset, byte_len) của chunk: FTS đọc
+// chunk qua view text_chunk_texts (note_slice trên text_content), nên text của note chỉ có một
+// bản và nén là DB nhỏ đi thật. Trigger FTS đọc chunk từ nội dung đang lưu, vì vậy chunk được
+// xóa trước khi ghi nội dung mới và chèn sau đó.
 class TextContentRepository {
     public:
-        explicit TextContentRepository(SQLiteDB &db) noexcept : m_db(db) {}
+        static constexpr ContentChunkOptions kChunkOptions{};
+        static constexpr std::size_t kMinCompressSize{64}; // note ngắn hơn lưu nguyên text
+
+        // text chỉ hợp lệ trong lần gọi (trỏ vào dòng SQLite hoặc buffer giải nén dùng lại)
+        using TextVisitor = std::function<void(sqlite3_int64, std::string_view)>;
+
+        // revisions != nullptr => updateText ghi thêm một phiên bản vào lịch sử
+        explicit TextContentRepository(SQLiteDB &db,
+                                       RevisionRepository* revisions = nullptr) noexcept
+            : m_db(db), m_revisions(revisions) {}
 
         void insertText(sqlite3_int64 resourceId, std::string_view text);
+
+        // Mỗi note một kết quả (chunk khớp tốt nhất) kèm snippet quanh chỗ khớp
         std::vector<std::pair<sqlite3_int64, std::string>>
             searchByContentFTS(std::string_view keyword);
+        std::vector<ContentHit> searchContentHits(std::string_view keyword);
+        // Theo kế hoạch của QueryRouter: trigram dùng text_chunks_trigram thay cho bảng FTS
+        std::vector<ContentHit> searchContentHits(const RoutedQuery &query);
+
         std::optional<std::string> getTextById(sqlite3_int64 resourceId);
+        // Id mọi note theo resource_id; bản có query chỉ lấy note có chunk khớp (trigram/FTS)
+        std::vector<sqlite3_int64> getNoteIds();
+        std::vector<sqlite3_int64> searchNoteIds(const RoutedQuery &query);
         std::vector<std::pair<sqlite3_int64, std::string>> getAllTexts();
+
+        // Duyệt mọi note theo resource_id mà không copy từng note; trả về số note đã duyệt
+        std::size_t forEachText(const TextVisitor &visit);
+
         void updateText(sqlite3_int64 resourceId, std::string_view newText);
 
         bool exists(sqlite3_int64 resourceId);
 
+        // Chia lại chunk cho toàn bộ note (migration); trả về số note đã xử lý
+        std::size_t reindexAll();
+
+        // Chỉ ảnh hưởng lần ghi sau; note đã nén vẫn đọc được khi tắt
+        void setCompressionEnabled(bool enabled) noexcept { m_compress = enabled; }
+
+        [[nodiscard]] bool compressionEnabled() const noexcept { return m_compress; }
+
+        // Đã có từ điển học từ note (nén không từ điển vẫn dùng được khi chưa có)
+        [[nodiscard]] bool hasDictionary() { return activeCodec().id() != 0; }
+
+        // Học từ điển mới từ các note gần nhất, dùng cho các lần nén sau.
+        // nullopt nếu chưa đủ note hoặc các note không có gì chung
+        std::optional<sqlite3_int64> trainDictionary();
+
+        // Ghi lại nội dung theo cấu hình hiện tại: nén note còn lưu text (hoặc giải nén mọi note
+        // khi đã tắt nén). allNotes = true thì nén lại cả note đang dùng từ điển cũ.
+        // Trả về số note đã ghi lại
+        std::size_t recompress(bool allNotes = false);
+
     private:
         SQLiteDB &m_db;
+        RevisionRepository* m_revisions;
+        bool m_compress{};
+        std::optional<std::uint32_t> m_activeDictionary;       // id từ điển mới nhất
+        std::unordered_map<std::uint32_t, TextCodec> m_codecs; // cache theo id từ điển
+
+        void exec(const char* sql);
+
+        const TextCodec &codec(std::uint32_t dictionaryId);
+        const TextCodec &activeCodec();
+
+        // BLOB nén nếu đang bật nén và nén có lợi, nullopt = lưu nguyên text
+        std::optional<std::string> encodeContent(std::string_view text);
+        void bindContent(sqlite3_stmt* stmt, int index, std::string_view text);
+
+        // TEXT: view vào dòng đang đọc; BLOB: giải nén vào scratch rồi trả view vào scratch
+        std::string_view readContent(const RowView &row, int column, std::string &scratch);
+
+        // Chunk phải ghi lại khi đổi nội dung note
+        struct ChunkEdit {
+                std::vector<sqlite3_int64> removed;                         // id
+                std::vector<std::pair<sqlite3_int64, std::size_t>> moved;   // id, byte_offset mới
+                std::vector<std::pair<sqlite3_int64, std::string_view>> added; // chunk_no, chunk
+        };
+
+        void deleteChunks(sqlite3_int64 resourceId);
+
+        // Chia lại toàn bộ note (text phải đang được lưu trong text_content)
+        void writeChunks(sqlite3_int64 resourceId, std::string_view text);
+
+        // So chunk mới với chunk đang lưu (cắt từ oldText): giữ chunk trùng nội dung, chỉ
+        // xóa/chèn phần khác; chunk giữ lại mà đổi vị trí thì dời byte_offset. nullopt nếu hết
+        // chỗ chèn giữa hai chunk giữ lại. added trỏ vào newText
+        std::optional<ChunkEdit> planChunkEdit(sqlite3_int64 resourceId, std::string_view oldText,
+                                               std::string_view newText);
 };
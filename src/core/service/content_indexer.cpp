@@ -0,0 +1,312 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "content_indexer.hpp"
+#include "bounded_queue.hpp"
+#include "content_index_repository.hpp"
+#include "cpp_symbols.hpp"
+#include "epub_extractor.hpp"
+#include "model.hpp"
+#include "sqldb_raii.hpp"
+#include "text_chunker.hpp"
+
+namespace {
+    constexpr std::size_t kReadBlockSize{32 * 1024};
+    constexpr unsigned kMaxAutoThreads{4};
+
+    // Worker dừng giữa chừng vì thread ghi DB đã hủy lượt index
+    struct ExtractionCancelled {};
+
+    void pushStream(std::istream &in, TextChunker &chunker) {
+        std::vector<char> block(kReadBlockSize);
+        while (in.read(block.data(), static_cast<std::streamsize>(block.size())) ||
+               in.gcount() > 0) {
+            chunker.push(std::string_view(block.data(), static_cast<std::size_t>(in.gcount())));
+        }
+    }
+
+    void execSql(SQLiteDB &db, const char* sql) {
+        SQLiteStmt stmt(db.get(), sql);
+        if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+            throw std::runtime_error(std::string("Content index SQL failed: ") + sql + " " +
+                                     sqlite3_errmsg(db.get()));
+        }
+    }
+
+    // Gọi trong catch: lỗi gốc được ném lại, lỗi ROLLBACK (SQLite có thể đã tự rollback) bỏ qua
+    void rollback(SQLiteDB &db) noexcept {
+        try {
+            execSql(db, "ROLLBACK;");
+        } catch (const std::exception &) {} // NOLINT(bugprone-empty-catch)
+    }
+} // namespace
+
+// ------------------------------------------------------------
+// ContentIndexer
+// ------------------------------------------------------------
+ContentIndexer::ContentIndexer(SQLiteDB &db, ContentIndexRepository &indexRepo, Options options)
+    : m_db(db), m_indexRepo(indexRepo), m_symbolRepo(db), m_options(options) {
+    m_options.chunkSize = std::max(m_options.chunkSize, TextChunker::kMinChunkSize);
+    if (m_options.extractThreads == 0) {
+        m_options.extractThreads =
+            std::clamp(std::thread::hardware_concurrency(), 1U, kMaxAutoThreads);
+    }
+}
+
+const std::vector<ResourceType> &ContentIndexer::supportedTypes() {
+    static const std::vector<ResourceType> types{ResourceType::cpp, ResourceType::text,
+                                                 ResourceType::epub};
+    return types;
+}
+
+std::size_t ContentIndexer::indexPending(std::size_t maxFiles) {
+    auto candidates = m_indexRepo.getPendingFiles(supportedTypes(), maxFiles);
+
+    const auto threads = static_cast<unsigned>(
+        std::min<std::size_t>(m_options.extractThreads, candidates.size()));
+    if (threads > 1) {
+        indexParallel(candidates, threads);
+        return candidates.size();
+    }
+
+    for (const auto &candidate : candidates) {
+        try {
+            indexFile(candidate);
+        } catch (const std::exception &ex) {
+            // Không để một file lỗi chặn cả hàng đợi
+            m_indexRepo.setIndexState(candidate.resource_id, candidate.file_hash, 0, ex.what());
+        }
+    }
+
+    return candidates.size();
+}
+
+void ContentIndexer::indexFile(const IndexCandidate &candidate) {
+    execSql(m_db, "BEGIN TRANSACTION;");
+
+    try {
+        m_indexRepo.clearChunks(candidate.resource_id);
+
+        ChunkCursor cursor;
+        int chunkNo{0};
+        bool writing{false};
+        std::optional<std::string> error;
+        const bool cpp = candidate.type == ResourceType::cpp;
+        CppSymbolScanner scanner;
+
+        try {
+            TextChunker chunker(m_options.chunkSize, [&](std::string_view chunk) {
+                if (cpp) { scanner.push(chunk); }
+                writing = true;
+                m_indexRepo.insertChunk(candidate.resource_id, cursor.advance(chunk), chunk);
+                ++chunkNo;
+                writing = false;
+            });
+            extractText(candidate, chunker);
+            chunker.finish();
+        } catch (const std::exception &ex) {
+            if (writing) { throw; } // lỗi DB: rollback cả file
+
+            // Lỗi đọc/giải nén: ghi nhận cùng hash hiện tại, chỉ thử lại khi file đổi nội dung
+            m_indexRepo.clearChunks(candidate.resource_id);
+            chunkNo = 0;
+            error = ex.what();
+        }
+
+        if (cpp && !error) {
+            m_symbolRepo.replaceSymbols(candidate.resource_id, scanner.finish());
+        } else {
+            m_symbolRepo.clearSymbols(candidate.resource_id);
+        }
+
+        m_indexRepo.setIndexState(candidate.resource_id, candidate.file_hash, chunkNo, error);
+
+        execSql(m_db, "COMMIT;");
+
+    } catch (...) {
+        rollback(m_db);
+        throw;
+    }
+}
+
+void ContentIndexer::indexParallel(const std::vector<IndexCandidate> &candidates,
+                                   unsigned threads) {
+    enum class Kind : std::uint8_t { chunk, done, failed };
+
+    struct Extracted {
+            std::size_t index{};         // vị trí trong candidates
+            Kind kind{};
+            std::string text;            // nội dung chunk, hoặc thông báo lỗi khi failed
+            std::vector<Symbol> symbols; // ký hiệu file cpp, gửi kèm done
+    };
+
+    // Bộ nhớ: tối đa queueCapacity chunk + một chunker mỗi worker, không phụ thuộc kích thước file
+    BoundedQueue<Extracted> queue(m_options.queueCapacity);
+    std::atomic<bool> cancelled{false};
+    std::atomic<std::size_t> next{0};
+    std::atomic<unsigned> activeWorkers{threads};
+
+    auto worker = [&] {
+        for (std::size_t i{}; (i = next.fetch_add(1)) < candidates.size();) {
+            Extracted result{.index = i, .kind = Kind::done};
+            const bool cpp = candidates[i].type == ResourceType::cpp;
+            CppSymbolScanner scanner;
+            try {
+                TextChunker chunker(m_options.chunkSize, [&](std::string_view chunk) {
+                    // Quét ký hiệu trên worker, thread ghi DB chỉ nhận kết quả
+                    if (cpp) { scanner.push(chunk); }
+                    if (!queue.push({.index = i, .kind = Kind::chunk, .text = std::string(chunk)},
+                                    cancelled)) {
+                        throw ExtractionCancelled{};
+                    }
+                });
+                extractText(candidates[i], chunker);
+                chunker.finish();
+                if (cpp) { result.symbols = scanner.finish(); }
+            } catch (const ExtractionCancelled &) {
+                break;
+            } catch (const std::exception &ex) {
+                result.kind = Kind::failed;
+                result.text = ex.what();
+            }
+
+            if (!queue.push(std::move(result), cancelled)) { break; }
+        }
+
+        if (activeWorkers.fetch_sub(1) == 1) { queue.close(); }
+    };
+
+    // Một transaction cho cả lượt; chunk của các file đến xen kẽ nhau
+    std::vector<int> chunkCounts(candidates.size(), -1);
+    std::vector<ChunkCursor> cursors(candidates.size());
+
+    execSql(m_db, "BEGIN TRANSACTION;");
+
+    std::vector<std::jthread> workers;
+    try {
+        workers.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) { workers.emplace_back(worker); }
+
+        Extracted item;
+        while (queue.pop(item, cancelled)) {
+            const auto &candidate = candidates[item.index];
+            int &count = chunkCounts[item.index];
+
+            if (count < 0) {
+                m_indexRepo.clearChunks(candidate.resource_id);
+                count = 0;
+            }
+
+            switch (item.kind) {
+            case Kind::chunk: {
+                const auto position = cursors[item.index].advance(item.text);
+                m_indexRepo.insertChunk(candidate.resource_id, position, item.text);
+                ++count;
+                break;
+            }
+            case Kind::done:
+                m_symbolRepo.replaceSymbols(candidate.resource_id, item.symbols);
+                m_indexRepo.setIndexState(candidate.resource_id, candidate.file_hash, count);
+                break;
+            case Kind::failed:
+                m_indexRepo.clearChunks(candidate.resource_id);
+                m_symbolRepo.clearSymbols(candidate.resource_id);
+                count = 0;
+                m_indexRepo.setIndexState(candidate.resource_id, candidate.file_hash, 0,
+                                          item.text);
+                break;
+            }
+        }
+
+        workers.clear();
+        execSql(m_db, "COMMIT;");
+
+    } catch (...) {
+        cancelled.store(true);
+        workers.clear(); // join trước khi queue bị hủy
+        rollback(m_db);
+        throw;
+    }
+}
+
+std::size_t ContentIndexer::forEachTextChunk(std::istream &in, std::size_t chunkSize,
+                                             const ChunkSink &sink) {
+    TextChunker chunker(chunkSize, sink);
+
+    pushStream(in, chunker);
+
+    return chunker.finish();
+}
+
+// ------------------------------------------------------------
+// PageChunkWriter
+// ------------------------------------------------------------
+PageChunkWriter::PageChunkWriter(SQLiteDB &db, ContentIndexRepository &indexRepo,
+                                 IndexCandidate candidate, std::size_t chunkSize)
+    : m_db(db), m_indexRepo(indexRepo), m_candidate(std::move(candidate)),
+      m_chunkSize(std::max(chunkSize, TextChunker::kMinChunkSize)) {
+    m_indexRepo.clearChunks(m_candidate.resource_id);
+}
+
+void PageChunkWriter::addPage(int page, std::string_view text) {
+    ++m_pageCount;
+    if (text.empty()) { return; }
+
+    execSql(m_db, "BEGIN TRANSACTION;");
+    const int before = m_chunkCount;
+
+    try {
+        // Offset/dòng tính trong trang; chunk_no đánh liên tục trên cả file
+        ChunkCursor cursor(m_chunkCount);
+        TextChunker chunker(m_chunkSize, [&](std::string_view chunk) {
+            m_indexRepo.insertChunk(m_candidate.resource_id, cursor.advance(chunk), chunk, page);
+            ++m_chunkCount;
+        });
+        chunker.push(text);
+        chunker.finish();
+
+        execSql(m_db, "COMMIT;");
+
+    } catch (...) {
+        m_chunkCount = before;
+        rollback(m_db);
+        throw;
+    }
+}
+
+void PageChunkWriter::finish() {
+    writeState(std::nullopt);
+}
+
+void PageChunkWriter::fail(std::string_view error) {
+    m_indexRepo.clearChunks(m_candidate.resource_id);
+    m_chunkCount = 0;
+    writeState(error);
+}
+
+void PageChunkWriter::writeState(std::optional<std::string_view> error) {
+    m_indexRepo.setIndexState(m_candidate.resource_id, m_candidate.file_hash, m_chunkCount, error);
+}
+
+void ContentIndexer::extractText(const IndexCandidate &candidate, TextChunker &chunker) {
+    if (candidate.type == ResourceType::epub) {
+        EpubExtractor epub(candidate.path);
+        epub.extractText([&](std::string_view text) { chunker.push(text); });
+        return;
+    }
+
+    std::ifstream in(candidate.path, std::ios::binary);
+    if (!in.is_open()) { throw std::runtime_error("Cannot open file: " + candidate.path); }
+
+    pushStream(in, chunker);
+}
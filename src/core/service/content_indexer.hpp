@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "model.hpp"
+#include "symbol_repository.hpp"
+#include "text_chunker.hpp"
+
+class SQLiteDB;
+class ContentIndexRepository;
+
+struct ContentIndexOptions {
+        std::size_t chunkSize{32 * 1024}; // byte mỗi chunk FTS, cũng là giới hạn bộ nhớ khi đọc
+        unsigned extractThreads{};        // số thread trích text song song, 0 = tự chọn
+        std::size_t queueCapacity{32};    // số chunk tối đa chờ ghi DB khi trích song song
+};
+
+// Trích nội dung file (cpp, txt, epub) vào file_chunks/file_chunks_fts để tìm theo nội dung;
+// file cpp còn được quét ký hiệu (CppSymbolScanner) vào bảng symbols trong cùng lượt đọc.
+// Incremental: chỉ index lại khi file_hash khác hash đã index (watcher/import cập nhật hash).
+// File được đọc tuần tự từng block, mỗi chunk ghi DB ngay => bộ nhớ không phụ thuộc kích thước file.
+// Nhiều file trong một lượt: trích text song song trên worker thread, chunk đi qua BoundedQueue
+// về thread gọi (thread duy nhất ghi DB). PDF không trích trong tiến trình app (PageChunkWriter).
+class ContentIndexer {
+    public:
+        using Options = ContentIndexOptions;
+        using ChunkSink = TextChunker::ChunkSink;
+
+        ContentIndexer(SQLiteDB &db, ContentIndexRepository &indexRepo,
+                       Options options = ContentIndexOptions{});
+
+        [[nodiscard]] static const std::vector<ResourceType> &supportedTypes();
+
+        // Index tối đa maxFiles file đang chờ, trả về số file đã xử lý
+        std::size_t indexPending(std::size_t maxFiles);
+
+        // Thay toàn bộ chunk (và ký hiệu nếu là cpp) của một file trong một transaction
+        void indexFile(const IndexCandidate &candidate);
+
+        // Chia stream thành chunk ~chunkSize byte (xem TextChunker). Trả về số chunk.
+        static std::size_t forEachTextChunk(std::istream &in, std::size_t chunkSize,
+                                            const ChunkSink &sink);
+
+        // Đẩy text của file ra chunker theo loại file; ném std::runtime_error nếu không đọc được
+        static void extractText(const IndexCandidate &candidate, TextChunker &chunker);
+
+    private:
+        void indexParallel(const std::vector<IndexCandidate> &candidates, unsigned threads);
+
+        SQLiteDB &m_db;
+        ContentIndexRepository &m_indexRepo;
+        SymbolRepository m_symbolRepo;
+        Options m_options;
+};
+
+// Ghi text PDF (do notes-pdf-worker trả về) theo từng trang: chunk không vắt qua hai trang nên
+// luôn biết số trang của kết quả tìm kiếm. Mỗi trang một transaction ngắn để PDF dài không
+// giữ khóa DB suốt thời gian worker chạy.
+class PageChunkWriter {
+    public:
+        // Xóa chunk cũ của file ngay khi bắt đầu
+        PageChunkWriter(SQLiteDB &db, ContentIndexRepository &indexRepo, IndexCandidate candidate,
+                        std::size_t chunkSize = ContentIndexOptions{}.chunkSize);
+
+        void addPage(int page, std::string_view text);
+
+        // Ghi trạng thái đã index với hash lúc bắt đầu (file đổi trong lúc trích sẽ được index lại)
+        void finish();
+
+        // Bỏ các trang đã ghi, ghi nhận lỗi để không thử lại đến khi file đổi
+        void fail(std::string_view error);
+
+        [[nodiscard]] const IndexCandidate &candidate() const noexcept { return m_candidate; }
+        [[nodiscard]] int chunkCount() const noexcept { return m_chunkCount; }
+        [[nodiscard]] int pageCount() const noexcept { return m_pageCount; }
+
+    private:
+        void writeState(std::optional<std::string_view> error);
+
+        SQLiteDB &m_db;
+        ContentIndexRepository &m_indexRepo;
+        IndexCandidate m_candidate;
+        std::size_t m_chunkSize;
+        int m_chunkCount{};
+        int m_pageCount{};
+};
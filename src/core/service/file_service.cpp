@@ -1,9 +1,9 @@
-#include <iomanip>
-#include <iostream>
+#include <memory>
+#include <system_error>
+#include <vector>
 #include <string>
 #include <optional>
 #include <fstream>
-#include <sstream>
 #include <stdexcept>
 #include <array>
 #include <filesystem>
@@ -14,72 +14,135 @@
 #include "file_repository.hpp"
 #include "model.hpp"
 #include "resource_repository.hpp"
+#include "content_store.hpp"
+#include "sqldb_raii.hpp"
 
-// Tính hash file (SHA256)
-std::string FileService::computeFileHash(const std::string &filePath) {
-    std::ifstream file(filePath, std::ios::binary);
-    if (!file.is_open()) { throw std::runtime_error("Error, cannot open file: " + filePath); }
+namespace {
+    constexpr std::size_t kIoBufferSize{64 * 1024};
 
-    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
-    if (ctx == nullptr) { throw std::runtime_error("Failed create EVP_MD_CTX"); }
+    struct EvpMdCtxDeleter {
+            void operator()(EVP_MD_CTX* ctx) const noexcept { EVP_MD_CTX_free(ctx); }
+    };
 
-    const EVP_MD* md = EVP_sha256();
-    if (EVP_DigestInit_ex(ctx, md, nullptr) != 1) {
-        EVP_MD_CTX_free(ctx);
-        throw std::runtime_error("EVP_DigestInit_ex failed");
-    }
+    using unique_evp_md_ctx_ptr = std::unique_ptr<EVP_MD_CTX, EvpMdCtxDeleter>;
 
-    const int bufferSize{8192};
-    std::array<char, bufferSize> buffer{};
-    while (file.read(buffer.data(), buffer.size()) || file.gcount() > 0) {
-        if (EVP_DigestUpdate(ctx, buffer.data(), static_cast<std::size_t>(file.gcount())) != 1) {
-            EVP_MD_CTX_free(ctx);
-            throw std::runtime_error("EVP_DigestUpdate failed");
-        }
-    }
+    // SHA256 tăng dần: mỗi block chỉ cần đọc một lần
+    class Sha256Stream {
+        public:
+            Sha256Stream() : m_ctx(EVP_MD_CTX_new()) {
+                if (!m_ctx) { throw std::runtime_error("Failed create EVP_MD_CTX"); }
+                if (EVP_DigestInit_ex(m_ctx.get(), EVP_sha256(), nullptr) != 1) {
+                    throw std::runtime_error("EVP_DigestInit_ex failed");
+                }
+            }
 
-    // unsigned char hash[EVP_MAX_MD_SIZE];
-    std::array<unsigned char, EVP_MAX_MD_SIZE> hash{};
-    unsigned int hashLen{};
+            void update(const char* data, std::size_t len) {
+                if (EVP_DigestUpdate(m_ctx.get(), data, len) != 1) {
+                    throw std::runtime_error("EVP_DigestUpdate failed");
+                }
+            }
 
-    if (EVP_DigestFinal_ex(ctx, hash.data(), &hashLen) != 1) {
-        EVP_MD_CTX_free(ctx);
-        throw std::runtime_error("EVP_DigestFinal_ex failed");
-    }
+            FileHash finalDigest() {
+                FileHash hash{};
+                unsigned int hashLen{};
+
+                if (EVP_DigestFinal_ex(m_ctx.get(), reinterpret_cast<unsigned char*>(hash.data()),
+                                       &hashLen) != 1 ||
+                    hashLen != hash.size()) {
+                    throw std::runtime_error("EVP_DigestFinal_ex failed");
+                }
 
-    EVP_MD_CTX_free(ctx);
+                return hash;
+            }
 
-    std::ostringstream oss;
-    oss << std::hex << std::setfill('0');
-    for (unsigned int i = 0; i < hashLen; ++i) { oss << std::setw(2) << static_cast<int>(hash[i]); }
+        private:
+            unique_evp_md_ctx_ptr m_ctx;
+    };
 
-    return oss.str();
+    // Xóa file tạm nếu chưa được rename thành file đích (lỗi giữa chừng, trùng hash,...)
+    class TempFileGuard {
+        public:
+            explicit TempFileGuard(std::filesystem::path path) noexcept : m_path(std::move(path)) {}
+
+            ~TempFileGuard() {
+                if (!m_path.empty()) {
+                    std::error_code ec;
+                    std::filesystem::remove(m_path, ec);
+                }
+            }
+
+            TempFileGuard(const TempFileGuard &) = delete;
+            TempFileGuard &operator=(const TempFileGuard &) = delete;
+
+            [[nodiscard]] const std::filesystem::path &path() const noexcept { return m_path; }
+
+            void release() noexcept { m_path.clear(); }
+
+        private:
+            std::filesystem::path m_path;
+    };
+} // namespace
+
+// Tính hash file (SHA256)
+FileHash FileService::computeFileHash(const std::string &filePath) {
+    std::ifstream file(filePath, std::ios::binary);
+    if (!file.is_open()) { throw std::runtime_error("Error, cannot open file: " + filePath); }
+
+    Sha256Stream digest;
+
+    std::vector<char> buffer(kIoBufferSize);
+    while (file.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) ||
+           file.gcount() > 0) {
+        digest.update(buffer.data(), static_cast<std::size_t>(file.gcount()));
+    }
+
+    return digest.finalDigest();
 }
 
 // Thêm file vào DB kèm hash
 // NOLINTNEXTLINE
 sqlite3_int64 FileService::addFileResource(const std::string &filepath, const std::string &title,
                                            ResourceType type, bool isManaged) {
-    // Tính hash của file
-    std::string hash = computeFileHash(filepath);
+    auto stored = prepareFile(filepath, isManaged);
+    return registerFile(stored, filepath, title, type, isManaged).first;
+}
 
+FileService::StoredFile FileService::prepareFile(const std::string &filepath,
+                                                 bool isManaged) const {
+    // Hash và copy trong cùng một lượt đọc, file chỉ xuất hiện trong storage khi đã hoàn chỉnh
+    if (isManaged) { return hashAndCopyToStorage(filepath); }
+
+    return StoredFile{.hash = computeFileHash(filepath), .storedPath = filepath, .isNewCopy = false};
+}
+
+// NOLINTNEXTLINE
+std::pair<sqlite3_int64, bool> FileService::registerFile(const StoredFile &stored,
+                                                         const std::string &filepath,
+                                                         const std::string &title,
+                                                         ResourceType type, bool isManaged) {
     // Kiểm tra hash có tồn tại chưa
-    auto existing = m_resRepo.getByFileHash(hash);
-    if (existing.has_value()) { return existing->id; } // đã tồn tại -> trả về resource_id
-
-    std::string storedPath;
-    if (isManaged) {
-        storedPath = copyToStorage(filepath, hash);
-    } else {
-        storedPath = filepath;
+    auto existing = m_resRepo.getByFileHash(stored.hash);
+    if (existing.has_value()) {
+        // Resource đã có (vd: trước đó chỉ link ngoài) -> bỏ bản copy vừa tạo
+        discardCopy(stored);
+        return {existing->id, false}; // đã tồn tại -> trả về resource_id
     }
 
     sqlite3_int64 resourceId =
-        m_resRepo.insert({.title = title, .type = type, .file_hash = hash}); // NOLINT
+        m_resRepo.insert({.title = title, .type = type, .file_hash = stored.hash}); // NOLINT
+
+    m_fileRepo.insertFile(resourceId, stored.storedPath, filepath, isManaged);
+
+    return {resourceId, true};
+}
 
-    m_fileRepo.insertFile(resourceId, storedPath, filepath, isManaged);
+// Cùng nội dung thì cùng đường dẫn <hash><ext>: chỉ bản commit đầu tiên có isNewCopy, các file
+// trùng còn lại dùng chung bản đó và có thể đã được ghi vào DB trước
+void FileService::discardCopy(const StoredFile &stored) {
+    if (!stored.isNewCopy || m_fileRepo.getResourceIdBystoredPath(stored.storedPath)) { return; }
 
-    return resourceId;
+    std::error_code ec;
+    std::filesystem::remove(stored.storedPath, ec);
 }
 
 // Kiểm tra file đã được index chưa
@@ -89,7 +152,7 @@ std::optional<sqlite3_int64> FileService::findResourceByFile(const std::string &
     if (byOriginal.has_value()) { return byOriginal; }
 
     // Kiểm tra theo hash
-    std::string hash = computeFileHash(filepath);
+    const auto hash = computeFileHash(filepath);
     auto byHash = m_resRepo.getByFileHash(hash);
     if (byHash.has_value()) { return byHash->id; }
 
@@ -109,23 +172,128 @@ void FileService::refreshFileHash(sqlite3_int64 resourceId) {
                                  std::to_string(resourceId));
     }
 
-    std::string newHash = computeFileHash(*entry.stored_path);
+    const auto newHash = computeFileHash(*entry.stored_path);
     m_resRepo.updateFileHash(resourceId, newHash);
 }
 
-// NOLINTNEXTLINE
-std::string FileService::copyToStorage(const std::string &srcPath, const std::string &hash) {
+std::vector<sqlite3_int64>
+    FileService::applyLinkedChanges(const std::vector<LinkedFileChange> &changes) {
+    std::vector<sqlite3_int64> failed;
+    if (changes.empty()) { return failed; }
+
+    auto exec = [this](const char* sql) {
+        SQLiteStmt stmt(m_db.get(), sql);
+        if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+            throw std::runtime_error(std::string("Apply linked changes failed: ") +
+                                     sqlite3_errmsg(m_db.get()));
+        }
+    };
+
+    exec("BEGIN TRANSACTION;");
+
+    try {
+        for (const auto &change : changes) {
+            exec("SAVEPOINT linked_change;");
+            try {
+                using Kind = LinkedFileChange::Kind;
+
+                if (change.kind == Kind::missing) {
+                    m_fileRepo.setMissing(change.resource_id, true);
+                } else {
+                    if (change.kind == Kind::moved) {
+                        m_fileRepo.updateFile(change.resource_id, change.path, change.path,
+                                              false);
+                    }
+                    if (change.hash.has_value()) {
+                        m_resRepo.updateFileHash(change.resource_id, *change.hash);
+                    }
+                    m_fileRepo.setMissing(change.resource_id, false);
+                }
+
+                exec("RELEASE linked_change;");
+
+            } catch (const std::exception &) {
+                exec("ROLLBACK TO linked_change;");
+                exec("RELEASE linked_change;");
+                failed.push_back(change.resource_id);
+            }
+        }
+
+        exec("COMMIT;");
+
+    } catch (...) {
+        SQLiteStmt rollbackStmt(m_db.get(), "ROLLBACK;");
+        sqlite3_step(rollbackStmt.get());
+        throw;
+    }
+
+    return failed;
+}
+
+// Đọc file nguồn theo từng block: mỗi block vừa cập nhật digest vừa ghi ra file tạm trong storage.
+// Khi xong mới commit (link không ghi đè, cùng filesystem) vào vị trí <hash><ext> của ContentStore.
+FileService::StoredFile FileService::hashAndCopyToStorage(const std::string &srcPath) const {
     namespace fs = std::filesystem;
 
-    fs::path storageDir = "resources";
-    if (!fs::exists(storageDir)) { fs::create_directories(storageDir); }
+    std::ifstream src(srcPath, std::ios::binary);
+    if (!src.is_open()) { throw std::runtime_error("Error, cannot open file: " + srcPath); }
 
-    fs::path ext = fs::path(srcPath).extension();
-    fs::path dest = storageDir / (hash + ext.string());
+    TempFileGuard tmp(m_store.makeTempPath());
+    std::ofstream dst(tmp.path(), std::ios::binary | std::ios::trunc);
+    if (!dst.is_open()) {
+        throw std::runtime_error("Error, cannot create temp file: " + tmp.path().string());
+    }
+
+    Sha256Stream digest;
+
+    std::vector<char> buffer(kIoBufferSize);
+    while (src.read(buffer.data(), static_cast<std::streamsize>(buffer.size())) ||
+           src.gcount() > 0) {
+        const auto count = src.gcount();
+        digest.update(buffer.data(), static_cast<std::size_t>(count));
+        if (!dst.write(buffer.data(), count)) {
+            throw std::runtime_error("Error, write failed: " + tmp.path().string());
+        }
+    }
+
+    dst.close();
+    if (dst.fail()) { throw std::runtime_error("Error, flush failed: " + tmp.path().string()); }
+
+    const auto hash = digest.finalDigest();
+    fs::path dest = m_store.pathFor(fileHashToHex(hash), fs::path(srcPath).extension().string());
 
-    fs::copy_file(srcPath, dest, fs::copy_options::skip_existing);
+    // Đã có bản copy cùng nội dung -> giữ bản cũ, file tạm tự bị xóa
+    const bool isNewCopy = m_store.commit(tmp.path(), dest);
+    if (isNewCopy) { tmp.release(); }
 
-    if (!fs::exists(storageDir)) { std::cout << "path not exist"; } // here
+    return StoredFile{.hash = hash, .storedPath = dest.string(), .isNewCopy = isNewCopy};
+}
+
+// Chuyển storage phẳng cũ (<root>/<hash><ext>) sang layout sharded và cập nhật stored_path.
+// DB được cập nhật (và commit) trước khi đụng tới file: lỗi ở DB thì chưa file nào bị chuyển,
+// lỗi lúc chuyển file thì file về chỗ cũ và stored_path được trả về đường dẫn phẳng
+std::size_t FileService::migrateFlatStorage() {
+    const auto plan = m_store.planFlatMigration();
+    if (plan.empty()) { return 0; }
+
+    std::vector<std::pair<std::string, std::string>> relinks;
+    relinks.reserve(plan.size());
+    for (const auto &entry : plan) {
+        relinks.emplace_back(entry.from.filename().string(), entry.to.string());
+    }
+    m_fileRepo.relinkStoredFiles(relinks);
+
+    try {
+        m_store.applyMigration(plan);
+    } catch (...) {
+        std::vector<std::pair<std::string, std::string>> restores;
+        restores.reserve(plan.size());
+        for (const auto &entry : plan) {
+            restores.emplace_back(entry.to.string(), entry.from.string());
+        }
+        m_fileRepo.updateStoredPaths(restores);
+        throw;
+    }
 
-    return dest.string();
+    return plan.size();
 }
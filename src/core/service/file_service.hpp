@@ -2,8 +2,11 @@
 
 #include <string>
 #include <optional>
+#include <utility>
+#include <vector>
 #include <sqlite3.h>
 #include "model.hpp"
+#include "content_store.hpp"
 
 class SQLiteDB;
 class FileRepository;
@@ -11,11 +14,11 @@ class ResourceRepository;
 
 class FileService {
     public:
-        FileService(SQLiteDB &db, FileRepository &fileRepo, ResourceRepository &resRepo) noexcept
+        FileService(SQLiteDB &db, FileRepository &fileRepo, ResourceRepository &resRepo)
             : m_db(db), m_fileRepo(fileRepo), m_resRepo(resRepo) {}
 
         // Tính hash file (SHA256)
-        static std::string computeFileHash(const std::string &filePath);
+        static FileHash computeFileHash(const std::string &filePath);
 
         // Thêm file vào DB kèm hash
         // filepath: đường dẫn gốc user chọn
@@ -25,17 +28,53 @@ class FileService {
         sqlite3_int64 addFileResource(const std::string &filepath, const std::string &title,
                                       ResourceType type, bool isManaged);
 
+        struct StoredFile {
+                FileHash hash{};
+                std::string storedPath;
+                bool isNewCopy{}; // false nếu storage đã có sẵn file cùng hash
+        };
+
+        // Hai bước của addFileResource, tách ra để import hàng loạt chạy song song:
+        // prepareFile chỉ đọc file/ghi storage (an toàn khi gọi từ nhiều thread),
+        // registerFile ghi DB (chỉ gọi từ thread sở hữu connection)
+        [[nodiscard]] StoredFile prepareFile(const std::string &filepath, bool isManaged) const;
+
+        // second = false nếu file trùng hash với resource đã có (first là id cũ)
+        std::pair<sqlite3_int64, bool> registerFile(const StoredFile &stored,
+                                                    const std::string &filepath,
+                                                    const std::string &title, ResourceType type,
+                                                    bool isManaged);
+
+        // Xóa bản copy mới tạo (isNewCopy) của file không được ghi vào DB. Bỏ qua nếu có dòng
+        // files trỏ tới đường dẫn đó: file khác cùng nội dung (import song song) đã được ghi với
+        // đúng bản copy này. Chỉ gọi từ thread sở hữu connection
+        void discardCopy(const StoredFile &stored);
+
         // Kiểm tra file đã được index chưa
         std::optional<sqlite3_int64> findResourceByFile(const std::string &filepath);
 
         // Đồng bộ lại hash (khi file thay đổi nội dung)
         void refreshFileHash(sqlite3_int64 resourceId);
 
+        // Ghi các thay đổi của file linked (hash, đường dẫn, tombstone) trong một transaction.
+        // Mỗi thay đổi có savepoint riêng; trả về id các thay đổi bị bỏ qua do lỗi
+        // (vd: nội dung mới trùng hash với resource khác)
+        std::vector<sqlite3_int64> applyLinkedChanges(const std::vector<LinkedFileChange> &changes);
+
+        // Thư mục lưu trữ file managed (lấy từ AppSettings::resourceDir)
+        void setContentStore(ContentStore store) noexcept { m_store = std::move(store); }
+
+        [[nodiscard]] const ContentStore &contentStore() const noexcept { return m_store; }
+
+        // Di chuyển file managed từ layout phẳng cũ sang layout sharded, trả về số file đã chuyển
+        std::size_t migrateFlatStorage();
+
     private:
         SQLiteDB &m_db;
         FileRepository &m_fileRepo;
         ResourceRepository &m_resRepo;
+        ContentStore m_store;
 
-        // Helper: copy file vào storage (nếu isManaged = true)
-        static std::string copyToStorage(const std::string &srcPath, const std::string &hash);
+        // Helper: hash + copy file vào storage trong một lượt đọc (nếu isManaged = true)
+        [[nodiscard]] StoredFile hashAndCopyToStorage(const std::string &srcPath) const;
 };
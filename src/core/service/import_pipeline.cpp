@@ -0,0 +1,362 @@
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <sqlite3.h>
+#include "import_pipeline.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+#include "resource_repository.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    double perSecond(std::uint64_t count, std::chrono::steady_clock::duration elapsed) {
+        const double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+    }
+} // namespace
+
+ImportPipeline::ImportPipeline(SQLiteDB &db, FileService &fileService,
+                               ResourceRepository &resRepo, Options options,
+                               ProgressCallback onProgress)
+    : m_db(db), m_fileService(fileService), m_resRepo(resRepo), m_options(std::move(options)),
+      m_onProgress(std::move(onProgress)), m_scanQueue(m_options.queueCapacity),
+      m_hashQueue(m_options.queueCapacity) {
+    if (m_options.hashThreads == 0) {
+        m_options.hashThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    if (m_options.batchSize == 0) { m_options.batchSize = 1; }
+}
+
+ImportPipeline::~ImportPipeline() {
+    cancel();
+    wait();
+}
+
+void ImportPipeline::start() {
+    if (m_running.exchange(true)) { return; }
+
+    m_startTime = std::chrono::steady_clock::now();
+    m_lastReport = m_startTime;
+    m_activeHashers.store(m_options.hashThreads);
+
+    m_threads.reserve(m_options.hashThreads + 2);
+    m_threads.emplace_back([this] { scanStage(); });
+    for (unsigned i = 0; i < m_options.hashThreads; ++i) {
+        m_threads.emplace_back([this] { hashStage(); });
+    }
+    m_threads.emplace_back([this] { writeStage(); });
+}
+
+void ImportPipeline::wait() {
+    for (auto &t : m_threads) {
+        if (t.joinable()) { t.join(); }
+    }
+    m_threads.clear();
+}
+
+void ImportPipeline::pause() noexcept {
+    m_paused.store(true);
+}
+
+void ImportPipeline::resume() noexcept {
+    m_paused.store(false);
+    m_paused.notify_all();
+}
+
+void ImportPipeline::cancel() noexcept {
+    m_cancelled.store(true);
+    m_scanQueue.close();
+    m_hashQueue.close();
+
+    // Đánh thức các stage đang pause để chúng thấy cờ hủy
+    resume();
+}
+
+bool ImportPipeline::waitIfPaused() const {
+    while (m_paused.load(std::memory_order_acquire)) { m_paused.wait(true); }
+    return !m_cancelled.load(std::memory_order_acquire);
+}
+
+// ------------------------------------------------------------
+// Stage 1: duyệt thư mục, lọc theo loại file được hỗ trợ
+// ------------------------------------------------------------
+void ImportPipeline::scanStage() {
+    namespace fs = std::filesystem;
+
+    std::error_code ec;
+    fs::recursive_directory_iterator it(m_options.root,
+                                        fs::directory_options::skip_permission_denied, ec);
+    if (ec) { setLastError("Cannot scan " + m_options.root.string() + ": " + ec.message()); }
+
+    for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+        if (!waitIfPaused()) { break; }
+
+        const auto &entry = *it;
+        std::error_code statEc;
+        if (!entry.is_regular_file(statEc)) { continue; }
+
+        const auto pathStr = entry.path().string();
+        auto typeOpt = resourceTypeFromFile(pathStr);
+        if (!typeOpt.has_value()) {
+            m_skipped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        const std::uint64_t size = entry.file_size(statEc);
+
+        ScanItem item{.path = pathStr,
+                      .title = entry.path().stem().string(),
+                      .type = *typeOpt,
+                      .size = statEc ? 0 : size};
+
+        if (!m_scanQueue.push(std::move(item), m_cancelled)) { break; }
+
+        m_scanned.fetch_add(1, std::memory_order_relaxed);
+        m_scannedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    if (ec && !m_cancelled.load()) { setLastError("Scan stopped: " + ec.message()); }
+
+    m_scanFinished.store(true, std::memory_order_release);
+    m_scanQueue.close();
+}
+
+// ------------------------------------------------------------
+// Stage 2: hash (và copy vào storage nếu managed), chạy song song
+// ------------------------------------------------------------
+void ImportPipeline::hashStage() {
+    ScanItem item;
+    while (m_scanQueue.pop(item, m_cancelled)) {
+        if (!waitIfPaused()) { break; }
+
+        HashedItem hashed;
+        try {
+            hashed.stored = m_fileService.prepareFile(item.path, m_options.isManaged);
+        } catch (const std::exception &ex) { hashed.error = ex.what(); }
+
+        m_hashed.fetch_add(1, std::memory_order_relaxed);
+        m_hashedBytes.fetch_add(item.size, std::memory_order_relaxed);
+
+        hashed.item = std::move(item);
+        // push nhận item theo giá trị (đã bị move kể cả khi thất bại) nên giữ lại thông tin copy
+        const auto stored = hashed.stored;
+        if (!m_hashQueue.push(std::move(hashed), m_cancelled)) {
+            // Bị hủy: bản copy vừa tạo sẽ không được ghi vào DB
+            deferDiscard(stored);
+            break;
+        }
+    }
+
+    // Thread hash cuối cùng đóng queue cho stage ghi DB
+    if (m_activeHashers.fetch_sub(1) == 1) { m_hashQueue.close(); }
+    m_activeHashers.notify_all();
+}
+
+// ------------------------------------------------------------
+// Stage 3: dedupe + ghi DB theo batch (một transaction cho nhiều file)
+// ------------------------------------------------------------
+void ImportPipeline::writeStage() {
+    using clock = std::chrono::steady_clock;
+
+    std::size_t inBatch{0};
+    clock::time_point batchStart{};
+
+    auto commitBatch = [&] {
+        if (inBatch == 0) { return; }
+        execSql("COMMIT;");
+        inBatch = 0;
+    };
+
+    auto processItem = [&](HashedItem &hashed) {
+        if (!hashed.error.empty()) {
+            m_failed.fetch_add(1, std::memory_order_relaxed);
+            setLastError(hashed.item.path + ": " + hashed.error);
+            return;
+        }
+
+        if (inBatch == 0) {
+            execSql("BEGIN TRANSACTION;");
+            batchStart = clock::now();
+        }
+        ++inBatch;
+
+        // Savepoint cho từng file: lỗi một file không làm hỏng cả batch
+        execSql("SAVEPOINT import_item;");
+        try {
+            std::string title = hashed.item.title;
+            if (m_resRepo.existsTitle(title, hashed.item.type)) {
+                // Trùng tiêu đề (vd: nhiều README.txt) -> dùng đường dẫn tương đối
+                title = std::filesystem::path(hashed.item.path)
+                            .lexically_relative(m_options.root)
+                            .generic_string();
+            }
+
+            const auto registered = m_fileService.registerFile(
+                hashed.stored, hashed.item.path, title, hashed.item.type, m_options.isManaged);
+
+            if (registered.second) {
+                m_written.fetch_add(1, std::memory_order_relaxed);
+                m_writtenBytes.fetch_add(hashed.item.size, std::memory_order_relaxed);
+            } else {
+                m_duplicates.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            execSql("RELEASE import_item;");
+
+        } catch (const std::exception &ex) {
+            execSql("ROLLBACK TO import_item;");
+            execSql("RELEASE import_item;");
+
+            deferDiscard(hashed.stored);
+
+            m_failed.fetch_add(1, std::memory_order_relaxed);
+            setLastError(hashed.item.path + ": " + ex.what());
+        }
+    };
+
+    try {
+        HashedItem hashed;
+        for (;;) {
+            // Không giữ transaction mở trong lúc pause
+            if (m_paused.load(std::memory_order_relaxed)) { commitBatch(); }
+            if (!waitIfPaused()) { break; }
+
+            // Chờ item không quá hạn báo tiến độ, và hạn commit nếu đang có batch mở
+            auto deadline = m_lastReport + m_options.reportInterval;
+            if (inBatch > 0) {
+                deadline = std::min(deadline, batchStart + m_options.maxBatchLatency);
+            }
+
+            // closed đọc trước pop: pop thất bại sau đó nghĩa là queue đã đóng và rỗng
+            const bool closed = m_hashQueue.isClosed();
+            if (m_hashQueue.pop(hashed, m_cancelled, deadline)) {
+                processItem(hashed);
+                hashed = HashedItem{};
+                if (inBatch >= m_options.batchSize) { commitBatch(); }
+            } else if (closed) {
+                break;
+            } else if (inBatch > 0 && clock::now() - batchStart >= m_options.maxBatchLatency) {
+                // Hash chậm hơn ghi DB: không giữ transaction mở quá lâu
+                commitBatch();
+            }
+
+            if (clock::now() - m_lastReport >= m_options.reportInterval) { report(false); }
+        }
+
+        commitBatch();
+
+    } catch (const std::exception &ex) {
+        setLastError(ex.what());
+        if (inBatch > 0) {
+            try {
+                execSql("ROLLBACK;");
+            } catch (const std::exception &) {} // NOLINT(bugprone-empty-catch)
+        }
+        m_cancelled.store(true);
+        m_scanQueue.close();
+        m_hashQueue.close();
+    }
+
+    // Hủy giữa chừng: dọn các bản copy đã vào storage nhưng chưa kịp ghi DB. Chờ mọi thread
+    // hash thoát trước (queue đã đóng nên chúng không còn chờ push), nếu không bản copy của
+    // thread còn đang trong prepareFile sẽ lọt qua
+    for (auto active = m_activeHashers.load(); active != 0; active = m_activeHashers.load()) {
+        m_activeHashers.wait(active);
+    }
+    HashedItem leftover;
+    while (m_hashQueue.tryPop(leftover)) { deferDiscard(leftover.stored); }
+    discardUnwrittenCopies();
+
+    m_running.store(false, std::memory_order_release);
+    report(true);
+}
+
+void ImportPipeline::deferDiscard(const FileService::StoredFile &stored) {
+    if (!stored.isNewCopy) { return; }
+
+    std::lock_guard lock(m_copiesMutex);
+    m_unwrittenCopies.push_back(stored.storedPath);
+}
+
+// Chạy trên thread ghi DB sau khi mọi thread hash đã thoát. Đường dẫn còn dòng files trỏ tới
+// (file trùng nội dung đã ghi) được giữ; lỗi đọc DB thì thà để sót file còn hơn xóa nhầm
+void ImportPipeline::discardUnwrittenCopies() noexcept {
+    std::lock_guard lock(m_copiesMutex);
+    for (auto &path : m_unwrittenCopies) {
+        try {
+            m_fileService.discardCopy({.storedPath = std::move(path), .isNewCopy = true});
+        } catch (const std::exception &) {} // NOLINT(bugprone-empty-catch)
+    }
+    m_unwrittenCopies.clear();
+}
+
+void ImportPipeline::execSql(const char* sql) {
+    SQLiteStmt stmt(m_db.get(), sql);
+    if (sqlite3_step(stmt.get()) != SQLITE_DONE) {
+        throw std::runtime_error(std::string("Import SQL failed: ") + sql + " " +
+                                 sqlite3_errmsg(m_db.get()));
+    }
+}
+
+void ImportPipeline::setLastError(std::string message) {
+    std::lock_guard lock(m_errorMutex);
+    m_lastError = std::move(message);
+}
+
+ImportProgress ImportPipeline::snapshot() const {
+    const auto elapsed = std::chrono::steady_clock::now() - m_startTime;
+
+    ImportProgress p;
+    p.scanned.items = m_scanned.load(std::memory_order_relaxed);
+    p.scanned.bytes = m_scannedBytes.load(std::memory_order_relaxed);
+    p.hashed.items = m_hashed.load(std::memory_order_relaxed);
+    p.hashed.bytes = m_hashedBytes.load(std::memory_order_relaxed);
+    p.written.items = m_written.load(std::memory_order_relaxed);
+    p.written.bytes = m_writtenBytes.load(std::memory_order_relaxed);
+    p.duplicates = m_duplicates.load(std::memory_order_relaxed);
+    p.skipped = m_skipped.load(std::memory_order_relaxed);
+    p.failed = m_failed.load(std::memory_order_relaxed);
+
+    for (auto* stage : {&p.scanned, &p.hashed, &p.written}) {
+        stage->itemsPerSec = perSecond(stage->items, elapsed);
+        stage->bytesPerSec = perSecond(stage->bytes, elapsed);
+    }
+
+    p.scanFinished = m_scanFinished.load(std::memory_order_acquire);
+    p.paused = m_paused.load(std::memory_order_relaxed);
+    p.cancelled = m_cancelled.load(std::memory_order_relaxed);
+    p.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed);
+
+    // ETA theo tốc độ của stage chậm nhất (hash hoặc ghi DB)
+    const std::uint64_t done = p.written.items + p.duplicates + p.failed;
+    const double rate = perSecond(done, elapsed);
+    if (p.scanFinished && rate > 0.0 && p.scanned.items >= done) {
+        const double remaining = static_cast<double>(p.scanned.items - done);
+        p.eta = std::chrono::seconds(static_cast<std::int64_t>(remaining / rate));
+    }
+
+    {
+        std::lock_guard lock(m_errorMutex);
+        p.lastError = m_lastError;
+    }
+
+    return p;
+}
+
+void ImportPipeline::report(bool finished) {
+    m_lastReport = std::chrono::steady_clock::now();
+    if (!m_onProgress) { return; }
+
+    auto progress = snapshot();
+    progress.finished = finished;
+    if (finished) { progress.eta = std::chrono::seconds(0); }
+
+    m_onProgress(progress);
+}
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sqlite3.h>
+#include "model.hpp"
+#include "file_service.hpp"
+#include "bounded_queue.hpp"
+
+class SQLiteDB;
+class ResourceRepository;
+
+// Tiến độ import, gửi định kỳ qua ProgressCallback
+struct ImportProgress {
+        struct Stage {
+                std::uint64_t items{};
+                std::uint64_t bytes{};
+                double itemsPerSec{};
+                double bytesPerSec{};
+        };
+
+        Stage scanned;             // file hợp lệ tìm được khi duyệt thư mục
+        Stage hashed;              // file đã hash (+ copy nếu managed)
+        Stage written;             // resource mới đã ghi vào DB
+        std::uint64_t duplicates{}; // trùng hash với resource đã có
+        std::uint64_t skipped{};    // không nhận dạng được loại file
+        std::uint64_t failed{};     // lỗi đọc file / lỗi ghi DB
+
+        bool scanFinished{};
+        bool paused{};
+        bool cancelled{};
+        bool finished{};
+
+        std::chrono::milliseconds elapsed{};
+        std::optional<std::chrono::seconds> eta; // chỉ có khi đã duyệt xong thư mục
+
+        std::string lastError;
+};
+
+// Import cả thư mục theo pipeline 3 stage nối bằng BoundedQueue:
+//   scan (1 thread) -> hash/copy (N thread) -> ghi DB theo batch (1 thread)
+// Queue đầy thì stage trước phải chờ (backpressure), nên bộ nhớ không phụ thuộc số file.
+// Thread ghi DB dùng chung connection với UI: caller phải chặn ghi từ UI trong lúc import.
+class ImportPipeline {
+    public:
+        struct Options {
+                std::filesystem::path root;
+                bool isManaged{};
+                unsigned hashThreads{};        // 0 = theo hardware_concurrency
+                std::size_t queueCapacity{256};
+                std::size_t batchSize{256};    // số file mỗi transaction
+                std::chrono::milliseconds maxBatchLatency{200};
+                std::chrono::milliseconds reportInterval{250};
+        };
+
+        using ProgressCallback = std::function<void(const ImportProgress &)>;
+
+        ImportPipeline(SQLiteDB &db, FileService &fileService, ResourceRepository &resRepo,
+                       Options options, ProgressCallback onProgress = {});
+        ~ImportPipeline();
+
+        ImportPipeline(const ImportPipeline &) = delete;
+        ImportPipeline &operator=(const ImportPipeline &) = delete;
+
+        void start();
+        void wait();
+
+        void pause() noexcept;
+        void resume() noexcept;
+        void cancel() noexcept;
+
+        [[nodiscard]] bool isPaused() const noexcept {
+            return m_paused.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] bool isRunning() const noexcept {
+            return m_running.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] ImportProgress snapshot() const;
+
+    private:
+        struct ScanItem {
+                std::string path;
+                std::string title;
+                ResourceType type{};
+                std::uint64_t size{};
+        };
+
+        struct HashedItem {
+                ScanItem item;
+                FileService::StoredFile stored;
+                std::string error; // rỗng nếu hash thành công
+        };
+
+        void scanStage();
+        void hashStage();
+        void writeStage();
+
+        // Block khi đang pause; trả về false nếu đã bị hủy
+        bool waitIfPaused() const;
+
+        // Bản copy vào storage của một file không được ghi vào DB (managed): chỉ ghi nhận, xóa ở
+        // cuối writeStage khi mọi file đã ghi xong, vì file trùng nội dung có thể dùng chung nó
+        void deferDiscard(const FileService::StoredFile &stored);
+        void discardUnwrittenCopies() noexcept;
+        void execSql(const char* sql);
+        void report(bool finished);
+        void setLastError(std::string message);
+
+        SQLiteDB &m_db;
+        FileService &m_fileService;
+        ResourceRepository &m_resRepo;
+        Options m_options;
+        ProgressCallback m_onProgress;
+
+        BoundedQueue<ScanItem> m_scanQueue;
+        BoundedQueue<HashedItem> m_hashQueue;
+
+        std::atomic<bool> m_paused{false};
+        std::atomic<bool> m_cancelled{false};
+        std::atomic<bool> m_running{false};
+        std::atomic<bool> m_scanFinished{false};
+        std::atomic<unsigned> m_activeHashers{0};
+
+        std::atomic<std::uint64_t> m_scanned{0};
+        std::atomic<std::uint64_t> m_scannedBytes{0};
+        std::atomic<std::uint64_t> m_hashed{0};
+        std::atomic<std::uint64_t> m_hashedBytes{0};
+        std::atomic<std::uint64_t> m_written{0};
+        std::atomic<std::uint64_t> m_writtenBytes{0};
+        std::atomic<std::uint64_t> m_duplicates{0};
+        std::atomic<std::uint64_t> m_skipped{0};
+        std::atomic<std::uint64_t> m_failed{0};
+
+        mutable std::mutex m_errorMutex;
+        std::string m_lastError;
+
+        std::mutex m_copiesMutex;
+        std::vector<std::string> m_unwrittenCopies;
+
+        std::chrono::steady_clock::time_point m_startTime;
+        std::chrono::steady_clock::time_point m_lastReport;
+
+        std::vector<std::jthread> m_threads;
+};
@@ -0,0 +1,396 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "linked_file_watcher.hpp"
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+
+#if defined(__linux__)
+#include <cerrno>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    namespace fs = std::filesystem;
+
+#if defined(__linux__)
+    constexpr std::uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE |
+                                         IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+                                         IN_MOVE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+    constexpr std::size_t kEventBufferSize{64 * 1024};
+#endif
+
+    std::string parentDir(const std::string &path) {
+        return fs::path(path).parent_path().string();
+    }
+} // namespace
+
+LinkedFileWatcher::LinkedFileWatcher(FileRepository &fileRepo, FileService &fileService,
+                                     Options options)
+    : m_fileRepo(fileRepo), m_fileService(fileService), m_options(options) {}
+
+LinkedFileWatcher::~LinkedFileWatcher() {
+    stop();
+}
+
+std::size_t LinkedFileWatcher::start() {
+    if (m_started) { return 0; }
+
+#if defined(__linux__)
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) { m_lastError = std::string("inotify_init1 failed: ") + std::strerror(errno); }
+#endif
+
+    m_started = true;
+
+    return rescan();
+}
+
+void LinkedFileWatcher::stop() noexcept {
+#if defined(__linux__)
+    if (m_fd >= 0) { ::close(m_fd); } // đóng fd => kernel tự gỡ mọi watch
+#endif
+    m_fd = -1;
+    m_started = false;
+
+    m_dirToWatch.clear();
+    m_watchToDir.clear();
+    m_pending.clear();
+    m_moveCookies.clear();
+}
+
+bool LinkedFileWatcher::isSettled(clock::time_point now) const noexcept {
+    return !m_pending.empty() && now - m_lastEvent >= m_options.debounce;
+}
+
+bool LinkedFileWatcher::needsRescan(clock::time_point now) const noexcept {
+    return m_started && (m_needRescan || now - m_lastRescan >= m_options.rescanInterval);
+}
+
+// ------------------------------------------------------------
+// Danh sách file linked + watch thư mục cha
+// ------------------------------------------------------------
+void LinkedFileWatcher::loadFromDb() {
+    std::unordered_map<sqlite3_int64, Tracked> tracked;
+    std::unordered_map<std::string, sqlite3_int64> byPath;
+
+    for (auto &row : m_fileRepo.getLinkedFiles()) {
+        Tracked t{.path = std::move(row.path),
+                  .hash = std::move(row.file_hash),
+                  .missing = row.is_missing};
+
+        // Giữ size/mtime đã biết nếu đường dẫn không đổi, để rescan phát hiện được thay đổi.
+        // File mới (hoặc lần load đầu) chỉ lấy stat hiện tại: coi hash trong DB là đúng
+        auto old = m_tracked.find(row.resource_id);
+        if (old != m_tracked.end() && old->second.path == t.path) {
+            t.size = old->second.size;
+            t.mtime = old->second.mtime;
+        } else {
+            std::error_code ec;
+            t.size = fs::file_size(t.path, ec);
+            if (ec) { t.size = 0; }
+            t.mtime = fs::last_write_time(t.path, ec);
+        }
+
+        byPath.emplace(t.path, row.resource_id);
+        tracked.emplace(row.resource_id, std::move(t));
+    }
+
+    m_tracked = std::move(tracked);
+    m_byPath = std::move(byPath);
+}
+
+void LinkedFileWatcher::syncWatches() {
+#if defined(__linux__)
+    if (m_fd < 0) { return; }
+
+    std::unordered_set<std::string> wanted;
+    for (const auto &[id, t] : m_tracked) { wanted.insert(parentDir(t.path)); }
+
+    // Gỡ watch của thư mục không còn file linked nào
+    for (auto it = m_dirToWatch.begin(); it != m_dirToWatch.end();) {
+        if (wanted.contains(it->first)) {
+            ++it;
+            continue;
+        }
+        inotify_rm_watch(m_fd, it->second);
+        m_watchToDir.erase(it->second);
+        it = m_dirToWatch.erase(it);
+    }
+
+    for (const auto &dir : wanted) {
+        if (dir.empty() || m_dirToWatch.contains(dir)) { continue; }
+
+        const int wd = inotify_add_watch(m_fd, dir.c_str(), kWatchMask);
+        if (wd < 0) { continue; } // thư mục không còn: file sẽ bị đánh dấu missing khi rescan
+
+        m_dirToWatch.emplace(dir, wd);
+        m_watchToDir[wd] = dir;
+    }
+#endif
+}
+
+// ------------------------------------------------------------
+// Sự kiện inotify -> thay đổi chờ ghi (gom theo resource)
+// ------------------------------------------------------------
+std::size_t LinkedFileWatcher::readEvents() {
+    std::size_t count{0};
+
+#if defined(__linux__)
+    if (m_fd < 0) { return 0; }
+
+    alignas(inotify_event) std::array<char, kEventBufferSize> buffer{};
+
+    for (;;) {
+        const ssize_t len = ::read(m_fd, buffer.data(), buffer.size());
+        if (len <= 0) { break; } // EAGAIN: đã đọc hết
+
+        for (std::size_t offset = 0; offset < static_cast<std::size_t>(len);) {
+            inotify_event event{};
+            std::memcpy(&event, buffer.data() + offset, sizeof(inotify_event));
+
+            const char* namePtr = buffer.data() + offset + sizeof(inotify_event);
+            const std::string_view name(namePtr, event.len > 0 ? std::strlen(namePtr) : 0);
+
+            handleEvent(event.wd, event.mask, event.cookie, name);
+
+            offset += sizeof(inotify_event) + event.len;
+            ++count;
+        }
+    }
+#endif
+
+    return count;
+}
+
+void LinkedFileWatcher::handleEvent(int wd, std::uint32_t mask, std::uint32_t cookie,
+                                    std::string_view name) {
+#if defined(__linux__)
+    using Kind = LinkedFileChange::Kind;
+
+    // Queue của kernel bị tràn: không còn biết chắc gì đã thay đổi
+    if ((mask & IN_Q_OVERFLOW) != 0U) {
+        m_needRescan = true;
+        return;
+    }
+
+    auto dirIt = m_watchToDir.find(wd);
+    if (dirIt == m_watchToDir.end()) { return; } // watch đã bị gỡ
+
+    // Chính thư mục bị xóa/di chuyển: không biết đường dẫn mới => rescan
+    if ((mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) != 0U) {
+        m_needRescan = true;
+        if ((mask & IN_IGNORED) != 0U) {
+            m_dirToWatch.erase(dirIt->second);
+            m_watchToDir.erase(dirIt);
+        }
+        return;
+    }
+
+    if (name.empty() || (mask & IN_ISDIR) != 0U) { return; }
+
+    const std::string path = (fs::path(dirIt->second) / name).string();
+    auto byPathIt = m_byPath.find(path);
+
+    if ((mask & IN_MOVED_FROM) != 0U) {
+        if (byPathIt == m_byPath.end()) { return; }
+        // Nếu không có IN_MOVED_TO cùng cookie (chuyển ra ngoài vùng watch) -> missing
+        m_moveCookies[cookie] = byPathIt->second;
+        markPending(byPathIt->second, Kind::missing);
+        return;
+    }
+
+    if ((mask & IN_MOVED_TO) != 0U) {
+        if (auto cookieIt = m_moveCookies.find(cookie); cookieIt != m_moveCookies.end()) {
+            markPending(cookieIt->second, Kind::moved, path);
+            m_moveCookies.erase(cookieIt);
+        }
+        // Editor lưu kiểu "ghi file tạm rồi rename đè": nội dung file đang theo dõi đã đổi
+        if (byPathIt != m_byPath.end()) { markPending(byPathIt->second, Kind::modified); }
+        return;
+    }
+
+    if (byPathIt == m_byPath.end()) { return; }
+
+    if ((mask & IN_DELETE) != 0U) {
+        markPending(byPathIt->second, Kind::missing);
+    } else {
+        // IN_CREATE (file được tạo lại), IN_MODIFY, IN_CLOSE_WRITE
+        markPending(byPathIt->second, Kind::modified);
+    }
+#else
+    (void)wd;
+    (void)mask;
+    (void)cookie;
+    (void)name;
+#endif
+}
+
+void LinkedFileWatcher::markPending(sqlite3_int64 id, LinkedFileChange::Kind kind,
+                                    std::string path) {
+    m_lastEvent = clock::now();
+
+    // Sự kiện sau ghi đè sự kiện trước; riêng moved giữ lại đường dẫn mới
+    auto &pending = m_pending[id];
+    if (pending.kind == LinkedFileChange::Kind::moved && kind == LinkedFileChange::Kind::modified &&
+        !pending.path.empty()) {
+        return;
+    }
+    pending.kind = kind;
+    pending.path = std::move(path);
+}
+
+// ------------------------------------------------------------
+// Ghi thay đổi
+// ------------------------------------------------------------
+std::size_t LinkedFileWatcher::flush() {
+    if (m_pending.empty()) { return 0; }
+
+    auto pending = std::move(m_pending);
+    m_pending.clear();
+    m_moveCookies.clear();
+
+    std::vector<LinkedFileChange> changes;
+    changes.reserve(pending.size());
+
+    for (const auto &[id, p] : pending) {
+        auto it = m_tracked.find(id);
+        if (it == m_tracked.end()) { continue; }
+
+        const bool isMove = p.kind == LinkedFileChange::Kind::moved && !p.path.empty();
+        const std::string &path = isMove ? p.path : it->second.path;
+
+        // Sự kiện ghi có thể nằm trong cùng tick mtime => luôn hash lại
+        LinkedFileChange change;
+        if (evaluate(id, it->second, path, true, change)) { changes.push_back(std::move(change)); }
+    }
+
+    return applyChanges(std::move(changes));
+}
+
+std::size_t LinkedFileWatcher::rescan() {
+    m_lastRescan = clock::now();
+    m_needRescan = false;
+
+    // Rescan thay cho các sự kiện đang chờ
+    m_pending.clear();
+    m_moveCookies.clear();
+
+    loadFromDb();
+    syncWatches();
+
+    std::vector<LinkedFileChange> changes;
+    for (auto &[id, tracked] : m_tracked) {
+        LinkedFileChange change;
+        if (evaluate(id, tracked, tracked.path, false, change)) {
+            changes.push_back(std::move(change));
+        }
+    }
+
+    return applyChanges(std::move(changes));
+}
+
+bool LinkedFileWatcher::evaluate(sqlite3_int64 id, Tracked &tracked, const std::string &path,
+                                 bool forceHash, LinkedFileChange &change) {
+    using Kind = LinkedFileChange::Kind;
+
+    change.resource_id = id;
+    change.path = path;
+
+    std::error_code ec;
+    const bool exists = fs::is_regular_file(path, ec);
+    if (!exists) {
+        if (tracked.missing) { return false; }
+        change.kind = Kind::missing;
+        change.path = tracked.path;
+        return true;
+    }
+
+    const auto size = fs::file_size(path, ec);
+    const auto mtime = fs::last_write_time(path, ec);
+    const bool moved = path != tracked.path;
+    const bool statChanged = size != tracked.size || mtime != tracked.mtime;
+
+    tracked.size = size;
+    tracked.mtime = mtime;
+
+    if (!forceHash && !statChanged && !moved && !tracked.missing) { return false; }
+
+    FileHash hash{};
+    try {
+        hash = FileService::computeFileHash(path);
+    } catch (const std::exception &ex) {
+        m_lastError = ex.what();
+        return false;
+    }
+
+    if (hash != tracked.hash) { change.hash = hash; }
+
+    if (moved) {
+        change.kind = Kind::moved;
+    } else if (change.hash.has_value()) {
+        change.kind = Kind::modified;
+    } else if (tracked.missing) {
+        change.kind = Kind::restored;
+    } else {
+        return false; // chỉ đổi mtime, nội dung như cũ
+    }
+
+    return true;
+}
+
+std::size_t LinkedFileWatcher::applyChanges(std::vector<LinkedFileChange> changes) {
+    if (changes.empty()) { return 0; }
+
+    std::ranges::sort(changes, {}, &LinkedFileChange::resource_id);
+
+    std::vector<sqlite3_int64> failed;
+    try {
+        failed = m_fileService.applyLinkedChanges(changes);
+    } catch (const std::exception &ex) {
+        m_lastError = ex.what();
+        m_needRescan = true; // thử lại ở lần rescan sau
+        return 0;
+    }
+
+    bool pathsChanged{false};
+    for (const auto &change : changes) {
+        if (std::ranges::find(failed, change.resource_id) != failed.end()) { continue; }
+
+        auto it = m_tracked.find(change.resource_id);
+        if (it == m_tracked.end()) { continue; }
+        auto &tracked = it->second;
+
+        if (change.kind == LinkedFileChange::Kind::missing) {
+            tracked.missing = true;
+            continue;
+        }
+
+        if (change.kind == LinkedFileChange::Kind::moved && change.path != tracked.path) {
+            m_byPath.erase(tracked.path);
+            m_byPath[change.path] = change.resource_id;
+            tracked.path = change.path;
+            pathsChanged = true;
+        }
+        if (change.hash.has_value()) { tracked.hash = change.hash; }
+        tracked.missing = false;
+    }
+
+    if (!failed.empty()) {
+        m_lastError = std::to_string(failed.size()) + " linked file change(s) could not be saved";
+    }
+
+    if (pathsChanged) { syncWatches(); }
+
+    return changes.size() - failed.size();
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <sqlite3.h>
+#include "model.hpp"
+
+class FileRepository;
+class FileService;
+
+struct LinkedWatchOptions {
+        std::chrono::milliseconds debounce{500};                            // gom burst sự kiện
+        std::chrono::milliseconds rescanInterval{std::chrono::minutes(10)}; // rescan định kỳ
+};
+
+// Theo dõi file linked (is_managed = 0) để DB không giữ hash/đường dẫn cũ:
+// - Linux: inotify trên thư mục cha của các file; nơi khác chỉ có rescan định kỳ
+// - Không tự tạo thread: caller (UI) gọi readEvents() khi nativeHandle() đọc được,
+//   flush() khi isSettled(), rescan() khi needsRescan() => mọi thao tác DB nằm trên thread của caller
+// - Rescan so sánh size/mtime, chỉ hash lại file có thay đổi
+class LinkedFileWatcher {
+    public:
+        using Options = LinkedWatchOptions;
+        using clock = std::chrono::steady_clock;
+
+        LinkedFileWatcher(FileRepository &fileRepo, FileService &fileService,
+                          Options options = LinkedWatchOptions{});
+        ~LinkedFileWatcher();
+
+        LinkedFileWatcher(const LinkedFileWatcher &) = delete;
+        LinkedFileWatcher &operator=(const LinkedFileWatcher &) = delete;
+
+        // Mở inotify và rescan lần đầu (phát hiện file bị xóa/sửa khi app đang tắt)
+        std::size_t start();
+        void stop() noexcept;
+
+        [[nodiscard]] bool isStarted() const noexcept { return m_started; }
+
+        // File descriptor của inotify (-1 nếu không hỗ trợ) để gắn vào event loop
+        [[nodiscard]] int nativeHandle() const noexcept { return m_fd; }
+
+        // Đọc hết sự kiện đang chờ (không block), trả về số sự kiện đã đọc
+        std::size_t readEvents();
+
+        [[nodiscard]] bool hasPending() const noexcept { return !m_pending.empty(); }
+
+        // Có thay đổi đang chờ và đã qua khoảng debounce kể từ sự kiện cuối
+        [[nodiscard]] bool isSettled(clock::time_point now = clock::now()) const noexcept;
+
+        // Ghi các thay đổi đang chờ vào DB (một transaction), trả về số thay đổi đã ghi
+        std::size_t flush();
+
+        // Đọc lại danh sách file linked từ DB và stat toàn bộ; dùng khi inotify tràn queue,
+        // thư mục bị xóa/di chuyển, hoặc định kỳ
+        std::size_t rescan();
+
+        [[nodiscard]] bool needsRescan(clock::time_point now = clock::now()) const noexcept;
+
+        [[nodiscard]] std::size_t trackedCount() const noexcept { return m_tracked.size(); }
+
+        [[nodiscard]] std::size_t watchedDirectoryCount() const noexcept {
+            return m_dirToWatch.size();
+        }
+
+        [[nodiscard]] const std::string &lastError() const noexcept { return m_lastError; }
+
+    private:
+        struct Tracked {
+                std::string path;
+                std::optional<FileHash> hash;
+                bool missing{};
+                std::uintmax_t size{};
+                std::filesystem::file_time_type mtime{};
+        };
+
+        struct Pending {
+                LinkedFileChange::Kind kind{};
+                std::string path; // đường dẫn mới nếu kind == moved
+        };
+
+        void loadFromDb();
+        void syncWatches();
+        void handleEvent(int wd, std::uint32_t mask, std::uint32_t cookie, std::string_view name);
+        void markPending(sqlite3_int64 id, LinkedFileChange::Kind kind, std::string path = {});
+
+        // So sánh trạng thái trên đĩa với Tracked, trả về false nếu không có gì cần ghi
+        bool evaluate(sqlite3_int64 id, Tracked &tracked, const std::string &path,
+                      bool forceHash, LinkedFileChange &change);
+
+        std::size_t applyChanges(std::vector<LinkedFileChange> changes);
+
+        FileRepository &m_fileRepo;
+        FileService &m_fileService;
+        Options m_options;
+
+        int m_fd{-1};
+        bool m_started{};
+        bool m_needRescan{};
+
+        std::unordered_map<sqlite3_int64, Tracked> m_tracked;
+        std::unordered_map<std::string, sqlite3_int64> m_byPath;
+
+        std::unordered_map<std::string, int> m_dirToWatch;
+        std::unordered_map<int, std::string> m_watchToDir;
+
+        std::unordered_map<sqlite3_int64, Pending> m_pending;
+        std::unordered_map<std::uint32_t, sqlite3_int64> m_moveCookies; // IN_MOVED_FROM chờ cặp
+
+        clock::time_point m_lastEvent{};
+        clock::time_point m_lastRescan{};
+
+        std::string m_lastError;
+};
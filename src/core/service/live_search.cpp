@@ -0,0 +1,190 @@
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "code_tokenizer.hpp"
+#include "live_search.hpp"
+#include "resource_repository.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    using Tokens = std::vector<std::string>;
+    // Token theo vị trí FTS5: từ con, kèm identifier đầy đủ colocated (xem code_tokenizer.hpp)
+    using Positions = std::vector<Tokens>;
+
+    bool isAscii(std::string_view text) {
+        return std::ranges::all_of(text,
+                                   [](char c) { return static_cast<unsigned char>(c) < 0x80; });
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    std::vector<std::string_view> splitPieces(std::string_view keyword) {
+        std::vector<std::string_view> pieces;
+        std::size_t pos{0};
+        while (pos < keyword.size()) {
+            while (pos < keyword.size() && isSpace(keyword[pos])) { ++pos; }
+            const auto start = pos;
+            while (pos < keyword.size() && !isSpace(keyword[pos])) { ++pos; }
+            if (pos > start) { pieces.push_back(keyword.substr(start, pos - start)); }
+        }
+        return pieces;
+    }
+
+    // Text ASCII được tokenizer "code" tách hoàn toàn bằng bộ quét byte, không qua unicode61
+    Positions titlePositions(std::string_view title) {
+        Positions positions;
+        forEachCodeToken(
+            title, false,
+            [&](std::string_view token, std::size_t, std::size_t, bool colocated) {
+                if (!colocated) { positions.emplace_back(); }
+                positions.back().emplace_back(token);
+                return true;
+            },
+            [](std::size_t, std::size_t) { return true; });
+        return positions;
+    }
+
+    // Truy vấn chỉ có từ con, mỗi từ một vị trí
+    Tokens queryTokens(std::string_view piece) {
+        Tokens tokens;
+        forEachCodeToken(
+            piece, true,
+            [&](std::string_view token, std::size_t, std::size_t, bool) {
+                tokens.emplace_back(token);
+                return true;
+            },
+            [](std::size_t, std::size_t) { return true; });
+        return tokens;
+    }
+
+    // "a b"* của FTS5: các vị trí liền nhau, riêng token cuối chỉ cần khớp tiền tố
+    bool matchesPhrase(const Positions &title, const Tokens &phrase) {
+        for (std::size_t start = 0; start + phrase.size() <= title.size(); ++start) {
+            bool matched = true;
+            for (std::size_t i = 0; i < phrase.size() && matched; ++i) {
+                const bool last = i + 1 == phrase.size();
+                matched = std::ranges::any_of(title[start + i], [&](const std::string &token) {
+                    return last ? token.starts_with(phrase[i]) : token == phrase[i];
+                });
+            }
+            if (matched) { return true; }
+        }
+        return false;
+    }
+} // namespace
+
+std::string LiveSearch::toPrefixQuery(std::string_view keyword) {
+    std::string query;
+    for (const auto piece : splitPieces(keyword)) {
+        if (isAscii(piece) && queryTokens(piece).empty()) { continue; }
+
+        if (!query.empty()) { query += ' '; }
+        query += '"';
+        for (const char c : piece) {
+            if (c == '"') { query += '"'; }
+            query += c;
+        }
+        query += "\"*";
+    }
+    return query;
+}
+
+LiveSearch::Result LiveSearch::search(std::string_view keyword) {
+    Result result{.query = toPrefixQuery(keyword), .ids = {}, .complete = true, .refined = false};
+    if (result.query.empty()) {
+        reset();
+        return result;
+    }
+
+    if (canRefine(keyword)) {
+        refine(keyword, result);
+    } else {
+        fullSearch(result);
+    }
+    m_keyword.assign(keyword);
+
+    return result;
+}
+
+void LiveSearch::reset() noexcept {
+    m_keyword.clear();
+    m_candidates.clear();
+    m_complete = false;
+    m_changes = -1;
+}
+
+bool LiveSearch::canRefine(std::string_view keyword) const {
+    return m_complete && !m_keyword.empty() && keyword.starts_with(m_keyword) &&
+           isAscii(keyword) && sqlite3_total_changes64(m_db.get()) == m_changes;
+}
+
+void LiveSearch::refine(std::string_view keyword, Result &result) {
+    std::vector<Tokens> phrases;
+    for (const auto piece : splitPieces(keyword)) {
+        if (auto tokens = queryTokens(piece); !tokens.empty()) {
+            phrases.push_back(std::move(tokens));
+        }
+    }
+
+    std::vector<bool> keep(m_candidates.size());
+    std::vector<std::size_t> uncertain;
+    for (std::size_t i = 0; i < m_candidates.size(); ++i) {
+        const auto &title = m_candidates[i].title;
+        if (!isAscii(title)) {
+            uncertain.push_back(i);
+            continue;
+        }
+
+        const auto positions = titlePositions(title);
+        keep[i] = std::ranges::all_of(
+            phrases, [&](const Tokens &phrase) { return matchesPhrase(positions, phrase); });
+    }
+
+    // Title có dấu/không phải Latin: để FTS quyết định, chỉ quét khoảng rowid của chúng
+    if (!uncertain.empty()) {
+        const auto rows = m_resRepo.searchTitlesFTS(result.query,
+                                                    m_candidates[uncertain.front()].id,
+                                                    m_candidates[uncertain.back()].id);
+        for (const auto i : uncertain) {
+            keep[i] = std::ranges::binary_search(rows, m_candidates[i].id, {},
+                                                 [](const auto &row) { return row.first; });
+        }
+    }
+
+    std::vector<Candidate> next;
+    for (std::size_t i = 0; i < m_candidates.size(); ++i) {
+        if (!keep[i]) { continue; }
+        result.ids.push_back(m_candidates[i].id);
+        next.push_back(std::move(m_candidates[i]));
+    }
+    m_candidates = std::move(next);
+
+    result.complete = true;
+    result.refined = true;
+}
+
+void LiveSearch::fullSearch(Result &result) {
+    auto rows = m_resRepo.searchTitlesFTS(result.query, std::numeric_limits<sqlite3_int64>::min(),
+                                          std::numeric_limits<sqlite3_int64>::max(),
+                                          kMaxCandidates + 1);
+
+    m_complete = rows.size() <= kMaxCandidates;
+    if (!m_complete) { rows.resize(kMaxCandidates); }
+    m_changes = sqlite3_total_changes64(m_db.get());
+
+    m_candidates.clear();
+    result.ids.reserve(rows.size());
+    for (auto &[id, title] : rows) {
+        result.ids.push_back(id);
+        if (m_complete) { m_candidates.push_back({.id = id, .title = std::move(title)}); }
+    }
+
+    result.complete = m_complete;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+
+class SQLiteDB;
+class ResourceRepository;
+
+// Tìm theo title trong lúc gõ: mỗi lần gọi là một truy vấn prefix FTS5 ("foo ba" -> "foo"* "ba"*).
+// Từ khóa mới chỉ gõ thêm vào từ khóa trước thì kết quả là tập con của lần trước; nếu lần trước
+// đã giữ trọn tập (<= kMaxCandidates) và DB chưa đổi, tập được lọc lại trong bộ nhớ thay vì chạy
+// lại truy vấn. Title/từ khóa ASCII được tách token bằng chính bộ quét của tokenizer "code"; title
+// còn lại được kiểm lại bằng một truy vấn FTS giới hạn trong khoảng rowid của chúng.
+class LiveSearch {
+    public:
+        struct Result {
+                std::string query;              // biểu thức MATCH, rỗng nếu từ khóa không có token
+                std::vector<sqlite3_int64> ids; // theo rowid tăng dần, tối đa kMaxCandidates
+                bool complete{};                // ids là toàn bộ kết quả
+                bool refined{};                 // lọc từ tập trước, không chạy truy vấn đầy đủ
+        };
+
+        static constexpr std::size_t kMaxCandidates{2000};
+
+        LiveSearch(SQLiteDB &db, ResourceRepository &resRepo) noexcept
+            : m_db(db), m_resRepo(resRepo) {}
+
+        // Mỗi đoạn cách nhau bởi khoảng trắng thành một phrase prefix; dấu " được nhân đôi.
+        // Đoạn ASCII không có chữ/số (vd "-", "_") bị bỏ vì FTS5 coi là phrase rỗng
+        [[nodiscard]] static std::string toPrefixQuery(std::string_view keyword);
+
+        Result search(std::string_view keyword);
+
+        // Quên tập trước (đổi DB, đổi chế độ tìm...)
+        void reset() noexcept;
+
+    private:
+        struct Candidate {
+                sqlite3_int64 id{};
+                std::string title;
+        };
+
+        [[nodiscard]] bool canRefine(std::string_view keyword) const;
+        void refine(std::string_view keyword, Result &result);
+        void fullSearch(Result &result);
+
+        SQLiteDB &m_db;
+        ResourceRepository &m_resRepo;
+        std::string m_keyword;
+        std::vector<Candidate> m_candidates;
+        bool m_complete{};
+        sqlite3_int64 m_changes{-1}; // sqlite3_total_changes64 lúc lấy tập
+};
@@ -0,0 +1,427 @@
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <regex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "regex_search.hpp"
+#include "content_index_repository.hpp"
+#include "query_router.hpp"
+#include "search_indexes.hpp"
+#include "text_content_repository.hpp"
+
+namespace {
+    constexpr std::size_t kReadBlockSize{64 * 1024};
+    constexpr std::size_t kMaxLineScan{8 * 1024}; // std::regex đệ quy theo độ dài chuỗi
+    constexpr std::size_t kMaxLineText{240};
+    constexpr std::size_t kMinTrigramChars{3};
+    constexpr unsigned kMaxAutoThreads{8};
+
+    bool isContinuation(char c) {
+        return (static_cast<unsigned char>(c) & 0xC0U) == 0x80U;
+    }
+
+    bool isAlnum(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) != 0;
+    }
+
+    std::size_t charCount(std::string_view text) {
+        return static_cast<std::size_t>(
+            std::ranges::count_if(text, [](char c) { return !isContinuation(c); }));
+    }
+
+    // Vị trí ']' đóng lớp ký tự mở tại open
+    std::size_t classEnd(std::string_view pattern, std::size_t open) {
+        std::size_t i = open + 1;
+        if (i < pattern.size() && pattern[i] == '^') { ++i; }
+        for (; i < pattern.size(); ++i) {
+            if (pattern[i] == '\\') {
+                ++i;
+            } else if (pattern[i] == ']') {
+                return i;
+            }
+        }
+        return pattern.size();
+    }
+
+    // Vị trí ')' đóng nhóm mở tại open
+    std::size_t groupEnd(std::string_view pattern, std::size_t open) {
+        int depth{0};
+        for (std::size_t i = open; i < pattern.size(); ++i) {
+            switch (pattern[i]) {
+            case '\\': ++i; break;
+            case '[': i = classEnd(pattern, i); break;
+            case '(': ++depth; break;
+            case ')':
+                if (--depth == 0) { return i; }
+                break;
+            default: break;
+            }
+        }
+        return pattern.size();
+    }
+
+    // Phần tử đứng trước pos có thể lặp 0 lần
+    bool optionalQuantifier(std::string_view pattern, std::size_t pos) {
+        if (pos >= pattern.size()) { return false; }
+        const char c = pattern[pos];
+        return c == '?' || c == '*' ||
+               (c == '{' && pos + 1 < pattern.size() && pattern[pos + 1] == '0');
+    }
+
+    // Số ký tự thuộc escape \<letter> sau chữ cái (\xHH, \uHHHH, \cX, backreference \12)
+    std::size_t escapeTail(std::string_view pattern, std::size_t letter) {
+        const auto rest = pattern.size() - letter - 1;
+        switch (pattern[letter]) {
+        case 'x': return std::min<std::size_t>(2, rest);
+        case 'u': return std::min<std::size_t>(4, rest);
+        case 'c': return std::min<std::size_t>(1, rest);
+        default: break;
+        }
+
+        const auto isDigit = [](char c) {
+            return std::isdigit(static_cast<unsigned char>(c)) != 0;
+        };
+        std::size_t n{0};
+        if (isDigit(pattern[letter])) {
+            while (n < rest && isDigit(pattern[letter + 1 + n])) { ++n; }
+        }
+        return n;
+    }
+
+    // Cụm từ cho FTS5 MATCH: nháy kép, nháy bên trong nhân đôi
+    std::string ftsPhrase(std::string_view text) {
+        std::string out{'"'};
+        for (const char c : text) {
+            out += c;
+            if (c == '"') { out += '"'; }
+        }
+        out += '"';
+        return out;
+    }
+
+    std::string clipLine(std::string_view line) {
+        const auto first = line.find_first_not_of(" \t");
+        line.remove_prefix(first == std::string_view::npos ? line.size() : first);
+        if (line.size() <= kMaxLineText) { return std::string(line); }
+
+        std::size_t cut = kMaxLineText;
+        while (cut > 0 && isContinuation(line[cut])) { --cut; }
+        return std::string(line.substr(0, cut)) + "…";
+    }
+} // namespace
+
+std::string requiredLiteral(std::string_view pattern) {
+    std::string best;
+    std::string run;
+    const auto commit = [&] {
+        if (run.size() > best.size()) { best = run; }
+        run.clear();
+    };
+
+    for (std::size_t i = 0; i < pattern.size(); ++i) {
+        const char c = pattern[i];
+        switch (c) {
+        case '|': return {}; // nhánh khác có thể không chứa literal nào
+        case '\\':
+            if (i + 1 >= pattern.size()) { break; }
+            if (isAlnum(pattern[++i])) {
+                // \d, \w, \b, \n... không phải ký tự cố định
+                commit();
+                i += escapeTail(pattern, i);
+            } else {
+                run += pattern[i];
+            }
+            break;
+        case '[':
+            commit();
+            i = classEnd(pattern, i);
+            break;
+        case '(': {
+            commit();
+            const auto end = groupEnd(pattern, i);
+            const bool lookaround = pattern.substr(i, 3) == "(?=" || pattern.substr(i, 3) == "(?!";
+            if (lookaround || optionalQuantifier(pattern, end + 1)) {
+                i = end; // cả nhóm không bắt buộc (hoặc không tiêu ký tự)
+            } else if (pattern.substr(i, 3) == "(?:") {
+                i += 2;
+            }
+            break;
+        }
+        case '*':
+        case '?':
+            if (!run.empty()) { run.pop_back(); }
+            commit();
+            break;
+        case '{':
+            // Có thể lặp 0 lần: bỏ ký tự vừa thêm
+            if (!run.empty()) { run.pop_back(); }
+            commit();
+            i = std::min(pattern.find('}', i), pattern.size());
+            break;
+        case '+': // ký tự trước bắt buộc nhưng có thể lặp: literal không nối tiếp được
+        case ')':
+        case '.':
+        case '^':
+        case '$': commit(); break;
+        default: run += c; break;
+        }
+    }
+
+    commit();
+    return best;
+}
+
+// ------------------------------------------------------------
+// RegexSearch
+// ------------------------------------------------------------
+RegexSearch::RegexSearch(SQLiteDB &db, std::string_view pattern, Options options,
+                         std::stop_token cancel)
+    : m_db(db), m_pattern(pattern), m_options(options),
+      m_noteQueue(std::max<std::size_t>(options.queueCapacity, 2)) {
+    auto flags = std::regex::ECMAScript | std::regex::optimize;
+    if (m_options.ignoreCase) { flags |= std::regex::icase; }
+    try {
+        m_regex = std::regex(m_pattern, flags);
+    } catch (const std::regex_error &ex) {
+        throw std::runtime_error("Invalid regex: " + std::string(ex.what()));
+    }
+
+    // ignoreCase: literal trong pattern không còn là chuỗi con cố định của text
+    if (!m_options.ignoreCase) { m_literal = requiredLiteral(m_pattern); }
+
+    TextContentRepository textRepo(m_db);
+    m_prefiltered =
+        charCount(m_literal) >= kMinTrigramChars && SearchIndexes(m_db).contentTrigramEnabled();
+    // Chunk note cắt ở '\n' (trừ dòng > 32KB) nên literal trong một dòng luôn nằm gọn một chunk
+    m_noteIds = m_prefiltered ? textRepo.searchNoteIds(RoutedQuery{
+                                    .plan = QueryPlan::trigram, .expression = ftsPhrase(m_literal)})
+                              : textRepo.getNoteIds();
+
+    // Chỉ file text trên đĩa; epub/pdf là file nén/nhị phân
+    m_files = ContentIndexRepository(m_db).getFiles({ResourceType::cpp, ResourceType::text});
+
+    if (m_options.threads == 0) {
+        m_options.threads = std::clamp(std::thread::hardware_concurrency(), 1U, kMaxAutoThreads);
+    }
+    m_deadline = std::chrono::steady_clock::now() + m_options.budget;
+
+    m_stopCallback.emplace(std::move(cancel), CancelOnStop{this});
+
+    m_activeWorkers.store(m_options.threads);
+    m_threads.reserve(m_options.threads);
+    for (unsigned t = 0; t < m_options.threads; ++t) {
+        m_threads.emplace_back([this] { worker(); });
+    }
+}
+
+RegexSearch::~RegexSearch() {
+    m_stopCallback.reset();
+    cancel();
+    m_noteQueue.close();
+    m_threads.clear(); // join trước khi queue và kết quả bị hủy
+}
+
+void RegexSearch::cancel() noexcept {
+    finish(Status::cancelled);
+}
+
+RegexSearch::Status RegexSearch::status() const noexcept {
+    return m_status.load(std::memory_order_acquire);
+}
+
+void RegexSearch::finish(Status status) noexcept {
+    // Giữ lý do dừng đầu tiên
+    auto expected = Status::running;
+    m_status.compare_exchange_strong(expected, status, std::memory_order_acq_rel);
+    if (status != Status::completed) { m_stopped.store(true, std::memory_order_relaxed); }
+}
+
+bool RegexSearch::checkDeadline() noexcept {
+    if (std::chrono::steady_clock::now() < m_deadline) { return true; }
+    finish(Status::timedOut);
+    return false;
+}
+
+std::string RegexSearch::describe() const {
+    std::string text = "regex /" + m_pattern + "/";
+    if (!m_literal.empty()) {
+        text += " literal \"" + m_literal + "\"";
+        if (m_prefiltered) { text += " (trigram)"; }
+    }
+    text += ": " + std::to_string(noteCount()) + " note, " + std::to_string(fileCount()) + " file";
+    return text;
+}
+
+void RegexSearch::feedNotes() {
+    if (m_noteQueue.isClosed()) { return; }
+
+    TextContentRepository textRepo(m_db);
+    while (!stopped()) {
+        if (!m_pending) {
+            if (m_nextNote >= m_noteIds.size()) {
+                m_noteQueue.close();
+                return;
+            }
+            const auto id = m_noteIds[m_nextNote++];
+            auto text = textRepo.getTextById(id);
+            if (!text) { continue; }
+            m_pending = NoteJob{.resource_id = id, .text = std::move(*text)};
+        }
+        if (!m_noteQueue.tryPush(*m_pending)) { return; } // queue đầy: worker đang bận
+        m_pending.reset();
+    }
+}
+
+bool RegexSearch::poll(std::vector<RegexMatch> &out, std::chrono::milliseconds slice) {
+    const auto until = std::chrono::steady_clock::now() + slice;
+    for (;;) {
+        feedNotes();
+
+        const bool finished = m_activeWorkers.load(std::memory_order_acquire) == 0;
+        {
+            std::lock_guard lock(m_matchMutex);
+            if (!m_matches.empty()) {
+                std::ranges::move(m_matches, std::back_inserter(out));
+                m_matches.clear();
+                return true;
+            }
+        }
+        if (finished) { return false; }
+        if (std::chrono::steady_clock::now() >= until) { return true; }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+std::vector<RegexMatch> RegexSearch::run() {
+    std::vector<RegexMatch> matches;
+    while (poll(matches, std::chrono::milliseconds(50))) {}
+    return matches;
+}
+
+void RegexSearch::worker() {
+    NoteJob job;
+    while (!stopped()) {
+        // Note trước (đã nằm trong bộ nhớ), hết note thì nhận file kế tiếp, hết file thì chờ note
+        if (!m_noteQueue.tryPop(job)) {
+            const auto i = m_nextFile.fetch_add(1, std::memory_order_relaxed);
+            if (i < m_files.size()) {
+                scanFile(m_files[i]);
+                continue;
+            }
+            if (!m_noteQueue.pop(job, m_stopped)) { break; }
+        }
+
+        LinePos pos;
+        scanLines(job.resource_id, job.text, pos, true);
+    }
+
+    if (m_activeWorkers.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        finish(Status::completed);
+    }
+}
+
+void RegexSearch::scanFile(const IndexCandidate &file) {
+    std::ifstream in(file.path, std::ios::binary);
+    if (!in.is_open()) { return; } // file mất hoặc không đọc được: bỏ qua như grep -s
+
+    std::vector<char> block(kReadBlockSize);
+    std::string carry; // dòng dở cuối block trước
+    LinePos pos;
+
+    while (!stopped() && (in.read(block.data(), static_cast<std::streamsize>(block.size())) ||
+                          in.gcount() > 0)) {
+        carry.append(block.data(), static_cast<std::size_t>(in.gcount()));
+        carry.erase(0, scanLines(file.resource_id, carry, pos, false));
+
+        // Dòng rất dài: chỉ phần đầu được so khớp, phần còn lại chỉ cần để tính offset
+        if (carry.size() > kMaxLineScan) {
+            pos.dropped += carry.size() - kMaxLineScan;
+            carry.resize(kMaxLineScan);
+        }
+    }
+
+    if (!stopped()) { scanLines(file.resource_id, carry, pos, true); }
+}
+
+std::size_t RegexSearch::scanLines(sqlite3_int64 resourceId, std::string_view text, LinePos &pos,
+                                   bool eof) {
+    // Chuyển pos tới đầu dòng tại to (ngay sau một '\n')
+    const auto advance = [&](std::size_t from, std::size_t to) {
+        if (to <= from) { return; }
+        pos.line += static_cast<int>(std::count(text.begin() + static_cast<std::ptrdiff_t>(from),
+                                                text.begin() + static_cast<std::ptrdiff_t>(to),
+                                                '\n'));
+        pos.offset += to - from + pos.dropped;
+        pos.dropped = 0;
+    };
+
+    std::size_t begin{0};
+    while (begin < text.size()) {
+        if (stopped() || !checkDeadline()) { return text.size(); }
+
+        if (!m_literal.empty()) {
+            // find() dò ký tự đầu bằng memchr: dòng không chứa literal không phải chạy regex
+            const auto hit = text.find(m_literal, begin);
+            if (hit == std::string_view::npos) {
+                // Dòng dở cuối block có thể chứa literal khi nối với block sau
+                const auto lastNl = text.rfind('\n');
+                const auto rest = lastNl == std::string_view::npos || lastNl < begin ? begin
+                                                                                    : lastNl + 1;
+                advance(begin, rest);
+                return eof ? text.size() : rest;
+            }
+
+            const auto prevNl = text.rfind('\n', hit);
+            const auto lineStart =
+                prevNl == std::string_view::npos || prevNl < begin ? begin : prevNl + 1;
+            advance(begin, lineStart);
+            begin = lineStart;
+        }
+
+        const auto nl = text.find('\n', begin);
+        if (nl == std::string_view::npos && !eof) { return begin; }
+
+        const auto end = nl == std::string_view::npos ? text.size() : nl;
+        matchLine(resourceId, text.substr(begin, end - begin), pos);
+        if (nl == std::string_view::npos) { break; }
+
+        advance(begin, nl + 1);
+        begin = nl + 1;
+    }
+
+    return text.size();
+}
+
+void RegexSearch::matchLine(sqlite3_int64 resourceId, std::string_view line, const LinePos &pos) {
+    auto view = line.substr(0, kMaxLineScan);
+    if (!view.empty() && view.back() == '\r') { view.remove_suffix(1); }
+
+    std::cmatch match;
+    try {
+        if (!std::regex_search(view.data(), view.data() + view.size(), match, m_regex)) { return; }
+    } catch (const std::regex_error &) {
+        return; // error_complexity/error_stack: coi như không khớp
+    }
+
+    if (m_matchCount.fetch_add(1, std::memory_order_relaxed) >= m_options.maxMatches) {
+        finish(Status::truncated);
+        return;
+    }
+
+    RegexMatch result{.resource_id = resourceId,
+                      .line = pos.line,
+                      .byte_offset = pos.offset + static_cast<std::size_t>(match.position(0)),
+                      .text = clipLine(view)};
+
+    std::lock_guard lock(m_matchMutex);
+    m_matches.push_back(std::move(result));
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <regex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <sqlite3.h>
+#include "model.hpp"
+#include "bounded_queue.hpp"
+
+class SQLiteDB;
+
+// Một dòng khớp regex trong note hoặc file
+struct RegexMatch {
+        sqlite3_int64 resource_id{};
+        int line{1};               // đếm từ 1
+        std::size_t byte_offset{}; // vị trí khớp trong toàn bộ text của note/file
+        std::string text;          // dòng chứa kết quả, cắt ngắn cho danh sách
+};
+
+enum class RegexSearchStatus : std::uint8_t {
+    running,
+    completed, // đã quét hết nguồn
+    cancelled,
+    timedOut,  // hết budget, giữ các kết quả đã có
+    truncated  // đủ maxMatches
+};
+
+struct RegexSearchOptions {
+        unsigned threads{};                     // số worker, 0 = tự chọn
+        std::chrono::milliseconds budget{5000}; // thời gian tối đa cho cả lượt tìm
+        std::size_t maxMatches{1000};
+        bool ignoreCase{};
+        std::size_t queueCapacity{16};          // số note tối đa chờ worker
+};
+
+// Chuỗi con dài nhất mà mọi kết quả khớp pattern (cú pháp ECMAScript) chắc chắn chứa.
+// Rỗng khi không suy ra được (có '|', chỉ toàn lớp ký tự...). Thận trọng: chỉ bỏ sót literal,
+// không bao giờ trả về chuỗi mà một kết quả hợp lệ có thể không chứa.
+[[nodiscard]] std::string requiredLiteral(std::string_view pattern);
+
+// Tìm regex theo dòng (như grep) trên nội dung note và file cpp/txt được liên kết.
+// Worker thread tự lấy việc: note đi qua BoundedQueue (thread DB nạp dần), file được nhận
+// theo con trỏ chung rồi đọc từng block. Literal bắt buộc của pattern dùng để lọc trước:
+// note chỉ nạp khi bảng trigram có literal, còn trong text thì nhảy thẳng tới dòng chứa literal
+// thay vì chạy regex trên mọi dòng. Kết quả được lấy dần qua poll() để UI hiện ngay.
+// Dừng khi hủy (cancel() hoặc stop_token), hết budget, hoặc đủ maxMatches.
+class RegexSearch {
+    public:
+        using Options = RegexSearchOptions;
+        using Status = RegexSearchStatus;
+
+        // Ném std::runtime_error nếu pattern không hợp lệ. Worker chạy ngay khi tạo xong
+        RegexSearch(SQLiteDB &db, std::string_view pattern, Options options = RegexSearchOptions{},
+                    std::stop_token cancel = {});
+        ~RegexSearch();
+
+        RegexSearch(const RegexSearch &) = delete;
+        RegexSearch &operator=(const RegexSearch &) = delete;
+
+        // Gọi trên thread sở hữu connection: nạp note cho worker, chờ tối đa slice rồi chuyển
+        // kết quả mới vào out. Trả về false khi lượt tìm đã kết thúc và không còn kết quả nào
+        bool poll(std::vector<RegexMatch> &out, std::chrono::milliseconds slice);
+
+        // Chạy đến khi kết thúc, trả về toàn bộ kết quả
+        std::vector<RegexMatch> run();
+
+        void cancel() noexcept;
+
+        [[nodiscard]] Status status() const noexcept;
+        [[nodiscard]] const std::string &literal() const noexcept { return m_literal; }
+        [[nodiscard]] bool prefiltered() const noexcept { return m_prefiltered; }
+        [[nodiscard]] std::size_t noteCount() const noexcept { return m_noteIds.size(); }
+        [[nodiscard]] std::size_t fileCount() const noexcept { return m_files.size(); }
+
+        // Dạng "regex /Foo+/ literal \"Fo\" (trigram): 12 note, 3 file" để báo cho người dùng
+        [[nodiscard]] std::string describe() const;
+
+    private:
+        struct NoteJob {
+                sqlite3_int64 resource_id{};
+                std::string text;
+        };
+
+        // Vị trí đang quét trong một note/file
+        struct LinePos {
+                int line{1};
+                std::size_t offset{};  // byte đầu dòng hiện tại
+                std::size_t dropped{}; // byte đã bỏ của dòng hiện tại (dòng quá dài)
+        };
+
+        void worker();
+        void scanFile(const IndexCandidate &file);
+        // Quét các dòng hoàn chỉnh của text, trả về số byte đã dùng (eof: quét cả dòng dở)
+        std::size_t scanLines(sqlite3_int64 resourceId, std::string_view text, LinePos &pos,
+                              bool eof);
+        void matchLine(sqlite3_int64 resourceId, std::string_view line, const LinePos &pos);
+        void finish(Status status) noexcept;
+        [[nodiscard]] bool stopped() const noexcept {
+            return m_stopped.load(std::memory_order_relaxed);
+        }
+        [[nodiscard]] bool checkDeadline() noexcept;
+        void feedNotes();
+
+        SQLiteDB &m_db;
+        std::string m_pattern;
+        Options m_options;
+        std::regex m_regex;
+        std::string m_literal; // rỗng khi không lọc được theo literal
+        bool m_prefiltered{};
+
+        std::vector<sqlite3_int64> m_noteIds;
+        std::vector<IndexCandidate> m_files;
+        std::size_t m_nextNote{};         // chỉ thread DB dùng
+        std::optional<NoteJob> m_pending; // note đã đọc nhưng queue đang đầy
+
+        BoundedQueue<NoteJob> m_noteQueue;
+        std::atomic<std::size_t> m_nextFile{0};
+        std::atomic<unsigned> m_activeWorkers{0};
+        std::atomic<bool> m_stopped{false};
+        std::atomic<Status> m_status{Status::running};
+        std::chrono::steady_clock::time_point m_deadline;
+
+        mutable std::mutex m_matchMutex;
+        std::vector<RegexMatch> m_matches; // chờ poll() lấy
+        std::atomic<std::size_t> m_matchCount{0};
+
+        struct CancelOnStop {
+                RegexSearch* search;
+                void operator()() const noexcept { search->cancel(); }
+        };
+
+        std::optional<std::stop_callback<CancelOnStop>> m_stopCallback;
+        std::vector<std::jthread> m_threads;
+};
@@ -2,6 +2,11 @@
 #include <stdexcept>
 #include <optional>
 #include <filesystem>
+#include <algorithm>
+#include <iterator>
+#include <span>
+#include <string_view>
+#include <vector>
 #include <sqlite3.h>
 #include "file_repository.hpp"
 #include "model.hpp"
@@ -10,6 +15,29 @@
 #include "tag_repository.hpp"
 #include "text_content_repository.hpp"
 #include "resource_repository.hpp"
+#include "content_index_repository.hpp"
+#include "query_router.hpp"
+#include "search_facets.hpp"
+#include "search_indexes.hpp"
+#include "search_result.hpp"
+#include "symbol_repository.hpp"
+
+namespace {
+    // Một điều kiện của searchQuery; estimate rỗng = không đếm rẻ được (FTS)
+    struct QueryStep {
+            const SearchTerm* term;
+            std::optional<sqlite3_int64> estimate;
+            ResourceType type{};
+    };
+
+    // candidates và ids đều tăng dần
+    void intersectIds(std::vector<sqlite3_int64> &candidates,
+                      const std::vector<sqlite3_int64> &ids) {
+        std::vector<sqlite3_int64> kept;
+        std::ranges::set_intersection(candidates, ids, std::back_inserter(kept));
+        candidates = std::move(kept);
+    }
+} // namespace
 
 // NOLINTNEXTLINE
 sqlite3_int64 ResourceService::addTextResource(const std::string &title, const std::string &content,
@@ -20,7 +48,7 @@ sqlite3_int64 ResourceService::addTextResource(const std::string &title, const s
 
     // Insert vào resources (file_hash để trống)
     sqlite3_int64 resourceId =
-        m_resRepo.insert({.title = title, .type = type, .file_hash = ""}); // NOLINT
+        m_resRepo.insert({.title = title, .type = type, .file_hash = std::nullopt}); // NOLINT
 
     // Insert nội dung text vào text_content
     m_textRepo.insertText(resourceId, content);
@@ -102,29 +130,263 @@ std::vector<FullResource> ResourceService::searchByTitleFull(const std::string &
 
 std::vector<std::pair<sqlite3_int64, std::string>>
     ResourceService::searchByContent(const std::string &keyword) {
-    return m_textRepo.searchByContentFTS(keyword);
+    std::vector<std::pair<sqlite3_int64, std::string>> matches;
+
+    for (auto &hit : searchContentHits(keyword)) {
+        if (hit.page.has_value()) {
+            hit.snippet = "p. " + std::to_string(*hit.page) + ": " + hit.snippet;
+        }
+        matches.emplace_back(hit.resource_id, std::move(hit.snippet));
+    }
+
+    return matches;
 }
 
 std::vector<FullResource> ResourceService::searchByContentFull(const std::string &keyword) {
     std::vector<FullResource> results;
-    auto matches = m_textRepo.searchByContentFTS(keyword);
-    results.reserve(matches.size());
+    auto hits = searchContentHits(keyword);
+    results.reserve(hits.size());
 
-    for (auto &[resourceId, snippet] : matches) {
-        auto full = getFullResource(resourceId);
+    for (auto &hit : hits) {
+        auto full = getFullResource(hit.resource_id);
         if (full.has_value()) {
-            // override content bằng snippet highlight
-            full->content = snippet;
+            // override content bằng snippet quanh chỗ khớp
+            full->content = hit.snippet;
+            full->hit = std::move(hit);
             results.push_back(std::move(*full));
         }
     }
     return results;
 }
 
+SearchResult ResourceService::searchByTitleResult(const std::string &keyword) {
+    SearchResult result;
+    m_resRepo.appendSearchEntries(m_resRepo.searchIdsByTitle(routeTitleQuery(keyword)), result);
+    return result;
+}
+
+SearchResult ResourceService::searchByContentResult(const std::string &keyword) {
+    const auto hits = searchContentHits(keyword);
+    return contentHitPage(hits, 0, hits.size()).result;
+}
+
+SearchPage ResourceService::searchByTitlePage(const std::string &keyword, std::size_t offset,
+                                              std::size_t limit) {
+    const auto ids = m_resRepo.searchIdsByTitle(routeTitleQuery(keyword), offset, limit);
+
+    SearchPage page{.result = {}, .last = ids.size() < limit};
+    m_resRepo.appendSearchEntries(ids, page.result);
+    return page;
+}
+
+SearchPage ResourceService::getTagPage(const std::string &tag, std::size_t offset,
+                                       std::size_t limit) {
+    const auto ids = m_tagRepo.getResourceIdsViaOneTag(tag, offset, limit);
+
+    SearchPage page{.result = {}, .last = ids.size() < limit};
+    m_resRepo.appendSearchEntries(ids, page.result);
+    return page;
+}
+
+SearchPage ResourceService::contentHitPage(std::span<const ContentHit> hits, std::size_t offset,
+                                           std::size_t limit) {
+    const auto begin = std::min(offset, hits.size());
+    const auto pageHits = hits.subspan(begin, std::min(limit, hits.size() - begin));
+
+    std::vector<sqlite3_int64> ids;
+    ids.reserve(pageHits.size());
+    for (const auto &hit : pageHits) { ids.push_back(hit.resource_id); }
+
+    SearchPage page{.result = {}, .last = offset + pageHits.size() >= hits.size()};
+    m_resRepo.appendSearchEntries(ids, page.result);
+
+    // Entry giữ thứ tự của hits, chỉ thiếu các resource đã bị bỏ qua
+    std::size_t entry{0};
+    for (const auto &hit : pageHits) {
+        if (entry < page.result.size() && page.result[entry].id == hit.resource_id) {
+            page.result.setHit(entry++, hit);
+        }
+    }
+
+    return page;
+}
+
+SearchPage ResourceService::idPage(std::span<const sqlite3_int64> ids, std::size_t offset,
+                                   std::size_t limit) {
+    const auto begin = std::min(offset, ids.size());
+    const auto pageIds = ids.subspan(begin, std::min(limit, ids.size() - begin));
+
+    SearchPage page{.result = {}, .last = offset + pageIds.size() >= ids.size()};
+    m_resRepo.appendSearchEntries(pageIds, page.result);
+    return page;
+}
+
+RoutedQuery ResourceService::routeTitleQuery(std::string_view keyword) const {
+    return routeQuery(keyword, SearchIndexes(m_db).titleCapabilities());
+}
+
+RoutedQuery ResourceService::routeContentQuery(std::string_view keyword) const {
+    return routeQuery(keyword, SearchIndexes(m_db).contentCapabilities());
+}
+
+std::vector<ContentHit> ResourceService::searchContentHits(const std::string &keyword) {
+    return searchContentHits(routeContentQuery(keyword));
+}
+
+std::vector<ContentHit> ResourceService::searchContentHits(const RoutedQuery &query) {
+    auto hits = m_textRepo.searchContentHits(query);
+
+    // Nội dung file (cpp/txt/epub/pdf) đã index. Hai danh sách đều đã xếp theo bm25: trộn theo
+    // rank để file khớp mạnh không đứng sau note khớp yếu (bằng rank thì note trước)
+    if (m_contentIndexRepo != nullptr) {
+        auto fileHits = m_contentIndexRepo->searchFileContentHits(query);
+        if (fileHits.empty()) { return hits; }
+
+        std::vector<ContentHit> merged;
+        merged.reserve(hits.size() + fileHits.size());
+        std::ranges::merge(std::make_move_iterator(hits.begin()),
+                           std::make_move_iterator(hits.end()),
+                           std::make_move_iterator(fileHits.begin()),
+                           std::make_move_iterator(fileHits.end()), std::back_inserter(merged),
+                           {}, &ContentHit::rank, &ContentHit::rank);
+        return merged;
+    }
+
+    return hits;
+}
+
+std::vector<ContentHit> ResourceService::findDefinitions(const std::string &name) {
+    std::vector<ContentHit> hits;
+
+    // Tên trong bảng không kèm scope: "Foo::bar" tra theo "bar"
+    std::string_view key(name);
+    if (const auto scope = key.rfind("::"); scope != std::string_view::npos) {
+        key.remove_prefix(scope + 2);
+    }
+    if (key.empty()) { return hits; }
+
+    for (const auto &symbol : SymbolRepository(m_db).findDefinitions(key)) {
+        hits.push_back({.resource_id = symbol.resource_id,
+                        .snippet = std::string(symbolKindToString(symbol.kind)) + " " +
+                                   symbol.name,
+                        .byte_offset = 0,
+                        .line = symbol.line,
+                        .page = std::nullopt});
+    }
+
+    return hits;
+}
+
 std::vector<Resource> ResourceService::getResourcesByTags(const std::vector<std::string> &tags) {
     return m_tagRepo.getResourcesViaTags(tags);
 }
 
+QueryMatches ResourceService::searchQuery(const SearchQuery &query,
+                                          std::optional<std::size_t> facetTags) {
+    std::vector<QueryStep> steps;
+    steps.reserve(query.terms.size());
+    for (const auto &term : query.terms) {
+        QueryStep step{.term = &term, .estimate = std::nullopt};
+        if (term.field == SearchField::tag) {
+            step.estimate = m_tagRepo.countResourcesViaOneTag(term.value);
+        } else if (term.field == SearchField::type) {
+            step.type = resourceTypeFromString(term.value);
+            step.estimate = m_resRepo.countByType(step.type);
+        }
+        steps.push_back(step);
+    }
+
+    // Ít dòng nhất trước; FTS sau cùng, title (bảng nhỏ) trước content
+    std::ranges::stable_sort(steps, [](const QueryStep &a, const QueryStep &b) {
+        if (a.estimate.has_value() != b.estimate.has_value()) { return a.estimate.has_value(); }
+        if (a.estimate.has_value()) { return *a.estimate < *b.estimate; }
+        return a.term->field < b.term->field;
+    });
+
+    QueryMatches matches;
+    std::optional<std::vector<sqlite3_int64>> candidates; // tăng dần; nullopt = chưa lọc
+    bool ranked{false};
+
+    for (const auto &step : steps) {
+        const auto &term = *step.term;
+        if (!matches.plan.empty()) { matches.plan += " > "; }
+        matches.plan += std::string(searchFieldName(term.field)) + ":" + term.value;
+
+        if (candidates.has_value() && candidates->empty()) {
+            matches.plan += "(skipped)";
+            continue;
+        }
+
+        const bool probe = candidates.has_value() && step.estimate.has_value() &&
+                           static_cast<sqlite3_int64>(candidates->size()) < *step.estimate;
+        if (probe) {
+            // Ít ứng viên hơn số dòng của điều kiện: tra từng id qua khóa chính
+            std::erase_if(*candidates, [&](sqlite3_int64 id) {
+                return term.field == SearchField::tag ? !m_tagRepo.hasTag(id, term.value)
+                                                      : m_resRepo.getTypeById(id) != step.type;
+            });
+        } else {
+            std::vector<sqlite3_int64> ids;
+            switch (term.field) {
+                case SearchField::tag:
+                    ids = m_tagRepo.getResourceIdsViaOneTag(term.value);
+                    break;
+                case SearchField::type:
+                    ids = m_resRepo.getIdsByType(step.type);
+                    break;
+                case SearchField::title:
+                    ids = m_resRepo.searchIdsByTitle(routeTitleQuery(term.value));
+                    break;
+                case SearchField::content: {
+                    auto hits = searchContentHits(term.value);
+                    ids.reserve(hits.size());
+                    for (const auto &hit : hits) { ids.push_back(hit.resource_id); }
+                    std::ranges::sort(ids);
+                    ids.erase(std::ranges::unique(ids).begin(), ids.end());
+
+                    // Thứ tự kết quả theo rank của điều kiện content đầu tiên
+                    if (!ranked) {
+                        matches.hits = std::move(hits);
+                        ranked = true;
+                    }
+                    break;
+                }
+            }
+
+            if (candidates.has_value()) {
+                intersectIds(*candidates, ids);
+            } else {
+                candidates = std::move(ids);
+            }
+        }
+
+        matches.plan += "(" + std::to_string(candidates->size()) + ")";
+    }
+
+    if (ranked) {
+        std::erase_if(matches.hits, [&](const ContentHit &hit) {
+            return !std::ranges::binary_search(*candidates, hit.resource_id);
+        });
+        matches.ids.reserve(matches.hits.size());
+        for (const auto &hit : matches.hits) { matches.ids.push_back(hit.resource_id); }
+    } else if (candidates.has_value()) {
+        matches.ids = std::move(*candidates);
+    }
+
+    if (facetTags.has_value()) { matches.facets = searchFacets(matches.ids, *facetTags); }
+
+    return matches;
+}
+
+SearchFacets ResourceService::searchFacets(std::span<const sqlite3_int64> ids,
+                                           std::size_t topTags) {
+    return countSearchFacets(m_db, ids, topTags);
+}
+
+std::vector<sqlite3_int64> ResourceService::searchTitleIds(const std::string &keyword) {
+    return m_resRepo.searchIdsByTitle(routeTitleQuery(keyword));
+}
+
 void ResourceService::addTagToResource(sqlite3_int64 resourceId, const std::string &tag) {
     sqlite3_int64 tagId{};
     auto tagIdOpt = m_tagRepo.getTagIdByName(tag);
@@ -178,6 +440,12 @@ std::vector<FullResource> ResourceService::getFullResourcesByTag(const std::stri
     return results;
 }
 
+SearchResult ResourceService::getResultByTag(const std::string &tag) {
+    SearchResult result;
+    m_resRepo.appendSearchEntries(m_tagRepo.getResourceIdsViaOneTag(tag), result);
+    return result;
+}
+
 bool ResourceService::isExistTitle(std::string_view title, ResourceType type) const {
     return m_resRepo.existsTitle(title, type);
 }
\ No newline at end of file
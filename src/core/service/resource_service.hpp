@@ -1,10 +1,18 @@
 #pragma once
 
+#include <cstddef>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 #include <sqlite3.h>
 #include "model.hpp"
+#include "query_router.hpp"
+#include "search_facets.hpp"
+#include "search_query.hpp"
+#include "search_result.hpp"
 
 class SQLiteDB;
 class ResourceRepository;
@@ -12,14 +20,17 @@ class FileRepository;
 class TextContentRepository;
 class TagRepository;
 class FileService;
+class ContentIndexRepository;
 
 class ResourceService {
     public:
         ResourceService(SQLiteDB &db, ResourceRepository &resRepo, FileRepository &fileRepo,
                         TextContentRepository &textRepo, TagRepository &tagRepo,
-                        FileService &fileService) noexcept
+                        FileService &fileService,
+                        ContentIndexRepository* contentIndexRepo = nullptr) noexcept
             : m_db(db), m_resRepo(resRepo), m_fileRepo(fileRepo), m_textRepo(textRepo),
-              m_tagRepo(tagRepo), m_fileService(fileService) {}
+              m_tagRepo(tagRepo), m_fileService(fileService),
+              m_contentIndexRepo(contentIndexRepo) {}
 
         // ========== CRUD ==========
         sqlite3_int64 addTextResource(const std::string &title, const std::string &content,
@@ -35,7 +46,50 @@ class ResourceService {
         std::vector<std::pair<sqlite3_int64, std::string>>
             searchByContent(const std::string &keyword);
         std::vector<FullResource> searchByContentFull(const std::string &keyword);
+        // Note và file đã index trộn theo rank bm25; mỗi resource một hit kèm vị trí chỗ khớp
+        std::vector<ContentHit> searchContentHits(const std::string &keyword);
+        // Như trên với kế hoạch đã chọn sẵn (vd routeFuzzyQuery)
+        std::vector<ContentHit> searchContentHits(const RoutedQuery &query);
+        // Nơi định nghĩa type/hàm/macro tên name trong file cpp đã index (bảng symbols), mỗi
+        // định nghĩa một hit: snippet "function name", line là dòng của tên
+        std::vector<ContentHit> findDefinitions(const std::string &name);
         std::vector<Resource> getResourcesByTags(const std::vector<std::string> &tags);
+        // Truy vấn nhiều điều kiện (parseSearchQuery) trong một lần. Điều kiện tag/type đếm được
+        // qua index nên chạy trước, ít dòng nhất trước; title/content (FTS) chạy sau cùng. Khi
+        // ứng viên còn ít hơn số dòng của một điều kiện tag/type thì tra từng id thay vì đọc cả
+        // index, hết ứng viên thì bỏ qua các bước còn lại. Có facetTags thì kèm facet của cả tập
+        // kết quả (searchFacets) với tối đa facetTags tag
+        QueryMatches searchQuery(const SearchQuery &query,
+                                 std::optional<std::size_t> facetTags = std::nullopt);
+        // Số resource theo tag (topTags tag nhiều nhất) và theo type của một tập kết quả đã có,
+        // đếm trong một lượt qua index của resource_tags (countSearchFacets)
+        SearchFacets searchFacets(std::span<const sqlite3_int64> ids, std::size_t topTags);
+        // Mọi id khớp title, theo id (searchByTitlePage là từng trang của danh sách này)
+        std::vector<sqlite3_int64> searchTitleIds(const std::string &keyword);
+
+        // Index được chọn cho từ khóa (prefix/trigram/LIKE, xem QueryRouter); các hàm tìm
+        // title/nội dung ở trên và dưới đều chạy theo kế hoạch này
+        [[nodiscard]] RoutedQuery routeTitleQuery(std::string_view keyword) const;
+        [[nodiscard]] RoutedQuery routeContentQuery(std::string_view keyword) const;
+
+        // Như các hàm *Full nhưng đóng gói trong SearchResult (một arena cho cả kết quả) và
+        // không đọc nội dung note; tìm theo nội dung thì mỗi entry có hit kèm snippet
+        SearchResult searchByTitleResult(const std::string &keyword);
+        SearchResult searchByContentResult(const std::string &keyword);
+        SearchResult getResultByTag(const std::string &tag);
+
+        // Từng trang [offset, offset + limit) của cùng truy vấn, cho view nạp dần.
+        // Trang có thể ít hơn limit dòng (bỏ qua file mất dòng files) mà chưa phải trang cuối
+        SearchPage searchByTitlePage(const std::string &keyword, std::size_t offset,
+                                     std::size_t limit);
+        SearchPage getTagPage(const std::string &tag, std::size_t offset, std::size_t limit);
+        // Tìm theo nội dung xếp hạng trên toàn bộ hit nên hit được tìm một lần
+        // (searchContentHits), các trang chỉ đọc resource của phần hit tương ứng
+        SearchPage contentHitPage(std::span<const ContentHit> hits, std::size_t offset,
+                                  std::size_t limit);
+        // Trang của danh sách id đã có sẵn (vd LiveSearch), giữ thứ tự ids
+        SearchPage idPage(std::span<const sqlite3_int64> ids, std::size_t offset,
+                          std::size_t limit);
 
         // ========== Tags ==========
         void addTagToResource(sqlite3_int64 resourceId, const std::string &tag);
@@ -56,4 +110,5 @@ class ResourceService {
         TextContentRepository &m_textRepo;
         TagRepository &m_tagRepo;
         FileService &m_fileService;
+        ContentIndexRepository* m_contentIndexRepo; // nullptr => chỉ tìm trong text note
 };
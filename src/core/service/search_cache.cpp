@@ -0,0 +1,176 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "search_cache.hpp"
+#include "write_generations.hpp"
+
+namespace {
+    using Tables = std::span<const std::string_view>;
+
+    // Trang nào cũng đọc resource kèm path và tag (ResourceRepository::appendSearchEntries);
+    // schema đổi (vd bật trigram) thì cách tìm đổi theo
+    constexpr std::array<std::string_view, 5> kPageTables{
+        "resources", "files", "tags", "resource_tags", WriteGenerations::kSchema};
+    constexpr std::array<std::string_view, 7> kContentPageTables{
+        "resources",   "files",       "tags", "resource_tags",
+        "text_chunks", "file_chunks", WriteGenerations::kSchema};
+    // Hit của nội dung chỉ đọc bảng chunk (snippet cắt từ text_content, nhưng sửa note luôn ghi
+    // lại text_chunks); xóa resource thì chunk bị xóa theo (cascade)
+    constexpr std::array<std::string_view, 3> kContentHitTables{"text_chunks", "file_chunks",
+                                                                WriteGenerations::kSchema};
+
+    Tables tablesOf(const SearchCache::Key &key) {
+        switch (key.mode) {
+            case SearchCache::Mode::title:
+            case SearchCache::Mode::tag:
+                return kPageTables;
+            case SearchCache::Mode::content:
+                return key.limit == 0 ? Tables(kContentHitTables) : Tables(kContentPageTables);
+            case SearchCache::Mode::query:
+                return kContentPageTables;
+        }
+        return kContentPageTables;
+    }
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    // Phần node của list và unordered_map, ước lượng
+    constexpr std::size_t kNodeBytes{64};
+} // namespace
+
+std::string normalizeSearchQuery(std::string_view query) {
+    while (!query.empty() && isSpace(query.front())) { query.remove_prefix(1); }
+    while (!query.empty() && isSpace(query.back())) { query.remove_suffix(1); }
+    if (query.starts_with('*')) { return std::string(query); }
+
+    std::string out;
+    out.reserve(query.size());
+    bool inQuote{false};
+    bool pendingSpace{false};
+    for (const char c : query) {
+        if (!inQuote && isSpace(c)) {
+            pendingSpace = true;
+            continue;
+        }
+        if (pendingSpace) {
+            out += ' ';
+            pendingSpace = false;
+        }
+        if (c == '"') { inQuote = !inQuote; }
+        out += c;
+    }
+
+    return out;
+}
+
+SearchCache::Key SearchCache::pageKey(Mode mode, std::string_view query, std::size_t offset,
+                                      std::size_t limit) {
+    return {.mode = mode,
+            .query = mode == Mode::tag ? std::string(query) : normalizeSearchQuery(query),
+            .offset = offset,
+            .limit = limit};
+}
+
+SearchCache::Key SearchCache::matchesKey(Mode mode, std::string_view query) {
+    return pageKey(mode, query, 0, 0);
+}
+
+void SearchCache::setBudget(std::size_t bytes) {
+    m_budget = bytes;
+    trim();
+}
+
+void SearchCache::clear() noexcept {
+    m_index.clear();
+    m_entries.clear();
+    m_used = 0;
+}
+
+std::size_t SearchCache::KeyHash::operator()(const Key &key) const noexcept {
+    std::size_t hash = std::hash<std::string>{}(key.query);
+    const auto mix = [&](std::size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    };
+    mix(static_cast<std::size_t>(key.mode));
+    mix(key.offset);
+    mix(key.limit);
+    return hash;
+}
+
+std::optional<std::uint64_t> SearchCache::snapshot(const Key &key) const noexcept {
+    if (m_generations.inTransaction()) { return std::nullopt; }
+    return m_generations.version(tablesOf(key));
+}
+
+bool SearchCache::admits(const Key &key, std::optional<std::uint64_t> before,
+                         std::size_t bytes) const noexcept {
+    // Lúc tính xong vẫn ngoài transaction và không bảng nào bị ghi trong lúc tính
+    return before.has_value() && bytes <= m_budget && !m_generations.inTransaction() &&
+           m_generations.version(tablesOf(key)) == *before;
+}
+
+const SearchCache::Value* SearchCache::find(const Key &key) {
+    const auto found = m_index.find(key);
+    if (found == m_index.end()) { return nullptr; }
+
+    const auto it = found->second;
+    if (it->version != m_generations.version(tablesOf(key))) {
+        erase(it);
+        ++m_stats.stale;
+        return nullptr;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, it);
+    return &it->value;
+}
+
+void SearchCache::store(const Key &key, Value value, std::uint64_t version, std::size_t bytes) {
+    if (const auto found = m_index.find(key); found != m_index.end()) { erase(found->second); }
+
+    m_entries.push_front(
+        {.key = key, .value = std::move(value), .version = version, .bytes = bytes});
+    m_index.emplace(key, m_entries.begin());
+    m_used += bytes;
+    trim();
+}
+
+void SearchCache::erase(std::list<Entry>::iterator it) noexcept {
+    m_used -= it->bytes;
+    m_index.erase(it->key);
+    m_entries.erase(it);
+}
+
+void SearchCache::trim() noexcept {
+    while (m_used > m_budget && !m_entries.empty()) {
+        erase(std::prev(m_entries.end()));
+        ++m_stats.evictions;
+    }
+}
+
+std::size_t SearchCache::pageBytes(const Key &key, const SearchPage &page) noexcept {
+    return sizeof(Entry) + kNodeBytes + 2 * key.query.size() + page.result.arenaBytes();
+}
+
+std::size_t SearchCache::matchesBytes(const Key &key, const QueryMatches &matches) noexcept {
+    std::size_t bytes = sizeof(Entry) + kNodeBytes + 2 * key.query.size() +
+                        sizeof(QueryMatches) + matches.plan.capacity() +
+                        matches.ids.capacity() * sizeof(sqlite3_int64) +
+                        matches.hits.capacity() * sizeof(ContentHit);
+    for (const auto &hit : matches.hits) { bytes += hit.snippet.capacity(); }
+    if (matches.facets.has_value()) {
+        for (const auto &facets : {&matches.facets->tags, &matches.facets->types}) {
+            bytes += facets->capacity() * sizeof(FacetCount);
+            for (const auto &facet : *facets) { bytes += facet.name.capacity(); }
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include "search_query.hpp"
+#include "search_result.hpp"
+
+class WriteGenerations;
+
+// Gộp khoảng trắng ngoài cặp "..." (FTS5 không phân biệt) và bỏ khoảng trắng hai đầu; truy vấn
+// chuỗi con (*...) chỉ bỏ hai đầu vì khoảng trắng bên trong là một phần của chuỗi cần tìm
+[[nodiscard]] std::string normalizeSearchQuery(std::string_view query);
+
+// Cache LRU kết quả tìm kiếm, giới hạn theo tổng byte: từng trang đã đọc resource và danh sách
+// hit/id của cả truy vấn. Mỗi mục nhớ version (WriteGenerations) của các bảng mà nó đọc, lấy lúc
+// bắt đầu tính; lúc tra mà một bảng trong đó đã bị ghi thì mục bị bỏ, nên không bao giờ trả kết
+// quả cũ. Kết quả tính trong transaction (có thể chưa commit) hoặc có ghi xen vào lúc đang tính
+// thì không được lưu. Chỉ dùng từ một thread.
+class SearchCache {
+    public:
+        enum class Mode : std::uint8_t { title, content, tag, query };
+
+        struct Key {
+                Mode mode{};
+                std::string query;   // đã chuẩn hóa, riêng tag giữ nguyên (tên tag so khớp đúng)
+                std::size_t offset{};
+                std::size_t limit{}; // 0: danh sách của cả truy vấn thay vì một trang
+
+                bool operator==(const Key &) const = default;
+        };
+
+        struct Stats {
+                std::size_t hits{};
+                std::size_t misses{};
+                std::size_t stale{};     // mục bị bỏ lúc tra vì bảng đã bị ghi
+                std::size_t evictions{}; // mục bị đẩy ra vì vượt ngân sách
+        };
+
+        SearchCache(const WriteGenerations &generations, std::size_t budgetBytes) noexcept
+            : m_generations(generations), m_budget(budgetBytes) {}
+
+        [[nodiscard]] static Key pageKey(Mode mode, std::string_view query, std::size_t offset,
+                                         std::size_t limit);
+        [[nodiscard]] static Key matchesKey(Mode mode, std::string_view query);
+
+        // Bản sao của trang đã cache, hoặc compute() rồi lưu lại
+        template <class Compute> SearchPage page(const Key &key, Compute &&compute);
+        // Danh sách đã cache (dùng chung, không copy), hoặc compute() rồi lưu lại
+        template <class Compute>
+        std::shared_ptr<const QueryMatches> matches(const Key &key, Compute &&compute);
+
+        // Giảm ngân sách thì đẩy mục cũ nhất ra ngay
+        void setBudget(std::size_t bytes);
+        [[nodiscard]] std::size_t budget() const noexcept { return m_budget; }
+        [[nodiscard]] std::size_t usedBytes() const noexcept { return m_used; }
+        [[nodiscard]] std::size_t size() const noexcept { return m_entries.size(); }
+        [[nodiscard]] const Stats &stats() const noexcept { return m_stats; }
+        void clear() noexcept;
+
+    private:
+        using Value = std::variant<SearchPage, std::shared_ptr<const QueryMatches>>;
+
+        struct Entry {
+                Key key;
+                Value value;
+                std::uint64_t version{};
+                std::size_t bytes{};
+        };
+
+        struct KeyHash {
+                std::size_t operator()(const Key &key) const noexcept;
+        };
+
+        // Version các bảng mà mục của key đọc; nullopt khi đang trong transaction
+        [[nodiscard]] std::optional<std::uint64_t> snapshot(const Key &key) const noexcept;
+        [[nodiscard]] bool admits(const Key &key, std::optional<std::uint64_t> before,
+                                  std::size_t bytes) const noexcept;
+
+        // Mục còn đúng của key (đưa lên đầu LRU), nullptr nếu không có
+        const Value* find(const Key &key);
+        void store(const Key &key, Value value, std::uint64_t version, std::size_t bytes);
+        void erase(std::list<Entry>::iterator it) noexcept;
+        void trim() noexcept;
+
+        [[nodiscard]] static std::size_t pageBytes(const Key &key, const SearchPage &page) noexcept;
+        [[nodiscard]] static std::size_t matchesBytes(const Key &key,
+                                                      const QueryMatches &matches) noexcept;
+
+        const WriteGenerations &m_generations;
+        std::size_t m_budget;
+        std::size_t m_used{0};
+        std::list<Entry> m_entries; // đầu danh sách: dùng gần nhất
+        std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+        Stats m_stats;
+};
+
+template <class Compute> SearchPage SearchCache::page(const Key &key, Compute &&compute) {
+    if (const auto* cached = find(key)) {
+        if (const auto* stored = std::get_if<SearchPage>(cached)) {
+            ++m_stats.hits;
+            return {.result = stored->result.copy(), .last = stored->last};
+        }
+    }
+    ++m_stats.misses;
+
+    const auto before = snapshot(key);
+    SearchPage fresh = std::forward<Compute>(compute)();
+
+    const auto bytes = pageBytes(key, fresh);
+    if (admits(key, before, bytes)) {
+        store(key, SearchPage{.result = fresh.result.copy(), .last = fresh.last}, *before, bytes);
+    }
+    return fresh;
+}
+
+template <class Compute>
+std::shared_ptr<const QueryMatches> SearchCache::matches(const Key &key, Compute &&compute) {
+    if (const auto* cached = find(key)) {
+        if (const auto* stored = std::get_if<std::shared_ptr<const QueryMatches>>(cached)) {
+            ++m_stats.hits;
+            return *stored;
+        }
+    }
+    ++m_stats.misses;
+
+    const auto before = snapshot(key);
+    auto fresh = std::make_shared<const QueryMatches>(std::forward<Compute>(compute)());
+
+    const auto bytes = matchesBytes(key, *fresh);
+    if (admits(key, before, bytes)) { store(key, fresh, *before, bytes); }
+    return fresh;
+}
@@ -29,6 +29,12 @@ bool AppSettings::load(const std::filesystem::path &path) {
     if (kv.contains("is_managed")) {
         m_isManagedResource = (kv["is_managed"] == "true" || kv["is_managed"] == "1");
     }
+    if (kv.contains("compress_notes")) {
+        m_compressNotes = (kv["compress_notes"] == "true" || kv["compress_notes"] == "1");
+    }
+    if (kv.contains("substring_index")) {
+        m_substringIndex = (kv["substring_index"] == "true" || kv["substring_index"] == "1");
+    }
 
     m_dirty = false;
 
@@ -45,6 +51,8 @@ bool AppSettings::save(const std::filesystem::path &path) const {
     file << "language=" << (m_language == Language::english ? "en" : "vi") << "\n";
     file << "resource_dir=" << m_resourceDir.string() << "\n";
     file << "is_managed=" << (m_isManagedResource ? "true" : "false") << "\n";
+    file << "compress_notes=" << (m_compressNotes ? "true" : "false") << "\n";
+    file << "substring_index=" << (m_substringIndex ? "true" : "false") << "\n";
 
     return true;
 }
@@ -76,3 +84,17 @@ void AppSettings::setManagedResources(bool managed) noexcept {
         m_dirty = true;
     }
 }
+
+void AppSettings::setCompressNotes(bool compress) noexcept {
+    if (m_compressNotes != compress) {
+        m_compressNotes = compress;
+        m_dirty = true;
+    }
+}
+
+void AppSettings::setSubstringIndex(bool enabled) noexcept {
+    if (m_substringIndex != enabled) {
+        m_substringIndex = enabled;
+        m_dirty = true;
+    }
+}
@@ -22,6 +22,10 @@ class AppSettings {
 
         [[nodiscard]] bool isManagedResources() const noexcept { return m_isManagedResource; }
 
+        [[nodiscard]] bool compressNotes() const noexcept { return m_compressNotes; }
+
+        [[nodiscard]] bool substringIndex() const noexcept { return m_substringIndex; }
+
         // Setter
         void setTheme(Theme theme) noexcept;
 
@@ -31,6 +35,10 @@ class AppSettings {
 
         void setManagedResources(bool managed) noexcept;
 
+        void setCompressNotes(bool compress) noexcept;
+
+        void setSubstringIndex(bool enabled) noexcept;
+
         // =====================
 
         void markDirty(bool dirty = true) noexcept { m_dirty = dirty; }
@@ -42,6 +50,8 @@ class AppSettings {
         Language m_language{Language::english};
         std::filesystem::path m_resourceDir{"resources"};
         bool m_isManagedResource{true};
+        bool m_compressNotes{}; // nén nội dung note trong DB
+        bool m_substringIndex{}; // index trigram cho tìm chuỗi con trong nội dung
 
         bool m_dirty{}; // trạng thái thay đổi kể từ lần load/save cuối
 };
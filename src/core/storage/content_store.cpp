@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+#include "content_store.hpp"
+
+namespace {
+    constexpr std::size_t kSha256HexLen{64};
+} // namespace
+
+ContentStore::ContentStore(std::filesystem::path root, Layout layout)
+    : m_root(std::move(root)), m_layout(layout) {
+    if (m_root.empty()) { m_root = "resources"; }
+
+    if (static_cast<std::size_t>(m_layout.levels) * m_layout.width >= kSha256HexLen) {
+        throw std::invalid_argument("ContentStore layout consumes the whole hash");
+    }
+}
+
+std::filesystem::path ContentStore::pathFor(std::string_view hash, std::string_view ext) const {
+    std::filesystem::path dir = m_root;
+
+    for (std::size_t level = 0; level < m_layout.levels; ++level) {
+        const std::size_t pos = level * m_layout.width;
+        if (pos + m_layout.width > hash.size()) { break; }
+        dir /= std::string(hash.substr(pos, m_layout.width));
+    }
+
+    std::string name(hash);
+    name += ext;
+
+    return dir / name;
+}
+
+std::filesystem::path ContentStore::makeTempPath() const {
+    static thread_local std::mt19937_64 rng{std::random_device{}()};
+
+    std::filesystem::create_directories(m_root);
+    return m_root / (".import-" + std::to_string(rng()) + ".tmp");
+}
+
+// exists rồi rename không atomic: hai thread import cùng nội dung đều thấy đích chưa có và cùng
+// nhận true. Hard link không bao giờ ghi đè nên kiểm tra và tạo đích là một thao tác
+bool ContentStore::commit(const std::filesystem::path &tempPath,
+                          const std::filesystem::path &dest) const {
+    namespace fs = std::filesystem;
+
+    fs::create_directories(dest.parent_path());
+
+    std::error_code ec;
+    fs::create_hard_link(tempPath, dest, ec);
+    if (ec == std::errc::file_exists) { return false; }
+    if (!ec) {
+        fs::remove(tempPath, ec);
+        return true;
+    }
+
+    // Filesystem không có hard link (FAT...): giữ chỗ đích bằng file tạo độc quyền rồi rename đè
+    // lên. Trong khoảng giữa đích là file rỗng, chỉ caller cùng hash (nhận false) thấy nó
+    {
+        std::ofstream reserve(dest, std::ios::binary | std::ios::noreplace);
+        if (!reserve.is_open()) {
+            if (fs::exists(dest)) { return false; }
+            throw std::runtime_error("Error, cannot create store file: " + dest.string());
+        }
+    }
+
+    try {
+        fs::rename(tempPath, dest);
+    } catch (...) {
+        fs::remove(dest, ec);
+        throw;
+    }
+
+    return true;
+}
+
+std::vector<ContentStore::MigrationEntry>
+    ContentStore::planFlatMigration(const std::filesystem::path &flatDir) const {
+    namespace fs = std::filesystem;
+
+    std::vector<MigrationEntry> plan;
+    if (m_layout.levels == 0 || !fs::is_directory(flatDir)) { return plan; }
+
+    for (const auto &item : fs::directory_iterator(flatDir)) {
+        if (!item.is_regular_file()) { continue; }
+        if (!isContentName(item.path().stem().string())) { continue; }
+        plan.push_back({.from = item.path(),
+                        .to = pathFor(item.path().stem().string(),
+                                      item.path().extension().string())});
+    }
+
+    return plan;
+}
+
+void ContentStore::applyMigration(const std::vector<MigrationEntry> &entries) const {
+    namespace fs = std::filesystem;
+
+    std::vector<const MigrationEntry*> renamed;
+    std::vector<const MigrationEntry*> duplicates;
+
+    try {
+        for (const auto &entry : entries) {
+            fs::create_directories(entry.to.parent_path());
+            if (fs::exists(entry.to)) {
+                // Bản sharded đã có (cùng nội dung) -> bản phẳng bỏ sau khi xong hết
+                duplicates.push_back(&entry);
+            } else {
+                fs::rename(entry.from, entry.to);
+                renamed.push_back(&entry);
+            }
+        }
+    } catch (...) {
+        std::error_code ec;
+        for (const auto* entry : renamed) { fs::rename(entry->to, entry->from, ec); }
+        throw;
+    }
+
+    std::error_code ec;
+    for (const auto* entry : duplicates) { fs::remove(entry->from, ec); }
+}
+
+std::vector<ContentStore::MigrationEntry>
+    ContentStore::migrateFlat(const std::filesystem::path &flatDir) const {
+    auto plan = planFlatMigration(flatDir);
+    applyMigration(plan);
+    return plan;
+}
+
+bool ContentStore::isContentName(std::string_view stem) noexcept {
+    return stem.size() == kSha256HexLen && std::ranges::all_of(stem, [](char c) {
+               return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f');
+           });
+}
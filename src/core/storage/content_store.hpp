@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Cách chia thư mục con: levels cấp, mỗi cấp lấy width ký tự đầu của hash
+struct StoreLayout {
+        std::uint8_t levels{2}; // số cấp thư mục con (0 = phẳng như cũ)
+        std::uint8_t width{2};  // số ký tự hash cho mỗi cấp
+};
+
+// Kho lưu trữ file theo nội dung (content-addressed): <root>/ab/cd/<hash><ext>
+// Chia thư mục con theo tiền tố hash để tránh một thư mục phẳng chứa hàng trăm nghìn file
+class ContentStore {
+    public:
+        using Layout = StoreLayout;
+
+        struct MigrationEntry {
+                std::filesystem::path from;
+                std::filesystem::path to;
+        };
+
+        explicit ContentStore(std::filesystem::path root = "resources", Layout layout = StoreLayout{});
+
+        [[nodiscard]] const std::filesystem::path &root() const noexcept { return m_root; }
+
+        [[nodiscard]] Layout layout() const noexcept { return m_layout; }
+
+        // Đường dẫn đích của một hash (không kiểm tra tồn tại)
+        [[nodiscard]] std::filesystem::path pathFor(std::string_view hash,
+                                                    std::string_view ext) const;
+
+        // File tạm nằm trong root để link/rename sang đích là atomic (cùng filesystem)
+        [[nodiscard]] std::filesystem::path makeTempPath() const;
+
+        // Đưa file tạm vào vị trí của hash mà không ghi đè, trả về false nếu đích đã tồn tại
+        // (file tạm giữ nguyên để caller tự xóa). Atomic: nhiều thread commit cùng một đích thì
+        // đúng một thread nhận true
+        bool commit(const std::filesystem::path &tempPath,
+                    const std::filesystem::path &dest) const;
+
+        // Các file <hash><ext> nằm phẳng trong flatDir và đích của chúng trong layout hiện tại,
+        // chưa di chuyển gì: caller cập nhật DB trước rồi mới applyMigration
+        std::vector<MigrationEntry> planFlatMigration(const std::filesystem::path &flatDir) const;
+
+        std::vector<MigrationEntry> planFlatMigration() const {
+            return planFlatMigration(m_root);
+        }
+
+        // Di chuyển theo kế hoạch. Lỗi giữa chừng thì trả các file đã chuyển về chỗ cũ rồi ném
+        // tiếp; bản phẳng có đích đã tồn tại (cùng nội dung) chỉ bị xóa khi mọi file đã chuyển
+        void applyMigration(const std::vector<MigrationEntry> &entries) const;
+
+        // planFlatMigration + applyMigration, trả về danh sách file đã di chuyển
+        std::vector<MigrationEntry> migrateFlat(const std::filesystem::path &flatDir) const;
+
+        std::vector<MigrationEntry> migrateFlat() const { return migrateFlat(m_root); }
+
+        [[nodiscard]] static bool isContentName(std::string_view stem) noexcept;
+
+    private:
+        std::filesystem::path m_root;
+        Layout m_layout;
+};
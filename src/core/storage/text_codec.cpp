@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <zlib.h>
+#include "text_codec.hpp"
+
+namespace {
+    constexpr std::size_t kMaxSampleBytes{16 * 1024 * 1024}; // giới hạn bộ nhớ khi học
+    constexpr std::size_t kMinLine{8};
+    constexpr std::size_t kMaxLine{512};
+    constexpr std::size_t kMinWord{5};
+    constexpr std::size_t kMaxWord{64};
+    constexpr int kLevel{9};
+    constexpr int kMemLevel{8};
+    // Deflate nở tối đa ~1032 lần (match 258 byte trong vài bit); +1 cho stream chỉ vài byte
+    constexpr std::uint64_t kMaxInflateRatio{1032};
+
+    void putU32(std::string &out, std::uint32_t value) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            out.push_back(static_cast<char>((value >> shift) & 0xFFU));
+        }
+    }
+
+    std::uint32_t getU32(std::string_view data, std::size_t pos) {
+        std::uint32_t value{};
+        for (int i = 3; i >= 0; --i) {
+            value = (value << 8U) |
+                    static_cast<unsigned char>(data[pos + static_cast<std::size_t>(i)]);
+        }
+        return value;
+    }
+
+    bool isSpace(char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    template <typename Fn>
+    void forEachWord(std::string_view text, Fn &&fn) {
+        std::size_t pos{0};
+        while (pos < text.size()) {
+            while (pos < text.size() && isSpace(text[pos])) { ++pos; }
+            const std::size_t start = pos;
+            while (pos < text.size() && !isSpace(text[pos])) { ++pos; }
+            if (pos > start) { fn(text.substr(start, pos - start)); }
+        }
+    }
+
+    // Các đoạn ứng viên của một mẫu, mỗi đoạn tính một lần dù lặp lại trong mẫu
+    void collectFragments(std::string_view sample, std::unordered_set<std::string_view> &out) {
+        std::size_t pos{0};
+        while (pos < sample.size()) {
+            auto end = sample.find('\n', pos);
+            if (end == std::string_view::npos) { end = sample.size(); }
+
+            auto line = sample.substr(pos, end - pos);
+            if (!line.empty() && line.back() == '\r') { line.remove_suffix(1); }
+            if (line.size() >= kMinLine && line.size() <= kMaxLine) { out.insert(line); }
+
+            forEachWord(line, [&](std::string_view word) {
+                if (word.size() >= kMinWord && word.size() <= kMaxWord) { out.insert(word); }
+            });
+
+            pos = end + 1;
+        }
+    }
+
+    struct Fragment {
+            std::string_view text;
+            std::size_t score{};
+    };
+} // namespace
+
+std::string TextCodec::trainDictionary(const std::vector<std::string_view> &samples,
+                                       std::size_t maxSize) {
+    maxSize = std::min(maxSize, kMaxDictionarySize);
+
+    std::unordered_map<std::string_view, std::size_t> docFreq;
+    std::unordered_set<std::string_view> fragments;
+    std::size_t consumed{0};
+
+    for (const auto sample : samples) {
+        if (consumed >= kMaxSampleBytes) { break; }
+        consumed += sample.size();
+
+        fragments.clear();
+        collectFragments(sample, fragments);
+        for (const auto fragment : fragments) { ++docFreq[fragment]; }
+    }
+
+    // Đoạn chỉ có trong một mẫu không giúp gì cho các note khác
+    std::vector<Fragment> ranked;
+    for (const auto &[text, count] : docFreq) {
+        if (count >= 2) { ranked.push_back({text, count * text.size()}); }
+    }
+
+    std::ranges::sort(ranked, [](const Fragment &a, const Fragment &b) {
+        return a.score != b.score ? a.score > b.score : a.text < b.text;
+    });
+
+    // Từ đã nằm trong một dòng được chọn thì không cần thêm riêng
+    std::unordered_set<std::string_view> covered;
+    std::vector<std::string_view> selected;
+    std::size_t total{0};
+
+    for (const auto &fragment : ranked) {
+        if (covered.contains(fragment.text)) { continue; }
+        if (total + fragment.text.size() + 1 > maxSize) { continue; }
+
+        selected.push_back(fragment.text);
+        total += fragment.text.size() + 1;
+        forEachWord(fragment.text, [&](std::string_view word) { covered.insert(word); });
+    }
+
+    std::string dictionary;
+    dictionary.reserve(total);
+    for (const auto text : selected | std::views::reverse) {
+        dictionary.append(text);
+        dictionary.push_back('\n');
+    }
+
+    return dictionary;
+}
+
+TextCodec::TextCodec(std::uint32_t id, std::string dictionary)
+    : m_id(id), m_dictionary(std::move(dictionary)) {
+    if (m_dictionary.size() > kMaxDictionarySize) {
+        // deflate chỉ nhìn được 32 KiB cuối; giữ phần đó để nén/giải nén luôn khớp nhau
+        m_dictionary.erase(0, m_dictionary.size() - kMaxDictionarySize);
+    }
+}
+
+std::string TextCodec::compress(std::string_view text) const {
+    if (text.size() > std::numeric_limits<std::uint32_t>::max()) {
+        throw std::invalid_argument("Text is too large to compress");
+    }
+
+    z_stream zs{};
+    if (deflateInit2(&zs, kLevel, Z_DEFLATED, -MAX_WBITS, kMemLevel, Z_DEFAULT_STRATEGY) !=
+        Z_OK) {
+        throw std::runtime_error("deflateInit2 failed");
+    }
+
+    if (!m_dictionary.empty() &&
+        deflateSetDictionary(&zs, reinterpret_cast<const Bytef*>(m_dictionary.data()),
+                             static_cast<uInt>(m_dictionary.size())) != Z_OK) {
+        deflateEnd(&zs);
+        throw std::runtime_error("deflateSetDictionary failed");
+    }
+
+    std::string out;
+    putU32(out, m_id);
+    putU32(out, static_cast<std::uint32_t>(text.size()));
+    out.resize(kHeaderSize + deflateBound(&zs, static_cast<uLong>(text.size())));
+
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(text.data()));
+    zs.avail_in = static_cast<uInt>(text.size());
+    zs.next_out = reinterpret_cast<Bytef*>(out.data() + kHeaderSize);
+    zs.avail_out = static_cast<uInt>(out.size() - kHeaderSize);
+
+    const int rc = deflate(&zs, Z_FINISH);
+    const auto written = zs.total_out;
+    deflateEnd(&zs);
+
+    if (rc != Z_STREAM_END) { throw std::runtime_error("deflate failed"); }
+
+    out.resize(kHeaderSize + written);
+    return out;
+}
+
+std::string TextCodec::decompress(std::string_view blob) const {
+    if (dictionaryId(blob) != m_id) {
+        throw std::runtime_error("Compressed text uses dictionary " +
+                                 std::to_string(dictionaryId(blob)) + ", expected " +
+                                 std::to_string(m_id));
+    }
+
+    const std::uint32_t rawSize = getU32(blob, 4);
+    const auto data = blob.substr(kHeaderSize);
+
+    // Header hỏng có thể đòi tới 4 GiB: kiểm tra trước khi cấp phát
+    if (rawSize > (static_cast<std::uint64_t>(data.size()) + 1) * kMaxInflateRatio) {
+        throw std::runtime_error("Corrupted compressed text: size " + std::to_string(rawSize) +
+                                 " exceeds what " + std::to_string(data.size()) +
+                                 " bytes can inflate to");
+    }
+
+    z_stream zs{};
+    if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+        throw std::runtime_error("inflateInit2 failed");
+    }
+
+    // Deflate thô: đặt từ điển ngay sau init, không chờ Z_NEED_DICT
+    if (!m_dictionary.empty() &&
+        inflateSetDictionary(&zs, reinterpret_cast<const Bytef*>(m_dictionary.data()),
+                             static_cast<uInt>(m_dictionary.size())) != Z_OK) {
+        inflateEnd(&zs);
+        throw std::runtime_error("inflateSetDictionary failed");
+    }
+
+    std::string out(rawSize, '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+    zs.next_out = reinterpret_cast<Bytef*>(out.data());
+    zs.avail_out = rawSize;
+
+    const int rc = inflate(&zs, Z_FINISH);
+    const auto produced = zs.total_out;
+    inflateEnd(&zs);
+
+    if (rc != Z_STREAM_END || produced != rawSize) {
+        throw std::runtime_error("Corrupted compressed text");
+    }
+
+    return out;
+}
+
+std::uint32_t TextCodec::dictionaryId(std::string_view blob) {
+    if (blob.size() < kHeaderSize) { throw std::runtime_error("Corrupted compressed text"); }
+
+    return getU32(blob, 0);
+}
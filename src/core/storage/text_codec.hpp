@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Nén text note bằng deflate thô với từ điển dựng sẵn (preset dictionary) học từ chính các note.
+// Note ngắn nén riêng lẻ gần như không được gì; từ điển chứa các dòng/từ lặp lại giữa nhiều note
+// (header, boilerplate, code) nên deflate tham chiếu được ngay từ byte đầu.
+//
+// Định dạng blob: [u32 LE id từ điển (0 = không từ điển)][u32 LE kích thước gốc][deflate thô]
+class TextCodec {
+    public:
+        static constexpr std::size_t kMaxDictionarySize{32 * 1024}; // cửa sổ deflate
+        static constexpr std::size_t kHeaderSize{8};
+
+        // Chọn các dòng và từ xuất hiện trong nhiều mẫu nhất (điểm = số mẫu * độ dài), ghép
+        // thành từ điển tối đa maxSize byte; đoạn điểm cao nằm cuối (gần dữ liệu nhất).
+        // Trả về rỗng nếu không có gì lặp lại giữa các mẫu
+        [[nodiscard]] static std::string trainDictionary(
+            const std::vector<std::string_view> &samples,
+            std::size_t maxSize = kMaxDictionarySize);
+
+        // id = 0 dùng cho nén không từ điển
+        explicit TextCodec(std::uint32_t id = 0, std::string dictionary = {});
+
+        [[nodiscard]] std::uint32_t id() const noexcept { return m_id; }
+
+        [[nodiscard]] const std::string &dictionary() const noexcept { return m_dictionary; }
+
+        [[nodiscard]] std::string compress(std::string_view text) const;
+
+        // Ném lỗi nếu blob hỏng hoặc được nén bằng từ điển khác
+        [[nodiscard]] std::string decompress(std::string_view blob) const;
+
+        // Id từ điển đã dùng để nén blob
+        [[nodiscard]] static std::uint32_t dictionaryId(std::string_view blob);
+
+    private:
+        std::uint32_t m_id;
+        std::string m_dictionary;
+};
@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include "text_delta.hpp"
+
+namespace {
+    constexpr char kCopy{0x00};
+    constexpr char kInsert{0x01};
+
+    void putVarint(std::string &out, std::uint64_t value) {
+        while (value >= 0x80U) {
+            out.push_back(static_cast<char>((value & 0x7FU) | 0x80U));
+            value >>= 7U;
+        }
+        out.push_back(static_cast<char>(value));
+    }
+
+    std::uint64_t getVarint(std::string_view data, std::size_t &pos) {
+        std::uint64_t value{};
+        for (unsigned shift = 0; shift < 64; shift += 7) {
+            if (pos >= data.size()) { break; }
+
+            const auto byte = static_cast<unsigned char>(data[pos++]);
+            value |= static_cast<std::uint64_t>(byte & 0x7FU) << shift;
+            if ((byte & 0x80U) == 0) { return value; }
+        }
+        throw std::runtime_error("Corrupted text delta");
+    }
+
+    class DeltaWriter {
+        public:
+            explicit DeltaWriter(std::size_t targetSize) { putVarint(m_out, targetSize); }
+
+            void copy(std::size_t offset, std::size_t length) {
+                if (length == 0) { return; }
+
+                m_out.push_back(kCopy);
+                putVarint(m_out, offset);
+                putVarint(m_out, length);
+            }
+
+            void insert(std::string_view bytes) {
+                if (bytes.empty()) { return; }
+
+                m_out.push_back(kInsert);
+                putVarint(m_out, bytes.size());
+                m_out.append(bytes);
+            }
+
+            std::string take() { return std::move(m_out); }
+
+        private:
+            std::string m_out;
+    };
+} // namespace
+
+std::string TextDelta::make(std::string_view base, std::string_view target) {
+    DeltaWriter writer(target.size());
+
+    // Phần đầu/cuối giống nhau là trường hợp phổ biến nhất khi sửa note
+    const std::size_t limit = std::min(base.size(), target.size());
+    std::size_t prefix{0};
+    while (prefix < limit && base[prefix] == target[prefix]) { ++prefix; }
+
+    std::size_t suffix{0};
+    while (suffix < limit - prefix &&
+           base[base.size() - 1 - suffix] == target[target.size() - 1 - suffix]) {
+        ++suffix;
+    }
+
+    const std::size_t baseEnd = base.size() - suffix;
+    const std::size_t targetEnd = target.size() - suffix;
+
+    writer.copy(0, prefix);
+
+    // Phần giữa: tìm lại các khối kBlockSize byte của base (đoạn bị di chuyển, chèn giữa...)
+    std::unordered_map<std::string_view, std::size_t> blocks;
+    for (std::size_t off = prefix; off + kBlockSize <= baseEnd; off += kBlockSize) {
+        blocks.try_emplace(base.substr(off, kBlockSize), off);
+    }
+
+    std::size_t literal{prefix};
+    std::size_t pos{prefix};
+    while (!blocks.empty() && pos + kBlockSize <= targetEnd) {
+        const auto found = blocks.find(target.substr(pos, kBlockSize));
+        if (found == blocks.end()) {
+            ++pos;
+            continue;
+        }
+
+        std::size_t from = found->second;
+        std::size_t length{kBlockSize};
+        while (pos + length < targetEnd && from + length < baseEnd &&
+               target[pos + length] == base[from + length]) {
+            ++length;
+        }
+
+        // Nới đoạn khớp ngược về phía trước, lấy lại phần đã tính là chèn
+        std::size_t start = pos;
+        while (start > literal && from > prefix && target[start - 1] == base[from - 1]) {
+            --start;
+            --from;
+            ++length;
+        }
+
+        writer.insert(target.substr(literal, start - literal));
+        writer.copy(from, length);
+        pos = start + length;
+        literal = pos;
+    }
+
+    writer.insert(target.substr(literal, targetEnd - literal));
+    writer.copy(baseEnd, suffix);
+
+    return writer.take();
+}
+
+std::string TextDelta::apply(std::string_view base, std::string_view delta) {
+    std::size_t pos{0};
+    const auto size = getVarint(delta, pos);
+
+    std::string out;
+    // size đọc từ dữ liệu có thể hỏng: chỉ reserve trong giới hạn hợp lý
+    out.reserve(static_cast<std::size_t>(
+        std::min<std::uint64_t>(size, base.size() + delta.size())));
+
+    while (pos < delta.size()) {
+        const char op = delta[pos++];
+
+        if (op == kCopy) {
+            const auto offset = getVarint(delta, pos);
+            const auto length = getVarint(delta, pos);
+            if (offset > base.size() || length > base.size() - offset) {
+                throw std::runtime_error("Text delta does not match its base");
+            }
+            out.append(base.substr(offset, length));
+
+        } else if (op == kInsert) {
+            const auto length = getVarint(delta, pos);
+            if (length > delta.size() - pos) { throw std::runtime_error("Corrupted text delta"); }
+            out.append(delta.substr(pos, length));
+            pos += length;
+
+        } else {
+            throw std::runtime_error("Corrupted text delta");
+        }
+    }
+
+    if (out.size() != size) { throw std::runtime_error("Corrupted text delta"); }
+
+    return out;
+}
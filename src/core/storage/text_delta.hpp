@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+// Delta nhị phân giữa hai phiên bản text (kiểu git/xdelta): chuỗi lệnh copy từ base và
+// insert byte mới. Sửa vài dòng trong note dài chỉ tốn vài chục byte.
+//
+//   delta := varint(target size) op*
+//   op    := 0x00 varint(offset) varint(length)    copy từ base
+//          | 0x01 varint(length) byte[length]      chèn nguyên văn
+class TextDelta {
+    public:
+        // Đoạn khớp ngắn hơn thì chèn thẳng rẻ hơn một lệnh copy
+        static constexpr std::size_t kBlockSize{16};
+
+        [[nodiscard]] static std::string make(std::string_view base, std::string_view target);
+
+        // Ném std::runtime_error nếu delta hỏng hoặc không khớp base
+        [[nodiscard]] static std::string apply(std::string_view base, std::string_view delta);
+};
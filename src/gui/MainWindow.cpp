@@ -4,6 +4,7 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QRadioButton>
+#include <QCheckBox>
 #include <QTableWidget>
 #include <QHBoxLayout>
 #include <QFormLayout>
@@ -17,24 +18,39 @@
 #include <QScrollBar>
 #include <QFontDatabase>
 #include <QTextEdit>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QTextDocument>
 #include <QFileDialog>
 #include <QMenu>
 #include <QPoint>
+#include <QStatusBar>
+#include <QTimer>
+#include <QStringList>
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <optional>
 #include <ranges>
+#include <vector>
 
 #include "UiConstants.hpp"
 #include "BrowseTabWidget.hpp"
 #include "AddTabWidget.hpp"
+#include "ImportDialog.hpp"
+#include "ImportWorker.hpp"
 #include "SettingsTabWidget.hpp"
 #include "MainWindow.hpp"
 #include "AppSettings.hpp"
 #include "CodeEditorLineHighlighter.hpp"
+#include "ResultsModel.hpp"
 #include "ResultsTable.hpp"
 #include "cpphighlightertheme.hpp"
 #include "cpphighlighter.hpp"
 #include "model.hpp"
 #include "NotesAppCore.hpp"
+#include "regex_search.hpp"
+#include "search_query.hpp"
 #include "TagInput.hpp"
 #include "AppController.hpp"
 
@@ -42,6 +58,24 @@ namespace {
     constexpr int GUI_WIDTH{1200};
     constexpr int GUI_HEIGHT{800};
     constexpr int NOTI_TIMEOUT{3000};
+    constexpr int REGEX_POLL_INTERVAL{30};                     // ms giữa hai lần lấy kết quả
+    constexpr std::chrono::milliseconds REGEX_POLL_SLICE{10}; // thời gian chờ tối đa mỗi lần
+
+    // "12 results · tags: cpp 5, ds 3 · types: text 10, cpp 2"
+    QString facetSummary(const SearchFacets &facets) {
+        const auto join = [](const std::vector<FacetCount> &counts) {
+            QStringList parts;
+            for (const auto &facet : counts) {
+                parts << QString("%1 %2").arg(QString::fromStdString(facet.name)).arg(facet.count);
+            }
+            return parts.join(", ");
+        };
+
+        QString summary = QObject::tr("%1 results").arg(facets.total);
+        if (!facets.tags.empty()) { summary += QObject::tr(" · tags: ") + join(facets.tags); }
+        if (!facets.types.empty()) { summary += QObject::tr(" · types: ") + join(facets.types); }
+        return summary;
+    }
 } // namespace
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
@@ -51,6 +85,8 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent) {
     buildUi();
 }
 
+MainWindow::~MainWindow() = default;
+
 void MainWindow::buildUi() {
     m_tabWidget = new QTabWidget(this);
     setCentralWidget(m_tabWidget);
@@ -66,10 +102,15 @@ void MainWindow::setupBrowseTab() {
     m_browseTab = new BrowseTabWidget(this);
 
     connect(m_browseTab, &BrowseTabWidget::searchRequested, this, &MainWindow::onSearchClicked);
+    connect(m_browseTab, &BrowseTabWidget::liveSearchRequested, this, &MainWindow::onLiveSearch);
+
+    m_regexTimer = new QTimer(this);
+    m_regexTimer->setInterval(REGEX_POLL_INTERVAL);
+    connect(m_regexTimer, &QTimer::timeout, this, &MainWindow::onRegexPoll);
 
     connect(m_browseTab, &BrowseTabWidget::resourceDoubleClicked, this,
-            [this](const QString &id, const QString &title, const QString &path) {
-                viewResource(id, title, path);
+            [this](const QString &id, const QString &title, const QString &path, int line) {
+                viewResource(id, title, path, line);
             });
 
     connect(m_browseTab, &BrowseTabWidget::contextMenuRequested, this,
@@ -82,6 +123,8 @@ void MainWindow::setupAddTab() {
     m_addTab = new AddTabWidget(this);
 
     connect(m_addTab, &AddTabWidget::addNoteRequested, this, &MainWindow::onAddNoteClicked);
+    connect(m_addTab, &AddTabWidget::importFolderRequested, this,
+            &MainWindow::onImportFolderRequested);
 
     m_tabWidget->addTab(m_addTab, QIcon(":/icons/add_tab.ico"), tr("Add Note"));
 }
@@ -114,18 +157,195 @@ void MainWindow::onSearchClicked() {
         return;
     }
 
-    std::vector<FullResource> results;
-    if (m_browseTab->titleRadio()->isChecked()) {
-        results = m_core->searchByTitleFull(keyword.toUtf8().toStdString());
+    stopRegexSearch();
+    if (m_browseTab->regexRadio()->isChecked()) {
+        startRegexSearch(keyword.toUtf8().toStdString());
+        return;
+    }
+
+    // Bảng chỉ nạp trang đầu, các trang sau được truy vấn khi cuộn tới
+    ResultsModel::PageFetcher fetcher;
+    auto paging = ResultsModel::Paging::requery;
+    NotesAppCore* core = m_core;
+    std::string term = keyword.toUtf8().toStdString();
+
+    // "tag:cpp type:text content:mutex": chạy mọi điều kiện một lần, không theo mode đang chọn
+    SearchQuery query;
+    try {
+        query = parseSearchQuery(term);
+    } catch (const std::exception &e) {
+        showError(QString::fromUtf8(e.what()));
+        return;
+    }
+
+    // Báo index được chọn (fts / fts-prefix / trigram / like-scan) trên thanh trạng thái
+    std::optional<RoutedQuery> route;
+    QString status;
+    // Kèm số kết quả theo tag/type của cả tập để người dùng biết nên lọc tiếp theo gì
+    std::optional<SearchCache::Mode> facetMode;
+
+    if (query.fielded) {
+        status = QString::fromStdString(core->searchQueryMatches(term)->plan);
+        facetMode = SearchCache::Mode::query;
+        fetcher = [core, term](std::size_t offset, std::size_t limit) {
+            return core->searchQueryPage(term, offset, limit);
+        };
+    } else if (m_browseTab->titleRadio()->isChecked()) {
+        route = core->routeTitleQuery(term);
+        facetMode = SearchCache::Mode::title;
+        fetcher = [core, term](std::size_t offset, std::size_t limit) {
+            return core->searchByTitlePage(term, offset, limit);
+        };
     } else if (m_browseTab->contentRadio()->isChecked()) {
-        results = m_core->searchByContentFull(keyword.toUtf8().toStdString());
+        route = core->routeContentQuery(term);
+        facetMode = SearchCache::Mode::content;
+        // Hit xếp hạng trên toàn bộ nội dung: tìm một lần (cache), các trang chỉ đọc resource
+        fetcher = [core, term](std::size_t offset, std::size_t limit) {
+            return core->searchContentPage(term, offset, limit);
+        };
+    } else if (m_browseTab->fuzzyRadio()->isChecked()) {
+        // Mở rộng từ khóa một lần; status bar cho thấy các term đã thử
+        route = core->routeFuzzyContentQuery(term);
+        auto hits = std::make_shared<const std::vector<ContentHit>>(
+            core->searchContentHits(*route));
+        fetcher = [core, hits](std::size_t offset, std::size_t limit) {
+            return core->contentHitPage(*hits, offset, limit);
+        };
+        paging = ResultsModel::Paging::snapshot;
     } else if (m_browseTab->tagRadio()->isChecked()) {
-        results = m_core->getFullResourcesByTag(keyword.toUtf8().toStdString());
+        facetMode = SearchCache::Mode::tag;
+        fetcher = [core, term](std::size_t offset, std::size_t limit) {
+            return core->getTagPage(term, offset, limit);
+        };
+    } else if (m_browseTab->symbolRadio()->isChecked()) {
+        // Mỗi định nghĩa một dòng, mở viewer tại dòng định nghĩa
+        auto hits = std::make_shared<const std::vector<ContentHit>>(core->findDefinitions(term));
+        fetcher = [core, hits](std::size_t offset, std::size_t limit) {
+            return core->contentHitPage(*hits, offset, limit);
+        };
+        paging = ResultsModel::Paging::snapshot;
+    }
+    if (!fetcher) { return; }
+
+    if (route) { status = QString::fromStdString(route->describe()); }
+    if (facetMode) {
+        const QString facets = facetSummary(core->searchFacets(*facetMode, term));
+        status = status.isEmpty() ? facets : status + " | " + facets;
+    }
+    if (!status.isEmpty()) { statusBar()->showMessage(status, NOTI_TIMEOUT); }
+
+    // Kết quả cũ (các trang arena) được giải phóng khi thay nguồn
+    m_browseTab->displayResults(std::move(fetcher), paging);
+
+    m_browseTab->updateColumnWidths();
+}
+
+void MainWindow::startRegexSearch(const std::string &pattern) {
+    try {
+        m_regexSearch = m_core->createRegexSearch(pattern);
+    } catch (const std::exception &e) {
+        showError(QString::fromUtf8(e.what()));
+        return;
+    }
+
+    m_regexHits = 0;
+    m_browseTab->displayResults({});
+    statusBar()->showMessage(QString::fromStdString(m_regexSearch->describe()));
+    m_regexTimer->start();
+}
+
+void MainWindow::stopRegexSearch() {
+    m_regexTimer->stop();
+    m_regexSearch.reset(); // hủy và join worker
+}
+
+void MainWindow::onRegexPoll() {
+    if (m_regexSearch == nullptr) {
+        m_regexTimer->stop();
+        return;
+    }
+
+    // poll() cũng nạp note cho worker nên phải chạy trên thread sở hữu connection
+    std::vector<RegexMatch> matches;
+    const bool running = m_regexSearch->poll(matches, REGEX_POLL_SLICE);
+
+    if (!matches.empty()) {
+        // Mỗi dòng khớp một hàng, mở viewer tại dòng đó
+        std::vector<ContentHit> hits;
+        hits.reserve(matches.size());
+        for (auto &match : matches) {
+            hits.push_back({.resource_id = match.resource_id,
+                            .snippet = std::move(match.text),
+                            .byte_offset = static_cast<std::int64_t>(match.byte_offset),
+                            .line = match.line});
+        }
+
+        try {
+            auto page = m_core->contentHitPage(hits, 0, hits.size());
+            const bool first = m_regexHits == 0;
+            m_regexHits += page.result.size();
+            m_browseTab->resultsModel()->appendResults(std::move(page.result));
+            if (first) { m_browseTab->updateColumnWidths(); }
+        } catch (const std::exception &e) {
+            qWarning() << "Load regex results failed:" << e.what();
+        }
+    }
+
+    if (running) { return; }
+
+    const QString reason = [status = m_regexSearch->status()]() -> QString {
+        switch (status) {
+            case RegexSearchStatus::cancelled:
+                return tr("cancelled");
+            case RegexSearchStatus::timedOut:
+                return tr("time limit reached");
+            case RegexSearchStatus::truncated:
+                return tr("result limit reached");
+            default:
+                return tr("done");
+        }
+    }();
+    statusBar()->showMessage(tr("Regex: %1 matches (%2)").arg(m_regexHits).arg(reason),
+                             NOTI_TIMEOUT);
+    stopRegexSearch();
+}
+
+void MainWindow::onLiveSearch(const QString &keyword) {
+    if (m_core == nullptr) { return; }
+
+    // Xóa hết từ khóa khi đang gõ: dọn bảng, không hiện thông báo như nút Search
+    if (keyword.trimmed().isEmpty()) {
+        m_core->resetLiveSearch();
+        m_browseTab->resultsModel()->clear();
+        return;
+    }
+
+    LiveSearch::Result live;
+    try {
+        live = m_core->liveSearchTitle(keyword.toUtf8().toStdString());
+    } catch (const std::exception &e) {
+        // Đang gõ dở: giữ kết quả cũ, lần gõ sau sẽ thử lại
+        qWarning() << "Live search failed:" << e.what();
+        return;
     }
-    if (results.empty()) { return; }
 
-    m_browseTab->displayResults(results);
+    ResultsModel::PageFetcher fetcher;
+    auto paging = ResultsModel::Paging::requery;
+    NotesAppCore* core = m_core;
+    if (live.complete) {
+        auto ids = std::make_shared<const std::vector<sqlite3_int64>>(std::move(live.ids));
+        fetcher = [core, ids](std::size_t offset, std::size_t limit) {
+            return core->idPage(*ids, offset, limit);
+        };
+        paging = ResultsModel::Paging::snapshot;
+    } else {
+        // Quá nhiều kết quả để giữ trọn: phân trang thẳng trên truy vấn prefix
+        fetcher = [core, query = std::move(live.query)](std::size_t offset, std::size_t limit) {
+            return core->searchByTitlePage(query, offset, limit);
+        };
+    }
 
+    m_browseTab->displayResults(std::move(fetcher), paging);
     m_browseTab->updateColumnWidths();
 }
 
@@ -200,8 +420,19 @@ void MainWindow::onAddNoteClicked() {
     }
 
     if (m_addTab->fileRadio()->isChecked()) {
-        auto resId = m_core->addFileNote(pathStr, titleStd, type,
-                                         m_appController->settings()->isManagedResources());
+        const bool isManaged = m_appController->settings()->isManagedResources();
+        auto resId = m_core->addFileNote(pathStr, titleStd, type, isManaged);
+
+        // File linked mới -> đưa vào danh sách theo dõi
+        if (auto* monitor = m_appController->fileMonitor(); !isManaged && monitor != nullptr) {
+            monitor->refresh();
+        }
+        if (auto* scheduler = m_appController->indexScheduler(); scheduler != nullptr) {
+            scheduler->schedule();
+        }
+        if (auto* pdfPool = m_appController->pdfPool(); pdfPool != nullptr) {
+            pdfPool->schedule();
+        }
 
         std::vector<std::string> tagNames;
         auto tags = m_addTab->tagInput()->getAllTags();
@@ -221,6 +452,51 @@ void MainWindow::onAddNoteClicked() {
     }
 }
 
+void MainWindow::onImportFolderRequested(const QString &directory) {
+    if (m_core == nullptr) {
+        showError(tr("Database not initialized."));
+        return;
+    }
+
+    // Dialog modal: UI không ghi DB trong lúc pipeline dùng connection
+    auto* dialog = new ImportDialog(directory, this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+
+    // Watcher file linked cũng ghi DB trên GUI thread -> tạm dừng đến khi đóng dialog
+    if (auto* monitor = m_appController->fileMonitor(); monitor != nullptr) {
+        monitor->suspend();
+        connect(dialog, &QObject::destroyed, monitor, &LinkedFileMonitor::resume);
+    }
+    if (auto* scheduler = m_appController->indexScheduler(); scheduler != nullptr) {
+        scheduler->suspend();
+        connect(dialog, &QObject::destroyed, scheduler, &ContentIndexScheduler::resume);
+    }
+    if (auto* pdfPool = m_appController->pdfPool(); pdfPool != nullptr) {
+        pdfPool->suspend();
+        connect(dialog, &QObject::destroyed, pdfPool, &PdfExtractionPool::resume);
+    }
+    if (auto* compactor = m_appController->revisionCompactor(); compactor != nullptr) {
+        compactor->suspend();
+        connect(dialog, &QObject::destroyed, compactor, &RevisionCompactor::resume);
+    }
+
+    // Worker là con của dialog: đóng dialog => hủy + join pipeline
+    auto* worker = new ImportWorker(*m_core, dialog);
+
+    connect(worker, &ImportWorker::progressChanged, dialog, &ImportDialog::updateProgress);
+    connect(dialog, &ImportDialog::pauseRequested, worker, &ImportWorker::pause);
+    connect(dialog, &ImportDialog::resumeRequested, worker, &ImportWorker::resume);
+    connect(dialog, &ImportDialog::cancelRequested, worker, &ImportWorker::cancel);
+    connect(worker, &ImportWorker::finished, this, [this](const ImportProgress &progress) {
+        if (progress.written.items > 0) {
+            showInfo(tr("Imported %1 file(s).").arg(progress.written.items));
+        }
+    });
+
+    worker->start(directory, m_appController->settings()->isManagedResources());
+    dialog->open();
+}
+
 void MainWindow::onApplyButtonSettingsClicked() {
     if (m_core == nullptr) {
         QMessageBox::critical(this, tr("Error"), tr("Core is not initialized."));
@@ -261,6 +537,9 @@ void MainWindow::onApplyButtonSettingsClicked() {
         settingsPtr->setManagedResources(isMan);
     }
 
+    settingsPtr->setCompressNotes(m_settingsTab->compressNotesCheck()->isChecked());
+    settingsPtr->setSubstringIndex(m_settingsTab->substringIndexCheck()->isChecked());
+
     if (settingsPtr->isDirty()) {
         m_appController->saveSettings();
 
@@ -348,7 +627,10 @@ void MainWindow::closeEvent(QCloseEvent* event) {
 // Core injection & helpers
 // ===================================================
 void MainWindow::setCore(NotesAppCore* core) {
+    stopRegexSearch();
     m_core = core;
+    // Fetcher của bảng kết quả giữ con trỏ tới core cũ
+    m_browseTab->resultsModel()->clear();
     // showInfo(tr("Database initialized successfully."));
 
     m_tabWidget->setTabEnabled(m_tabWidget->indexOf(m_addTab), true);
@@ -396,7 +678,8 @@ void MainWindow::pickupFolder() {
 }
 
 // NOLINTNEXTLINE
-void MainWindow::viewResource(const QString &id, const QString &title, const QString &path) {
+void MainWindow::viewResource(const QString &id, const QString &title, const QString &path,
+                              int line) {
     auto* dialog = new QDialog(this);
     dialog->setAttribute(Qt::WA_DeleteOnClose); // Tự giải phóng khi đóng
     dialog->setWindowTitle(QString("Chi tiết tài liệu: %1").arg(title));
@@ -446,11 +729,21 @@ void MainWindow::viewResource(const QString &id, const QString &title, const QSt
         }
     }
 
+    if (line > 0) {
+        const QTextBlock block = viewSourceTextEdit->document()->findBlockByNumber(line - 1);
+        if (block.isValid()) {
+            QTextCursor cursor(block);
+            cursor.select(QTextCursor::LineUnderCursor);
+            viewSourceTextEdit->setTextCursor(cursor);
+        }
+    }
+
     dialog->show();
+    if (line > 0) { viewSourceTextEdit->ensureCursorVisible(); }
 
     QTimer::singleShot(0, this, [this]() {
         m_browseTab->resultsTable()->clearSelection();
-        m_browseTab->resultsTable()->setCurrentItem(nullptr);
+        m_browseTab->resultsTable()->setCurrentIndex(QModelIndex());
         m_browseTab->resultsTable()->clearFocus();
     });
 }
@@ -498,18 +791,21 @@ void MainWindow::showContextMenu(const QPoint &pos, int row, const QString &id,
         QVector<sqlite3_int64> idsToDelete;
         idsToDelete.reserve(selectedRows.size());
 
+        auto* model = m_browseTab->resultsModel();
         for (const QModelIndex &idx : selectedRows) {
-            const QString id = resultsTbl->item(idx.row(), 0)->text();
-            bool ok = false;
-            const sqlite3_int64 resId = id.toLongLong(&ok);
-            if (ok) { idsToDelete.append(resId); }
-        }
-
-        for (const auto &selectedRow : std::ranges::reverse_view(selectedRows)) {
-            resultsTbl->removeRow(selectedRow.row());
+            if (const auto res = model->entry(idx.row())) { idsToDelete.append(res->id); }
         }
 
+        // Xóa khỏi DB trước: với nguồn chạy lại truy vấn removeRows lùi offset phân trang,
+        // fetchMore chen giữa phải thấy DB đã bớt các dòng này
         for (sqlite3_int64 id : idsToDelete) { m_core->deleteResource(id); }
+
+        // selectedRows không theo thứ tự: xóa từ dòng dưới lên để chỉ số còn đúng
+        QList<int> rows;
+        rows.reserve(selectedRows.size());
+        for (const QModelIndex &idx : selectedRows) { rows.append(idx.row()); }
+        std::ranges::sort(rows, std::greater<>());
+        for (const int row : rows) { model->removeRows(row, 1); }
     });
 
     menu.exec(resultsTbl->viewport()->mapToGlobal(
@@ -542,6 +838,12 @@ void MainWindow::applySettingsToUi(const AppSettings* settings) {
     } else {
         m_settingsTab->resourceManagementCombo()->setCurrentIndex(1); // "Save path only"
     }
+
+    // Nén nội dung note
+    m_settingsTab->compressNotesCheck()->setChecked(settings->compressNotes());
+
+    // Index trigram cho tìm chuỗi con trong nội dung
+    m_settingsTab->substringIndexCheck()->setChecked(settings->substringIndex());
 }
 
 void MainWindow::setAppController(AppController* controller) {
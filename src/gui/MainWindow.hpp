@@ -1,7 +1,10 @@
 #pragma once
 
 #include <QMainWindow>
+#include <cstddef>
 #include <cstdint>
+#include <memory>
+#include <string>
 #include "AppSettings.hpp"
 
 // ----------------------------------------------------
@@ -25,6 +28,8 @@ class AddTabWidget;
 class SettingsTabWidget;
 class CodeEditorLineHighlighter;
 class AppController;
+class QTimer;
+class RegexSearch;
 
 // ----------------------------------------------------
 
@@ -36,7 +41,7 @@ class MainWindow : public QMainWindow {
 
     public:
         explicit MainWindow(QWidget* parent = nullptr);
-        ~MainWindow() override = default;
+        ~MainWindow() override; // RegexSearch chỉ được khai báo trước
 
         void setAppController(AppController* controller);
 
@@ -65,10 +70,13 @@ class MainWindow : public QMainWindow {
 
     private slots:
         void onSearchClicked();
+        void onLiveSearch(const QString &keyword);
+        void onRegexPoll();
         void onAddNoteClicked();
         void onApplyButtonSettingsClicked();
         void onDefaultButtonSettingsClicked();
         void pickupFolder();
+        void onImportFolderRequested(const QString &directory);
 
     private: // NOLINT(readability-redundant-access-specifiers)
         NotesAppCore* m_core{};
@@ -81,6 +89,9 @@ class MainWindow : public QMainWindow {
         SettingsTabWidget* m_settingsTab{};
 
         // Browse Tab
+        std::unique_ptr<RegexSearch> m_regexSearch; // lượt tìm regex đang chạy
+        QTimer* m_regexTimer{};
+        std::size_t m_regexHits{};
 
         // Add Tab
         CppHighlighter* m_cppHighlighter{};
@@ -96,7 +107,13 @@ class MainWindow : public QMainWindow {
 
         void onTextRadioToggled(bool checked);
 
-        void viewResource(const QString &id, const QString &title, const QString &path);
+        // Kết quả regex hiện dần qua m_regexTimer; lượt cũ bị hủy khi tìm lại hoặc đổi DB
+        void startRegexSearch(const std::string &pattern);
+        void stopRegexSearch();
+
+        // line > 0: cuộn tới dòng đó (chỗ khớp khi tìm theo nội dung)
+        void viewResource(const QString &id, const QString &title, const QString &path,
+                          int line = 0);
 
         void showContextMenu(const QPoint &pos, int row, const QString &id, const QString &title,
                              const QString &path);
@@ -92,9 +92,14 @@ void AddTabWidget::setupUi() {
     m_clearBtn->setMinimumWidth(BUTTON_WIDTH);
     m_clearBtn->setIcon(QIcon(":/icons/clear.ico"));
 
+    // Import cả thư mục (chạy nền, có dialog tiến độ)
+    m_importBtn = new QPushButton(tr("Import folder..."));
+    m_importBtn->setMinimumWidth(BUTTON_WIDTH);
+
     buttonLayout->addStretch(1);
     buttonLayout->addWidget(m_addBtn);
     buttonLayout->addWidget(m_clearBtn);
+    buttonLayout->addWidget(m_importBtn);
     buttonLayout->addStretch(1);
     buttonLayout->setSpacing(10); // NOLINT(readability-magic-numbers)
 
@@ -127,6 +132,7 @@ void AddTabWidget::setupConnections() {
     connect(m_filepathInp, &QLineEdit::textChanged, this, &AddTabWidget::updateAddAndClearButtons);
 
     connect(m_browseBtn, &QPushButton::clicked, this, &AddTabWidget::onBrowseFile);
+    connect(m_importBtn, &QPushButton::clicked, this, &AddTabWidget::onImportFolderClicked);
     // connect(m_browseButton, &QPushButton::clicked, [this] { pickupFile(); });
 }
 
@@ -173,6 +179,13 @@ void AddTabWidget::onBrowseFile() {
     if (!filePath.isEmpty()) { m_filepathInp->setText(QDir::toNativeSeparators(filePath)); }
 }
 
+void AddTabWidget::onImportFolderClicked() {
+    const QString dirPath =
+        QFileDialog::getExistingDirectory(this, tr("Select Folder to Import"), QDir::homePath());
+
+    if (!dirPath.isEmpty()) { emit importFolderRequested(QDir::toNativeSeparators(dirPath)); }
+}
+
 // Logic enable/disable when m_titleInp, m_textEdt, m_filepathInp has content
 void AddTabWidget::updateAddAndClearButtons() {
     const bool isTextMode = m_textRad->isChecked();
@@ -202,6 +215,7 @@ void AddTabWidget::retranslateUi() {
 
     m_addBtn->setText(tr("Add"));
     m_clearBtn->setText(tr("Clear"));
+    m_importBtn->setText(tr("Import folder..."));
 }
 
 int AddTabWidget::editorWidth() const noexcept {
@@ -32,12 +32,14 @@ class AddTabWidget final : public QWidget {
     signals:
         void addNoteRequested(QString title, QString textContent, QString filePath,
                               QStringList tags, bool isTextMode);
+        void importFolderRequested(QString directory);
 
     private slots:
         void onAddButtonClicked();
         void onClearButtonClicked();
         void onTextRadioToggled(bool checked);
         void onBrowseFile();
+        void onImportFolderClicked();
         void updateAddAndClearButtons();
 
     private: // NOLINT(readability-redundant-access-specifiers)
@@ -57,6 +59,7 @@ class AddTabWidget final : public QWidget {
         QPushButton* m_addBtn{};
         QPushButton* m_browseBtn{};
         QPushButton* m_clearBtn{};
+        QPushButton* m_importBtn{};
         TagInput* m_tagInp{};
 
         int m_EditorWidth{};
@@ -1,7 +1,14 @@
+#include <QTimer>
 #include "BrowseTabWidget.hpp"
+#include "ResultsModel.hpp"
 #include "ResultsTable.hpp"
 #include "model.hpp"
 
+namespace {
+    // Gõ liên tục chỉ chạy một truy vấn, sau khi dừng gõ chừng này ms
+    constexpr int LIVE_SEARCH_DELAY_MS{150};
+} // namespace
+
 BrowseTabWidget::BrowseTabWidget(QWidget* parent) : QWidget(parent) {
     setupUI();
     setupConnections();
@@ -13,6 +20,7 @@ void BrowseTabWidget::setupUI() {
     auto* searchLayout = new QHBoxLayout();
     m_searchInp = new QLineEdit();
     m_searchInp->setPlaceholderText(tr("Enter keyword..."));
+    m_searchInp->setToolTip(tr("Combine filters in any mode: tag:cpp type:text content:mutex"));
 
     m_searchBtn = new QPushButton(tr("Search"));
     m_searchBtn->setIcon(QIcon(":/icons/search_button.ico"));
@@ -30,28 +38,43 @@ void BrowseTabWidget::setupUI() {
     m_titleRad = new QRadioButton(tr("Title"));
     m_contentRad = new QRadioButton(tr("Content"));
     m_tagRad = new QRadioButton("Tag");
+    m_symbolRad = new QRadioButton(tr("Definition"));
+    m_regexRad = new QRadioButton(tr("Regex"));
+    m_fuzzyRad = new QRadioButton(tr("Fuzzy"));
     m_titleRad->setChecked(true);
 
     auto* searchByGroup = new QButtonGroup(this);
     searchByGroup->addButton(m_titleRad);
     searchByGroup->addButton(m_contentRad);
+    searchByGroup->addButton(m_fuzzyRad);
     searchByGroup->addButton(m_tagRad);
+    searchByGroup->addButton(m_symbolRad);
+    searchByGroup->addButton(m_regexRad);
 
     filterLayout->addWidget(m_searchByLbl);
     filterLayout->addWidget(m_titleRad);
     filterLayout->addWidget(m_contentRad);
+    filterLayout->addWidget(m_fuzzyRad);
     filterLayout->addWidget(m_tagRad);
+    filterLayout->addWidget(m_symbolRad);
+    filterLayout->addWidget(m_regexRad);
 
+    m_resultsModel = new ResultsModel(this);
     m_resultsTbl = new ResultsTable(this);
+    m_resultsTbl->setModel(m_resultsModel);
     m_resultsTbl->setContextMenuPolicy(Qt::CustomContextMenu);
-    m_resultsTbl->setColumnCount(3);
-    m_resultsTbl->setHorizontalHeaderLabels({tr("ID"), tr("Title"), tr("Path")});
     m_resultsTbl->horizontalHeader()->setStretchLastSection(true);
     m_resultsTbl->verticalHeader()->setVisible(false);
     m_resultsTbl->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Fixed);
     m_resultsTbl->setColumnWidth(0, 50); // NOLINT(readability-magic-numbers)
     m_resultsTbl->setSelectionBehavior(QAbstractItemView::SelectRows);
     m_resultsTbl->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    // Chiều cao dòng cố định: view không phải đo từng dòng khi có hàng chục nghìn kết quả
+    m_resultsTbl->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+
+    m_liveTimer = new QTimer(this);
+    m_liveTimer->setSingleShot(true);
+    m_liveTimer->setInterval(LIVE_SEARCH_DELAY_MS);
 
     mainLayout->addLayout(searchLayout);
     mainLayout->addWidget(filterContainer, 0, Qt::AlignHCenter);
@@ -60,10 +83,15 @@ void BrowseTabWidget::setupUI() {
 
 void BrowseTabWidget::setupConnections() {
     connect(m_searchBtn, &QPushButton::clicked, this, [this]() {
+        m_liveTimer->stop();
+
         // IIFE: Biểu thức lambda được định nghĩa và gọi ngay lập tức ()
         const QString mode = [this]() -> QString {
             if (m_titleRad->isChecked()) { return "title"; }
             if (m_contentRad->isChecked()) { return "content"; }
+            if (m_symbolRad->isChecked()) { return "symbol"; }
+            if (m_regexRad->isChecked()) { return "regex"; }
+            if (m_fuzzyRad->isChecked()) { return "fuzzy"; }
             // Luôn phải có return cuối cùng cho các trường hợp còn lại
             return "tag";
         }(); // Dấu ngoặc () ở cuối để gọi lambda ngay lập tức
@@ -73,7 +101,15 @@ void BrowseTabWidget::setupConnections() {
 
     connect(m_searchInp, &QLineEdit::returnPressed, m_searchBtn, &QPushButton::click);
 
-    connect(m_resultsTbl, &QTableWidget::cellDoubleClicked, this,
+    // Chỉ tìm theo title khi đang gõ; nội dung/tag vẫn chờ Enter hoặc nút Search.
+    // Mỗi phím khởi động lại timer nên phím cũ không bao giờ chạy truy vấn
+    connect(m_searchInp, &QLineEdit::textChanged, this, [this]() {
+        if (m_titleRad->isChecked()) { m_liveTimer->start(); }
+    });
+    connect(m_liveTimer, &QTimer::timeout, this,
+            [this]() { emit liveSearchRequested(m_searchInp->text()); });
+
+    connect(m_resultsTbl, &QAbstractItemView::doubleClicked, this,
             &BrowseTabWidget::onCellDoubleClicked);
 
     connect(m_resultsTbl, &QWidget::customContextMenuRequested, this,
@@ -83,11 +119,15 @@ void BrowseTabWidget::setupConnections() {
 void BrowseTabWidget::retranslateUi() {
     m_searchBtn->setText(tr("Search"));
     m_searchInp->setPlaceholderText(tr("Enter keyword..."));
+    m_searchInp->setToolTip(tr("Combine filters in any mode: tag:cpp type:text content:mutex"));
     m_searchByLbl->setText(tr("Search by: "));
     m_titleRad->setText(tr("Title"));
     m_contentRad->setText(tr("Content"));
+    m_symbolRad->setText(tr("Definition"));
+    m_regexRad->setText(tr("Regex"));
+    m_fuzzyRad->setText(tr("Fuzzy"));
 
-    m_resultsTbl->setHorizontalHeaderLabels({tr("ID"), tr("Title"), tr("Path")});
+    m_resultsModel->retranslate();
 }
 
 QString BrowseTabWidget::searchKeyword() const noexcept {
@@ -106,10 +146,26 @@ QRadioButton* BrowseTabWidget::tagRadio() const noexcept {
     return m_tagRad;
 }
 
+QRadioButton* BrowseTabWidget::symbolRadio() const noexcept {
+    return m_symbolRad;
+}
+
+QRadioButton* BrowseTabWidget::regexRadio() const noexcept {
+    return m_regexRad;
+}
+
+QRadioButton* BrowseTabWidget::fuzzyRadio() const noexcept {
+    return m_fuzzyRad;
+}
+
 ResultsTable* BrowseTabWidget::resultsTable() const noexcept {
     return m_resultsTbl;
 }
 
+ResultsModel* BrowseTabWidget::resultsModel() const noexcept {
+    return m_resultsModel;
+}
+
 void BrowseTabWidget::updateColumnWidths() {
     if (m_resultsTbl == nullptr) { return; }
 
@@ -123,38 +179,22 @@ void BrowseTabWidget::updateColumnWidths() {
 
 // signals custom
 // NOLINTNEXTLINE
-void BrowseTabWidget::onCellDoubleClicked(int row) {
-    auto rowDataOpt = rowData(row);
+void BrowseTabWidget::onCellDoubleClicked(const QModelIndex &index) {
+    auto rowDataOpt = rowData(index.row());
     if (!rowDataOpt.has_value()) {
-        qWarning() << "Invalid row" << row;
+        qWarning() << "Invalid row" << index.row();
         return;
     }
 
     const auto &data = *rowDataOpt;
 
-    emit resourceDoubleClicked(data.id, data.title, data.path);
+    emit resourceDoubleClicked(data.id, data.title, data.path, data.line);
 }
 
-void BrowseTabWidget::displayResults(const std::vector<FullResource> &results) {
-    m_resultsTbl->setRowCount(0); // Dọn dẹp (clear) hoặc chuẩn bị lại bảng kết quả
-
-    for (const auto &res : results) {
-        const int row = m_resultsTbl->rowCount();
-        m_resultsTbl->insertRow(row);
-
-        auto* idItem = new QTableWidgetItem(QString::number(res.resource.id));
-        idItem->setTextAlignment(Qt::AlignCenter);
-        idItem->setFlags(idItem->flags() & ~Qt::ItemIsEditable);
-        m_resultsTbl->setItem(row, 0, idItem);
-
-        m_resultsTbl->setItem(row, 1,
-                              new QTableWidgetItem(QString::fromStdString(res.resource.title)));
-
-        if (res.filepath.has_value()) {
-            m_resultsTbl->setItem(row, 2,
-                                  new QTableWidgetItem(QString::fromStdString(*res.filepath)));
-        }
-    }
+void BrowseTabWidget::displayResults(ResultsModel::PageFetcher fetcher,
+                                     ResultsModel::Paging paging) {
+    m_resultsModel->setSource(std::move(fetcher), paging);
+    m_resultsTbl->scrollToTop();
 }
 
 void BrowseTabWidget::onCustomContextMenuRequested(const QPoint &pos) {
@@ -163,33 +203,28 @@ void BrowseTabWidget::onCustomContextMenuRequested(const QPoint &pos) {
 
     const int row = index.row();
 
-    auto* idItem = m_resultsTbl->item(row, 0);
-    auto* titleItem = m_resultsTbl->item(row, 1);
-    auto* pathItem = m_resultsTbl->item(row, 2);
-
-    if ((idItem == nullptr) || (titleItem == nullptr)) {
+    auto rowDataOpt = rowData(row);
+    if (!rowDataOpt.has_value()) {
         return; // Tránh dereference null pointer
     }
 
-    const QString &id = idItem->text();
-    const QString &title = titleItem->text();
-    const QString &path = (pathItem != nullptr) ? pathItem->text() : QString();
-
-    emit contextMenuRequested(pos, row, id, title, path);
+    emit contextMenuRequested(pos, row, rowDataOpt->id, rowDataOpt->title, rowDataOpt->path);
 }
 
 std::optional<BrowseTabWidget::RowData> BrowseTabWidget::rowData(int row) const {
-    if (row < 0 || row >= m_resultsTbl->rowCount()) { return std::nullopt; }
-
-    auto* idItem = m_resultsTbl->item(row, 0);
-    auto* titleItem = m_resultsTbl->item(row, 1);
-    auto* pathItem = m_resultsTbl->item(row, 2);
-
-    if ((idItem == nullptr) || (titleItem == nullptr)) { return std::nullopt; }
-
-    RowData r{.id = idItem->text(),
-              .title = titleItem->text(),
-              .path = (pathItem != nullptr) ? pathItem->text() : QString()};
+    const auto res = m_resultsModel->entry(row);
+    if (!res.has_value()) { return std::nullopt; }
+
+    RowData r{.id = QString::number(res->id),
+              .title = QString::fromUtf8(res->title.data(),
+                                         static_cast<qsizetype>(res->title.size())),
+              .path = res->path.has_value()
+                          ? QString::fromUtf8(res->path->data(),
+                                              static_cast<qsizetype>(res->path->size()))
+                          : QString(),
+              .line = m_resultsModel->index(row, ResultsModel::IdColumn)
+                          .data(ResultsModel::LINE_ROLE)
+                          .toInt()};
 
     return r;
 }
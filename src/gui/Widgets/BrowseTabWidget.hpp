@@ -3,6 +3,7 @@
 #include <QWidget>
 #include <optional>
 #include <vector>
+#include "ResultsModel.hpp"
 #include "model.hpp" // std::vector bắt buộc phải biết định nghĩa đầy đủ (tức là kích thước và cấu trúc) của kiểu dữ liệu mà nó chứa (FullResource) ngay tại thời điểm mẫu lớp std::vector được khởi tạo (instantiate) hoặc khai báo
 
 class QWidget;
@@ -10,6 +11,7 @@ class QLineEdit;
 class QPushButton;
 class QLabel;
 class QRadioButton;
+class QTimer;
 class ResultsTable;
 
 class BrowseTabWidget final : public QWidget {
@@ -20,7 +22,9 @@ class BrowseTabWidget final : public QWidget {
         ~BrowseTabWidget() override = default;
 
         void retranslateUi();
-        void displayResults(const std::vector<FullResource> &results);
+        // Bảng nạp dần từng trang của fetcher; kết quả cũ được giải phóng khi thay nguồn
+        void displayResults(ResultsModel::PageFetcher fetcher,
+                            ResultsModel::Paging paging = ResultsModel::Paging::requery);
         void updateColumnWidths();
 
         // Getter
@@ -28,24 +32,36 @@ class BrowseTabWidget final : public QWidget {
         [[nodiscard]] QRadioButton* titleRadio() const noexcept;
         [[nodiscard]] QRadioButton* contentRadio() const noexcept;
         [[nodiscard]] QRadioButton* tagRadio() const noexcept;
+        // Tìm nơi định nghĩa class/hàm/macro trong file cpp đã index (bảng symbols)
+        [[nodiscard]] QRadioButton* symbolRadio() const noexcept;
+        // Regex theo dòng trên note và file cpp/txt, kết quả hiện dần
+        [[nodiscard]] QRadioButton* regexRadio() const noexcept;
+        // Như Content nhưng chấp nhận từ khóa gõ sai (mở rộng tới term gần nhất trong index)
+        [[nodiscard]] QRadioButton* fuzzyRadio() const noexcept;
         [[nodiscard]] ResultsTable* resultsTable() const noexcept;
+        [[nodiscard]] ResultsModel* resultsModel() const noexcept;
 
     signals:
         void searchRequested(const QString &keyword, const QString &mode);
-        void resourceDoubleClicked(const QString &id, const QString &title, const QString &path);
+        // Tìm theo title khi đang gõ, phát khi người dùng ngừng gõ một lúc (debounce)
+        void liveSearchRequested(const QString &keyword);
+        // line: dòng chứa chỗ khớp khi tìm theo nội dung, 0 nếu không có
+        void resourceDoubleClicked(const QString &id, const QString &title, const QString &path,
+                                   int line);
         void contextMenuRequested(const QPoint &pos, int row, const QString &id,
                                   const QString &title, const QString &path);
 
     private:
         void setupUI();
         void setupConnections();
-        void onCellDoubleClicked(int row);
+        void onCellDoubleClicked(const QModelIndex &index);
         void onCustomContextMenuRequested(const QPoint &pos);
 
         struct RowData {
                 QString id;
                 QString title;
                 QString path;
+                int line{};
         };
 
         [[nodiscard]] std::optional<RowData> rowData(int row) const;
@@ -56,5 +72,10 @@ class BrowseTabWidget final : public QWidget {
         QRadioButton* m_titleRad{};
         QRadioButton* m_contentRad{};
         QRadioButton* m_tagRad{};
+        QRadioButton* m_symbolRad{};
+        QRadioButton* m_regexRad{};
+        QRadioButton* m_fuzzyRad{};
         ResultsTable* m_resultsTbl{};
+        ResultsModel* m_resultsModel{};
+        QTimer* m_liveTimer{};
 };
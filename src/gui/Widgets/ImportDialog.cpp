@@ -0,0 +1,128 @@
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QLocale>
+#include <QProgressBar>
+#include <QPushButton>
+#include "ImportDialog.hpp"
+#include "import_pipeline.hpp"
+
+namespace {
+    constexpr int DIALOG_WIDTH{480};
+    constexpr int BUTTON_WIDTH{100};
+} // namespace
+
+ImportDialog::ImportDialog(const QString &directory, QWidget* parent) : QDialog(parent) {
+    setWindowTitle(tr("Import Folder"));
+    setModal(true);
+    setMinimumWidth(DIALOG_WIDTH);
+
+    setupUi(directory);
+}
+
+void ImportDialog::setupUi(const QString &directory) {
+    auto* mainLayout = new QVBoxLayout(this);
+
+    m_dirLbl = new QLabel(directory);
+    m_dirLbl->setWordWrap(true);
+
+    m_statusLbl = new QLabel(tr("Scanning..."));
+    m_detailLbl = new QLabel();
+    m_detailLbl->setWordWrap(true);
+
+    m_progressBar = new QProgressBar();
+    m_progressBar->setRange(0, 0); // chưa biết tổng số file -> busy indicator
+
+    auto* buttonLayout = new QHBoxLayout();
+    m_pauseBtn = new QPushButton(tr("Pause"));
+    m_pauseBtn->setMinimumWidth(BUTTON_WIDTH);
+    m_cancelBtn = new QPushButton(tr("Cancel"));
+    m_cancelBtn->setMinimumWidth(BUTTON_WIDTH);
+
+    buttonLayout->addStretch(1);
+    buttonLayout->addWidget(m_pauseBtn);
+    buttonLayout->addWidget(m_cancelBtn);
+
+    mainLayout->addWidget(m_dirLbl);
+    mainLayout->addWidget(m_progressBar);
+    mainLayout->addWidget(m_statusLbl);
+    mainLayout->addWidget(m_detailLbl);
+    mainLayout->addLayout(buttonLayout);
+
+    connect(m_pauseBtn, &QPushButton::clicked, this, &ImportDialog::onPauseClicked);
+    connect(m_cancelBtn, &QPushButton::clicked, this, &ImportDialog::reject);
+}
+
+void ImportDialog::updateProgress(const ImportProgress &progress) {
+    const QLocale locale;
+
+    // Tổng số file chỉ biết chắc khi đã duyệt xong thư mục
+    if (progress.scanFinished && progress.scanned.items > 0) {
+        const auto done = progress.written.items + progress.duplicates + progress.failed;
+        m_progressBar->setRange(0, 100); // NOLINT(readability-magic-numbers)
+        m_progressBar->setValue(static_cast<int>(done * 100 / progress.scanned.items));
+    }
+
+    QString status;
+    if (progress.finished) {
+        status = progress.cancelled ? tr("Import cancelled.") : tr("Import finished.");
+    } else if (progress.paused) {
+        status = tr("Paused.");
+    } else if (progress.eta.has_value()) {
+        status = tr("Importing... about %1 s left").arg(progress.eta->count());
+    } else {
+        status = tr("Importing...");
+    }
+    m_statusLbl->setText(status);
+
+    QString detail = tr("Found: %1 | Hashed: %2 (%3/s) | Added: %4 | Duplicates: %5 | "
+                        "Skipped: %6 | Failed: %7")
+                         .arg(progress.scanned.items)
+                         .arg(progress.hashed.items)
+                         .arg(locale.formattedDataSize(
+                             static_cast<qint64>(progress.hashed.bytesPerSec)))
+                         .arg(progress.written.items)
+                         .arg(progress.duplicates)
+                         .arg(progress.skipped)
+                         .arg(progress.failed);
+
+    if (!progress.lastError.empty()) {
+        detail += "\n" + tr("Last error: %1").arg(QString::fromStdString(progress.lastError));
+    }
+    m_detailLbl->setText(detail);
+
+    if (progress.finished) {
+        m_finished = true;
+        if (!progress.scanFinished || progress.scanned.items == 0) {
+            m_progressBar->setRange(0, 1);
+            m_progressBar->setValue(1);
+        }
+        m_pauseBtn->setEnabled(false);
+        m_cancelBtn->setEnabled(true);
+        m_cancelBtn->setText(tr("Close"));
+    }
+}
+
+void ImportDialog::onPauseClicked() {
+    m_paused = !m_paused;
+    m_pauseBtn->setText(m_paused ? tr("Resume") : tr("Pause"));
+
+    if (m_paused) {
+        emit pauseRequested();
+    } else {
+        emit resumeRequested();
+    }
+}
+
+void ImportDialog::reject() {
+    // Esc / nút Cancel khi đang chạy: chỉ yêu cầu hủy, dialog đóng khi pipeline báo xong
+    if (!m_finished) {
+        m_pauseBtn->setEnabled(false);
+        m_cancelBtn->setEnabled(false);
+        m_statusLbl->setText(tr("Cancelling..."));
+        emit cancelRequested();
+        return;
+    }
+
+    QDialog::reject();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QDialog>
+#include "import_pipeline.hpp"
+
+class QLabel;
+class QProgressBar;
+class QPushButton;
+
+// Dialog modal hiển thị tiến độ import thư mục; modal để UI không ghi DB song song với pipeline
+class ImportDialog final : public QDialog {
+        Q_OBJECT
+
+    public:
+        explicit ImportDialog(const QString &directory, QWidget* parent = nullptr);
+        ~ImportDialog() override = default;
+
+    signals:
+        void pauseRequested();
+        void resumeRequested();
+        void cancelRequested();
+
+    public slots:
+        void updateProgress(const ImportProgress &progress);
+
+    protected:
+        void reject() override;
+
+    private slots:
+        void onPauseClicked();
+
+    private: // NOLINT(readability-redundant-access-specifiers)
+        void setupUi(const QString &directory);
+
+        QLabel* m_dirLbl{};
+        QLabel* m_statusLbl{};
+        QLabel* m_detailLbl{};
+        QProgressBar* m_progressBar{};
+        QPushButton* m_pauseBtn{};
+        QPushButton* m_cancelBtn{};
+
+        bool m_paused{};
+        bool m_finished{};
+};
@@ -0,0 +1,153 @@
+#include <QDebug>
+#include <QString>
+#include <algorithm>
+#include <exception>
+#include <string_view>
+#include <utility>
+#include "ResultsModel.hpp"
+#include "search_result.hpp"
+
+namespace {
+    QString toQString(std::string_view text) {
+        return QString::fromUtf8(text.data(), static_cast<qsizetype>(text.size()));
+    }
+} // namespace
+
+ResultsModel::ResultsModel(QObject* parent) : QAbstractTableModel(parent) {}
+
+void ResultsModel::setSource(PageFetcher fetcher, Paging paging) {
+    beginResetModel();
+    m_pages.clear();
+    m_rows.clear();
+    m_fetcher = std::move(fetcher);
+    m_paging = paging;
+    m_offset = 0;
+    m_exhausted = !m_fetcher;
+    endResetModel();
+
+    // Trang đầu nạp ngay để biết có kết quả hay không
+    if (canFetchMore(QModelIndex())) { fetchMore(QModelIndex()); }
+}
+
+void ResultsModel::clear() {
+    setSource({});
+}
+
+void ResultsModel::appendResults(SearchResult result) {
+    if (result.empty()) { return; }
+
+    const auto first = static_cast<int>(m_rows.size());
+    const auto count = static_cast<int>(result.size());
+    const auto pageNo = static_cast<std::uint32_t>(m_pages.size());
+
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+    m_pages.push_back(std::move(result));
+    m_rows.reserve(m_rows.size() + static_cast<std::size_t>(count));
+    for (std::uint32_t i = 0; i < static_cast<std::uint32_t>(count); ++i) {
+        m_rows.push_back({.page = pageNo, .index = i});
+    }
+    endInsertRows();
+}
+
+std::optional<SearchResult::Entry> ResultsModel::entry(int row) const {
+    if (row < 0 || static_cast<std::size_t>(row) >= m_rows.size()) { return std::nullopt; }
+
+    const auto ref = m_rows[static_cast<std::size_t>(row)];
+    return m_pages[ref.page][ref.index];
+}
+
+void ResultsModel::retranslate() {
+    emit headerDataChanged(Qt::Horizontal, 0, ColumnCount - 1);
+}
+
+int ResultsModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(m_rows.size());
+}
+
+int ResultsModel::columnCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant ResultsModel::data(const QModelIndex &index, int role) const {
+    const auto res = entry(index.row());
+    if (!index.isValid() || !res.has_value()) { return {}; }
+
+    if (role == LINE_ROLE) {
+        // PDF chỉ biết dòng trong trang nên bỏ qua
+        return res->hit.has_value() && !res->hit->page.has_value() ? res->hit->line : 0;
+    }
+
+    if (role == Qt::TextAlignmentRole && index.column() == IdColumn) {
+        return QVariant::fromValue(Qt::Alignment(Qt::AlignCenter));
+    }
+
+    if (role != Qt::DisplayRole && role != Qt::ToolTipRole) { return {}; }
+
+    switch (index.column()) {
+        case IdColumn:
+            return QString::number(res->id);
+        case TitleColumn:
+            return toQString(res->title);
+        case PathColumn:
+            return res->path.has_value() ? toQString(*res->path) : QString();
+        default:
+            return {};
+    }
+}
+
+QVariant ResultsModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+        case IdColumn:
+            return tr("ID");
+        case TitleColumn:
+            return tr("Title");
+        case PathColumn:
+            return tr("Path");
+        default:
+            return {};
+    }
+}
+
+bool ResultsModel::canFetchMore(const QModelIndex &parent) const {
+    return !parent.isValid() && !m_exhausted;
+}
+
+void ResultsModel::fetchMore(const QModelIndex &parent) {
+    if (!canFetchMore(parent)) { return; }
+
+    SearchPage page;
+    try {
+        page = m_fetcher(m_offset, PAGE_SIZE);
+    } catch (const std::exception &e) {
+        // Lỗi giữa chừng (DB bận, query hỏng...): giữ các trang đã có, ngừng nạp tiếp
+        qWarning() << "Fetch results failed:" << e.what();
+        m_exhausted = true;
+        return;
+    }
+    m_offset += PAGE_SIZE;
+    m_exhausted = page.last;
+
+    appendResults(std::move(page.result));
+}
+
+bool ResultsModel::removeRows(int row, int count, const QModelIndex &parent) {
+    if (parent.isValid() || row < 0 || count <= 0 ||
+        static_cast<std::size_t>(row + count) > m_rows.size()) {
+        return false;
+    }
+
+    beginRemoveRows(parent, row, row + count - 1);
+    m_rows.erase(m_rows.begin() + row, m_rows.begin() + row + count);
+    // Truy vấn chạy lại không còn resource đã xóa nên các dòng sau lùi lên: lùi offset theo, nếu
+    // không trang kế tiếp bỏ sót count dòng. Snapshot vẫn giữ chỗ của chúng (trang chỉ bỏ qua id
+    // đã xóa) nên offset giữ nguyên, lùi thì trang kế tiếp lặp lại dòng đã hiện
+    if (m_paging == Paging::requery) {
+        m_offset -= std::min(m_offset, static_cast<std::size_t>(count));
+    }
+    endRemoveRows();
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <QAbstractTableModel>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+#include "search_result.hpp"
+
+// Model cho bảng kết quả Browse: dữ liệu nằm trong các trang SearchResult (arena), QString chỉ
+// được tạo khi view hỏi tới dòng đang hiển thị. Trang sau được nạp khi cuộn tới cuối
+// (canFetchMore/fetchMore), mỗi trang là một truy vấn có LIMIT/OFFSET.
+// Mỗi dòng tốn một RowRef (8 byte) cộng bản ghi của SearchResult.
+class ResultsModel final : public QAbstractTableModel {
+        Q_OBJECT
+
+    public:
+        enum Column : std::uint8_t { IdColumn = 0, TitleColumn, PathColumn, ColumnCount };
+
+        static constexpr int LINE_ROLE{Qt::UserRole}; // dòng chỗ khớp, 0 nếu không có
+        static constexpr std::size_t PAGE_SIZE{500};
+
+        using PageFetcher = std::function<SearchPage(std::size_t offset, std::size_t limit)>;
+
+        // Fetcher lấy trang từ đâu, để biết xóa dòng có làm các dòng sau dịch lên không
+        enum class Paging : std::uint8_t {
+            requery,  // mỗi trang chạy lại truy vấn: resource đã xóa không còn trong kết quả
+            snapshot, // trang cắt từ danh sách chụp sẵn (hit, id): danh sách không ngắn đi
+        };
+
+        explicit ResultsModel(QObject* parent = nullptr);
+        ~ResultsModel() override = default;
+
+        // Thay nguồn kết quả: bỏ mọi trang cũ (giải phóng arena) và nạp trang đầu
+        void setSource(PageFetcher fetcher, Paging paging = Paging::requery);
+        void clear();
+        // Thêm kết quả đến dần (tìm regex) vào cuối bảng, không qua fetcher
+        void appendResults(SearchResult result);
+
+        [[nodiscard]] std::optional<SearchResult::Entry> entry(int row) const;
+
+        // Gọi sau khi đổi ngôn ngữ
+        void retranslate();
+
+        [[nodiscard]] int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+        [[nodiscard]] int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+        [[nodiscard]] QVariant data(const QModelIndex &index,
+                                    int role = Qt::DisplayRole) const override;
+        [[nodiscard]] QVariant headerData(int section, Qt::Orientation orientation,
+                                          int role = Qt::DisplayRole) const override;
+
+        [[nodiscard]] bool canFetchMore(const QModelIndex &parent) const override;
+        void fetchMore(const QModelIndex &parent) override;
+
+        // Chỉ bỏ dòng khỏi bảng (sau khi đã xóa resource), không động tới DB. Với Paging::requery
+        // lùi offset trang kế tiếp theo số dòng đã xóa
+        bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    private:
+        struct RowRef {
+                std::uint32_t page{};
+                std::uint32_t index{};
+        };
+
+        PageFetcher m_fetcher;
+        std::vector<SearchResult> m_pages;
+        std::vector<RowRef> m_rows;
+        std::size_t m_offset{}; // offset của trang kế tiếp trong truy vấn
+        Paging m_paging{Paging::requery};
+        bool m_exhausted{true};
+};
@@ -6,6 +6,7 @@
 #include <QLineEdit>
 #include <QPushButton>
 #include <QComboBox>
+#include <QCheckBox>
 #include <QVariant>
 #include "SettingsTabWidget.hpp"
 #include "UiConstants.hpp"
@@ -35,6 +36,8 @@ void SettingsTabWidget::setupUi() {
     contentLayout->addLayout(setupThemeGroup());
     contentLayout->addLayout(setupResourceDirGroup());
     contentLayout->addLayout(setupResourceManagerTypeGroup());
+    contentLayout->addLayout(setupCompressionGroup());
+    contentLayout->addLayout(setupSubstringIndexGroup());
     contentLayout->addStretch(1);
     contentLayout->addWidget(m_notiSettingsChangedLbl);
     contentLayout->addLayout(setupButtonGroup());
@@ -68,6 +71,8 @@ void SettingsTabWidget::retranslateUi() {
     m_resManLbl->setText(tr("Notes file management type"));
     m_resManCom->setItemText(0, tr("Notes Manager"));
     m_resManCom->setItemText(1, tr("Save path only"));
+    m_compressLbl->setText(tr("Compress note text in the database"));
+    m_substringLbl->setText(tr("Index note content for substring search (*text)"));
     m_applyBtn->setText(tr("Apply"));
     m_defaultBtn->setText(tr("Default"));
 }
@@ -110,6 +115,14 @@ QComboBox* SettingsTabWidget::resourceManagementCombo() const noexcept {
     return m_resManCom;
 }
 
+QCheckBox* SettingsTabWidget::compressNotesCheck() const noexcept {
+    return m_compressChk;
+}
+
+QCheckBox* SettingsTabWidget::substringIndexCheck() const noexcept {
+    return m_substringChk;
+}
+
 QLabel* SettingsTabWidget::notificationLabel() const noexcept {
     return m_notiSettingsChangedLbl;
 }
@@ -195,6 +208,30 @@ QHBoxLayout* SettingsTabWidget::setupResourceManagerTypeGroup() {
     return resManLayout;
 }
 
+QHBoxLayout* SettingsTabWidget::setupCompressionGroup() {
+    // Nén nội dung note
+    auto* compressLayout = new QHBoxLayout();
+    m_compressLbl = new QLabel(tr("Compress note text in the database"));
+    m_compressChk = new QCheckBox();
+    compressLayout->addWidget(m_compressLbl);
+    compressLayout->addStretch(1);
+    compressLayout->addWidget(m_compressChk);
+
+    return compressLayout;
+}
+
+QHBoxLayout* SettingsTabWidget::setupSubstringIndexGroup() {
+    // Index trigram cho nội dung (tốn thêm dung lượng DB)
+    auto* substringLayout = new QHBoxLayout();
+    m_substringLbl = new QLabel(tr("Index note content for substring search (*text)"));
+    m_substringChk = new QCheckBox();
+    substringLayout->addWidget(m_substringLbl);
+    substringLayout->addStretch(1);
+    substringLayout->addWidget(m_substringChk);
+
+    return substringLayout;
+}
+
 QHBoxLayout* SettingsTabWidget::setupButtonGroup() {
     // Thêm container chứa nhóm nút nằm ngang QHBoxLayout
     auto* buttonLayout = new QHBoxLayout();
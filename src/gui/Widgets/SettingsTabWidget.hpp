@@ -3,6 +3,7 @@
 class QRadioButton;
 class QLineEdit;
 class QComboBox;
+class QCheckBox;
 class QPushButton;
 class QLabel;
 
@@ -22,6 +23,8 @@ class SettingsTabWidget final : public QWidget {
         [[nodiscard]] QRadioButton* themeDarkRad() const noexcept;
         [[nodiscard]] QLineEdit* resourceDirInput() const noexcept;
         [[nodiscard]] QComboBox* resourceManagementCombo() const noexcept;
+        [[nodiscard]] QCheckBox* compressNotesCheck() const noexcept;
+        [[nodiscard]] QCheckBox* substringIndexCheck() const noexcept;
         [[nodiscard]] QLabel* notificationLabel() const noexcept;
         [[nodiscard]] QPushButton* applyButton() const noexcept;
         [[nodiscard]] QPushButton* defaultButton() const noexcept;
@@ -48,17 +51,23 @@ class SettingsTabWidget final : public QWidget {
         QLineEdit* m_resDirInp{};
         QPushButton* m_resDirBtn{};
         QComboBox* m_resManCom{};
+        QCheckBox* m_compressChk{};
+        QCheckBox* m_substringChk{};
         QPushButton* m_applyBtn{};
         QPushButton* m_defaultBtn{};
         QLabel* m_langLbl{};
         QLabel* m_themeLbl{};
         QLabel* m_resDirLbl{};
         QLabel* m_resManLbl{};
+        QLabel* m_compressLbl{};
+        QLabel* m_substringLbl{};
         QLabel* m_notiSettingsChangedLbl{};
 
         [[nodiscard]] QHBoxLayout* setupLanguageGroup();
         [[nodiscard]] QHBoxLayout* setupThemeGroup();
         [[nodiscard]] QHBoxLayout* setupResourceDirGroup();
         [[nodiscard]] QHBoxLayout* setupResourceManagerTypeGroup();
+        [[nodiscard]] QHBoxLayout* setupCompressionGroup();
+        [[nodiscard]] QHBoxLayout* setupSubstringIndexGroup();
         [[nodiscard]] QHBoxLayout* setupButtonGroup();
 };
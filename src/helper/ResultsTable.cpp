@@ -3,7 +3,7 @@
 #include <QTimer>
 #include "ResultsTable.hpp"
 
-ResultsTable::ResultsTable(QWidget* parent) : QTableWidget(parent) {}
+ResultsTable::ResultsTable(QWidget* parent) : QTableView(parent) {}
 
 void ResultsTable::mousePressEvent(QMouseEvent* event) {
     QModelIndex idx = indexAt(event->pos());
@@ -11,17 +11,17 @@ void ResultsTable::mousePressEvent(QMouseEvent* event) {
         clearSelection();
         selectionModel()->setCurrentIndex(QModelIndex(), QItemSelectionModel::NoUpdate);
     }
-    QTableWidget::mousePressEvent(event);
+    QTableView::mousePressEvent(event);
 }
 
 void ResultsTable::focusOutEvent(QFocusEvent* event) {
     clearSelection();
     selectionModel()->setCurrentIndex(QModelIndex(), QItemSelectionModel::NoUpdate);
-    QTableWidget::focusOutEvent(event);
+    QTableView::focusOutEvent(event);
 }
 
 void ResultsTable::showEvent(QShowEvent* event) {
-    QTableWidget::showEvent(event);
+    QTableView::showEvent(event);
 
     // Dùng timer để clear sau khi Qt hoàn tất khôi phục selection mặc định
     QTimer::singleShot(0, this, [this]() {
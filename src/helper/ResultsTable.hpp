@@ -1,13 +1,14 @@
 #pragma once
 
-#include <QTableWidget>
+#include <QTableView>
 
 class QMouseEvent;
 class QFocusEvent;
 class QShowEvent;
 
 // Prevent highlight cell last clicked when miss focus
-class ResultsTable : public QTableWidget {
+// View ảo: dữ liệu lấy từ model (ResultsModel), chỉ vẽ các dòng đang hiển thị
+class ResultsTable : public QTableView {
         Q_OBJECT
     public:
         explicit ResultsTable(QWidget* parent = nullptr);
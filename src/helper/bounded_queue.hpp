@@ -0,0 +1,162 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <utility>
+
+// Hàng đợi MPMC có giới hạn, không dùng lock (thuật toán ring buffer của D. Vyukov)
+// - tryPush/tryPop không bao giờ block
+// - push/pop chờ bằng backoff (spin -> yield -> sleep) => backpressure cho stage phía trước;
+//   pop có thể kèm deadline để consumer còn việc định kỳ (commit batch, báo tiến độ)
+// - close(): producer báo hết dữ liệu, consumer pop nốt phần còn lại rồi nhận false
+template <typename T>
+class BoundedQueue {
+    public:
+        explicit BoundedQueue(std::size_t capacity)
+            : m_capacity(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity)),
+              m_mask(m_capacity - 1), m_cells(std::make_unique<Cell[]>(m_capacity)) {
+            for (std::size_t i = 0; i < m_capacity; ++i) {
+                m_cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        BoundedQueue(const BoundedQueue &) = delete;
+        BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+        [[nodiscard]] std::size_t capacity() const noexcept { return m_capacity; }
+
+        bool tryPush(T &value) {
+            std::size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell &cell = m_cells[pos & m_mask];
+                const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+                if (diff == 0) {
+                    if (m_enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                                           std::memory_order_relaxed)) {
+                        cell.value = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false; // đầy
+                } else {
+                    pos = m_enqueuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        bool tryPop(T &out) {
+            std::size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell &cell = m_cells[pos & m_mask];
+                const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const auto diff =
+                    static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+                if (diff == 0) {
+                    if (m_dequeuePos.compare_exchange_weak(pos, pos + 1,
+                                                           std::memory_order_relaxed)) {
+                        out = std::move(*cell.value);
+                        cell.value.reset();
+                        cell.sequence.store(pos + m_capacity, std::memory_order_release);
+                        return true;
+                    }
+                } else if (diff < 0) {
+                    return false; // rỗng
+                } else {
+                    pos = m_dequeuePos.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // Chờ đến khi có chỗ trống; trả về false nếu queue đã đóng hoặc bị hủy
+        bool push(T value, const std::atomic<bool> &cancelled) {
+            Backoff backoff;
+            while (!tryPush(value)) {
+                if (m_closed.load(std::memory_order_acquire) ||
+                    cancelled.load(std::memory_order_relaxed)) {
+                    return false;
+                }
+                backoff.pause();
+            }
+            return true;
+        }
+
+        // Chờ đến khi có phần tử; trả về false khi queue đã đóng và rỗng, hoặc bị hủy
+        bool pop(T &out, const std::atomic<bool> &cancelled) {
+            return pop(out, cancelled, std::chrono::steady_clock::time_point::max());
+        }
+
+        // Như trên nhưng thôi chờ khi qua deadline (vẫn thử pop một lần); false do hết giờ thì
+        // queue chưa chắc đã đóng
+        bool pop(T &out, const std::atomic<bool> &cancelled,
+                 std::chrono::steady_clock::time_point deadline) {
+            Backoff backoff;
+            for (;;) {
+                // Đọc cờ closed TRƯỚC khi thử pop, tránh bỏ sót phần tử push ngay trước close()
+                const bool closed = m_closed.load(std::memory_order_acquire);
+                if (tryPop(out)) { return true; }
+                if (closed || cancelled.load(std::memory_order_relaxed) ||
+                    std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+                backoff.pause();
+            }
+        }
+
+        void close() noexcept { m_closed.store(true, std::memory_order_release); }
+
+        [[nodiscard]] bool isClosed() const noexcept {
+            return m_closed.load(std::memory_order_acquire);
+        }
+
+        // Ước lượng (không chính xác khi đang có thread khác push/pop)
+        [[nodiscard]] std::size_t sizeApprox() const noexcept {
+            const auto enq = m_enqueuePos.load(std::memory_order_relaxed);
+            const auto deq = m_dequeuePos.load(std::memory_order_relaxed);
+            return enq > deq ? enq - deq : 0;
+        }
+
+    private:
+        // Tách hai đầu queue ra hai cache line khác nhau để producer/consumer không tranh nhau
+        static constexpr std::size_t kCacheLine{64};
+
+        struct Cell {
+                std::atomic<std::size_t> sequence;
+                std::optional<T> value;
+        };
+
+        struct Backoff {
+                unsigned spins{};
+
+                void pause() {
+                    constexpr unsigned kSpinLimit{64};
+                    constexpr unsigned kYieldLimit{128};
+                    constexpr auto kSleep = std::chrono::microseconds(200);
+
+                    if (spins < kSpinLimit) {
+                        ++spins;
+                    } else if (spins < kYieldLimit) {
+                        ++spins;
+                        std::this_thread::yield();
+                    } else {
+                        std::this_thread::sleep_for(kSleep);
+                    }
+                }
+        };
+
+        const std::size_t m_capacity;
+        const std::size_t m_mask;
+        std::unique_ptr<Cell[]> m_cells; // NOLINT(modernize-avoid-c-arrays)
+
+        alignas(kCacheLine) std::atomic<std::size_t> m_enqueuePos{0};
+        alignas(kCacheLine) std::atomic<std::size_t> m_dequeuePos{0};
+        alignas(kCacheLine) std::atomic<bool> m_closed{false};
+};
@@ -0,0 +1,109 @@
+// notes-pdf-worker: trích text layer của một file PDF, ghi ra stdout theo pdf_worker_protocol.
+// App chạy mỗi PDF trong một tiến trình riêng: parser gặp file hỏng/độc hại chỉ làm chết worker,
+// không ảnh hưởng app. Worker tự siết giới hạn tài nguyên trước khi mở file.
+//
+//   notes-pdf-worker [--max-pages N] [--cpu-seconds S] <file.pdf>
+
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include <string_view>
+#include "pdf_text.hpp"
+#include "pdf_worker_protocol.hpp"
+
+#if defined(__linux__)
+#include <csignal>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#elif defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+    constexpr int kDefaultMaxPages{2000};
+    constexpr int kDefaultCpuSeconds{60};
+    constexpr unsigned long long kMaxAddressSpace{1ULL << 30U}; // 1 GiB
+
+    bool writeOut(std::string_view data) {
+        return std::fwrite(data.data(), 1, data.size(), stdout) == data.size() &&
+               std::fflush(stdout) == 0;
+    }
+
+    void applySandbox([[maybe_unused]] int cpuSeconds) {
+#if defined(__linux__)
+        // App chết thì worker chết theo; không bao giờ được nâng quyền qua exec
+        prctl(PR_SET_PDEATHSIG, SIGKILL);
+        prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0);
+
+        const rlimit memory{kMaxAddressSpace, kMaxAddressSpace};
+        setrlimit(RLIMIT_AS, &memory);
+
+        // Vượt soft limit nhận SIGXCPU, hard limit +1s thì bị SIGKILL
+        const auto cpu = static_cast<rlim_t>(cpuSeconds);
+        const rlimit cpuLimit{cpu, cpu + 1};
+        setrlimit(RLIMIT_CPU, &cpuLimit);
+
+        const rlimit noCore{0, 0};
+        setrlimit(RLIMIT_CORE, &noCore);
+#elif defined(_WIN32)
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    }
+
+    bool parsePositive(const char* text, int &value) {
+        char* end = nullptr;
+        const long parsed = std::strtol(text, &end, 10);
+        if (end == text || *end != '\0' || parsed <= 0 || parsed > 1'000'000) { return false; }
+
+        value = static_cast<int>(parsed);
+        return true;
+    }
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int maxPages{kDefaultMaxPages};
+    int cpuSeconds{kDefaultCpuSeconds};
+    const char* path = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--max-pages" && i + 1 < argc) {
+            if (!parsePositive(argv[++i], maxPages)) { return 2; }
+        } else if (arg == "--cpu-seconds" && i + 1 < argc) {
+            if (!parsePositive(argv[++i], cpuSeconds)) { return 2; }
+        } else if (path == nullptr) {
+            path = argv[i];
+        } else {
+            return 2;
+        }
+    }
+
+    if (path == nullptr) {
+        std::fputs("usage: notes-pdf-worker [--max-pages N] [--cpu-seconds S] <file.pdf>\n",
+                   stderr);
+        return 2;
+    }
+
+    applySandbox(cpuSeconds);
+
+    try {
+        PdfTextExtractor pdf(path);
+
+        bool writable{true};
+        const int pages = pdf.extractPages(
+            [&](int page, std::string_view text) {
+                writable = writable && writeOut(encodePdfPage(page, text));
+            },
+            maxPages);
+
+        if (!writable || !writeOut(encodePdfDone(pages))) { return 1; }
+
+    } catch (const std::exception &ex) {
+        writeOut(encodePdfError(ex.what()));
+        return 1;
+    }
+
+    return 0;
+}
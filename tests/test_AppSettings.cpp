@@ -11,6 +11,14 @@ TEST_CASE("AppSettings - default values", "[AppSettings]") {
     SECTION("default theme should be Light") {
         REQUIRE(settings.theme() == Theme::light);
     }
+
+    SECTION("note compression should be off") {
+        REQUIRE_FALSE(settings.compressNotes());
+    }
+
+    SECTION("substring index should be off") {
+        REQUIRE_FALSE(settings.substringIndex());
+    }
 }
 
 TEST_CASE("AppSettings - change settings", "[AppSettings]") {
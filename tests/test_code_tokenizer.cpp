@@ -0,0 +1,216 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+#include "code_tokenizer.hpp"
+#include "schema_migrator.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    using Strings = std::vector<std::string>;
+
+    // "token" hoặc "+token" (colocated); đoạn không phải ASCII ghi là "<đoạn>"
+    Strings scan(std::string_view text, bool query = false) {
+        Strings out;
+        forEachCodeToken(
+            text, query,
+            [&](std::string_view token, std::size_t, std::size_t, bool colocated) {
+                out.push_back((colocated ? "+" : "") + std::string(token));
+                return true;
+            },
+            [&](std::size_t begin, std::size_t end) {
+                out.push_back("<" + std::string(text.substr(begin, end - begin)) + ">");
+                return true;
+            });
+        return out;
+    }
+
+    void exec(SQLiteDB &db, const std::string &sql) {
+        REQUIRE(sqlite3_exec(db.get(), sql.c_str(), nullptr, nullptr, nullptr) == SQLITE_OK);
+    }
+
+    std::vector<sqlite3_int64> match(SQLiteDB &db, const std::string &table,
+                                     const std::string &query) {
+        SQLiteStmt stmt(db.get(), "SELECT rowid FROM " + table + " WHERE " + table +
+                                      " MATCH ? ORDER BY rowid;");
+        sqlite3_bind_text(stmt.get(), 1, query.c_str(), -1, SQLITE_TRANSIENT);
+
+        std::vector<sqlite3_int64> ids;
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            ids.push_back(sqlite3_column_int64(stmt.get(), 0));
+        }
+        return ids;
+    }
+
+    // Snippet code C++ kiểu note thật, mỗi cái một khác
+    std::vector<std::string> sampleSnippets(int count) {
+        std::vector<std::string> snippets;
+        for (int n = 0; n < count; ++n) {
+            const auto id = std::to_string(n);
+            snippets.push_back(
+                "// Ghi chú số " + id + ": tìm tag theo tên\n"
+                "std::optional<TagRecord> getTagIdByName" + id + "(std::string_view tag_name) {\n"
+                "    static std::unordered_map<std::string, int> cache_" + id + ";\n"
+                "    if (auto it = cache_" + id + ".find(std::string(tag_name)); it != cache_" +
+                id + ".end()) { return TagRecord{it->second}; }\n"
+                "    return m_tagRepo.findByName(tag_name, HTMLParser::kDefaultLimit);\n}\n");
+        }
+        return snippets;
+    }
+} // namespace
+
+TEST_CASE("Code tokenizer splits identifiers", "[CodeTokenizer]") {
+    SECTION("camelCase, snake_case and scopes become sub-words") {
+        CHECK(scan("getTagIdByName") ==
+              Strings{"get", "+gettagidbyname", "tag", "id", "by", "name"});
+        CHECK(scan("tag_name") == Strings{"tag", "+tagname", "name"});
+        CHECK(scan("std::unordered_map") ==
+              Strings{"std", "+stdunorderedmap", "unordered", "map"});
+        CHECK(scan("HTMLParser utf8Decode") ==
+              Strings{"html", "+htmlparser", "parser", "utf8", "+utf8decode", "decode"});
+    }
+
+    SECTION("plain words and separators behave like unicode61") {
+        CHECK(scan("Ring buffer, v2!") == Strings{"ring", "buffer", "v2"});
+        CHECK(scan("a : b ::c __ _x_") == Strings{"a", "b", "c", "x"});
+        CHECK(scan("").empty());
+    }
+
+    SECTION("queries only carry sub-words") {
+        CHECK(scan("getTagIdByName", true) == Strings{"get", "tag", "id", "by", "name"});
+        CHECK(scan("gettag", true) == Strings{"gettag"});
+    }
+
+    SECTION("runs with non-ASCII bytes are handed over whole") {
+        CHECK(scan("Tìm kiếm getTag") == Strings{"<Tìm kiếm>", "get", "+gettag", "tag"});
+        CHECK(scan("xửLý_note") == Strings{"<xửLý_note>"});
+    }
+}
+
+TEST_CASE("Code tokenizer inside FTS5", "[CodeTokenizer]") {
+    SQLiteDB db(":memory:");
+    exec(db, "CREATE VIRTUAL TABLE docs USING fts5(body, tokenize = 'code remove_diacritics 1');"
+             "INSERT INTO docs (rowid, body) VALUES "
+             "(1, 'auto id = repo.getTagIdByName(name);'),"
+             "(2, 'std::unordered_map<int, Tag> tag_cache;'),"
+             "(3, 'Ghi chú tiếng Việt về thuật toán'),"
+             "(4, 'tag and id, but apart');");
+
+    CHECK(match(db, "docs", "\"tag id\"") == std::vector<sqlite3_int64>{1});
+    CHECK(match(db, "docs", "tag id") == std::vector<sqlite3_int64>{1, 4});
+    CHECK(match(db, "docs", "getTagIdByName") == std::vector<sqlite3_int64>{1});
+    CHECK(match(db, "docs", "gettagidbyname") == std::vector<sqlite3_int64>{1});
+    CHECK(match(db, "docs", "gettag*") == std::vector<sqlite3_int64>{1});
+    CHECK(match(db, "docs", "getTa*") == std::vector<sqlite3_int64>{1});
+    CHECK(match(db, "docs", "\"std::unordered_map\"") == std::vector<sqlite3_int64>{2});
+    CHECK(match(db, "docs", "unordered_map") == std::vector<sqlite3_int64>{2});
+    CHECK(match(db, "docs", "cache") == std::vector<sqlite3_int64>{2});
+    // Đoạn tiếng Việt vẫn qua unicode61: bỏ dấu, hạ chữ thường
+    CHECK(match(db, "docs", "ghi chu") == std::vector<sqlite3_int64>{3});
+
+    // highlight() dùng offset của từ con đầu tiên ở mỗi vị trí
+    SQLiteStmt stmt(db.get(), "SELECT highlight(docs, 0, '[', ']') FROM docs "
+                              "WHERE docs MATCH '\"tag id\"';");
+    REQUIRE(sqlite3_step(stmt.get()) == SQLITE_ROW);
+    CHECK(std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0))) ==
+          "auto id = repo.get[TagId]ByName(name);");
+}
+
+TEST_CASE("Schema v11 switches FTS tables to the code tokenizer",
+          "[CodeTokenizer][SchemaMigrator]") {
+    SQLiteDB db(":memory:");
+    exec(db, R"SQL(
+        CREATE TABLE resources (id INTEGER PRIMARY KEY, title TEXT NOT NULL, type INTEGER);
+        CREATE VIRTUAL TABLE resources_fts USING fts5(
+            title, prefix = '2 3 4', tokenize = 'unicode61 remove_diacritics 1'
+        );
+        CREATE TRIGGER resources_insert_fts AFTER INSERT ON resources
+        BEGIN
+            INSERT INTO resources_fts (rowid, title) VALUES (new.id, new.title);
+        END;
+
+        CREATE TABLE text_chunks (id INTEGER PRIMARY KEY, resource_id INTEGER, content TEXT);
+        CREATE VIRTUAL TABLE text_chunks_fts USING fts5(
+            content, content = 'text_chunks', content_rowid = 'id', prefix = '2 3 4',
+            tokenize = 'unicode61 remove_diacritics 1'
+        );
+        CREATE TRIGGER text_chunks_insert_fts AFTER INSERT ON text_chunks
+        BEGIN
+            INSERT INTO text_chunks_fts (rowid, content) VALUES (new.id, new.content);
+        END;
+
+        INSERT INTO resources (id, title, type) VALUES (1, 'TagRepository notes', 0);
+        INSERT INTO text_chunks (id, resource_id, content)
+        VALUES (1, 1, 'int getTagIdByName(std::string_view name);');
+
+        PRAGMA user_version = 10;
+    )SQL");
+
+    CHECK(match(db, "resources_fts", "repository").empty());
+    CHECK(match(db, "text_chunks_fts", "\"tag id\"").empty());
+
+    REQUIRE(SchemaMigrator(db).migrate() == SchemaMigrator::kCurrentVersion - 10);
+
+    CHECK(match(db, "resources_fts", "repository") == std::vector<sqlite3_int64>{1});
+    CHECK(match(db, "text_chunks_fts", "\"tag id\"") == std::vector<sqlite3_int64>{1});
+
+    // Trigger cũ ghi vào bảng mới
+    exec(db, "INSERT INTO resources (id, title, type) VALUES (2, 'ringBuffer', 0);");
+    CHECK(match(db, "resources_fts", "buffer") == std::vector<sqlite3_int64>{2});
+}
+
+TEST_CASE("Code tokenizer indexing throughput", "[CodeTokenizer][.benchmark]") {
+    const auto snippets = sampleSnippets(2000);
+    std::size_t bytes{};
+    for (const auto &snippet : snippets) { bytes += snippet.size(); }
+
+    SQLiteDB db(":memory:");
+    exec(db, "CREATE TABLE snippets (id INTEGER PRIMARY KEY, content TEXT);"
+             "CREATE VIRTUAL TABLE unicode_fts USING fts5(content, content = 'snippets', "
+             "content_rowid = 'id', tokenize = 'unicode61 remove_diacritics 1');"
+             "CREATE VIRTUAL TABLE code_fts USING fts5(content, content = 'snippets', "
+             "content_rowid = 'id', tokenize = 'code remove_diacritics 1');");
+    {
+        SQLiteStmt insert(db.get(), "INSERT INTO snippets (content) VALUES (?);");
+        for (const auto &snippet : snippets) {
+            sqlite3_reset(insert.get());
+            sqlite3_bind_text(insert.get(), 1, snippet.c_str(), -1, SQLITE_STATIC);
+            REQUIRE(sqlite3_step(insert.get()) == SQLITE_DONE);
+        }
+    }
+
+    const auto rebuild = [&](const std::string &fts) {
+        const auto start = std::chrono::steady_clock::now();
+        exec(db, "INSERT INTO " + fts + " (" + fts + ") VALUES ('rebuild');");
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return static_cast<double>(bytes) / 1e6 / elapsed.count();
+    };
+
+    const double unicodeRate = rebuild("unicode_fts");
+    const double codeRate = rebuild("code_fts");
+    WARN(bytes << " B of C++ snippets, unicode61 " << unicodeRate << " MB/s, code " << codeRate
+               << " MB/s");
+
+    // Tokenizer sinh nhiều token hơn (từ con + identifier đầy đủ) nhưng không được chậm hẳn
+    CHECK(codeRate * 3 > unicodeRate);
+
+    BENCHMARK("unicode61 rebuild") {
+        exec(db, "INSERT INTO unicode_fts (unicode_fts) VALUES ('rebuild');");
+    };
+    BENCHMARK("code rebuild") { exec(db, "INSERT INTO code_fts (code_fts) VALUES ('rebuild');"); };
+
+    BENCHMARK("code scan only") {
+        std::size_t tokens{};
+        for (const auto &snippet : snippets) {
+            forEachCodeToken(
+                snippet, false,
+                [&](std::string_view, std::size_t, std::size_t, bool) { return ++tokens > 0; },
+                [](std::size_t, std::size_t) { return true; });
+        }
+        return tokens;
+    };
+}
@@ -0,0 +1,371 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "content_index_repository.hpp"
+#include "content_indexer.hpp"
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+#include "resource_repository.hpp"
+#include "resource_service.hpp"
+#include "schema_migrator.hpp"
+#include "sqldb_raii.hpp"
+#include "tag_repository.hpp"
+#include "text_content_repository.hpp"
+
+namespace {
+    namespace fs = std::filesystem;
+
+    // Schema gốc (v0), phần còn lại do SchemaMigrator tạo
+    void createIndexerSchema(SQLiteDB &db, bool migrate = true) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type TEXT NOT NULL,
+                file_hash TEXT UNIQUE,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                UNIQUE (title, type)
+            );
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0,
+                FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+            );
+
+            CREATE TABLE text_content (
+                resource_id INTEGER PRIMARY KEY,
+                content TEXT NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE text_content_fts USING fts5(content);
+
+            CREATE TRIGGER text_content_insert_fts AFTER INSERT ON text_content
+            BEGIN
+                INSERT INTO text_content_fts (rowid, content) VALUES (new.resource_id, new.content);
+            END;
+
+            CREATE TABLE tags (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT UNIQUE NOT NULL);
+            CREATE TABLE resource_tags (resource_id INTEGER, tag_id INTEGER,
+                                        PRIMARY KEY (resource_id, tag_id));
+        )SQL";
+
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+        if (migrate) { SchemaMigrator(db).migrate(); }
+    }
+
+    // Bảng con (text_content, text_content_fts) của schema trước v4
+    void insertLegacyNote(SQLiteDB &db, sqlite3_int64 id, const std::string &title,
+                          const std::string &content) {
+        SQLiteStmt res(db.get(), "INSERT INTO resources (id, title, type) VALUES (?, ?, 'text');");
+        sqlite3_bind_int64(res.get(), 1, id);
+        sqlite3_bind_text(res.get(), 2, title.c_str(), -1, SQLITE_TRANSIENT);
+        REQUIRE(sqlite3_step(res.get()) == SQLITE_DONE);
+
+        SQLiteStmt text(db.get(), "INSERT INTO text_content (resource_id, content) VALUES (?, ?);");
+        sqlite3_bind_int64(text.get(), 1, id);
+        sqlite3_bind_text(text.get(), 2, content.c_str(), -1, SQLITE_TRANSIENT);
+        REQUIRE(sqlite3_step(text.get()) == SQLITE_DONE);
+    }
+
+    void writeFile(const fs::path &path, std::string_view content) {
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs << content;
+    }
+
+    std::vector<std::string> chunksOf(const std::string &text, std::size_t chunkSize) {
+        std::istringstream in(text);
+        std::vector<std::string> chunks;
+        ContentIndexer::forEachTextChunk(in, chunkSize, [&](std::string_view chunk) {
+            chunks.emplace_back(chunk);
+        });
+        return chunks;
+    }
+} // namespace
+
+TEST_CASE("ContentIndexer::forEachTextChunk splits on line and UTF-8 boundaries",
+          "[ContentIndexer]") {
+    SECTION("prefers cutting after a newline") {
+        std::string text;
+        for (int i = 0; i < 100; ++i) { text += "line number " + std::to_string(i) + "\n"; }
+
+        const auto chunks = chunksOf(text, 256);
+        REQUIRE(chunks.size() > 1);
+
+        std::string joined;
+        for (const auto &c : chunks) {
+            CHECK(c.size() <= 256);
+            joined += c;
+        }
+        CHECK(joined == text);
+
+        for (std::size_t i = 0; i + 1 < chunks.size(); ++i) { CHECK(chunks[i].back() == '\n'); }
+    }
+
+    SECTION("never splits a multi-byte character") {
+        std::string text;
+        for (int i = 0; i < 300; ++i) { text += "ệ"; } // 3 byte mỗi ký tự, không có '\n'
+
+        const auto chunks = chunksOf(text, 256);
+        REQUIRE(chunks.size() > 1);
+
+        std::string joined;
+        for (const auto &c : chunks) {
+            CHECK(c.size() % 3 == 0);
+            joined += c;
+        }
+        CHECK(joined == text);
+    }
+
+    SECTION("empty input yields no chunk") {
+        CHECK(chunksOf("", 256).empty());
+    }
+}
+
+TEST_CASE("ChunkCursor tracks offsets and lines across chunks", "[ContentIndexer]") {
+    std::string text;
+    for (int i = 1; i <= 200; ++i) { text += "line " + std::to_string(i) + "\n"; }
+
+    ChunkCursor cursor;
+    std::vector<ChunkPosition> positions;
+    std::istringstream in(text);
+
+    ContentIndexer::forEachTextChunk(in, 256, [&](std::string_view chunk) {
+        const auto pos = cursor.advance(chunk);
+        positions.push_back(pos);
+
+        // Chunk bắt đầu đúng tại byte_offset, ở đầu dòng line_no
+        CHECK(text.compare(static_cast<std::size_t>(pos.byte_offset), chunk.size(), chunk) == 0);
+        CHECK(chunk.starts_with("line " + std::to_string(pos.line_no) + "\n"));
+    });
+
+    REQUIRE(positions.size() > 2);
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+        CHECK(positions[i].chunk_no == static_cast<int>(i));
+    }
+    CHECK(positions.front().byte_offset == 0);
+    CHECK(positions.front().line_no == 1);
+}
+
+TEST_CASE("splitContentDefined cuts on content, not position", "[ContentIndexer]") {
+    std::string text;
+    for (int i = 1; i <= 4000; ++i) {
+        text += "row " + std::to_string(i * 7919 % 10007) + " đoạn văn bản mẫu\n";
+    }
+
+    const ContentChunkOptions options{.minSize = 512, .targetSize = 1024, .maxSize = 4096};
+    const auto chunks = splitContentDefined(text, options);
+    REQUIRE(chunks.size() > 10);
+
+    std::string joined;
+    for (const auto chunk : chunks) {
+        CHECK(chunk.size() <= options.maxSize);
+        joined += chunk;
+    }
+    CHECK(joined == text);
+
+    // Sửa một chỗ ở giữa: các chunk trước và sau vùng sửa không đổi
+    std::string edited = text;
+    edited.insert(text.size() / 2, "inserted words\n");
+    const auto editedChunks = splitContentDefined(edited, options);
+
+    const std::set<std::string_view> before(chunks.begin(), chunks.end());
+    const auto changed = std::ranges::count_if(editedChunks, [&](std::string_view chunk) {
+        return !before.contains(chunk);
+    });
+    CHECK(changed <= 2);
+
+    SECTION("long lines are cut at UTF-8 boundaries") {
+        std::string line;
+        for (int i = 0; i < 3000; ++i) { line += "ệ"; } // không có '\n'
+
+        const auto parts = splitContentDefined(line, options);
+        REQUIRE(parts.size() > 1);
+        for (const auto part : parts) { CHECK(part.size() % 3 == 0); }
+    }
+
+    CHECK(splitContentDefined("", options).empty());
+}
+
+TEST_CASE("Schema v4 moves note search to chunked text_chunks", "[ContentIndexer]") {
+    SQLiteDB db(":memory:");
+    createIndexerSchema(db, false);
+
+    std::string longNote;
+    for (int i = 1; i <= 2000; ++i) { longNote += "paragraph " + std::to_string(i) + "\n"; }
+    longNote += "the legacy marker\n";
+
+    insertLegacyNote(db, 1, "short", "legacy note body");
+    insertLegacyNote(db, 2, "long", longNote);
+
+    CHECK(SchemaMigrator(db).migrate() == SchemaMigrator::kCurrentVersion);
+
+    {
+        SQLiteStmt stmt(db.get(), "SELECT 1 FROM sqlite_master WHERE name = 'text_content_fts';");
+        CHECK(sqlite3_step(stmt.get()) == SQLITE_DONE);
+    }
+
+    TextContentRepository textRepo(db);
+    const auto hits = textRepo.searchContentHits("legacy");
+    REQUIRE(hits.size() == 2);
+
+    for (const auto &hit : hits) {
+        if (hit.resource_id == 2) {
+            CHECK(hit.line == 2001);
+            CHECK(hit.byte_offset == static_cast<std::int64_t>(longNote.find("legacy")));
+        } else {
+            CHECK(hit.line == 1);
+            CHECK(hit.byte_offset == 0);
+        }
+    }
+}
+
+TEST_CASE("ContentIndexer indexes linked files and re-indexes on hash change",
+          "[ContentIndexer]") {
+    SQLiteDB db(":memory:");
+    createIndexerSchema(db);
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    TextContentRepository textRepo(db);
+    TagRepository tagRepo(db);
+    ContentIndexRepository indexRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+    ResourceService resService(db, resRepo, fileRepo, textRepo, tagRepo, fileService, &indexRepo);
+    ContentIndexer indexer(db, indexRepo, ContentIndexOptions{.chunkSize = 256});
+
+    const auto dir = fs::temp_directory_path() / "notes_content_index";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    const auto cpp = dir / "vector_utils.cpp";
+    std::string source;
+    for (int i = 0; i < 50; ++i) { source += "int helper" + std::to_string(i) + "();\n"; }
+    source += "void quicksortPartition();\n";
+    writeFile(cpp, source);
+
+    const auto txt = dir / "notes.txt";
+    writeFile(txt, "remember the borrow checker");
+
+    const auto cppId = fileService.addFileResource(cpp.string(), "vector_utils", ResourceType::cpp,
+                                                   false);
+    const auto txtId = fileService.addFileResource(txt.string(), "notes", ResourceType::text,
+                                                   false);
+    resService.addTextResource("plain note", "quicksortPartition in a note", ResourceType::text);
+
+    CHECK(indexer.indexPending(10) == 2);
+    CHECK(indexRepo.chunkCount(cppId) > 1);
+    CHECK(indexRepo.chunkCount(txtId) == 1);
+
+    // Hash không đổi -> không còn gì để index
+    CHECK(indexer.indexPending(10) == 0);
+
+    SECTION("content search covers text notes and indexed files") {
+        const auto matches = resService.searchByContent("quicksortPartition");
+        REQUIRE(matches.size() == 2);
+
+        bool hasFile{false};
+        for (const auto &[id, snippet] : matches) {
+            if (id == cppId) {
+                hasFile = true;
+                CHECK(snippet.find("quicksortPartition") != std::string::npos);
+            }
+        }
+        CHECK(hasFile);
+
+        CHECK(resService.searchByContent("borrow").front().first == txtId);
+    }
+
+    SECTION("hits carry the offset and line of the match") {
+        const auto hits = resService.searchContentHits("quicksortPartition");
+        REQUIRE(hits.size() == 2);
+
+        // Note và file trộn theo bm25: note chỉ một dòng FTS (idf ~ 0) khớp yếu hơn file
+        CHECK(hits[0].rank <= hits[1].rank);
+        CHECK(hits[0].resource_id == cppId);
+        CHECK(hits[0].line == 51);
+        CHECK(hits[0].byte_offset ==
+              static_cast<std::int64_t>(source.find("quicksortPartition")));
+        CHECK(hits[1].line == 1);
+        CHECK(hits[1].byte_offset == 0);
+
+        const auto full = resService.searchByContentFull("helper30");
+        REQUIRE(full.size() == 1);
+        REQUIRE(full[0].hit.has_value());
+        CHECK(full[0].hit->line == 31);
+        CHECK(full[0].content == full[0].hit->snippet);
+    }
+
+    SECTION("hash change triggers re-index with new content") {
+        writeFile(txt, "lifetimes and ownership");
+        resRepo.updateFileHash(txtId, FileService::computeFileHash(txt.string()));
+
+        CHECK(indexer.indexPending(10) == 1);
+        CHECK(resService.searchByContent("borrow").empty());
+        CHECK(resService.searchByContent("ownership").size() == 1);
+    }
+
+    SECTION("deleting the resource drops its chunks") {
+        resService.deleteResource(cppId);
+        CHECK(indexRepo.chunkCount(cppId) == 0);
+        CHECK(resService.searchByContent("helper7").empty());
+    }
+
+    SECTION("unreadable file is recorded and not retried until its hash changes") {
+        const FileHash stale{std::byte{0xde}, std::byte{0xad}, std::byte{0xbe}, std::byte{0xef}};
+        fs::remove(txt);
+        resRepo.updateFileHash(txtId, stale);
+
+        CHECK(indexer.indexPending(10) == 1);
+        CHECK(indexRepo.getIndexedHash(txtId) == stale);
+        CHECK(indexer.indexPending(10) == 0);
+    }
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("ContentIndexer does not write into a transaction it failed to begin",
+          "[ContentIndexer]") {
+    SQLiteDB db(":memory:");
+    createIndexerSchema(db);
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    ContentIndexRepository indexRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+    ContentIndexer indexer(db, indexRepo, ContentIndexOptions{.extractThreads = 2});
+
+    const auto dir = fs::temp_directory_path() / "notes_index_begin";
+    fs::create_directories(dir);
+    std::vector<sqlite3_int64> ids;
+    for (const auto* name : {"a.txt", "b.txt"}) {
+        writeFile(dir / name, std::string("indexed outside the caller transaction ") + name);
+        ids.push_back(
+            fileService.addFileResource((dir / name).string(), name, ResourceType::text, false));
+    }
+
+    // BEGIN lồng trong transaction đang mở bị SQLite từ chối: phải báo lỗi, không được để
+    // COMMIT của lượt index commit luôn transaction của caller
+    REQUIRE(sqlite3_exec(db.get(), "BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    CHECK_THROWS_AS(indexer.indexPending(10), std::runtime_error);
+    CHECK(sqlite3_get_autocommit(db.get()) == 0);
+    for (const auto id : ids) { CHECK(indexRepo.chunkCount(id) == 0); }
+    REQUIRE(sqlite3_exec(db.get(), "ROLLBACK;", nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    CHECK(indexer.indexPending(10) == 2);
+    for (const auto id : ids) { CHECK(indexRepo.chunkCount(id) == 1); }
+
+    fs::remove_all(dir);
+}
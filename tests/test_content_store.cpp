@@ -0,0 +1,223 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <sqlite3.h>
+#include "content_store.hpp"
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "resource_repository.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    namespace fs = std::filesystem;
+
+    const std::string kHash = "abcdef0123456789abcdef0123456789abcdef0123456789abcdef0123456789";
+
+    fs::path makeStoreRoot(const std::string &name) {
+        auto root = fs::temp_directory_path() / name;
+        fs::remove_all(root);
+        fs::create_directories(root);
+        return root;
+    }
+
+    void writeFile(const fs::path &path, std::string_view content) {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << content;
+    }
+
+    // File managed có sẵn trong DB với stored_path đúng như đã ghi
+    sqlite3_int64 insertManaged(SQLiteDB &db, FileRepository &fileRepo,
+                                const std::string &storedPath) {
+        REQUIRE(sqlite3_exec(db.get(), "INSERT INTO resources (title, type) VALUES ('f', 1);",
+                             nullptr, nullptr, nullptr) == SQLITE_OK);
+        const auto id = sqlite3_last_insert_rowid(db.get());
+        fileRepo.insertFile(id, storedPath, "/original/" + storedPath, true);
+        return id;
+    }
+} // namespace
+
+TEST_CASE("ContentStore pathFor fans out by hash prefix", "[ContentStore]") {
+    SECTION("default layout is ab/cd/<hash><ext>") {
+        ContentStore store("store");
+        CHECK(store.pathFor(kHash, ".pdf") == fs::path("store") / "ab" / "cd" / (kHash + ".pdf"));
+    }
+
+    SECTION("levels = 0 keeps the flat layout") {
+        ContentStore store("store", {.levels = 0, .width = 2});
+        CHECK(store.pathFor(kHash, ".pdf") == fs::path("store") / (kHash + ".pdf"));
+    }
+
+    SECTION("custom width and depth") {
+        ContentStore store("store", {.levels = 1, .width = 3});
+        CHECK(store.pathFor(kHash, "") == fs::path("store") / "abc" / kHash);
+    }
+}
+
+TEST_CASE("ContentStore isContentName only accepts sha256 hex", "[ContentStore]") {
+    CHECK(ContentStore::isContentName(kHash));
+    CHECK_FALSE(ContentStore::isContentName("abc"));
+    CHECK_FALSE(ContentStore::isContentName(".import-123"));
+    CHECK_FALSE(ContentStore::isContentName(std::string(64, 'G')));
+}
+
+TEST_CASE("ContentStore commit publishes a hash once across threads", "[ContentStore]") {
+    auto root = makeStoreRoot("notes_store_commit");
+    ContentStore store(root);
+    const auto dest = store.pathFor(kHash, ".txt");
+
+    constexpr int kThreads{8};
+    std::vector<fs::path> temps;
+    for (int i = 0; i < kThreads; ++i) {
+        temps.push_back(store.makeTempPath());
+        writeFile(temps.back(), "same content");
+    }
+
+    std::atomic<int> created{0};
+    {
+        std::vector<std::jthread> threads;
+        for (const auto &temp : temps) {
+            threads.emplace_back([&] {
+                if (store.commit(temp, dest)) { created.fetch_add(1); }
+            });
+        }
+    }
+
+    // Đúng một thread tạo bản copy; file tạm của các thread còn lại vẫn nguyên cho caller xóa
+    CHECK(created.load() == 1);
+    CHECK(fs::file_size(dest) == std::string_view("same content").size());
+    const auto leftover = std::ranges::count_if(temps, [](const fs::path &temp) {
+        return fs::exists(temp);
+    });
+    CHECK(leftover == kThreads - 1);
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("ContentStore migrateFlat moves flat files into shards", "[ContentStore]") {
+    auto root = makeStoreRoot("notes_store_migrate");
+    ContentStore store(root);
+
+    writeFile(root / (kHash + ".txt"), "flat");
+    writeFile(root / "notes.txt", "not content-addressed");
+
+    auto moved = store.migrateFlat();
+
+    REQUIRE(moved.size() == 1);
+    CHECK(moved[0].from == root / (kHash + ".txt"));
+    CHECK(moved[0].to == store.pathFor(kHash, ".txt"));
+    CHECK(fs::exists(moved[0].to));
+    CHECK_FALSE(fs::exists(moved[0].from));
+    CHECK(fs::exists(root / "notes.txt"));
+
+    // Chạy lại không làm gì thêm
+    CHECK(store.migrateFlat().empty());
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("FileService uses ContentStore root and migrates stored_path", "[ContentStore]") {
+    SQLiteDB db(":memory:");
+    const char* schema = R"SQL(
+        CREATE TABLE resources (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL,
+            type INTEGER NOT NULL,
+            file_hash BLOB,
+            created_at INTEGER DEFAULT (unixepoch()),
+            updated_at INTEGER DEFAULT (unixepoch())
+        );
+
+        CREATE TABLE files (
+            resource_id INTEGER PRIMARY KEY,
+            stored_path TEXT,
+            original_path TEXT NOT NULL,
+            is_managed INTEGER NOT NULL DEFAULT 0
+        );
+    )SQL";
+    REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    FileService service(db, fileRepo, resRepo);
+
+    auto root = makeStoreRoot("notes_store_service");
+    auto src = fs::temp_directory_path() / "notes_store_src.cpp";
+    writeFile(src, "int main() {}");
+
+    SECTION("managed import lands in the configured sharded root") {
+        service.setContentStore(ContentStore(root));
+
+        auto id = service.addFileResource(src.string(), "Src", ResourceType::cpp, true);
+        auto entry = fileRepo.getFileById(id);
+
+        REQUIRE(entry.has_value());
+        const auto hash = fileHashToHex(FileService::computeFileHash(src.string()));
+        CHECK(fs::path(*entry->stored_path) == service.contentStore().pathFor(hash, ".cpp"));
+        CHECK(fs::exists(*entry->stored_path));
+    }
+
+    SECTION("migrateFlatStorage updates stored_path of flat entries") {
+        service.setContentStore(ContentStore(root, {.levels = 0, .width = 2}));
+        auto id = service.addFileResource(src.string(), "Src", ResourceType::cpp, true);
+        const auto flatPath = *fileRepo.getFileById(id)->stored_path;
+        REQUIRE(fs::path(flatPath).parent_path() == root);
+
+        service.setContentStore(ContentStore(root));
+        CHECK(service.migrateFlatStorage() == 1);
+
+        auto entry = fileRepo.getFileById(id);
+        REQUIRE(entry.has_value());
+        CHECK(*entry->stored_path != flatPath);
+        CHECK(fs::exists(*entry->stored_path));
+        CHECK_FALSE(fs::exists(flatPath));
+    }
+
+    SECTION("legacy relative stored_path is relinked under an absolute root") {
+        // Dòng cũ ghi "resources/<hash><ext>", root được chọn lại dưới dạng tuyệt đối
+        REQUIRE(root.is_absolute());
+        const auto name = kHash + ".txt";
+        writeFile(root / name, "legacy");
+        const auto id = insertManaged(db, fileRepo, "resources/" + name);
+
+        service.setContentStore(ContentStore(root));
+        CHECK(service.migrateFlatStorage() == 1);
+
+        const auto entry = fileRepo.getFileById(id);
+        REQUIRE(entry.has_value());
+        CHECK(fs::path(*entry->stored_path) == service.contentStore().pathFor(kHash, ".txt"));
+        CHECK(fs::exists(*entry->stored_path));
+        CHECK_FALSE(fs::exists(root / name));
+    }
+
+    SECTION("a failed move puts files and stored_path back") {
+        const std::string other(64, '0');
+        writeFile(root / (kHash + ".txt"), "first");
+        writeFile(root / (other + ".txt"), "second");
+        const auto first = insertManaged(db, fileRepo, "resources/" + kHash + ".txt");
+        const auto second = insertManaged(db, fileRepo, "resources/" + other + ".txt");
+
+        // Thư mục shard "ab" bị một file chiếm chỗ -> không tạo được đích của kHash
+        writeFile(root / "ab", "blocker");
+
+        service.setContentStore(ContentStore(root));
+        CHECK_THROWS(service.migrateFlatStorage());
+
+        CHECK(fs::exists(root / (kHash + ".txt")));
+        CHECK(fs::exists(root / (other + ".txt")));
+        for (const auto id : {first, second}) {
+            const auto entry = fileRepo.getFileById(id);
+            REQUIRE(entry.has_value());
+            CHECK(fs::path(*entry->stored_path).parent_path() == root);
+            CHECK(fs::exists(*entry->stored_path));
+        }
+    }
+
+    fs::remove(src);
+    fs::remove_all(root);
+}
@@ -0,0 +1,382 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+#include "content_index_repository.hpp"
+#include "content_indexer.hpp"
+#include "cpp_symbols.hpp"
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+#include "resource_repository.hpp"
+#include "resource_service.hpp"
+#include "schema_migrator.hpp"
+#include "sqldb_raii.hpp"
+#include "symbol_repository.hpp"
+#include "tag_repository.hpp"
+#include "text_content_repository.hpp"
+
+namespace {
+    namespace fs = std::filesystem;
+    using Strings = std::vector<std::string>;
+
+    // "kind name:line" cho từng ký hiệu
+    Strings describe(const std::vector<Symbol> &symbols) {
+        Strings out;
+        for (const auto &symbol : symbols) {
+            out.push_back(std::string(symbolKindToString(symbol.kind)) + " " + symbol.name + ":" +
+                          std::to_string(symbol.line));
+        }
+        return out;
+    }
+
+    Strings scan(std::string_view source) {
+        return describe(CppSymbolScanner::scan(source));
+    }
+
+    Strings only(const Strings &all, std::string_view kind) {
+        Strings out;
+        for (const auto &entry : all) {
+            if (entry.starts_with(std::string(kind) + " ")) { out.push_back(entry); }
+        }
+        return out;
+    }
+
+    void createSchema(SQLiteDB &db) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type TEXT NOT NULL,
+                file_hash TEXT UNIQUE,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                UNIQUE (title, type)
+            );
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0,
+                FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+            );
+
+            CREATE TABLE text_content (
+                resource_id INTEGER PRIMARY KEY,
+                content TEXT NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE text_content_fts USING fts5(content);
+
+            CREATE TABLE tags (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT UNIQUE NOT NULL);
+            CREATE TABLE resource_tags (resource_id INTEGER, tag_id INTEGER,
+                                        PRIMARY KEY (resource_id, tag_id));
+        )SQL";
+
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+        SchemaMigrator(db).migrate();
+    }
+
+    void writeFile(const fs::path &path, std::string_view content) {
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs << content;
+    }
+
+    constexpr std::string_view kRingBuffer = R"CPP(#include <vector>
+#include "ring_buffer.hpp"
+#define RING_CAPACITY 64
+#define RING_MAX(a, b) \
+    ((a) > (b) ? (a) : (b))
+
+namespace ds {
+    /* class NotAType { */
+    template <typename T> class RingBuffer : public BufferBase<T> {
+        public:
+            explicit RingBuffer(std::size_t capacity) : m_data(capacity), m_head{0} {
+                reset(capacity);
+            }
+            ~RingBuffer() override = default;
+
+            bool operator==(const RingBuffer &) const = default;
+            [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+            void push(const T &value);
+
+        private:
+            std::vector<T> m_data;
+            std::size_t m_head;
+    };
+
+    enum class Mode : std::uint8_t { overwrite, reject };
+    struct Stats;
+} // namespace ds
+
+template <typename T>
+void ds::RingBuffer<T>::push(const T &value) {
+    const auto text = R"(void fake() { call(); })";
+    std::string label("push(" + std::to_string(value) + ")");
+    if (full()) { return grow(m_data.size() * 2); }
+    m_data[m_head] = value; // notify(value);
+}
+
+auto makeBuffer(int n) -> ds::RingBuffer<int> {
+    return ds::RingBuffer<int>(static_cast<std::size_t>(n));
+}
+)CPP";
+} // namespace
+
+TEST_CASE("CppSymbolScanner finds definitions, includes and calls", "[CppSymbols]") {
+    const auto all = scan(kRingBuffer);
+
+    CHECK(only(all, "include") == Strings{"include vector:1", "include ring_buffer.hpp:2"});
+    CHECK(only(all, "macro") == Strings{"macro RING_CAPACITY:3", "macro RING_MAX:4"});
+    CHECK(only(all, "type") == Strings{"type RingBuffer:9", "type Mode:25"});
+    CHECK(only(all, "function") == Strings{"function RingBuffer:11", "function size:17",
+                                           "function push:30", "function makeBuffer:37"});
+    // Comment, string, raw string và init list không sinh lời gọi
+    CHECK(only(all, "call") == Strings{"call reset:12", "call to_string:32", "call full:33",
+                                       "call grow:33", "call size:33"});
+}
+
+TEST_CASE("CppSymbolScanner handles the awkward corners", "[CppSymbols]") {
+    SECTION("chunks may split anywhere, even inside a token") {
+        const auto whole = CppSymbolScanner::scan(kRingBuffer);
+        for (const std::size_t step : {1U, 7U, 64U}) {
+            CppSymbolScanner scanner;
+            for (std::size_t pos = 0; pos < kRingBuffer.size(); pos += step) {
+                scanner.push(kRingBuffer.substr(pos, step));
+            }
+            CHECK(scanner.finish() == whole);
+        }
+    }
+
+    SECTION("macro invocations with string arguments are not functions") {
+        const auto symbols = scan("TEST_CASE(\"ring\", \"[ds]\") {\n"
+                                  "    SECTION(\"push\") { CHECK(ring.push(1)); }\n"
+                                  "}\n");
+        CHECK(only(symbols, "function").empty());
+        CHECK(only(symbols, "call") == Strings{"call SECTION:2", "call CHECK:2", "call push:2"});
+    }
+
+    SECTION("operators, destructors, out-of-class members and multi-line heads") {
+        const auto symbols = scan("Foo::~Foo() {}\n"
+                                  "Foo &Foo::operator=(const Foo &) { return *this; }\n"
+                                  "auto Foo::operator()(int x) const -> int { return x; }\n"
+                                  "Foo::operator bool() const { return true; }\n"
+                                  "static int\n"
+                                  "parse(const char *text,\n"
+                                  "      int len)\n"
+                                  "{\n"
+                                  "    return 0;\n"
+                                  "}\n");
+        CHECK(only(symbols, "function") ==
+              Strings{"function ~Foo:1", "function operator=:2", "function operator():3",
+                      "function operator bool:4", "function parse:6"});
+    }
+
+    SECTION("declarations, forward declarations and variables are skipped") {
+        const auto symbols = scan("class Forward;\n"
+                                  "struct stat info;\n"
+                                  "int declared(int);\n"
+                                  "Widget() = delete;\n"
+                                  "int global(42);\n"
+                                  "enum class Small : int;\n"
+                                  "std::string name(\"x\");\n");
+        CHECK(symbols.empty());
+    }
+
+    SECTION("extern \"C\" blocks and nested namespaces keep their functions") {
+        const auto symbols = scan("namespace a::b { extern \"C\" {\n"
+                                  "int c_api(void) { return helper(); }\n"
+                                  "} }\n");
+        CHECK(symbols == Strings{"function c_api:2", "call helper:2"});
+    }
+}
+
+TEST_CASE("SymbolRepository stores and finds symbols", "[CppSymbols]") {
+    SQLiteDB db(":memory:");
+    createSchema(db);
+    REQUIRE(sqlite3_exec(db.get(),
+                         "INSERT INTO resources (id, title, type) VALUES (1, 'a.cpp', 1), "
+                         "(2, 'b.cpp', 1);",
+                         nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    SymbolRepository repo(db);
+    const std::vector<Symbol> first{{.kind = SymbolKind::type, .name = "Widget", .line = 3},
+                                    {.kind = SymbolKind::function, .name = "draw", .line = 9},
+                                    {.kind = SymbolKind::call, .name = "draw", .line = 20},
+                                    {.kind = SymbolKind::call, .name = "draw", .line = 20}};
+    repo.replaceSymbols(1, first);
+    repo.replaceSymbols(2, std::vector<Symbol>{
+                               {.kind = SymbolKind::macro, .name = "draw", .line = 1},
+                               {.kind = SymbolKind::include, .name = "widget.hpp", .line = 2}});
+
+    CHECK(repo.symbolsOf(1).size() == 3);
+    CHECK(describe(repo.findDefinitions("draw")) == Strings{"function draw:9", "macro draw:1"});
+    CHECK(repo.findDefinitions("draw")[1].resource_id == 2);
+    CHECK(describe(repo.findSymbols("draw", SymbolKind::call)) == Strings{"call draw:20"});
+    CHECK(repo.findSymbols("widget.hpp", SymbolKind::include).front().resource_id == 2);
+    CHECK(repo.findDefinitions("Draw").empty());
+
+    repo.replaceSymbols(1, std::vector<Symbol>{{.kind = SymbolKind::function, .name = "paint"}});
+    CHECK(describe(repo.symbolsOf(1)) == Strings{"function paint:1"});
+
+    // Xóa resource kéo theo ký hiệu
+    REQUIRE(sqlite3_exec(db.get(), "DELETE FROM resources WHERE id = 2;", nullptr, nullptr,
+                         nullptr) == SQLITE_OK);
+    CHECK(repo.findDefinitions("draw").empty());
+}
+
+TEST_CASE("ContentIndexer keeps symbols of cpp files current", "[CppSymbols][ContentIndexer]") {
+    SQLiteDB db(":memory:");
+    createSchema(db);
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    TextContentRepository textRepo(db);
+    TagRepository tagRepo(db);
+    ContentIndexRepository indexRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+    ResourceService resService(db, resRepo, fileRepo, textRepo, tagRepo, fileService, &indexRepo);
+    SymbolRepository symbolRepo(db);
+
+    ContentIndexer indexer(db, indexRepo,
+                           ContentIndexOptions{.chunkSize = 256, .extractThreads = 3});
+
+    const auto dir = fs::temp_directory_path() / "notes_cpp_symbols";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    const auto ring = dir / "ring_buffer.hpp";
+    writeFile(ring, kRingBuffer);
+    const auto main = dir / "main.cpp";
+    writeFile(main, "#include \"ring_buffer.hpp\"\nint main() { return makeBuffer(4).size(); }\n");
+    const auto txt = dir / "notes.txt";
+    writeFile(txt, "class NotCode { void f() {} };\n");
+
+    const auto ringId =
+        fileService.addFileResource(ring.string(), "ring_buffer", ResourceType::cpp, false);
+    const auto mainId =
+        fileService.addFileResource(main.string(), "main", ResourceType::cpp, false);
+    const auto txtId = fileService.addFileResource(txt.string(), "notes", ResourceType::text,
+                                                   false);
+
+    CHECK(indexer.indexPending(10) == 3);
+    CHECK(symbolRepo.symbolsOf(txtId).empty());
+
+    const auto defs = resService.findDefinitions("ds::RingBuffer");
+    REQUIRE(defs.size() == 2);
+    CHECK(defs[0].resource_id == ringId);
+    CHECK(defs[0].snippet == "type RingBuffer");
+    CHECK(defs[0].line == 9);
+    CHECK(defs[1].snippet == "function RingBuffer");
+
+    const auto callers = symbolRepo.findSymbols("makeBuffer", SymbolKind::call);
+    REQUIRE(callers.size() == 1);
+    CHECK(callers[0].resource_id == mainId);
+    CHECK(symbolRepo.findSymbols("ring_buffer.hpp", SymbolKind::include).size() == 2);
+
+    SECTION("sequential indexing finds the same symbols as the workers") {
+        const auto parallel = symbolRepo.symbolsOf(ringId);
+        ContentIndexer sequential(db, indexRepo,
+                                  ContentIndexOptions{.chunkSize = 256, .extractThreads = 1});
+        sequential.indexFile({.resource_id = ringId,
+                              .type = ResourceType::cpp,
+                              .path = ring.string(),
+                              .file_hash = FileService::computeFileHash(ring.string())});
+        CHECK(symbolRepo.symbolsOf(ringId) == parallel);
+    }
+
+    SECTION("changed file replaces its symbols") {
+        writeFile(ring, "\n\nstruct Deque {};\n");
+        resRepo.updateFileHash(ringId, FileService::computeFileHash(ring.string()));
+
+        CHECK(indexer.indexPending(10) == 1);
+        CHECK(resService.findDefinitions("RingBuffer").empty());
+        REQUIRE(resService.findDefinitions("Deque").size() == 1);
+        CHECK(resService.findDefinitions("Deque")[0].line == 3);
+    }
+
+    SECTION("unreadable file drops its symbols") {
+        fs::remove(ring);
+        resRepo.updateFileHash(ringId, FileHash{std::byte{0x01}});
+
+        CHECK(indexer.indexPending(10) == 1);
+        CHECK(symbolRepo.symbolsOf(ringId).empty());
+    }
+
+    SECTION("deleting the resource drops its symbols") {
+        resService.deleteResource(mainId);
+        CHECK(symbolRepo.findSymbols("makeBuffer", SymbolKind::call).empty());
+    }
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("Schema v12 re-indexes cpp files for symbols", "[CppSymbols][SchemaMigrator]") {
+    SQLiteDB db(":memory:");
+    REQUIRE(sqlite3_exec(db.get(), R"SQL(
+        CREATE TABLE resources (id INTEGER PRIMARY KEY, title TEXT NOT NULL, type INTEGER);
+        CREATE TABLE file_index_state (resource_id INTEGER PRIMARY KEY, indexed_hash BLOB);
+        INSERT INTO resources (id, title, type) VALUES (1, 'a.cpp', 1), (2, 'b.txt', 0);
+        INSERT INTO file_index_state (resource_id, indexed_hash) VALUES (1, x'01'), (2, x'02');
+        PRAGMA user_version = 11;
+    )SQL", nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    REQUIRE(SchemaMigrator(db).migrate() == SchemaMigrator::kCurrentVersion - 11);
+
+    SQLiteStmt stmt(db.get(), "SELECT resource_id FROM file_index_state;");
+    REQUIRE(sqlite3_step(stmt.get()) == SQLITE_ROW);
+    CHECK(sqlite3_column_int64(stmt.get(), 0) == 2);
+    CHECK(sqlite3_step(stmt.get()) == SQLITE_DONE);
+
+    SymbolRepository repo(db);
+    CHECK(repo.findDefinitions("anything").empty());
+}
+
+TEST_CASE("Definition lookup stays fast", "[CppSymbols][.benchmark]") {
+    SQLiteDB db(":memory:");
+    createSchema(db);
+
+    // 2000 file, mỗi file ~50 ký hiệu
+    std::string source;
+    for (int i = 0; i < 10; ++i) {
+        const auto id = std::to_string(i);
+        source += "#include \"dep" + id + ".hpp\"\nclass Widget" + id + " {\n"
+                  "    void draw" + id + "() { paint(); layout(); }\n};\n"
+                  "int helper" + id + "(int x) { return compute(x) + other(x); }\n";
+    }
+
+    std::size_t symbols{};
+    const auto start = std::chrono::steady_clock::now();
+    SymbolRepository repo(db);
+    REQUIRE(sqlite3_exec(db.get(), "BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    for (int file = 1; file <= 2000; ++file) {
+        SQLiteStmt insert(db.get(), "INSERT INTO resources (id, title, type) VALUES (?, ?, 1);");
+        sqlite3_bind_int(insert.get(), 1, file);
+        sqlite3_bind_text(insert.get(), 2, ("f" + std::to_string(file)).c_str(), -1,
+                          SQLITE_TRANSIENT);
+        REQUIRE(sqlite3_step(insert.get()) == SQLITE_DONE);
+
+        const auto found = CppSymbolScanner::scan(source);
+        symbols += found.size();
+        repo.replaceSymbols(file, found);
+    }
+    REQUIRE(sqlite3_exec(db.get(), "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    WARN(symbols << " symbols from 2000 files indexed in " << elapsed.count() << " s");
+
+    CHECK(repo.findDefinitions("Widget7", 5000).size() == 2000);
+
+    BENCHMARK("where is helper3 defined") { return repo.findDefinitions("helper3", 10); };
+    BENCHMARK("who calls compute") {
+        return repo.findSymbols("compute", SymbolKind::call, 10);
+    };
+    BENCHMARK("scan one file") { return CppSymbolScanner::scan(source); };
+}
@@ -0,0 +1,301 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include <zlib.h>
+#include "content_index_repository.hpp"
+#include "content_indexer.hpp"
+#include "epub_extractor.hpp"
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "markup_text.hpp"
+#include "model.hpp"
+#include "resource_repository.hpp"
+#include "schema_migrator.hpp"
+#include "sqldb_raii.hpp"
+#include "zip_archive.hpp"
+
+namespace {
+    namespace fs = std::filesystem;
+
+    struct ZipItem {
+            std::string name;
+            std::string data;
+            bool deflate{true};
+    };
+
+    void putU16(std::string &out, std::uint32_t v) {
+        out += static_cast<char>(v & 0xFFU);
+        out += static_cast<char>((v >> 8U) & 0xFFU);
+    }
+
+    void putU32(std::string &out, std::uint32_t v) {
+        putU16(out, v & 0xFFFFU);
+        putU16(out, v >> 16U);
+    }
+
+    std::string rawDeflate(const std::string &data) {
+        z_stream zs{};
+        REQUIRE(deflateInit2(&zs, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                             Z_DEFAULT_STRATEGY) == Z_OK);
+
+        std::string out(deflateBound(&zs, static_cast<uLong>(data.size())), '\0');
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        zs.avail_in = static_cast<uInt>(data.size());
+        zs.next_out = reinterpret_cast<Bytef*>(out.data());
+        zs.avail_out = static_cast<uInt>(out.size());
+
+        REQUIRE(deflate(&zs, Z_FINISH) == Z_STREAM_END);
+        out.resize(zs.total_out);
+        deflateEnd(&zs);
+        return out;
+    }
+
+    // Ghi ZIP tối giản (không ZIP64, không data descriptor) cho test
+    void writeZip(const fs::path &path, const std::vector<ZipItem> &items) {
+        std::string body;
+        std::string directory;
+
+        for (const auto &item : items) {
+            const auto payload = item.deflate ? rawDeflate(item.data) : item.data;
+            const auto crc = static_cast<std::uint32_t>(
+                crc32(0, reinterpret_cast<const Bytef*>(item.data.data()),
+                      static_cast<uInt>(item.data.size())));
+            const auto method = item.deflate ? 8U : 0U;
+            const auto offset = static_cast<std::uint32_t>(body.size());
+
+            putU32(body, 0x04034b50);
+            putU16(body, 20);
+            putU16(body, 0);
+            putU16(body, method);
+            putU32(body, 0); // thời gian
+            putU32(body, crc);
+            putU32(body, static_cast<std::uint32_t>(payload.size()));
+            putU32(body, static_cast<std::uint32_t>(item.data.size()));
+            putU16(body, static_cast<std::uint32_t>(item.name.size()));
+            putU16(body, 0);
+            body += item.name;
+            body += payload;
+
+            putU32(directory, 0x02014b50);
+            putU16(directory, 20);
+            putU16(directory, 20);
+            putU16(directory, 0);
+            putU16(directory, method);
+            putU32(directory, 0);
+            putU32(directory, crc);
+            putU32(directory, static_cast<std::uint32_t>(payload.size()));
+            putU32(directory, static_cast<std::uint32_t>(item.data.size()));
+            putU16(directory, static_cast<std::uint32_t>(item.name.size()));
+            putU16(directory, 0);
+            putU16(directory, 0);
+            putU16(directory, 0);
+            putU16(directory, 0);
+            putU32(directory, 0);
+            putU32(directory, offset);
+            directory += item.name;
+        }
+
+        std::string eocd;
+        putU32(eocd, 0x06054b50);
+        putU16(eocd, 0);
+        putU16(eocd, 0);
+        putU16(eocd, static_cast<std::uint32_t>(items.size()));
+        putU16(eocd, static_cast<std::uint32_t>(items.size()));
+        putU32(eocd, static_cast<std::uint32_t>(directory.size()));
+        putU32(eocd, static_cast<std::uint32_t>(body.size()));
+        putU16(eocd, 0);
+
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs << body << directory << eocd;
+    }
+
+    std::string chapter(const std::string &title, const std::string &body) {
+        return R"(<?xml version="1.0" encoding="utf-8"?>
+<!DOCTYPE html>
+<html xmlns="http://www.w3.org/1999/xhtml"><head><title>ignored head</title>
+<style>p { color: red; }</style></head>
+<body><h1>)" + title + "</h1>\n<p>" + body + "</p></body></html>";
+    }
+
+    // EPUB mẫu: spine đảo thứ tự so với tên file để kiểm tra đọc theo spine
+    void writeSampleEpub(const fs::path &path, const std::string &longText = {}) {
+        const std::string container = R"(<?xml version="1.0"?>
+<container version="1.0" xmlns="urn:oasis:names:tc:opendocument:xmlns:container">
+  <rootfiles>
+    <rootfile full-path="OEBPS/content.opf" media-type="application/oebps-package+xml"/>
+  </rootfiles>
+</container>)";
+
+        const std::string opf = R"(<?xml version="1.0"?>
+<package xmlns="http://www.idpf.org/2007/opf" version="3.0">
+  <manifest>
+    <item id="c1" href="text/ch%201.xhtml" media-type="application/xhtml+xml"/>
+    <item id="c2" href="./text/ch2.xhtml#start" media-type="application/xhtml+xml"/>
+    <item id="css" href="style.css" media-type="text/css"/>
+  </manifest>
+  <spine>
+    <itemref idref="c2"/>
+    <itemref idref="c1"/>
+    <itemref idref="css"/>
+  </spine>
+</package>)";
+
+        writeZip(path, {
+            {"mimetype", "application/epub+zip", false},
+            {"META-INF/container.xml", container},
+            {"OEBPS/content.opf", opf},
+            {"OEBPS/text/ch 1.xhtml", chapter("Second", "Ownership &amp; borrowing" + longText)},
+            {"OEBPS/text/ch2.xhtml", chapter("First", "Zero&#45;cost &lt;abstractions&gt;")},
+            {"OEBPS/style.css", "p { color: blue; }"},
+        });
+    }
+
+    std::string scan(const std::vector<std::string> &pieces) {
+        std::string out;
+        MarkupTextScanner scanner([&](std::string_view text) { out += text; });
+        for (const auto &piece : pieces) { scanner.feed(piece); }
+        scanner.finish();
+        return out;
+    }
+} // namespace
+
+TEST_CASE("MarkupTextScanner strips markup regardless of how input is split", "[EpubExtractor]") {
+    const std::string html =
+        "<html><head><title>T</title></head><body><!-- note -> still comment -->"
+        "<p class=\"a>b\">Hello&nbsp;<b>wor</b>ld &amp; caf&#xE9;</p>"
+        "<script>if (a < b) {}</script><div>x  \n  y &unknown; &#0;</div></body></html>";
+
+    const std::string expected = "Hello world & café\nx y &unknown;\n";
+    CHECK(scan({html}) == expected);
+
+    std::vector<std::string> bytes;
+    for (const char c : html) { bytes.emplace_back(1, c); }
+    CHECK(scan(bytes) == expected);
+}
+
+TEST_CASE("ZipArchive reads stored and deflated entries in blocks", "[EpubExtractor]") {
+    const auto path = fs::temp_directory_path() / "notes_zip_test.zip";
+
+    std::string big;
+    while (big.size() < 3 * ZipArchive::kBlockSize) {
+        big += "block of text " + std::to_string(big.size());
+    }
+    writeZip(path, {{"stored.txt", "plain", false}, {"big.txt", big, true}});
+
+    ZipArchive zip(path);
+    REQUIRE(zip.entries().size() == 2);
+    REQUIRE(zip.find("stored.txt") != nullptr);
+    CHECK(zip.find("missing.txt") == nullptr);
+
+    CHECK(zip.readEntryToString(*zip.find("stored.txt"), 100) == "plain");
+
+    std::size_t blocks{0};
+    std::string inflated;
+    zip.readEntry(*zip.find("big.txt"), [&](std::string_view block) {
+        CHECK(block.size() <= ZipArchive::kBlockSize);
+        inflated += block;
+        ++blocks;
+    });
+    CHECK(inflated == big);
+    CHECK(blocks > 1);
+
+    // Giới hạn kích thước giải nén chặn zip bomb
+    CHECK_THROWS_AS(zip.readEntryToString(*zip.find("big.txt"), 1024), std::runtime_error);
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a zip at all, just text";
+    CHECK_THROWS_AS(ZipArchive(path), std::runtime_error);
+
+    fs::remove(path);
+}
+
+TEST_CASE("EpubExtractor follows the OPF spine", "[EpubExtractor]") {
+    const auto path = fs::temp_directory_path() / "notes_epub_test.epub";
+    writeSampleEpub(path);
+
+    EpubExtractor epub(path);
+    REQUIRE(epub.spine().size() == 2);
+    CHECK(epub.spine()[0] == "OEBPS/text/ch2.xhtml");
+    CHECK(epub.spine()[1] == "OEBPS/text/ch 1.xhtml");
+
+    std::string text;
+    epub.extractText([&](std::string_view piece) { text += piece; });
+
+    CHECK(text == "First\nZero-cost <abstractions>\n\n\nSecond\nOwnership & borrowing\n");
+    CHECK(text.find("ignored head") == std::string::npos);
+    CHECK(text.find("color") == std::string::npos);
+
+    fs::remove(path);
+}
+
+TEST_CASE("ContentIndexer indexes EPUB books in parallel", "[EpubExtractor]") {
+    SQLiteDB db(":memory:");
+    const char* schema = R"SQL(
+        CREATE TABLE resources (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL,
+            type TEXT NOT NULL,
+            file_hash TEXT UNIQUE,
+            created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+            updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+            UNIQUE (title, type)
+        );
+
+        CREATE TABLE files (
+            resource_id INTEGER PRIMARY KEY,
+            stored_path TEXT,
+            original_path TEXT NOT NULL,
+            is_managed INTEGER NOT NULL DEFAULT 0,
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+    )SQL";
+    REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+    SchemaMigrator(db).migrate();
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    ContentIndexRepository indexRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+    ContentIndexer indexer(db, indexRepo,
+                           ContentIndexOptions{.chunkSize = 256, .extractThreads = 3,
+                                               .queueCapacity = 2});
+
+    const auto dir = fs::temp_directory_path() / "notes_epub_index";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    std::vector<sqlite3_int64> ids;
+    for (int i = 0; i < 4; ++i) {
+        const auto path = dir / ("book" + std::to_string(i) + ".epub");
+        std::string filler;
+        for (int n = 0; n < 100; ++n) { filler += " lifetime" + std::to_string(i * 1000 + n); }
+        writeSampleEpub(path, filler);
+        ids.push_back(fileService.addFileResource(path.string(), "book" + std::to_string(i),
+                                                  ResourceType::epub, false));
+    }
+
+    const auto broken = dir / "broken.epub";
+    std::ofstream(broken, std::ios::binary) << "PK but not really";
+    const auto brokenId =
+        fileService.addFileResource(broken.string(), "broken", ResourceType::epub, false);
+
+    CHECK(indexer.indexPending(10) == 5);
+    CHECK(indexer.indexPending(10) == 0);
+
+    for (const auto id : ids) { CHECK(indexRepo.chunkCount(id) > 1); }
+    CHECK(indexRepo.chunkCount(brokenId) == 0);
+    CHECK(indexRepo.getIndexedHash(brokenId).has_value());
+
+    const auto hits = indexRepo.searchFileContentFTS("lifetime2042");
+    REQUIRE(hits.size() == 1);
+    CHECK(hits.front().first == ids[2]);
+
+    CHECK(indexRepo.searchFileContentFTS("borrowing").size() == 4);
+    CHECK(indexRepo.searchFileContentFTS("color").empty());
+
+    fs::remove_all(dir);
+}
@@ -17,10 +17,10 @@ namespace {
                 CREATE TABLE resources (
                     id INTEGER PRIMARY KEY AUTOINCREMENT,
                     title TEXT NOT NULL,
-                    type TEXT NOT NULL,
-                    file_hash TEXT,
-                    created_at TEXT DEFAULT CURRENT_TIMESTAMP,
-                    updated_at TEXT DEFAULT CURRENT_TIMESTAMP
+                    type INTEGER NOT NULL,
+                    file_hash BLOB,
+                    created_at INTEGER DEFAULT (unixepoch()),
+                    updated_at INTEGER DEFAULT (unixepoch())
                 );
 
                 -- files table: dùng cả original_path và stored_path (tên thường thấy trong mã)
@@ -71,6 +71,8 @@ TEST_CASE("FileService::computeFileHash produces deterministic value", "[FileSer
     auto hash2 = FileService::computeFileHash(file);
 
     CHECK(hash1 == hash2); // cùng nội dung → hash trùng
+    CHECK(fileHashToHex(hash1) ==
+          "2cf24dba5fb0a30e26e83b2ac5b9e29e1b161e5c1fa7425e73043362938b9824");
 
     auto diffFile = createTempFile("hash2.txt", "world");
     auto hash3 = FileService::computeFileHash(diffFile);
@@ -126,11 +128,11 @@ TEST_CASE("FileService::findResourceByFile finds by existing hash", "[FileServic
     auto hash = FileService::computeFileHash(file);
 
     // chèn resource có file_hash = hash
-    sqlite3_exec(
-        db.get(),
-        ("INSERT INTO resources (title, type, file_hash) VALUES ('A','pdf','" + hash + "');")
-            .c_str(),
-        nullptr, nullptr, nullptr);
+    sqlite3_exec(db.get(),
+                 ("INSERT INTO resources (title, type, file_hash) VALUES ('A',2,X'" +
+                  fileHashToHex(hash) + "');")
+                     .c_str(),
+                 nullptr, nullptr, nullptr);
 
     // gọi hàm: trả về optional<sqlite3_int64>
     auto idOpt = service.findResourceByFile(file);
@@ -157,7 +159,7 @@ TEST_CASE("FileService::refreshFileHash updates existing resource", "[FileServic
 
     // Tạo resource ID = 1
     sqlite3_exec(db.get(),
-                 "INSERT INTO resources (id, title, type, file_hash) VALUES (1,'Old','pdf','123');",
+                 "INSERT INTO resources (id, title, type, file_hash) VALUES (1,'Old',2,X'0123');",
                  nullptr, nullptr, nullptr);
 
     // Tạo file thật và insert dòng vào bảng files để mô phỏng file đã lưu
@@ -175,9 +177,49 @@ TEST_CASE("FileService::refreshFileHash updates existing resource", "[FileServic
     REQUIRE(sqlite3_prepare_v2(db.get(), "SELECT file_hash FROM resources WHERE id=1;", -1, &stmt,
                                nullptr) == SQLITE_OK);
     REQUIRE(sqlite3_step(stmt) == SQLITE_ROW);
-    const auto* hash = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-    CHECK_FALSE(std::string(hash).empty());
+    const void* hash = sqlite3_column_blob(stmt, 0);
+    CHECK(fileHashFromBlob(hash, sqlite3_column_bytes(stmt, 0)) ==
+          FileService::computeFileHash(file));
     sqlite3_finalize(stmt);
 
     std::filesystem::remove(file);
 }
+
+// ------------------------------------------------------------
+// Test group: addFileResource (managed, hash + copy một lượt)
+// ------------------------------------------------------------
+TEST_CASE("FileService::addFileResource managed copies file named by hash", "[FileService]") {
+    namespace fs = std::filesystem;
+
+    SQLiteDB db(":memory:");
+    createMinimalFileServiceSchema(db.get());
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    FileService service(db, fileRepo, resRepo);
+
+    auto file = createTempFile("managed.cpp", "int managed();");
+    const auto expectedHash = FileService::computeFileHash(file);
+
+    auto id = service.addFileResource(file, "Managed", ResourceType::cpp, true);
+
+    auto entry = fileRepo.getFileById(id);
+    REQUIRE(entry.has_value());
+    REQUIRE(entry->stored_path.has_value());
+
+    const fs::path stored = *entry->stored_path;
+    CHECK(stored.filename() == fileHashToHex(expectedHash) + ".cpp");
+    CHECK(FileService::computeFileHash(stored) == expectedHash);
+
+    // Không còn file tạm sót lại trong storage
+    for (const auto &item : fs::directory_iterator(stored.parent_path())) {
+        CHECK_FALSE(item.path().extension() == ".tmp");
+    }
+
+    // Cùng nội dung -> tái sử dụng resource, không tạo thêm file tạm
+    auto again = service.addFileResource(file, "Managed again", ResourceType::cpp, true);
+    CHECK(again == id);
+
+    fs::remove(stored);
+    fs::remove(file);
+}
@@ -0,0 +1,309 @@
+#include <catch2/catch_test_macros.hpp>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sqlite3.h>
+#include "bounded_queue.hpp"
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "import_pipeline.hpp"
+#include "resource_repository.hpp"
+#include "content_store.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    namespace fs = std::filesystem;
+
+    void createImportSchema(sqlite3* db) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type INTEGER NOT NULL,
+                file_hash BLOB UNIQUE,
+                created_at INTEGER DEFAULT (unixepoch()),
+                updated_at INTEGER DEFAULT (unixepoch()),
+                UNIQUE (title, type)
+            );
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0
+            );
+        )SQL";
+
+        REQUIRE(sqlite3_exec(db, schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+    }
+
+    void writeFile(const fs::path &path, std::string_view content) {
+        fs::create_directories(path.parent_path());
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << content;
+    }
+
+    int countRows(sqlite3* db, const char* table) {
+        SQLiteStmt stmt(db, std::string("SELECT COUNT(*) FROM ") + table + ";");
+        REQUIRE(sqlite3_step(stmt.get()) == SQLITE_ROW);
+        return sqlite3_column_int(stmt.get(), 0);
+    }
+} // namespace
+
+TEST_CASE("BoundedQueue keeps FIFO order and reports full/empty", "[BoundedQueue]") {
+    BoundedQueue<int> queue(4);
+    REQUIRE(queue.capacity() == 4);
+
+    for (int i = 0; i < 4; ++i) {
+        int v = i;
+        REQUIRE(queue.tryPush(v));
+    }
+
+    int extra = 99; // NOLINT(readability-magic-numbers)
+    CHECK_FALSE(queue.tryPush(extra));
+
+    for (int i = 0; i < 4; ++i) {
+        int out{};
+        REQUIRE(queue.tryPop(out));
+        CHECK(out == i);
+    }
+
+    int out{};
+    CHECK_FALSE(queue.tryPop(out));
+}
+
+TEST_CASE("BoundedQueue pop with a deadline stops waiting on an open empty queue",
+          "[BoundedQueue]") {
+    BoundedQueue<int> queue(4);
+    const std::atomic<bool> cancelled{false};
+    const auto wait = std::chrono::milliseconds(20);
+
+    int out{};
+    const auto start = std::chrono::steady_clock::now();
+    CHECK_FALSE(queue.pop(out, cancelled, start + wait));
+    CHECK(std::chrono::steady_clock::now() - start >= wait);
+    CHECK_FALSE(queue.isClosed());
+
+    // Có phần tử thì trả về ngay kể cả khi đã quá hạn
+    int v = 7; // NOLINT(readability-magic-numbers)
+    REQUIRE(queue.tryPush(v));
+    CHECK(queue.pop(out, cancelled, start));
+    CHECK(out == 7);
+}
+
+TEST_CASE("BoundedQueue delivers every item across producers and consumers", "[BoundedQueue]") {
+    constexpr int kProducers{4};
+    constexpr int kPerProducer{5000};
+
+    BoundedQueue<int> queue(64); // NOLINT(readability-magic-numbers)
+    std::atomic<bool> cancelled{false};
+    std::atomic<long long> sum{0};
+    std::atomic<int> count{0};
+    std::atomic<int> activeProducers{kProducers};
+    std::atomic<int> rejected{0};
+
+    {
+        std::vector<std::jthread> threads;
+        for (int p = 0; p < kProducers; ++p) {
+            threads.emplace_back([&, p] {
+                for (int i = 0; i < kPerProducer; ++i) {
+                    if (!queue.push(p * kPerProducer + i, cancelled)) { ++rejected; }
+                }
+                if (activeProducers.fetch_sub(1) == 1) { queue.close(); }
+            });
+        }
+        for (int c = 0; c < 3; ++c) {
+            threads.emplace_back([&] {
+                int v{};
+                while (queue.pop(v, cancelled)) {
+                    sum += v;
+                    ++count;
+                }
+            });
+        }
+    }
+
+    constexpr long long total = static_cast<long long>(kProducers) * kPerProducer;
+    CHECK(rejected == 0);
+    CHECK(count == total);
+    CHECK(sum == total * (total - 1) / 2);
+}
+
+TEST_CASE("ImportPipeline imports a directory tree with dedupe", "[ImportPipeline]") {
+    SQLiteDB db(":memory:");
+    createImportSchema(db.get());
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+
+    const auto root = fs::temp_directory_path() / "notes_import_tree";
+    fs::remove_all(root);
+    writeFile(root / "a.cpp", "int a();");
+    writeFile(root / "sub" / "b.pdf", "%PDF-b");
+    writeFile(root / "sub" / "deep" / "a.cpp", "int other_a();"); // trùng tiêu đề
+    writeFile(root / "copy_of_a.cpp", "int a();");                // trùng nội dung
+    writeFile(root / "notes.xyz", "unsupported");
+
+    std::atomic<int> reports{0};
+    ImportProgress last;
+
+    ImportPipeline pipeline(db, fileService, resRepo,
+                            {.root = root, .isManaged = false, .hashThreads = 2,
+                             .queueCapacity = 2, .batchSize = 2},
+                            [&](const ImportProgress &p) {
+                                ++reports;
+                                last = p;
+                            });
+    pipeline.start();
+    pipeline.wait();
+
+    REQUIRE(reports > 0);
+    CHECK(last.finished);
+    CHECK_FALSE(last.cancelled);
+    CHECK(last.scanFinished);
+    CHECK(last.scanned.items == 4);
+    CHECK(last.hashed.items == 4);
+    CHECK(last.written.items == 3);
+    CHECK(last.duplicates == 1);
+    CHECK(last.skipped == 1);
+    CHECK(last.failed == 0);
+
+    CHECK(countRows(db.get(), "resources") == 3);
+    CHECK(countRows(db.get(), "files") == 3);
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("ImportPipeline cancel stops without leaving an open transaction", "[ImportPipeline]") {
+    SQLiteDB db(":memory:");
+    createImportSchema(db.get());
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+
+    const auto root = fs::temp_directory_path() / "notes_import_cancel";
+    fs::remove_all(root);
+    for (int i = 0; i < 200; ++i) { // NOLINT(readability-magic-numbers)
+        writeFile(root / ("f" + std::to_string(i) + ".cpp"), "int f" + std::to_string(i) + ";");
+    }
+
+    ImportPipeline pipeline(db, fileService, resRepo, {.root = root, .hashThreads = 2});
+    pipeline.pause();
+    pipeline.start();
+    CHECK(pipeline.isPaused());
+
+    pipeline.cancel();
+    pipeline.wait();
+
+    CHECK_FALSE(pipeline.isRunning());
+    CHECK(pipeline.snapshot().cancelled);
+    CHECK(sqlite3_get_autocommit(db.get()) != 0);
+
+    fs::remove_all(root);
+}
+
+TEST_CASE("ImportPipeline cancelled mid-import leaves no stray copies in the store",
+          "[ImportPipeline]") {
+    SQLiteDB db(":memory:");
+    createImportSchema(db.get());
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+
+    const auto root = fs::temp_directory_path() / "notes_import_cancel_managed";
+    const auto store = fs::temp_directory_path() / "notes_import_cancel_store";
+    fs::remove_all(root);
+    fs::remove_all(store);
+    fileService.setContentStore(ContentStore(store));
+    for (int i = 0; i < 300; ++i) { // NOLINT(readability-magic-numbers)
+        writeFile(root / ("f" + std::to_string(i) + ".cpp"), "int f" + std::to_string(i) + ";");
+    }
+
+    // Hủy từ thread ghi DB khi đã ghi được vài file: lúc đó các thread hash còn đang copy
+    ImportPipeline* running{nullptr};
+    ImportPipeline pipeline(db, fileService, resRepo,
+                            {.root = root, .isManaged = true, .hashThreads = 4,
+                             .queueCapacity = 4, .batchSize = 4,
+                             .reportInterval = std::chrono::milliseconds(0)},
+                            [&](const ImportProgress &p) {
+                                if (p.written.items >= 10) { running->cancel(); }
+                            });
+    running = &pipeline;
+    pipeline.start();
+    pipeline.wait();
+
+    const auto last = pipeline.snapshot();
+    CHECK(last.cancelled);
+    CHECK(last.written.items < 300);
+
+    // Mọi file trong store đều là stored_path của một dòng files, không còn file tạm
+    std::set<fs::path> referenced;
+    SQLiteStmt stmt(db.get(), "SELECT stored_path FROM files;");
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        referenced.emplace(reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0)));
+    }
+    std::set<fs::path> stored;
+    for (const auto &entry : fs::recursive_directory_iterator(store)) {
+        if (entry.is_regular_file()) { stored.insert(entry.path()); }
+    }
+    CHECK(stored == referenced);
+    CHECK(referenced.size() == static_cast<std::size_t>(countRows(db.get(), "files")));
+
+    fs::remove_all(root);
+    fs::remove_all(store);
+}
+
+TEST_CASE("ImportPipeline keeps the shared copy of identical managed files", "[ImportPipeline]") {
+    SQLiteDB db(":memory:");
+    createImportSchema(db.get());
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+
+    const auto root = fs::temp_directory_path() / "notes_import_identical";
+    const auto store = fs::temp_directory_path() / "notes_import_identical_store";
+    fs::remove_all(root);
+    fs::remove_all(store);
+    fileService.setContentStore(ContentStore(store));
+
+    // Hai file cùng nội dung nằm cạnh nhau nên được hash cùng lúc, cùng copy vào một <hash><ext>
+    constexpr int kPairs{100};
+    for (int i = 0; i < kPairs; ++i) {
+        const auto dir = root / ("d" + std::to_string(i));
+        const auto content = "int f" + std::to_string(i) + ";";
+        writeFile(dir / "a.cpp", content);
+        writeFile(dir / "b.cpp", content);
+    }
+
+    ImportPipeline pipeline(db, fileService, resRepo,
+                            {.root = root, .isManaged = true, .hashThreads = 4,
+                             .queueCapacity = 4, .batchSize = 8});
+    pipeline.start();
+    pipeline.wait();
+
+    const auto last = pipeline.snapshot();
+    CHECK(last.written.items == kPairs);
+    CHECK(last.duplicates == kPairs);
+    CHECK(last.failed == 0);
+
+    int files{0};
+    SQLiteStmt stmt(db.get(), "SELECT stored_path FROM files;");
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        const auto* storedPath = reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+        CHECK(fs::exists(storedPath));
+        ++files;
+    }
+    CHECK(files == kPairs);
+
+    fs::remove_all(root);
+    fs::remove_all(store);
+}
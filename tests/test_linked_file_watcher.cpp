@@ -0,0 +1,192 @@
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <sqlite3.h>
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "linked_file_watcher.hpp"
+#include "model.hpp"
+#include "resource_repository.hpp"
+#include "schema_migrator.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    namespace fs = std::filesystem;
+
+    void createWatcherSchema(sqlite3* db) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type TEXT NOT NULL,
+                file_hash TEXT UNIQUE,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                UNIQUE (title, type)
+            );
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0,
+                missing_since TEXT NULL
+            );
+        )SQL";
+
+        REQUIRE(sqlite3_exec(db, schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+    }
+
+    void writeFile(const fs::path &path, std::string_view content) {
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs << content;
+    }
+
+    LinkedFileState stateOf(FileRepository &repo, sqlite3_int64 id) {
+        for (auto &state : repo.getLinkedFiles()) {
+            if (state.resource_id == id) { return state; }
+        }
+        FAIL("resource not linked");
+        return {};
+    }
+} // namespace
+
+TEST_CASE("SchemaMigrator adds files.missing_since to old databases", "[SchemaMigrator]") {
+    SQLiteDB db(":memory:");
+    REQUIRE(sqlite3_exec(db.get(),
+                         "CREATE TABLE files (resource_id INTEGER PRIMARY KEY, stored_path TEXT, "
+                         "original_path TEXT NOT NULL, is_managed INTEGER NOT NULL DEFAULT 0);",
+                         nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    SchemaMigrator migrator(db);
+    CHECK(migrator.userVersion() == 0);
+    CHECK(migrator.migrate() == SchemaMigrator::kCurrentVersion);
+    CHECK(migrator.userVersion() == SchemaMigrator::kCurrentVersion);
+
+    SQLiteStmt stmt(db.get(), "SELECT missing_since FROM files;");
+    CHECK(sqlite3_step(stmt.get()) == SQLITE_DONE);
+
+    // Chạy lại không làm gì
+    CHECK(migrator.migrate() == 0);
+}
+
+TEST_CASE("LinkedFileWatcher rescan detects edits and deletions", "[LinkedFileWatcher]") {
+    SQLiteDB db(":memory:");
+    createWatcherSchema(db.get());
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+
+    const auto dir = fs::temp_directory_path() / "notes_watch_rescan";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    const auto a = dir / "a.cpp";
+    const auto b = dir / "b.cpp";
+    writeFile(a, "int a;");
+    writeFile(b, "int b;");
+
+    const auto idA = fileService.addFileResource(a.string(), "a", ResourceType::cpp, false);
+    const auto idB = fileService.addFileResource(b.string(), "b", ResourceType::cpp, false);
+
+    LinkedFileWatcher watcher(fileRepo, fileService);
+    CHECK(watcher.start() == 0);
+    CHECK(watcher.trackedCount() == 2);
+
+    writeFile(a, "int a_changed_size;");
+    fs::remove(b);
+
+    CHECK(watcher.rescan() == 2);
+    CHECK(stateOf(fileRepo, idA).file_hash == FileService::computeFileHash(a.string()));
+    CHECK(stateOf(fileRepo, idB).is_missing);
+
+    // Không có gì mới -> không ghi
+    CHECK(watcher.rescan() == 0);
+
+    // File quay lại -> gỡ tombstone
+    writeFile(b, "int b;");
+    CHECK(watcher.rescan() == 1);
+    CHECK_FALSE(stateOf(fileRepo, idB).is_missing);
+
+    fs::remove_all(dir);
+}
+
+#if defined(__linux__)
+TEST_CASE("LinkedFileWatcher applies inotify events in batches", "[LinkedFileWatcher]") {
+    SQLiteDB db(":memory:");
+    createWatcherSchema(db.get());
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+
+    const auto dir = fs::temp_directory_path() / "notes_watch_events";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    const auto a = dir / "a.cpp";
+    const auto b = dir / "b.cpp";
+    writeFile(a, "int a;");
+    writeFile(b, "int b;");
+
+    const auto idA = fileService.addFileResource(a.string(), "a", ResourceType::cpp, false);
+    const auto idB = fileService.addFileResource(b.string(), "b", ResourceType::cpp, false);
+
+    LinkedFileWatcher watcher(fileRepo, fileService,
+                              LinkedWatchOptions{.debounce = std::chrono::milliseconds(0)});
+    watcher.start();
+    REQUIRE(watcher.nativeHandle() >= 0);
+    CHECK(watcher.watchedDirectoryCount() == 1);
+
+    SECTION("burst of writes is coalesced into one hash update") {
+        for (int i = 0; i < 5; ++i) { writeFile(a, "int a" + std::to_string(i) + ";"); }
+
+        CHECK(watcher.readEvents() > 1);
+        CHECK(watcher.isSettled());
+        CHECK(watcher.flush() == 1);
+        CHECK(stateOf(fileRepo, idA).file_hash == FileService::computeFileHash(a.string()));
+    }
+
+    SECTION("rename inside a watched directory updates the path") {
+        const auto moved = dir / "b_renamed.cpp";
+        fs::rename(b, moved);
+
+        watcher.readEvents();
+        CHECK(watcher.flush() == 1);
+
+        const auto state = stateOf(fileRepo, idB);
+        CHECK(state.path == moved.string());
+        CHECK_FALSE(state.is_missing);
+        CHECK(fileService.findResourceByFile(moved.string()) == idB);
+    }
+
+    SECTION("delete leaves a tombstone, recreate clears it") {
+        fs::remove(a);
+        watcher.readEvents();
+        CHECK(watcher.flush() == 1);
+        CHECK(stateOf(fileRepo, idA).is_missing);
+
+        writeFile(a, "int a;");
+        watcher.readEvents();
+        CHECK(watcher.flush() == 1);
+        CHECK_FALSE(stateOf(fileRepo, idA).is_missing);
+    }
+
+    SECTION("moving a file out of watched directories marks it missing") {
+        const auto outside = fs::temp_directory_path() / "notes_watch_outside.cpp";
+        fs::rename(b, outside);
+
+        watcher.readEvents();
+        CHECK(watcher.flush() == 1);
+        CHECK(stateOf(fileRepo, idB).is_missing);
+
+        fs::remove(outside);
+    }
+
+    watcher.stop();
+    fs::remove_all(dir);
+}
+#endif
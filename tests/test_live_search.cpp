@@ -0,0 +1,135 @@
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <sqlite3.h>
+#include "live_search.hpp"
+#include "resource_repository.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    SQLiteDB createInMemoryDB() {
+        SQLiteDB db(":memory:");
+
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type INTEGER NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE resources_fts USING fts5(
+                title,
+                tokenize = 'unicode61 remove_diacritics 1'
+            );
+
+            CREATE TRIGGER resources_insert_fts AFTER INSERT ON resources
+            BEGIN
+                INSERT INTO resources_fts (rowid, title) VALUES (new.id, new.title);
+            END;
+        )SQL";
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+
+        return db;
+    }
+
+    void insertTitle(SQLiteDB &db, const std::string &title) {
+        SQLiteStmt stmt(db.get(), "INSERT INTO resources (title, type) VALUES (?, 0);");
+        sqlite3_bind_text(stmt.get(), 1, title.c_str(), -1, SQLITE_TRANSIENT);
+        REQUIRE(sqlite3_step(stmt.get()) == SQLITE_DONE);
+    }
+
+    using Ids = std::vector<sqlite3_int64>;
+} // namespace
+
+TEST_CASE("LiveSearch builds FTS5 prefix queries", "[LiveSearch]") {
+    CHECK(LiveSearch::toPrefixQuery("foo ba") == R"("foo"* "ba"*)");
+    CHECK(LiveSearch::toPrefixQuery("  qt-mo  ") == R"("qt-mo"*)");
+    CHECK(LiveSearch::toPrefixQuery(R"(a"b)") == R"("a""b"*)");
+    CHECK(LiveSearch::toPrefixQuery("AND or") == R"("AND"* "or"*)");
+    CHECK(LiveSearch::toPrefixQuery("- foo") == R"("foo"*)");
+    CHECK(LiveSearch::toPrefixQuery(" -- ").empty());
+    CHECK(LiveSearch::toPrefixQuery("tiếng") == R"("tiếng"*)");
+}
+
+TEST_CASE("LiveSearch refines from the previous keystroke", "[LiveSearch]") {
+    auto db = createInMemoryDB();
+    insertTitle(db, "Qt model view");    // 1
+    insertTitle(db, "Qt signals");       // 2
+    insertTitle(db, "Query planner");    // 3
+    insertTitle(db, "Tiếng Việt notes"); // 4
+    insertTitle(db, "Quản lý");          // 5
+
+    ResourceRepository repo(db);
+    LiveSearch live(db, repo);
+
+    auto first = live.search("q");
+    CHECK_FALSE(first.refined);
+    CHECK(first.complete);
+    CHECK(first.ids == Ids{1, 2, 3, 5});
+
+    // "Quản lý" không tách token trong bộ nhớ được nên FTS kiểm lại
+    auto second = live.search("qu");
+    CHECK(second.refined);
+    CHECK(second.ids == Ids{3, 5});
+
+    auto third = live.search("qua");
+    CHECK(third.refined);
+    CHECK(third.ids == Ids{5});
+
+    SECTION("a keyword that does not extend the previous one runs a full query") {
+        auto other = live.search("qt m");
+        CHECK_FALSE(other.refined);
+        CHECK(other.ids == Ids{1});
+    }
+
+    SECTION("refined phrases match what FTS5 returns") {
+        REQUIRE_FALSE(live.search("qt").refined);
+        auto refined = live.search("qt-mo");
+        CHECK(refined.refined);
+
+        LiveSearch fresh(db, repo);
+        auto full = fresh.search("qt-mo");
+        CHECK_FALSE(full.refined);
+        CHECK(refined.ids == full.ids);
+        CHECK(full.ids == Ids{1});
+    }
+
+    SECTION("a write to the database drops the previous set") {
+        REQUIRE_FALSE(live.search("q").refined);
+        insertTitle(db, "Quick notes"); // 6
+
+        auto after = live.search("qu");
+        CHECK_FALSE(after.refined);
+        CHECK(after.ids == Ids{3, 5, 6});
+    }
+
+    SECTION("an empty keyword resets the session") {
+        auto empty = live.search("  ");
+        CHECK(empty.query.empty());
+        CHECK(empty.ids.empty());
+        CHECK_FALSE(live.search("qua").refined);
+    }
+}
+
+TEST_CASE("LiveSearch does not keep oversized result sets", "[LiveSearch]") {
+    auto db = createInMemoryDB();
+    REQUIRE(sqlite3_exec(db.get(), "BEGIN;", nullptr, nullptr, nullptr) == SQLITE_OK);
+    for (std::size_t i = 0; i <= LiveSearch::kMaxCandidates; ++i) {
+        insertTitle(db, "bulk " + std::to_string(i));
+    }
+    REQUIRE(sqlite3_exec(db.get(), "COMMIT;", nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    ResourceRepository repo(db);
+    LiveSearch live(db, repo);
+
+    auto all = live.search("bu");
+    CHECK_FALSE(all.complete);
+    CHECK(all.ids.size() == LiveSearch::kMaxCandidates);
+    CHECK(all.ids.front() == 1);
+
+    // Tập trước không trọn thì không lọc tiếp được
+    auto next = live.search("bulk 1999");
+    CHECK_FALSE(next.refined);
+    CHECK(next.complete);
+    CHECK(next.ids == Ids{2000});
+}
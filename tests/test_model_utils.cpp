@@ -1,6 +1,7 @@
 #include <cstring>
 #include <stdexcept>
 #include <optional>
+#include <string>
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include "model.hpp"
@@ -39,6 +40,52 @@ TEST_CASE("resourceTypeFromString - Valid and Invalid Inputs", "[Model][Utils][R
     }
 }
 
+TEST_CASE("resourceTypeCode - Round Trip", "[Model][Utils][ResourceType]") {
+    SECTION("Codes stored in resources.type") {
+        REQUIRE(resourceTypeCode(ResourceType::text) == 0);
+        REQUIRE(resourceTypeCode(ResourceType::cpp) == 1);
+        REQUIRE(resourceTypeCode(ResourceType::pdf) == 2);
+        REQUIRE(resourceTypeCode(ResourceType::epub) == 3);
+
+        for (auto type : {ResourceType::text, ResourceType::cpp, ResourceType::pdf,
+                          ResourceType::epub}) {
+            REQUIRE(resourceTypeFromCode(resourceTypeCode(type)) == type);
+        }
+    }
+
+    SECTION("Unknown Code Should Throw std::runtime_error") {
+        CHECK_THROWS_AS(resourceTypeFromCode(-1), std::runtime_error);
+        CHECK_THROWS_WITH(resourceTypeFromCode(4), "Unknown ResourceType code: 4");
+    }
+}
+
+TEST_CASE("FileHash hex conversion", "[Model][Utils][FileHash]") {
+    const std::string hex = "2cf24dba5fb0a30e26e83b2ac5b9e29e1b161e5c1fa7425e73043362938b9824";
+
+    SECTION("Round trip") {
+        const auto hash = fileHashFromHex(hex);
+        REQUIRE(hash.has_value());
+        CHECK(hash->front() == std::byte{0x2c});
+        CHECK(hash->back() == std::byte{0x24});
+        CHECK(fileHashToHex(*hash) == hex);
+        CHECK(fileHashFromHex("2CF24DBA5FB0A30E26E83B2AC5B9E29E1B161E5C1FA7425E73043362938B9824") ==
+              hash);
+    }
+
+    SECTION("Invalid hex") {
+        CHECK_FALSE(fileHashFromHex("").has_value());
+        CHECK_FALSE(fileHashFromHex(hex.substr(2)).has_value());
+        CHECK_FALSE(fileHashFromHex("zz" + hex.substr(2)).has_value());
+    }
+
+    SECTION("Blob of the wrong size") {
+        const FileHash hash{};
+        CHECK(fileHashFromBlob(hash.data(), 32) == hash);
+        CHECK_FALSE(fileHashFromBlob(hash.data(), 16).has_value());
+        CHECK_FALSE(fileHashFromBlob(nullptr, 0).has_value());
+    }
+}
+
 TEST_CASE("resourceTypeFromExtension", "[Model][Utils][ResourceType]") {
     SECTION("Mapping valid resource type") {
         REQUIRE(resourceTypeFromExtension("txt") == ResourceType::text);
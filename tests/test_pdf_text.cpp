@@ -0,0 +1,301 @@
+#include <catch2/catch_test_macros.hpp>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include <zlib.h>
+#include "content_index_repository.hpp"
+#include "content_indexer.hpp"
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+#include "pdf_text.hpp"
+#include "pdf_worker_protocol.hpp"
+#include "resource_repository.hpp"
+#include "schema_migrator.hpp"
+#include "sqldb_raii.hpp"
+
+namespace {
+    namespace fs = std::filesystem;
+
+    std::string zlibCompress(const std::string &data) {
+        uLongf size = compressBound(static_cast<uLong>(data.size()));
+        std::string out(size, '\0');
+        REQUIRE(compress(reinterpret_cast<Bytef*>(out.data()), &size,
+                         reinterpret_cast<const Bytef*>(data.data()),
+                         static_cast<uLong>(data.size())) == Z_OK);
+        out.resize(size);
+        return out;
+    }
+
+    std::string stream(const std::string &dictEntries, const std::string &data) {
+        return "<< /Length " + std::to_string(data.size()) + " " + dictEntries + " >>\nstream\n" +
+               data + "\nendstream";
+    }
+
+    // Ghi PDF với bảng xref đúng offset; objects[i] là object số i + 1, rỗng = không ghi
+    // (object nằm trong object stream). trailerEntries thêm vào dict trailer
+    std::string buildPdf(const std::vector<std::string> &objects,
+                         const std::string &trailerEntries = {}) {
+        std::string out = "%PDF-1.5\n%\xE2\xE3\xCF\xD3\n";
+        std::vector<std::size_t> offsets;
+
+        for (std::size_t i = 0; i < objects.size(); ++i) {
+            offsets.push_back(out.size());
+            if (objects[i].empty()) { continue; }
+            out += std::to_string(i + 1) + " 0 obj\n" + objects[i] + "\nendobj\n";
+        }
+
+        const auto xref = out.size();
+        out += "xref\n0 " + std::to_string(objects.size() + 1) + "\n0000000000 65535 f \n";
+        for (const auto offset : offsets) {
+            const auto digits = std::to_string(offset);
+            out += std::string(10 - digits.size(), '0') + digits + " 00000 n \n";
+        }
+        out += "trailer\n<< /Size " + std::to_string(objects.size() + 1) +
+               " /Root 1 0 R " + trailerEntries + ">>\nstartxref\n" + std::to_string(xref) + "\n%%EOF\n";
+        return out;
+    }
+
+    // 3 trang: (1) Type1 WinAnsi không nén, (2) Type0 + ToUnicode, nén Flate, font nằm trong
+    // object stream, (3) trang trống. Resources kế thừa từ node Pages.
+    std::string samplePdf(const std::string &extraPage2 = {}) {
+        const std::string page1 = "BT /F1 12 Tf 72 720 Td (Hello) Tj ( World) Tj\n"
+                                  "0 -14 Td [(Zero) -250 (cost)] TJ T* (caf\\351) Tj ET";
+        const std::string page2 = "BT /F2 10 Tf 1 0 0 1 50 700 Tm <000100020007> Tj\n"
+                                  "1 0 0 1 50 680 Tm <0003000400050006> Tj ET\n"
+                                  "BT /F1 12 Tf 50 600 Td (" + extraPage2 + ") Tj ET";
+
+        const std::string cmap = "/CIDInit /ProcSet findresource begin\nbegincmap\n"
+                                 "1 begincodespacerange <0000> <FFFF> endcodespacerange\n"
+                                 "2 beginbfchar <0001> <0050> <0002> <0044> endbfchar\n"
+                                 "1 beginbfchar <0007> <0046> endbfchar\n"
+                                 "1 beginbfrange <0003> <0006> <0041> endbfrange\n"
+                                 "endcmap end";
+
+        const std::string type0Font = "<< /Type /Font /Subtype /Type0 /BaseFont /Custom "
+                                      "/Encoding /Identity-H /ToUnicode 10 0 R >>";
+        const std::string objStmHeader = "9 0 ";
+        const std::string objStm = objStmHeader + type0Font;
+
+        return buildPdf({
+            "<< /Type /Catalog /Pages 2 0 R >>",
+            "<< /Type /Pages /Kids [3 0 R 4 0 R 5 0 R] /Count 3 "
+            "/Resources << /Font << /F1 6 0 R /F2 9 0 R >> >> >>",
+            "<< /Type /Page /Parent 2 0 R /Contents 7 0 R >>",
+            "<< /Type /Page /Parent 2 0 R /Contents [8 0 R] >>",
+            "<< /Type /Page /Parent 2 0 R >>",
+            "<< /Type /Font /Subtype /Type1 /BaseFont /Helvetica /Encoding /WinAnsiEncoding >>",
+            stream("", page1),
+            stream("/Filter /FlateDecode", zlibCompress(page2)),
+            "", // object 9 nằm trong object stream 11
+            stream("/Filter /FlateDecode", zlibCompress(cmap)),
+            stream("/Type /ObjStm /N 1 /First " + std::to_string(objStmHeader.size()) +
+                       " /Filter /FlateDecode",
+                   zlibCompress(objStm)),
+        });
+    }
+
+    void writeFile(const fs::path &path, const std::string &data) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << data;
+    }
+
+    struct PageText {
+            int page{};
+            std::string text;
+    };
+
+    std::vector<PageText> extract(PdfTextExtractor &pdf,
+                                  int maxPages = PdfTextExtractor::kAllPages) {
+        std::vector<PageText> pages;
+        pdf.extractPages([&](int page, std::string_view text) {
+            pages.push_back({page, std::string(text)});
+        }, maxPages);
+        return pages;
+    }
+} // namespace
+
+TEST_CASE("PdfTextExtractor reads the text layer page by page", "[PdfText]") {
+    const auto path = fs::temp_directory_path() / "notes_pdf_test.pdf";
+    writeFile(path, samplePdf());
+
+    PdfTextExtractor pdf(path);
+    REQUIRE(pdf.pageCount() == 3);
+
+    const auto pages = extract(pdf);
+    REQUIRE(pages.size() == 2); // trang 3 không có text
+    CHECK(pages[0].page == 1);
+    CHECK(pages[0].text == "Hello World\nZero cost\ncaf\xC3\xA9");
+    CHECK(pages[1].page == 2);
+    CHECK(pages[1].text == "PDF\nABCD");
+
+    // Ngân sách trang
+    std::vector<int> seen;
+    CHECK(pdf.extractPages([&](int page, std::string_view) { seen.push_back(page); }, 1) == 1);
+    CHECK(seen == std::vector<int>{1});
+
+    writeFile(path, "%PDF-1.4\nthis is not really a pdf");
+    CHECK_THROWS_AS(PdfTextExtractor(path), std::runtime_error);
+
+    writeFile(path, "plain text");
+    CHECK_THROWS_AS(PdfTextExtractor(path), std::runtime_error);
+
+    fs::remove(path);
+}
+
+TEST_CASE("PdfTextExtractor rejects encrypted PDFs", "[PdfText]") {
+    const auto path = fs::temp_directory_path() / "notes_pdf_encrypted.pdf";
+    const std::vector<std::string> objects{
+        "<< /Type /Catalog /Pages 2 0 R >>",
+        "<< /Type /Pages /Kids [3 0 R] /Count 1 >>",
+        "<< /Type /Page /Parent 2 0 R /Contents 4 0 R >>",
+        stream("", "BT /F1 12 Tf (\x8f\x12\xa7) Tj ET"),
+        "<< /Filter /Standard /V 2 /R 3 /Length 128 /P -4 /O <00> /U <00> >>",
+    };
+
+    const auto message = [&] {
+        try {
+            PdfTextExtractor pdf(path);
+        } catch (const std::runtime_error &ex) {
+            return std::string(ex.what());
+        }
+        return std::string();
+    };
+
+    // Lỗi này là file_index_state.error của file (worker gửi lại qua frame error)
+    writeFile(path, buildPdf(objects, "/Encrypt 5 0 R /ID [<01> <01>] "));
+    CHECK(message().starts_with("Encrypted PDF"));
+
+    // PDF 1.5+: /Encrypt nằm trong dict của xref stream
+    auto withXrefStream = objects;
+    withXrefStream.push_back(stream("/Type /XRef /Size 7 /Root 1 0 R /Encrypt 5 0 R", ""));
+    writeFile(path, buildPdf(withXrefStream));
+    CHECK(message().starts_with("Encrypted PDF"));
+
+    writeFile(path, buildPdf(objects));
+    CHECK(message().empty());
+
+    fs::remove(path);
+}
+
+TEST_CASE("PdfWorkerDecoder handles frames split at any byte", "[PdfText]") {
+    const std::string output = encodePdfPage(1, "line one\nline two") + encodePdfPage(3, "") +
+                               encodePdfPage(4, "page\xC3\xA9") + encodePdfDone(4);
+
+    std::vector<PageText> pages;
+    int done{-1};
+    PdfWorkerDecoder decoder([&](int page, std::string_view text) {
+        pages.push_back({page, std::string(text)});
+    }, [&](int count) { done = count; }, [](std::string_view) { FAIL("unexpected error"); });
+
+    for (const char c : output) { decoder.feed(std::string_view(&c, 1)); }
+
+    REQUIRE(pages.size() == 3);
+    CHECK(pages[0].text == "line one\nline two");
+    CHECK(pages[1].page == 3);
+    CHECK(pages[1].text.empty());
+    CHECK(pages[2].text == "page\xC3\xA9");
+    CHECK(done == 4);
+    CHECK(decoder.finished());
+    CHECK_THROWS_AS(decoder.feed("page 5 1\nx"), std::runtime_error);
+
+    std::string error;
+    PdfWorkerDecoder errors([](int, std::string_view) {}, [](int) {},
+                            [&](std::string_view message) { error = message; });
+    errors.feed(encodePdfError("Unsupported PDF filter: JBIG2Decode"));
+    CHECK(error == "Unsupported PDF filter: JBIG2Decode");
+    CHECK(errors.finished());
+
+    PdfWorkerDecoder garbage([](int, std::string_view) {}, [](int) {}, [](std::string_view) {});
+    CHECK_THROWS_AS(garbage.feed("Segmentation fault\n"), std::runtime_error);
+
+    PdfWorkerDecoder limited([](int, std::string_view) {}, [](int) {}, [](std::string_view) {},
+                             16);
+    CHECK_THROWS_AS(limited.feed("page 1 17\n"), std::runtime_error);
+}
+
+TEST_CASE("PageChunkWriter stores PDF chunks with page numbers", "[PdfText]") {
+    SQLiteDB db(":memory:");
+    const char* schema = R"SQL(
+        CREATE TABLE resources (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL,
+            type TEXT NOT NULL,
+            file_hash TEXT UNIQUE,
+            created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+            updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+            UNIQUE (title, type)
+        );
+
+        CREATE TABLE files (
+            resource_id INTEGER PRIMARY KEY,
+            stored_path TEXT,
+            original_path TEXT NOT NULL,
+            is_managed INTEGER NOT NULL DEFAULT 0,
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+    )SQL";
+    REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+    SchemaMigrator(db).migrate();
+
+    {
+        SQLiteStmt stmt(db.get(), "SELECT 1 FROM pragma_table_info('file_chunks') "
+                                  "WHERE name = 'page';");
+        CHECK(sqlite3_step(stmt.get()) == SQLITE_ROW);
+    }
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    ContentIndexRepository indexRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+
+    const auto path = fs::temp_directory_path() / "notes_pdf_index.pdf";
+    std::string filler;
+    for (int n = 0; n < 60; ++n) { filler += "ownership" + std::to_string(n) + " "; }
+    writeFile(path, samplePdf(filler));
+
+    const auto id = fileService.addFileResource(path.string(), "book", ResourceType::pdf, false);
+
+    // PDF không được trích trong tiến trình app
+    ContentIndexer indexer(db, indexRepo);
+    CHECK(indexer.indexPending(10) == 0);
+
+    auto pending = indexRepo.getPendingFiles({ResourceType::pdf}, 10);
+    REQUIRE(pending.size() == 1);
+
+    {
+        PageChunkWriter writer(db, indexRepo, pending.front(), 256);
+        PdfTextExtractor pdf(path);
+        pdf.extractPages([&](int page, std::string_view text) { writer.addPage(page, text); });
+        writer.finish();
+
+        CHECK(writer.pageCount() == 2);
+        CHECK(writer.chunkCount() > 2); // trang 2 dài hơn một chunk
+        CHECK(indexRepo.chunkCount(id) == writer.chunkCount());
+    }
+
+    CHECK(indexRepo.getPendingFiles({ResourceType::pdf}, 10).empty());
+
+    auto hits = indexRepo.searchFileContentFTS("Hello");
+    REQUIRE(hits.size() == 1);
+    CHECK(hits.front().second.starts_with("p. 1: "));
+
+    hits = indexRepo.searchFileContentFTS("ownership59");
+    REQUIRE(hits.size() == 1);
+    CHECK(hits.front().first == id);
+    CHECK(hits.front().second.starts_with("p. 2: "));
+
+    // Worker lỗi giữa chừng: bỏ các trang đã ghi, không thử lại đến khi file đổi
+    {
+        PageChunkWriter writer(db, indexRepo, pending.front(), 256);
+        writer.addPage(1, "partial text");
+        writer.fail("PDF extraction timed out");
+    }
+    CHECK(indexRepo.chunkCount(id) == 0);
+    CHECK(indexRepo.searchFileContentFTS("partial").empty());
+    CHECK(indexRepo.getPendingFiles({ResourceType::pdf}, 10).empty());
+
+    fs::remove(path);
+}
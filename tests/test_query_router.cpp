@@ -0,0 +1,203 @@
+#include <string>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <sqlite3.h>
+#include "query_router.hpp"
+#include "resource_repository.hpp"
+#include "schema_migrator.hpp"
+#include "search_indexes.hpp"
+#include "sqldb_raii.hpp"
+#include "text_content_repository.hpp"
+
+namespace {
+    // Schema v9 tối thiểu: FTS chưa có prefix index, chưa có bảng trigram
+    SQLiteDB createV9DB() {
+        SQLiteDB db(":memory:");
+
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type INTEGER NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE resources_fts USING fts5(
+                title,
+                tokenize = 'unicode61 remove_diacritics 1'
+            );
+
+            CREATE TRIGGER resources_insert_fts AFTER INSERT ON resources
+            BEGIN
+                INSERT INTO resources_fts (rowid, title) VALUES (new.id, new.title);
+            END;
+
+            CREATE TABLE text_content (
+                resource_id INTEGER PRIMARY KEY,
+                content TEXT
+            );
+
+            CREATE TABLE text_chunks (
+                id          INTEGER PRIMARY KEY,
+                resource_id INTEGER NOT NULL,
+                chunk_no    INTEGER NOT NULL,
+                byte_len    INTEGER NOT NULL,
+                line_count  INTEGER NOT NULL,
+                content     TEXT NOT NULL,
+                UNIQUE (resource_id, chunk_no)
+            );
+
+            CREATE VIRTUAL TABLE text_chunks_fts USING fts5(
+                content,
+                content = 'text_chunks',
+                content_rowid = 'id',
+                tokenize = 'unicode61 remove_diacritics 1'
+            );
+
+            CREATE TRIGGER text_chunks_insert_fts AFTER INSERT ON text_chunks
+            BEGIN
+                INSERT INTO text_chunks_fts (rowid, content) VALUES (new.id, new.content);
+            END;
+
+            CREATE TRIGGER text_chunks_delete_fts AFTER DELETE ON text_chunks
+            BEGIN
+                INSERT INTO text_chunks_fts (text_chunks_fts, rowid, content)
+                VALUES ('delete', old.id, old.content);
+            END;
+
+            INSERT INTO resources (title, type) VALUES ('RingBufferImpl', 1), ('Algorithms', 0),
+                                                       ('Notes on ring', 0);
+
+            PRAGMA user_version = 9;
+        )SQL";
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+
+        return db;
+    }
+
+    using Ids = std::vector<sqlite3_int64>;
+} // namespace
+
+TEST_CASE("QueryRouter picks the cheapest index", "[QueryRouter]") {
+    const SearchCapabilities all{.prefixIndex = true, .trigram = true, .likeScan = true};
+    const SearchCapabilities bare{};
+
+    SECTION("plain terms stay on FTS unchanged") {
+        const auto routed = routeQuery("  ring buffer ", all);
+        CHECK(routed.plan == QueryPlan::ftsTerms);
+        CHECK(routed.expression == "ring buffer");
+    }
+
+    SECTION("prefixes use the prefix index only for lengths 2 to 4") {
+        CHECK(routeQuery("algo*", all).plan == QueryPlan::ftsPrefix);
+        CHECK(routeQuery("al*", all).plan == QueryPlan::ftsPrefix);
+        CHECK(routeQuery("a*", all).plan == QueryPlan::ftsPrefixScan);
+        CHECK(routeQuery("algor*", all).plan == QueryPlan::ftsPrefixScan);
+        CHECK(routeQuery("algo* ring", all).plan == QueryPlan::ftsPrefix);
+        CHECK(routeQuery("algo* algori*", all).plan == QueryPlan::ftsPrefixScan);
+        CHECK(routeQuery("algo*", bare).plan == QueryPlan::ftsPrefixScan);
+        // '*' chỉ áp cho từ con cuối: "getTa*" -> get, ta*
+        CHECK(routeQuery("getTa*", all).plan == QueryPlan::ftsPrefix);
+        // Ký tự có dấu đếm theo ký tự, không theo byte
+        CHECK(routeQuery("việt*", all).plan == QueryPlan::ftsPrefix);
+    }
+
+    SECTION("a leading star asks for a substring") {
+        const auto trigram = routeQuery("*Buffer*", all);
+        CHECK(trigram.plan == QueryPlan::trigram);
+        CHECK(trigram.expression == R"("Buffer")");
+
+        // Trigram cần ít nhất 3 ký tự
+        const auto shortNeedle = routeQuery("*ng", all);
+        CHECK(shortNeedle.plan == QueryPlan::likeScan);
+        CHECK(shortNeedle.expression == "%ng%");
+
+        CHECK(routeQuery(R"(*50%_"x)", all).expression == R"("50%_""x")");
+        CHECK(routeQuery("*50%_", {.likeScan = true}).expression == R"(%50\%\_%)");
+
+        const auto fallback = routeQuery("*Buffer", {.prefixIndex = true});
+        CHECK(fallback.plan == QueryPlan::ftsPrefixScan);
+        CHECK(fallback.expression == R"("Buffer"*)");
+    }
+
+    SECTION("nothing to search for") {
+        CHECK(routeQuery("   ", all).plan == QueryPlan::none);
+        CHECK(routeQuery("**", all).plan == QueryPlan::none);
+        CHECK(routeQuery("", all).describe() == "none");
+    }
+
+    CHECK(routeQuery("*Buffer", all).describe() == R"(trigram: "Buffer")");
+}
+
+TEST_CASE("Schema v10 adds prefix and trigram indexes", "[QueryRouter][SchemaMigrator]") {
+    auto db = createV9DB();
+    SearchIndexes indexes(db);
+
+    CHECK_FALSE(indexes.titleCapabilities().prefixIndex);
+    CHECK_FALSE(indexes.titleCapabilities().trigram);
+
+    CHECK(SchemaMigrator(db).migrate() == SchemaMigrator::kCurrentVersion - 9);
+    CHECK(SchemaMigrator(db).userVersion() == SchemaMigrator::kCurrentVersion);
+
+    const auto title = indexes.titleCapabilities();
+    CHECK(title.prefixIndex);
+    CHECK(title.trigram);
+    CHECK(title.likeScan);
+    CHECK(indexes.contentCapabilities().prefixIndex);
+    CHECK_FALSE(indexes.contentCapabilities().trigram);
+
+    ResourceRepository repo(db);
+    CHECK(repo.searchIdsByTitle(routeQuery("ring*", title)) == Ids{1, 3});
+    CHECK(repo.searchIdsByTitle(routeQuery("*buffer", title)) == Ids{1});
+    CHECK(repo.searchIdsByTitle(routeQuery("*go", title)) == Ids{2});
+    CHECK(repo.searchIdsByTitle(routeQuery("*", title)).empty());
+
+    SECTION("title trigram follows inserts, renames and deletes") {
+        REQUIRE(sqlite3_exec(db.get(),
+                             "INSERT INTO resources (title, type) VALUES ('ByteBufferPool', 1);"
+                             "UPDATE resources SET title = 'RingQueue' WHERE id = 1;"
+                             "DELETE FROM resources WHERE id = 3;",
+                             nullptr, nullptr, nullptr) == SQLITE_OK);
+
+        CHECK(repo.searchIdsByTitle(routeQuery("*buffer", title)) == Ids{4});
+        CHECK(repo.searchIdsByTitle(routeQuery("*ngQue", title)) == Ids{1});
+    }
+}
+
+TEST_CASE("Content trigram index is optional", "[QueryRouter]") {
+    auto db = createV9DB();
+    REQUIRE(SchemaMigrator(db).migrate() == SchemaMigrator::kCurrentVersion - 9);
+
+    TextContentRepository textRepo(db);
+    textRepo.insertText(1, "template <typename T>\nclass RingBufferImpl {};\n");
+    textRepo.insertText(2, "sorting algorithms\n");
+
+    SearchIndexes indexes(db);
+    const auto substring = [&] { return routeQuery("*ufferImpl", indexes.contentCapabilities()); };
+
+    // Chưa bật: lùi về prefix FTS, không thấy chuỗi con giữa từ con
+    CHECK(substring().plan == QueryPlan::ftsPrefixScan);
+    CHECK(textRepo.searchContentHits(substring()).empty());
+
+    CHECK(indexes.setContentTrigram(true));
+    CHECK_FALSE(indexes.setContentTrigram(true));
+    CHECK(indexes.contentTrigramEnabled());
+
+    // Bật sau khi đã có note: bảng trigram được nạp lại từ text_chunks
+    const auto hits = textRepo.searchContentHits(substring());
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0].resource_id == 1);
+    CHECK(hits[0].line == 2);
+    CHECK(hits[0].byte_offset == 33);
+
+    // Note ghi sau khi bật được trigger đưa vào trigram
+    textRepo.insertText(3, "struct ByteBufferImpl;\n");
+    CHECK(textRepo.searchContentHits(substring()).size() == 2);
+
+    CHECK(indexes.setContentTrigram(false));
+    CHECK_FALSE(indexes.contentTrigramEnabled());
+    CHECK(substring().plan == QueryPlan::ftsPrefixScan);
+    // text_chunks của v13 có khóa ngoại tới resources
+    REQUIRE(sqlite3_exec(db.get(), "INSERT INTO resources (title, type) VALUES ('again', 0);",
+                         nullptr, nullptr, nullptr) == SQLITE_OK);
+    textRepo.insertText(4, "RingBufferImpl again\n");
+}
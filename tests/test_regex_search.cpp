@@ -0,0 +1,253 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+#include "regex_search.hpp"
+#include "resource_repository.hpp"
+#include "resource_service.hpp"
+#include "schema_migrator.hpp"
+#include "search_indexes.hpp"
+#include "sqldb_raii.hpp"
+#include "tag_repository.hpp"
+#include "text_content_repository.hpp"
+
+namespace {
+    namespace fs = std::filesystem;
+    using Strings = std::vector<std::string>;
+
+    void createSchema(SQLiteDB &db) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type TEXT NOT NULL,
+                file_hash TEXT UNIQUE,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                UNIQUE (title, type)
+            );
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0,
+                FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+            );
+
+            CREATE TABLE text_content (
+                resource_id INTEGER PRIMARY KEY,
+                content TEXT NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE text_content_fts USING fts5(content);
+
+            CREATE TABLE tags (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT UNIQUE NOT NULL);
+            CREATE TABLE resource_tags (resource_id INTEGER, tag_id INTEGER,
+                                        PRIMARY KEY (resource_id, tag_id));
+        )SQL";
+
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+        SchemaMigrator(db).migrate();
+    }
+
+    void writeFile(const fs::path &path, std::string_view content) {
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        ofs << content;
+    }
+
+    // "id:line text" cho từng kết quả, sắp xếp vì worker trả về theo thứ tự bất kỳ
+    Strings describe(const std::vector<RegexMatch> &matches) {
+        Strings out;
+        for (const auto &match : matches) {
+            out.push_back(std::to_string(match.resource_id) + ":" + std::to_string(match.line) +
+                          " " + match.text);
+        }
+        std::ranges::sort(out);
+        return out;
+    }
+} // namespace
+
+TEST_CASE("requiredLiteral extracts a substring every match contains", "[RegexSearch]") {
+    CHECK(requiredLiteral("RingBuffer") == "RingBuffer");
+    CHECK(requiredLiteral("class\\s+Ring\\w*") == "class");
+    CHECK(requiredLiteral("push_back\\(") == "push_back(");
+    CHECK(requiredLiteral("colou?r") == "colo");
+    CHECK(requiredLiteral("ab+cde") == "cde");
+    CHECK(requiredLiteral("x{2}yz") == "yz");
+    CHECK(requiredLiteral("^\\s*#include\\s*<unordered_map>$") == "<unordered_map>");
+    CHECK(requiredLiteral("\\x41BCD") == "BCD");
+    CHECK(requiredLiteral("[abc]def[ghi]") == "def");
+    CHECK(requiredLiteral("(?:std::)?vector<int>") == "vector<int>");
+    CHECK(requiredLiteral("(?!skip)keep") == "keep");
+    CHECK(requiredLiteral("(optional)*tail") == "tail");
+    CHECK(requiredLiteral("(needed)+") == "needed");
+
+    // Nhánh '|' hoặc chỉ có lớp ký tự: không lọc được
+    CHECK(requiredLiteral("foo|bar").empty());
+    CHECK(requiredLiteral("(foo|bar)baz").empty());
+    CHECK(requiredLiteral("\\d+\\.\\d+").size() == 1);
+    CHECK(requiredLiteral("[0-9]+").empty());
+}
+
+TEST_CASE("RegexSearch finds matching lines in notes and linked files", "[RegexSearch]") {
+    SQLiteDB db(":memory:");
+    createSchema(db);
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    TextContentRepository textRepo(db);
+    TagRepository tagRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+    ResourceService resService(db, resRepo, fileRepo, textRepo, tagRepo, fileService);
+
+    const auto ringNote = resService.addTextResource(
+        "ring", "template <typename T>\nclass RingBuffer {\n    void push(T v);\n};\n",
+        ResourceType::text);
+    const auto sortNote = resService.addTextResource(
+        "sort", "void sort(int *a, int n);\r\nclass Sorter {};\r\n", ResourceType::text);
+    resService.addTextResource("empty", "no classes here", ResourceType::text);
+
+    const auto dir = fs::temp_directory_path() / "notes_regex_search";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    const auto header = dir / "queue.hpp";
+    writeFile(header, "#pragma once\n\nclass Queue;\nclass   BoundedQueue {\n};\n");
+    const auto headerId =
+        fileService.addFileResource(header.string(), "queue", ResourceType::cpp, false);
+
+    // Dòng khớp nằm vắt qua ranh giới block đọc 64KB
+    std::string big(70'000, 'x');
+    big[10] = '\n';
+    big += "\nclass Spanning {};\n";
+    const auto bigFile = dir / "big.txt";
+    writeFile(bigFile, big);
+    const auto bigId = fileService.addFileResource(bigFile.string(), "big", ResourceType::text,
+                                                   false);
+
+    const auto search = [&](std::string_view pattern, RegexSearchOptions options = {}) {
+        if (options.threads == 0) { options.threads = 3; }
+        RegexSearch regex(db, pattern, options);
+        auto matches = regex.run();
+        CHECK(regex.status() == RegexSearchStatus::completed);
+        return matches;
+    };
+
+    const auto matches = search("^class\\s+\\w+");
+    CHECK(describe(matches) ==
+          Strings{std::to_string(ringNote) + ":2 class RingBuffer {",
+                  std::to_string(sortNote) + ":2 class Sorter {};",
+                  std::to_string(headerId) + ":3 class Queue;",
+                  std::to_string(headerId) + ":4 class   BoundedQueue {",
+                  std::to_string(bigId) + ":3 class Spanning {};"});
+
+    const auto spanning = std::ranges::find(matches, bigId, &RegexMatch::resource_id);
+    REQUIRE(spanning != matches.end());
+    CHECK(spanning->byte_offset == 70'001);
+
+    SECTION("no literal: every line goes through the regex") {
+        CHECK(describe(search("\\bv\\w*\\)")) ==
+              Strings{std::to_string(ringNote) + ":3 void push(T v);"});
+    }
+
+    SECTION("ignoreCase") {
+        CHECK(search("boundedqueue").empty());
+        CHECK(search("boundedqueue", {.ignoreCase = true}).size() == 1);
+    }
+
+    SECTION("missing files are skipped") {
+        fs::remove(header);
+        CHECK(describe(search("BoundedQueue")).empty());
+    }
+
+    SECTION("trigram prefilter loads only notes containing the literal") {
+        REQUIRE(SearchIndexes(db).setContentTrigram(true));
+
+        RegexSearch regex(db, "Ring\\w+", {.threads = 2});
+        CHECK(regex.prefiltered());
+        CHECK(regex.literal() == "Ring");
+        CHECK(regex.noteCount() == 1);
+        CHECK(regex.fileCount() == 2);
+        CHECK(describe(regex.run()) == Strings{std::to_string(ringNote) + ":2 class RingBuffer {"});
+    }
+
+    SECTION("results arrive incrementally through poll") {
+        RegexSearch regex(db, "^class", {.threads = 1});
+        std::vector<RegexMatch> out;
+        std::size_t rounds{0};
+        while (regex.poll(out, std::chrono::milliseconds(5))) { ++rounds; }
+        CHECK(rounds >= 1);
+        CHECK(out.size() == matches.size());
+        CHECK_FALSE(regex.poll(out, std::chrono::milliseconds(0)));
+    }
+
+    fs::remove_all(dir);
+}
+
+TEST_CASE("RegexSearch stops on cancel, budget and match limit", "[RegexSearch]") {
+    SQLiteDB db(":memory:");
+    createSchema(db);
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    TextContentRepository textRepo(db);
+    TagRepository tagRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+    ResourceService resService(db, resRepo, fileRepo, textRepo, tagRepo, fileService);
+
+    std::string body;
+    for (int i = 0; i < 500; ++i) { body += "line " + std::to_string(i) + " match\n"; }
+    for (int n = 0; n < 20; ++n) {
+        resService.addTextResource("note " + std::to_string(n), body, ResourceType::text);
+    }
+
+    SECTION("match limit") {
+        RegexSearch regex(db, "match", {.threads = 4, .maxMatches = 100});
+        CHECK(regex.run().size() == 100);
+        CHECK(regex.status() == RegexSearchStatus::truncated);
+    }
+
+    SECTION("time budget") {
+        RegexSearch regex(db, "match", {.budget = std::chrono::milliseconds(0)});
+        CHECK(regex.run().empty());
+        CHECK(regex.status() == RegexSearchStatus::timedOut);
+    }
+
+    SECTION("stop token") {
+        std::stop_source source;
+        source.request_stop();
+        RegexSearch regex(db, "match", {}, source.get_token());
+        CHECK(regex.run().empty());
+        CHECK(regex.status() == RegexSearchStatus::cancelled);
+    }
+
+    SECTION("cancel keeps what was found") {
+        RegexSearch regex(db, "match", {.threads = 2, .maxMatches = 20'000});
+        std::vector<RegexMatch> out;
+        regex.poll(out, std::chrono::milliseconds(1));
+        regex.cancel();
+        while (regex.poll(out, std::chrono::milliseconds(5))) {}
+        CHECK(regex.status() == RegexSearchStatus::cancelled);
+        CHECK(out.size() <= 10'000);
+    }
+
+    SECTION("all matches without limits") {
+        RegexSearch regex(db, "^line \\d+ match$", {.maxMatches = 20'000});
+        CHECK(regex.run().size() == 10'000);
+        CHECK(regex.status() == RegexSearchStatus::completed);
+    }
+
+    CHECK_THROWS_AS(RegexSearch(db, "class (unclosed"), std::runtime_error);
+}
@@ -1,8 +1,17 @@
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
 #include <sqlite3.h>
+#include "content_index_repository.hpp"
 #include "model.hpp"
 #include "resource_repository.hpp"
+#include "schema_migrator.hpp"
 #include "sqldb_raii.hpp"
 
 namespace {
@@ -16,10 +25,10 @@ namespace {
             CREATE TABLE resources (
                 id INTEGER PRIMARY KEY AUTOINCREMENT,
                 title TEXT NOT NULL,
-                type TEXT NOT NULL,
-                file_hash TEXT,
-                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
-                updated_at TEXT DEFAULT CURRENT_TIMESTAMP
+                type INTEGER NOT NULL,
+                file_hash BLOB,
+                created_at INTEGER DEFAULT (unixepoch()),
+                updated_at INTEGER DEFAULT (unixepoch())
             );
 
             CREATE VIRTUAL TABLE resources_fts USING fts5(
@@ -56,14 +65,21 @@ namespace {
         return db;
     }
 
-    Resource makeResource(std::string title, ResourceType type, std::string fileHash = "") {
+    Resource makeResource(std::string title, ResourceType type,
+                          std::optional<FileHash> fileHash = std::nullopt) {
         Resource r{};
         r.title = std::move(title);
         r.type = type;
-        r.file_hash = std::move(fileHash);
+        r.file_hash = fileHash;
 
         return r;
     }
+
+    FileHash hashOf(std::uint8_t seed) {
+        FileHash hash{};
+        hash.fill(std::byte{seed});
+        return hash;
+    }
 } // namespace
 
 TEST_CASE("ResourceRepository basic CRUD", "[ResourceRepository]") {
@@ -71,7 +87,7 @@ TEST_CASE("ResourceRepository basic CRUD", "[ResourceRepository]") {
     ResourceRepository repo(db);
 
     SECTION("insert and getById") {
-        Resource res = makeResource("Doc1", ResourceType::cpp, "hash123");
+        Resource res = makeResource("Doc1", ResourceType::cpp, hashOf(1));
         auto id = repo.insert(res);
 
         auto resOpt = repo.getById(id);
@@ -108,7 +124,7 @@ TEST_CASE("ResourceRepository utility functions", "[ResourceRepository]") {
     ResourceRepository repo(db);
 
     Resource a = makeResource("A", ResourceType::text);
-    Resource b = makeResource("B", ResourceType::pdf, "hashString");
+    Resource b = makeResource("B", ResourceType::pdf, hashOf(2));
     repo.insert(a);
     repo.insert(b);
 
@@ -118,18 +134,18 @@ TEST_CASE("ResourceRepository utility functions", "[ResourceRepository]") {
     }
 
     SECTION("getByFileHash returns correct resource") {
-        auto resOpt = repo.getByFileHash("hashString");
+        auto resOpt = repo.getByFileHash(hashOf(2));
         REQUIRE(resOpt.has_value());
         REQUIRE(resOpt->title == "B");
     }
 
     SECTION("updateFileHash updates value correctly") {
-        auto resOpt = repo.getByFileHash("hashString");
+        auto resOpt = repo.getByFileHash(hashOf(2));
         REQUIRE(resOpt.has_value());
         auto id = resOpt->id;
 
-        repo.updateFileHash(id, "newHash");
-        auto updated = repo.getByFileHash("newHash");
+        repo.updateFileHash(id, hashOf(3));
+        auto updated = repo.getByFileHash(hashOf(3));
         REQUIRE(updated.has_value());
         REQUIRE(updated->title == "B");
         REQUIRE(updated->id == id);
@@ -139,4 +155,208 @@ TEST_CASE("ResourceRepository utility functions", "[ResourceRepository]") {
         auto resOpt = repo.searchByTitleFTS("A");
         REQUIRE_FALSE(resOpt.empty());
     }
+
+    SECTION("timestamps are unix epoch seconds") {
+        sqlite3_exec(db.get(), "UPDATE resources SET created_at = 1704164645 WHERE title = 'A';",
+                     nullptr, nullptr, nullptr);
+
+        auto resOpt = repo.searchByTitleFTS("A");
+        REQUIRE(resOpt.size() == 1);
+        CHECK(epochFromTimestamp(resOpt.front().created_at) == 1704164645);
+        CHECK(resOpt.front().updated_at > resOpt.front().created_at);
+
+        auto times = repo.getTimestamps(resOpt.front().id);
+        REQUIRE(times.has_value());
+        CHECK(times->first == resOpt.front().created_at);
+        CHECK(times->second == resOpt.front().updated_at);
+    }
+}
+
+TEST_CASE("SchemaMigrator v8 converts resources to integer columns", "[SchemaMigrator]") {
+    SQLiteDB db(":memory:");
+    const char* schema = R"SQL(
+        CREATE TABLE resources (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL,
+            type TEXT NOT NULL,
+            file_hash TEXT UNIQUE NULL,
+            created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            updated_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            UNIQUE (title, type)
+        );
+
+        CREATE TABLE files (
+            resource_id INTEGER PRIMARY KEY,
+            stored_path TEXT,
+            original_path TEXT NOT NULL,
+            is_managed INTEGER NOT NULL DEFAULT 0,
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+
+        CREATE VIRTUAL TABLE resources_fts USING fts5(title);
+
+        CREATE TRIGGER resources_insert_fts AFTER INSERT ON resources
+        BEGIN
+            INSERT INTO resources_fts (rowid, title) VALUES (new.id, new.title);
+        END;
+
+        INSERT INTO resources (id, title, type, created_at, updated_at)
+        VALUES (1, 'notes', 'text', '2024-01-02 03:04:05', '2024-01-02 03:04:05'),
+               (2, 'manual', 'pdf', '2024-01-02 03:04:05', '2024-02-01 00:00:00'),
+               (3, 'gone', 'cpp', '2024-01-02 03:04:05', '2024-01-02 03:04:05');
+        DELETE FROM resources WHERE id = 3;
+
+        INSERT INTO files (resource_id, original_path) VALUES (2, '/docs/manual.pdf');
+    )SQL";
+    REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    CHECK(SchemaMigrator(db).migrate() == SchemaMigrator::kCurrentVersion);
+
+    ResourceRepository repo(db);
+    auto manual = repo.getById(2);
+    REQUIRE(manual.has_value());
+    CHECK(manual->type == ResourceType::pdf);
+    CHECK(epochFromTimestamp(manual->created_at) == 1704164645);
+    CHECK(epochFromTimestamp(manual->updated_at) == 1706745600);
+
+    {
+        SQLiteStmt stmt(db.get(), "SELECT typeof(type), typeof(created_at) FROM resources;");
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            CHECK(std::string_view(reinterpret_cast<const char*>(
+                      sqlite3_column_text(stmt.get(), 0))) == "integer");
+            CHECK(std::string_view(reinterpret_cast<const char*>(
+                      sqlite3_column_text(stmt.get(), 1))) == "integer");
+        }
+    }
+
+    // Bảng con không bị cascade khi dựng lại resources, FTS vẫn theo dõi bảng mới
+    {
+        SQLiteStmt stmt(db.get(), "SELECT COUNT(*) FROM files;");
+        REQUIRE(sqlite3_step(stmt.get()) == SQLITE_ROW);
+        CHECK(sqlite3_column_int(stmt.get(), 0) == 1);
+    }
+
+    const auto id = repo.insert(makeResource("fresh", ResourceType::epub));
+    CHECK(id == 4); // id 3 đã xóa không được cấp lại
+    CHECK(repo.searchByTitleFTS("fresh").size() == 1);
+
+    // foreign_keys được bật lại sau migration
+    repo.remove(2);
+    SQLiteStmt stmt(db.get(), "SELECT COUNT(*) FROM files;");
+    REQUIRE(sqlite3_step(stmt.get()) == SQLITE_ROW);
+    CHECK(sqlite3_column_int(stmt.get(), 0) == 0);
+}
+
+TEST_CASE("SchemaMigrator v8 fails on rows orphaned by the resources rebuild",
+          "[SchemaMigrator]") {
+    SQLiteDB db(":memory:");
+    const char* schema = R"SQL(
+        CREATE TABLE resources (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL,
+            type TEXT NOT NULL,
+            file_hash TEXT UNIQUE NULL,
+            created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            updated_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            UNIQUE (title, type)
+        );
+
+        CREATE TABLE files (
+            resource_id INTEGER PRIMARY KEY,
+            stored_path TEXT,
+            original_path TEXT NOT NULL,
+            is_managed INTEGER NOT NULL DEFAULT 0,
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+
+        INSERT INTO resources (id, title, type) VALUES (1, 'notes', 'text');
+
+        -- Dòng files không có resource (ghi khi foreign_keys còn tắt)
+        PRAGMA foreign_keys = OFF;
+        INSERT INTO files (resource_id, original_path) VALUES (7, '/docs/lost.pdf');
+        PRAGMA foreign_keys = ON;
+    )SQL";
+    REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    SchemaMigrator migrator(db);
+    CHECK_THROWS_AS(migrator.migrate(), std::runtime_error);
+
+    // Bước v8 rollback: resources giữ cột TEXT, không còn transaction mở
+    CHECK(migrator.userVersion() == 7);
+    CHECK(sqlite3_get_autocommit(db.get()) != 0);
+    SQLiteStmt stmt(db.get(), "SELECT typeof(type) FROM resources;");
+    REQUIRE(sqlite3_step(stmt.get()) == SQLITE_ROW);
+    CHECK(std::string_view(reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0))) ==
+          "text");
+}
+
+TEST_CASE("SchemaMigrator v9 stores file hashes as BLOB", "[SchemaMigrator]") {
+    SQLiteDB db(":memory:");
+    const char* schema = R"SQL(
+        CREATE TABLE resources (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            title TEXT NOT NULL,
+            type TEXT NOT NULL,
+            file_hash TEXT UNIQUE NULL,
+            created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            updated_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            UNIQUE (title, type)
+        );
+
+        CREATE TABLE files (
+            resource_id INTEGER PRIMARY KEY,
+            stored_path TEXT,
+            original_path TEXT NOT NULL,
+            is_managed INTEGER NOT NULL DEFAULT 0,
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+
+        CREATE TABLE file_index_state (
+            resource_id  INTEGER PRIMARY KEY,
+            indexed_hash TEXT NOT NULL,
+            chunk_count  INTEGER NOT NULL DEFAULT 0,
+            error        TEXT NULL,
+            indexed_at   TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+        );
+
+        INSERT INTO resources (id, title, type, file_hash) VALUES
+            (1, 'hello', 'pdf',
+             '2cf24dba5fb0a30e26e83b2ac5b9e29e1b161e5c1fa7425e73043362938b9824'),
+            (2, 'broken', 'pdf', 'not-a-hash'),
+            (3, 'note', 'text', NULL);
+
+        INSERT INTO file_index_state (resource_id, indexed_hash) VALUES
+            (1, '2cf24dba5fb0a30e26e83b2ac5b9e29e1b161e5c1fa7425e73043362938b9824'),
+            (2, 'not-a-hash');
+
+        PRAGMA user_version = 7;
+    )SQL";
+    REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+    REQUIRE(SchemaMigrator(db).migrate() == SchemaMigrator::kCurrentVersion - 7);
+
+    ResourceRepository repo(db);
+    const auto hello = fileHashFromHex(
+        "2cf24dba5fb0a30e26e83b2ac5b9e29e1b161e5c1fa7425e73043362938b9824");
+    REQUIRE(hello.has_value());
+
+    auto found = repo.getByFileHash(*hello);
+    REQUIRE(found.has_value());
+    CHECK(found->id == 1);
+    CHECK(found->file_hash == hello);
+
+    // Hash hỏng bị bỏ, note không có hash vẫn NULL
+    SQLiteStmt stmt(db.get(), "SELECT id, typeof(file_hash), length(file_hash) FROM resources "
+                              "ORDER BY id;");
+    std::vector<std::string> types;
+    while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+        types.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 1)));
+        if (types.back() == "blob") { CHECK(sqlite3_column_int(stmt.get(), 2) == 32); }
+    }
+    CHECK(types == std::vector<std::string>{"blob", "null", "null"});
+
+    // Trạng thái index khớp hash đã chuyển; trạng thái hỏng bị xóa để index lại
+    ContentIndexRepository indexRepo(db);
+    CHECK(indexRepo.getIndexedHash(1) == hello);
+    CHECK_FALSE(indexRepo.getIndexedHash(2).has_value());
 }
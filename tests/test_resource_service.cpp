@@ -24,10 +24,10 @@ namespace {
         CREATE TABLE resources (
             id INTEGER PRIMARY KEY AUTOINCREMENT,
             title TEXT NOT NULL,
-            type TEXT NOT NULL,
-            file_hash TEXT,
-            created_at TEXT DEFAULT CURRENT_TIMESTAMP,
-            updated_at TEXT DEFAULT CURRENT_TIMESTAMP
+            type INTEGER NOT NULL,
+            file_hash BLOB,
+            created_at INTEGER DEFAULT (unixepoch()),
+            updated_at INTEGER DEFAULT (unixepoch())
         );
 
         CREATE VIRTUAL TABLE resources_fts
@@ -45,8 +45,35 @@ namespace {
             content TEXT
         );
 
-        CREATE VIRTUAL TABLE text_content_fts
-            USING fts5(content, content='text_content', content_rowid='resource_id');
+        CREATE TABLE text_chunks (
+            id INTEGER PRIMARY KEY,
+            resource_id INTEGER NOT NULL,
+            chunk_no INTEGER NOT NULL,
+            byte_offset INTEGER NOT NULL,
+            byte_len INTEGER NOT NULL,
+            line_count INTEGER NOT NULL
+        );
+
+        CREATE VIEW text_chunk_texts AS
+        SELECT c.id AS id, note_slice(t.content, c.byte_offset, c.byte_len) AS content
+        FROM text_chunks c JOIN text_content t ON t.resource_id = c.resource_id;
+
+        CREATE VIRTUAL TABLE text_chunks_fts
+            USING fts5(content, content='text_chunk_texts', content_rowid='id');
+
+        CREATE TRIGGER text_chunks_insert_fts AFTER INSERT ON text_chunks BEGIN
+            INSERT INTO text_chunks_fts (rowid, content)
+            SELECT id, content FROM text_chunk_texts WHERE id = new.id;
+        END;
+
+        CREATE TRIGGER text_chunks_delete_fts BEFORE DELETE ON text_chunks BEGIN
+            INSERT INTO text_chunks_fts (text_chunks_fts, rowid, content)
+            SELECT 'delete', id, content FROM text_chunk_texts WHERE id = old.id;
+        END;
+
+        CREATE TRIGGER text_content_delete_chunks BEFORE DELETE ON text_content BEGIN
+            DELETE FROM text_chunks WHERE resource_id = old.resource_id;
+        END;
 
         -- =====================================================
         -- Tagging system
@@ -127,7 +154,7 @@ TEST_CASE("ResourceService getFullResource combines repositories correctly", "[R
     createMinimalSchema(db.get());
 
     sqlite3_exec(db.get(),
-                 "INSERT INTO resources (title, type) VALUES ('Doc1', 'text');"
+                 "INSERT INTO resources (title, type) VALUES ('Doc1', 0);"
                  "INSERT INTO text_content VALUES (1, 'hello');"
                  "INSERT INTO tags (name) VALUES ('qt');"
                  "INSERT INTO resource_tags VALUES (1, 1);",
@@ -162,7 +189,7 @@ TEST_CASE("ResourceService deleteResource removes managed files", "[ResourceServ
     std::ofstream(tmpFile) << "dummy";
 
     sqlite3_stmt* stmt{};
-    sqlite3_prepare_v2(db.get(), "INSERT INTO resources (title, type) VALUES ('F', 'pdf');", -1,
+    sqlite3_prepare_v2(db.get(), "INSERT INTO resources (title, type) VALUES ('F', 2);", -1,
                        &stmt, nullptr);
     sqlite3_step(stmt);
     sqlite3_finalize(stmt);
@@ -188,7 +215,7 @@ TEST_CASE("ResourceService addTagToResource handles existing/new tags correctly"
     FileService fileService(db, fileRepo, resRepo);
 
     sqlite3_exec(db.get(),
-                 "INSERT INTO resources (title, type) VALUES ('Doc', 'text');"
+                 "INSERT INTO resources (title, type) VALUES ('Doc', 0);"
                  "INSERT INTO tags (name) VALUES ('qt');",
                  nullptr, nullptr, nullptr);
 
@@ -213,7 +240,7 @@ TEST_CASE("ResourceService isExistTitle delegates correctly", "[ResourceService]
     SQLiteDB db(":memory:");
     createMinimalSchema(db.get());
 
-    sqlite3_exec(db.get(), "INSERT INTO resources (title, type) VALUES ('abc', 'pdf');", nullptr,
+    sqlite3_exec(db.get(), "INSERT INTO resources (title, type) VALUES ('abc', 2);", nullptr,
                  nullptr, nullptr);
 
     ResourceRepository resRepo(db);
@@ -232,8 +259,8 @@ TEST_CASE("ResourceService searchByTitleFull aggregates results", "[ResourceServ
 
     sqlite3_exec(db.get(),
                  "INSERT INTO resources (title, type) VALUES "
-                 "('Learn Qt', 'text'),"
-                 "('Qt GUI', 'text');"
+                 "('Learn Qt', 0),"
+                 "('Qt GUI', 0);"
                  "INSERT INTO text_content VALUES (1, 'intro c++');"
                  "INSERT INTO text_content VALUES (2, 'qt tutorial');"
                  "INSERT INTO tags (name) VALUES ('cpp'), ('qt');"
@@ -262,20 +289,19 @@ TEST_CASE("ResourceService searchByContentFull aggregates results", "[ResourceSe
 
     sqlite3_exec(db.get(),
                  "INSERT INTO resources (title, type) VALUES "
-                 "('Doc1', 'text'),"
-                 "('Doc2', 'text');"
+                 "('Doc1', 0),"
+                 "('Doc2', 0);"
                  "INSERT INTO text_content VALUES (1, 'C plus plus intro');"
                  "INSERT INTO text_content VALUES (2, 'Qt advanced plus');"
                  "INSERT INTO tags (name) VALUES ('cpp'), ('qt');"
                  "INSERT INTO resource_tags VALUES (1, 1);"
-                 "INSERT INTO resource_tags VALUES (2, 2);"
-                 "INSERT INTO text_content_fts(rowid, content) "
-                 "SELECT resource_id, content FROM text_content;",
+                 "INSERT INTO resource_tags VALUES (2, 2);",
                  nullptr, nullptr, nullptr);
 
     ResourceRepository resRepo(db);
     FileRepository fileRepo(db);
     TextContentRepository textRepo(db);
+    REQUIRE(textRepo.reindexAll() == 2);
     TagRepository tagRepo(db);
     FileService fileService(db, fileRepo, resRepo);
 
@@ -285,3 +311,108 @@ TEST_CASE("ResourceService searchByContentFull aggregates results", "[ResourceSe
     REQUIRE(results.size() == 2);
     CHECK(results[0].resource.title == "Doc1");
 }
+
+TEST_CASE("ResourceService returns search results in one SearchResult", "[ResourceService]") {
+    SQLiteDB db(":memory:");
+    createMinimalSchema(db.get());
+
+    sqlite3_exec(db.get(),
+                 "INSERT INTO resources (title, type) VALUES "
+                 "('Qt plus', 0),"
+                 "('Qt lib', 1),"
+                 "('Qt lost', 1);"
+                 "INSERT INTO text_content VALUES (1, 'plus intro');"
+                 "INSERT INTO files VALUES (2, NULL, '/src/lib.cpp', 0);"
+                 "INSERT INTO tags (name) VALUES ('cpp'), ('qt');"
+                 "INSERT INTO resource_tags VALUES (1, 2);"
+                 "INSERT INTO resource_tags VALUES (2, 1);"
+                 "INSERT INTO resource_tags VALUES (2, 2);"
+                 "INSERT INTO resources_fts(rowid, title) VALUES (1, 'Qt plus');"
+                 "INSERT INTO resources_fts(rowid, title) VALUES (2, 'Qt lib');"
+                 "INSERT INTO resources_fts(rowid, title) VALUES (3, 'Qt lost');",
+                 nullptr, nullptr, nullptr);
+
+    ResourceRepository resRepo(db);
+    FileRepository fileRepo(db);
+    TextContentRepository textRepo(db);
+    REQUIRE(textRepo.reindexAll() == 1);
+    TagRepository tagRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+
+    ResourceService service(db, resRepo, fileRepo, textRepo, tagRepo, fileService);
+
+    // Resource 3 là file nhưng không có dòng files: bị bỏ qua như getFullResource
+    const auto byTitle = service.searchByTitleResult("Qt");
+    REQUIRE(byTitle.size() == 2);
+    CHECK(byTitle[0].title == "Qt plus");
+    CHECK_FALSE(byTitle[0].path.has_value());
+    CHECK(byTitle[1].path == "/src/lib.cpp");
+    CHECK(byTitle[1].tags.size() == 2);
+
+    const auto byTag = service.getResultByTag("cpp");
+    REQUIRE(byTag.size() == 1);
+    CHECK(byTag[0].id == 2);
+
+    const auto byContent = service.searchByContentResult("plus");
+    REQUIRE(byContent.size() == 1);
+    REQUIRE(byContent[0].hit.has_value());
+    CHECK(byContent[0].hit->snippet.find("plus") != std::string_view::npos);
+    CHECK(byContent[0].tags.size() == 1);
+}
+
+TEST_CASE("ResourceService pages search results", "[ResourceService]") {
+    SQLiteDB db(":memory:");
+    createMinimalSchema(db.get());
+
+    SQLiteStmt insert(db.get(), "INSERT INTO resources (title, type) VALUES (?, 0);");
+    SQLiteStmt index(db.get(), "INSERT INTO resources_fts(rowid, title) VALUES (?, ?);");
+    for (int i = 1; i <= 25; ++i) {
+        const auto title = "page note " + std::to_string(i);
+        sqlite3_reset(insert.get());
+        sqlite3_bind_text(insert.get(), 1, title.c_str(), -1, SQLITE_TRANSIENT);
+        REQUIRE(sqlite3_step(insert.get()) == SQLITE_DONE);
+
+        sqlite3_reset(index.get());
+        sqlite3_bind_int(index.get(), 1, i);
+        sqlite3_bind_text(index.get(), 2, title.c_str(), -1, SQLITE_TRANSIENT);
+        REQUIRE(sqlite3_step(index.get()) == SQLITE_DONE);
+    }
+
+    ResourceRepository resRepo(db);
+    FileRepository fileRepo(db);
+    TextContentRepository textRepo(db);
+    TagRepository tagRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+
+    ResourceService service(db, resRepo, fileRepo, textRepo, tagRepo, fileService);
+
+    std::vector<sqlite3_int64> ids;
+    std::size_t offset{0};
+    for (bool last = false; !last; offset += 10) {
+        auto page = service.searchByTitlePage("page", offset, 10);
+        for (std::size_t i = 0; i < page.result.size(); ++i) { ids.push_back(page.result[i].id); }
+        last = page.last;
+    }
+
+    CHECK(offset == 30);
+    REQUIRE(ids.size() == 25);
+    CHECK(ids.front() == 1);
+    CHECK(ids.back() == 25);
+
+    // Trang của danh sách hit có sẵn giữ snippet theo đúng hit
+    const std::vector<ContentHit> hits{{.resource_id = 3, .snippet = "three"},
+                                       {.resource_id = 99, .snippet = "gone"},
+                                       {.resource_id = 4, .snippet = "four"}};
+    auto first = service.contentHitPage(hits, 0, 2);
+    CHECK_FALSE(first.last);
+    REQUIRE(first.result.size() == 1);
+    CHECK(first.result[0].hit->snippet == "three");
+
+    auto second = service.contentHitPage(hits, 2, 2);
+    CHECK(second.last);
+    REQUIRE(second.result.size() == 1);
+    CHECK(second.result[0].id == 4);
+    CHECK(second.result[0].hit->snippet == "four");
+
+    CHECK(service.contentHitPage(hits, 10, 2).result.empty());
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <set>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "ResultsModel.hpp"
+#include "model.hpp"
+#include "search_result.hpp"
+
+namespace {
+    constexpr auto kTotal{static_cast<sqlite3_int64>(ResultsModel::PAGE_SIZE * 2)};
+
+    // Trang [offset, offset + limit) của ids, bỏ qua id trong deleted (như contentHitPage/idPage)
+    SearchPage pageOf(const std::vector<sqlite3_int64> &ids, const std::set<sqlite3_int64> &deleted,
+                      std::size_t offset, std::size_t limit) {
+        SearchPage page;
+        const auto end = std::min(ids.size(), offset + limit);
+        for (auto i = std::min(offset, end); i < end; ++i) {
+            if (deleted.contains(ids[i])) { continue; }
+            page.result.add(ids[i], ResourceType::text, "note " + std::to_string(ids[i]),
+                            std::nullopt, {}, {});
+        }
+        page.last = end == ids.size();
+        return page;
+    }
+
+    std::vector<sqlite3_int64> rowIds(const ResultsModel &model) {
+        std::vector<sqlite3_int64> ids;
+        for (int row = 0; row < model.rowCount(); ++row) { ids.push_back(model.entry(row)->id); }
+        return ids;
+    }
+
+    std::vector<sqlite3_int64> idRange(sqlite3_int64 first, sqlite3_int64 last) {
+        std::vector<sqlite3_int64> ids;
+        for (auto id = first; id <= last; ++id) { ids.push_back(id); }
+        return ids;
+    }
+} // namespace
+
+TEST_CASE("ResultsModel keeps paging a snapshot in place after removing rows",
+          "[GUI][ResultsModel]") {
+    auto ids = idRange(1, kTotal);
+
+    // Danh sách chụp sẵn không ngắn đi khi xóa, trang chỉ bỏ qua id đã xóa
+    std::set<sqlite3_int64> deleted;
+    ResultsModel model;
+    model.setSource(
+        [&ids, &deleted](std::size_t offset, std::size_t limit) {
+            return pageOf(ids, deleted, offset, limit);
+        },
+        ResultsModel::Paging::snapshot);
+    REQUIRE(model.rowCount() == static_cast<int>(ResultsModel::PAGE_SIZE));
+
+    deleted.insert(1);
+    REQUIRE(model.removeRows(0, 1));
+
+    REQUIRE(model.canFetchMore(QModelIndex()));
+    model.fetchMore(QModelIndex());
+    CHECK(rowIds(model) == idRange(2, kTotal));
+}
+
+TEST_CASE("ResultsModel steps a re-run query back after removing rows", "[GUI][ResultsModel]") {
+    auto ids = idRange(1, kTotal);
+
+    // Truy vấn chạy lại không còn resource đã xóa: các dòng sau lùi lên
+    ResultsModel model;
+    model.setSource([&ids](std::size_t offset, std::size_t limit) {
+        return pageOf(ids, {}, offset, limit);
+    });
+    REQUIRE(model.rowCount() == static_cast<int>(ResultsModel::PAGE_SIZE));
+
+    ids.erase(ids.begin());
+    REQUIRE(model.removeRows(0, 1));
+
+    REQUIRE(model.canFetchMore(QModelIndex()));
+    model.fetchMore(QModelIndex());
+    CHECK(rowIds(model) == idRange(2, kTotal));
+}
@@ -0,0 +1,160 @@
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "revision_repository.hpp"
+#include "schema_migrator.hpp"
+#include "sqldb_raii.hpp"
+#include "text_content_repository.hpp"
+#include "text_delta.hpp"
+
+namespace {
+    void createRevisionSchema(SQLiteDB &db) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type TEXT NOT NULL,
+                file_hash TEXT UNIQUE,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                UNIQUE (title, type)
+            );
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0,
+                FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+            );
+
+            CREATE TABLE text_content (
+                resource_id INTEGER PRIMARY KEY,
+                content TEXT NOT NULL,
+                FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+            );
+
+            INSERT INTO resources (id, title, type) VALUES (1, 'journal', 'text');
+            INSERT INTO resources (id, title, type) VALUES (2, 'scratch', 'text');
+        )SQL";
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+        SchemaMigrator(db).migrate();
+    }
+
+    std::string journal(int edits) {
+        std::string text;
+        for (int line = 1; line <= 400; ++line) {
+            text += "entry " + std::to_string(line) + " of the journal, lorem ipsum dolor\n";
+        }
+        for (int n = 1; n <= edits; ++n) {
+            const auto at = text.find("entry " + std::to_string(n * 10) + " ");
+            text.replace(at, 5, "edit" + std::to_string(n));
+        }
+        return text;
+    }
+} // namespace
+
+TEST_CASE("TextDelta encodes edits as copies of the base", "[RevisionRepository]") {
+    const auto base = journal(0);
+
+    SECTION("small edit in a long text") {
+        auto target = base;
+        target.replace(target.find("entry 200 "), 5, "changed");
+
+        const auto delta = TextDelta::make(base, target);
+        CHECK(delta.size() < 32);
+        CHECK(TextDelta::apply(base, delta) == target);
+    }
+
+    SECTION("moved and inserted blocks") {
+        const auto cut = base.find("entry 100 ");
+        const auto end = base.find("entry 150 ");
+        auto target = base.substr(cut, end - cut) + "new heading\n" + base.substr(0, cut) +
+                      base.substr(end);
+
+        const auto delta = TextDelta::make(base, target);
+        CHECK(delta.size() < 64);
+        CHECK(TextDelta::apply(base, delta) == target);
+    }
+
+    SECTION("unrelated and empty texts") {
+        CHECK(TextDelta::apply("", TextDelta::make("", "fresh")) == "fresh");
+        CHECK(TextDelta::apply("old", TextDelta::make("old", "")).empty());
+        CHECK(TextDelta::apply("abc", TextDelta::make("abc", "xyz")) == "xyz");
+    }
+
+    SECTION("corrupted delta") {
+        auto delta = TextDelta::make(base, base + "tail");
+        CHECK_THROWS_AS(TextDelta::apply(base.substr(0, 100), delta), std::runtime_error);
+        delta.pop_back();
+        CHECK_THROWS_AS(TextDelta::apply(base, delta), std::runtime_error);
+    }
+}
+
+TEST_CASE("RevisionRepository keeps bounded delta chains", "[RevisionRepository]") {
+    SQLiteDB db(":memory:");
+    createRevisionSchema(db);
+
+    RevisionRepository revisions(db, {.maxChainDepth = 4, .keepRevisions = 9});
+    TextContentRepository textRepo(db, &revisions);
+
+    textRepo.insertText(1, journal(0));
+    CHECK(revisions.getRevisions(1).empty()); // chưa sửa lần nào
+
+    for (int n = 1; n <= 30; ++n) { textRepo.updateText(1, journal(n)); }
+    textRepo.updateText(1, journal(30)); // không đổi: không thêm phiên bản
+
+    auto list = revisions.getRevisions(1);
+    REQUIRE(list.size() == 31);
+
+    // Snapshot cho bản gốc, rồi cứ sau 4 delta một snapshot
+    for (std::size_t i = 0; i < list.size(); ++i) {
+        CHECK(list[i].revision == static_cast<std::int64_t>(i + 1));
+        CHECK(list[i].is_snapshot == (i % 5 == 0));
+        CHECK(list[i].size == static_cast<std::int64_t>(journal(static_cast<int>(i)).size()));
+        if (!list[i].is_snapshot) { CHECK(list[i].stored_size < 64); }
+    }
+
+    for (int n = 0; n <= 30; ++n) { CHECK(revisions.getRevisionText(1, n + 1) == journal(n)); }
+    CHECK_FALSE(revisions.getRevisionText(1, 32).has_value());
+    CHECK_FALSE(revisions.getRevisionText(2, 1).has_value());
+
+    SECTION("compaction keeps the newest revisions readable") {
+        CHECK(revisions.getNotesToCompact(10) == std::vector<sqlite3_int64>{1});
+        CHECK(revisions.compact(1) == 22); // phiên bản 23 là delta: được ghi lại thành snapshot
+        CHECK(revisions.getNotesToCompact(10).empty());
+        CHECK(revisions.compact(1) == 0);
+
+        list = revisions.getRevisions(1);
+        REQUIRE(list.size() == 9);
+        CHECK(list.front().revision == 23);
+        CHECK(list.front().is_snapshot);
+        for (const auto &info : list) {
+            CHECK(revisions.getRevisionText(1, info.revision) ==
+                  journal(static_cast<int>(info.revision - 1)));
+        }
+
+        // Ghi tiếp sau khi compact
+        textRepo.updateText(1, journal(31));
+        CHECK(revisions.getRevisionText(1, 32) == journal(31));
+    }
+
+    SECTION("edits made without history start a new snapshot") {
+        TextContentRepository(db).updateText(1, "rewritten outside of history");
+        textRepo.updateText(1, "rewritten outside of history, then edited");
+
+        list = revisions.getRevisions(1);
+        REQUIRE(list.size() == 33);
+        CHECK(list[31].is_snapshot);
+        CHECK(revisions.getRevisionText(1, 32) == "rewritten outside of history");
+        CHECK(revisions.getRevisionText(1, 33) == "rewritten outside of history, then edited");
+    }
+
+    SECTION("deleting the note drops its history") {
+        SQLiteStmt stmt(db.get(), "DELETE FROM resources WHERE id = 1;");
+        REQUIRE(sqlite3_step(stmt.get()) == SQLITE_DONE);
+        CHECK(revisions.getRevisions(1).empty());
+    }
+}
@@ -0,0 +1,216 @@
+#include <catch2/catch_test_macros.hpp>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <sqlite3.h>
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+#include "resource_repository.hpp"
+#include "resource_service.hpp"
+#include "schema_migrator.hpp"
+#include "search_cache.hpp"
+#include "search_indexes.hpp"
+#include "sqldb_raii.hpp"
+#include "tag_repository.hpp"
+#include "text_content_repository.hpp"
+#include "write_generations.hpp"
+
+namespace {
+    void createSchema(SQLiteDB &db) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type TEXT NOT NULL,
+                file_hash TEXT UNIQUE,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                UNIQUE (title, type)
+            );
+
+            CREATE VIRTUAL TABLE resources_fts USING fts5(title);
+
+            CREATE TRIGGER resources_insert_fts AFTER INSERT ON resources
+            BEGIN
+                INSERT INTO resources_fts (rowid, title) VALUES (new.id, new.title);
+            END;
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0,
+                FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+            );
+
+            CREATE TABLE text_content (
+                resource_id INTEGER PRIMARY KEY,
+                content TEXT NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE text_content_fts USING fts5(content);
+
+            CREATE TABLE tags (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT UNIQUE NOT NULL);
+            CREATE TABLE resource_tags (resource_id INTEGER, tag_id INTEGER,
+                                        PRIMARY KEY (resource_id, tag_id));
+        )SQL";
+
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+        SchemaMigrator(db).migrate();
+    }
+
+    void exec(SQLiteDB &db, const char* sql) {
+        REQUIRE(sqlite3_exec(db.get(), sql, nullptr, nullptr, nullptr) == SQLITE_OK);
+    }
+
+    std::vector<sqlite3_int64> idsOf(const SearchPage &page) {
+        std::vector<sqlite3_int64> ids;
+        for (std::size_t i = 0; i < page.result.size(); ++i) { ids.push_back(page.result[i].id); }
+        return ids;
+    }
+
+    struct Fixture {
+            SQLiteDB db{":memory:"};
+            FileRepository fileRepo{db};
+            ResourceRepository resRepo{db};
+            TextContentRepository textRepo{db};
+            TagRepository tagRepo{db};
+            FileService fileService{db, fileRepo, resRepo};
+            ResourceService resService{db, resRepo, fileRepo, textRepo, tagRepo, fileService};
+
+            Fixture() { createSchema(db); }
+    };
+} // namespace
+
+TEST_CASE("WriteGenerations counts writes per table", "[SearchCache]") {
+    Fixture f;
+    const auto &generations = f.db.generations();
+    const auto version = [&](std::string_view table) {
+        return generations.version(std::array{table});
+    };
+
+    const auto note = f.resService.addTextResource("ring", "ring buffer", ResourceType::text);
+
+    const auto tags = version("tags");
+    const auto chunks = version("text_chunks");
+    CHECK(f.resService.searchContentHits(std::string("ring")).size() == 1);
+    CHECK(version("tags") == tags); // đọc không tăng
+
+    f.resService.addTagToResource(note, "cpp");
+    CHECK(version("tags") != tags);
+    CHECK(version("text_chunks") == chunks);
+
+    // Chunk bị xóa theo resource (ON DELETE CASCADE) cũng được đếm
+    f.resService.deleteResource(note);
+    CHECK(version("text_chunks") != chunks);
+
+    CHECK_FALSE(generations.inTransaction());
+    exec(f.db, "BEGIN;");
+    CHECK(generations.inTransaction());
+    exec(f.db, "COMMIT;");
+}
+
+TEST_CASE("SearchCache serves repeated searches until a dependent table changes",
+          "[SearchCache]") {
+    Fixture f;
+    SearchCache cache(f.db.generations(), 1024 * 1024);
+    using Mode = SearchCache::Mode;
+
+    const auto ring = f.resService.addTextResource("ring buffer", "lock-free ring",
+                                                   ResourceType::text);
+    f.resService.addTextResource("mutex notes", "std::mutex and ring", ResourceType::text);
+
+    int titleRuns{0};
+    const auto titlePage = [&](std::string_view keyword) {
+        return cache.page(SearchCache::pageKey(Mode::title, keyword, 0, 50), [&] {
+            ++titleRuns;
+            return f.resService.searchByTitlePage(std::string(keyword), 0, 50);
+        });
+    };
+
+    int contentRuns{0};
+    const auto contentMatches = [&](std::string_view keyword) {
+        return cache.matches(SearchCache::matchesKey(Mode::content, keyword), [&] {
+            ++contentRuns;
+            return QueryMatches{.ids = {},
+                                .hits = f.resService.searchContentHits(std::string(keyword)),
+                                .plan = {}};
+        });
+    };
+
+    const auto first = titlePage("ring");
+    const auto second = titlePage("  ring ");
+    CHECK(titleRuns == 1);
+    CHECK(idsOf(second) == idsOf(first));
+    CHECK(second.result[0].title == "ring buffer");
+    CHECK(second.last == first.last);
+
+    CHECK(contentMatches("ring")->hits.size() == 2);
+    CHECK(contentMatches("ring")->hits.size() == 2);
+    CHECK(contentRuns == 1);
+    CHECK(cache.size() == 2);
+    CHECK(cache.stats().hits == 2);
+
+    SECTION("a tag invalidates pages but not content hits") {
+        f.resService.addTagToResource(ring, "ds");
+
+        CHECK(titlePage("ring").result[0].tags.size() == 1);
+        CHECK(titleRuns == 2);
+        CHECK(cache.stats().stale == 1);
+
+        contentMatches("ring");
+        CHECK(contentRuns == 1);
+    }
+
+    SECTION("new content is found after a write") {
+        f.resService.addTextResource("third", "ring again", ResourceType::text);
+        CHECK(contentMatches("ring")->hits.size() == 3);
+        CHECK(contentRuns == 2);
+    }
+
+    SECTION("schema changes invalidate content hits") {
+        REQUIRE(SearchIndexes(f.db).setContentTrigram(true));
+        contentMatches("ring");
+        CHECK(contentRuns == 2);
+    }
+
+    SECTION("results read inside a transaction are not cached") {
+        exec(f.db, "BEGIN;");
+        f.resService.addTextResource("pending", "ring pending", ResourceType::text);
+        CHECK(contentMatches("ring")->hits.size() == 3);
+        exec(f.db, "ROLLBACK;");
+
+        CHECK(contentMatches("ring")->hits.size() == 2);
+        CHECK(contentRuns == 3);
+    }
+
+    SECTION("budget evicts the least recently used entries") {
+        const auto used = cache.usedBytes();
+        cache.setBudget(used);
+        titlePage("ring"); // lên đầu
+        titlePage("mutex");
+        CHECK(cache.usedBytes() <= cache.budget());
+        CHECK(cache.stats().evictions >= 1);
+
+        const auto runs = titleRuns;
+        titlePage("mutex");
+        CHECK(titleRuns == runs);
+
+        cache.setBudget(0);
+        CHECK(cache.size() == 0);
+        CHECK(cache.usedBytes() == 0);
+    }
+}
+
+TEST_CASE("normalizeSearchQuery collapses whitespace outside phrases", "[SearchCache]") {
+    CHECK(normalizeSearchQuery("  ring \t buffer\n") == "ring buffer");
+    CHECK(normalizeSearchQuery(R"(tag:cpp   content:"a  b")") == R"(tag:cpp content:"a  b")");
+    CHECK(normalizeSearchQuery(" *a  b ") == "*a  b");
+
+    // tag so khớp đúng tên nên không chuẩn hóa
+    CHECK(SearchCache::pageKey(SearchCache::Mode::tag, "a  b", 0, 10).query == "a  b");
+    CHECK(SearchCache::pageKey(SearchCache::Mode::title, "a  b", 0, 10).query == "a b");
+}
@@ -0,0 +1,170 @@
+#include <catch2/catch_test_macros.hpp>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+#include "resource_repository.hpp"
+#include "resource_service.hpp"
+#include "schema_migrator.hpp"
+#include "search_facets.hpp"
+#include "search_query.hpp"
+#include "sqldb_raii.hpp"
+#include "tag_repository.hpp"
+#include "text_content_repository.hpp"
+
+namespace {
+    void createSchema(SQLiteDB &db) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type TEXT NOT NULL,
+                file_hash TEXT UNIQUE,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                UNIQUE (title, type)
+            );
+
+            CREATE VIRTUAL TABLE resources_fts USING fts5(title);
+
+            CREATE TRIGGER resources_insert_fts AFTER INSERT ON resources
+            BEGIN
+                INSERT INTO resources_fts (rowid, title) VALUES (new.id, new.title);
+            END;
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0,
+                FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+            );
+
+            CREATE TABLE text_content (
+                resource_id INTEGER PRIMARY KEY,
+                content TEXT NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE text_content_fts USING fts5(content);
+
+            CREATE TABLE tags (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT UNIQUE NOT NULL);
+            CREATE TABLE resource_tags (resource_id INTEGER, tag_id INTEGER,
+                                        PRIMARY KEY (resource_id, tag_id));
+        )SQL";
+
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+        SchemaMigrator(db).migrate();
+    }
+
+    using Counts = std::vector<std::pair<std::string, std::size_t>>;
+
+    Counts countsOf(const std::vector<FacetCount> &facets) {
+        Counts counts;
+        for (const auto &facet : facets) { counts.emplace_back(facet.name, facet.count); }
+        return counts;
+    }
+
+    struct Fixture {
+            SQLiteDB db{":memory:"};
+            FileRepository fileRepo{db};
+            ResourceRepository resRepo{db};
+            TextContentRepository textRepo{db};
+            TagRepository tagRepo{db};
+            FileService fileService{db, fileRepo, resRepo};
+            ResourceService resService{db, resRepo, fileRepo, textRepo, tagRepo, fileService};
+
+            Fixture() { createSchema(db); }
+
+            sqlite3_int64 add(const std::string &title, ResourceType type,
+                              const std::vector<std::string> &tags) {
+                // File (cpp...) chỉ cần dòng resources để đếm type
+                const auto id = type == ResourceType::text
+                                    ? resService.addTextResource(title, title + " body", type)
+                                    : resRepo.insert({.title = title, .type = type});
+                resService.addTagsToResource(id, tags);
+                return id;
+            }
+    };
+} // namespace
+
+TEST_CASE("countSearchFacets counts tags and types of a result set", "[SearchFacets]") {
+    Fixture f;
+    const auto a = f.add("alpha", ResourceType::text, {"cpp", "ds"});
+    const auto b = f.add("beta", ResourceType::cpp, {"cpp"});
+    const auto c = f.add("gamma", ResourceType::text, {"ds", "os"});
+    const auto d = f.add("delta", ResourceType::text, {});
+    f.add("outside", ResourceType::cpp, {"cpp", "os"});
+
+    // Id trùng tính một lần, id không tồn tại bị bỏ qua
+    const std::vector<sqlite3_int64> ids{c, a, b, d, a, 9999};
+    const auto facets = countSearchFacets(f.db, ids, 10);
+
+    CHECK(facets.total == 4);
+    CHECK(countsOf(facets.tags) == Counts{{"cpp", 2}, {"ds", 2}, {"os", 1}});
+    CHECK(countsOf(facets.types) == Counts{{"text", 3}, {"cpp", 1}});
+
+    SECTION("topTags keeps the most frequent tags") {
+        CHECK(countsOf(countSearchFacets(f.db, ids, 1).tags) == Counts{{"cpp", 2}});
+        CHECK(countSearchFacets(f.db, ids, 0).tags.empty());
+    }
+
+    SECTION("an empty set has no facets") {
+        const auto empty = countSearchFacets(f.db, {}, 10);
+        CHECK(empty.total == 0);
+        CHECK(empty.tags.empty());
+        CHECK(empty.types.empty());
+    }
+}
+
+TEST_CASE("countSearchFacets gives the same counts for sparse and dense id sets",
+          "[SearchFacets]") {
+    Fixture f;
+    std::vector<sqlite3_int64> all;
+    for (int i = 0; i < 64; ++i) {
+        std::vector<std::string> tags{i % 2 == 0 ? "even" : "odd"};
+        if (i % 3 == 0) { tags.emplace_back("three"); }
+        all.push_back(f.add("note " + std::to_string(i),
+                            i % 4 == 0 ? ResourceType::cpp : ResourceType::text, tags));
+    }
+
+    // Hai id ở hai đầu: tra từng id; cả tập: quét một lần theo khoảng id
+    const std::vector<sqlite3_int64> sparse{all.front(), all.back()};
+    const auto ends = countSearchFacets(f.db, sparse, 10);
+    CHECK(ends.total == 2);
+    CHECK(countsOf(ends.tags) == Counts{{"three", 2}, {"even", 1}, {"odd", 1}});
+    CHECK(countsOf(ends.types) == Counts{{"text", 1}, {"cpp", 1}});
+
+    const auto dense = countSearchFacets(f.db, all, 10);
+    CHECK(dense.total == 64);
+    CHECK(countsOf(dense.tags) == Counts{{"even", 32}, {"odd", 32}, {"three", 22}});
+    CHECK(countsOf(dense.types) == Counts{{"text", 48}, {"cpp", 16}});
+
+    // Tập dày nằm giữa: quét chỉ trong khoảng [min, max] của tập
+    const std::vector<sqlite3_int64> middle(all.begin() + 10, all.begin() + 20);
+    CHECK(countSearchFacets(f.db, middle, 10).total == 10);
+}
+
+TEST_CASE("searchQuery returns facets of the whole match set on request", "[SearchFacets]") {
+    Fixture f;
+    f.add("mutex guide", ResourceType::text, {"cpp", "threads"});
+    f.add("mutex impl", ResourceType::cpp, {"cpp"});
+    f.add("mutex history", ResourceType::text, {"history"});
+
+    const auto query = parseSearchQuery("title:mutex tag:cpp");
+    CHECK_FALSE(f.resService.searchQuery(query).facets.has_value());
+
+    const auto matches = f.resService.searchQuery(query, 5);
+    REQUIRE(matches.ids.size() == 2);
+    REQUIRE(matches.facets.has_value());
+    CHECK(matches.facets->total == 2);
+    CHECK(countsOf(matches.facets->tags) == Counts{{"cpp", 2}, {"threads", 1}});
+    CHECK(countsOf(matches.facets->types) == Counts{{"text", 1}, {"cpp", 1}});
+
+    const auto none = f.resService.searchQuery(parseSearchQuery("tag:missing"), 5);
+    REQUIRE(none.facets.has_value());
+    CHECK(none.facets->total == 0);
+}
@@ -0,0 +1,163 @@
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+#include "resource_repository.hpp"
+#include "resource_service.hpp"
+#include "schema_migrator.hpp"
+#include "search_query.hpp"
+#include "sqldb_raii.hpp"
+#include "tag_repository.hpp"
+#include "text_content_repository.hpp"
+
+namespace {
+    void createSchema(SQLiteDB &db) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type TEXT NOT NULL,
+                file_hash TEXT UNIQUE,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                UNIQUE (title, type)
+            );
+
+            CREATE VIRTUAL TABLE resources_fts USING fts5(title);
+
+            CREATE TRIGGER resources_insert_fts AFTER INSERT ON resources
+            BEGIN
+                INSERT INTO resources_fts (rowid, title) VALUES (new.id, new.title);
+            END;
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0,
+                FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+            );
+
+            CREATE TABLE text_content (
+                resource_id INTEGER PRIMARY KEY,
+                content TEXT NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE text_content_fts USING fts5(content);
+
+            CREATE TABLE tags (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT UNIQUE NOT NULL);
+            CREATE TABLE resource_tags (resource_id INTEGER, tag_id INTEGER,
+                                        PRIMARY KEY (resource_id, tag_id));
+        )SQL";
+
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+        SchemaMigrator(db).migrate();
+    }
+
+    std::vector<std::string> describe(const SearchQuery &query) {
+        std::vector<std::string> out;
+        for (const auto &term : query.terms) {
+            out.push_back(std::string(searchFieldName(term.field)) + ":" + term.value);
+        }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("parseSearchQuery splits fields and keeps bare words as title", "[SearchQuery]") {
+    const auto query = parseSearchQuery("tag:cpp  type:text content:mutex");
+    CHECK(query.fielded);
+    CHECK(describe(query) ==
+          std::vector<std::string>{"tag:cpp", "type:text", "content:mutex"});
+
+    CHECK(describe(parseSearchQuery("ring tag:cpp buffer")) ==
+          std::vector<std::string>{"title:ring buffer", "tag:cpp"});
+
+    // Field lạ không phải điều kiện
+    const auto plain = parseSearchQuery("std::vector http://x");
+    CHECK_FALSE(plain.fielded);
+    CHECK(describe(plain) == std::vector<std::string>{"title:std::vector http://x"});
+
+    // Dấu " là phrase với title/content, chỉ để nhóm với tag
+    CHECK(describe(parseSearchQuery(R"(content:"ring buffer" tag:"open source")")) ==
+          std::vector<std::string>{R"(content:"ring buffer")", "tag:open source"});
+    CHECK(describe(parseSearchQuery(R"(tag:"say ""hi""")")) ==
+          std::vector<std::string>{R"(tag:say "hi")"});
+
+    CHECK(parseSearchQuery("   ").terms.empty());
+
+    CHECK_THROWS_AS(parseSearchQuery("type:video"), std::runtime_error);
+    CHECK_THROWS_AS(parseSearchQuery("content: mutex"), std::runtime_error);
+    CHECK_THROWS_AS(parseSearchQuery(R"(tag:"")"), std::runtime_error);
+    CHECK_THROWS_AS(parseSearchQuery(R"(tag:"open source)"), std::runtime_error);
+}
+
+TEST_CASE("searchQuery runs the most selective predicate first", "[SearchQuery][ResourceService]") {
+    SQLiteDB db(":memory:");
+    createSchema(db);
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    TextContentRepository textRepo(db);
+    TagRepository tagRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+    ResourceService resService(db, resRepo, fileRepo, textRepo, tagRepo, fileService);
+
+    const auto guide = resService.addTextResource(
+        "mutex guide", "std::mutex with lock_guard, mutex everywhere", ResourceType::text);
+    const auto intro = resService.addTextResource("mutex intro", "a mutex is a lock",
+                                                  ResourceType::text);
+    const auto vectors = resService.addTextResource("vectors", "std::vector", ResourceType::text);
+    resService.addTextResource("misc", "nothing here", ResourceType::text);
+    const auto pool = resRepo.insert({.title = "thread_pool", .type = ResourceType::cpp});
+
+    resService.addTagsToResource(guide, {"cpp", "concurrency"});
+    resService.addTagsToResource(intro, {"concurrency"});
+    resService.addTagsToResource(vectors, {"cpp"});
+    resService.addTagsToResource(pool, {"cpp", "concurrency"});
+
+    SECTION("tag, type and content in one query") {
+        const auto matches =
+            resService.searchQuery(parseSearchQuery("type:text content:mutex tag:cpp"));
+        CHECK(matches.ids == std::vector<sqlite3_int64>{guide});
+        REQUIRE(matches.hits.size() == 1);
+        CHECK(matches.hits[0].resource_id == guide);
+        // tag:cpp (3 dòng) trước type:text (4 dòng), FTS sau cùng
+        CHECK(matches.plan == "tag:cpp(3) > type:text(2) > content:mutex(1)");
+    }
+
+    SECTION("results follow content rank") {
+        const auto matches =
+            resService.searchQuery(parseSearchQuery("content:mutex tag:concurrency"));
+        CHECK(matches.plan == "tag:concurrency(3) > content:mutex(2)");
+        REQUIRE(matches.ids.size() == 2);
+        CHECK(matches.ids[0] == guide); // "mutex" hai lần
+        CHECK(matches.ids[1] == intro);
+        CHECK(matches.hits.size() == matches.ids.size());
+    }
+
+    SECTION("bare words search titles") {
+        const auto matches = resService.searchQuery(parseSearchQuery("type:cpp thread"));
+        CHECK(matches.ids == std::vector<sqlite3_int64>{pool});
+        CHECK(matches.hits.empty());
+        CHECK(matches.plan == "type:cpp(1) > title:thread(1)");
+    }
+
+    SECTION("no candidates left: later steps are skipped") {
+        const auto matches = resService.searchQuery(parseSearchQuery("content:mutex tag:none"));
+        CHECK(matches.ids.empty());
+        CHECK(matches.plan == "tag:none(0) > content:mutex(skipped)");
+    }
+
+    SECTION("same field twice") {
+        CHECK(resService.searchQuery(parseSearchQuery("tag:cpp tag:concurrency")).ids ==
+              std::vector<sqlite3_int64>{guide, pool});
+        CHECK(resService.searchQuery(parseSearchQuery("type:cpp type:text")).ids.empty());
+    }
+
+    CHECK(resService.searchQuery(parseSearchQuery("")).ids.empty());
+}
@@ -0,0 +1,95 @@
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include "model.hpp"
+#include "search_result.hpp"
+
+namespace {
+    SearchResult makeResults(int count) {
+        SearchResult result;
+        result.reserve(static_cast<std::size_t>(count));
+
+        for (int i = 0; i < count; ++i) {
+            const auto title = "note number " + std::to_string(i);
+            const std::string path = "/files/" + std::to_string(i) + ".cpp";
+            result.add(i, i % 2 == 0 ? ResourceType::text : ResourceType::cpp, title,
+                       i % 2 == 0 ? std::nullopt : std::optional<std::string_view>(path),
+                       timestampFromEpoch(i), timestampFromEpoch(i + 1));
+            for (int t = 0; t < i % 3; ++t) { result.addTag("tag" + std::to_string(t)); }
+        }
+
+        return result;
+    }
+} // namespace
+
+TEST_CASE("SearchResult packs entries into one arena", "[SearchResult]") {
+    auto result = makeResults(10'000);
+    REQUIRE(result.size() == 10'000);
+
+    const auto entry = result[4'001];
+    CHECK(entry.id == 4'001);
+    CHECK(entry.type == ResourceType::cpp);
+    CHECK(entry.title == "note number 4001");
+    CHECK(entry.path == "/files/4001.cpp");
+    CHECK(epochFromTimestamp(entry.created_at) == 4'001);
+    CHECK(epochFromTimestamp(entry.updated_at) == 4'002);
+    REQUIRE(entry.tags.size() == 2);
+    CHECK(entry.tags[1] == "tag1");
+    CHECK_FALSE(entry.hit.has_value());
+
+    CHECK_FALSE(result[0].path.has_value());
+    CHECK(result[0].tags.empty());
+
+    // Chuỗi và bản ghi nằm trong vài block lớn, không phải hàng chục nghìn cấp phát nhỏ
+    CHECK(result.arenaBytes() > 0);
+    CHECK(result.arenaBytes() < 4 * 1024 * 1024);
+
+    SECTION("move is a pointer handoff, also across threads") {
+        const auto* title = result[9'999].title.data();
+
+        auto moved = std::async(std::launch::async, [source = std::move(result)]() mutable {
+                         return std::move(source);
+                     }).get();
+
+        CHECK(result.empty()); // NOLINT(bugprone-use-after-move)
+        REQUIRE(moved.size() == 10'000);
+        CHECK(moved[9'999].title.data() == title);
+        CHECK(moved[9'999].title == "note number 9999");
+    }
+
+    SECTION("clear frees everything at once") {
+        result.clear();
+        CHECK(result.empty());
+        CHECK(result.arenaBytes() == 0);
+
+        // Dùng lại sau clear
+        result.add(7, ResourceType::text, "again", std::nullopt, {}, {});
+        CHECK(result[0].title == "again");
+    }
+}
+
+TEST_CASE("SearchResult stores content hits", "[SearchResult]") {
+    SearchResult result;
+    result.add(1, ResourceType::text, "note", std::nullopt, {}, {});
+    result.add(2, ResourceType::pdf, "book", "/books/b.pdf", {}, {});
+
+    result.setHit(0, {.resource_id = 1, .snippet = "a [match] here", .byte_offset = 12, .line = 3});
+    result.setHit(1, {.resource_id = 2, .snippet = "page text", .line = 1, .page = 4});
+
+    REQUIRE(result[0].hit.has_value());
+    CHECK(result[0].hit->snippet == "a [match] here");
+    CHECK(result[0].hit->byte_offset == 12);
+    CHECK(result[0].hit->line == 3);
+    CHECK_FALSE(result[0].hit->page.has_value());
+    CHECK(result[1].hit->page == 4);
+
+    CHECK_THROWS_AS(result[2], std::out_of_range);
+    CHECK_THROWS_AS(result.setHit(5, {}), std::out_of_range);
+
+    // Tag chỉ gắn được cho resource vừa add
+    result.addTag("x");
+    CHECK_THROWS_AS(SearchResult().addTag("x"), std::logic_error);
+}
@@ -1,8 +1,16 @@
 #include <catch2/matchers/catch_matchers.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <cstddef>
 #include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
 #include <sqlite3.h>
+#include "model.hpp"
+#include "row_view.hpp"
 #include "sqldb_raii.hpp"
 
 namespace {
@@ -72,3 +80,83 @@ TEST_CASE("SQLiteStmt - RAII and Error Handling", "[DB][RAII]") {
                           Catch::Matchers::ContainsSubstring("Failed to prepare statement"));
     }
 }
+
+TEST_CASE("ResultSet decodes rows without copying", "[DB][RowView]") {
+    SQLiteDB db(":memory:");
+    const char* schema = R"SQL(
+        CREATE TABLE items (id INTEGER PRIMARY KEY, name TEXT, type INTEGER, at INTEGER,
+                            hash BLOB, score REAL);
+        INSERT INTO items VALUES (1, 'alpha', 1, 1700000000, zeroblob(32), 0.5);
+        INSERT INTO items VALUES (2, NULL, 2, 0, X'0102', 1.5);
+    )SQL";
+    REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+
+    SECTION("typed columns") {
+        SQLiteStmt stmt(db.get(), "SELECT id, name, type, at, hash, score FROM items ORDER BY id;");
+
+        std::vector<std::string> names;
+        int rows{};
+        for (const auto &[id, name, type, at, hash, score] :
+             ResultSet<sqlite3_int64, std::optional<std::string_view>, ResourceType, Timestamp,
+                       std::optional<FileHash>, double>(stmt)) {
+            ++rows;
+            CHECK(id == rows);
+            names.emplace_back(name.value_or("<null>"));
+            if (id == 1) {
+                CHECK(type == ResourceType::cpp);
+                CHECK(epochFromTimestamp(at) == 1700000000);
+                CHECK(hash == FileHash{});
+                CHECK(score == 0.5);
+            } else {
+                CHECK(type == ResourceType::pdf);
+                CHECK_FALSE(hash.has_value()); // sai độ dài
+            }
+        }
+
+        CHECK(rows == 2);
+        CHECK(names == std::vector<std::string>{"alpha", "<null>"});
+    }
+
+    SECTION("views point into the statement") {
+        SQLiteStmt stmt(db.get(), "SELECT name, hash FROM items WHERE id = ?;");
+        sqlite3_bind_int64(stmt.get(), 1, 1);
+
+        const auto row = ResultSet<>(stmt).next();
+        REQUIRE(row.has_value());
+        CHECK(row->text(0) == "alpha");
+        CHECK(row->text(0).data() ==
+              reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0)));
+        CHECK(row->get<std::span<const std::byte>>(1).size() == 32);
+        CHECK(row->get<std::string>(0) == "alpha");
+    }
+
+    SECTION("empty result and step-by-step reads") {
+        SQLiteStmt stmt(db.get(), "SELECT id FROM items WHERE id > ? ORDER BY id;");
+        sqlite3_bind_int64(stmt.get(), 1, 1);
+
+        ResultSet<sqlite3_int64> rows(stmt);
+        CHECK(std::get<0>(rows.next().value()) == 2);
+        CHECK_FALSE(rows.next().has_value());
+
+        sqlite3_reset(stmt.get());
+        sqlite3_bind_int64(stmt.get(), 1, 5);
+        CHECK(ResultSet<sqlite3_int64>(stmt).begin() == std::default_sentinel);
+    }
+
+    SECTION("errors throw") {
+        SQLiteStmt wide(db.get(), "SELECT id FROM items;");
+        CHECK_THROWS_AS((ResultSet<sqlite3_int64, std::string_view>(wide).begin()),
+                        std::runtime_error);
+
+        SQLiteStmt bad(db.get(), "SELECT type FROM items;");
+        REQUIRE(sqlite3_exec(db.get(), "UPDATE items SET type = 9 WHERE id = 2;", nullptr,
+                             nullptr, nullptr) == SQLITE_OK);
+        ResultSet<ResourceType> types(bad);
+        CHECK(types.next().has_value());
+        CHECK_THROWS_AS(types.next(), std::runtime_error); // mã type không hợp lệ
+
+        SQLiteStmt failing(db.get(), "SELECT abs(-9223372036854775807 - 1);"); // integer overflow
+        CHECK_THROWS_WITH(ResultSet<>(failing).next(),
+                          Catch::Matchers::ContainsSubstring("Query step failed"));
+    }
+}
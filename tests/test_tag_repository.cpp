@@ -18,10 +18,10 @@ namespace {
             CREATE TABLE resources (
                 id          INTEGER PRIMARY KEY AUTOINCREMENT,
                 title       TEXT NOT NULL,
-                type        TEXT NOT NULL,
-                file_hash   TEXT UNIQUE NULL,
-                created_at  TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
-                updated_at  TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+                type        INTEGER NOT NULL,
+                file_hash   BLOB UNIQUE NULL,
+                created_at  INTEGER NOT NULL DEFAULT (unixepoch()),
+                updated_at  INTEGER NOT NULL DEFAULT (unixepoch()),
                 UNIQUE (title, type)
             );
 
@@ -55,7 +55,7 @@ namespace {
         SQLiteStmt stmt(db.get(), "INSERT INTO resources (title, type) VALUES (?, ?);");
 
         sqlite3_bind_text(stmt.get(), 1, res.title.c_str(), -1, SQLITE_TRANSIENT);
-        sqlite3_bind_text(stmt.get(), 2, resourceTypeToString(res.type), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int(stmt.get(), 2, resourceTypeCode(res.type));
 
         REQUIRE(sqlite3_step(stmt.get()) == SQLITE_DONE);
 
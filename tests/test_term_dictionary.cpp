@@ -0,0 +1,211 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include <sqlite3.h>
+#include "file_repository.hpp"
+#include "file_service.hpp"
+#include "model.hpp"
+#include "query_router.hpp"
+#include "resource_repository.hpp"
+#include "resource_service.hpp"
+#include "schema_migrator.hpp"
+#include "sqldb_raii.hpp"
+#include "tag_repository.hpp"
+#include "term_dictionary.hpp"
+#include "text_content_repository.hpp"
+
+namespace {
+    using Strings = std::vector<std::string>;
+
+    void createSchema(SQLiteDB &db) {
+        const char* schema = R"SQL(
+            CREATE TABLE resources (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                title TEXT NOT NULL,
+                type TEXT NOT NULL,
+                file_hash TEXT UNIQUE,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                updated_at TEXT DEFAULT CURRENT_TIMESTAMP,
+                UNIQUE (title, type)
+            );
+
+            CREATE TABLE files (
+                resource_id INTEGER PRIMARY KEY,
+                stored_path TEXT,
+                original_path TEXT NOT NULL,
+                is_managed INTEGER NOT NULL DEFAULT 0,
+                FOREIGN KEY (resource_id) REFERENCES resources(id) ON DELETE CASCADE
+            );
+
+            CREATE TABLE text_content (
+                resource_id INTEGER PRIMARY KEY,
+                content TEXT NOT NULL
+            );
+
+            CREATE VIRTUAL TABLE text_content_fts USING fts5(content);
+
+            CREATE TABLE tags (id INTEGER PRIMARY KEY AUTOINCREMENT, name TEXT UNIQUE NOT NULL);
+            CREATE TABLE resource_tags (resource_id INTEGER, tag_id INTEGER,
+                                        PRIMARY KEY (resource_id, tag_id));
+        )SQL";
+
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+        SchemaMigrator(db).migrate();
+    }
+
+    int levenshtein(std::string_view a, std::string_view b) {
+        std::vector<int> row(b.size() + 1);
+        for (std::size_t j = 0; j <= b.size(); ++j) { row[j] = static_cast<int>(j); }
+        for (std::size_t i = 1; i <= a.size(); ++i) {
+            int diagonal = row[0];
+            row[0] = static_cast<int>(i);
+            for (std::size_t j = 1; j <= b.size(); ++j) {
+                const int above = row[j];
+                row[j] = std::min({above + 1, row[j - 1] + 1,
+                                   diagonal + (a[i - 1] == b[j - 1] ? 0 : 1)});
+                diagonal = above;
+            }
+        }
+        return row[b.size()];
+    }
+
+    std::vector<TermDictionary::Entry> randomTerms(std::size_t count, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> length(3, 12);
+        std::uniform_int_distribution<int> letter(0, 7); // bảng chữ nhỏ => nhiều term gần nhau
+        std::uniform_int_distribution<std::int64_t> docs(1, 1000);
+
+        std::vector<TermDictionary::Entry> terms;
+        terms.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::string term(static_cast<std::size_t>(length(rng)), 'a');
+            for (auto &c : term) { c = static_cast<char>('a' + letter(rng)); }
+            terms.emplace_back(std::move(term), docs(rng));
+        }
+        return terms;
+    }
+
+    Strings termsOf(const std::vector<TermMatch> &matches) {
+        Strings out;
+        for (const auto &match : matches) { out.push_back(match.term); }
+        return out;
+    }
+} // namespace
+
+TEST_CASE("TermDictionary expands a term to its nearest neighbours", "[TermDictionary]") {
+    const TermDictionary dict({{"template", 40},
+                               {"templates", 12},
+                               {"temple", 3},
+                               {"class", 90},
+                               {"clash", 2},
+                               {"alias", 7},
+                               {"template", 2}}); // trùng: gộp tần suất
+
+    REQUIRE(dict.size() == 6);
+    CHECK(dict.term(0) == "alias");
+
+    const auto matches = dict.expand("templete");
+    CHECK(termsOf(matches) == Strings{"template", "templates", "temple"});
+    CHECK(matches[0].distance == 1);
+    CHECK(matches[0].docs == 42);
+    CHECK(matches[1].distance == 2);
+
+    // Độ dài 4..7 ký tự: chỉ khoảng cách 1, term phổ biến trước
+    CHECK(termsOf(dict.expand("clas")) == Strings{"class", "clash"});
+    CHECK(termsOf(dict.expand("clasx")) == Strings{"class", "clash"});
+
+    CHECK(termsOf(dict.expand("templete", {.maxExpansions = 1})) == Strings{"template"});
+    CHECK(termsOf(dict.expand("templete", {.minDocs = 10})) == Strings{"template", "templates"});
+    CHECK(termsOf(dict.expand("clasx", {.maxDistance = 0})).empty());
+    CHECK(termsOf(dict.expand("cls", {.maxDistance = 2})) == Strings{"class", "clash"});
+    CHECK(dict.expand("").empty());
+    CHECK(TermDictionary().expand("template").empty());
+}
+
+TEST_CASE("TermDictionary agrees with brute-force edit distance", "[TermDictionary]") {
+    const auto terms = randomTerms(20'000, 7);
+    const TermDictionary dict(terms);
+
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<std::size_t> pick(0, terms.size() - 1);
+    for (int round = 0; round < 40; ++round) {
+        // Term có thật bị sửa một ký tự, và một từ hoàn toàn ngẫu nhiên
+        std::string query = terms[pick(rng)].first;
+        query[query.size() / 2] = 'z';
+        const auto k = round % 3;
+
+        Strings expected;
+        for (std::size_t i = 0; i < dict.size(); ++i) {
+            if (levenshtein(dict.term(i), query) <= k) { expected.emplace_back(dict.term(i)); }
+        }
+
+        auto actual = termsOf(dict.expand(query, {.maxDistance = k, .maxExpansions = 100'000}));
+        std::ranges::sort(actual);
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("routeFuzzyQuery builds OR groups per word", "[TermDictionary][QueryRouter]") {
+    const TermDictionary dict({{"ring", 5}, {"buffer", 8}, {"buffers", 1}, {"template", 3}});
+
+    const auto routed = routeFuzzyQuery("RingBufer templete", dict);
+    CHECK(routed.plan == QueryPlan::ftsFuzzy);
+    CHECK(routed.expression ==
+          R"("ring" AND ("bufer" OR "buffer") AND ("templete" OR "template"))");
+    CHECK(routed.describe().starts_with("fts-fuzzy: "));
+
+    CHECK(routeFuzzyQuery("  ", dict).plan == QueryPlan::none);
+    CHECK(routeFuzzyQuery("ghi chú", dict).expression == R"("ghi" AND "chú")");
+}
+
+TEST_CASE("Fuzzy content search finds misspelled words", "[TermDictionary][ResourceService]") {
+    SQLiteDB db(":memory:");
+    createSchema(db);
+
+    FileRepository fileRepo(db);
+    ResourceRepository resRepo(db);
+    TextContentRepository textRepo(db);
+    TagRepository tagRepo(db);
+    FileService fileService(db, fileRepo, resRepo);
+    ResourceService resService(db, resRepo, fileRepo, textRepo, tagRepo, fileService);
+
+    const auto noteId = resService.addTextResource(
+        "ring", "intro\ntemplate <typename T>\nclass RingBuffer {};\n", ResourceType::text);
+    resService.addTextResource("other", "sorting algorithms", ResourceType::text);
+
+    CHECK(resService.searchContentHits(std::string("templete")).empty());
+
+    TermDictionary dict;
+    CHECK(dict.refreshContent(db));
+    CHECK_FALSE(dict.refreshContent(db)); // không ghi gì thì không đọc lại
+    CHECK(dict.size() > 0);
+
+    const auto hits = resService.searchContentHits(routeFuzzyQuery("templete RingBufer", dict));
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0].resource_id == noteId);
+    CHECK(hits[0].line == 2);
+
+    // Note mới: từ điển đọc lại ở lần tìm sau
+    resService.addTextResource("algo", "quicksort partition", ResourceType::text);
+    CHECK(dict.refreshContent(db));
+    CHECK(termsOf(dict.expand("partitoin", {.maxDistance = 2})) == Strings{"partition"});
+}
+
+TEST_CASE("Fuzzy expansion stays fast on a large vocabulary", "[TermDictionary][.benchmark]") {
+    const auto start = std::chrono::steady_clock::now();
+    const TermDictionary dict(randomTerms(1'000'000, 3));
+    const std::chrono::duration<double> built = std::chrono::steady_clock::now() - start;
+    WARN(dict.size() << " terms loaded in " << built.count() << " s");
+
+    BENCHMARK("expand 8-letter word, k = 2") { return dict.expand("abcdefgh"); };
+    BENCHMARK("expand 6-letter word, k = 1") { return dict.expand("hgfedc"); };
+    BENCHMARK("expand 12-letter word, k = 2") { return dict.expand("abcdabcdabcd"); };
+}
@@ -0,0 +1,109 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "text_codec.hpp"
+
+namespace {
+    // Note giống thực tế: header/boilerplate lặp lại giữa các note, phần thân mỗi note một khác
+    std::vector<std::string> sampleNotes(int count) {
+        std::vector<std::string> notes;
+        for (int n = 0; n < count; ++n) {
+            std::string note = "# Daily log " + std::to_string(n) + "\n"
+                               "#include <algorithm>\n#include <string>\n#include <vector>\n"
+                               "TODO: review pull requests and update the changelog\n";
+            for (int line = 0; line < 8; ++line) {
+                note += "for (const auto &item : items" + std::to_string(n * 8 + line) +
+                        ") { process(item); }\n";
+            }
+            note += "Status: waiting for review\n";
+            notes.push_back(std::move(note));
+        }
+        return notes;
+    }
+
+    std::vector<std::string_view> views(const std::vector<std::string> &notes) {
+        return {notes.begin(), notes.end()};
+    }
+
+    std::size_t totalSize(const std::vector<std::string> &notes) {
+        std::size_t total{};
+        for (const auto &note : notes) { total += note.size(); }
+        return total;
+    }
+} // namespace
+
+TEST_CASE("TextCodec round-trips text with and without a dictionary", "[TextCodec]") {
+    const auto notes = sampleNotes(200);
+    const auto dictionary = TextCodec::trainDictionary(views(notes));
+
+    REQUIRE_FALSE(dictionary.empty());
+    CHECK(dictionary.size() <= TextCodec::kMaxDictionarySize);
+    CHECK(dictionary.find("TODO: review pull requests") != std::string::npos);
+    CHECK(dictionary.find("# Daily log 7") == std::string::npos); // chỉ có trong một note
+
+    const TextCodec plain;
+    const TextCodec trained(3, dictionary);
+
+    std::size_t plainBytes{};
+    std::size_t trainedBytes{};
+    for (const auto &note : notes) {
+        const auto a = plain.compress(note);
+        const auto b = trained.compress(note);
+        CHECK(plain.decompress(a) == note);
+        CHECK(trained.decompress(b) == note);
+        CHECK(TextCodec::dictionaryId(b) == 3);
+        plainBytes += a.size();
+        trainedBytes += b.size();
+    }
+
+    // Note ngắn: từ điển mới là thứ làm nén có ý nghĩa
+    CHECK(trainedBytes * 2 < plainBytes);
+
+    const auto blob = trained.compress(notes.front());
+    CHECK_THROWS_AS(plain.decompress(blob), std::runtime_error);
+    CHECK_THROWS_AS(trained.decompress(blob.substr(0, blob.size() - 4)), std::runtime_error);
+    CHECK_THROWS_AS(TextCodec::dictionaryId("abc"), std::runtime_error);
+
+    // Kích thước gốc trong header không thể có với từng ấy byte nén: báo lỗi, không cấp phát
+    auto huge = blob;
+    huge.replace(4, 4, "\xff\xff\xff\xff");
+    CHECK_THROWS_AS(trained.decompress(huge), std::runtime_error);
+
+    CHECK(TextCodec::trainDictionary({"only one note here"}).empty());
+}
+
+TEST_CASE("TextCodec ratio and decode throughput", "[TextCodec][.benchmark]") {
+    const auto notes = sampleNotes(2000);
+    const TextCodec plain;
+    const TextCodec trained(1, TextCodec::trainDictionary(views(notes)));
+
+    std::vector<std::string> blobs;
+    std::size_t plainBytes{};
+    for (const auto &note : notes) {
+        plainBytes += plain.compress(note).size();
+        blobs.push_back(trained.compress(note));
+    }
+
+    const auto raw = totalSize(notes);
+    const auto packed = totalSize(blobs);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::size_t decoded{};
+    for (const auto &blob : blobs) { decoded += trained.decompress(blob).size(); }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    WARN("raw " << raw << " B, deflate " << plainBytes << " B, with dictionary " << packed
+                << " B (ratio " << static_cast<double>(raw) / static_cast<double>(packed)
+                << "), decode " << static_cast<double>(decoded) / 1e6 / elapsed.count()
+                << " MB/s");
+
+    BENCHMARK("decompress 2000 notes") {
+        std::size_t total{};
+        for (const auto &blob : blobs) { total += trained.decompress(blob).size(); }
+        return total;
+    };
+}
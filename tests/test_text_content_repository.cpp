@@ -1,13 +1,19 @@
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <set>
 #include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
 #include "sqldb_raii.hpp"
 #include "text_content_repository.hpp"
 
 namespace {
-    SQLiteDB createInMemoryDB() {
-        SQLiteDB db(":memory:");
-        sqlite3* rawPtr = db.get();
-
+    void createSchema(SQLiteDB &db) {
         const char* schema = R"SQL(
             PRAGMA foreign_keys = ON;
 
@@ -16,36 +22,61 @@ namespace {
                 content TEXT
             );
 
-            CREATE VIRTUAL TABLE text_content_fts USING fts5(
+            CREATE TABLE text_chunks (
+                id INTEGER PRIMARY KEY,
+                resource_id INTEGER NOT NULL,
+                chunk_no INTEGER NOT NULL,
+                byte_offset INTEGER NOT NULL,
+                byte_len INTEGER NOT NULL,
+                line_count INTEGER NOT NULL,
+                UNIQUE (resource_id, chunk_no)
+            );
+
+            CREATE VIEW text_chunk_texts AS
+            SELECT c.id AS id, note_slice(t.content, c.byte_offset, c.byte_len) AS content
+            FROM text_chunks c JOIN text_content t ON t.resource_id = c.resource_id;
+
+            CREATE VIRTUAL TABLE text_chunks_fts USING fts5(
                 content,
+                content = 'text_chunk_texts',
+                content_rowid = 'id',
                 tokenize = 'unicode61 remove_diacritics 1'
             );
 
-            CREATE TRIGGER text_content_insert_fts
-            AFTER INSERT ON text_content
-            WHEN new.content IS NOT NULL
+            CREATE TRIGGER text_chunks_insert_fts
+            AFTER INSERT ON text_chunks
             BEGIN
-                INSERT INTO text_content_fts (rowid, content)
-                VALUES (new.resource_id, new.content);
+                INSERT INTO text_chunks_fts (rowid, content)
+                SELECT id, content FROM text_chunk_texts WHERE id = new.id;
             END;
 
-            CREATE TRIGGER text_content_update_fts
-            AFTER UPDATE ON text_content
+            CREATE TRIGGER text_chunks_delete_fts
+            BEFORE DELETE ON text_chunks
             BEGIN
-                UPDATE text_content_fts
-                SET content = new.content
-                WHERE rowid = old.resource_id;
+                INSERT INTO text_chunks_fts (text_chunks_fts, rowid, content)
+                SELECT 'delete', id, content FROM text_chunk_texts WHERE id = old.id;
             END;
 
-            CREATE TRIGGER text_content_delete_fts
-            AFTER DELETE ON text_content
+            CREATE TRIGGER text_content_delete_chunks
+            BEFORE DELETE ON text_content
             BEGIN
-                DELETE FROM text_content_fts
-                WHERE rowid = old.resource_id;
+                DELETE FROM text_chunks WHERE resource_id = old.resource_id;
             END;
+
+            CREATE TABLE text_dictionaries (
+                id INTEGER PRIMARY KEY,
+                dictionary BLOB NOT NULL,
+                sample_count INTEGER NOT NULL,
+                created_at TEXT DEFAULT CURRENT_TIMESTAMP
+            );
         )SQL";
 
-        REQUIRE(sqlite3_exec(rawPtr, schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+        REQUIRE(sqlite3_exec(db.get(), schema, nullptr, nullptr, nullptr) == SQLITE_OK);
+    }
+
+    SQLiteDB createInMemoryDB() {
+        SQLiteDB db(":memory:");
+        createSchema(db);
         return db;
     }
 } // namespace
@@ -116,3 +147,319 @@ TEST_CASE("TextContentRepository FTS search", "[TextContentRepository][fts]") {
         REQUIRE(check.empty());
     }
 }
+
+TEST_CASE("TextContentRepository reports match positions in large notes",
+          "[TextContentRepository][fts]") {
+    auto db = createInMemoryDB();
+    TextContentRepository repo(db);
+
+    // ~40 KiB, nhiều chunk; từ cần tìm nằm ở dòng 900
+    std::string text;
+    std::size_t expectedOffset{};
+    for (int line = 1; line <= 1000; ++line) {
+        if (line == 900) {
+            expectedOffset = text.size() + 6;
+            text += "note  needle here\n";
+        } else {
+            text += "filler line " + std::to_string(line) + " lorem ipsum\n";
+        }
+    }
+    repo.insertText(7, text); // NOLINT(readability-magic-numbers)
+
+    {
+        SQLiteStmt stmt(db.get(), "SELECT COUNT(*) FROM text_chunks WHERE resource_id = 7;");
+        REQUIRE(sqlite3_step(stmt.get()) == SQLITE_ROW);
+        CHECK(sqlite3_column_int(stmt.get(), 0) > 1);
+    }
+
+    auto hits = repo.searchContentHits("needle");
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0].resource_id == 7);
+    CHECK(hits[0].line == 900);
+    CHECK(hits[0].byte_offset == static_cast<std::int64_t>(expectedOffset));
+    CHECK(text.compare(expectedOffset, 6, "needle") == 0);
+    CHECK(hits[0].snippet.find("needle") != std::string::npos);
+    CHECK(hits[0].snippet.size() < 1024);
+    CHECK_FALSE(hits[0].page.has_value());
+
+    SECTION("updateText rewrites the chunks") {
+        repo.updateText(7, "first line\nsecond needle"); // NOLINT(readability-magic-numbers)
+
+        hits = repo.searchContentHits("needle");
+        REQUIRE(hits.size() == 1);
+        CHECK(hits[0].line == 2);
+        CHECK(hits[0].byte_offset == 18);
+        CHECK(repo.searchContentHits("filler").empty());
+    }
+
+    SECTION("failed update leaves text and chunks untouched") {
+        CHECK_THROWS_AS(repo.updateText(8, "needle"), std::runtime_error);
+        CHECK(repo.searchContentHits("needle").size() == 1);
+        CHECK(repo.searchContentHits("lorem").size() == 1);
+    }
+}
+
+TEST_CASE("TextContentRepository updateText rewrites only changed chunks",
+          "[TextContentRepository][fts]") {
+    auto db = createInMemoryDB();
+    TextContentRepository repo(db);
+
+    auto chunkIds = [&] {
+        std::set<sqlite3_int64> ids;
+        SQLiteStmt stmt(db.get(), "SELECT id FROM text_chunks WHERE resource_id = 7;");
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            ids.insert(sqlite3_column_int64(stmt.get(), 0));
+        }
+        return ids;
+    };
+
+    auto storedText = [&] {
+        std::string joined;
+        SQLiteStmt stmt(db.get(), "SELECT v.content FROM text_chunks c "
+                                  "JOIN text_chunk_texts v ON v.id = c.id "
+                                  "WHERE c.resource_id = 7 ORDER BY c.chunk_no;");
+        while (sqlite3_step(stmt.get()) == SQLITE_ROW) {
+            joined += reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0));
+        }
+        return joined;
+    };
+
+    auto countNew = [](const std::set<sqlite3_int64> &before,
+                       const std::set<sqlite3_int64> &after) {
+        return std::ranges::count_if(after, [&](auto id) { return !before.contains(id); });
+    };
+
+    // ~200 KiB, vài chục chunk
+    std::string text;
+    for (int line = 1; line <= 5000; ++line) {
+        text += "entry " + std::to_string(line) + " of the journal, lorem ipsum\n";
+    }
+    repo.insertText(7, text); // NOLINT(readability-magic-numbers)
+
+    const auto initial = chunkIds();
+    REQUIRE(initial.size() > 10);
+
+    // Sửa một từ ở giữa note
+    const auto editAt = text.find("entry 2500 ");
+    text.replace(editAt, 5, "needle");
+    repo.updateText(7, text); // NOLINT(readability-magic-numbers)
+
+    const auto edited = chunkIds();
+    CHECK(countNew(initial, edited) <= 2);
+    CHECK(countNew(edited, initial) <= 2); // số chunk cũ bị xóa
+    CHECK(storedText() == text);
+    CHECK(*repo.getTextById(7) == text);
+
+    auto hits = repo.searchContentHits("needle");
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0].line == 2500);
+    CHECK(hits[0].byte_offset == static_cast<std::int64_t>(editAt));
+
+    // Chèn ở đầu note: chunk phía sau giữ nguyên, vị trí vẫn đúng
+    text.insert(0, "preface\n");
+    repo.updateText(7, text); // NOLINT(readability-magic-numbers)
+
+    CHECK(countNew(edited, chunkIds()) <= 2);
+    CHECK(storedText() == text);
+
+    hits = repo.searchContentHits("needle");
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0].line == 2501);
+    CHECK(hits[0].byte_offset == static_cast<std::int64_t>(editAt + 8));
+
+    // Ghi lại y nguyên: không chunk nào đổi
+    const auto unchanged = chunkIds();
+    repo.updateText(7, text); // NOLINT(readability-magic-numbers)
+    CHECK(chunkIds() == unchanged);
+}
+
+TEST_CASE("TextContentRepository compresses note bodies transparently",
+          "[TextContentRepository][compression]") {
+    auto db = createInMemoryDB();
+    TextContentRepository repo(db);
+
+    auto storedType = [&](sqlite3_int64 id) {
+        SQLiteStmt stmt(db.get(), "SELECT typeof(content) FROM text_content "
+                                  "WHERE resource_id = ?;");
+        sqlite3_bind_int64(stmt.get(), 1, id);
+        REQUIRE(sqlite3_step(stmt.get()) == SQLITE_ROW);
+        return std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt.get(), 0)));
+    };
+
+    auto storedBytes = [&] {
+        SQLiteStmt stmt(db.get(), "SELECT SUM(length(CAST(content AS BLOB))) FROM text_content;");
+        REQUIRE(sqlite3_step(stmt.get()) == SQLITE_ROW);
+        return sqlite3_column_int64(stmt.get(), 0);
+    };
+
+    // Các note cùng khuôn: header + boilerplate giống nhau, phần thân khác nhau
+    auto makeNote = [](int n) {
+        std::string note = "// Project Notes - meeting summary\n#include <vector>\n"
+                           "#include <string>\nAttendees: design team, review board\n";
+        for (int line = 0; line < 20; ++line) {
+            note += "item " + std::to_string(n * 100 + line) + ": follow up on the agenda\n";
+        }
+        return note;
+    };
+
+    for (int n = 1; n <= 20; ++n) { repo.insertText(n, makeNote(n)); }
+    CHECK(storedType(1) == "text");
+    const auto rawBytes = storedBytes();
+
+    repo.setCompressionEnabled(true);
+    CHECK_FALSE(repo.hasDictionary());
+    const auto dictionary = repo.trainDictionary();
+    REQUIRE(dictionary.has_value());
+    CHECK(repo.hasDictionary());
+    CHECK(repo.recompress() == 20);
+    CHECK(repo.recompress() == 0); // đã nén hết
+
+    CHECK(storedType(1) == "blob");
+    CHECK(storedBytes() * 3 < rawBytes);
+    CHECK(*repo.getTextById(7) == makeNote(7));
+    CHECK(repo.getAllTexts().size() == 20);
+
+    // FTS đọc chunk cắt từ nội dung đã giải nén: tìm kiếm và vị trí không đổi
+    auto hits = repo.searchContentHits("705");
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0].resource_id == 7);
+    CHECK(hits[0].line == 10);
+
+    // Ghi mới và sửa đều nén; note ngắn giữ nguyên text
+    repo.insertText(21, makeNote(21));
+    repo.insertText(22, "short");
+    CHECK(storedType(21) == "blob");
+    CHECK(storedType(22) == "text");
+
+    auto note = makeNote(21) + "needle\n";
+    repo.updateText(21, note);
+    CHECK(*repo.getTextById(21) == note);
+    CHECK(repo.searchContentHits("needle").size() == 1);
+
+    SECTION("a new dictionary keeps old blobs readable") {
+        REQUIRE(repo.trainDictionary() != dictionary);
+        CHECK(*repo.getTextById(3) == makeNote(3));
+        CHECK(repo.recompress(true) == 21);
+        CHECK(*repo.getTextById(3) == makeNote(3));
+    }
+
+    SECTION("disabling compression restores plain text") {
+        repo.setCompressionEnabled(false);
+        CHECK(repo.recompress() == 21);
+        CHECK(storedType(1) == "text");
+        CHECK(storedBytes() > rawBytes);
+        CHECK(*repo.getTextById(21) == note);
+    }
+
+    SECTION("reindexAll reads compressed bodies") {
+        CHECK(repo.reindexAll() == 22);
+        CHECK(repo.searchContentHits("needle").size() == 1);
+    }
+}
+
+TEST_CASE("TextContentRepository keeps a single copy of the note text",
+          "[TextContentRepository][compression]") {
+    auto db = createInMemoryDB();
+    TextContentRepository repo(db);
+    repo.setCompressionEnabled(true);
+
+    auto exec = [&](const char* sql) {
+        return sqlite3_exec(db.get(), sql, nullptr, nullptr, nullptr);
+    };
+    // 'integrity-check' với rank = 1 so index FTS với text đọc lại qua text_chunk_texts
+    auto ftsConsistent = [&] {
+        return exec("INSERT INTO text_chunks_fts (text_chunks_fts, rank) "
+                    "VALUES ('integrity-check', 1);") == SQLITE_OK;
+    };
+
+    {
+        SQLiteStmt stmt(db.get(), "SELECT 1 FROM pragma_table_info('text_chunks') "
+                                  "WHERE name = 'content';");
+        CHECK(sqlite3_step(stmt.get()) == SQLITE_DONE);
+    }
+
+    std::string text;
+    for (int line = 1; line <= 3000; ++line) {
+        text += "record " + std::to_string(line) + " of the compressed journal\n";
+    }
+    repo.insertText(1, text);
+    repo.insertText(2, text + "closing needle\n");
+    CHECK(ftsConsistent());
+
+    auto hits = repo.searchContentHits("needle");
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0].resource_id == 2);
+    CHECK(hits[0].line == 3001);
+    CHECK(hits[0].byte_offset == static_cast<std::int64_t>(text.size() + 8));
+    CHECK(hits[0].snippet.find("needle") != std::string::npos);
+
+    // Sửa giữa note: chunk phía sau dời byte_offset, FTS vẫn khớp với nội dung mới
+    auto edited = text;
+    edited.replace(edited.find("record 1500 "), 6, "needle");
+    repo.updateText(1, edited);
+    CHECK(ftsConsistent());
+    CHECK(repo.searchContentHits("needle").size() == 2);
+
+    // Xóa nội dung: chunk được bỏ khỏi FTS trước khi mất text để đọc lại
+    REQUIRE(exec("DELETE FROM text_content WHERE resource_id = 2;") == SQLITE_OK);
+    CHECK(ftsConsistent());
+    hits = repo.searchContentHits("needle");
+    REQUIRE(hits.size() == 1);
+    CHECK(hits[0].resource_id == 1);
+    CHECK(hits[0].line == 1500);
+
+    // Chunk nằm ngoài nội dung là lỗi, không phải text sai
+    CHECK(exec("SELECT note_slice('abc', 2, 5);") == SQLITE_ERROR);
+}
+
+TEST_CASE("Compressed notes shrink the database file", "[TextContentRepository][.benchmark]") {
+    // Note giả lập: khung chung giữa các note, thân ghép từ ngẫu nhiên (seed cố định)
+    const std::vector<std::string> words{
+        "buffer", "queue",  "mutex", "thread", "vector", "latency", "cache",  "index",
+        "review", "design", "sync",  "deploy", "parser", "token",   "commit", "branch"};
+    std::mt19937 rng(42); // NOLINT(readability-magic-numbers)
+    std::vector<std::string> notes;
+    std::size_t rawBytes{};
+    for (int n = 0; n < 2000; ++n) {
+        std::string note = "// Meeting notes " + std::to_string(n) +
+                           "\n#include <vector>\n#include <string>\nAttendees: team\n";
+        for (int line = 0; line < 60; ++line) {
+            for (int w = 0; w < 8; ++w) { note += words[rng() % words.size()] + ' '; }
+            note += std::to_string(rng() % 10000) + '\n';
+        }
+        rawBytes += note.size();
+        notes.push_back(std::move(note));
+    }
+
+    const auto fileSize = [&](bool compress) {
+        const auto path = std::filesystem::temp_directory_path() / "notes_text_size.db";
+        std::filesystem::remove(path);
+        {
+            // SQLiteDB không mở với SQLITE_OPEN_CREATE: file rỗng là DB hợp lệ
+            std::ofstream(path).flush();
+            SQLiteDB db(path.string());
+            createSchema(db);
+            TextContentRepository repo(db);
+            repo.setCompressionEnabled(compress);
+            if (compress) {
+                for (std::size_t i = 0; i < 100; ++i) {
+                    repo.insertText(static_cast<sqlite3_int64>(i + 1), notes[i]);
+                }
+                REQUIRE(repo.trainDictionary().has_value());
+                repo.recompress();
+            }
+            for (std::size_t i = compress ? 100 : 0; i < notes.size(); ++i) {
+                repo.insertText(static_cast<sqlite3_int64>(i + 1), notes[i]);
+            }
+            REQUIRE(sqlite3_exec(db.get(), "VACUUM;", nullptr, nullptr, nullptr) == SQLITE_OK);
+        }
+        const auto size = std::filesystem::file_size(path);
+        std::filesystem::remove(path);
+        return size;
+    };
+
+    const auto plain = fileSize(false);
+    const auto compressed = fileSize(true);
+    WARN(notes.size() << " notes, " << rawBytes << " B of text: database " << plain
+                      << " B plain, " << compressed << " B compressed");
+}